@@ -17,6 +17,9 @@
 #include <cstdint>
 #include <memory>
 #include <future>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "bftengine/IStateTransfer.hpp"
 #include "util/Metrics.hpp"
@@ -90,6 +93,14 @@ class IAppState {
                                           uint32_t outBlockMaxSize,
                                           uint32_t *outBlockActualSize) = 0;
 
+  // Get multiple blocks, with a single batched read if supported by the application/storage layer.
+  // blockIds should be sorted in ascending order. On return, outBlocks[i] holds block blockIds[i], or std::nullopt if
+  // the block does not exist. If a block is larger than outBlockMaxSize, an exception is thrown.
+  // The default implementation reads the blocks one by one.
+  virtual void getBlocks(const std::vector<uint64_t> &blockIds,
+                         uint32_t outBlockMaxSize,
+                         std::vector<std::optional<std::string>> &outBlocks) const;
+
   // If block blockId exists, then the digest of block blockId-1 is returned via
   // the argument outPrevBlockDigest. Returns true IFF block blockId exists.
   virtual bool getPrevDigestFromBlock(uint64_t blockId, StateTransferDigest *outPrevBlockDigest) const = 0;
@@ -182,6 +193,19 @@ struct Config {
   bool enableSourceBlocksPreFetch = true;
   bool enableSourceSelectorPrimaryAwareness = true;
   bool enableStoreRvbDataDuringCheckpointing = true;
+  bool enableStripedFetching = false;  // fetch upcoming batches from helper sources, in parallel to the current source
+  // Max number of batches fetched concurrently from helper sources. Stripe data is bounded on its own by
+  // maxPendingDataFromSourceReplica, hence a destination may hold up to twice that amount while striped fetching is on.
+  uint16_t maxNumOfFetchStripes = 3;
+  // Compression of blocks sent by sources: 0 - none, 1 - LZ4, 2 - zstd. Requested by a destination, and served by a
+  // source (only if the source has it enabled as well). Blocks are sent raw if the algorithm was not built in.
+  uint16_t blockCompressionType = 0;
+  // Digest of the reserved pages descriptor, part of the checkpoint - must be the same in all replicas:
+  // 1 - digest of the whole descriptor, 2 - Merkle tree root, updated incrementally on checkpoints
+  uint16_t resPagesDigestVersion = 1;
+  // Size of the source blocks read-ahead cache, shared by all the destinations served: 0 - disabled. Blocks of
+  // predicted upcoming batches are read into the cache ahead of time, in a single batched storage read.
+  uint32_t sourceBlocksCacheSizeMb = 0;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const Config &c) {
@@ -218,6 +242,12 @@ inline std::ostream &operator<<(std::ostream &os, const Config &c) {
               c.enableSourceBlocksPreFetch,
               c.enableSourceSelectorPrimaryAwareness,
               c.enableStoreRvbDataDuringCheckpointing);
+  os << ",";
+  os << KVLOG(c.enableStripedFetching,
+              c.maxNumOfFetchStripes,
+              c.blockCompressionType,
+              c.resPagesDigestVersion,
+              c.sourceBlocksCacheSizeMb);
   return os;
 }
 // creates an instance of the state transfer module.
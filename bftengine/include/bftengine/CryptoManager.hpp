@@ -54,6 +54,19 @@ class CryptoManager : public IKeyExchanger, public IMultiSigKeyGenerator {
     return get(sn)->thresholdVerifierForOptimisticCommit_;
   }
 
+  // Pre-execution results are signed before they are ordered, i.e. there is no sequence number to pick the cryptosystem
+  // by. The signature shares are created by the latest cryptosystem. The combined signature is verified by the latest
+  // one, or by the one of the PrePrepare carrying it in case the keys were exchanged in the meantime.
+  std::shared_ptr<IThresholdSigner> thresholdSignerForPreExecution() const {
+    return cryptoSystems_.rbegin()->second->thresholdSigner_;
+  }
+  std::shared_ptr<IThresholdVerifier> thresholdVerifierForPreExecution() const {
+    return cryptoSystems_.rbegin()->second->thresholdVerifierForPreExecution_;
+  }
+  std::shared_ptr<IThresholdVerifier> thresholdVerifierForPreExecution(const SeqNum sn) const {
+    return get(sn)->thresholdVerifierForPreExecution_;
+  }
+
   std::unique_ptr<Cryptosystem>& getLatestCryptoSystem() const { return cryptoSystems_.rbegin()->second->cryptosys_; }
 
   /**
@@ -119,6 +132,9 @@ class CryptoManager : public IKeyExchanger, public IMultiSigKeyGenerator {
     // verifier of a threshold signature (for threshold N out of N)
     std::shared_ptr<IThresholdVerifier> thresholdVerifierForOptimisticCommit_;
 
+    // verifier of a threshold signature (for threshold fVal+1 out of N) on pre-execution results
+    std::shared_ptr<IThresholdVerifier> thresholdVerifierForPreExecution_;
+
     void init() {
       std::uint16_t f{ReplicaConfig::instance().getfVal()};
       std::uint16_t c{ReplicaConfig::instance().getcVal()};
@@ -127,6 +143,7 @@ class CryptoManager : public IKeyExchanger, public IMultiSigKeyGenerator {
       thresholdVerifierForSlowPathCommit_.reset(cryptosys_->createThresholdVerifier(f * 2 + c + 1));
       thresholdVerifierForCommit_.reset(cryptosys_->createThresholdVerifier(f * 3 + c + 1));
       thresholdVerifierForOptimisticCommit_.reset(cryptosys_->createThresholdVerifier(numSigners));
+      thresholdVerifierForPreExecution_.reset(cryptosys_->createThresholdVerifier(f + 1));
     }
   };
 
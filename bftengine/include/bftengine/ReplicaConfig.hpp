@@ -87,6 +87,10 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
                false,
                "enables send/receive of batched PreProcess request/reply messages");
   CONFIG_PARAM(clientBatchingEnabled, bool, false, "enables the concord-client-batch feature");
+  CONFIG_PARAM(maxPrimaryQueueRequestsPerClient,
+               uint32_t,
+               0,
+               "maximum number of requests of a single client in the primary's requests queue, 0 means no limit");
   CONFIG_PARAM(clientBatchingMaxMsgsNbr, uint16_t, 10, "Maximum messages number in one client batch");
   CONFIG_PARAM(clientTransactionSigningEnabled,
                bool,
@@ -131,6 +135,9 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
   // sign with the matching private key
   std::set<std::pair<const std::string, std::set<uint16_t>>> publicKeysOfClients;
   std::unordered_map<uint16_t, std::set<uint16_t>> clientGroups;
+  // Weights of clients in the primary's fair requests queue - a client with weight w gets w times the share of a
+  // client with the default weight of 1
+  std::unordered_map<uint16_t, uint16_t> primaryQueueClientsWeights;
   CONFIG_PARAM(clientsKeysPrefix, std::string, "", "the path to the client keys directory");
   CONFIG_PARAM(saveClinetKeyFile,
                bool,
@@ -200,6 +207,12 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
 
   CONFIG_PARAM(preExecutionResultAuthEnabled, bool, false, "if PreExecution result authentication is enabled");
 
+  CONFIG_PARAM(preExecutionResultThresholdSignEnabled,
+               bool,
+               false,
+               "if PreExecution results are authenticated by a single threshold signature combined from the replicas' "
+               "signature shares instead of a set of replica signatures (requires preExecutionResultAuthEnabled)");
+
   CONFIG_PARAM(prePrepareFinalizeAsyncEnabled, bool, true, "Enabling asynchronous preprepare finishing");
 
   CONFIG_PARAM(
@@ -249,11 +262,22 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
                true,
                "When set to true this parameter will cause endWriteTran to block until "
                "the transaction is persisted every time we update the metadata.");
+  CONFIG_PARAM(groupCommitMetadata,
+               bool,
+               false,
+               "When set to true, metadata updates are committed together once the replica has processed the "
+               "messages it currently holds, and outgoing messages are sent only after that commit.");
 
   CONFIG_PARAM(stateIterationMultiGetBatchSize,
                std::uint32_t,
                30u,
                "Amount of keys to get at once via multiGet when iterating state");
+  CONFIG_PARAM(publicStateHashVersion,
+               std::uint32_t,
+               1u,
+               "Version of the public state hash computed for DB snapshots: 1 - chained over all keys, 2 - computed "
+               "in parallel over partitions of keys. Set 2 only once all clientservice instances are upgraded, older "
+               "ones only compare the chained hash");
 
   CONFIG_PARAM(enableMultiplexChannel, bool, true, "whether multiplex communication channel is enabled")
 
@@ -409,6 +433,7 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
     serialize(outStream, enablePostExecutionSeparation);
     serialize(outStream, postExecutionQueuesSize);
     serialize(outStream, stateIterationMultiGetBatchSize);
+    serialize(outStream, publicStateHashVersion);
     serialize(outStream, config_params_);
     serialize(outStream, enableMultiplexChannel);
     serialize(outStream, enableEventGroups);
@@ -418,6 +443,9 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
     serialize(outStream, kvBlockchainVersion);
     serialize(outStream, operatorMsgSigningAlgo);
     serialize(outStream, replicaMsgSigningAlgo);
+    serialize(outStream, preExecutionResultThresholdSignEnabled);
+    serialize(outStream, maxPrimaryQueueRequestsPerClient);
+    serialize(outStream, primaryQueueClientsWeights);
   }
   void deserializeDataMembers(std::istream& inStream) {
     deserialize(inStream, isReadOnly);
@@ -509,6 +537,7 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
     deserialize(inStream, enablePostExecutionSeparation);
     deserialize(inStream, postExecutionQueuesSize);
     deserialize(inStream, stateIterationMultiGetBatchSize);
+    deserialize(inStream, publicStateHashVersion);
     deserialize(inStream, config_params_);
     deserialize(inStream, enableMultiplexChannel);
     deserialize(inStream, enableEventGroups);
@@ -518,6 +547,9 @@ class ReplicaConfig : public concord::serialize::SerializableFactory<ReplicaConf
     deserialize(inStream, kvBlockchainVersion);
     deserialize(inStream, operatorMsgSigningAlgo);
     deserialize(inStream, replicaMsgSigningAlgo);
+    deserialize(inStream, preExecutionResultThresholdSignEnabled);
+    deserialize(inStream, maxPrimaryQueueRequestsPerClient);
+    deserialize(inStream, primaryQueueClientsWeights);
   }
 
  private:
@@ -614,7 +646,10 @@ inline std::ostream& operator<<(std::ostream& os, const ReplicaConfig& rc) {
               rc.useUnifiedCertificates,
               rc.kvBlockchainVersion,
               replicaMsgSignAlgo,
-              operatorMsgSignAlgo);
+              operatorMsgSignAlgo,
+              rc.preExecutionResultThresholdSignEnabled,
+              rc.maxPrimaryQueueRequestsPerClient,
+              rc.publicStateHashVersion);
   os << ", ";
   for (auto& [param, value] : rc.config_params_) os << param << ": " << value << "\n";
   return os;
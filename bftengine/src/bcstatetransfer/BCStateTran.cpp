@@ -64,6 +64,22 @@ BlockDigest computeBlockDigest(const uint64_t blockId, const char *block, const
   return impl::BCStateTran::computeDigestOfBlock(blockId, block, blockSize);
 }
 
+void IAppState::getBlocks(const std::vector<uint64_t> &blockIds,
+                          uint32_t outBlockMaxSize,
+                          std::vector<std::optional<std::string>> &outBlocks) const {
+  outBlocks.clear();
+  outBlocks.reserve(blockIds.size());
+  std::unique_ptr<char[]> buffer(new char[outBlockMaxSize]);
+  for (auto blockId : blockIds) {
+    uint32_t actualBlockSize{0};
+    if (hasBlock(blockId) && getBlock(blockId, buffer.get(), outBlockMaxSize, &actualBlockSize)) {
+      outBlocks.emplace_back(std::string(buffer.get(), actualBlockSize));
+    } else {
+      outBlocks.emplace_back(std::nullopt);
+    }
+  }
+}
+
 IStateTransfer *create(const Config &config,
                        IAppState *const stateApi,
                        std::shared_ptr<concord::storage::IDBClient> dbc,
@@ -230,7 +246,20 @@ BCStateTran::Metrics BCStateTran::createRegisterMetrics() {
 
       metrics_component_.RegisterGauge("src_num_io_contexts_dropped", 0),
       metrics_component_.RegisterGauge("src_num_io_contexts_invoked", 0),
-      metrics_component_.RegisterCounter("src_num_io_contexts_consumed")};
+      metrics_component_.RegisterCounter("src_num_io_contexts_consumed"),
+
+      metrics_component_.RegisterCounter("src_num_compressed_blocks"),
+      metrics_component_.RegisterCounter("src_num_incompressible_blocks"),
+      metrics_component_.RegisterCounter("src_compressed_blocks_raw_bytes"),
+      metrics_component_.RegisterCounter("src_compressed_blocks_compressed_bytes"),
+      metrics_component_.RegisterCounter("dst_num_decompressed_blocks"),
+      metrics_component_.RegisterCounter("dst_decompression_failures"),
+
+      metrics_component_.RegisterCounter("src_blocks_cache_hits"),
+      metrics_component_.RegisterCounter("src_blocks_cache_misses"),
+      metrics_component_.RegisterCounter("src_num_blocks_read_ahead"),
+      metrics_component_.RegisterGauge("src_blocks_cache_size_bytes", 0),
+      metrics_component_.RegisterGauge("src_session_bytes_throughput", 0)};
 }
 
 void BCStateTran::rvbm_deleter::operator()(RVBManager *ptr) const { delete ptr; }  // used for pimpl
@@ -254,6 +283,8 @@ BCStateTran::BCStateTran(const Config &config, IAppState *const stateApi, DataSt
       cycleCounter_{0},
       running_{false},
       replicaForStateTransfer_{nullptr},
+      requestedCompressionType_{getRequestedCompressionType()},
+      resPagesDigestVersion_{static_cast<DataStore::ResPagesDigestVersion>(config_.resPagesDigestVersion)},
       randomGen_{randomDevice_()},
       sourceSelector_{allOtherReplicas(),
                       config_.fetchRetransmissionTimeoutMs,
@@ -264,6 +295,10 @@ BCStateTran::BCStateTran(const Config &config, IAppState *const stateApi, DataSt
       fetchState_{0},
       commitState_{0},
       postponedSendFetchBlocksMsg_(false),
+      stripeManager_{config_.maxNumOfFetchStripes,
+                     config_.fetchRetransmissionTimeoutMs,
+                     config_.fetchRetransmissionTimeoutMs * std::max(config_.maxFetchRetransmissions, 1U),
+                     ST_SRC_LOG},
       ioPool_(
           config_.maxNumberOfChunksInBatch,
           nullptr,                                           // alloc callback
@@ -310,6 +345,7 @@ BCStateTran::BCStateTran(const Config &config, IAppState *const stateApi, DataSt
   ConcordAssertGE(replicas_.size(), 3U * config_.fVal + 1U);
   ConcordAssert(replicas_.count(config_.myReplicaId) == 1 || config.isReadOnly);
   ConcordAssertLT(finalizePutblockTimeoutMilli_, config_.refreshTimerMs);
+  ConcordAssertLT(digestJobTimeoutMilli_, config_.refreshTimerMs);
   ConcordAssertEQ(RejectFetchingMsg::reasonMessages.size(), RejectFetchingMsg::Reason::LAST - 1);
   if (config_.sourceSessionExpiryDurationMs > 0) {
     ConcordAssertGT(config_.sourceSessionExpiryDurationMs, config_.fetchRetransmissionTimeoutMs);
@@ -317,6 +353,15 @@ BCStateTran::BCStateTran(const Config &config, IAppState *const stateApi, DataSt
 
   LOG_INFO(logger_, "Creating BCStateTran object: " << config_);
 
+  if (requestedCompressionType_ != CompressionType::NONE) {
+    compressionWorkers_ = std::make_unique<concord::util::ThreadPool>("st-compression", numOfCompressionWorkers_);
+  }
+  digestWorkers_ = std::make_unique<concord::util::ThreadPool>("st-digest", numOfDigestWorkers_);
+  if (config_.sourceBlocksCacheSizeMb > 0) {
+    sourceBlocksCache_ = std::make_unique<SourceBlocksCache>(config_.sourceBlocksCacheSizeMb * 1024ULL * 1024ULL);
+    readAheadWorker_ = std::make_unique<concord::util::ThreadPool>("st-read-ahead", 1);
+  }
+
   // Register metrics component with the default aggregator.
   metrics_component_.Register();
 
@@ -480,6 +525,7 @@ void BCStateTran::stopRunningImpl() {
   // This one should always be first!
   running_ = false;
   clearIoContexts();
+  clearSourceBlocksCache();
   if (postProcessingQ_) {
     postProcessingQ_->stop();
   }
@@ -516,6 +562,7 @@ DataStore::CheckpointDesc BCStateTran::createCheckpointDesc(uint64_t checkpointN
   checkDesc.maxBlockId = maxBlockId;
   checkDesc.digestOfMaxBlockId = digestOfMaxBlockId;
   checkDesc.digestOfResPagesDescriptor = digestOfResPagesDescriptor;
+  checkDesc.resPagesDigestVersion = resPagesDigestVersion_;
   rvbm_->updateRvbDataDuringCheckpoint(checkDesc);
   metrics_.current_rvb_data_state_.Get().Set(rvbm_->getStateOfRvbData());
 
@@ -532,27 +579,91 @@ DataStore::CheckpointDesc BCStateTran::createCheckpointDesc(uint64_t checkpointN
 
 // Associate any pending reserved pages with the current checkpoint.
 // Return the digest of all the reserved pages descriptor.
-//
-// This has the side effect of mutating buffer_.
 Digest BCStateTran::checkpointReservedPages(uint64_t checkpointNumber, DataStoreTransaction *txn) {
+  TimeRecorder scoped_timer(*histograms_.checkpoint_res_pages_duration);
+  auto updatedPages = associatePendingResPages(checkpointNumber, txn);
+  ConcordAssertEQ(txn->numOfAllPendingResPage(), 0);
+  return computeDigestOfResPagesDescriptor(checkpointNumber, updatedPages, txn);
+}
+
+std::vector<DataStore::SingleResPageDesc> BCStateTran::associatePendingResPages(uint64_t checkpointNumber,
+                                                                                DataStoreTransaction *txn) {
   set<uint32_t> pages = txn->getNumbersOfPendingResPages();
   auto numberOfPagesInCheckpoint = pages.size();
   LOG_INFO(logger_,
            "Associating pending pages with checkpoint: " << KVLOG(numberOfPagesInCheckpoint, checkpointNumber));
-  std::unique_ptr<char[]> buffer(new char[config_.sizeOfReservedPage]);
-  for (uint32_t p : pages) {
-    Digest d;
-    txn->getPendingResPage(p, buffer.get(), config_.sizeOfReservedPage);
-    computeDigestOfPage(p, checkpointNumber, buffer.get(), config_.sizeOfReservedPage, d);
-    txn->associatePendingResPageWithCheckpoint(p, checkpointNumber, d);
+  histograms_.checkpoint_num_of_updated_res_pages->record(numberOfPagesInCheckpoint);
+
+  std::vector<DataStore::SingleResPageDesc> updatedPages;
+  updatedPages.reserve(numberOfPagesInCheckpoint);
+  const uint32_t pageSize = config_.sizeOfReservedPage;
+  const size_t batchSize = std::min<size_t>(numberOfPagesInCheckpoint, maxResPagesInDigestBatch_);
+  std::unique_ptr<char[]> buffer(new char[batchSize * pageSize]);
+  auto it = pages.begin();
+  while (it != pages.end()) {
+    // Pages are read by this thread (the transaction is not thread safe), and digested in parallel
+    const size_t first = updatedPages.size();
+    for (; (it != pages.end()) && (updatedPages.size() - first < batchSize); ++it) {
+      txn->getPendingResPage(*it, buffer.get() + (updatedPages.size() - first) * pageSize, pageSize);
+      updatedPages.push_back(DataStore::SingleResPageDesc{*it, checkpointNumber, Digest{}});
+    }
+    const size_t numOfPages = updatedPages.size() - first;
+    const size_t numOfJobs = std::min<size_t>(numOfPages, numOfDigestWorkers_);
+    std::vector<std::future<void>> jobs;
+    jobs.reserve(numOfJobs);
+    for (size_t job = 0; job < numOfJobs; ++job) {
+      jobs.push_back(digestWorkers_->async([&, job]() {
+        for (size_t i = job; i < numOfPages; i += numOfJobs) {
+          auto &pageDesc = updatedPages[first + i];
+          computeDigestOfPage(
+              pageDesc.pageId, checkpointNumber, buffer.get() + i * pageSize, pageSize, pageDesc.pageDigest);
+        }
+      }));
+    }
+    for (auto &job : jobs) {
+      job.get();
+    }
   }
 
-  ConcordAssertEQ(txn->numOfAllPendingResPage(), 0);
-  DataStore::ResPagesDescriptor *allPagesDesc = txn->getResPagesDescriptor(checkpointNumber);
-  ConcordAssertEQ(allPagesDesc->numOfPages, numberOfReservedPages_);
+  for (const auto &pageDesc : updatedPages) {
+    txn->associatePendingResPageWithCheckpoint(pageDesc.pageId, checkpointNumber, pageDesc.pageDigest);
+  }
+  return updatedPages;
+}
 
+Digest BCStateTran::computeDigestOfResPagesDescriptor(uint64_t checkpointNumber,
+                                                      const std::vector<DataStore::SingleResPageDesc> &updatedPages,
+                                                      DataStoreTransaction *txn) {
   Digest digestOfResPagesDescriptor;
-  computeDigestOfPagesDescriptor(allPagesDesc, digestOfResPagesDescriptor);
+  const auto lastStoredCheckpoint = txn->getLastStoredCheckpoint();
+  if ((resPagesDigestVersion_ == DataStore::ResPagesDigestVersion::MERKLE) && resPagesDigestTree_ &&
+      (resPagesDigestTreeCheckpoint_ > 0) && (resPagesDigestTreeCheckpoint_ == lastStoredCheckpoint)) {
+    // Only the updated pages have changed since the last checkpoint
+    for (const auto &pageDesc : updatedPages) {
+      resPagesDigestTree_->update(pageDesc);
+    }
+    resPagesDigestTreeCheckpoint_ = checkpointNumber;
+    digestOfResPagesDescriptor = resPagesDigestTree_->digest();
+    auto numOfUpdatedPages = updatedPages.size();
+    LOG_INFO(logger_,
+             "Reserved pages descriptor digest updated: " << KVLOG(
+                 checkpointNumber, numOfUpdatedPages, digestOfResPagesDescriptor));
+    return digestOfResPagesDescriptor;
+  }
+
+  DataStore::ResPagesDescriptor *allPagesDesc = txn->getResPagesDescriptor(checkpointNumber);
+  ConcordAssertEQ(allPagesDesc->numOfPages, numberOfReservedPages_);
+  if (resPagesDigestVersion_ == DataStore::ResPagesDigestVersion::MERKLE) {
+    LOG_INFO(logger_,
+             "Building reserved pages digest tree: " << KVLOG(
+                 checkpointNumber, lastStoredCheckpoint, resPagesDigestTreeCheckpoint_));
+    resPagesDigestTree_ = std::make_unique<ResPagesDigestTree>(allPagesDesc->numOfPages);
+    resPagesDigestTree_->build(allPagesDesc);
+    resPagesDigestTreeCheckpoint_ = checkpointNumber;
+    digestOfResPagesDescriptor = resPagesDigestTree_->digest();
+  } else {
+    computeDigestOfPagesDescriptor(allPagesDesc, digestOfResPagesDescriptor);
+  }
 
   LOG_INFO(logger_, allPagesDesc->toString(digestOfResPagesDescriptor.toString()));
 
@@ -615,6 +726,7 @@ void BCStateTran::createCheckpointOfCurrentStateImpl(uint64_t checkpointNumber)
 #endif
 
   {  // txn scope
+    TimeRecorder scoped_timer(*histograms_.create_checkpoint_duration);
     DataStoreTransaction::Guard g(psd_->beginTransaction());
     auto digestOfResPagesDescriptor = checkpointReservedPages(checkpointNumber, g.txn());
     auto checkDesc = createCheckpointDesc(checkpointNumber, digestOfResPagesDescriptor);
@@ -951,6 +1063,8 @@ void BCStateTran::startCollectingStateImpl() {
     g.txn()->deleteAllPendingPages();
     g.txn()->setIsFetchingState(true);
   }
+  // Blocks may be rolled back and replaced while fetching
+  clearSourceBlocksCache();
 
   // TODO - The next 4 lines do not belong here (CRE) - move outside
   LOG_INFO(logger_, "Starts async reconfiguration engine");
@@ -990,6 +1104,7 @@ void BCStateTran::onTimerImpl() {
     LOG_TRACE(logger_, "Updating all aggregators...");
     metrics_component_.UpdateAggregator();
     sourceSelector_.UpdateAggregator();
+    stripeManager_.UpdateAggregator();
     rvbm_->UpdateAggregator();
     lastAggregatorUpdateTimeMilli = currentTimeMilli;
   }
@@ -1009,6 +1124,9 @@ void BCStateTran::onTimerImpl() {
     lastMetricsDumpTimeMilli = currentTimeMilli;
     LOG_DEBUG(logger_, "--BCStateTransfer metrics dump--" + metrics_component_.ToJson());
     LOG_DEBUG(logger_, "--SourceSelector metrics dump--" + sourceSelector_.getMetricComponent().ToJson());
+    if (config_.enableStripedFetching) {
+      LOG_DEBUG(logger_, "--StripeManager metrics dump--" + stripeManager_.getMetricComponent().ToJson());
+    }
     LOG_DEBUG(logger_, "--RVBManager metrics dump--" + rvbm_->getMetricComponent().ToJson());
     LOG_DEBUG(logger_, "--RVT metrics dump--" + rvbm_->getRvtMetricComponent().ToJson());
   }
@@ -1029,6 +1147,9 @@ void BCStateTran::onTimerImpl() {
     }
     // process data if fetching
   } else if (fs == FetchingState::GettingMissingBlocks || fs == FetchingState::GettingMissingResPages) {
+    if (fs == FetchingState::GettingMissingBlocks) {
+      checkStripesTimeouts();
+    }
     processData();
   } else if (fs == FetchingState::FinalizingCycle) {
     ConcordAssert(on_transferring_complete_ongoing_);
@@ -1102,6 +1223,11 @@ void BCStateTran::getStatusImpl(std::string &statusOut) {
     bj.addKv("preferredReplicas", preferred_replicas);
     bj.addKv("nextRequiredBlock", fetchState_.nextBlockId);
     bj.addKv("totalSizeOfPendingItemDataMsgs", totalSizeOfPendingItemDataMsgs);
+    if (config_.enableStripedFetching) {
+      bj.addKv("numOfStripes", stripeManager_.numOfStripes());
+      bj.addKv("totalSizeOfStripesItemDataMsgs", totalSizeOfStripesItemDataMsgs_);
+      bj.addKv("consumedStripeSourceId", consumedStripeSourceId_);
+    }
     bj.endNested();
 
     bj.addNestedJson("collectingDetails", logsForCollectingStatus());
@@ -1109,6 +1235,7 @@ void BCStateTran::getStatusImpl(std::string &statusOut) {
 
   bj.addNestedJson("StateTransferMetrics", metrics_component_.ToJson());
   bj.addNestedJson("SourceSelectorMetrics", sourceSelector_.getMetricComponent().ToJson());
+  bj.addNestedJson("StripeManagerMetrics", stripeManager_.getMetricComponent().ToJson());
   bj.addNestedJson("RVBManagerMetrics", rvbm_->getMetricComponent().ToJson());
   bj.addNestedJson("RVTMetrics", rvbm_->getRvtMetricComponent().ToJson());
 
@@ -1181,7 +1308,8 @@ void BCStateTran::handleStateTransferMessageImpl(char *msg,
         onMessage(convertBaseStMsgToRealStMsgType<AskForCheckpointSummariesMsg>(msgHeader.release()), msgLen, senderId);
       }
     } break;
-    case MsgType::CheckpointsSummary: {
+    case MsgType::CheckpointsSummary:
+    case MsgType::VersionedCheckpointsSummary: {
       if (fs == FetchingState::GettingCheckpointSummaries) {
 #ifdef ENABLE_ALL_METRICS
         metrics_.handle_CheckpointsSummary_msg_++;
@@ -1205,7 +1333,8 @@ void BCStateTran::handleStateTransferMessageImpl(char *msg,
         onMessage(convertBaseStMsgToRealStMsgType<RejectFetchingMsg>(msgHeader.release()), msgLen, senderId);
       }
     } break;
-    case MsgType::ItemData: {
+    case MsgType::ItemData:
+    case MsgType::CompressedItemData: {
       if (fs == FetchingState::GettingMissingBlocks || fs == FetchingState::GettingMissingResPages) {
         TimeRecorder scoped_timer(*histograms_.dst_handle_ItemData_msg);
         metrics_.handle_ItemData_msg_++;
@@ -1486,6 +1615,7 @@ void BCStateTran::onFetchingStateChange(FetchingState newFetchingState) {
       ConcordAssert(digestOfNextRequiredBlock_.isZero());
       fetchState_ = computeNextBatchToFetch(psd_->getFirstRequiredBlock());
       commitState_ = fetchState_;
+      pendingCommitStates_.clear();
       LOG_INFO(logger_, KVLOG(fetchState_, commitState_));
       gettingMissingBlocksDT_.start();
       blocksFetched_.start();
@@ -1589,6 +1719,17 @@ void BCStateTran::trySendFetchBlocksMsg(int16_t lastKnownChunkInLastRequiredBloc
     return;
   }
 
+  if (isStripedFetchingActive() && shouldWaitForStripe(lastKnownChunkInLastRequiredBlock)) {
+    LOG_DEBUG(logger_, "Waiting for stripe:" << KVLOG(fetchState_, waitingForStripeSinceMilli_));
+    postponedSendFetchBlocksMsg_ = false;
+    return;
+  }
+  waitingForStripeSinceMilli_ = 0;
+  if (stripeManager_.getStripeBySource(sourceSelector_.currentReplica())) {
+    // A source serves a single batch at a time - the stripe is going to be overridden by this request
+    cancelStripe(sourceSelector_.currentReplica(), StripeCancelReason::STALE);
+  }
+
   FetchBlocksMsg msg;
   lastMsgSeqNum_ = uniqueMsgSeqNum();
 #ifdef ENABLE_ALL_METRICS
@@ -1600,6 +1741,7 @@ void BCStateTran::trySendFetchBlocksMsg(int16_t lastKnownChunkInLastRequiredBloc
   msg.maxBlockIdInCycle = psd_->getLastRequiredBlock();
   msg.lastKnownChunkInLastRequiredBlock = lastKnownChunkInLastRequiredBlock;
   msg.rvbGroupId = rvbm_->getFetchBlocksRvbGroupId(msg.minBlockId, msg.maxBlockId);
+  msg.compressionType = static_cast<uint8_t>(requestedCompressionType_);
   auto totalBlocksRequested = (msg.maxBlockId - msg.minBlockId) + 1;
 
   LOG_INFO(logger_,
@@ -1620,6 +1762,7 @@ void BCStateTran::trySendFetchBlocksMsg(int16_t lastKnownChunkInLastRequiredBloc
   dst_time_between_sendFetchBlocksMsg_rec_.end();  // if it was never started, this operation does nothing
   dst_time_between_sendFetchBlocksMsg_rec_.start();
   postponedSendFetchBlocksMsg_ = false;
+  dispatchStripes();
 }
 
 void BCStateTran::sendFetchResPagesMsg(int16_t lastKnownChunkInLastRequiredBlock) {
@@ -1698,7 +1841,8 @@ void BCStateTran::onMessage(STMessageUptr<AskForCheckpointSummariesMsg> m, uint3
 
     DataStore::CheckpointDesc cpDesc = psd_->getCheckpointDesc(i);
 
-    auto msg = CheckpointSummaryMsg::alloc(cpDesc.rvbData.size());
+    auto msg =
+        CheckpointSummaryMsg::alloc(cpDesc.rvbData.size(), static_cast<uint8_t>(cpDesc.resPagesDigestVersion));
     msg->checkpointNum = i;
     msg->maxBlockId = cpDesc.maxBlockId;
     msg->digestOfMaxBlockId = cpDesc.digestOfMaxBlockId;
@@ -1762,6 +1906,17 @@ void BCStateTran::onMessage(STMessageUptr<CheckpointSummaryMsg> m, uint32_t msgL
     return;
   }
 
+  // the reserved pages of the checkpoint could not be validated
+  if (m->resPagesDigestVersion() != static_cast<uint8_t>(resPagesDigestVersion_)) {
+    LOG_WARN(logger_,
+             "Msg is irrelevant, reserved pages digest version mismatch: "
+                 << KVLOG(replicaId, m->checkpointNum, m->resPagesDigestVersion(), config_.resPagesDigestVersion));
+#ifdef ENABLE_ALL_METRICS
+    metrics_.irrelevant_checkpoint_summary_msg_++;
+#endif
+    return;
+  }
+
   uint16_t numOfMsgsFromSender =
       (numOfSummariesFromOtherReplicas.count(replicaId) == 0) ? 0 : numOfSummariesFromOtherReplicas.at(replicaId);
 
@@ -1833,6 +1988,8 @@ void BCStateTran::onMessage(STMessageUptr<CheckpointSummaryMsg> m, uint32_t msgL
   newCheckpoint.maxBlockId = cpSummaryMsg->maxBlockId;
   newCheckpoint.digestOfMaxBlockId = cpSummaryMsg->digestOfMaxBlockId;
   newCheckpoint.digestOfResPagesDescriptor = cpSummaryMsg->digestOfResPagesDescriptor;
+  newCheckpoint.resPagesDigestVersion =
+      static_cast<DataStore::ResPagesDigestVersion>(cpSummaryMsg->resPagesDigestVersion());
   newCheckpoint.rvbData.insert(
       newCheckpoint.rvbData.begin(), cpSummaryMsg->data, cpSummaryMsg->data + cpSummaryMsg->sizeofRvbData());
 
@@ -1905,7 +2062,32 @@ uint16_t BCStateTran::getBlocksConcurrentAsync(uint64_t maxBlockId, uint64_t min
   for (uint64_t i{maxBlockId}; (i >= minBlockId) && (j < numBlocks) && !ioPool_.empty(); --i, ++j) {
     auto ctx = ioPool_.alloc();
     ctx->blockId = i;
-    ctx->future = as_->getBlockAsync(ctx->blockId, ctx->blockData.get(), config_.maxBlockSize, &ctx->actualBlockSize);
+    ctx->compressionType = sourceBatch_.compressionType;
+    ctx->uncompressedBlockSize = 0;
+    if (!sourceBlocksCache_ || !getBlockFromCache(*ctx)) {
+      ctx->future =
+          as_->getBlockAsync(ctx->blockId, ctx->blockData.get(), config_.maxBlockSize, &ctx->actualBlockSize);
+    }
+    if (ctx->compressionType != CompressionType::NONE) {
+      // Chain the compression job to the storage read job. The context is kept alive until its future is consumed.
+      ctx->future = compressionWorkers_->async(
+          [recorder = histograms_.src_compress_block_duration](std::future<bool> getBlockFuture,
+                                                               BlockIOContext *ioCtx) {
+            if (!getBlockFuture.get()) {
+              return false;
+            }
+            TimeRecorder<true> scoped_timer(*recorder);
+            auto compressedSize =
+                BlockCompressor::compress(ioCtx->compressionType, ioCtx->blockData.get(), ioCtx->actualBlockSize);
+            if (compressedSize > 0) {
+              ioCtx->uncompressedBlockSize = ioCtx->actualBlockSize;
+              ioCtx->actualBlockSize = compressedSize;
+            }
+            return true;
+          },
+          std::move(ctx->future),
+          ctx.get());
+    }
     ioContexts_.push_back(std::move(ctx));
   }
   if (j > 0) {
@@ -1915,6 +2097,112 @@ uint16_t BCStateTran::getBlocksConcurrentAsync(uint64_t maxBlockId, uint64_t min
   return j;
 }
 
+CompressionType BCStateTran::getRequestedCompressionType() const {
+  if (config_.blockCompressionType == 0) {
+    return CompressionType::NONE;
+  }
+  const auto type = static_cast<CompressionType>(config_.blockCompressionType);
+  if ((config_.blockCompressionType >= static_cast<uint16_t>(CompressionType::LAST)) ||
+      !BlockCompressor::isSupported(type)) {
+    LOG_WARN(logger_,
+             "Blocks compression is not supported, blocks are sent raw:" << KVLOG(config_.blockCompressionType));
+    return CompressionType::NONE;
+  }
+  LOG_INFO(logger_, "Blocks compression is enabled:" << KVLOG(toString(type)));
+  return type;
+}
+
+CompressionType BCStateTran::getSourceCompressionType(uint8_t requestedType) const {
+  // Compress only if enabled on this replica as well, and the requested algorithm is built in
+  if (!compressionWorkers_ || (requestedType == static_cast<uint8_t>(CompressionType::NONE)) ||
+      (requestedType >= static_cast<uint8_t>(CompressionType::LAST))) {
+    return CompressionType::NONE;
+  }
+  const auto type = static_cast<CompressionType>(requestedType);
+  return BlockCompressor::isSupported(type) ? type : CompressionType::NONE;
+}
+
+bool BCStateTran::getBlockFromCache(BlockIOContext &ctx) {
+  if (!sourceBlocksCache_->get(ctx.blockId, ctx.blockData.get(), config_.maxBlockSize, &ctx.actualBlockSize)) {
+    metrics_.src_blocks_cache_misses_++;
+    return false;
+  }
+  metrics_.src_blocks_cache_hits_++;
+  std::promise<bool> promise;
+  promise.set_value(true);
+  ctx.future = promise.get_future();
+  return true;
+}
+
+void BCStateTran::sourceReadAhead(const FetchBlocksMsg &m, uint16_t replicaId) {
+  // A destination requests consecutive ranges in ascending order. Predict the range size from its previous request,
+  // and assume a full batch otherwise.
+  uint64_t rangeSize = config_.maxNumberOfChunksInBatch;
+  if ((lastFetchBlocksReplicaId_ == replicaId) && (m.maxBlockId > lastFetchBlocksMaxBlockId_) &&
+      (m.maxBlockId - lastFetchBlocksMaxBlockId_ < rangeSize)) {
+    rangeSize = m.maxBlockId - lastFetchBlocksMaxBlockId_;
+  }
+  lastFetchBlocksReplicaId_ = replicaId;
+  lastFetchBlocksMaxBlockId_ = m.maxBlockId;
+
+  // The next range is pre-fetched block by block into ioContexts_ while this batch is sent - read ahead the one after
+  const uint64_t firstBlockId = m.maxBlockId + 1 + (config_.enableSourceBlocksPreFetch ? rangeSize : 0);
+  const uint64_t lastBlockId = std::min(firstBlockId + rangeSize - 1, m.maxBlockIdInCycle);
+  if (firstBlockId > lastBlockId) {
+    return;
+  }
+  if (readAheadFuture_.valid() &&
+      (readAheadFuture_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)) {
+    LOG_DEBUG(logger_, "Previous read-ahead is still ongoing:" << KVLOG(firstBlockId, lastBlockId));
+    return;
+  }
+
+  std::vector<uint64_t> blockIds;
+  blockIds.reserve(lastBlockId - firstBlockId + 1);
+  for (auto blockId = firstBlockId; blockId <= lastBlockId; ++blockId) {
+    if (!sourceBlocksCache_->contains(blockId)) {
+      blockIds.push_back(blockId);
+    }
+  }
+  if (blockIds.empty()) {
+    return;
+  }
+  LOG_DEBUG(logger_, "Read ahead:" << KVLOG(firstBlockId, lastBlockId, blockIds.size()));
+  metrics_.src_num_blocks_read_ahead_ += blockIds.size();
+  readAheadFuture_ = readAheadWorker_->async(
+      [this,
+       durationRecorder = histograms_.src_read_ahead_duration,
+       numOfBlocksRecorder = histograms_.src_read_ahead_num_of_blocks](std::vector<uint64_t> ids) {
+        TimeRecorder<true> scoped_timer(*durationRecorder);
+        numOfBlocksRecorder->recordAtomic(ids.size());
+        std::vector<std::optional<std::string>> blocks;
+        try {
+          as_->getBlocks(ids, config_.maxBlockSize, blocks);
+        } catch (const std::exception &e) {
+          // Blocks are read again on demand
+          LOG_WARN(logger_, "Read-ahead failed:" << KVLOG(ids.front(), ids.back(), e.what()));
+          return;
+        }
+        for (size_t i = 0; i < blocks.size(); ++i) {
+          if (blocks[i]) {
+            sourceBlocksCache_->put(ids[i], blocks[i]->data(), blocks[i]->size());
+          }
+        }
+      },
+      std::move(blockIds));
+}
+
+void BCStateTran::clearSourceBlocksCache() {
+  if (!sourceBlocksCache_) {
+    return;
+  }
+  if (readAheadFuture_.valid()) {
+    readAheadFuture_.wait();
+  }
+  sourceBlocksCache_->clear();
+  metrics_.src_blocks_cache_size_bytes_.Get().Set(0);
+}
+
 void BCStateTran::clearIoContexts() {
   TimeRecorder scoped_timer(*histograms_.time_to_clear_io_contexts);
 
@@ -1950,6 +2238,7 @@ void BCStateTran::sourcePrepareBatch(uint64_t numBlocksRequested) {
   // 2) The front context blockId equals m->maxBlockId.
   // 3) Exact prediction: numBlocksRequested equal exactly to sizeIoContexts, and all expected block IDs are ordered
   //  in declining order.
+  // 4) All contexts were invoked with the compression of this batch.
 
   //
   // TODO: Consider adding optimization which allows keeping matching blocks from any non-empty ioContexts_. In that
@@ -1968,8 +2257,10 @@ void BCStateTran::sourcePrepareBatch(uint64_t numBlocksRequested) {
     auto j{sb.nextBlockId};
     size_t i{};
     for (; i < std::min(numBlocksRequested, sizeIoContexts); ++i, --j) {
-      if ((ioContexts_[i]->blockId != j) || (!ioContexts_[i]->future.valid())) {
-        // found an invalid future or non-matching blockId. in that case we stop and clear the whole ioContexts_.
+      if ((ioContexts_[i]->blockId != j) || (!ioContexts_[i]->future.valid()) ||
+          (ioContexts_[i]->compressionType != sb.compressionType)) {
+        // found an invalid future, non-matching blockId or compression. in that case we stop and clear the whole
+        // ioContexts_.
         break;
       }
     }
@@ -2014,15 +2305,16 @@ void BCStateTran::onMessage(STMessageUptr<FetchBlocksMsg> m, uint32_t msgLen, ui
                  m->maxBlockId,
                  m->maxBlockIdInCycle,
                  m->rvbGroupId,
-                 m->lastKnownChunkInLastRequiredBlock));
+                 m->lastKnownChunkInLastRequiredBlock,
+                 (int)m->requestedCompressionType(msgLen)));
   metrics_.received_fetch_blocks_msg_++;
 
   // if msg is invalid
-  if (msgLen < sizeof(FetchBlocksMsg) || m->msgSeqNum == 0 || m->minBlockId == 0 || m->maxBlockId < m->minBlockId ||
-      m->maxBlockId > m->maxBlockIdInCycle) {
+  if (msgLen < FetchBlocksMsg::sizeWithoutCompressionType() || m->msgSeqNum == 0 || m->minBlockId == 0 ||
+      m->maxBlockId < m->minBlockId || m->maxBlockId > m->maxBlockIdInCycle) {
     LOG_WARN(logger_,
              "Msg is invalid: " << KVLOG(msgLen,
-                                         sizeof(FetchBlocksMsg),
+                                         FetchBlocksMsg::sizeWithoutCompressionType(),
                                          replicaId,
                                          m->msgSeqNum,
                                          m->minBlockId,
@@ -2098,10 +2390,14 @@ void BCStateTran::onMessage(STMessageUptr<FetchBlocksMsg> m, uint32_t msgLen, ui
                     config_,
                     rvbGroupDigestsExpectedSize,
                     m.get(),
-                    replicaId);
+                    replicaId,
+                    getSourceCompressionType(m->requestedCompressionType(msgLen)));
   ConcordAssertEQ(sourceBatch_.destReplicaId, sourceSession_.ownerDestReplicaId());
 
   sourcePrepareBatch(numBlocksRequested);
+  if (sourceBlocksCache_) {
+    sourceReadAhead(*m, replicaId);
+  }
 
   LOG_INFO(logger_,
            "Start sending batch:" + sourceBatch_.toString() << KVLOG(numBlocksRequested,
@@ -2158,8 +2454,21 @@ void BCStateTran::continueSendBatch() {
       }
       ConcordAssertGT(ctx->actualBlockSize, 0);
       ConcordAssertEQ(ctx->blockId, sb.nextBlockId);
-      LOG_DEBUG(logger_, "Start sending next block: " << KVLOG(sb.batchNumber, sb.nextBlockId, ctx->actualBlockSize));
-      histograms_.src_get_block_size_bytes->record(ctx->actualBlockSize);
+      LOG_DEBUG(logger_,
+                "Start sending next block: " << KVLOG(
+                    sb.batchNumber, sb.nextBlockId, ctx->actualBlockSize, ctx->uncompressedBlockSize));
+      if (ctx->uncompressedBlockSize > 0) {
+        histograms_.src_get_block_size_bytes->record(ctx->uncompressedBlockSize);
+        histograms_.src_compressed_block_size_bytes->record(ctx->actualBlockSize);
+        metrics_.src_num_compressed_blocks_++;
+        metrics_.src_compressed_blocks_raw_bytes_ += ctx->uncompressedBlockSize;
+        metrics_.src_compressed_blocks_compressed_bytes_ += ctx->actualBlockSize;
+      } else {
+        histograms_.src_get_block_size_bytes->record(ctx->actualBlockSize);
+        if (ctx->compressionType != CompressionType::NONE) {
+          metrics_.src_num_incompressible_blocks_++;
+        }
+      }
       sb.getNextBlock = false;
     }
     buffer = ctx->blockData.get();
@@ -2189,12 +2498,17 @@ void BCStateTran::continueSendBatch() {
     ConcordAssertGT(chunkSize, 0);
 
     char *pRawChunk = buffer + (sb.nextChunk - 1) * config_.maxChunkSize;
-    auto outMsg = ItemDataMsg::alloc(chunkSize + sb.rvbGroupDigestsExpectedSize);
+    // Blocks are compressed only for destinations which requested it, so older destinations get plain ItemData
+    const bool compressed = (ctx->uncompressedBlockSize > 0);
+    auto outMsg = ItemDataMsg::alloc(chunkSize + sb.rvbGroupDigestsExpectedSize, compressed);
 
     outMsg->requestMsgSeqNum = m->msgSeqNum;
     outMsg->blockNumber = sb.nextBlockId;
     outMsg->totalNumberOfChunksInBlock = numOfChunksInNextBlock;
     outMsg->chunkNumber = sb.nextChunk;
+    if (compressed) {
+      outMsg->setCompressionInfo(static_cast<uint8_t>(ctx->compressionType), ctx->uncompressedBlockSize);
+    }
 
     outMsg->lastInBatch =
         ((sb.numSentChunks + 1) >= config_.maxNumberOfChunksInBatch) || ((sb.nextBlockId - 1) < m->minBlockId);
@@ -2236,6 +2550,7 @@ void BCStateTran::continueSendBatch() {
                                                outMsg->chunkNumber,
                                                outMsg->getDataSize(),
                                                outMsg->rvbDigestsSize,
+                                               (int)outMsg->compressionType(),
                                                (bool)outMsg->lastInBatch));
 
     metrics_.sent_item_data_msg_++;
@@ -2244,6 +2559,10 @@ void BCStateTran::continueSendBatch() {
     sb.numSentBytes += (chunkSize + sb.rvbGroupDigestsExpectedSize);
 
     auto finalizeContext = [&]() {
+      // Keep blocks read on demand for other destinations. Only raw blocks are cached.
+      if (sourceBlocksCache_ && (ctx->uncompressedBlockSize == 0)) {
+        sourceBlocksCache_->put(ctx->blockId, ctx->blockData.get(), ctx->actualBlockSize);
+      }
       ioPool_.free(ctx);
       ioContexts_.pop_front();
 
@@ -2291,6 +2610,11 @@ void BCStateTran::continueSendBatch() {
   histograms_.src_send_batch_num_of_chunks->record(sb.numSentChunks);
   src_send_batch_duration_rec_.end();
   metrics_.src_overall_batches_sent_++;
+  sourceSession_.addSentBytes(sb.numSentBytes);
+  metrics_.src_session_bytes_throughput_.Get().Set(sourceSession_.bytesThroughput());
+  if (sourceBlocksCache_) {
+    metrics_.src_blocks_cache_size_bytes_.Get().Set(sourceBlocksCache_->sizeBytes());
+  }
   if (sb.prefetched) {
     src_send_prefetched_batch_duration_rec_.end();
     metrics_.src_overall_prefetched_batches_sent_++;
@@ -2474,6 +2798,18 @@ void BCStateTran::onMessage(STMessageUptr<RejectFetchingMsg> m, uint32_t msgLen,
     return;
   }
 
+  // Rejection of a stripe request - the stripe is cancelled and its source is suspended for a while
+  if ((fs == FetchingState::GettingMissingBlocks) && (sourceSelector_.currentReplica() != replicaId)) {
+    auto stripe = stripeManager_.getStripeBySource(replicaId);
+    if (stripe && (stripe->msgSeqNum == m->requestMsgSeqNum) &&
+        (m->rejectionCode != RejectFetchingMsg::Reason::RES_PAGE_NOT_FOUND)) {
+      LOG_INFO(logger_, "Stripe request rejected:" << KVLOG(replicaId, m->rejectionCode, itr->second));
+      cancelStripe(replicaId, StripeCancelReason::REJECTED);
+      dispatchStripes();
+      return;
+    }
+  }
+
   // if msg is not relevant
   if ((sourceSelector_.currentReplica() != replicaId) || (lastMsgSeqNum_ != m->requestMsgSeqNum) ||
       ((fs == FetchingState::GettingMissingBlocks) &&
@@ -2556,7 +2892,8 @@ void BCStateTran::onMessage(STMessageUptr<ItemDataMsg> m,
   // if msg is invalid
   if ((msgLen != m->size()) || (msgRequestSeqNum == 0) || (m->blockNumber == 0) ||
       (m->totalNumberOfChunksInBlock == 0) || (m->totalNumberOfChunksInBlock > MaxNumOfChunksInBlock) ||
-      (m->chunkNumber == 0) || (msgDataSize == 0) || (msgRvbDigestsSize >= msgDataSize)) {
+      (m->chunkNumber == 0) || (m->chunkNumber > m->totalNumberOfChunksInBlock) || (msgDataSize == 0) ||
+      (msgRvbDigestsSize >= msgDataSize)) {
     LOG_WARN(logger_,
              "Msg is invalid: " << KVLOG(replicaId,
                                          msgLen,
@@ -2573,6 +2910,12 @@ void BCStateTran::onMessage(STMessageUptr<ItemDataMsg> m,
   }
 
   auto fetchingState = fs;
+  if ((fs == FetchingState::GettingMissingBlocks) && stripeManager_.getStripeBySource(replicaId) &&
+      ((sourceSelector_.currentReplica() != replicaId) || (fetchState_.minBlockId > m->blockNumber) ||
+       (fetchState_.nextBlockId < m->blockNumber))) {
+    onStripeItemDataMsg(std::move(m), replicaId);
+    return;
+  }
   if (fs == FetchingState::GettingMissingBlocks) {
     // Reasons for dropping a message as "irrelevant" for this state:
     // 1) Not the source we chose
@@ -2582,7 +2925,8 @@ void BCStateTran::onMessage(STMessageUptr<ItemDataMsg> m,
     // delayed due to retransmissions, but it should still be valid block with an expected ID. No reason to drop.
     if ((sourceSelector_.currentReplica() != replicaId) || (fetchState_.minBlockId > m->blockNumber) ||
         (fetchState_.nextBlockId < m->blockNumber) ||
-        (msgDataSize + totalSizeOfPendingItemDataMsgs > config_.maxPendingDataFromSourceReplica)) {
+        (msgDataSize + totalSizeOfPendingItemDataMsgs + totalSizeOfDigestJobs_ >
+         config_.maxPendingDataFromSourceReplica)) {
       LOG_WARN(logger_,
                "Msg is irrelevant: " << KVLOG(replicaId,
                                               fetchingState,
@@ -2595,6 +2939,7 @@ void BCStateTran::onMessage(STMessageUptr<ItemDataMsg> m,
                                               msgRvbDigestsSize,
                                               msgDataSize,
                                               totalSizeOfPendingItemDataMsgs,
+                                              totalSizeOfDigestJobs_,
                                               config_.maxPendingDataFromSourceReplica));
       metrics_.irrelevant_item_data_msg_++;
       return;
@@ -2647,7 +2992,7 @@ void BCStateTran::onMessage(STMessageUptr<ItemDataMsg> m,
 #endif
     totalSizeOfPendingItemDataMsgs += msgDataSize;
     metrics_.total_size_of_pending_item_data_msgs_.Get().Set(totalSizeOfPendingItemDataMsgs);
-    processData(msgLastInBatch, msgRvbDigestsSize);
+    processData(msgLastInBatch);
     return;
   } else {
     LOG_INFO(logger_,
@@ -2656,6 +3001,311 @@ void BCStateTran::onMessage(STMessageUptr<ItemDataMsg> m,
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Striped fetching
+//////////////////////////////////////////////////////////////////////////////
+
+bool BCStateTran::isStripedFetchingActive() const {
+  return config_.enableStripedFetching && (config_.maxNumOfFetchStripes > 0);
+}
+
+// Fill the stripes window: assign the batches which follow the current batch to idle helper sources.
+// A stripe is fetched without RVB group digests, so it is dispatched only if it ends in an RVB which digest is already
+// stored, or in the last required block (validated against the target checkpoint).
+void BCStateTran::dispatchStripes() {
+  if (!isStripedFetchingActive() || !fetchState_.isValid() || !sourceSelector_.hasSource()) {
+    return;
+  }
+  const auto currTime = getMonotonicTimeMilli();
+  const auto lastRequiredBlock = psd_->getLastRequiredBlock();
+
+  // Cancel stripes which are behind the current batch, or overlap it without matching its borders
+  std::vector<uint16_t> staleStripesSources;
+  for (const auto &[sourceId, stripe] : stripeManager_.getStripes()) {
+    if ((stripe.minBlockId <= fetchState_.maxBlockId) &&
+        ((stripe.minBlockId != fetchState_.minBlockId) || (stripe.maxBlockId != fetchState_.maxBlockId))) {
+      staleStripesSources.push_back(sourceId);
+    }
+  }
+  for (auto sourceId : staleStripesSources) {
+    cancelStripe(sourceId, StripeCancelReason::STALE);
+  }
+
+  // Helper sources are all other replicas, except for the current source and the primary
+  auto candidates = allOtherReplicas();
+  candidates.erase(sourceSelector_.currentReplica());
+  candidates.erase(sourceSelector_.currentPrimary());
+
+  uint64_t minBlockId = std::max(fetchState_.maxBlockId, stripeManager_.maxStripedBlockId()) + 1;
+  while (stripeManager_.hasCapacity() && (minBlockId <= lastRequiredBlock)) {
+    const uint64_t maxBlockId = computeBatchMaxBlockId(minBlockId);
+    if (((maxBlockId != lastRequiredBlock) && !isRvbBlockId(maxBlockId)) ||
+        (rvbm_->getFetchBlocksRvbGroupId(minBlockId, maxBlockId) != 0)) {
+      break;
+    }
+    const auto sourceId = stripeManager_.selectSource(candidates, currTime);
+    if (sourceId == NO_REPLICA) {
+      break;
+    }
+    const auto &stripe = stripeManager_.addStripe(minBlockId, maxBlockId, sourceId, uniqueMsgSeqNum(), currTime);
+    sendFetchBlocksMsgToStripeSource(stripe, maxBlockId, 0);
+    minBlockId = maxBlockId + 1;
+  }
+}
+
+void BCStateTran::sendFetchBlocksMsgToStripeSource(const Stripe &stripe,
+                                                   uint64_t maxBlockId,
+                                                   int16_t lastKnownChunkInLastRequiredBlock) {
+  FetchBlocksMsg msg;
+  msg.msgSeqNum = stripe.msgSeqNum;
+  msg.minBlockId = stripe.minBlockId;
+  msg.maxBlockId = maxBlockId;
+  msg.maxBlockIdInCycle = psd_->getLastRequiredBlock();
+  msg.lastKnownChunkInLastRequiredBlock = lastKnownChunkInLastRequiredBlock;
+  // RVB group digests are already stored
+  msg.rvbGroupId = 0;
+  msg.compressionType = static_cast<uint8_t>(requestedCompressionType_);
+
+  LOG_INFO(logger_,
+           "Sending FetchBlocksMsg (stripe):" << KVLOG(stripe.sourceId,
+                                                       msg.msgSeqNum,
+                                                       msg.minBlockId,
+                                                       msg.maxBlockId,
+                                                       msg.maxBlockIdInCycle,
+                                                       msg.lastKnownChunkInLastRequiredBlock));
+  replicaForStateTransfer_->sendStateTransferMessage(
+      reinterpret_cast<char *>(&msg), sizeof(FetchBlocksMsg), stripe.sourceId);
+  metrics_.sent_fetch_blocks_msg_++;
+}
+
+void BCStateTran::onStripeItemDataMsg(STMessageUptr<ItemDataMsg> m, uint16_t replicaId) {
+  auto stripe = stripeManager_.getStripeBySource(replicaId);
+  ConcordAssertNE(stripe, nullptr);
+  const auto msgRequestSeqNum = m->requestMsgSeqNum;
+  const auto msgDataSize = m->getDataSize();
+  const bool msgLastInBatch = m->lastInBatch;
+  const auto currTime = getMonotonicTimeMilli();
+
+  if (msgRequestSeqNum != stripe->msgSeqNum) {
+    // A late reply to an older request of this source: either a former request of the stripe, or a request which was
+    // sent to this source while it was the current source
+    LOG_WARN(logger_, "Msg is irrelevant (stripe): " << KVLOG(replicaId, msgRequestSeqNum, stripe->toString()));
+    metrics_.irrelevant_item_data_msg_++;
+    return;
+  }
+  if (m->rvbDigestsSize > 0) {
+    // RVB group digests were not requested
+    LOG_WARN(logger_, "Unexpected RVB digests in stripe data:" << KVLOG(replicaId, msgRequestSeqNum, m->blockNumber));
+    cancelStripe(replicaId, StripeCancelReason::BAD_DATA);
+    dispatchStripes();
+    return;
+  }
+  if (stripe->completed || (m->blockNumber < stripe->minBlockId) || (m->blockNumber > stripe->maxBlockId) ||
+      (msgDataSize + totalSizeOfStripesItemDataMsgs_ > config_.maxPendingDataFromSourceReplica)) {
+    LOG_WARN(logger_,
+             "Msg is irrelevant (stripe): " << KVLOG(replicaId,
+                                                     msgRequestSeqNum,
+                                                     m->blockNumber,
+                                                     stripe->toString(),
+                                                     msgDataSize,
+                                                     totalSizeOfStripesItemDataMsgs_,
+                                                     config_.maxPendingDataFromSourceReplica));
+    metrics_.irrelevant_item_data_msg_++;
+    return;
+  }
+
+  bool added = false;
+  tie(std::ignore, added) = stripesItemDataMsgs_[replicaId].emplace(std::move(m));
+  if (!added) {
+    LOG_DEBUG(logger_, "ItemDataMsg was NOT added to stripe: " << KVLOG(replicaId, msgRequestSeqNum));
+    return;
+  }
+  totalSizeOfStripesItemDataMsgs_ += msgDataSize;
+  stripeManager_.onDataReceived(replicaId, msgDataSize, currTime);
+
+  bool badData = false;
+  uint64_t nextMissingBlock = 0;
+  int16_t lastKnownChunk = 0;
+  if (!checkStripeData(*stripe, badData, nextMissingBlock, lastKnownChunk)) {
+    if (badData) {
+      cancelStripe(replicaId, StripeCancelReason::BAD_DATA);
+      dispatchStripes();
+    } else if (msgLastInBatch) {
+      // The source has ended its batch before the stripe is complete - ask for the rest of the stripe
+      stripe->msgSeqNum = uniqueMsgSeqNum();
+      sendFetchBlocksMsgToStripeSource(*stripe, nextMissingBlock, lastKnownChunk);
+    }
+    return;
+  }
+
+  stripeManager_.onStripeCompleted(replicaId, currTime);
+  if ((waitingForStripeSinceMilli_ > 0) && (stripe->minBlockId == fetchState_.minBlockId) &&
+      (stripe->maxBlockId == fetchState_.maxBlockId)) {
+    processData();
+  }
+}
+
+// Returns true if all the chunks of all the blocks of a stripe are available. Otherwise, returns the highest block
+// which is missing chunks, and the last chunk available in this block. Data is not validated here (only its
+// structure) - blocks are validated when the stripe is consumed.
+bool BCStateTran::checkStripeData(const Stripe &stripe,
+                                  bool &outBadDataDetected,
+                                  uint64_t &outNextMissingBlock,
+                                  int16_t &outLastKnownChunk) const {
+  outBadDataDetected = false;
+  outNextMissingBlock = stripe.maxBlockId;
+  outLastKnownChunk = 0;
+  auto it = stripesItemDataMsgs_.find(stripe.sourceId);
+  if (it == stripesItemDataMsgs_.end()) {
+    return false;
+  }
+
+  const auto &msgs = it->second;
+  auto msgIt = msgs.begin();
+  for (uint64_t blockId = stripe.maxBlockId; blockId >= stripe.minBlockId; --blockId) {
+    uint16_t totalNumberOfChunks = 0;
+    uint16_t maxAvailableChunk = 0;
+    uint32_t blockSize = 0;
+    for (; (msgIt != msgs.end()) && ((*msgIt)->blockNumber == blockId); ++msgIt) {
+      const auto &msg = *msgIt;
+      if (totalNumberOfChunks == 0) totalNumberOfChunks = msg->totalNumberOfChunksInBlock;
+      blockSize += msg->getDataSize();
+      if ((totalNumberOfChunks != msg->totalNumberOfChunksInBlock) || (msg->chunkNumber > totalNumberOfChunks) ||
+          (blockSize > config_.maxBlockSize)) {
+        LOG_WARN(logger_, "Bad stripe data:" << KVLOG(stripe.sourceId, blockId, msg->chunkNumber, blockSize));
+        outBadDataDetected = true;
+        return false;
+      }
+      if (maxAvailableChunk + 1 == msg->chunkNumber) maxAvailableChunk = msg->chunkNumber;
+    }
+    if ((totalNumberOfChunks == 0) || (maxAvailableChunk < totalNumberOfChunks)) {
+      outNextMissingBlock = blockId;
+      outLastKnownChunk = static_cast<int16_t>(maxAvailableChunk);
+      return false;
+    }
+  }
+  return true;
+}
+
+void BCStateTran::cancelStripe(uint16_t sourceId, StripeCancelReason reason) {
+  auto it = stripesItemDataMsgs_.find(sourceId);
+  if (it != stripesItemDataMsgs_.end()) {
+    for (const auto &msg : it->second) {
+      totalSizeOfStripesItemDataMsgs_ -= msg->getDataSize();
+    }
+    stripesItemDataMsgs_.erase(it);
+  }
+  auto stripe = stripeManager_.getStripeBySource(sourceId);
+  if (stripe && (waitingForStripeSinceMilli_ > 0) && (stripe->minBlockId == fetchState_.minBlockId) &&
+      (stripe->maxBlockId == fetchState_.maxBlockId)) {
+    // Stop waiting - the current batch should be requested from the current source
+    waitingForStripeSinceMilli_ = 0;
+    postponedSendFetchBlocksMsg_ = true;
+  }
+  stripeManager_.cancelStripe(sourceId, reason, getMonotonicTimeMilli());
+}
+
+void BCStateTran::clearAllStripes() {
+  stripesItemDataMsgs_.clear();
+  totalSizeOfStripesItemDataMsgs_ = 0;
+  consumedStripeSourceId_ = NO_REPLICA;
+  waitingForStripeSinceMilli_ = 0;
+  stripeManager_.reset();
+}
+
+void BCStateTran::checkStripesTimeouts() {
+  if (!isStripedFetchingActive()) {
+    return;
+  }
+  for (auto sourceId : stripeManager_.getInactiveStripesSources(getMonotonicTimeMilli())) {
+    cancelStripe(sourceId, StripeCancelReason::TIMEOUT);
+  }
+  dispatchStripes();
+}
+
+// If the current batch is fully available from a completed stripe, move the stripe data into pendingItemDataMsgs.
+// The data is then validated and committed by processData, exactly as if it was sent by the current source.
+bool BCStateTran::tryConsumeStripe() {
+  if (!isStripedFetchingActive() || (consumedStripeSourceId_ != NO_REPLICA) || !fetchState_.isValid() ||
+      (fetchState_.nextBlockId != fetchState_.maxBlockId)) {
+    return false;
+  }
+  auto stripe = stripeManager_.getStripeByRange(fetchState_.minBlockId, fetchState_.maxBlockId);
+  if (!stripe || !stripe->completed) {
+    return false;
+  }
+
+  const auto sourceId = stripe->sourceId;
+  auto it = stripesItemDataMsgs_.find(sourceId);
+  ConcordAssert(it != stripesItemDataMsgs_.end());
+  auto &msgs = it->second;
+  uint32_t stripeDataSize = 0;
+  for (const auto &msg : msgs) {
+    stripeDataSize += msg->getDataSize();
+  }
+  if ((rvbm_->getFetchBlocksRvbGroupId(fetchState_.minBlockId, fetchState_.maxBlockId) != 0) ||
+      (stripeDataSize + totalSizeOfPendingItemDataMsgs > config_.maxPendingDataFromSourceReplica)) {
+    LOG_WARN(logger_,
+             "Cannot consume stripe:" << KVLOG(
+                 stripe->toString(), stripeDataSize, totalSizeOfPendingItemDataMsgs, fetchState_));
+    cancelStripe(sourceId, StripeCancelReason::STALE);
+    return false;
+  }
+
+  // Messages which already exist in pendingItemDataMsgs are left in msgs
+  pendingItemDataMsgs.merge(msgs);
+  uint32_t duplicatesDataSize = 0;
+  for (const auto &msg : msgs) {
+    duplicatesDataSize += msg->getDataSize();
+  }
+  totalSizeOfPendingItemDataMsgs += (stripeDataSize - duplicatesDataSize);
+  totalSizeOfStripesItemDataMsgs_ -= stripeDataSize;
+  stripesItemDataMsgs_.erase(it);
+#ifdef ENABLE_ALL_METRICS
+  metrics_.num_pending_item_data_msgs_.Get().Set(pendingItemDataMsgs.size());
+#endif
+  metrics_.total_size_of_pending_item_data_msgs_.Get().Set(totalSizeOfPendingItemDataMsgs);
+
+  LOG_INFO(logger_, "Consuming stripe:" << KVLOG(sourceId, fetchState_, stripeDataSize));
+  stripeManager_.onStripeConsumed(sourceId);
+  consumedStripeSourceId_ = sourceId;
+  waitingForStripeSinceMilli_ = 0;
+  postponedSendFetchBlocksMsg_ = false;
+  dispatchStripes();
+  return true;
+}
+
+// Returns true if the current batch should not be requested from the current source, since it is already being
+// fetched by a stripe which is not late
+bool BCStateTran::shouldWaitForStripe(int16_t lastKnownChunkInLastRequiredBlock) {
+  if ((lastKnownChunkInLastRequiredBlock != 0) || (fetchState_.nextBlockId != fetchState_.maxBlockId) ||
+      (consumedStripeSourceId_ != NO_REPLICA)) {
+    return false;
+  }
+  auto stripe = stripeManager_.getStripeByRange(fetchState_.minBlockId, fetchState_.maxBlockId);
+  if (!stripe) {
+    return false;
+  }
+  if (stripe->completed || (stripe->sourceId == sourceSelector_.currentReplica())) {
+    // Either a completed stripe which could not be consumed, or a stripe which is going to be overridden
+    cancelStripe(stripe->sourceId, StripeCancelReason::STALE);
+    return false;
+  }
+
+  const auto currTime = getMonotonicTimeMilli();
+  if (waitingForStripeSinceMilli_ == 0) {
+    waitingForStripeSinceMilli_ = currTime;
+  }
+  if (stripeManager_.isStripeLate(*stripe, waitingForStripeSinceMilli_, currTime)) {
+    LOG_WARN(logger_, "Stripe is late:" << KVLOG(stripe->toString(), waitingForStripeSinceMilli_, currTime));
+    cancelStripe(stripe->sourceId, StripeCancelReason::TIMEOUT);
+    return false;
+  }
+  // The current source is idle while waiting - avoid retransmissions to it
+  sourceSelector_.setFetchingTimeStamp(currTime, false);
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // cache that holds virtual blocks
 //////////////////////////////////////////////////////////////////////////////
@@ -2785,6 +3435,8 @@ void BCStateTran::clearAllPendingItemsData() {
 
   pendingItemDataMsgs.clear();
   totalSizeOfPendingItemDataMsgs = 0;
+  clearDigestJobs();
+  consumedStripeSourceId_ = NO_REPLICA;
 #ifdef ENABLE_ALL_METRICS
   metrics_.num_pending_item_data_msgs_.Get().Set(0);
 #endif
@@ -2817,6 +3469,8 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
                                    int16_t &outLastChunkInRequiredBlock,
                                    char *outBlock,
                                    uint32_t &outBlockSize,
+                                   CompressionType &outCompressionType,
+                                   uint32_t &outUncompressedBlockSize,
                                    bool isVBLock) {
   ConcordAssertGE(requiredBlock, 1);
 
@@ -2825,11 +3479,15 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
   outBadDataDetected = false;
   outLastChunkInRequiredBlock = 0;
   outBlockSize = 0;
+  outCompressionType = CompressionType::NONE;
+  outUncompressedBlockSize = 0;
   bool badData = false;
   bool fullBlock = false;
   uint16_t totalNumberOfChunks = 0;
   uint16_t maxAvailableChunk = 0;
   uint32_t blockSize = 0;
+  uint8_t compressionType = 0;
+  uint32_t uncompressedBlockSize = 0;
 
   for (const auto &msg : pendingItemDataMsgs) {
     if (msg->blockNumber != requiredBlock) {
@@ -2838,10 +3496,16 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
     // the conditions of these asserts are checked when receiving the message
     ConcordAssertGT(msg->totalNumberOfChunksInBlock, 0);
     ConcordAssertGE(msg->chunkNumber, 1);
-    if (totalNumberOfChunks == 0) totalNumberOfChunks = msg->totalNumberOfChunksInBlock;
+    if (totalNumberOfChunks == 0) {
+      totalNumberOfChunks = msg->totalNumberOfChunksInBlock;
+      compressionType = msg->compressionType();
+      uncompressedBlockSize = msg->uncompressedBlockSize();
+    }
     blockSize += (msg->getDataSize() - msg->rvbDigestsSize);
-    if (totalNumberOfChunks != msg->totalNumberOfChunksInBlock || msg->chunkNumber > totalNumberOfChunks ||
-        blockSize > maxSize) {
+    // Any chunk of the block beyond the last one is bad data, the same rule is applied by createBlockDigestJob
+    if (fullBlock || totalNumberOfChunks != msg->totalNumberOfChunksInBlock || msg->chunkNumber > totalNumberOfChunks ||
+        blockSize > maxSize || compressionType != msg->compressionType() ||
+        uncompressedBlockSize != msg->uncompressedBlockSize()) {
       badData = true;
       break;
     }
@@ -2854,12 +3518,10 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
     ConcordAssertLE(maxAvailableChunk, totalNumberOfChunks);
     if (maxAvailableChunk == totalNumberOfChunks) {
       fullBlock = true;
-      break;
     }
   }
 
   if (badData) {
-    ConcordAssert(!fullBlock);
     outBadDataDetected = true;
     outLastChunkInRequiredBlock = 0;
     return false;
@@ -2897,18 +3559,137 @@ bool BCStateTran::getNextFullBlock(uint64_t requiredBlock,
 
     if (currentChunk == totalNumberOfChunks) {
       outBlockSize = currentPos;
+      outCompressionType = static_cast<CompressionType>(compressionType);
+      outUncompressedBlockSize = uncompressedBlockSize;
       return true;
     }
   }  // while (true)
 }
 
-bool BCStateTran::checkBlock(uint64_t blockId, char *block, uint32_t blockSize) const {
-  Digest computedBlockDigest;
-  {
-    histograms_.compute_block_digest_size->record(blockSize);
-    TimeRecorder scoped_timer(*histograms_.compute_block_digest_duration);
-    this->computeDigestOfBlock(blockId, block, blockSize, &computedBlockDigest);
+void BCStateTran::dispatchBlockDigestJobs() {
+  auto it = pendingItemDataMsgs.begin();
+  while (it != pendingItemDataMsgs.end()) {
+    const uint64_t blockId = (*it)->blockNumber;
+    auto blockEnd =
+        std::find_if(it, pendingItemDataMsgs.end(), [blockId](const auto &msg) { return msg->blockNumber != blockId; });
+    if ((blockId >= fetchState_.minBlockId) && (blockId <= fetchState_.nextBlockId) &&
+        (digestJobs_.find(blockId) == digestJobs_.end())) {
+      auto job = createBlockDigestJob(it, blockEnd);
+      if (job) {
+        digestJobs_.emplace(blockId, std::move(job));
+        histograms_.dst_num_pending_digest_jobs->record(digestJobs_.size());
+      }
+    }
+    it = blockEnd;
+  }
+#ifdef ENABLE_ALL_METRICS
+  metrics_.num_pending_item_data_msgs_.Get().Set(pendingItemDataMsgs.size());
+#endif
+  metrics_.total_size_of_pending_item_data_msgs_.Get().Set(totalSizeOfPendingItemDataMsgs);
+}
+
+// Returns nullptr if the block is not full, or malformed. A block is full if it consists of exactly chunks
+// 1..totalNumberOfChunksInBlock, as in getNextFullBlock. Malformed blocks (e.g. with surplus chunks) are left in
+// pendingItemDataMsgs - bad data is detected by getNextFullBlock when the block becomes the next required block.
+BCStateTran::BlockDigestJobPtr BCStateTran::createBlockDigestJob(
+    set<STMessageUptr<ItemDataMsg>, compareItemDataMsg>::iterator first,
+    set<STMessageUptr<ItemDataMsg>, compareItemDataMsg>::iterator last) {
+  const auto &firstMsg = *first;
+  uint16_t numOfChunks = 0;
+  uint32_t receivedSize = 0;
+  uint32_t rvbDigestsSize = 0;
+  bool lastInBatch = false;
+  for (auto it = first; it != last; ++it) {
+    const auto &msg = *it;
+    ++numOfChunks;
+    if ((msg->chunkNumber != numOfChunks) || (msg->chunkNumber > firstMsg->totalNumberOfChunksInBlock) ||
+        (msg->totalNumberOfChunksInBlock != firstMsg->totalNumberOfChunksInBlock) ||
+        (msg->compressionType() != firstMsg->compressionType()) ||
+        (msg->uncompressedBlockSize() != firstMsg->uncompressedBlockSize())) {
+      return nullptr;
+    }
+    receivedSize += msg->getDataSize();
+    rvbDigestsSize += msg->rvbDigestsSize;
+    lastInBatch = lastInBatch || msg->lastInBatch;
+  }
+  if ((numOfChunks != firstMsg->totalNumberOfChunksInBlock) || (receivedSize - rvbDigestsSize > config_.maxBlockSize)) {
+    return nullptr;
+  }
+
+  auto job = std::make_shared<BlockDigestJob>();
+  job->blockId = firstMsg->blockNumber;
+  job->rvbDigestsSize = rvbDigestsSize;
+  job->receivedSize = receivedSize;
+  job->totalNumberOfChunks = numOfChunks;
+  job->lastInBatch = lastInBatch;
+  job->compressionType = static_cast<CompressionType>(firstMsg->compressionType());
+  job->uncompressedBlockSize = firstMsg->uncompressedBlockSize();
+  job->data.resize(receivedSize);
+  // RVB group digests are placed first, whatever chunk they were sent with
+  uint32_t rvbDigestsPos = 0;
+  uint32_t blockPos = rvbDigestsSize;
+  for (auto it = first; it != last;) {
+    const auto &msg = *it;
+    memcpy(job->data.data() + rvbDigestsPos, msg->data, msg->rvbDigestsSize);
+    memcpy(job->data.data() + blockPos, msg->data + msg->rvbDigestsSize, msg->getDataSize() - msg->rvbDigestsSize);
+    rvbDigestsPos += msg->rvbDigestsSize;
+    blockPos += msg->getDataSize() - msg->rvbDigestsSize;
+    totalSizeOfPendingItemDataMsgs -= msg->getDataSize();
+    it = pendingItemDataMsgs.erase(it);
   }
+  totalSizeOfDigestJobs_ += receivedSize;
+
+  bool decompress = (job->compressionType != CompressionType::NONE);
+  if (decompress && ((requestedCompressionType_ == CompressionType::NONE) || (job->uncompressedBlockSize == 0) ||
+                     (job->uncompressedBlockSize > config_.maxBlockSize))) {
+    // Not worth a worker - the block is rejected when it is consumed
+    job->decompressionFailed = true;
+    decompress = false;
+  }
+  job->dispatchTime = steady_clock::now();
+  job->future = digestWorkers_->async(
+      [queueRecorder = histograms_.dst_digest_job_queue_duration,
+       jobRecorder = histograms_.dst_digest_job_duration,
+       decompressRecorder = histograms_.dst_decompress_block_duration,
+       digestCalcRecorder = histograms_.dst_digest_calc_duration,
+       decompress](BlockDigestJobPtr job) {
+        queueRecorder->recordAtomic(duration_cast<microseconds>(steady_clock::now() - job->dispatchTime).count());
+        {
+          TimeRecorder<true> scoped_timer(*jobRecorder);
+          if (decompress) {
+            TimeRecorder<true> decompress_timer(*decompressRecorder);
+            std::vector<char> decompressed(job->rvbDigestsSize + job->uncompressedBlockSize);
+            memcpy(decompressed.data(), job->data.data(), job->rvbDigestsSize);
+            job->decompressionFailed = !BlockCompressor::decompress(job->compressionType,
+                                                                    job->data.data() + job->rvbDigestsSize,
+                                                                    job->data.size() - job->rvbDigestsSize,
+                                                                    decompressed.data() + job->rvbDigestsSize,
+                                                                    job->uncompressedBlockSize);
+            if (!job->decompressionFailed) {
+              job->data.swap(decompressed);
+            }
+          }
+          if (!job->decompressionFailed) {
+            TimeRecorder<true> digest_timer(*digestCalcRecorder);
+            computeDigestOfBlock(job->blockId,
+                                 job->data.data() + job->rvbDigestsSize,
+                                 job->data.size() - job->rvbDigestsSize,
+                                 &job->digest);
+          }
+        }
+        job->doneTime = steady_clock::now();
+      },
+      job);
+  return job;
+}
+
+void BCStateTran::clearDigestJobs() {
+  // Jobs which are still running own their data, there is no need to wait for them
+  digestJobs_.clear();
+  totalSizeOfDigestJobs_ = 0;
+}
+
+bool BCStateTran::checkBlock(uint64_t blockId, const Digest &computedBlockDigest) const {
   if (isRvbBlockId(blockId)) {
     auto rvbDigest = rvbm_->getDigestFromStoredRvb(blockId);
     std::string rvbDigestStr = !rvbDigest ? "" : rvbDigest.value().get().toString();
@@ -2982,7 +3763,7 @@ bool BCStateTran::checkVirtualBlockOfResPages(const Digest &expectedDigestOfResP
   }
 
   Digest computedDigest;
-  computeDigestOfPagesDescriptor(pagesDesc, computedDigest);
+  computeDigestOfPagesDescriptor(pagesDesc, computedDigest, targetCheckpointDesc_.resPagesDigestVersion);
   LOG_INFO(logger_, pagesDesc->toString(computedDigest.toString()));
   psd_->free(pagesDesc);
 
@@ -3128,7 +3909,7 @@ bool BCStateTran::finalizePutblockAsync(PutBlockWaitPolicy waitPolicy, DataStore
       addOneShotTimer(finalizePutblockTimeoutMilli_, "finalizePutblockAsync");
       break;
     }
-    // currently, fetch must wait to commit before moving into the next batch, so the next assert must always be true
+    // blocks are put (and committed) in descending order inside a batch, and batches are committed in ascending order
     ConcordAssertEQ(ctx->blockId, commitState_.nextBlockId);
     try {
       ConcordAssertEQ(ctx->future.get(), true);
@@ -3136,6 +3917,8 @@ bool BCStateTran::finalizePutblockAsync(PutBlockWaitPolicy waitPolicy, DataStore
       LOG_FATAL(logger_, e.what());
       ConcordAssert(false);
     }
+    histograms_.dst_put_block_to_commit_duration->record(
+        duration_cast<microseconds>(steady_clock::now() - ctx->putTime).count());
 
     LOG_DEBUG(logger_, "Block Committed (written to ST blockchain):" << KVLOG(ctx->blockId));
 
@@ -3159,12 +3942,21 @@ bool BCStateTran::finalizePutblockAsync(PutBlockWaitPolicy waitPolicy, DataStore
       firstRequiredBlockId = commitState_.maxBlockId + 1;
       auto oldCommitState_ = commitState_;
       ConcordAssertLE(firstRequiredBlockId, psd_->getLastRequiredBlock());
+      if (!pendingCommitStates_.empty()) {
+        // Move on to the next fetched batch
+        commitState_ = pendingCommitStates_.front();
+        pendingCommitStates_.pop_front();
+      }
       LOG_INFO(logger_,
                "Done committing blocks [" << oldCommitState_.minBlockId << "," << oldCommitState_.maxBlockId
                                           << "], new commitState_:" << commitState_
-                                          << KVLOG(firstRequiredBlockId, postProcessingUpperBoundBlockId_));
-      ConcordAssert(ioContexts_.empty());
-      break;
+                                          << KVLOG(firstRequiredBlockId,
+                                                   postProcessingUpperBoundBlockId_,
+                                                   pendingCommitStates_.size()));
+      if (commitState_ == oldCommitState_) {
+        ConcordAssert(ioContexts_.empty());
+        break;
+      }
     } else {
       --commitState_.nextBlockId;
       LOG_TRACE(logger_, KVLOG(commitState_));
@@ -3180,22 +3972,28 @@ bool BCStateTran::finalizePutblockAsync(PutBlockWaitPolicy waitPolicy, DataStore
   return doneProcesssing;
 }
 
-// Compute the next batch reqired, taking into accont: minRequiredBlockId
-// and configuration parameters fetchRangeSize and maxNumberOfChunksInBatch
-BCStateTran::BlocksBatchDesc BCStateTran::computeNextBatchToFetch(uint64_t minRequiredBlockId) {
+// Compute the max block ID of a batch which starts at minRequiredBlockId, taking into accont configuration parameters
+// fetchRangeSize and maxNumberOfChunksInBatch
+uint64_t BCStateTran::computeBatchMaxBlockId(uint64_t minRequiredBlockId) const {
   uint64_t maxRequiredBlockId = minRequiredBlockId + config_.maxNumberOfChunksInBatch - 1;
   if (!isRvbBlockId(maxRequiredBlockId)) {
     uint64_t deltaToNearestRVB = maxRequiredBlockId % config_.fetchRangeSize;
     if ((maxRequiredBlockId >= deltaToNearestRVB) && (maxRequiredBlockId - deltaToNearestRVB >= minRequiredBlockId))
       maxRequiredBlockId = maxRequiredBlockId - deltaToNearestRVB;
   }
-  auto lastRequiredBlock = psd_->getLastRequiredBlock();
-  maxRequiredBlockId = std::min(maxRequiredBlockId, lastRequiredBlock);
+  maxRequiredBlockId = std::min(maxRequiredBlockId, psd_->getLastRequiredBlock());
 
   // Check with RVB manager that we are not between borders of RVB groups. This is rare, but we want to avoid the case
   // where we will need to ask for multiple digest groups. This make code more complicated.
   BlockId rvbmUpperBound = rvbm_->getRvbGroupMaxBlockIdOfNonStoredRvbGroup(minRequiredBlockId, maxRequiredBlockId);
-  maxRequiredBlockId = std::min(maxRequiredBlockId, rvbmUpperBound);
+  return std::min(maxRequiredBlockId, rvbmUpperBound);
+}
+
+// Compute the next batch reqired, taking into accont: minRequiredBlockId
+// and configuration parameters fetchRangeSize and maxNumberOfChunksInBatch
+BCStateTran::BlocksBatchDesc BCStateTran::computeNextBatchToFetch(uint64_t minRequiredBlockId) {
+  auto lastRequiredBlock = psd_->getLastRequiredBlock();
+  uint64_t maxRequiredBlockId = computeBatchMaxBlockId(minRequiredBlockId);
   BlocksBatchDesc fetchBatch;
   fetchBatch.maxBlockId = maxRequiredBlockId;
   fetchBatch.nextBlockId = maxRequiredBlockId;
@@ -3204,7 +4002,7 @@ BCStateTran::BlocksBatchDesc BCStateTran::computeNextBatchToFetch(uint64_t minRe
   digestOfNextRequiredBlock_.makeZero();
   ConcordAssert(fetchBatch.isValid());
   ConcordAssertLT(fetchState_.nextBlockId, config_.maxNumberOfChunksInBatch + fetchBatch.minBlockId);
-  LOG_INFO(logger_, KVLOG(minRequiredBlockId, maxRequiredBlockId, rvbmUpperBound, fetchBatch, lastRequiredBlock));
+  LOG_INFO(logger_, KVLOG(minRequiredBlockId, maxRequiredBlockId, fetchBatch, lastRequiredBlock));
   return fetchBatch;
 }
 
@@ -3295,9 +4093,11 @@ void BCStateTran::stReset(DataStoreTransaction *txn, bool resetRvbm, bool resetS
   }
   digestOfNextRequiredBlock_.makeZero();
   clearAllPendingItemsData();
+  clearAllStripes();
   clearInfoAboutGettingCheckpointSummary();
   fetchState_.reset();
   commitState_.reset();
+  pendingCommitStates_.clear();
   sourceSelector_.reset();
   targetCheckpointDesc_.makeZero();
   postponedSendFetchBlocksMsg_ = false;
@@ -3340,7 +4140,7 @@ void BCStateTran::stReset(DataStoreTransaction *txn, bool resetRvbm, bool resetS
   }
 }
 
-void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
+void BCStateTran::processData(bool lastInBatch) {
   const FetchingState fs = getFetchingState();
   const auto fetchingState = fs;
   LOG_DEBUG(logger_, KVLOG(fetchingState));
@@ -3354,6 +4154,16 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
   ConcordAssertOR(isGettingBlocks && (psd_->getLastRequiredBlock() != 0),
                   !isGettingBlocks && (psd_->getLastRequiredBlock() == 0));
   while (true) {
+    if (badDataFromCurrentSourceReplica && (consumedStripeSourceId_ != NO_REPLICA)) {
+      // Data was fetched from a stripe's helper source - penalize the helper source, not the current source.
+      // The rest of the batch is re-fetched from the current source.
+      LOG_WARN(logger_, "Bad data from stripe source:" << KVLOG(consumedStripeSourceId_, fetchState_));
+      stripeManager_.onBadDataFromConsumedStripe(consumedStripeSourceId_);
+      badDataFromCurrentSourceReplica = false;
+      clearAllPendingItemsData();
+      lastInBatch = true;
+    }
+
     //////////////////////////////////////////////////////////////////////////
     // Select a source replica (if need to)
     /////////////////////////////////////////////////////////////////////////
@@ -3400,29 +4210,68 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
     //////////////////////////////////////////////////////////////////////////
     int16_t lastChunkInRequiredBlock = 0;
     uint32_t actualBuffersize = 0;
-
-    // TODO (GL) - for now (for simplicity) to support chunking, we call with buffer_ as an input. Later on we copy
-    // buffer_ into BlockIOContext::blockData when the block is full.
-    // We can save this copy by calling with BlockIOContext::blockData.
-    // But this is more complex. In general, copying memory shouldn't impact performance much (micro-seconds)
-    // so we are OK with it now.
-    const bool newBlock = getNextFullBlock(fetchState_.nextBlockId,
-                                           badDataFromCurrentSourceReplica,
-                                           lastChunkInRequiredBlock,
-                                           buffer_.get(),
-                                           actualBuffersize,
-                                           !isGettingBlocks);
+    uint32_t rvbDigestsSize = 0;
+    CompressionType compressionType = CompressionType::NONE;
+    uint32_t uncompressedBlockSize = 0;
+    BlockDigestJobPtr digestJob;
+    bool newBlock = false;
+
+    if (isGettingBlocks) {
+      // Full blocks are digested by the workers, while we keep on receiving data
+      dispatchBlockDigestJobs();
+      auto jobIt = digestJobs_.find(fetchState_.nextBlockId);
+      if (jobIt != digestJobs_.end()) {
+        if (jobIt->second->future.wait_for(std::chrono::nanoseconds(0)) != std::future_status::ready) {
+          if (newSourceReplica) {
+            postponedSendFetchBlocksMsg_ = true;
+          }
+          addOneShotTimer(digestJobTimeoutMilli_, "Wait for block digest job");
+          break;
+        }
+        digestJob = std::move(jobIt->second);
+        digestJobs_.erase(jobIt);
+        totalSizeOfDigestJobs_ -= digestJob->receivedSize;
+        histograms_.dst_digested_block_wait_duration->record(
+            duration_cast<microseconds>(steady_clock::now() - digestJob->doneTime).count());
+        newBlock = true;
+        lastChunkInRequiredBlock = digestJob->totalNumberOfChunks;
+        actualBuffersize = digestJob->data.size();
+        rvbDigestsSize = digestJob->rvbDigestsSize;
+        // lastInBatch is carried by the block it was sent with
+        lastInBatch = digestJob->lastInBatch;
+      }
+    }
+    if (!digestJob) {
+      // TODO (GL) - for now (for simplicity) to support chunking, we call with buffer_ as an input. Later on we copy
+      // buffer_ into BlockIOContext::blockData when the block is full.
+      // We can save this copy by calling with BlockIOContext::blockData.
+      // But this is more complex. In general, copying memory shouldn't impact performance much (micro-seconds)
+      // so we are OK with it now.
+      newBlock = getNextFullBlock(fetchState_.nextBlockId,
+                                  badDataFromCurrentSourceReplica,
+                                  lastChunkInRequiredBlock,
+                                  buffer_.get(),
+                                  actualBuffersize,
+                                  compressionType,
+                                  uncompressedBlockSize,
+                                  !isGettingBlocks);
+      if (newBlock && isGettingBlocks) {
+        // getNextFullBlock and createBlockDigestJob accept the same blocks, so this is not expected. If they ever
+        // disagree, treat the block as bad data instead of consuming it without a digest
+        LOG_ERROR(logger_, "Full block was not dispatched to a digest job:" << KVLOG(fetchState_.nextBlockId));
+        newBlock = false;
+        badDataFromCurrentSourceReplica = true;
+      }
+    }
     bool newBlockIsValid = false;
-    char *blockData = buffer_.get() + rvbDigestsSize;
+    char *blockData = digestJob ? (digestJob->data.data() + rvbDigestsSize) : buffer_.get();
     size_t blockDataSize = actualBuffersize - rvbDigestsSize;
-    char *rvbDigests = (rvbDigestsSize > 0) ? buffer_.get() : nullptr;
     if (newBlock && isGettingBlocks) {
-      TimeRecorder scoped_timer(*histograms_.dst_digest_calc_duration);
       ConcordAssert(!badDataFromCurrentSourceReplica);
 
       if (rvbDigestsSize > 0) {
         LOG_INFO(logger_, "Setting RVB digests into RVB manager:" << KVLOG(rvbDigestsSize));
-        if (!rvbm_->setSerializedDigestsOfRvbGroup(rvbDigests,
+        if (!rvbm_->setSerializedDigestsOfRvbGroup(digestJob->data.data(),
                                                    rvbDigestsSize,
                                                    fetchState_.minBlockId,
                                                    fetchState_.maxBlockId,
@@ -3437,16 +4286,36 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
         }
       }
 
+      if (!badDataFromCurrentSourceReplica && (digestJob->compressionType != CompressionType::NONE)) {
+        // Block is checked, put and processed in its original form
+        if (digestJob->decompressionFailed) {
+          LOG_ERROR(logger_,
+                    "Failed to decompress block:" << KVLOG(fetchState_.nextBlockId,
+                                                           toString(digestJob->compressionType),
+                                                           blockDataSize,
+                                                           digestJob->uncompressedBlockSize,
+                                                           toString(requestedCompressionType_)));
+          metrics_.dst_decompression_failures_++;
+          badDataFromCurrentSourceReplica = true;
+        } else {
+          metrics_.dst_num_decompressed_blocks_++;
+        }
+      }
+
       if (!badDataFromCurrentSourceReplica) {
-        newBlockIsValid = checkBlock(fetchState_.nextBlockId, blockData, blockDataSize);
+        newBlockIsValid = checkBlock(fetchState_.nextBlockId, digestJob->digest);
         badDataFromCurrentSourceReplica = !newBlockIsValid;
       }
     } else if (newBlock && !isGettingBlocks) {
       ConcordAssert(!badDataFromCurrentSourceReplica);
-      if (!config_.enableReservedPages)
+      if (compressionType != CompressionType::NONE) {
+        // Reserved pages are never compressed
+        newBlockIsValid = false;
+      } else if (!config_.enableReservedPages) {
         newBlockIsValid = true;
-      else
+      } else {
         newBlockIsValid = checkVirtualBlockOfResPages(digestOfNextRequiredBlock_, buffer_.get(), actualBuffersize);
+      }
 
       badDataFromCurrentSourceReplica = !newBlockIsValid;
     } else {
@@ -3470,7 +4339,9 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
         //////////////////////////////////////////////////////////////////////////
         ConcordAssertAND(lastChunkInRequiredBlock >= 1, actualBuffersize > 0);
 
-        sourceSelector_.onReceivedValidBlockFromSource();
+        if (consumedStripeSourceId_ == NO_REPLICA) {
+          sourceSelector_.onReceivedValidBlockFromSource();
+        }
         bool lastFetchedBlockIdInCycle = isLastFetchedBlockIdInCycle(fetchState_.nextBlockId);
         bool minBlockIdInCurrentBatch = fetchState_.isMinBlockId(fetchState_.nextBlockId);
 
@@ -3495,6 +4366,7 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
           // TODO - this can probably be optimized - see TODO above getNextFullBlock
           memcpy(ctx->blockData.get(), blockData, blockDataSize);
           clearPendingItemsData(fetchState_.nextBlockId, fetchState_.nextBlockId);
+          ctx->putTime = steady_clock::now();
           ctx->future = as_->putBlockAsync(fetchState_.nextBlockId, ctx->blockData.get(), ctx->actualBlockSize, false);
           ioContexts_.push_back(std::move(ctx));
           histograms_.dst_num_pending_blocks_to_commit->record(ioContexts_.size());
@@ -3508,21 +4380,33 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
             ConcordAssertLE(nextBatcheMinBlockId, g.txn()->getLastRequiredBlock());
             auto oldFetchState_ = fetchState_;
 
-            // Currently, for simplicity - wait for temproary commit to end.
-            // TODO - it should be possible to push fetchState_ into a new data structure and replace it with
-            // commitState upperBound  work on in the next batch
-            finalizePutblockAsync(PutBlockWaitPolicy::WAIT_ALL_JOBS, g.txn());
+            // Do not wait for the temporary commit to end - the next batch is committed by finalizePutblockAsync
+            // right after the batches before it. Blocks are committed to the ST blockchain, and become reachable only
+            // after post-processing, which is done in batches order.
             fetchState_ = computeNextBatchToFetch(nextBatcheMinBlockId);
-            commitState_ = fetchState_;
+            pendingCommitStates_.push_back(fetchState_);
             LOG_TRACE(logger_, KVLOG(fetchState_, nextBatcheMinBlockId));
             ConcordAssert(commitState_.isValid());
             LOG_INFO(logger_,
                      "Done putting (async) blocks [" << oldFetchState_.minBlockId << "," << oldFetchState_.maxBlockId
-                                                     << "]," << KVLOG(fetchState_));
+                                                     << "],"
+                                                     << KVLOG(fetchState_,
+                                                              commitState_,
+                                                              pendingCommitStates_.size(),
+                                                              consumedStripeSourceId_));
+            if (consumedStripeSourceId_ != NO_REPLICA) {
+              // Done consuming a stripe - the next batch should be requested (or consumed from another stripe)
+              consumedStripeSourceId_ = NO_REPLICA;
+              lastInBatch = true;
+            }
           } else {
             --fetchState_.nextBlockId;
           }
           if (lastInBatch || postponedSendFetchBlocksMsg_ || newSourceReplica) {
+            if (tryConsumeStripe()) {
+              lastInBatch = false;
+              continue;
+            }
             trySendFetchBlocksMsg(0, KVLOG(lastInBatch, postponedSendFetchBlocksMsg_, newSourceReplica));
             break;
           }
@@ -3540,6 +4424,7 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
           // At this stage we haven't yet committed the last block in cycle so we expect the next assert:
           ConcordAssertEQ(fetchState_, commitState_);
           ConcordAssert(ioContexts_.empty());
+          ConcordAssert(pendingCommitStates_.empty());
           // approximation - we put this block later, but have already collected it. Report already now
           reportCollectingStatus(blockDataSize, true);
           blocksFetched_.stop();
@@ -3657,6 +4542,10 @@ void BCStateTran::processData(bool lastInBatch, uint32_t rvbDigestsSize) {
       //////////////////////////////////////////////////////////////////////////
       // if we don't have new full block/vblock (but we did not detect a problem)
       //////////////////////////////////////////////////////////////////////////
+      if (isGettingBlocks && tryConsumeStripe()) {
+        lastInBatch = false;
+        continue;
+      }
       bool retransmissionTimeoutExpired = sourceSelector_.retransmissionTimeoutExpired(currTime);
       if (newSourceReplica || retransmissionTimeoutExpired || postponedSendFetchBlocksMsg_ || lastInBatch) {
         if (isGettingBlocks) {
@@ -3680,7 +4569,9 @@ void BCStateTran::onGettingMissingBlocksEnd(DataStoreTransaction *txn) {
   LOG_INFO(logger_, "Done collecting blocks!");
   fetchState_.reset();
   commitState_.reset();
+  pendingCommitStates_.clear();
   clearAllPendingItemsData();
+  clearAllStripes();
   digestOfNextRequiredBlock_ = targetCheckpointDesc_.digestOfResPagesDescriptor;
   txn->setFirstRequiredBlock(0);
   txn->setLastRequiredBlock(0);
@@ -3806,6 +4697,8 @@ void BCStateTran::checkConfig() {
   // single validation until reaching the next RVB. For now, it is reasonable to have this restriction. To be improved
   // later.
   ConcordAssertLE(config_.fetchRangeSize, config_.maxNumberOfChunksInBatch);
+  ConcordAssertGE(config_.resPagesDigestVersion, static_cast<uint16_t>(DataStore::ResPagesDigestVersion::FLAT));
+  ConcordAssertLT(config_.resPagesDigestVersion, static_cast<uint16_t>(DataStore::ResPagesDigestVersion::LAST));
 }
 
 void BCStateTran::checkFirstAndLastCheckpoint(uint64_t firstStoredCheckpoint, uint64_t lastStoredCheckpoint) {
@@ -3934,7 +4827,8 @@ void BCStateTran::checkStoredCheckpoints(uint64_t firstStoredCheckpoint, uint64_
         ConcordAssertEQ(allPagesDesc->numOfPages, numberOfReservedPages_);
         {
           Digest computedDigestOfResPagesDescriptor;
-          computeDigestOfPagesDescriptor(allPagesDesc, computedDigestOfResPagesDescriptor);
+          computeDigestOfPagesDescriptor(
+              allPagesDesc, computedDigestOfResPagesDescriptor, desc.resPagesDigestVersion);
           LOG_INFO(logger_, allPagesDesc->toString(computedDigestOfResPagesDescriptor.toString()));
           ConcordAssertEQ(computedDigestOfResPagesDescriptor, desc.digestOfResPagesDescriptor);
         }
@@ -3974,7 +4868,13 @@ void BCStateTran::computeDigestOfPage(
   digestGenerator.writeDigest(reinterpret_cast<char *>(&outDigest));
 }
 
-void BCStateTran::computeDigestOfPagesDescriptor(const DataStore::ResPagesDescriptor *pagesDesc, Digest &outDigest) {
+void BCStateTran::computeDigestOfPagesDescriptor(const DataStore::ResPagesDescriptor *pagesDesc,
+                                                 Digest &outDigest,
+                                                 DataStore::ResPagesDigestVersion version) {
+  if (version == DataStore::ResPagesDigestVersion::MERKLE) {
+    outDigest = ResPagesDigestTree::computeDigest(pagesDesc);
+    return;
+  }
   DigestGenerator digestGenerator;
   digestGenerator.update(reinterpret_cast<const char *>(pagesDesc), pagesDesc->size());
   digestGenerator.writeDigest(reinterpret_cast<char *>(&outDigest));
@@ -4023,6 +4923,7 @@ Digest BCStateTran::getBlockAndComputeDigest(uint64_t currBlock) {
 
 void BCStateTran::setAggregator(std::shared_ptr<concordMetrics::Aggregator> aggregator) {
   sourceSelector_.setAggregator(aggregator);
+  stripeManager_.setAggregator(aggregator);
   metrics_component_.SetAggregator(aggregator);
   rvbm_->setAggregator(aggregator);
 }
@@ -4087,16 +4988,33 @@ void BCStateTran::SourceSession::close() {
     LOG_WARN(logger_, "Trying to close a closed session!");
     return;
   }
-  LOG_INFO(
-      logger_,
-      "SourceSession: Session closed:" << std::boolalpha << KVLOG(replicaId_, startTime_, activeDuration(), expired()));
+  LOG_INFO(logger_,
+           "SourceSession: Session closed:" << std::boolalpha
+                                            << KVLOG(replicaId_,
+                                                     startTime_,
+                                                     activeDuration(),
+                                                     expired(),
+                                                     numSentBytes_,
+                                                     bytesThroughput()));
   replicaId_ = UINT16_MAX;
   startTime_ = 0;
+  openTime_ = 0;
+  numSentBytes_ = 0;
+}
+
+uint64_t BCStateTran::SourceSession::bytesThroughput() const {
+  if (openTime_ == 0) {
+    return 0;
+  }
+  auto durationMilli = std::max<uint64_t>(getMonotonicTimeMilli() - openTime_, 1);
+  return (numSentBytes_ * 1000) / durationMilli;
 }
 
 void BCStateTran::SourceSession::open(uint16_t replicaId) {
   replicaId_ = replicaId;
   startTime_ = getMonotonicTimeMilli();
+  openTime_ = startTime_;
+  numSentBytes_ = 0;
   LOG_INFO(logger_, "SourceSession:" << KVLOG(replicaId, startTime_));
 
   auto &registrar = RegistrarSingleton::getInstance();
@@ -4173,7 +5091,8 @@ void BCStateTran::SourceBatch::init(uint64_t batchNumber,
                                     const Config &config,
                                     size_t rvbGroupDigestsExpectedSize,
                                     const FetchBlocksMsg *msg,
-                                    uint16_t destReplicaId) {
+                                    uint16_t destReplicaId,
+                                    CompressionType compressionType) {
   numSentBytes = 0;
   numSentChunks = 0;
   active = true;
@@ -4187,8 +5106,12 @@ void BCStateTran::SourceBatch::init(uint64_t batchNumber,
     preFetchBlockId = std::min(maxBlockIdInCycle, maxBlockId + config.maxNumberOfChunksInBatch);
   }
   this->rvbGroupDigestsExpectedSize = rvbGroupDigestsExpectedSize;
-  this->destRequest = *msg;
+  // An older destination sends the request without the trailing compressionType, don't read beyond it
+  this->destRequest = FetchBlocksMsg{};
+  memcpy(&this->destRequest, msg, FetchBlocksMsg::sizeWithoutCompressionType());
+  this->destRequest.compressionType = static_cast<uint8_t>(compressionType);
   this->destReplicaId = destReplicaId;
+  this->compressionType = compressionType;
 }
 
 }  // namespace impl
@@ -32,6 +32,10 @@
 #include "Messages.hpp"
 #include "util/Metrics.hpp"
 #include "SourceSelector.hpp"
+#include "StripeManager.hpp"
+#include "BlockCompressor.hpp"
+#include "ResPagesDigestTree.hpp"
+#include "SourceBlocksCache.hpp"
 #include "util/callback_registry.hpp"
 #include "util/Handoff.hpp"
 #include "SysConsts.hpp"
@@ -43,6 +47,7 @@
 #include "util/SimpleMemoryPool.hpp"
 #include "messages/MessageBase.hpp"
 #include "util/memory.hpp"
+#include "util/thread_pool.hpp"
 
 using std::set;
 using std::map;
@@ -287,6 +292,40 @@ class BCStateTran : public IStateTransfer {
 
   std::unique_ptr<char[]> buffer_;  // general use buffer
 
+  ///////////////////////////////////////////////////////////////////////////
+  // Blocks compression
+  ///////////////////////////////////////////////////////////////////////////
+
+  // Compression requested by this replica as a destination (NONE if not configured or not supported)
+  const CompressionType requestedCompressionType_;
+  // Compresses blocks on the source side, after they are read from storage. Exists only if compression is enabled.
+  std::unique_ptr<concord::util::ThreadPool> compressionWorkers_;
+  static constexpr uint32_t numOfCompressionWorkers_ = 4;
+
+  CompressionType getRequestedCompressionType() const;
+  // Compression to use as a source, for a destination which requested requestedType
+  CompressionType getSourceCompressionType(uint8_t requestedType) const;
+
+  ///////////////////////////////////////////////////////////////////////////
+  // Reserved pages checkpointing
+  ///////////////////////////////////////////////////////////////////////////
+
+  const DataStore::ResPagesDigestVersion resPagesDigestVersion_;
+  // Used only with ResPagesDigestVersion::MERKLE. Reflects the reserved pages descriptor of checkpoint
+  // resPagesDigestTreeCheckpoint_. It is updated with the pages of each new checkpoint, and rebuilt if the last stored
+  // checkpoint is not resPagesDigestTreeCheckpoint_ (on startup or after state transfer).
+  std::unique_ptr<ResPagesDigestTree> resPagesDigestTree_;
+  uint64_t resPagesDigestTreeCheckpoint_ = 0;
+  // Max number of pending pages which are read and digested (in parallel, by digestWorkers_) together on a checkpoint
+  static constexpr uint32_t maxResPagesInDigestBatch_ = 1024;
+
+  // Associate the pending pages with the checkpoint and return them (page digests are computed in parallel)
+  std::vector<DataStore::SingleResPageDesc> associatePendingResPages(uint64_t checkpointNumber,
+                                                                     DataStoreTransaction* txn);
+  Digest computeDigestOfResPagesDescriptor(uint64_t checkpointNumber,
+                                           const std::vector<DataStore::SingleResPageDesc>& updatedPages,
+                                           DataStoreTransaction* txn);
+
   // random generator
   std::random_device randomDevice_;
   std::mt19937 randomGen_;
@@ -451,6 +490,9 @@ class BCStateTran : public IStateTransfer {
 
   BlocksBatchDesc fetchState_;
   BlocksBatchDesc commitState_;
+  // Batches which were fully fetched and put, waiting for the commit of the batches before them (commitState_ and its
+  // predecessors in the queue). Committing a batch overlaps fetching the next batches.
+  std::deque<BlocksBatchDesc> pendingCommitStates_;
 
   DataStore::CheckpointDesc targetCheckpointDesc_;
   Digest digestOfNextRequiredBlock_;
@@ -476,6 +518,74 @@ class BCStateTran : public IStateTransfer {
   set<STMessageUptr<ItemDataMsg>, compareItemDataMsg> pendingItemDataMsgs;
   uint32_t totalSizeOfPendingItemDataMsgs = 0;
 
+  ///////////////////////////////////////////////////////////////////////////
+  // Destination blocks pipeline: a block is taken out of pendingItemDataMsgs as soon as all of its chunks arrive, and
+  // is decompressed and digested by digestWorkers_. The ST thread consumes the digested blocks in descending block ID
+  // order - it only compares digests (chain link / RVB) and puts the blocks.
+  ///////////////////////////////////////////////////////////////////////////
+  struct BlockDigestJob {
+    uint64_t blockId = 0;
+    // RVB group digests (if any), followed by the block. The block is compressed until the job is done.
+    std::vector<char> data;
+    uint32_t rvbDigestsSize = 0;
+    uint32_t receivedSize = 0;
+    uint16_t totalNumberOfChunks = 0;
+    bool lastInBatch = false;
+    CompressionType compressionType = CompressionType::NONE;
+    uint32_t uncompressedBlockSize = 0;
+    // Set by the worker
+    bool decompressionFailed = false;
+    Digest digest;
+    std::chrono::steady_clock::time_point dispatchTime;
+    std::chrono::steady_clock::time_point doneTime;
+    std::future<void> future;
+  };
+  using BlockDigestJobPtr = std::shared_ptr<BlockDigestJob>;
+
+  static constexpr uint32_t numOfDigestWorkers_ = 4;
+  // Must be less than config_.refreshTimerMs
+  static constexpr uint32_t digestJobTimeoutMilli_ = 1;
+  std::unique_ptr<concord::util::ThreadPool> digestWorkers_;
+  // Jobs of the current batch, by block ID. The received data of all jobs is counted, together with
+  // totalSizeOfPendingItemDataMsgs, against config_.maxPendingDataFromSourceReplica.
+  map<uint64_t, BlockDigestJobPtr> digestJobs_;
+  uint32_t totalSizeOfDigestJobs_ = 0;
+
+  // Move all the full blocks of the current batch from pendingItemDataMsgs into new digest jobs
+  void dispatchBlockDigestJobs();
+  BlockDigestJobPtr createBlockDigestJob(set<STMessageUptr<ItemDataMsg>, compareItemDataMsg>::iterator first,
+                                         set<STMessageUptr<ItemDataMsg>, compareItemDataMsg>::iterator last);
+  void clearDigestJobs();
+
+  ///////////////////////////////////////////////////////////////////////////
+  // Striped fetching: upcoming batches are fetched from helper sources, in parallel to the current source.
+  // Stripe data is kept aside, and moved into pendingItemDataMsgs only when its batch becomes the current batch.
+  ///////////////////////////////////////////////////////////////////////////
+  StripeManager stripeManager_;
+  map<uint16_t, set<STMessageUptr<ItemDataMsg>, compareItemDataMsg>> stripesItemDataMsgs_;
+  // Bounded by maxPendingDataFromSourceReplica, separately from totalSizeOfPendingItemDataMsgs
+  uint32_t totalSizeOfStripesItemDataMsgs_ = 0;
+  // Source of the stripe which is currently being consumed (validated and committed), NO_REPLICA if none
+  uint16_t consumedStripeSourceId_ = NO_REPLICA;
+  // Time when we started to wait for an in-flight stripe which covers the current batch, 0 if not waiting
+  uint64_t waitingForStripeSinceMilli_ = 0;
+
+  bool isStripedFetchingActive() const;
+  void dispatchStripes();
+  void sendFetchBlocksMsgToStripeSource(const Stripe& stripe,
+                                        uint64_t maxBlockId,
+                                        int16_t lastKnownChunkInLastRequiredBlock);
+  void onStripeItemDataMsg(STMessageUptr<ItemDataMsg> m, uint16_t replicaId);
+  bool checkStripeData(const Stripe& stripe,
+                       bool& outBadDataDetected,
+                       uint64_t& outNextMissingBlock,
+                       int16_t& outLastKnownChunk) const;
+  void cancelStripe(uint16_t sourceId, StripeCancelReason reason);
+  void clearAllStripes();
+  void checkStripesTimeouts();
+  bool tryConsumeStripe();
+  bool shouldWaitForStripe(int16_t lastKnownChunkInLastRequiredBlock);
+
   void stReset(DataStoreTransaction* txn,
                bool resetRvbm = false,
                bool resetStoredCp = false,
@@ -487,6 +597,8 @@ class BCStateTran : public IStateTransfer {
                         int16_t& outLastChunkInRequiredBlock,
                         char* outBlock,
                         uint32_t& outBlockSize,
+                        CompressionType& outCompressionType,
+                        uint32_t& outUncompressedBlockSize,
                         bool isVBLock);
 
   // startCollectingStateExternal() is invoked by the API call startCollectingState().
@@ -497,13 +609,15 @@ class BCStateTran : public IStateTransfer {
   void startCollectingStateInternal();
 
   BlocksBatchDesc computeNextBatchToFetch(uint64_t minRequiredBlockId);
-  bool checkBlock(uint64_t blockNum, char* block, uint32_t blockSize) const;
+  uint64_t computeBatchMaxBlockId(uint64_t minRequiredBlockId) const;
+  // Compare the digest of a digested block to the expected one (chain link, RVB or the target checkpoint)
+  bool checkBlock(uint64_t blockNum, const Digest& computedBlockDigest) const;
 
   bool checkVirtualBlockOfResPages(const Digest& expectedDigestOfResPagesDescriptor,
                                    char* vblock,
                                    uint32_t vblockSize) const;
 
-  void processData(bool lastInBatch = false, uint32_t rvbDigestsSize = 0);
+  void processData(bool lastInBatch = false);
   void cycleEndSummary();
   void onGettingMissingBlocksEnd(DataStoreTransaction* txn);
   set<uint16_t> allOtherReplicas();
@@ -538,7 +652,10 @@ class BCStateTran : public IStateTransfer {
   static void computeDigestOfPage(
       const uint32_t pageId, const uint64_t checkpointNumber, const char* page, uint32_t pageSize, Digest& outDigest);
 
-  static void computeDigestOfPagesDescriptor(const DataStore::ResPagesDescriptor* pagesDesc, Digest& outDigest);
+  static void computeDigestOfPagesDescriptor(
+      const DataStore::ResPagesDescriptor* pagesDesc,
+      Digest& outDigest,
+      DataStore::ResPagesDigestVersion version = DataStore::ResPagesDigestVersion::FLAT);
 
   static void computeDigestOfBlock(const uint64_t blockNum,
                                    const char* block,
@@ -565,6 +682,12 @@ class BCStateTran : public IStateTransfer {
     }
     uint64_t blockId = 0;
     uint32_t actualBlockSize = 0;
+    // Source only: requested compression. If the block was compressed, blockData holds the compressed block,
+    // actualBlockSize is its compressed size and uncompressedBlockSize is non-zero.
+    CompressionType compressionType = CompressionType::NONE;
+    uint32_t uncompressedBlockSize = 0;
+    // Destination only: time the block was handed to putBlockAsync
+    std::chrono::steady_clock::time_point putTime;
     std::unique_ptr<char[]> blockData;
     std::future<bool> future;
   };
@@ -587,6 +710,26 @@ class BCStateTran : public IStateTransfer {
   void sourcePrepareBatch(uint64_t numBlocksRequested);
   void clearIoContexts();
 
+  ///////////////////////////////////////////////////////////////////////////
+  // Source blocks read-ahead cache
+  ///////////////////////////////////////////////////////////////////////////
+
+  // Exist only if enabled by configuration (sourceBlocksCacheSizeMb > 0)
+  std::unique_ptr<SourceBlocksCache> sourceBlocksCache_;
+  // Reads ahead blocks into sourceBlocksCache_, a single batched read at a time
+  std::unique_ptr<concord::util::ThreadPool> readAheadWorker_;
+  std::future<void> readAheadFuture_;
+  // Last FetchBlocksMsg served, used to predict the next requests of the destination
+  uint16_t lastFetchBlocksReplicaId_ = UINT16_MAX;
+  uint64_t lastFetchBlocksMaxBlockId_ = 0;
+
+  // Read ahead into the cache the blocks predicted to be requested after the batch requested by m
+  void sourceReadAhead(const FetchBlocksMsg& m, uint16_t replicaId);
+  // If cached, copy the block into ctx and make its future ready. Returns false on a cache miss.
+  bool getBlockFromCache(BlockIOContext& ctx);
+  // Wait for an ongoing read-ahead and drop all cached blocks
+  void clearSourceBlocksCache();
+
   // lastBlock: is true if we put the oldest block (firstRequiredBlock)
   //
   // waitPolicy:
@@ -724,6 +867,19 @@ class BCStateTran : public IStateTransfer {
     GaugeHandle src_num_io_contexts_dropped_;
     GaugeHandle src_num_io_contexts_invoked_;
     CounterHandle src_num_io_contexts_consumed_;
+
+    CounterHandle src_num_compressed_blocks_;
+    CounterHandle src_num_incompressible_blocks_;
+    CounterHandle src_compressed_blocks_raw_bytes_;
+    CounterHandle src_compressed_blocks_compressed_bytes_;
+    CounterHandle dst_num_decompressed_blocks_;
+    CounterHandle dst_decompression_failures_;
+
+    CounterHandle src_blocks_cache_hits_;
+    CounterHandle src_blocks_cache_misses_;
+    CounterHandle src_num_blocks_read_ahead_;
+    GaugeHandle src_blocks_cache_size_bytes_;
+    GaugeHandle src_session_bytes_throughput_;
   };
   mutable Metrics metrics_;
   Metrics createRegisterMetrics();
@@ -814,7 +970,12 @@ class BCStateTran : public IStateTransfer {
   struct SourceSession {
    public:
     SourceSession(logging::Logger& logger, uint64_t sourceSessionExpiryDurationMs)
-        : logger_(logger), expiryDurationMs_{sourceSessionExpiryDurationMs}, replicaId_{0}, startTime_{0} {}
+        : logger_(logger),
+          expiryDurationMs_{sourceSessionExpiryDurationMs},
+          replicaId_{0},
+          startTime_{0},
+          openTime_{0},
+          numSentBytes_{0} {}
     SourceSession() = delete;
     void close();
     // returns a pair of booleans:
@@ -826,6 +987,9 @@ class BCStateTran : public IStateTransfer {
     bool isOpen() const { return startTime_ != 0; }
     uint16_t ownerDestReplicaId() const { return replicaId_; };
     uint64_t activeDuration() const { return getMonotonicTimeMilli() - startTime_; }
+    void addSentBytes(uint64_t numBytes) { numSentBytes_ += numBytes; }
+    // Bytes sent per second, since the session was opened
+    uint64_t bytesThroughput() const;
     void refresh(uint64_t startTime = 0);
     // A session can be expired only if it's open, when expiryDurationMs_ - session always expire.
     bool expired() const { return isOpen() && ((expiryDurationMs_ == 0) || (activeDuration() > expiryDurationMs_)); }
@@ -836,7 +1000,9 @@ class BCStateTran : public IStateTransfer {
     logging::Logger& logger_;
     const uint64_t expiryDurationMs_;
     uint16_t replicaId_;
-    uint64_t startTime_;
+    uint64_t startTime_;  // time of last activity
+    uint64_t openTime_;
+    uint64_t numSentBytes_;
   };
 
   struct SourceBatch {
@@ -851,7 +1017,8 @@ class BCStateTran : public IStateTransfer {
           getNextBlock{false},
           rvbGroupDigestsExpectedSize{0},
           destReplicaId{0},
-          prefetched{false} {}
+          prefetched{false},
+          compressionType{CompressionType::NONE} {}
     std::string toString() const;
     void init(uint64_t batchNumber,
               uint64_t maxBlockId,
@@ -861,7 +1028,8 @@ class BCStateTran : public IStateTransfer {
               const Config& config,
               size_t rvbGroupDigestsExpectedSize,
               const FetchBlocksMsg* msg,
-              uint16_t destReplicaId);
+              uint16_t destReplicaId,
+              CompressionType compressionType);
 
     bool active;
     uint64_t batchNumber;
@@ -875,6 +1043,7 @@ class BCStateTran : public IStateTransfer {
     FetchBlocksMsg destRequest;
     uint16_t destReplicaId;
     bool prefetched;  // true if this batch succeed with pre-fetch prediction
+    CompressionType compressionType;
   };
 
   SourceBatch sourceBatch_;
@@ -897,6 +1066,7 @@ class BCStateTran : public IStateTransfer {
     static constexpr uint64_t MAX_BATCH_SIZE_BLOCKS = 1000ULL;
     static constexpr uint64_t MAX_INCOMING_EVENTS_QUEUE_SIZE = 10000ULL;
     static constexpr uint64_t MAX_PENDING_BLOCKS_SIZE = 1000ULL;
+    static constexpr uint64_t MAX_NUM_OF_RES_PAGES = 1000000ULL;
 
     Recorders() {
       LOG_TRACE(ST_SRC_LOG, "Recorders: Thread ID: " << std::this_thread::get_id() << KVLOG(this));
@@ -908,13 +1078,22 @@ class BCStateTran : public IStateTransfer {
                                         incoming_events_queue_size,
                                         compute_block_digest_duration,
                                         compute_block_digest_size,
-                                        time_to_clear_io_contexts});
+                                        time_to_clear_io_contexts,
+                                        create_checkpoint_duration,
+                                        checkpoint_res_pages_duration,
+                                        checkpoint_num_of_updated_res_pages});
       // destination component
       registrar.perf.registerComponent("state_transfer_dest",
                                        {dst_handle_ItemData_msg,
                                         dst_time_between_sendFetchBlocksMsg,
                                         dst_num_pending_blocks_to_commit,
                                         dst_digest_calc_duration,
+                                        dst_decompress_block_duration,
+                                        dst_num_pending_digest_jobs,
+                                        dst_digest_job_queue_duration,
+                                        dst_digest_job_duration,
+                                        dst_digested_block_wait_duration,
+                                        dst_put_block_to_commit_duration,
                                         dst_time_ItemData_msg_in_incoming_events_queue,
                                         time_in_post_processing_events_queue});
       // source component
@@ -927,7 +1106,11 @@ class BCStateTran : public IStateTransfer {
                                         src_send_on_spot_batch_duration,
                                         src_send_batch_size_bytes,
                                         src_send_batch_num_of_chunks,
-                                        src_next_block_wait_duration});
+                                        src_next_block_wait_duration,
+                                        src_compress_block_duration,
+                                        src_compressed_block_size_bytes,
+                                        src_read_ahead_duration,
+                                        src_read_ahead_num_of_blocks});
     }
     ~Recorders() {
       LOG_TRACE(ST_SRC_LOG, "~Recorders: Thread ID: " << std::this_thread::get_id() << KVLOG(this));
@@ -950,6 +1133,12 @@ class BCStateTran : public IStateTransfer {
     DEFINE_SHARED_RECORDER(compute_block_digest_size, 1, MAX_BLOCK_SIZE, 3, concord::diagnostics::Unit::COUNT);
     DEFINE_SHARED_RECORDER(
         time_to_clear_io_contexts, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        create_checkpoint_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        checkpoint_res_pages_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        checkpoint_num_of_updated_res_pages, 1, MAX_NUM_OF_RES_PAGES, 3, concord::diagnostics::Unit::COUNT);
     // destination
     DEFINE_SHARED_RECORDER(
         dst_handle_ItemData_msg, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
@@ -959,6 +1148,20 @@ class BCStateTran : public IStateTransfer {
         dst_num_pending_blocks_to_commit, 1, MAX_PENDING_BLOCKS_SIZE, 3, concord::diagnostics::Unit::COUNT);
     DEFINE_SHARED_RECORDER(
         dst_digest_calc_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        dst_num_pending_digest_jobs, 1, MAX_PENDING_BLOCKS_SIZE, 3, concord::diagnostics::Unit::COUNT);
+    // blocks pipeline stages: waiting for a digest worker, decompressing and digesting (both recorded by the digest
+    // workers), waiting for the ordered digest comparison, and waiting for the commit to the ST blockchain
+    DEFINE_SHARED_RECORDER(
+        dst_decompress_block_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        dst_digest_job_queue_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        dst_digest_job_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        dst_digested_block_wait_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        dst_put_block_to_commit_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
     DEFINE_SHARED_RECORDER(dst_time_ItemData_msg_in_incoming_events_queue,
                            1,
                            MAX_VALUE_MICROSECONDS,
@@ -983,6 +1186,15 @@ class BCStateTran : public IStateTransfer {
         src_send_batch_num_of_chunks, 1, MAX_BATCH_SIZE_BLOCKS, 3, concord::diagnostics::Unit::COUNT);
     DEFINE_SHARED_RECORDER(
         src_next_block_wait_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    // recorded by the compression workers
+    DEFINE_SHARED_RECORDER(
+        src_compress_block_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(src_compressed_block_size_bytes, 1, MAX_BLOCK_SIZE, 3, concord::diagnostics::Unit::BYTES);
+    // recorded by the read-ahead worker
+    DEFINE_SHARED_RECORDER(
+        src_read_ahead_duration, 1, MAX_VALUE_MICROSECONDS, 3, concord::diagnostics::Unit::MICROSECONDS);
+    DEFINE_SHARED_RECORDER(
+        src_read_ahead_num_of_blocks, 1, MAX_BATCH_SIZE_BLOCKS, 3, concord::diagnostics::Unit::COUNT);
   };
   Recorders histograms_;
 
@@ -0,0 +1,152 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "BlockCompressor.hpp"
+
+namespace bftEngine {
+namespace bcst {
+namespace impl {
+
+std::string toString(CompressionType type) {
+  switch (type) {
+    case CompressionType::NONE:
+      return "NONE";
+    case CompressionType::LZ4:
+      return "LZ4";
+    case CompressionType::ZSTD:
+      return "ZSTD";
+    default:
+      return "UNKNOWN(" + std::to_string(static_cast<int>(type)) + ")";
+  }
+}
+
+bool BlockCompressor::isSupported(CompressionType type) {
+  switch (type) {
+#ifdef USE_LZ4
+    case CompressionType::LZ4:
+      return true;
+#endif
+#ifdef USE_ZSTD
+    case CompressionType::ZSTD:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+uint32_t BlockCompressor::compressBound(CompressionType type, uint32_t srcSize) {
+  switch (type) {
+#ifdef USE_LZ4
+    case CompressionType::LZ4:
+      return static_cast<uint32_t>(LZ4_compressBound(static_cast<int>(srcSize)));
+#endif
+#ifdef USE_ZSTD
+    case CompressionType::ZSTD:
+      return static_cast<uint32_t>(ZSTD_compressBound(srcSize));
+#endif
+    default:
+      return 0;
+  }
+}
+
+uint32_t BlockCompressor::compressTo(
+    CompressionType type, const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity) {
+  switch (type) {
+#ifdef USE_LZ4
+    case CompressionType::LZ4: {
+      auto size = LZ4_compress_default(src, dst, static_cast<int>(srcSize), static_cast<int>(dstCapacity));
+      return (size > 0) ? static_cast<uint32_t>(size) : 0;
+    }
+#endif
+#ifdef USE_ZSTD
+    case CompressionType::ZSTD: {
+      // A compression context is expensive to create - keep one per worker thread
+      static thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx{ZSTD_createCCtx(),
+                                                                                   &ZSTD_freeCCtx};
+      auto size = ZSTD_compressCCtx(cctx.get(), dst, dstCapacity, src, srcSize, kZstdLevel);
+      return ZSTD_isError(size) ? 0 : static_cast<uint32_t>(size);
+    }
+#endif
+    default:
+      (void)src;
+      (void)srcSize;
+      (void)dst;
+      (void)dstCapacity;
+      return 0;
+  }
+}
+
+uint32_t BlockCompressor::compress(CompressionType type, char* block, uint32_t blockSize) {
+  if (!isSupported(type) || (blockSize < kMinBlockSize)) {
+    return 0;
+  }
+  // Scratch buffer is reused by all blocks compressed by the same worker thread
+  static thread_local std::vector<char> scratch;
+  scratch.resize(std::max<size_t>(scratch.size(), compressBound(type, blockSize)));
+
+  const uint32_t sampleSize = std::min(blockSize, kSampleSize);
+  uint32_t compressedSize = compressTo(type, block, sampleSize, scratch.data(), scratch.size());
+  if (!isCompressible(sampleSize, compressedSize)) {
+    return 0;
+  }
+  if (sampleSize < blockSize) {
+    compressedSize = compressTo(type, block, blockSize, scratch.data(), scratch.size());
+    if (!isCompressible(blockSize, compressedSize)) {
+      return 0;
+    }
+  }
+  memcpy(block, scratch.data(), compressedSize);
+  return compressedSize;
+}
+
+bool BlockCompressor::decompress(
+    CompressionType type, const char* src, uint32_t srcSize, char* dst, uint32_t uncompressedSize) {
+  switch (type) {
+#ifdef USE_LZ4
+    case CompressionType::LZ4: {
+      auto size =
+          LZ4_decompress_safe(src, dst, static_cast<int>(srcSize), static_cast<int>(uncompressedSize));
+      return (size >= 0) && (static_cast<uint32_t>(size) == uncompressedSize);
+    }
+#endif
+#ifdef USE_ZSTD
+    case CompressionType::ZSTD: {
+      auto size = ZSTD_decompress(dst, uncompressedSize, src, srcSize);
+      return !ZSTD_isError(size) && (size == uncompressedSize);
+    }
+#endif
+    default:
+      (void)src;
+      (void)srcSize;
+      (void)dst;
+      (void)uncompressedSize;
+      return false;
+  }
+}
+
+}  // namespace impl
+}  // namespace bcst
+}  // namespace bftEngine
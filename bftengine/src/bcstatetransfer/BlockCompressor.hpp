@@ -0,0 +1,67 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+namespace bftEngine {
+namespace bcst {
+namespace impl {
+
+// Compression of block payloads sent by the source in ItemDataMsg. Values are sent on the wire - do not change them.
+enum class CompressionType : uint8_t { NONE = 0, LZ4 = 1, ZSTD = 2, LAST };
+
+std::string toString(CompressionType type);
+
+// Stateless (thread safe) block compression. A block is compressed as a whole, before it is split into chunks.
+// Support for each algorithm depends on the libraries found at build time (USE_LZ4 / USE_ZSTD).
+class BlockCompressor {
+ public:
+  static bool isSupported(CompressionType type);
+
+  // Compress blockSize bytes of block in place, only if compression is beneficial. Returns the compressed size, or 0
+  // if the block was left untouched (unsupported type or incompressible data).
+  // To save CPU on incompressible data (e.g. already compressed/encrypted payloads), a prefix of the block is
+  // compressed first, and the whole block is compressed only if the prefix compresses well enough.
+  // The decision depends only on the block content, so the same block is always sent in the same form - a
+  // destination may complete a block which was partially sent in a previous batch.
+  static uint32_t compress(CompressionType type, char* block, uint32_t blockSize);
+
+  // Decompress srcSize bytes of src into dst. Returns true only if the decompressed size equals exactly
+  // uncompressedSize. dst must be at least uncompressedSize bytes long.
+  static bool decompress(
+      CompressionType type, const char* src, uint32_t srcSize, char* dst, uint32_t uncompressedSize);
+
+  // Size of the block prefix which is compressed first, to detect incompressible data
+  static constexpr uint32_t kSampleSize = 64 * 1024;
+  // Minimal saving (in percents of the original size) for data to be considered compressible
+  static constexpr uint32_t kMinSavingPercent = 10;
+  // Smaller blocks are not worth compressing
+  static constexpr uint32_t kMinBlockSize = 512;
+  static constexpr int kZstdLevel = 3;
+
+ private:
+  // Compress into dst, returns 0 on failure
+  static uint32_t compressTo(
+      CompressionType type, const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity);
+  static uint32_t compressBound(CompressionType type, uint32_t srcSize);
+  static bool isCompressible(uint32_t rawSize, uint32_t compressedSize) {
+    return (compressedSize > 0) &&
+           (static_cast<uint64_t>(compressedSize) * 100 <= static_cast<uint64_t>(rawSize) * (100 - kMinSavingPercent));
+  }
+};
+
+}  // namespace impl
+}  // namespace bcst
+}  // namespace bftEngine
@@ -14,6 +14,7 @@ std::ostream& operator<<(std::ostream& os, const DataStore::CheckpointDesc& desc
      << " checkpointNum: " << desc.checkpointNum << " lastBlock: " << desc.maxBlockId
      << " digestOfLastBlock: " << desc.digestOfMaxBlockId.toString()
      << " digestOfResPagesDescriptor:" << desc.digestOfResPagesDescriptor.toString()
+     << " resPagesDigestVersion:" << static_cast<uint32_t>(desc.resPagesDigestVersion)
      << " rvbData size:" << desc.rvbData.size();
   return os;
 }
@@ -179,6 +180,8 @@ void DBDataStore::serializeCheckpoint(std::ostream& os, const CheckpointDesc& de
   Serializable::serialize(os, desc.digestOfMaxBlockId.get(), DIGEST_SIZE);
   Serializable::serialize(os, desc.digestOfResPagesDescriptor.get(), DIGEST_SIZE);
   Serializable::serialize(os, desc.rvbData);
+  // Added after rvbData, descriptors stored by older versions end here
+  Serializable::serialize(os, static_cast<uint8_t>(desc.resPagesDigestVersion));
 }
 void DBDataStore::deserializeCheckpoint(std::istream& is, CheckpointDesc& desc) const {
   Serializable::deserialize(is, desc.checkpointNum);
@@ -186,6 +189,12 @@ void DBDataStore::deserializeCheckpoint(std::istream& is, CheckpointDesc& desc)
   Serializable::deserialize(is, desc.digestOfMaxBlockId.getForUpdate(), DIGEST_SIZE);
   Serializable::deserialize(is, desc.digestOfResPagesDescriptor.getForUpdate(), DIGEST_SIZE);
   Serializable::deserialize(is, desc.rvbData);
+  desc.resPagesDigestVersion = ResPagesDigestVersion::FLAT;
+  if (is.peek() != std::char_traits<char>::eof()) {
+    uint8_t version{};
+    Serializable::deserialize(is, version);
+    desc.resPagesDigestVersion = static_cast<ResPagesDigestVersion>(version);
+  }
 }
 void DBDataStore::setCheckpointDesc(uint64_t checkpoint, const CheckpointDesc& desc, const bool checkIfAlreadyExists) {
   LOG_DEBUG(logger(), toString(desc));
@@ -78,12 +78,18 @@ class DataStore : public std::enable_shared_from_this<DataStore> {
   //////////////////////////////////////////////////////////////////////////
   // Checkpoints
   //////////////////////////////////////////////////////////////////////////
+  // The way digestOfResPagesDescriptor is computed. All replicas must use the same version, since the digest is a part
+  // of the checkpoint. Values are persisted and sent on the wire - do not change them.
+  // FLAT - digest of the whole ResPagesDescriptor. MERKLE - see ResPagesDigestTree.
+  enum class ResPagesDigestVersion : uint8_t { FLAT = 1, MERKLE = 2, LAST };
+
   struct CheckpointDesc {
     void makeZero() {
       checkpointNum = 0;
       maxBlockId = 0;
       digestOfMaxBlockId.makeZero();
       digestOfResPagesDescriptor.makeZero();
+      resPagesDigestVersion = ResPagesDigestVersion::FLAT;
       rvbData.clear();
     }
 
@@ -91,6 +97,7 @@ class DataStore : public std::enable_shared_from_this<DataStore> {
     uint64_t maxBlockId = 0;
     Digest digestOfMaxBlockId;
     Digest digestOfResPagesDescriptor;
+    ResPagesDigestVersion resPagesDigestVersion = ResPagesDigestVersion::FLAT;
     std::vector<char> rvbData{};
   };
 
@@ -18,6 +18,7 @@
 
 #include "log/logger.hpp"
 #include "IStateTransfer.hpp"
+#include "util/assertUtils.hpp"
 #include "util/hex_tools.hpp"
 
 namespace bftEngine {
@@ -35,7 +36,9 @@ class MsgType {
     FetchBlocks,
     FetchResPages,
     RejectFetching,
-    ItemData
+    ItemData,
+    CompressedItemData,  // ItemDataMsg followed by ItemDataMsg::CompressionInfo, sent only if requested
+    VersionedCheckpointsSummary  // CheckpointSummaryMsg followed by a non default resPagesDigestVersion
   };
 };
 
@@ -78,10 +81,19 @@ struct AskForCheckpointSummariesMsg : public BCStateTranBaseMsg {
 struct CheckpointSummaryMsg : public BCStateTranBaseMsg {
   CheckpointSummaryMsg() = delete;
 
-  static VariableSizeMsg<CheckpointSummaryMsg> alloc(size_t rvbDataSize) {
-    VariableSizeMsg<CheckpointSummaryMsg> msg{rvbDataSize};
-    msg->type = MsgType::CheckpointsSummary;
+  static constexpr uint8_t kDefaultResPagesDigestVersion = 1;  // DataStore::ResPagesDigestVersion::FLAT
+
+  // A non default resPagesDigestVersion is sent in a VersionedCheckpointsSummary message, right after the RVB data.
+  // Older replicas do not know this type, and could not validate such a checkpoint anyway.
+  static VariableSizeMsg<CheckpointSummaryMsg> alloc(size_t rvbDataSize,
+                                                     uint8_t resPagesDigestVersion = kDefaultResPagesDigestVersion) {
+    const bool versioned = (resPagesDigestVersion != kDefaultResPagesDigestVersion);
+    VariableSizeMsg<CheckpointSummaryMsg> msg{rvbDataSize + (versioned ? sizeof(uint8_t) : 0)};
+    msg->type = versioned ? MsgType::VersionedCheckpointsSummary : MsgType::CheckpointsSummary;
     msg->rvbDataSize = rvbDataSize;
+    if (versioned) {
+      msg->data[rvbDataSize] = static_cast<char>(resPagesDigestVersion);
+    }
     return msg;
   }
 
@@ -90,8 +102,15 @@ struct CheckpointSummaryMsg : public BCStateTranBaseMsg {
     rep->freeStateTransferMsg(const_cast<char*>(reinterpret_cast<const char*>(msg)));
   }
 
-  size_t size() const { return VariableSizeMsg<CheckpointSummaryMsg>::calcMsgSize(rvbDataSize); }
+  size_t size() const {
+    return VariableSizeMsg<CheckpointSummaryMsg>::calcMsgSize(rvbDataSize + (isVersioned() ? sizeof(uint8_t) : 0));
+  }
   size_t sizeofRvbData() const { return rvbDataSize; }
+  bool isVersioned() const { return type == MsgType::VersionedCheckpointsSummary; }
+  // DataStore::ResPagesDigestVersion of digestOfResPagesDescriptor
+  uint8_t resPagesDigestVersion() const {
+    return isVersioned() ? static_cast<uint8_t>(data[rvbDataSize]) : kDefaultResPagesDigestVersion;
+  }
 
   uint64_t checkpointNum;
   uint64_t maxBlockId;
@@ -118,6 +137,7 @@ struct CheckpointSummaryMsg : public BCStateTranBaseMsg {
     }
     oss << " maxBlockId=" << a->maxBlockId << " digestOfMaxBlockId=" << a->digestOfMaxBlockId.toString()
         << " digestOfResPagesDescriptor=" << a->digestOfResPagesDescriptor.toString()
+        << " resPagesDigestVersion=" << static_cast<uint32_t>(a->resPagesDigestVersion())
         << " requestMsgSeqNum=" << a->requestMsgSeqNum << " rvbDataSize=" << a->rvbDataSize << std::endl;
 
     if (b_id != std::numeric_limits<uint16_t>::max()) {
@@ -125,6 +145,7 @@ struct CheckpointSummaryMsg : public BCStateTranBaseMsg {
     }
     oss << " maxBlockId=" << b->maxBlockId << " digestOfMaxBlockId=" << b->digestOfMaxBlockId.toString()
         << " digestOfResPagesDescriptor=" << b->digestOfResPagesDescriptor.toString()
+        << " resPagesDigestVersion=" << static_cast<uint32_t>(b->resPagesDigestVersion())
         << " requestMsgSeqNum=" << b->requestMsgSeqNum << " requestMsgSeqNum=" << b->rvbDataSize << std::endl;
     LOG_WARN(logger, oss.str());
     if (a->rvbDataSize > 0) {
@@ -143,7 +164,8 @@ struct CheckpointSummaryMsg : public BCStateTranBaseMsg {
     bool cmp1 =
         ((a->maxBlockId == b->maxBlockId) && (a->checkpointNum == b->checkpointNum) &&
          (a->digestOfMaxBlockId == b->digestOfMaxBlockId) &&
-         (a->digestOfResPagesDescriptor == b->digestOfResPagesDescriptor) && (a->rvbDataSize == b->rvbDataSize));
+         (a->digestOfResPagesDescriptor == b->digestOfResPagesDescriptor) &&
+         (a->resPagesDigestVersion() == b->resPagesDigestVersion()) && (a->rvbDataSize == b->rvbDataSize));
     bool cmp2{true};
     if (cmp1 && (a->rvbDataSize > 0)) {
       cmp2 = (0 == memcmp(a->data, b->data, a->rvbDataSize));
@@ -160,7 +182,8 @@ struct CheckpointSummaryMsg : public BCStateTranBaseMsg {
                   "Should newly added field be compared below?");
     if ((a->maxBlockId != b->maxBlockId) || (a->checkpointNum != b->checkpointNum) ||
         (a->digestOfMaxBlockId != b->digestOfMaxBlockId) ||
-        (a->digestOfResPagesDescriptor != b->digestOfResPagesDescriptor) || (a->rvbDataSize != b->rvbDataSize) ||
+        (a->digestOfResPagesDescriptor != b->digestOfResPagesDescriptor) ||
+        (a->resPagesDigestVersion() != b->resPagesDigestVersion()) || (a->rvbDataSize != b->rvbDataSize) ||
         (0 != memcmp(a->data, b->data, a->rvbDataSize))) {
       logOnMismatch(a, b, a_id, b_id);
       return false;
@@ -177,7 +200,8 @@ struct FetchBlocksMsg : public BCStateTranBaseMsg {
         maxBlockId{},
         maxBlockIdInCycle{},
         rvbGroupId{},
-        lastKnownChunkInLastRequiredBlock{} {}
+        lastKnownChunkInLastRequiredBlock{},
+        compressionType{} {}
 
   uint64_t msgSeqNum;
   uint64_t minBlockId;
@@ -185,6 +209,14 @@ struct FetchBlocksMsg : public BCStateTranBaseMsg {
   uint64_t maxBlockIdInCycle;
   uint64_t rvbGroupId;
   uint16_t lastKnownChunkInLastRequiredBlock;
+  // Optional trailing field: requested compression of blocks (CompressionType), source may ignore it.
+  // Older replicas send and expect the message without it, see requestedCompressionType().
+  uint8_t compressionType;
+
+  static constexpr size_t sizeWithoutCompressionType() { return sizeof(FetchBlocksMsg) - sizeof(uint8_t); }
+  uint8_t requestedCompressionType(uint32_t msgLen) const {
+    return (msgLen >= sizeof(FetchBlocksMsg)) ? compressionType : 0;  // 0 is CompressionType::NONE
+  }
 };
 
 struct FetchResPagesMsg : public BCStateTranBaseMsg {
@@ -236,11 +268,18 @@ struct RejectFetchingMsg : public BCStateTranBaseMsg {
 };
 
 struct ItemDataMsg : public BCStateTranBaseMsg {
+  // Trailer of a CompressedItemData message, placed right after data. Compression is of the whole block, same for all
+  // its chunks. Chunks are parts of the compressed block.
+  struct CompressionInfo {
+    uint8_t compressionType;         // CompressionType
+    uint32_t uncompressedBlockSize;  // size of the block before compression
+  };
+
   ItemDataMsg() = delete;
 
-  static VariableSizeMsg<ItemDataMsg> alloc(size_t dataSize) {
-    VariableSizeMsg<ItemDataMsg> msg{dataSize};
-    msg->type = MsgType::ItemData;
+  static VariableSizeMsg<ItemDataMsg> alloc(size_t dataSize, bool withCompressionInfo = false) {
+    VariableSizeMsg<ItemDataMsg> msg{dataSize + (withCompressionInfo ? sizeof(CompressionInfo) : 0)};
+    msg->type = withCompressionInfo ? MsgType::CompressedItemData : MsgType::ItemData;
     msg->dataSize = dataSize;
     return msg;
   }
@@ -258,8 +297,26 @@ struct ItemDataMsg : public BCStateTranBaseMsg {
  public:
   char data[1];  // MSB[raw block of size dataSize-rvbDigestsSize|RVB DIGESTS of size rvbDigestsSize]LSB
 
-  uint32_t size() const { return VariableSizeMsg<ItemDataMsg>::calcMsgSize(dataSize); }
+  uint32_t size() const {
+    return VariableSizeMsg<ItemDataMsg>::calcMsgSize(dataSize) + (hasCompressionInfo() ? sizeof(CompressionInfo) : 0);
+  }
   uint32_t getDataSize() const { return dataSize; }
+
+  bool hasCompressionInfo() const { return type == MsgType::CompressedItemData; }
+  uint8_t compressionType() const { return hasCompressionInfo() ? compressionInfo()->compressionType : 0; }
+  uint32_t uncompressedBlockSize() const {
+    return hasCompressionInfo() ? compressionInfo()->uncompressedBlockSize : 0;
+  }
+  void setCompressionInfo(uint8_t compressionType, uint32_t uncompressedBlockSize) {
+    ConcordAssert(hasCompressionInfo());
+    auto* info = compressionInfo();
+    info->compressionType = compressionType;
+    info->uncompressedBlockSize = uncompressedBlockSize;
+  }
+
+ private:
+  CompressionInfo* compressionInfo() { return reinterpret_cast<CompressionInfo*>(data + dataSize); }
+  const CompressionInfo* compressionInfo() const { return reinterpret_cast<const CompressionInfo*>(data + dataSize); }
 };
 
 #pragma pack(pop)
@@ -10,6 +10,7 @@
 // file.
 
 #include <algorithm>
+#include <future>
 
 #include "RangeValidationTree.hpp"
 #include "RVBManager.hpp"
@@ -696,26 +697,36 @@ uint64_t RVBManager::addRvbDataOnBlockRange(uint64_t min_block_id,
   }
   uint64_t current_rvb_id = nextRvbBlockId(min_block_id);
   RVBId max_rvb_id_in_rvt = in_mem_rvt_->getMaxRvbId();
-  while (current_rvb_id < max_block_id) {  // we handle case of current_rvb_id == max_block_id later
-    // TODO - As a 2nd phase - should use the thread pool to fetch a batch of digests or move to a background
-    // process
-    if (current_rvb_id > max_rvb_id_in_rvt) {
-      Digest digest;
-      if (!as_->getPrevDigestFromBlock(current_rvb_id + 1,
-                                       reinterpret_cast<StateTransferDigest*>(digest.getForUpdate()))) {
+  // Reading a digest requires reading the next block from storage, which dominates the tree build time (e.g. on
+  // startup). Digests are read in parallel, while the tree is updated (in order) by this thread.
+  std::vector<std::pair<RVBId, std::future<std::optional<concord::crypto::BlockDigest>>>> pending_digests;
+  pending_digests.reserve(kMaxParallelDigestReads);
+  auto addPendingDigests = [&]() {
+    for (auto& [rvb_id, future] : pending_digests) {
+      const auto digest = future.get();
+      if (!digest.has_value()) {
         LOG_FATAL(logger_,
-                  "Digest not found:" << KVLOG(
-                      min_block_id, max_block_id, current_rvb_id, max_rvb_id_in_rvt, num_rvbs_added));
+                  "Digest not found:" << KVLOG(min_block_id, max_block_id, rvb_id, max_rvb_id_in_rvt, num_rvbs_added));
         ConcordAssert(false);
       }
       LOG_DEBUG(logger_,
-                "Add digest for block " << current_rvb_id << " "
-                                        << " Digest: " << digest.toString());
-      in_mem_rvt_->addRightNode(current_rvb_id, digest.getForUpdate(), DIGEST_SIZE);
+                "Add digest for block " << rvb_id << " "
+                                        << " Digest: " << Digest(digest.value()).toString());
+      in_mem_rvt_->addRightNode(rvb_id, reinterpret_cast<const char*>(digest.value().data()), DIGEST_SIZE);
       ++num_rvbs_added;
     }
+    pending_digests.clear();
+  };
+  while (current_rvb_id < max_block_id) {  // we handle case of current_rvb_id == max_block_id later
+    if (current_rvb_id > max_rvb_id_in_rvt) {
+      pending_digests.emplace_back(current_rvb_id, as_->getPrevDigestFromBlockAsync(current_rvb_id + 1));
+      if (pending_digests.size() == kMaxParallelDigestReads) {
+        addPendingDigests();
+      }
+    }
     current_rvb_id += config_.fetchRangeSize;
   }
+  addPendingDigests();
   if ((current_rvb_id == max_block_id) && (current_rvb_id > max_rvb_id_in_rvt)) {
     if (digest_of_max_block_id) {
       const auto& digest = digest_of_max_block_id.value();
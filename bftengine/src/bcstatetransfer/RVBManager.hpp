@@ -187,7 +187,9 @@ class RVBManager {
                             const char* block,
                             const uint32_t block_size,
                             char* out_digest) const;
-  // Returns # of RVBs added
+  // Returns # of RVBs added. RVB digests are read in parallel, up to kMaxParallelDigestReads at a time, and added to
+  // the tree in order.
+  static constexpr size_t kMaxParallelDigestReads = 256;
   uint64_t addRvbDataOnBlockRange(uint64_t min_block_id,
                                   uint64_t max_block_id,
                                   const std::optional<Digest>& digest_of_max_block_id);
@@ -11,6 +11,7 @@
 // terms and conditions of the subcomponent's license, as noted in the
 // LICENSE file.
 
+#include <cctype>
 #include <queue>
 #include <algorithm>
 #include <type_traits>
@@ -28,7 +29,6 @@ using namespace concord::serialize;
 namespace bftEngine::bcst::impl {
 
 using NodeVal = RangeValidationTree::NodeVal;
-using NodeVal_t = RangeValidationTree::NodeVal_t;
 using RVTNode = RangeValidationTree::RVTNode;
 using RVBNode = RangeValidationTree::RVBNode;
 using NodeInfo = RangeValidationTree::NodeInfo;
@@ -47,7 +47,236 @@ using RVTNodePtr = RangeValidationTree::RVTNodePtr;
 #endif
 
 //////////////////////////////// NodeVal  ///////////////////////////////////
-NodeVal_t NodeVal::kNodeValueModulo_{};
+namespace {
+// 64x64 => 128 bits multiplication. Returns the high 64 bits.
+uint64_t mulWide(uint64_t a, uint64_t b, uint64_t& low) {
+  const uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+  const uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+  const uint64_t lo_lo = a_lo * b_lo;
+  const uint64_t hi_lo = a_hi * b_lo;
+  const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + a_lo * b_hi;
+  low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+  return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+}
+}  // namespace
+
+size_t NodeVal::kNodeValueSize_{32};
+
+NodeVal::NodeVal(const char* vptr, size_t size) : negative_{false}, val_{} {
+  // Input is a big endian unsigned integer. Only the lowest kMaxValueSize bytes may affect the reduced value.
+  const auto* bytes = reinterpret_cast<const uint8_t*>(vptr);
+  for (size_t i = 0; i < std::min(size, kMaxValueSize); ++i) {
+    val_[i / sizeof(uint64_t)] |= static_cast<uint64_t>(bytes[size - 1 - i]) << (8 * (i % sizeof(uint64_t)));
+  }
+  reduce();
+}
+
+NodeVal NodeVal::fromHexString(const std::string& hex_str) {
+  NodeVal res;
+  const bool negative = (!hex_str.empty() && (hex_str[0] == '-'));
+  size_t begin = negative ? 1 : 0;
+  size_t end = begin;
+  while ((end < hex_str.size()) && std::isxdigit(static_cast<unsigned char>(hex_str[end]))) {
+    ++end;
+  }
+  // Only the lowest kMaxValueSize bytes may affect the reduced value
+  begin = std::max(begin, end - std::min(end - begin, 2 * kMaxValueSize));
+  for (size_t i = 0; i < end - begin; ++i) {
+    const char c = hex_str[end - 1 - i];
+    const uint64_t nibble = std::isdigit(static_cast<unsigned char>(c)) ? (c - '0') : (std::toupper(c) - 'A' + 10);
+    res.val_[i / 16] |= nibble << (4 * (i % 16));
+  }
+  res.negative_ = negative;
+  res.reduce();
+  return res;
+}
+
+void NodeVal::setValueSize(size_t val_size) {
+  ConcordAssertGT(val_size, 0);
+  ConcordAssertLE(val_size, kMaxValueSize);
+  kNodeValueSize_ = val_size;
+}
+
+bool NodeVal::isZero() const {
+  return std::all_of(val_.begin(), val_.end(), [](uint64_t limb) { return limb == 0; });
+}
+
+int NodeVal::compare(const Limbs& a, const Limbs& b) {
+  for (size_t i = kNumLimbs; i-- > 0;) {
+    if (a[i] != b[i]) {
+      return (a[i] < b[i]) ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+bool NodeVal::add(Limbs& a, const Limbs& b) {
+  bool carry = false;
+  for (size_t i = 0; i < kNumLimbs; ++i) {
+    const uint64_t sum = a[i] + b[i];
+    const bool next_carry = (sum < a[i]) || (carry && (sum == UINT64_MAX));
+    a[i] = sum + (carry ? 1 : 0);
+    carry = next_carry;
+  }
+  return carry;
+}
+
+bool NodeVal::sub(Limbs& a, const Limbs& b) {
+  bool borrow = false;
+  for (size_t i = 0; i < kNumLimbs; ++i) {
+    const uint64_t diff = a[i] - b[i];
+    const bool next_borrow = (a[i] < b[i]) || (borrow && (diff == 0));
+    a[i] = diff - (borrow ? 1 : 0);
+    borrow = next_borrow;
+  }
+  return borrow;
+}
+
+// Binary long division. Not on any hot path.
+void NodeVal::divMod(const Limbs& a, const Limbs& b, Limbs& quotient, Limbs& remainder) {
+  quotient.fill(0);
+  remainder.fill(0);
+  for (size_t bit = kNumLimbs * 64; bit-- > 0;) {
+    for (size_t i = kNumLimbs - 1; i > 0; --i) {
+      remainder[i] = (remainder[i] << 1) | (remainder[i - 1] >> 63);
+    }
+    remainder[0] = (remainder[0] << 1) | ((a[bit / 64] >> (bit % 64)) & 1);
+    if (compare(remainder, b) >= 0) {
+      sub(remainder, b);
+      quotient[bit / 64] |= (1ULL << (bit % 64));
+    }
+  }
+}
+
+NodeVal& NodeVal::addSigned(const NodeVal& v, bool negate) {
+  const bool v_negative = negate ? !v.negative_ : v.negative_;
+  if (negative_ == v_negative) {
+    add(val_, v.val_);
+  } else if (compare(val_, v.val_) >= 0) {
+    sub(val_, v.val_);
+  } else {
+    Limbs tmp = v.val_;
+    sub(tmp, val_);
+    val_ = tmp;
+    negative_ = v_negative;
+  }
+  return *this;
+}
+
+NodeVal& NodeVal::reduce() {
+  const size_t bits = kNodeValueSize_ * 8;
+  for (size_t i = (bits + 63) / 64; i < kNumLimbs; ++i) {
+    val_[i] = 0;
+  }
+  if (bits % 64) {
+    val_[bits / 64] &= (1ULL << (bits % 64)) - 1;
+  }
+  if (isZero()) {
+    negative_ = false;
+  }
+  return *this;
+}
+
+NodeVal NodeVal::operator*(const NodeVal& v) const {
+  // Only the lowest kNumLimbs limbs of the product may affect the reduced value
+  NodeVal res;
+  for (size_t i = 0; i < kNumLimbs; ++i) {
+    uint64_t carry = 0;
+    for (size_t j = 0; i + j < kNumLimbs; ++j) {
+      uint64_t low;
+      uint64_t high = mulWide(val_[i], v.val_[j], low);
+      low += res.val_[i + j];
+      high += (low < res.val_[i + j]) ? 1 : 0;
+      low += carry;
+      high += (low < carry) ? 1 : 0;
+      res.val_[i + j] = low;
+      carry = high;
+    }
+  }
+  res.negative_ = (negative_ != v.negative_);
+  return res.reduce();
+}
+
+NodeVal NodeVal::operator/(const NodeVal& v) const {
+  ConcordAssert(!v.isZero());
+  NodeVal res, remainder;
+  divMod(val_, v.val_, res.val_, remainder.val_);
+  res.negative_ = (negative_ != v.negative_);
+  return res.reduce();
+}
+
+NodeVal NodeVal::operator%(const NodeVal& v) const {
+  ConcordAssert(!v.isZero());
+  NodeVal quotient, res;
+  divMod(val_, v.val_, quotient.val_, res.val_);
+  res.negative_ = negative_;
+  if (res.isZero()) {
+    res.negative_ = false;
+  }
+  return res;
+}
+
+NodeVal& NodeVal::operator-=(const NodeVal& v) {
+  addSigned(v, true).reduce();
+  if (negative_) {
+    // modulo - |val_|
+    Limbs magnitude = val_;
+    val_.fill(0);
+    sub(val_, magnitude);
+    negative_ = false;
+    reduce();
+  }
+  return *this;
+}
+
+std::string NodeVal::toHexString(bool add_prefix) const noexcept {
+  static constexpr char kHexDigits[] = "0123456789ABCDEF";
+  std::string result{add_prefix ? "0x" : ""};
+  if (negative_) {
+    result += '-';
+  }
+  // Same format as OpenSSL BN_bn2hex: upper case, whole bytes, no leading zero bytes
+  bool leading_zeros = true;
+  for (size_t i = kNumLimbs * sizeof(uint64_t); i-- > 0;) {
+    const auto byte = static_cast<uint8_t>(val_[i / sizeof(uint64_t)] >> (8 * (i % sizeof(uint64_t))));
+    if (leading_zeros && (byte == 0)) {
+      continue;
+    }
+    leading_zeros = false;
+    result += kHexDigits[byte >> 4];
+    result += kHexDigits[byte & 0xF];
+  }
+  if (leading_zeros) {
+    result += '0';
+  }
+  return result;
+}
+
+std::string NodeVal::toDecString() const noexcept {
+  static constexpr uint64_t kChunk = 1000000000ULL;  // 10^9, remainder fits 30 bits
+  if (isZero()) {
+    return "0";
+  }
+  Limbs magnitude = val_;
+  std::vector<uint32_t> chunks;
+  while (!std::all_of(magnitude.begin(), magnitude.end(), [](uint64_t limb) { return limb == 0; })) {
+    uint64_t remainder = 0;
+    for (size_t i = kNumLimbs; i-- > 0;) {
+      const uint64_t high = (remainder << 32) | (magnitude[i] >> 32);
+      const uint64_t low = ((high % kChunk) << 32) | (magnitude[i] & 0xFFFFFFFF);
+      magnitude[i] = ((high / kChunk) << 32) | (low / kChunk);
+      remainder = low % kChunk;
+    }
+    chunks.push_back(static_cast<uint32_t>(remainder));
+  }
+  std::string result{negative_ ? "-" : ""};
+  result += std::to_string(chunks.back());
+  for (auto it = std::next(chunks.rbegin()); it != chunks.rend(); ++it) {
+    const auto chunk = std::to_string(*it);
+    result += std::string(9 - chunk.size(), '0') + chunk;
+  }
+  return result;
+}
 
 inline std::ostream& operator<<(std::ostream& os, const NodeVal& b) {
   os << b.toDecAndHexString();
@@ -103,16 +332,15 @@ uint64_t NodeInfo::prevRvbIndex(uint64_t rvb_index, uint8_t level) {
 
 // TODO - for now, the outDigest is of a fixed size. We can match the final size to RangeValidationTree::value_size
 // This requires us to write our own DigestContext
-const shared_ptr<char[]> RVBNode::computeNodeInitialValue(NodeInfo& node_info, const char* data, size_t data_size) {
+NodeVal RVBNode::computeNodeInitialValue(NodeInfo& node_info, const char* data, size_t data_size) {
   ConcordAssertGT(node_info.id(), 0);
   DigestGenerator digest_generator;
 
   digest_generator.update(reinterpret_cast<const char*>(&node_info.id_data_), sizeof(node_info.id_data_));
   digest_generator.update(data, data_size);
-  // TODO - Use default_delete in case memleak is reported by ASAN
-  static std::shared_ptr<char[]> out_digest_buff(new char[NodeVal::kDigestContextOutputSize]);
-  digest_generator.writeDigest(out_digest_buff.get());
-  return out_digest_buff;
+  std::array<char, NodeVal::kDigestContextOutputSize> out_digest_buff;
+  digest_generator.writeDigest(out_digest_buff.data());
+  return NodeVal(out_digest_buff.data(), out_digest_buff.size());
 }
 
 void RangeValidationTree::RVTMetadata::staticAssert() noexcept {
@@ -145,7 +373,7 @@ void RVBNode::logInfoVal(const std::string& prefix) {
 // level 0
 RVBNode::RVBNode(uint64_t rvb_index, const char* data, size_t data_size)
     : info_(kDefaultRVBLeafLevel, rvb_index),
-      current_value_(computeNodeInitialValue(info_, data, data_size), NodeVal::kDigestContextOutputSize) {
+      current_value_(computeNodeInitialValue(info_, data, data_size)) {
   ConcordAssertEQ(info_.level(), kDefaultRVBLeafLevel);
   logInfoVal("construct1: ");  // leave for debugging
 }
@@ -154,8 +382,7 @@ RVBNode::RVBNode(uint64_t rvb_index, const char* data, size_t data_size)
 RVBNode::RVBNode(uint8_t level, uint64_t rvb_index)
     : info_(level, NodeInfo::minPossibleSiblingRvbIndex(rvb_index, level - 1)),
       current_value_(
-          computeNodeInitialValue(info_, NodeVal::initialValueZeroData.data(), NodeVal::kDigestContextOutputSize),
-          NodeVal::kDigestContextOutputSize) {
+          computeNodeInitialValue(info_, NodeVal::initialValueZeroData.data(), NodeVal::kDigestContextOutputSize)) {
   ConcordAssertGE(level, kDefaultRVTLeafLevel);
   logInfoVal("construct2: ");  // leave for debugging
 }
@@ -190,8 +417,7 @@ RVTNode::RVTNode(SerializedRVTNode& node, NodeVal&& val)
       child_ids_(std::move(node.child_ids)),
       insertion_counter_{node.last_insertion_index},
       initial_value_(
-          computeNodeInitialValue(info_, NodeVal::initialValueZeroData.data(), NodeVal::kDigestContextOutputSize),
-          NodeVal::kDigestContextOutputSize) {}
+          computeNodeInitialValue(info_, NodeVal::initialValueZeroData.data(), NodeVal::kDigestContextOutputSize)) {}
 
 void RVTNode::addValue(const NodeVal& nvalue) {
   // Keep for debug, do not remove please!
@@ -234,7 +460,7 @@ RVTNodePtr RVTNode::createFromSerialized(std::istringstream& is) {
   Serializable::deserialize(is, snode.child_ids);
   std::string hexVal;
   Serializable::deserialize(is, hexVal);
-  return std::make_shared<RVTNode>(snode, NodeVal(NodeVal_t::fromHexString(hexVal)));
+  return std::make_shared<RVTNode>(snode, NodeVal::fromHexString(hexVal));
 }
 
 // In some cases RVB node might be inserted in as a middle child (see more details in above ctor)
@@ -293,15 +519,13 @@ RangeValidationTree::RangeValidationTree(const logging::Logger& logger,
       metrics_component_{
           concordMetrics::Component("range_validation_tree", std::make_shared<concordMetrics::Aggregator>())} {
 #endif
-  NodeVal::kNodeValueModulo_ = NodeVal::calcModulo(value_size_);
-  ConcordAssert(NodeVal::kNodeValueModulo_ != NodeVal_t(static_cast<signed long>(0)));
+  NodeVal::setValueSize(value_size_);
   RVTMetadata::staticAssert();
   SerializedRVTNode::staticAssert();
   RangeValidationTree::RVT_K = RVT_K;
   LOG_INFO(logger_,
            "RVT created: RVT_K=" << RangeValidationTree::RVT_K
-                                 << " kNodeValueModulo_(hex)=" << NodeVal::kNodeValueModulo_.toHexString(true)
-                                 << " kNodeValueModulo_(dec)=" << NodeVal::kNodeValueModulo_
+                                 << " kNodeValueModulo_=2^" << (NodeVal::valueSize() * 8)
                                  << " fetch_range_size_=" << fetch_range_size_ << " value_size_=" << value_size_);
 }
 
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <vector>
 #include <memory>
@@ -23,7 +24,6 @@
 #include <unordered_set>
 
 #include "log/logger.hpp"
-#include "crypto/integer.hpp"
 
 #include "crypto/digest.hpp"
 #include "util/serializable.hpp"
@@ -62,7 +62,7 @@ using RVBIndex = uint64_t;
 // 1. Tree does not store RVB nodes.
 // 2. Only blocks at specific interval are validated to improve replica recovery time.
 // 3. Each node in tree is represented having type as NodeInfo.
-// 4. NodeVal is stored in form of concord::crypto::Integer.
+// 4. NodeVal is stored in a fixed width (up to 512 bits) form, modulo 2^(8 * value_size).
 //
 // Implementation notes -
 // 1. APIs do not throw exception
@@ -78,7 +78,6 @@ class RangeValidationTree {
   friend class test::BcStTestDelegator;
 
  public:
-  using NodeVal_t = concord::crypto::Integer;
   /////////////////////////// API /////////////////////////////////////
   RangeValidationTree(const logging::Logger& logger, uint32_t RVT_K, uint32_t fetch_range_size, size_t value_size = 32);
   ~RangeValidationTree() = default;
@@ -151,58 +150,76 @@ class RangeValidationTree {
   }
 
  public:
+  // NodeVal is a value modulo 2^(8 * value_size), kept in a fixed width (up to 512 bits) sign-magnitude form, in order
+  // to avoid heap allocations on the tree update paths.
+  // Arithmetic follows the semantics of the arbitrary precision integer which was used before: values are reduced by
+  // a truncated remainder, which takes the sign of the dividend. Hence, values (and their serialized form) are kept
+  // identical.
   struct NodeVal {
-    NodeVal(const char* vptr, size_t size)
-        : val_{NodeVal_t(reinterpret_cast<unsigned const char*>(vptr), size) % kNodeValueModulo_} {}
+    static constexpr size_t kMaxValueSize = 64;  // in bytes
+    static constexpr size_t kNumLimbs = kMaxValueSize / sizeof(uint64_t);
+    using Limbs = std::array<uint64_t, kNumLimbs>;  // least significant limb first
+
+    NodeVal(const char* vptr, size_t size);
     NodeVal(const std::shared_ptr<char[]>&& v, size_t size) : NodeVal(v.get(), size) {}
     NodeVal(const std::string& v) : NodeVal(v.data(), v.size()) {}
-    NodeVal(const NodeVal& v) : val_(v.val_) {}
-    NodeVal(NodeVal&& v) : val_(std::move(v.val_)) {}
-    NodeVal(long n) : val_{n} {}
-    NodeVal() : val_{0L} {}
-    NodeVal(const NodeVal_t& v) : val_{v % kNodeValueModulo_} {}
-
-    NodeVal operator+(const NodeVal& v) { return NodeVal((val_ + v.val_) % kNodeValueModulo_); }
-    NodeVal operator-(const NodeVal& v) { return NodeVal((val_ - v.val_) % kNodeValueModulo_); }
-    NodeVal operator*(const NodeVal& v) { return NodeVal((val_ * v.val_) % kNodeValueModulo_); }
-    NodeVal operator/(const NodeVal& v) { return NodeVal((val_ / v.val_) % kNodeValueModulo_); }
-    NodeVal operator%(const NodeVal& v) { return NodeVal(val_ % v.val_); }
-    NodeVal& operator+=(const NodeVal& v) {
-      val_ = (val_ + v.val_) % kNodeValueModulo_;
-      return *this;
-    }
-    // The result might be negative!
-    NodeVal& operator-=(const NodeVal& v) {
-      val_ = (kNodeValueModulo_ + val_ - v.val_) % kNodeValueModulo_;
-      toPositive();
-      return *this;
+    NodeVal(const NodeVal& v) = default;
+    NodeVal(NodeVal&& v) = default;
+    NodeVal(long n) : negative_{n < 0}, val_{} {
+      val_[0] = negative_ ? (0ULL - static_cast<uint64_t>(n)) : static_cast<uint64_t>(n);
     }
-    bool operator!=(const NodeVal& v) const { return (val_ != v.val_); }
-    bool operator==(const NodeVal& v) const { return (val_ == v.val_); }
-
-    void setNegative() { val_.setNegative(); }
-    bool isNegative() { return val_.isNegative(); }
-
-    std::string toDecString() const noexcept { return val_.toDecString(); }
+    NodeVal() : negative_{false}, val_{} {}
+    NodeVal& operator=(const NodeVal& v) = default;
+    NodeVal& operator=(NodeVal&& v) = default;
+
+    // Parse a hexadecimal string, as returned by toHexString()
+    static NodeVal fromHexString(const std::string& hex_str);
+
+    NodeVal operator+(const NodeVal& v) const { return NodeVal(*this).addSigned(v, false).reduce(); }
+    NodeVal operator-(const NodeVal& v) const { return NodeVal(*this).addSigned(v, true).reduce(); }
+    NodeVal operator*(const NodeVal& v) const;
+    NodeVal operator/(const NodeVal& v) const;
+    NodeVal operator%(const NodeVal& v) const;
+    NodeVal& operator+=(const NodeVal& v) { return addSigned(v, false).reduce(); }
+    // The result is never negative
+    NodeVal& operator-=(const NodeVal& v);
+    bool operator!=(const NodeVal& v) const { return !(*this == v); }
+    bool operator==(const NodeVal& v) const { return (negative_ == v.negative_) && (val_ == v.val_); }
+
+    void setNegative() { negative_ = !isZero(); }
+    bool isNegative() const { return negative_; }
+
+    std::string toDecString() const noexcept;
     // add_prefix should be true to add a '0x' prefix
-    std::string toHexString(bool add_prefix = false) const noexcept { return val_.toHexString(add_prefix); }
+    std::string toHexString(bool add_prefix = false) const noexcept;
     std::string toDecAndHexString() const noexcept { return toDecString() + " (" + toHexString(true) + ")"; }
 
-    static NodeVal_t calcModulo(size_t val_size) { return NodeVal_t(1L) << (val_size * 8ULL); }
+    // Values are reduced modulo 2^(8 * val_size). val_size must be in the range [1, kMaxValueSize]
+    static void setValueSize(size_t val_size);
+    static size_t valueSize() { return kNodeValueSize_; }
 
-    // TODO - this parameter should be none static to support multiple RVTs in the future
-    static NodeVal_t kNodeValueModulo_;
     static constexpr size_t kDigestContextOutputSize = DIGEST_SIZE;
     static constexpr std::array<char, kDigestContextOutputSize> initialValueZeroData{};
 
    private:
-    void toPositive() {
-      while (val_.isNegative()) {
-        val_ += kNodeValueModulo_;
-      }
-    }
+    bool isZero() const;
+    // Signed addition (or subtraction if negate is true). Magnitude is computed modulo 2^512, which is a multiple of
+    // the modulo.
+    NodeVal& addSigned(const NodeVal& v, bool negate);
+    // Truncated remainder by the modulo: the sign is kept, and zero is never negative
+    NodeVal& reduce();
+
+    static int compare(const Limbs& a, const Limbs& b);
+    // Returns the carry / borrow
+    static bool add(Limbs& a, const Limbs& b);
+    static bool sub(Limbs& a, const Limbs& b);
+    static void divMod(const Limbs& a, const Limbs& b, Limbs& quotient, Limbs& remainder);
+
+    // TODO - this parameter should be none static to support multiple RVTs in the future
+    static size_t kNodeValueSize_;
 
-    NodeVal_t val_;
+    bool negative_;
+    Limbs val_;
   };
 
   struct NodeInfo {
@@ -284,7 +301,7 @@ class RangeValidationTree {
     RVBNode(uint8_t level, uint64_t rvb_index);
     RVBNode(uint64_t node_id, NodeVal&&);
     void logInfoVal(const std::string& prefix = "");
-    const std::shared_ptr<char[]> computeNodeInitialValue(NodeInfo& node_id, const char* data, size_t data_size);
+    static NodeVal computeNodeInitialValue(NodeInfo& node_id, const char* data, size_t data_size);
 
     NodeInfo info_;
     NodeVal current_value_;
@@ -0,0 +1,97 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "ResPagesDigestTree.hpp"
+
+using concord::crypto::DigestGenerator;
+
+namespace bftEngine {
+namespace bcst {
+namespace impl {
+
+namespace {
+size_t roundUpToPowerOf2(uint32_t n) {
+  size_t res = 1;
+  while (res < n) res <<= 1;
+  return res;
+}
+}  // namespace
+
+ResPagesDigestTree::ResPagesDigestTree(uint32_t numOfPages)
+    : numOfPages_{numOfPages}, numOfLeaves_{roundUpToPowerOf2(numOfPages)}, nodes_(2 * numOfLeaves_) {
+  ConcordAssertGT(numOfPages_, 0);
+}
+
+void ResPagesDigestTree::build(const DataStore::ResPagesDescriptor* pagesDesc) {
+  ConcordAssertEQ(pagesDesc->numOfPages, numOfPages_);
+  for (uint32_t i = 0; i < numOfPages_; ++i) {
+    ConcordAssertEQ(pagesDesc->d[i].pageId, i);
+    nodes_[numOfLeaves_ + i] = digestOfPageDesc(pagesDesc->d[i]);
+  }
+  for (size_t i = numOfLeaves_ + numOfPages_; i < 2 * numOfLeaves_; ++i) {
+    nodes_[i].makeZero();
+  }
+  for (size_t i = numOfLeaves_ - 1; i > 0; --i) {
+    nodes_[i] = digestOfChildren(nodes_[2 * i], nodes_[2 * i + 1]);
+  }
+}
+
+void ResPagesDigestTree::update(const DataStore::SingleResPageDesc& pageDesc) {
+  ConcordAssertLT(pageDesc.pageId, numOfPages_);
+  size_t i = numOfLeaves_ + pageDesc.pageId;
+  nodes_[i] = digestOfPageDesc(pageDesc);
+  for (i /= 2; i > 0; i /= 2) {
+    nodes_[i] = digestOfChildren(nodes_[2 * i], nodes_[2 * i + 1]);
+  }
+}
+
+Digest ResPagesDigestTree::digest() const {
+  // with a single page, the leaf is the root
+  Digest res;
+  DigestGenerator digestGenerator;
+  digestGenerator.update(reinterpret_cast<const char*>(&numOfPages_), sizeof(numOfPages_));
+  digestGenerator.update(nodes_[1].get(), sizeof(Digest));
+  digestGenerator.writeDigest(res.getForUpdate());
+  return res;
+}
+
+Digest ResPagesDigestTree::computeDigest(const DataStore::ResPagesDescriptor* pagesDesc) {
+  ResPagesDigestTree tree{pagesDesc->numOfPages};
+  tree.build(pagesDesc);
+  return tree.digest();
+}
+
+Digest ResPagesDigestTree::digestOfPageDesc(const DataStore::SingleResPageDesc& pageDesc) {
+  // digest the fields, struct padding is not well defined
+  Digest res;
+  DigestGenerator digestGenerator;
+  digestGenerator.update(reinterpret_cast<const char*>(&pageDesc.pageId), sizeof(pageDesc.pageId));
+  digestGenerator.update(reinterpret_cast<const char*>(&pageDesc.relevantCheckpoint),
+                         sizeof(pageDesc.relevantCheckpoint));
+  digestGenerator.update(pageDesc.pageDigest.get(), sizeof(Digest));
+  digestGenerator.writeDigest(res.getForUpdate());
+  return res;
+}
+
+Digest ResPagesDigestTree::digestOfChildren(const Digest& left, const Digest& right) {
+  Digest res;
+  DigestGenerator digestGenerator;
+  digestGenerator.update(left.get(), sizeof(Digest));
+  digestGenerator.update(right.get(), sizeof(Digest));
+  digestGenerator.writeDigest(res.getForUpdate());
+  return res;
+}
+
+}  // namespace impl
+}  // namespace bcst
+}  // namespace bftEngine
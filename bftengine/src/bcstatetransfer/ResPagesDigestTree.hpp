@@ -0,0 +1,59 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "DataStore.hpp"
+
+namespace bftEngine {
+namespace bcst {
+namespace impl {
+
+// A binary Merkle tree over the reserved pages descriptor (DataStore::ResPagesDescriptor), used to compute the
+// descriptor digest of version ResPagesDigestVersion::MERKLE.
+// Leaf i is the digest of the descriptor of page i. The digest of the descriptor is the digest of the number of pages
+// and the tree root. Updating a single page descriptor costs O(log(numOfPages)) digest computations, instead of
+// digesting the whole descriptor.
+// Not thread safe.
+class ResPagesDigestTree {
+ public:
+  explicit ResPagesDigestTree(uint32_t numOfPages);
+
+  // (Re)build the whole tree
+  void build(const DataStore::ResPagesDescriptor* pagesDesc);
+
+  // Update the descriptor of a single page
+  void update(const DataStore::SingleResPageDesc& pageDesc);
+
+  // The digest of the whole descriptor
+  Digest digest() const;
+
+  // One-shot (non incremental) digest of a whole descriptor
+  static Digest computeDigest(const DataStore::ResPagesDescriptor* pagesDesc);
+
+ private:
+  static Digest digestOfPageDesc(const DataStore::SingleResPageDesc& pageDesc);
+  static Digest digestOfChildren(const Digest& left, const Digest& right);
+
+  const uint32_t numOfPages_;
+  // a power of 2, padding leaves are zero digests
+  const size_t numOfLeaves_;
+  // heap layout: nodes_[1] is the root, the children of node i are 2i and 2i+1, leaves start at numOfLeaves_
+  std::vector<Digest> nodes_;
+};
+
+}  // namespace impl
+}  // namespace bcst
+}  // namespace bftEngine
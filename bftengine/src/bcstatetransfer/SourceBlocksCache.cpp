@@ -0,0 +1,90 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "SourceBlocksCache.hpp"
+
+namespace bftEngine {
+namespace bcst {
+namespace impl {
+
+bool SourceBlocksCache::get(uint64_t blockId, char* outBlock, uint32_t outBlockMaxSize, uint32_t* outBlockActualSize) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = blocks_.find(blockId);
+  if (it == blocks_.end()) {
+    return false;
+  }
+  const auto& block = it->second->second;
+  if (block.size() > outBlockMaxSize) {
+    throw std::runtime_error("not enough space to copy block " + std::to_string(blockId));
+  }
+  memcpy(outBlock, block.data(), block.size());
+  *outBlockActualSize = static_cast<uint32_t>(block.size());
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return true;
+}
+
+void SourceBlocksCache::put(uint64_t blockId, const char* block, uint32_t blockSize) {
+  if (blockSize > maxSizeBytes_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = blocks_.find(blockId);
+  if (it != blocks_.end()) {
+    // blocks are immutable
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+  evict(blockSize);
+  lru_.emplace_front(blockId, std::vector<char>(block, block + blockSize));
+  blocks_.emplace(blockId, lru_.begin());
+  sizeBytes_ += blockSize;
+}
+
+bool SourceBlocksCache::contains(uint64_t blockId) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return blocks_.count(blockId) > 0;
+}
+
+void SourceBlocksCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  blocks_.clear();
+  lru_.clear();
+  sizeBytes_ = 0;
+}
+
+uint64_t SourceBlocksCache::sizeBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sizeBytes_;
+}
+
+size_t SourceBlocksCache::numOfBlocks() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return blocks_.size();
+}
+
+void SourceBlocksCache::evict(uint64_t requiredBytes) {
+  while (!lru_.empty() && (sizeBytes_ + requiredBytes > maxSizeBytes_)) {
+    const auto& [blockId, block] = lru_.back();
+    sizeBytes_ -= block.size();
+    blocks_.erase(blockId);
+    lru_.pop_back();
+  }
+}
+
+}  // namespace impl
+}  // namespace bcst
+}  // namespace bftEngine
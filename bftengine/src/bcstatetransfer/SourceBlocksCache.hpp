@@ -0,0 +1,60 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+#pragma once
+
+#include <stdint.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace bftEngine {
+namespace bcst {
+namespace impl {
+
+// Raw (serialized) blocks kept by a source replica, shared by all the destinations it serves. Blocks are read ahead
+// into the cache by a worker thread, and consumed by the ST thread.
+// Bounded by the total size of the cached blocks: the least recently used blocks are evicted first.
+// Thread safe.
+class SourceBlocksCache {
+ public:
+  explicit SourceBlocksCache(uint64_t maxSizeBytes) : maxSizeBytes_{maxSizeBytes} {}
+
+  // Copy block blockId into outBlock. Returns false if the block is not cached.
+  // Throws if outBlockMaxSize is too small.
+  bool get(uint64_t blockId, char* outBlock, uint32_t outBlockMaxSize, uint32_t* outBlockActualSize);
+  // Add a block. A block larger than the whole cache is ignored, an already cached block is only marked as recently
+  // used.
+  void put(uint64_t blockId, const char* block, uint32_t blockSize);
+  bool contains(uint64_t blockId) const;
+  void clear();
+
+  uint64_t sizeBytes() const;
+  size_t numOfBlocks() const;
+  uint64_t maxSizeBytes() const { return maxSizeBytes_; }
+
+ private:
+  using Entry = std::pair<uint64_t, std::vector<char>>;
+  void evict(uint64_t requiredBytes);
+
+  const uint64_t maxSizeBytes_;
+  mutable std::mutex mutex_;
+  // front is the most recently used block
+  std::list<Entry> lru_;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> blocks_;
+  uint64_t sizeBytes_ = 0;
+};
+
+}  // namespace impl
+}  // namespace bcst
+}  // namespace bftEngine
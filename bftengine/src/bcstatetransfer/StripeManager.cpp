@@ -0,0 +1,276 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "StripeManager.hpp"
+
+namespace bftEngine {
+namespace bcst {
+namespace impl {
+
+std::string Stripe::toString() const {
+  std::ostringstream oss;
+  oss << KVLOG(minBlockId, maxBlockId, sourceId, msgSeqNum, bytesReceived, completed);
+  return oss.str();
+}
+
+StripeManager::StripeManager(uint16_t maxNumOfStripes,
+                             uint32_t stripeInactivityTimeoutMilli,
+                             uint32_t sourceSuspensionTimeMilli,
+                             logging::Logger &logger)
+    : maxNumOfStripes_(maxNumOfStripes),
+      stripeInactivityTimeoutMilli_(stripeInactivityTimeoutMilli),
+      sourceSuspensionTimeMilli_(sourceSuspensionTimeMilli),
+      logger_(logger),
+      metrics_component_{
+          concordMetrics::Component("state_transfer_striped_fetch", std::make_shared<concordMetrics::Aggregator>())},
+      metrics_{metrics_component_.RegisterGauge("active_stripes", 0),
+               metrics_component_.RegisterCounter("stripes_dispatched"),
+               metrics_component_.RegisterCounter("stripes_completed"),
+               metrics_component_.RegisterCounter("stripes_consumed"),
+               metrics_component_.RegisterCounter("stripes_cancelled_bad_data"),
+               metrics_component_.RegisterCounter("stripes_cancelled_rejected"),
+               metrics_component_.RegisterCounter("stripes_cancelled_timeout"),
+               metrics_component_.RegisterCounter("stripes_cancelled_stale"),
+               metrics_component_.RegisterCounter("stripe_bytes_received"),
+               metrics_component_.RegisterCounter("sources_suspended")} {}
+
+bool StripeManager::isSuspended(uint16_t sourceId, uint64_t currTimeMilli) const {
+  auto it = suspendedSources_.find(sourceId);
+  return (it != suspendedSources_.end()) && (currTimeMilli < it->second);
+}
+
+uint64_t StripeManager::getSourceThroughput(uint16_t sourceId) const {
+  auto it = sourcesThroughput_.find(sourceId);
+  return (it == sourcesThroughput_.end()) ? 0 : it->second;
+}
+
+uint64_t StripeManager::bestThroughput() const {
+  uint64_t best = 0;
+  for (const auto &[id, throughput] : sourcesThroughput_) {
+    (void)id;
+    best = std::max(best, throughput);
+  }
+  return best;
+}
+
+uint16_t StripeManager::selectSource(const std::set<uint16_t> &candidates, uint64_t currTimeMilli) const {
+  uint16_t selected = NO_REPLICA;
+  uint64_t selectedThroughput = 0;
+
+  for (auto id : candidates) {
+    if ((stripes_.count(id) != 0) || isExcluded(id)) {
+      continue;
+    }
+    auto suspended = suspendedSources_.find(id);
+    if (suspended != suspendedSources_.end()) {
+      if (currTimeMilli < suspended->second) {
+        continue;
+      }
+      // Suspension is over - explore this source again
+      return id;
+    }
+    auto it = sourcesThroughput_.find(id);
+    if (it == sourcesThroughput_.end()) {
+      // Not explored yet - give it a chance
+      return id;
+    }
+    if ((selected == NO_REPLICA) || (it->second > selectedThroughput)) {
+      selected = id;
+      selectedThroughput = it->second;
+    }
+  }
+  return selected;
+}
+
+Stripe &StripeManager::addStripe(
+    uint64_t minBlockId, uint64_t maxBlockId, uint16_t sourceId, uint64_t msgSeqNum, uint64_t currTimeMilli) {
+  ConcordAssert(hasCapacity());
+  ConcordAssertLE(minBlockId, maxBlockId);
+  ConcordAssertNE(sourceId, NO_REPLICA);
+  ConcordAssertEQ(stripes_.count(sourceId), 0);
+
+  Stripe stripe;
+  stripe.minBlockId = minBlockId;
+  stripe.maxBlockId = maxBlockId;
+  stripe.sourceId = sourceId;
+  stripe.msgSeqNum = msgSeqNum;
+  stripe.assignTimeMilli = currTimeMilli;
+  stripe.lastActivityTimeMilli = currTimeMilli;
+  suspendedSources_.erase(sourceId);
+  auto &s = stripes_[sourceId] = stripe;
+  metrics_.stripes_dispatched_++;
+  updateActiveStripesMetric();
+  LOG_DEBUG(logger_, "Stripe added:" << s.toString());
+  return s;
+}
+
+Stripe *StripeManager::getStripeBySource(uint16_t sourceId) {
+  auto it = stripes_.find(sourceId);
+  return (it == stripes_.end()) ? nullptr : &it->second;
+}
+
+Stripe *StripeManager::getStripeByRange(uint64_t minBlockId, uint64_t maxBlockId) {
+  for (auto &[id, stripe] : stripes_) {
+    (void)id;
+    if ((stripe.minBlockId == minBlockId) && (stripe.maxBlockId == maxBlockId)) {
+      return &stripe;
+    }
+  }
+  return nullptr;
+}
+
+uint64_t StripeManager::maxStripedBlockId() const {
+  uint64_t maxBlockId = 0;
+  for (const auto &[id, stripe] : stripes_) {
+    (void)id;
+    maxBlockId = std::max(maxBlockId, stripe.maxBlockId);
+  }
+  return maxBlockId;
+}
+
+void StripeManager::onDataReceived(uint16_t sourceId, uint32_t numOfBytes, uint64_t currTimeMilli) {
+  auto *stripe = getStripeBySource(sourceId);
+  ConcordAssertNE(stripe, nullptr);
+  stripe->bytesReceived += numOfBytes;
+  stripe->lastActivityTimeMilli = currTimeMilli;
+  metrics_.stripe_bytes_received_ += numOfBytes;
+}
+
+void StripeManager::onStripeCompleted(uint16_t sourceId, uint64_t currTimeMilli) {
+  auto *stripe = getStripeBySource(sourceId);
+  ConcordAssertNE(stripe, nullptr);
+  ConcordAssert(!stripe->completed);
+  stripe->completed = true;
+  stripe->lastActivityTimeMilli = currTimeMilli;
+  metrics_.stripes_completed_++;
+
+  const auto throughput = updateThroughput(*stripe, currTimeMilli);
+  const auto best = bestThroughput();
+  LOG_DEBUG(logger_, "Stripe completed:" << stripe->toString() << KVLOG(throughput, best));
+
+  // Demote a slow source for a while - other sources will be used instead
+  if (isSlow(throughput)) {
+    LOG_INFO(logger_, "Slow source:" << KVLOG(sourceId, throughput, best));
+    suspendSource(sourceId, currTimeMilli);
+  }
+}
+
+// Update source throughput (bytes/sec), using an exponential moving average
+uint64_t StripeManager::updateThroughput(const Stripe &stripe, uint64_t currTimeMilli) {
+  const uint64_t sample = stripeThroughput(stripe, currTimeMilli);
+  auto it = sourcesThroughput_.find(stripe.sourceId);
+  if (it == sourcesThroughput_.end()) {
+    sourcesThroughput_[stripe.sourceId] = sample;
+    return sample;
+  }
+  it->second = (sample * kThroughputSampleWeightPercent + it->second * (100 - kThroughputSampleWeightPercent)) / 100;
+  return it->second;
+}
+
+uint64_t StripeManager::stripeThroughput(const Stripe &stripe, uint64_t currTimeMilli) {
+  const uint64_t durationMilli =
+      (currTimeMilli > stripe.assignTimeMilli) ? (currTimeMilli - stripe.assignTimeMilli) : 1;
+  return (stripe.bytesReceived * 1000) / durationMilli;
+}
+
+bool StripeManager::isSlow(uint64_t throughput) const {
+  return (throughput * 100) < (bestThroughput() * kSlowSourceThresholdPercent);
+}
+
+void StripeManager::onStripeConsumed(uint16_t sourceId) {
+  auto it = stripes_.find(sourceId);
+  ConcordAssert(it != stripes_.end());
+  ConcordAssert(it->second.completed);
+  LOG_DEBUG(logger_, "Stripe consumed:" << it->second.toString());
+  stripes_.erase(it);
+  metrics_.stripes_consumed_++;
+  updateActiveStripesMetric();
+}
+
+void StripeManager::onBadDataFromConsumedStripe(uint16_t sourceId) {
+  LOG_WARN(logger_, "Source excluded (bad data):" << KVLOG(sourceId));
+  excludedSources_.insert(sourceId);
+  sourcesThroughput_.erase(sourceId);
+  metrics_.stripes_cancelled_bad_data_++;
+}
+
+void StripeManager::cancelStripe(uint16_t sourceId, StripeCancelReason reason, uint64_t currTimeMilli) {
+  auto it = stripes_.find(sourceId);
+  if (it == stripes_.end()) {
+    return;
+  }
+  LOG_INFO(logger_, "Cancel stripe:" << it->second.toString() << KVLOG(static_cast<int>(reason)));
+  switch (reason) {
+    case StripeCancelReason::BAD_DATA:
+      excludedSources_.insert(sourceId);
+      sourcesThroughput_.erase(sourceId);
+      metrics_.stripes_cancelled_bad_data_++;
+      break;
+    case StripeCancelReason::REJECTED:
+      suspendSource(sourceId, currTimeMilli);
+      metrics_.stripes_cancelled_rejected_++;
+      break;
+    case StripeCancelReason::TIMEOUT:
+      if (it->second.bytesReceived > 0) {
+        // Remember how slow it was
+        updateThroughput(it->second, currTimeMilli);
+      }
+      suspendSource(sourceId, currTimeMilli);
+      metrics_.stripes_cancelled_timeout_++;
+      break;
+    case StripeCancelReason::STALE:
+      metrics_.stripes_cancelled_stale_++;
+      break;
+  }
+  stripes_.erase(it);
+  updateActiveStripesMetric();
+}
+
+std::vector<uint16_t> StripeManager::getInactiveStripesSources(uint64_t currTimeMilli) const {
+  std::vector<uint16_t> sources;
+  for (const auto &[id, stripe] : stripes_) {
+    if (!stripe.completed && (currTimeMilli > stripe.lastActivityTimeMilli) &&
+        ((currTimeMilli - stripe.lastActivityTimeMilli) > stripeInactivityTimeoutMilli_)) {
+      sources.push_back(id);
+    }
+  }
+  return sources;
+}
+
+bool StripeManager::isStripeLate(const Stripe &stripe, uint64_t waitingSinceMilli, uint64_t currTimeMilli) const {
+  if (stripe.completed || (currTimeMilli <= waitingSinceMilli) ||
+      ((currTimeMilli - waitingSinceMilli) <= stripeInactivityTimeoutMilli_)) {
+    return false;
+  }
+  if ((currTimeMilli - stripe.lastActivityTimeMilli) > stripeInactivityTimeoutMilli_) {
+    return true;
+  }
+  // Source is active, but may be much slower than others
+  return isSlow(stripeThroughput(stripe, currTimeMilli));
+}
+
+void StripeManager::suspendSource(uint16_t sourceId, uint64_t currTimeMilli) {
+  suspendedSources_[sourceId] = currTimeMilli + sourceSuspensionTimeMilli_;
+  metrics_.sources_suspended_++;
+}
+
+void StripeManager::reset() {
+  stripes_.clear();
+  suspendedSources_.clear();
+  excludedSources_.clear();
+  updateActiveStripesMetric();
+}
+
+}  // namespace impl
+}  // namespace bcst
+}  // namespace bftEngine
@@ -0,0 +1,155 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+#pragma once
+
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "log/logger.hpp"
+#include "util/assertUtils.hpp"
+#include "util/Metrics.hpp"
+#include "SourceSelector.hpp"
+
+namespace bftEngine {
+namespace bcst {
+namespace impl {
+
+// A stripe is a batch of blocks [minBlockId, maxBlockId], which is fetched ahead of time from a helper source (a
+// replica other than the current source replica), while the current source is serving the batch which is being
+// committed. Stripe data is not trusted: it is validated block by block, in descending order, only when the batch
+// becomes the current batch.
+struct Stripe {
+  uint64_t minBlockId = 0;
+  uint64_t maxBlockId = 0;
+  uint16_t sourceId = NO_REPLICA;
+  // Sequence number of the latest FetchBlocksMsg sent for this stripe
+  uint64_t msgSeqNum = 0;
+  uint64_t assignTimeMilli = 0;
+  uint64_t lastActivityTimeMilli = 0;
+  uint64_t bytesReceived = 0;
+  bool completed = false;
+
+  uint64_t numOfBlocks() const { return maxBlockId - minBlockId + 1; }
+  std::string toString() const;
+};
+
+enum class StripeCancelReason { BAD_DATA, REJECTED, TIMEOUT, STALE };
+
+// Assigns stripes to helper sources and tracks per-source throughput. Faster sources are preferred, sources which
+// did not yet serve a stripe are explored first, slow / unresponsive sources are suspended for a period of time and
+// sources which sent bad data are excluded until reset (end of cycle).
+// All methods which depend on time get the current time as a parameter, to simplify testing.
+class StripeManager {
+ public:
+  StripeManager(uint16_t maxNumOfStripes,
+                uint32_t stripeInactivityTimeoutMilli,
+                uint32_t sourceSuspensionTimeMilli,
+                logging::Logger &logger);
+
+  bool hasCapacity() const { return stripes_.size() < maxNumOfStripes_; }
+  bool empty() const { return stripes_.empty(); }
+  size_t numOfStripes() const { return stripes_.size(); }
+  uint16_t maxNumOfStripes() const { return maxNumOfStripes_; }
+
+  // Select the best idle source out of candidates: sources which were not explored yet (or which suspension is over)
+  // first, then the fastest one. Returns NO_REPLICA if no source is available.
+  uint16_t selectSource(const std::set<uint16_t> &candidates, uint64_t currTimeMilli) const;
+
+  Stripe &addStripe(
+      uint64_t minBlockId, uint64_t maxBlockId, uint16_t sourceId, uint64_t msgSeqNum, uint64_t currTimeMilli);
+  Stripe *getStripeBySource(uint16_t sourceId);
+  Stripe *getStripeByRange(uint64_t minBlockId, uint64_t maxBlockId);
+  // Stripes, keyed by source replica ID
+  const std::map<uint16_t, Stripe> &getStripes() const { return stripes_; }
+  // The highest block ID which is covered by any stripe, 0 if there are no stripes
+  uint64_t maxStripedBlockId() const;
+
+  void onDataReceived(uint16_t sourceId, uint32_t numOfBytes, uint64_t currTimeMilli);
+  void onStripeCompleted(uint16_t sourceId, uint64_t currTimeMilli);
+  // Stripe data was handed over to the consumer - stripe is removed, source becomes idle
+  void onStripeConsumed(uint16_t sourceId);
+  // Bad data was detected while validating data of a stripe which was already consumed
+  void onBadDataFromConsumedStripe(uint16_t sourceId);
+  void cancelStripe(uint16_t sourceId, StripeCancelReason reason, uint64_t currTimeMilli);
+
+  // Sources of non-completed stripes which were not active for too long
+  std::vector<uint16_t> getInactiveStripesSources(uint64_t currTimeMilli) const;
+  // A stripe is late if the consumer is waiting for it for too long, while it is either inactive, or served by a source
+  // which is much slower than the fastest known source.
+  bool isStripeLate(const Stripe &stripe, uint64_t waitingSinceMilli, uint64_t currTimeMilli) const;
+
+  // Estimated throughput of a source (bytes per second), 0 if unknown
+  uint64_t getSourceThroughput(uint16_t sourceId) const;
+  bool isExcluded(uint16_t sourceId) const { return excludedSources_.count(sourceId) != 0; }
+  bool isSuspended(uint16_t sourceId, uint64_t currTimeMilli) const;
+
+  // Clear all stripes and exclusions. Throughput statistics are kept, since they are still useful for the next cycle
+  void reset();
+
+  // Metric
+  void setAggregator(std::shared_ptr<concordMetrics::Aggregator> aggregator) {
+    metrics_component_.SetAggregator(aggregator);
+  }
+  void UpdateAggregator() { metrics_component_.UpdateAggregator(); }
+  concordMetrics::Component &getMetricComponent() { return metrics_component_; }
+
+  // weight of the newest sample in the throughput moving average, in percents
+  static constexpr uint64_t kThroughputSampleWeightPercent = 50;
+  // a source which is slower than this percentage of the fastest known source is considered slow
+  static constexpr uint64_t kSlowSourceThresholdPercent = 25;
+
+ private:
+  void suspendSource(uint16_t sourceId, uint64_t currTimeMilli);
+  uint64_t updateThroughput(const Stripe &stripe, uint64_t currTimeMilli);
+  static uint64_t stripeThroughput(const Stripe &stripe, uint64_t currTimeMilli);
+  uint64_t bestThroughput() const;
+  bool isSlow(uint64_t throughput) const;
+  void updateActiveStripesMetric() { metrics_.active_stripes_.Get().Set(stripes_.size()); }
+
+  const uint16_t maxNumOfStripes_;
+  const uint32_t stripeInactivityTimeoutMilli_;
+  const uint32_t sourceSuspensionTimeMilli_;
+
+  std::map<uint16_t, Stripe> stripes_;
+  // Exponential moving average of throughput (bytes/sec), per source
+  std::map<uint16_t, uint64_t> sourcesThroughput_;
+  // Source ID -> suspension end time
+  std::map<uint16_t, uint64_t> suspendedSources_;
+  std::set<uint16_t> excludedSources_;
+  logging::Logger &logger_;
+
+ protected:
+  // Metrics
+  concordMetrics::Component metrics_component_;
+  struct Metrics {
+    GaugeHandle active_stripes_;
+    CounterHandle stripes_dispatched_;
+    CounterHandle stripes_completed_;
+    CounterHandle stripes_consumed_;
+    CounterHandle stripes_cancelled_bad_data_;
+    CounterHandle stripes_cancelled_rejected_;
+    CounterHandle stripes_cancelled_timeout_;
+    CounterHandle stripes_cancelled_stale_;
+    CounterHandle stripe_bytes_received_;
+    CounterHandle sources_suspended_;
+  };
+  mutable Metrics metrics_;
+};
+
+}  // namespace impl
+}  // namespace bcst
+}  // namespace bftEngine
@@ -26,6 +26,40 @@ using namespace std::chrono;
 using namespace concord::serialize;
 namespace bftEngine::impl {
 
+/*************************** Class ClientsManager::PendingRequestsIndex ***************************/
+
+void ClientsManager::PendingRequestsIndex::add(Time time,
+                                               NodeIdType clientId,
+                                               ReqId reqSeqNum,
+                                               const std::string& cid) {
+  const lock_guard<mutex> lock(mutex_);
+  index_.emplace(std::make_tuple(time, clientId, reqSeqNum), cid);
+}
+
+void ClientsManager::PendingRequestsIndex::remove(Time time, NodeIdType clientId, ReqId reqSeqNum) {
+  const lock_guard<mutex> lock(mutex_);
+  index_.erase(std::make_tuple(time, clientId, reqSeqNum));
+}
+
+void ClientsManager::PendingRequestsIndex::clear() {
+  const lock_guard<mutex> lock(mutex_);
+  index_.clear();
+}
+
+bool ClientsManager::PendingRequestsIndex::earliest(Time& time, std::string& cid) const {
+  const lock_guard<mutex> lock(mutex_);
+  if (index_.empty()) return false;
+  const auto& [key, earliestCid] = *index_.cbegin();
+  time = std::get<0>(key);
+  cid = earliestCid;
+  return true;
+}
+
+size_t ClientsManager::PendingRequestsIndex::size() const {
+  const lock_guard<mutex> lock(mutex_);
+  return index_.size();
+}
+
 /*************************** Class ClientsManager::RequestsInfo ***************************/
 
 void ClientsManager::RequestsInfo::emplaceSafe(NodeIdType clientId, ReqId reqSeqNum, const std::string& cid) {
@@ -33,28 +67,35 @@ void ClientsManager::RequestsInfo::emplaceSafe(NodeIdType clientId, ReqId reqSeq
     LOG_WARN(CL_MNGR, "The request already exists - skip adding" << KVLOG(clientId, reqSeqNum));
     return;
   }
-  const lock_guard<mutex> lock(requestsMapMutex_);
-  requestsMap_.emplace(reqSeqNum, RequestInfo{getMonotonicTime(), cid});
+  const auto time = getMonotonicTime();
+  {
+    const lock_guard<mutex> lock(requestsMapMutex_);
+    requestsMap_.emplace(reqSeqNum, RequestInfo{time, cid});
+  }
+  pendingIndex_.add(time, clientId, reqSeqNum, cid);
   LOG_DEBUG(CL_MNGR, "Added request" << KVLOG(clientId, reqSeqNum, requestsMap_.size()));
 }
 
+void ClientsManager::RequestsInfo::unindex(NodeIdType clientId, ReqId reqSeqNum, const RequestInfo& reqInfo) {
+  // Committed requests were already removed from the index
+  if (!reqInfo.committed) pendingIndex_.remove(reqInfo.time, clientId, reqSeqNum);
+}
+
 bool ClientsManager::RequestsInfo::findSafe(ReqId reqSeqNum) {
   const lock_guard<mutex> lock(requestsMapMutex_);
   return (requestsMap_.find(reqSeqNum) != requestsMap_.end());
 }
 
 bool ClientsManager::RequestsInfo::removeRequestsOutOfBatchBoundsSafe(NodeIdType clientId, ReqId reqSequenceNum) {
-  ReqId maxReqId{0};
   if (requestsMap_.find(reqSequenceNum) != requestsMap_.end()) return false;
 
   const lock_guard<mutex> lock(requestsMapMutex_);
-  for (const auto& reqInfo : requestsMap_)
-    if (reqInfo.first > maxReqId) maxReqId = reqInfo.first;
-
-  if (requestsMap_.size() == maxNumOfRequestsInBatch && maxReqId > reqSequenceNum) {
+  if (requestsMap_.size() == maxNumOfRequestsInBatch && requestsMap_.crbegin()->first > reqSequenceNum) {
     // If we don't have room for the sequence number, and we see that the highest sequence number is greater
     // than the given one, it means that the highest sequence number is out of the boundaries and can be safely removed
-    requestsMap_.erase(maxReqId);
+    const auto maxReqIt = std::prev(requestsMap_.end());
+    unindex(clientId, maxReqIt->first, maxReqIt->second);
+    requestsMap_.erase(maxReqIt);
     return true;
   }
   return false;
@@ -66,6 +107,7 @@ void ClientsManager::RequestsInfo::removeOldPendingReqsSafe(NodeIdType clientId,
     const auto oldSeqNum = it->first;
     if (oldSeqNum <= reqSeqNum) {
       LOG_INFO(CL_MNGR, "Remove old pending request" << KVLOG(clientId, oldSeqNum, reqSeqNum));
+      unindex(clientId, oldSeqNum, it->second);
       it = requestsMap_.erase(it);
     } else
       it++;
@@ -76,6 +118,7 @@ void ClientsManager::RequestsInfo::removePendingForExecutionRequestSafe(NodeIdTy
   const lock_guard<mutex> lock(requestsMapMutex_);
   const auto& reqIt = requestsMap_.find(reqSeqNum);
   if (reqIt != requestsMap_.end()) {
+    unindex(clientId, reqSeqNum, reqIt->second);
     requestsMap_.erase(reqIt);
     LOG_DEBUG(CL_MNGR, "Removed request" << KVLOG(clientId, reqSeqNum, requestsMap_.size()));
   }
@@ -99,6 +142,7 @@ bool ClientsManager::RequestsInfo::isPending(ReqId reqSeqNum) const {
 void ClientsManager::RequestsInfo::markRequestAsCommitted(NodeIdType clientId, ReqId reqSeqNum) {
   const auto& reqIt = requestsMap_.find(reqSeqNum);
   if (reqIt != requestsMap_.end()) {
+    unindex(clientId, reqSeqNum, reqIt->second);
     reqIt->second.committed = true;
     LOG_DEBUG(CL_MNGR, "Marked committed" << KVLOG(clientId, reqSeqNum));
     return;
@@ -106,32 +150,6 @@ void ClientsManager::RequestsInfo::markRequestAsCommitted(NodeIdType clientId, R
   LOG_DEBUG(CL_MNGR, "Request not found" << KVLOG(clientId, reqSeqNum));
 }
 
-void ClientsManager::RequestsInfo::infoOfEarliestPendingRequest(Time& earliestTime,
-                                                                RequestInfo& earliestPendingReqInfo) const {
-  for (const auto& req : requestsMap_) {
-    // Don't take into account already committed requests
-    if ((req.second.time != MinTime) && (earliestTime > req.second.time) && (!req.second.committed)) {
-      earliestPendingReqInfo = req.second;
-      earliestTime = earliestPendingReqInfo.time;
-    }
-  }
-}
-
-void ClientsManager::RequestsInfo::logAllPendingRequestsExceedingThreshold(const int64_t threshold,
-                                                                           const Time& currTime,
-                                                                           int& numExceeding) const {
-  for (const auto& req : requestsMap_) {
-    // Don't take into account already committed requests
-    if ((req.second.time != MinTime) && (!req.second.committed)) {
-      const auto delayed = duration_cast<milliseconds>(currTime - req.second.time).count();
-      if (delayed > threshold) {
-        LOG_INFO(CL_MNGR, "Request exceeding threshold:" << KVLOG(req.second.cid, delayed));
-        numExceeding++;
-      }
-    }
-  }
-}
-
 /*************************** Class ClientsManager::RepliesInfo ***************************/
 
 void ClientsManager::RepliesInfo::deleteReplyIfNeededSafe(NodeIdType clientId,
@@ -225,9 +243,10 @@ ClientsManager::ClientsManager(const std::set<NodeIdType>& proxyClients,
   clientIds_.insert(clientServices_.begin(), clientServices_.end());
   clientIds_.insert(internalClients_.begin(), internalClients_.end());
   ConcordAssert(clientIds_.size() >= 1);
+  clientIdsToReservedPages_.resize(*clientIds_.crbegin() + 1, kInvalidClientIndex);
   uint32_t rpage = 0;
   for (const auto cid : clientIds_) {
-    clientIdsToReservedPages_.emplace(cid, rpage);
+    clientIdsToReservedPages_[cid] = rpage;
     rpage++;
   }
   // For the benefit of code accessing clientsInfo_, pre-fill clientsInfo_ with a blank entry for each client to reduce
@@ -235,7 +254,7 @@ ClientsManager::ClientsManager(const std::set<NodeIdType>& proxyClients,
   // so far.
   for (const auto& client_id : clientIds_) {
     clientsInfo_.emplace(client_id, ClientInfo());
-    clientsInfo_[client_id].requestsInfo = make_shared<RequestsInfo>();
+    clientsInfo_[client_id].requestsInfo = make_shared<RequestsInfo>(pendingRequestsIndex_);
     clientsInfo_[client_id].repliesInfo = make_shared<RepliesInfo>();
   }
 
@@ -567,27 +586,32 @@ void ClientsManager::removePendingForExecutionRequest(NodeIdType clientId, ReqId
 
 void ClientsManager::clearAllPendingRequests() {
   for (auto& clientInfo : clientsInfo_) clientInfo.second.requestsInfo->clearSafe();
+  pendingRequestsIndex_.clear();
   LOG_DEBUG(CL_MNGR, "Cleared pending requests for all clients");
 }
 
-// Iterate over all clients and choose the earliest pending request.
+// The earliest pending request is the first one in the pending requests index.
 Time ClientsManager::infoOfEarliestPendingRequest(std::string& cid) const {
   Time earliestTime = MaxTime;
-  RequestInfo earliestPendingReqInfo{MaxTime, std::string()};
-  for (const auto& clientInfo : clientsInfo_)
-    clientInfo.second.requestsInfo->infoOfEarliestPendingRequest(earliestTime, earliestPendingReqInfo);
-  cid = earliestPendingReqInfo.cid;
-  if (earliestPendingReqInfo.time != MaxTime) {
+  cid.clear();
+  if (pendingRequestsIndex_.earliest(earliestTime, cid)) {
     LOG_DEBUG(CL_MNGR, "Earliest pending request: " << KVLOG(cid));
   }
-  return earliestPendingReqInfo.time;
+  return earliestTime;
 }
 
-// Iterate over all clients and log the ones that have not been committed for more than threshold milliseconds.
+// Log the requests that have not been committed for more than threshold milliseconds. These are a prefix of the
+// pending requests index, so we stop at the first request that doesn't exceed the threshold.
 void ClientsManager::logAllPendingRequestsExceedingThreshold(const int64_t threshold, const Time& currTime) const {
   int numExceeding = 0;
-  for (const auto& clientInfo : clientsInfo_)
-    clientInfo.second.requestsInfo->logAllPendingRequestsExceedingThreshold(threshold, currTime, numExceeding);
+  pendingRequestsIndex_.visitInTimeOrder(
+      [threshold, &numExceeding, &currTime](const std::string& cid, const Time& time) {
+        const auto delayed = duration_cast<milliseconds>(currTime - time).count();
+        if (delayed <= threshold) return false;
+        LOG_INFO(CL_MNGR, "Request exceeding threshold:" << KVLOG(cid, delayed));
+        numExceeding++;
+        return true;
+      });
   if (numExceeding) {
     LOG_INFO(CL_MNGR, "Total Client request with more than " << threshold << "ms delay: " << numExceeding);
   }
@@ -25,6 +25,11 @@
 #include <unordered_map>
 #include <memory>
 #include <queue>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
 #include <boost/bimap.hpp>
 
 namespace bftEngine {
@@ -87,7 +92,9 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
   // not make sense (too high) - this will prevent some potential attacks)
   bool hasReply(NodeIdType clientId, ReqId reqSeqNum);
 
-  bool isValidClient(NodeIdType clientId) const { return clientIds_.find(clientId) != clientIds_.end(); }
+  bool isValidClient(NodeIdType clientId) const {
+    return clientId < clientIdsToReservedPages_.size() && clientIdsToReservedPages_[clientId] != kInvalidClientIndex;
+  }
 
   // First, if this ClientsManager has a number of reply records for the given clientId equalling or exceeding the
   // maximum client batch size configured at the time of this ClientManager's construction (or 1 if client batching was
@@ -174,12 +181,12 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
   // Finds the request recorded by this ClientsManager at the earliest time (ignoring requests marked as committed),
   // writes its CID to the reference cid, and returns what that earliest time was. Writes an empty string to cid and
   // returns bftEngine::impl::MaxTime if this ClientsManager does not currently have records for any non-committed
-  // requests.
+  // requests. Doesn't depend on the number of clients, as the non-committed requests are indexed by their time.
   Time infoOfEarliestPendingRequest(std::string& cid) const;
 
   // Log a message for each request not marked as committed that this ClientsManager currently has a record for created
   // at a time more than threshold milliseconds before currTime. As a precondition to this function, the global logger
-  // VC_LOG must be initialized. Behavior is undefined if it is not.
+  // VC_LOG must be initialized. Behavior is undefined if it is not. Only the exceeding requests are visited.
   void logAllPendingRequestsExceedingThreshold(const int64_t threshold, const Time& currTime) const;
 
   // Deletes the reply to clientId this ClientsManager currently has a record for at same index in batch. There should
@@ -205,7 +212,8 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
   uint32_t getReplyFirstPageId(NodeIdType clientId) const { return getKeyPageId(clientId) + 1; }
 
   uint32_t getKeyPageId(NodeIdType clientId) const {
-    return clientIdsToReservedPages_.at(clientId) * reservedPagesPerClient_;
+    if (!isValidClient(clientId)) throw std::out_of_range("invalid client id " + std::to_string(clientId));
+    return clientIdsToReservedPages_[clientId] * reservedPagesPerClient_;
   }
 
   const ReplicaId myId_;
@@ -224,11 +232,39 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
     bool committed = false;
   };
 
+  // The requests of all clients that are not committed yet, ordered by the time they were recorded. Requests are added
+  // and removed by the replica's main thread and by the post-execution thread.
+  class PendingRequestsIndex {
+   public:
+    void add(Time time, NodeIdType clientId, ReqId reqSeqNum, const std::string& cid);
+    void remove(Time time, NodeIdType clientId, ReqId reqSeqNum);
+    void clear();
+
+    // Writes the time and CID of the earliest request; returns false if there are no requests
+    bool earliest(Time& time, std::string& cid) const;
+    // Calls f(cid, time) for the requests in time order, as long as f returns true
+    template <typename F>
+    void visitInTimeOrder(F&& f) const {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& [key, cid] : index_) {
+        if (!f(cid, std::get<0>(key))) return;
+      }
+    }
+    size_t size() const;
+
+   private:
+    mutable std::mutex mutex_;
+    std::map<std::tuple<Time, NodeIdType, ReqId>, std::string> index_;
+  };
+
   class RequestsInfo {
    public:
+    explicit RequestsInfo(PendingRequestsIndex& pendingIndex) : pendingIndex_{pendingIndex} {}
+
     void emplaceSafe(NodeIdType clientId, ReqId reqSeqNum, const std::string& cid);
     bool removeRequestsOutOfBatchBoundsSafe(NodeIdType clientId, ReqId reqSequenceNum);
     bool findSafe(ReqId reqSeqNum);
+    // Doesn't update the pending requests index, which is cleared as a whole
     void clearSafe();
     void removeOldPendingReqsSafe(NodeIdType clientId, ReqId reqSeqNum);
     void removePendingForExecutionRequestSafe(NodeIdType clientId, ReqId reqSeqNum);
@@ -237,10 +273,12 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
     bool find(ReqId reqSeqNum) const;
     bool isPending(ReqId reqSeqNum) const;
     void markRequestAsCommitted(NodeIdType clientId, ReqId reqSeqNum);
-    void infoOfEarliestPendingRequest(Time& earliestTime, RequestInfo& earliestPendingReqInfo) const;
-    void logAllPendingRequestsExceedingThreshold(const int64_t threshold,
-                                                 const Time& currTime,
-                                                 int& numExceeding) const;
+
+   private:
+    // Removes a request that is about to be erased from requestsMap_ from the pending requests index
+    void unindex(NodeIdType clientId, ReqId reqSeqNum, const RequestInfo& reqInfo);
+
+    PendingRequestsIndex& pendingIndex_;
 
    public:
     std::mutex requestsMapMutex_;
@@ -281,8 +319,11 @@ class ClientsManager : public ResPagesClient<ClientsManager>, public IPendingReq
   std::set<NodeIdType> clientServices_;
   std::set<NodeIdType> internalClients_;
   std::set<NodeIdType> clientIds_;
-  std::map<NodeIdType, uint32_t> clientIdsToReservedPages_;
+  // Dense, indexed by client ID - the index of the client's reserved pages or kInvalidClientIndex
+  static constexpr uint32_t kInvalidClientIndex = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> clientIdsToReservedPages_;
   std::unordered_map<NodeIdType, ClientInfo> clientsInfo_;
+  PendingRequestsIndex pendingRequestsIndex_;
   const uint32_t maxReplySize_;
   const uint16_t maxNumOfReqsPerClient_;
   concordMetrics::Component& metrics_;
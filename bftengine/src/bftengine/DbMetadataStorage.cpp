@@ -13,6 +13,7 @@
 
 #include "DbMetadataStorage.hpp"
 #include "util/assertUtils.hpp"
+#include <algorithm>
 #include <cstring>
 #include <exception>
 
@@ -72,6 +73,15 @@ void DBMetadataStorage::read(uint32_t objectId,
                              uint32_t &outActualObjectSize) {
   verifyOperation(objectId, bufferSize, outBufferForObject, false);
   lock_guard<mutex> lock(ioMutex_);
+  // Writes of an open batch are visible, since the batch may be kept open across transactions (group commit)
+  if (batch_) {
+    auto elem = batch_->find(metadataKeyManipulator_->generateMetadataKey(objectId));
+    if (elem != batch_->end()) {
+      outActualObjectSize = std::min<uint32_t>(elem->second.length(), bufferSize);
+      memcpy(outBufferForObject, elem->second.data(), outActualObjectSize);
+      return;
+    }
+  }
   Status status = dbClient_->get(
       metadataKeyManipulator_->generateMetadataKey(objectId), outBufferForObject, bufferSize, outActualObjectSize);
   if (status.isNotFound()) {
@@ -28,6 +28,10 @@ class DebugPersistentStorage : public PersistentStorage {
   uint8_t beginWriteTran() override;
   uint8_t endWriteTran(bool sync = false) override;
   bool isInWriteTran() const override;
+  // Nothing is persisted, hence there is nothing to defer
+  void setDeferredCommits(bool) override {}
+  bool hasDeferredWrites() const override { return false; }
+  void commitDeferredWrites() override {}
   void setLastExecutedSeqNum(SeqNum seqNum) override;
   void setPrimaryLastUsedSeqNum(SeqNum seqNum) override;
   void setStrictLowerBoundOfSeqNums(SeqNum seqNum) override;
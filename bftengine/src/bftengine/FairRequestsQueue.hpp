@@ -0,0 +1,142 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the sub-component's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+namespace bftEngine::impl {
+
+// The requests queue of the primary. Instead of FIFO, requests are scheduled with deficit round-robin (DRR) across
+// clients, such that a client that sends many requests can't starve the others:
+// - Every client with queued requests gets a turn in round-robin order. On each turn, the client's deficit grows by
+//   quantum * weight bytes, and its requests are served while their size is covered by the deficit.
+// - A client's weight is 1 unless configured otherwise.
+// - The requests of a single client are served in FIFO order.
+// - The number of queued requests per client can be bounded, in which case push() rejects the requests of a client
+//   that already has maxRequestsPerClient queued.
+//
+// RequestT should provide clientProxyId() and size().
+template <typename RequestT>
+class FairRequestsQueue {
+ public:
+  using ClientId = uint16_t;
+  using RequestPtr = std::unique_ptr<RequestT>;
+
+  // quantum - number of bytes added to a client's deficit per turn; should be at least the maximum request size
+  // maxRequestsPerClient - 0 means no limit
+  FairRequestsQueue(uint32_t quantum,
+                    uint32_t maxRequestsPerClient,
+                    std::unordered_map<ClientId, uint16_t> weights = std::unordered_map<ClientId, uint16_t>{})
+      : quantum_{std::max<uint32_t>(quantum, 1)},
+        maxRequestsPerClient_{maxRequestsPerClient},
+        weights_{std::move(weights)} {}
+
+  // Returns false (and leaves the request with the caller) if the client's queue is full
+  bool push(RequestPtr&& req) {
+    const auto clientId = req->clientProxyId();
+    auto& client = clients_[clientId];
+    if (maxRequestsPerClient_ > 0 && client.requests.size() >= maxRequestsPerClient_) {
+      return false;
+    }
+    if (client.requests.empty()) {
+      activeClients_.push_back(clientId);
+    }
+    client.requests.push_back(std::move(req));
+    ++size_;
+    return true;
+  }
+
+  // The next request to be served, or nullptr if the queue is empty
+  RequestT* front() {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    while (true) {
+      auto& client = clients_[activeClients_.front()];
+      if (!turnStarted_) {
+        client.deficit += static_cast<uint64_t>(quantum_) * weight(activeClients_.front());
+        turnStarted_ = true;
+      }
+      if (client.requests.front()->size() <= client.deficit) {
+        return client.requests.front().get();
+      }
+      // The client's turn is over
+      activeClients_.push_back(activeClients_.front());
+      activeClients_.pop_front();
+      turnStarted_ = false;
+    }
+  }
+
+  // Remove the request returned by front()
+  void pop() {
+    const auto* req = front();
+    if (req == nullptr) {
+      return;
+    }
+    const auto clientId = activeClients_.front();
+    auto& client = clients_[clientId];
+    client.deficit -= req->size();
+    client.requests.pop_front();
+    --size_;
+    if (client.requests.empty()) {
+      // Idle clients don't accumulate deficit
+      clients_.erase(clientId);
+      activeClients_.pop_front();
+      turnStarted_ = false;
+    }
+  }
+
+  void clear() {
+    clients_.clear();
+    activeClients_.clear();
+    turnStarted_ = false;
+    size_ = 0;
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  size_t size(ClientId clientId) const {
+    auto it = clients_.find(clientId);
+    return it == clients_.cend() ? 0 : it->second.requests.size();
+  }
+  bool isClientQueueFull(ClientId clientId) const {
+    return maxRequestsPerClient_ > 0 && size(clientId) >= maxRequestsPerClient_;
+  }
+  size_t numOfActiveClients() const { return activeClients_.size(); }
+
+ private:
+  struct ClientQueue {
+    std::deque<RequestPtr> requests;
+    uint64_t deficit = 0;
+  };
+
+  uint16_t weight(ClientId clientId) const {
+    auto it = weights_.find(clientId);
+    return (it == weights_.cend() || it->second == 0) ? 1 : it->second;
+  }
+
+  const uint32_t quantum_;
+  const uint32_t maxRequestsPerClient_;
+  const std::unordered_map<ClientId, uint16_t> weights_;
+  std::unordered_map<ClientId, ClientQueue> clients_;
+  // Clients with queued requests in round-robin order. The client at the front has the current turn.
+  std::deque<ClientId> activeClients_;
+  bool turnStarted_ = false;
+  size_t size_ = 0;
+};
+
+}  // namespace bftEngine::impl
@@ -194,6 +194,9 @@ void IncomingMsgsStorageImp::dispatchMessages(std::promise<void>& signalStarted)
         case IncomingMsg::INTERNAL:
           msgHandlers_->handleInternalMsg(std::move(msg.internal));
       };
+      if (ptrThreadLocalQueueForExternalMessages_->empty() && ptrThreadLocalQueueForInternalMessages_->empty()) {
+        msgHandlers_->handleMsgsBatchDone();
+      }
     }
   } catch (const std::exception& e) {
     LOG_FATAL(GL, "Exception: " << e.what() << "exiting ...");
@@ -31,6 +31,7 @@ using CallbackTypeWithRefArg = std::function<void(T&&)>;
 using MsgHandlerCallback = CallbackTypeWithArg<std::unique_ptr<MessageBase>>;
 using ValidatedMsgHandlerCallback = CallbackTypeWithRawPtrArg<CarrierMesssage>;
 using InternalMsgHandlerCallback = CallbackTypeWithRefArg<InternalMessage>;
+using MsgsBatchDoneCallback = std::function<void()>;
 
 // MsgHandlersRegistrator class contains message handling callback functions.
 // Logically it's a singleton - only one message handler could be registered for every message type,
@@ -44,6 +45,8 @@ using InternalMsgHandlerCallback = CallbackTypeWithRefArg<InternalMessage>;
 //     message will happen.
 //  3) Internal message callback handler which will be called by the Internal message
 //     dispatcher.
+//  4) An optional callback which will be called by the dispatcher once it has handled all the messages it took from
+//     the incoming queues at once (or once it waited for messages in vain).
 // MsgHandlersRegistrator is a repository of all kinds of callbacks.
 
 class MsgHandlersRegistrator {
@@ -62,6 +65,8 @@ class MsgHandlersRegistrator {
 
   void registerInternalMsgHandler(const InternalMsgHandlerCallback& cb) { internalMsgHandler_ = cb; }
 
+  void registerMsgsBatchDoneHandler(const MsgsBatchDoneCallback& cb) { msgsBatchDoneHandler_ = cb; }
+
   MsgHandlerCallback getCallback(uint16_t msgId) {
     auto iterator = msgHandlers_.find(msgId);
     if (iterator != msgHandlers_.end()) return iterator->second;
@@ -79,10 +84,15 @@ class MsgHandlersRegistrator {
 
   void handleInternalMsg(InternalMessage&& msg) { internalMsgHandler_(std::move(msg)); }
 
+  void handleMsgsBatchDone() {
+    if (msgsBatchDoneHandler_) msgsBatchDoneHandler_();
+  }
+
  private:
   std::unordered_map<uint16_t, MsgHandlerCallback> msgHandlers_;
   std::unordered_map<uint16_t, ValidatedMsgHandlerCallback> validatedMsgHandlers_;
   InternalMsgHandlerCallback internalMsgHandler_;
+  MsgsBatchDoneCallback msgsBatchDoneHandler_;
 };
 
 }  // namespace bftEngine::impl
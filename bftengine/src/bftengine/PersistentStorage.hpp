@@ -63,6 +63,19 @@ class PersistentStorage {
   // return true IFF write-only transactions are running now
   virtual bool isInWriteTran() const = 0;
 
+  // Group commit: while commits are deferred, the outermost endWriteTran() doesn't commit the transaction. Instead,
+  // the writes of all the transactions that ended since the last commit are committed at once by
+  // commitDeferredWrites(), which syncs if any of them asked to. A transaction that sets the descriptor of the last
+  // execution is never deferred, it is committed along with the deferred writes when it ends.
+  virtual void setDeferredCommits(bool deferred) = 0;
+
+  // return true IFF there are ended transactions that are not committed yet. Can be called by any thread.
+  virtual bool hasDeferredWrites() const = 0;
+
+  // commit the deferred writes, if any (does nothing while a write-only transaction is running). Can be called by any
+  // thread.
+  virtual void commitDeferredWrites() = 0;
+
   //////////////////////////////////////////////////////////////////////////
   // Update methods (should only be used in write-only transactions)
   //////////////////////////////////////////////////////////////////////////
@@ -149,22 +149,50 @@ ObjectDescMap PersistentStorageImp::getDefaultMetadataObjectDescriptors(uint16_t
 }
 
 uint8_t PersistentStorageImp::beginWriteTran() {
-  if (numOfNestedTransactions_ == 0) {
+  std::lock_guard<std::mutex> lock(deferredWritesLock_);
+  if (numOfNestedTransactions_ == 0 && !hasDeferredWrites_) {
     metadataStorage_->beginAtomicWriteOnlyBatch();
   }
   return ++numOfNestedTransactions_;
 }
 
 uint8_t PersistentStorageImp::endWriteTran(bool sync) {
+  std::lock_guard<std::mutex> lock(deferredWritesLock_);
   ConcordAssertNE(numOfNestedTransactions_, 0);
   if (--numOfNestedTransactions_ == 0) {
-    metadataStorage_->commitAtomicWriteOnlyBatch(sync);
+    if (deferCommits_ && !commitOnEndWriteTran_) {
+      syncDeferredWrites_ = syncDeferredWrites_ || sync;
+      hasDeferredWrites_ = true;
+    } else {
+      metadataStorage_->commitAtomicWriteOnlyBatch(sync || syncDeferredWrites_);
+      syncDeferredWrites_ = false;
+      hasDeferredWrites_ = false;
+    }
+    commitOnEndWriteTran_ = false;
   }
   return numOfNestedTransactions_;
 }
 
 bool PersistentStorageImp::isInWriteTran() const { return (numOfNestedTransactions_ != 0); }
 
+void PersistentStorageImp::setDeferredCommits(bool deferred) {
+  LOG_INFO(GL, KVLOG(deferred));
+  {
+    std::lock_guard<std::mutex> lock(deferredWritesLock_);
+    deferCommits_ = deferred;
+  }
+  if (!deferred) commitDeferredWrites();
+}
+
+void PersistentStorageImp::commitDeferredWrites() {
+  // Called by other threads as well, e.g. by the atomic writes of DbCheckpointManager
+  std::lock_guard<std::mutex> lock(deferredWritesLock_);
+  if (!hasDeferredWrites_ || numOfNestedTransactions_ != 0) return;
+  metadataStorage_->commitAtomicWriteOnlyBatch(syncDeferredWrites_);
+  syncDeferredWrites_ = false;
+  hasDeferredWrites_ = false;
+}
+
 /***** Setters *****/
 
 void PersistentStorageImp::setVersion() const {
@@ -355,6 +383,9 @@ void PersistentStorageImp::initDescriptorOfLastStableCheckpoint() {
 
 void PersistentStorageImp::setDescriptorOfLastExecution(const DescriptorOfLastExecution &desc) {
   setDescriptorOfLastExecution(desc, false);
+  // The descriptor is the write-ahead record of the execution, which changes the application state right after the
+  // transaction. Hence, the transaction is committed even if commits are deferred.
+  commitOnEndWriteTran_ = true;
   hasDescriptorOfLastExecution_ = true;
   descriptorOfLastExecution_ = DescriptorOfLastExecution{desc.executedSeqNum, desc.validRequests, desc.timeInTicks};
 }
@@ -544,6 +575,8 @@ void PersistentStorageImp::setUserDataAtomically(const void *data, std::size_t n
   if (numberOfBytes > kMaxUserDataSizeBytes) {
     throw std::invalid_argument{"Metadata user data is too big"};
   }
+  // Atomic writes must not overtake the deferred ones
+  commitDeferredWrites();
   metadataStorage_->atomicWrite(USER_DATA, static_cast<const char *>(data), numberOfBytes);
 }
 
@@ -1021,6 +1054,7 @@ bool PersistentStorageImp::nonExecSetIsAllowed() {
 }
 void PersistentStorageImp::setEraseMetadataStorageFlag() {
   bool eraseMtOnStartUp = true;
+  commitDeferredWrites();
   metadataStorage_->atomicWrite(ERASE_METADATA_ON_STARTUP, (char *)&eraseMtOnStartUp, sizeof(eraseMtOnStartUp));
 }
 
@@ -1035,6 +1069,7 @@ bool PersistentStorageImp::getEraseMetadataStorageFlag() {
 
 void PersistentStorageImp::setNewEpochFlag(bool flag) {
   bool newEpoch = flag;
+  commitDeferredWrites();
   metadataStorage_->atomicWrite(START_NEW_EPOCH, (char *)&newEpoch, sizeof(newEpoch));
 }
 
@@ -1046,10 +1081,14 @@ bool PersistentStorageImp::getNewEpochFlag() {
   return newEpoch;
 }
 
-void PersistentStorageImp::eraseMetadata() { metadataStorage_->eraseData(); }
+void PersistentStorageImp::eraseMetadata() {
+  commitDeferredWrites();
+  metadataStorage_->eraseData();
+}
 
 void PersistentStorageImp::setDbCheckpointMetadata(const std::vector<std::uint8_t> &v) {
   std::string data(v.begin(), v.end());
+  commitDeferredWrites();
   metadataStorage_->atomicWrite(DB_CHECKPOINT_DESCRIPTOR, data.data(), data.size());
 }
 std::optional<std::vector<std::uint8_t>> PersistentStorageImp::getDbCheckpointMetadata(const uint32_t &maxBuffSz) {
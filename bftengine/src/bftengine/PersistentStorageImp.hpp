@@ -16,6 +16,9 @@
 #include "MetadataStorage.hpp"
 #include "PersistentStorageWindows.hpp"
 
+#include <atomic>
+#include <mutex>
+
 namespace bftEngine {
 namespace impl {
 
@@ -122,6 +125,9 @@ class PersistentStorageImp : public PersistentStorage {
   uint8_t beginWriteTran() override;
   uint8_t endWriteTran(bool sync = false) override;
   bool isInWriteTran() const override;
+  void setDeferredCommits(bool deferred) override;
+  bool hasDeferredWrites() const override { return hasDeferredWrites_; }
+  void commitDeferredWrites() override;
 
   // Setters
   void setLastExecutedSeqNum(SeqNum seqNum) override;
@@ -268,7 +274,16 @@ class PersistentStorageImp : public PersistentStorage {
   // The rsiLatestIndex is a map of <principle_id, latest_index>
   std::unordered_map<uint32_t, uint64_t> rsiLatestIndex;
 
+  // Written by the thread that runs the write transactions, read by other threads under deferredWritesLock_
   uint8_t numOfNestedTransactions_ = 0;
+  // Group commit - the metadata storage batch stays open while there are deferred writes. Deferred writes may be
+  // committed by other threads, hence the batch is begun and committed under deferredWritesLock_.
+  std::mutex deferredWritesLock_;
+  bool deferCommits_ = false;
+  std::atomic_bool hasDeferredWrites_{false};
+  bool syncDeferredWrites_ = false;
+  // The current transaction is committed when it ends, even if commits are deferred
+  bool commitOnEndWriteTran_ = false;
   const SeqNum seqNumWindowFirst_ = 1;
   const SeqNum checkWindowFirst_ = 0;
   SeqNum checkWindowBeginning_ = 0;
@@ -80,6 +80,10 @@ void ReplicaBase::sendToAllOtherReplicas(MessageBase* m, bool includeRo) {
   if (includeRo) {
     replicas.insert(repsInfo->idsOfPeerROReplicas().begin(), repsInfo->idsOfPeerROReplicas().end());
   }
+  if (holdOutgoingMsgs() || hasHeldMsgs_) {
+    holdMsg(m, std::move(replicas));
+    return;
+  }
   msgsCommunicator_->send(replicas, m->body(), m->size());
 }
 
@@ -87,10 +91,41 @@ void ReplicaBase::sendRaw(MessageBase* m, NodeIdType dest) {
   if (config_.debugStatisticsEnabled) DebugStatistics::onSendExMessage(m->type());
   MsgCode::Type type = static_cast<MsgCode::Type>(m->type());
 
+  if (holdOutgoingMsgs() || hasHeldMsgs_) {
+    holdMsg(m, {dest});
+    return;
+  }
   LOG_DEBUG(CNSUS, "sending msg type: " << type << ", dest: " << dest);
   if (msgsCommunicator_->sendAsyncMessage(dest, m->body(), m->size())) {
     LOG_ERROR(CNSUS, "sendAsyncMessage failed: " << KVLOG(type, dest));
   }
 }
 
+void ReplicaBase::holdMsg(MessageBase* m, std::set<bft::communication::NodeNum>&& dests) {
+  LOG_DEBUG(CNSUS, "holding msg type: " << static_cast<MsgCode::Type>(m->type()));
+  std::lock_guard<std::mutex> lock(heldMsgsLock_);
+  heldMsgs_.push_back(HeldMsg{std::move(dests), std::vector<char>(m->body(), m->body() + m->size())});
+  hasHeldMsgs_ = true;
+}
+
+void ReplicaBase::releaseOutgoingMsgs() {
+  if (!hasHeldMsgs_) return;
+  std::vector<HeldMsg> msgs;
+  {
+    std::lock_guard<std::mutex> lock(heldMsgsLock_);
+    msgs.swap(heldMsgs_);
+    hasHeldMsgs_ = false;
+  }
+  for (auto& msg : msgs) {
+    if (msg.dests.size() == 1) {
+      const auto dest = *msg.dests.begin();
+      if (msgsCommunicator_->sendAsyncMessage(dest, msg.data.data(), msg.data.size())) {
+        LOG_ERROR(CNSUS, "sendAsyncMessage failed: " << KVLOG(dest));
+      }
+    } else {
+      msgsCommunicator_->send(msg.dests, msg.data.data(), msg.data.size());
+    }
+  }
+}
+
 }  // namespace bftEngine::impl
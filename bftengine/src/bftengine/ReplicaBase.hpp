@@ -11,7 +11,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
 #include "IRequestHandler.hpp"
 #include "PrimitiveTypes.hpp"
 #include "ReplicaConfig.hpp"
@@ -20,6 +24,7 @@
 #include "util/Metrics.hpp"
 #include "util/Timers.hpp"
 #include "ControlStateManager.hpp"
+#include "communication/ICommunication.hpp"
 
 namespace bftEngine::impl {
 
@@ -80,6 +85,12 @@ class ReplicaBase {
 
   void sendRaw(MessageBase* m, NodeIdType dest);
 
+  // Outgoing messages are held back (copied) while holdOutgoingMsgs() returns true, and are sent by
+  // releaseOutgoingMsgs(). Used to send messages only once the state they depend on is persisted. To keep the order of
+  // the messages, they are held as well until the held ones are released.
+  virtual bool holdOutgoingMsgs() const { return false; }
+  void releaseOutgoingMsgs();
+
   bool validateMessage(MessageBase* msg) {
     try {
       if (config_.debugStatisticsEnabled) DebugStatistics::onReceivedExMessage(msg->type());
@@ -116,6 +127,17 @@ class ReplicaBase {
   Timers::Handle debugStatTimer_;
   Timers::Handle metricsTimer_;
   concordUtil::Timers& timers_;
+
+ private:
+  struct HeldMsg {
+    std::set<bft::communication::NodeNum> dests;
+    std::vector<char> data;
+  };
+  void holdMsg(MessageBase* m, std::set<bft::communication::NodeNum>&& dests);
+
+  std::mutex heldMsgsLock_;
+  std::vector<HeldMsg> heldMsgs_;
+  std::atomic_bool hasHeldMsgs_{false};
 };
 
 }  // namespace bftEngine::impl
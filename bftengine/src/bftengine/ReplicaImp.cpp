@@ -172,6 +172,33 @@ void ReplicaImp::registerMsgHandlers() {
                                    bind(&ReplicaImp::messageHandler<StateTransferMsg>, this, placeholders::_1));
 
   msgHandlers_->registerInternalMsgHandler([this](InternalMessage &&msg) { onInternalMsg(std::move(msg)); });
+
+  msgHandlers_->registerMsgsBatchDoneHandler([this]() { onMsgsBatchDone(); });
+}
+
+void ReplicaImp::onMsgsBatchDone() { flushDeferredMetadata(); }
+
+void ReplicaImp::commitDeferredMetadata() {
+  if (ps_ && ps_->hasDeferredWrites()) {
+    ps_->commitDeferredWrites();
+    metric_metadata_group_commits_++;
+  }
+  // Executions are persisted only now, if their writes were deferred
+  if (const auto seqNum = pendingExecutionPersisted_.exchange(0)) events_.record("ExecutionPersisted", seqNum);
+}
+
+void ReplicaImp::flushDeferredMetadata() {
+  commitDeferredMetadata();
+  // Writes are still deferred if a write transaction is running
+  if (!ps_ || !ps_->hasDeferredWrites()) releaseOutgoingMsgs();
+}
+
+void ReplicaImp::recordExecutionPersisted(SeqNum seqNum) {
+  if (ps_ && ps_->hasDeferredWrites()) {
+    pendingExecutionPersisted_ = seqNum;
+  } else {
+    events_.record("ExecutionPersisted", seqNum);
+  }
 }
 
 template <typename T>
@@ -479,6 +506,12 @@ void ReplicaImp::onMessage<ClientRequestMsg>(std::unique_ptr<ClientRequestMsg> m
                      << KVLOG(clientId, reqSeqNum, requestsQueueOfPrimary.size()));
         return;
       }
+      if (requestsQueueOfPrimary.isClientQueueFull(clientId)) {
+        LOG_WARN(CNSUS,
+                 "ClientRequestMsg dropped. The client's share of the primary request queue is full. "
+                     << KVLOG(clientId, reqSeqNum, requestsQueueOfPrimary.size(clientId)));
+        return;
+      }
       if (clientsManager->canBecomePending(clientId, reqSeqNum)) {
         LOG_DEBUG(CNSUS, "Pushing to primary queue, request " << KVLOG(reqSeqNum, clientId, senderId));
         if (time_to_collect_batch_ == MinTime) time_to_collect_batch_ = getMonotonicTime();
@@ -611,11 +644,11 @@ bool ReplicaImp::checkSendPrePrepareMsgPrerequisites() {
 void ReplicaImp::removeDuplicatedRequestsFromRequestsQueue() {
   TimeRecorder scoped_timer(*histograms_.removeDuplicatedRequestsFromQueue);
   // Remove duplicated requests that are result of client retrials from the head of the requestsQueueOfPrimary
-  ClientRequestMsg *first = (requestsQueueOfPrimary.empty() ? nullptr : requestsQueueOfPrimary.front().get());
+  ClientRequestMsg *first = requestsQueueOfPrimary.front();
   while (first != nullptr && !clientsManager->canBecomePending(first->clientProxyId(), first->requestSeqNum())) {
     primaryCombinedReqSize -= first->size();
     requestsQueueOfPrimary.pop();
-    first = (requestsQueueOfPrimary.empty() ? nullptr : requestsQueueOfPrimary.front().get());
+    first = requestsQueueOfPrimary.front();
   }
   primary_queue_size_.Get().Set(requestsQueueOfPrimary.size());
 }
@@ -716,6 +749,8 @@ ClientRequestMsg *ReplicaImp::addRequestToPrePrepareMessage(ClientRequestMsg *ne
       clientsManager->addPendingRequest(
           nextRequest->clientProxyId(), nextRequest->requestSeqNum(), nextRequest->getCid());
       metric_primary_batching_duration_.finishMeasurement(nextRequest->getCid());
+      // Under the consensus sequence number, which is the id of the other events of the request
+      events_.record("ClientRequestAdded", prePrepareMsg.seqNumber(), nextRequest->clientProxyId());
     }
   } else if (nextRequest->size() > maxStorageForRequests) {  // The message is too big
     LOG_WARN(GL,
@@ -725,7 +760,7 @@ ClientRequestMsg *ReplicaImp::addRequestToPrePrepareMessage(ClientRequestMsg *ne
   primaryCombinedReqSize -= nextRequest->size();
   requestsQueueOfPrimary.pop();
   primary_queue_size_.Get().Set(requestsQueueOfPrimary.size());
-  return (requestsQueueOfPrimary.empty() ? nullptr : requestsQueueOfPrimary.front().get());
+  return requestsQueueOfPrimary.front();
 }
 
 // Finalize the preprepare message by adding digest at a point when no more changes will happen.
@@ -823,7 +858,7 @@ PrePrepareMsgCreationResult ReplicaImp::buildPrePrepareMessage() {
   uint32_t maxSpaceForReqs = prePrepareMsg->remainingSizeForRequests();
   {
     TimeRecorder scoped_timer1(*histograms_.addAllRequestsToPrePrepare);
-    ClientRequestMsg *nextRequest = (requestsQueueOfPrimary.empty() ? nullptr : requestsQueueOfPrimary.front().get());
+    ClientRequestMsg *nextRequest = requestsQueueOfPrimary.front();
     while (nextRequest != nullptr)
       nextRequest = addRequestToPrePrepareMessage(nextRequest, *prePrepareMsg.get(), maxSpaceForReqs);
   }
@@ -841,7 +876,7 @@ PrePrepareMsgCreationResult ReplicaImp::buildPrePrepareMessageByRequestsNum(uint
   }
 
   uint32_t maxSpaceForReqs = prePrepareMsg->remainingSizeForRequests();
-  ClientRequestMsg *nextRequest = (requestsQueueOfPrimary.empty() ? nullptr : requestsQueueOfPrimary.front().get());
+  ClientRequestMsg *nextRequest = requestsQueueOfPrimary.front();
   while (nextRequest != nullptr && prePrepareMsg->numberOfRequests() < requiredRequestsNum)
     nextRequest = addRequestToPrePrepareMessage(nextRequest, *prePrepareMsg.get(), maxSpaceForReqs);
 
@@ -858,7 +893,7 @@ PrePrepareMsgCreationResult ReplicaImp::buildPrePrepareMessageByBatchSize(uint32
   }
 
   uint32_t maxSpaceForReqs = prePrepareMsg->remainingSizeForRequests();
-  ClientRequestMsg *nextRequest = (requestsQueueOfPrimary.empty() ? nullptr : requestsQueueOfPrimary.front().get());
+  ClientRequestMsg *nextRequest = requestsQueueOfPrimary.front();
   while (nextRequest != nullptr &&
          (maxSpaceForReqs - prePrepareMsg->remainingSizeForRequests() < requiredBatchSizeInBytes))
     nextRequest = addRequestToPrePrepareMessage(nextRequest, *prePrepareMsg.get(), maxSpaceForReqs);
@@ -935,6 +970,7 @@ void ReplicaImp::startConsensusProcess(PrePrepareMsgShPtr &pp, bool isCreatedEar
       }
     }
   }
+  events_.record("PrePrepareSent", primaryLastUsedSeqNum, ppMsg->numberOfRequests());
 
   if (firstPath == CommitPath::SLOW) {
     startSlowPath(seqNumInfo);
@@ -1024,12 +1060,15 @@ bool ReplicaImp::validatePreProcessedResults(const PrePrepareMsg *msg, const Vie
       const MessageBase::Header *hdr = (MessageBase::Header *)requestBody;
       if (hdr->msgType == MsgCode::PreProcessResult) {
         tasks.push_back(threadPool.async(
-            [&errors, requestBody, error_id](auto replicaId, auto fVal) {
+            [&errors, requestBody, error_id](auto replicaId, auto fVal, auto thresholdSignEnabled, auto seqNum) {
               preprocessor::PreProcessResultMsg req((ClientRequestMsgHeader *)requestBody);
-              errors[error_id] = req.validatePreProcessResultSignatures(replicaId, fVal);
+              errors[error_id] = thresholdSignEnabled ? req.validatePreProcessResultCertificate(seqNum)
+                                                      : req.validatePreProcessResultSignatures(replicaId, fVal);
             },
             getReplicaConfig().replicaId,
-            getReplicaConfig().fVal));
+            getReplicaConfig().fVal,
+            getReplicaConfig().preExecutionResultThresholdSignEnabled,
+            msg->seqNumber()));
         error_id++;
       }
     }
@@ -1071,6 +1110,7 @@ void ReplicaImp::onMessage<PrePrepareMsg>(PrePrepareMsgUPtr msg) {
 
   metric_received_pre_prepares_++;
   const SeqNum msgSeqNum = message->seqNumber();
+  events_.record("PrePrepareReceived", msgSeqNum, message->senderId());
   SCOPED_MDC_PRIMARY(std::to_string(currentPrimary()));
   SCOPED_MDC_SEQ_NUM(std::to_string(msgSeqNum));
   LOG_INFO(CNSUS, "Received PrePrepareMsg" << KVLOG(message->senderId(), msgSeqNum, message->size()));
@@ -1918,6 +1958,7 @@ void ReplicaImp::onPrepareCombinedSigSucceeded(SeqNum seqNumber,
   SCOPED_MDC_SEQ_NUM(std::to_string(seqNumber));
   SCOPED_MDC_PATH(CommitPathToMDCString(CommitPath::SLOW));
   LOG_TRACE(THRESHSIGN_LOG, KVLOG(seqNumber, view, combinedSigLen));
+  events_.record("PrepareCollected", seqNumber, view);
 
   if (isCollectingState() && mainLog->insideActiveWindow(seqNumber)) {
     mainLog->get(seqNumber).resetPrepareSignatures();
@@ -2037,6 +2078,7 @@ void ReplicaImp::onCommitCombinedSigSucceeded(SeqNum seqNumber,
   SCOPED_MDC_SEQ_NUM(std::to_string(seqNumber));
   SCOPED_MDC_PATH(CommitPathToMDCString(CommitPath::SLOW));
   LOG_TRACE(THRESHSIGN_LOG, KVLOG(seqNumber, view, combinedSigLen));
+  events_.record("CommitCollected", seqNumber, view);
 
   if (isCollectingState() && mainLog->insideActiveWindow(seqNumber)) {
     mainLog->get(seqNumber).resetCommitSignatures(CommitPath::SLOW);
@@ -2146,6 +2188,7 @@ void ReplicaImp::onFastPathCommitCombinedSigSucceeded(SeqNum seqNumber,
   SCOPED_MDC_SEQ_NUM(std::to_string(seqNumber));
   SCOPED_MDC_PATH(CommitPathToMDCString(cPath));
   LOG_TRACE(THRESHSIGN_LOG, KVLOG(seqNumber, view, combinedSigLen));
+  events_.record("FastPathCommitCollected", seqNumber, view);
 
   if (isCollectingState() && mainLog->insideActiveWindow(seqNumber)) {
     mainLog->get(seqNumber).resetCommitSignatures(cPath);
@@ -3054,6 +3097,8 @@ void ReplicaImp::MoveToHigherView(ViewNum nextView) {
                newView, wasInPrevViewNumber, newPrimary, lastExecutedSeqNum, lastStableSeqNum));
 
   sendToAllOtherReplicas(pVC);
+  // Don't wait for the rest of the batch: the exit from the view is persisted and the view change message is sent now
+  flushDeferredMetadata();
 }
 
 void ReplicaImp::goToNextView() {
@@ -4328,6 +4373,7 @@ ReplicaImp::ReplicaImp(bool firstTime,
       batch_closed_on_logic_on_{metrics_.RegisterCounter("total_number_batch_closed_on_logic_on")},
       metric_indicator_of_non_determinism_{metrics_.RegisterCounter("indicator_of_non_determinism")},
       metric_total_committed_sn_{metrics_.RegisterCounter("total_committed_seqNum")},
+      metric_metadata_group_commits_{metrics_.RegisterCounter("metadataGroupCommits")},
       metric_total_slowPath_{metrics_.RegisterCounter("totalSlowPaths")},
       metric_total_slowPath_requests_{metrics_.RegisterCounter("totalSlowPathRequests")},
       metric_received_start_slow_commits_{metrics_.RegisterCounter("receivedStartSlowCommitMsgs")},
@@ -4580,6 +4626,8 @@ void ReplicaImp::stop() {
     timers_.cancel(viewChangeTimer_);
   }
   ReplicaForStateTransfer::stop();
+  // Messages that are still held are dropped, as the communication is stopped
+  commitDeferredMetadata();
   LOG_DEBUG(GL, "ReplicaImp::stop done");
 }
 
@@ -4645,6 +4693,8 @@ void ReplicaImp::start() {
   if (!firstTime_ || config_.getdebugPersistentStorageEnabled()) clientsManager->loadInfoFromReservedPages();
   addTimers();
   recoverRequests();
+  // From now on, metadata is committed once per batch of dispatched messages, see onMsgsBatchDone()
+  if (ps_ && config_.groupCommitMetadata) ps_->setDeferredCommits(true);
   // The following line will start the processing thread.
   // It must happen after the replica recovers requests in the main thread.
   msgsCommunicator_->startMsgsProcessing(config_.getreplicaId());
@@ -4821,6 +4871,7 @@ void ReplicaImp::startPrePrepareMsgExecution(PrePrepareMsg *ppMsg,
   ConcordAssertEQ(ppMsg->viewNumber(), getCurrentView());
 
   const uint16_t numOfRequests = ppMsg->numberOfRequests();
+  events_.record("ExecutionStarted", ppMsg->seqNumber(), numOfRequests);
 
   // recoverFromErrorInRequestsExecution ==> (numOfRequests > 0)
   ConcordAssertOR(!recoverFromErrorInRequestsExecution, (numOfRequests > 0));
@@ -4944,6 +4995,8 @@ void ReplicaImp::markSpecialRequests(RequestsIterator &reqIter,
     ps_->beginWriteTran();
     ps_->setDescriptorOfLastExecution(execDesc);
     ps_->endWriteTran(config_.getsyncOnUpdateOfMetadata());
+    // The descriptor is committed along with the deferred writes, send the messages that waited for them
+    flushDeferredMetadata();
   }
 }
 
@@ -5160,6 +5213,7 @@ void ReplicaImp::finishExecutePrePrepareMsg(PrePrepareMsg *ppMsg,
     delete pAccumulatedRequests;
   }
   LOG_INFO(CNSUS, "Finished execution of request seqNum:" << ppMsg->seqNumber());
+  events_.record("ExecutionFinished", ppMsg->seqNumber(), ppMsg->numberOfRequests());
   uint64_t checkpointNum{};
   if ((lastExecutedSeqNum + 1) % checkpointWindowSize == 0) {
     // Save the epoch to the reserved pages
@@ -5179,6 +5233,7 @@ void ReplicaImp::finishExecutePrePrepareMsg(PrePrepareMsg *ppMsg,
   if (ppMsg->numberOfRequests() > 0) bftRequestsHandler_->onFinishExecutingReadWriteRequests();
 
   if (ps_) ps_->endWriteTran(config_.getsyncOnUpdateOfMetadata());
+  recordExecutionPersisted(lastExecutedSeqNum);
 
   sendCheckpointIfNeeded();
 
@@ -5406,6 +5461,7 @@ void ReplicaImp::executeRequestsInPrePrepareMsg(concordUtils::SpanWrapper &paren
   ConcordAssertEQ(ppMsg->viewNumber(), getCurrentView());
   ConcordAssertEQ(ppMsg->seqNumber(), lastExecutedSeqNum + 1);
   const uint16_t numOfRequests = ppMsg->numberOfRequests();
+  events_.record("ExecutionStarted", ppMsg->seqNumber(), numOfRequests);
 
   // recoverFromErrorInRequestsExecution ==> (numOfRequests > 0)
   ConcordAssertOR(!recoverFromErrorInRequestsExecution, (numOfRequests > 0));
@@ -5465,6 +5521,8 @@ void ReplicaImp::executeRequestsInPrePrepareMsg(concordUtils::SpanWrapper &paren
         ps_->beginWriteTran();
         ps_->setDescriptorOfLastExecution(execDesc);
         ps_->endWriteTran(config_.getsyncOnUpdateOfMetadata());
+        // The descriptor is committed along with the deferred writes, send the messages that waited for them
+        flushDeferredMetadata();
       }
     } else {
       requestSet = mapOfRecoveredRequests;
@@ -5536,10 +5594,12 @@ void ReplicaImp::executeRequestsInPrePrepareMsg(concordUtils::SpanWrapper &paren
   }
 
   tryToMarkSeqNumAsStable();
+  events_.record("ExecutionFinished", lastExecutedSeqNum, numOfRequests);
 
   if (numOfRequests > 0) bftRequestsHandler_->onFinishExecutingReadWriteRequests();
 
   if (ps_) ps_->endWriteTran(config_.getsyncOnUpdateOfMetadata());
+  recordExecutionPersisted(lastExecutedSeqNum);
 
   sendCheckpointIfNeeded();
 
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <utility>
 
@@ -34,6 +35,7 @@
 #include "diagnostics.h"
 #include "performance_handler.h"
 #include "RequestsBatchingLogic.hpp"
+#include "FairRequestsQueue.hpp"
 #include "ReplicaStatusHandlers.hpp"
 #include "PerformanceManager.hpp"
 #include "secrets/secrets_manager_impl.h"
@@ -114,8 +116,12 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
   SeqNum maxSeqNumTransferredFromPrevViews = 0;
 
   // requests queue (used by the primary)
-  std::queue<std::unique_ptr<ClientRequestMsg>> requestsQueueOfPrimary;  // only used by the primary
-  size_t primaryCombinedReqSize = 0;                                     // only used by the primary
+  // Scheduled fairly across clients, see FairRequestsQueue
+  FairRequestsQueue<ClientRequestMsg> requestsQueueOfPrimary{
+      config_.getmaxExternalMessageSize(),
+      config_.maxPrimaryQueueRequestsPerClient,
+      config_.primaryQueueClientsWeights};  // only used by the primary
+  size_t primaryCombinedReqSize = 0;        // only used by the primary
 
   std::map<uint64_t, std::pair<Time, std::unique_ptr<ClientRequestMsg>>>
       requestsOfNonPrimary;  // used to retransmit client requests by a non primary replica
@@ -263,6 +269,8 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
   CounterHandle batch_closed_on_logic_on_;
   CounterHandle metric_indicator_of_non_determinism_;
   CounterHandle metric_total_committed_sn_;
+  /// Deferred metadata writes committed at once
+  CounterHandle metric_metadata_group_commits_;
   /// Executed slow consensuses
   CounterHandle metric_total_slowPath_;
   /// Inner requests in slow executions
@@ -448,6 +456,12 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
              shared_ptr<PersistentStorage> ps);
 
   void registerMsgHandlers();
+  // Commits the deferred metadata writes and sends the messages that waited for them
+  void onMsgsBatchDone();
+  void commitDeferredMetadata();
+  void flushDeferredMetadata();
+  // The ExecutionPersisted event is recorded once the writes of the execution are committed
+  void recordExecutionPersisted(SeqNum seqNum);
 
   template <typename T>
   void messageHandler(std::unique_ptr<MessageBase> msg);
@@ -456,6 +470,8 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
   void validatedMessageHandler(CarrierMesssage* msg);
 
   void send(MessageBase*, NodeIdType) override;
+  // Messages may depend on metadata that is not committed yet
+  bool holdOutgoingMsgs() const override { return ps_ && ps_->hasDeferredWrites(); }
   void sendAndIncrementMetric(MessageBase*, NodeIdType, CounterHandle&);
 
   bool tryToEnterView();
@@ -753,6 +769,11 @@ class ReplicaImp : public InternalReplicaApi, public ReplicaForStateTransfer {
 
   Recorders histograms_;
 
+  // Per sequence number timeline of the consensus and execution events, dumped by the diagnostics server
+  concord::diagnostics::FlightRecorder& events_ = concord::diagnostics::RegistrarSingleton::getInstance().events;
+  // The last executed seqNum whose writes are deferred, 0 if none
+  std::atomic<SeqNum> pendingExecutionPersisted_{0};
+
   // Used to measure the time for each consensus slot to go from pre-prepare to commit at the primary.
   // Time is recorded in histograms_.consensus
   concord::diagnostics::AsyncTimeRecorderMap<SeqNum> consensus_times_;
@@ -434,6 +434,7 @@ PreProcessor::PreProcessor(shared_ptr<MsgsCommunicator> &msgsCommunicator,
                            metricsComponent_.RegisterCounter("preProcPossiblePrimaryFaultDetected"),
                            metricsComponent_.RegisterCounter("preProcReqCompleted"),
                            metricsComponent_.RegisterCounter("preProcReqRetried"),
+                           metricsComponent_.RegisterCounter("preProcResultCertificateFailed"),
                            metricsComponent_.RegisterAtomicGauge("preProcessingTimeAvg", 0),
                            metricsComponent_.RegisterAtomicGauge("launchAsyncPreProcessJobTimeAvg", 0),
                            metricsComponent_.RegisterAtomicGauge("PreProcInFlyRequestsNum", 0)},
@@ -1456,8 +1457,22 @@ void PreProcessor::finalizePreProcessing(NodeIdType clientId, uint16_t reqOffset
       preProcessResult = static_cast<uint32_t>(OperationResult::UNKNOWN);
     }
     if (ReplicaConfig::instance().preExecutionResultAuthEnabled) {
-      const auto &sigsSet = reqProcessingStatePtr->getPreProcessResultSignatures();
-      auto sigsBuf = PreProcessResultSignature::serializeResultSignatures(sigsSet, numOfRequiredReplies());
+      std::string sigsBuf;
+      if (ReplicaConfig::instance().preExecutionResultThresholdSignEnabled) {
+        const auto certificate = reqProcessingStatePtr->getPreProcessResultCertificate();
+        if (!certificate) {
+          LOG_WARN(logger(),
+                   "Failed to combine pre-execution result signature shares; cancel request"
+                       << KVLOG(batchCid, reqSeqNum, reqCid, clientId, reqOffsetInBatch));
+          preProcessorMetrics_.preProcResultCertificateFailed++;
+          cancelPreProcessing(clientId, batchCid, reqOffsetInBatch);
+          return;
+        }
+        sigsBuf = certificate->serialize();
+      } else {
+        const auto &sigsSet = reqProcessingStatePtr->getPreProcessResultSignatures();
+        sigsBuf = PreProcessResultSignature::serializeResultSignatures(sigsSet, numOfRequiredReplies());
+      }
       preProcessMsg = make_unique<PreProcessResultMsg>(clientId,
                                                        preProcessResult,
                                                        reqSeqNum,
@@ -366,6 +366,7 @@ class PreProcessor : public bftEngine::IExternalObject {
     concordMetrics::CounterHandle preProcPossiblePrimaryFaultDetected;
     concordMetrics::CounterHandle preProcReqCompleted;
     concordMetrics::CounterHandle preProcReqRetried;
+    concordMetrics::CounterHandle preProcResultCertificateFailed;
     concordMetrics::AtomicGaugeHandle preProcessingTimeAvg;
     concordMetrics::AtomicGaugeHandle launchAsyncPreProcessJobTimeAvg;
     concordMetrics::AtomicGaugeHandle preProcInFlyRequestsNum;
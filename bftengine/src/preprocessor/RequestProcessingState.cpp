@@ -12,6 +12,7 @@
 #include "RequestProcessingState.hpp"
 #include "sparse_merkle/base_types.h"
 #include "SigManager.hpp"
+#include "ReplicaConfig.hpp"
 #include "TimeUtils.hpp"
 #include "messages/PreProcessResultHashCreator.hpp"
 
@@ -104,9 +105,7 @@ void RequestProcessingState::handlePrimaryPreProcessed(const char *preProcessRes
   // In case the pre-processing failed on the primary replica, fill primaryPreProcessResultData_ by the result-related
   // information.
   if (preProcessResult != OperationResult::SUCCESS) setupPreProcessResultData(preProcessResult);
-  auto sm = SigManager::instance();
-  std::vector<uint8_t> sig(sm->getMySigLength());
-  sm->sign(primaryPreProcessResultHash_.data(), primaryPreProcessResultHash_.size(), sig.data());
+  auto sig = signPrimaryPreProcessResultHash();
   if (!preProcessingResultHashes_[primaryPreProcessResultHash_]
            .emplace(std::move(sig), myReplicaId_, preProcessResult)
            .second) {
@@ -118,6 +117,16 @@ void RequestProcessingState::handlePrimaryPreProcessed(const char *preProcessRes
   numOfReceivedReplies_++;
 }
 
+std::vector<uint8_t> RequestProcessingState::signPrimaryPreProcessResultHash() const {
+  if (ReplicaConfig::instance().preExecutionResultThresholdSignEnabled) {
+    return PreProcessResultCertificate::signShare(primaryPreProcessResultHash_);
+  }
+  auto sm = SigManager::instance();
+  std::vector<uint8_t> sig(sm->getMySigLength());
+  sm->sign(primaryPreProcessResultHash_.data(), primaryPreProcessResultHash_.size(), sig.data());
+  return sig;
+}
+
 void RequestProcessingState::releaseResources() {
   clientPreProcessReqMsg_.reset();
   preProcessRequestMsg_.reset();
@@ -150,8 +159,11 @@ void RequestProcessingState::handlePreProcessReplyMsg(const PreProcessReplyMsgSh
     const auto &newHashArray = convertToArray(preProcessReplyMsg->resultsHash());
     // Counts equal hashes and saves the signatures with the replica ID. They will be used as a proof that the primary
     // is sending correct pre-execution result to the rest of the replicas.
+    auto signature = ReplicaConfig::instance().preExecutionResultThresholdSignEnabled
+                         ? preProcessReplyMsg->getResultHashThresholdSigShare()
+                         : preProcessReplyMsg->getResultHashSignature();
     if (!preProcessingResultHashes_[newHashArray]
-             .emplace(preProcessReplyMsg->getResultHashSignature(),
+             .emplace(std::move(signature),
                       preProcessReplyMsg->senderId(),
                       preProcessReplyMsg->preProcessResult())
              .second) {
@@ -229,9 +241,7 @@ void RequestProcessingState::modifyPrimaryResult(
     const std::pair<std::string, concord::crypto::SHA3_256::Digest> &result) {
   memcpy(const_cast<char *>(primaryPreProcessResultData_), result.first.c_str(), primaryPreProcessResultLen_);
   primaryPreProcessResultHash_ = result.second;
-  auto sm = SigManager::instance();
-  std::vector<uint8_t> sig(sm->getMySigLength());
-  sm->sign(primaryPreProcessResultHash_.data(), primaryPreProcessResultHash_.size(), sig.data());
+  auto sig = signPrimaryPreProcessResultHash();
   if (!preProcessingResultHashes_[primaryPreProcessResultHash_]
            .emplace(std::move(sig), myReplicaId_, primaryPreProcessResult_)
            .second) {
@@ -323,6 +333,11 @@ unique_ptr<MessageBase> RequestProcessingState::buildClientRequestMsg(bool empty
   return clientPreProcessReqMsg_->convertToClientRequestMsg(emptyReq);
 }
 
+std::optional<PreProcessResultCertificate> RequestProcessingState::getPreProcessResultCertificate() {
+  return PreProcessResultCertificate::combine(
+      getPreProcessResultSignatures(), primaryPreProcessResultHash_, numOfRequiredEqualReplies_);
+}
+
 const std::set<PreProcessResultSignature> &RequestProcessingState::getPreProcessResultSignatures() {
   const auto &r = preProcessingResultHashes_.find(primaryPreProcessResultHash_);
   if (r != preProcessingResultHashes_.end()) return r->second;
@@ -80,6 +80,8 @@ class RequestProcessingState {
   void resetRejectedReplicasList() { rejectedReplicaIds_.clear(); }
   void setPreprocessingRightNow(bool set) { preprocessingRightNow_ = set; }
   const std::set<PreProcessResultSignature>& getPreProcessResultSignatures();
+  // Combine the threshold signature shares of the primary replica result, if preExecutionResultThresholdSignEnabled
+  std::optional<PreProcessResultCertificate> getPreProcessResultCertificate();
   const concord::crypto::SHA3_256::Digest& getResultHash() { return primaryPreProcessResultHash_; };
   const bftEngine::OperationResult getAgreedPreProcessResult() const { return agreedPreProcessResult_; }
 
@@ -101,6 +103,8 @@ class RequestProcessingState {
   void updatePreProcessResultData(bftEngine::OperationResult preProcessResult);
   uint32_t sizeOfPreProcessResultData() const;
   void reportNonEqualHashes(const unsigned char* chosenData, uint32_t chosenSize) const;
+  // Sign primaryPreProcessResultHash_ by a replica signature or a threshold signature share
+  std::vector<uint8_t> signPrimaryPreProcessResultHash() const;
 
   // Detect if a hash is different from the input parameter because of the appended block id.
   std::pair<std::string, concord::crypto::SHA3_256::Digest> detectFailureDueToBlockID(
@@ -11,6 +11,8 @@
 
 #include "PreProcessBatchReplyMsg.hpp"
 #include "SigManager.hpp"
+#include "ReplicaConfig.hpp"
+#include "CryptoManager.hpp"
 #include "util/assertUtils.hpp"
 
 namespace preprocessor {
@@ -43,7 +45,8 @@ PreProcessBatchReplyMsg::PreProcessBatchReplyMsg(uint16_t clientId,
 }
 
 void PreProcessBatchReplyMsg::validate(const ReplicasInfo& repInfo) const {
-  if (size() < sizeof(Header) || size() < (sizeof(Header) + msgBody()->repliesSize))
+  if (size() < sizeof(Header) ||
+      size() < (sizeof(Header) + uint64_t{msgBody()->cidLength} + uint64_t{msgBody()->repliesSize}))
     throw std::runtime_error(__PRETTY_FUNCTION__);
 
   if (type() != MsgCode::PreProcessBatchReply) {
@@ -66,6 +69,42 @@ void PreProcessBatchReplyMsg::validate(const ReplicasInfo& repInfo) const {
     LOG_WARN(logger(), "Too many messages in the batch" << KVLOG(numOfMessagesInBatch, msgBody()->senderId, getCid()));
     throw std::runtime_error(__PRETTY_FUNCTION__);
   }
+
+  if (!checkElements()) {
+    LOG_WARN(logger(), "One or more replies in the batch are invalid" << KVLOG(msgBody()->senderId, getCid()));
+    throw std::runtime_error(__PRETTY_FUNCTION__);
+  }
+}
+
+// Each reply carries exactly the sender's signature, followed by a threshold share when threshold signing is on;
+// anything else would overflow the PreProcessReplyMsg rebuilt from it in getPreProcessReplyMsgs().
+bool PreProcessBatchReplyMsg::checkElements() const {
+  const auto& senderId = msgBody()->senderId;
+  uint64_t expectedReplyLen = SigManager::instance()->getSigLength(senderId);
+  if (ReplicaConfig::instance().preExecutionResultThresholdSignEnabled)
+    expectedReplyLen += CryptoManager::instance().thresholdSignerForPreExecution()->requiredLengthForSignedData();
+  const uint64_t maxReplyMsgSize = PreProcessReplyMsg::maxReplyMsgSize();
+  const uint64_t headerSize = sizeof(PreProcessReplyMsg::Header);
+  const uint64_t batchOffset = sizeof(Header) + msgBody()->cidLength;
+  uint64_t remaining = size() - batchOffset;
+  const char* dataPosition = body() + batchOffset;
+  for (uint32_t i = 0; i < msgBody()->numOfMessagesInBatch; i++) {
+    if (remaining < headerSize) {
+      LOG_WARN(logger(), "Truncated reply header" << KVLOG(senderId, i, remaining));
+      return false;
+    }
+    const auto& singleMsgHeader = *(const PreProcessReplyMsg::Header*)dataPosition;
+    const uint64_t replyLen = singleMsgHeader.replyLength;
+    const uint64_t singleMsgSize = headerSize + replyLen + singleMsgHeader.cidLength;
+    if (replyLen != expectedReplyLen || singleMsgSize > remaining || singleMsgSize > maxReplyMsgSize) {
+      LOG_WARN(logger(),
+               KVLOG(senderId, i, replyLen, expectedReplyLen, singleMsgHeader.cidLength, remaining, maxReplyMsgSize));
+      return false;
+    }
+    dataPosition += singleMsgSize;
+    remaining -= singleMsgSize;
+  }
+  return true;
 }
 
 void PreProcessBatchReplyMsg::setParams(
@@ -81,16 +120,19 @@ std::string PreProcessBatchReplyMsg::getCid() const { return string(body() + siz
 
 PreProcessReplyMsgsList& PreProcessBatchReplyMsg::getPreProcessReplyMsgs() {
   if (!preProcessReplyMsgsList_.empty()) return preProcessReplyMsgsList_;
+  // Never rebuild replies from a batch that has not passed the element checks done by validate()
+  if (!checkElements()) return preProcessReplyMsgsList_;
 
   const auto& numOfMessagesInBatch = msgBody()->numOfMessagesInBatch;
   const string& batchCid = getCid();
   const auto& clientId = msgBody()->clientId;
   const auto& senderId = msgBody()->senderId;
-  const auto sigLen = SigManager::instance()->getSigLength(msgBody()->senderId);
   char* dataPosition = body() + sizeof(Header) + msgBody()->cidLength;
   for (uint32_t i = 0; i < numOfMessagesInBatch; i++) {
     const auto& singleMsgHeader = *(PreProcessReplyMsg::Header*)dataPosition;
     const auto& reqSeqNum = singleMsgHeader.reqSeqNum;
+    // The signature may be followed by a threshold signature share, replyLength covers both
+    const auto sigLen = singleMsgHeader.replyLength;
     const char* sigPosition = dataPosition + sizeof(PreProcessReplyMsg::Header);
     const char* cidPosition = sigPosition + sigLen;
     const string cid(cidPosition, singleMsgHeader.cidLength);
@@ -102,6 +144,7 @@ PreProcessReplyMsgsList& PreProcessBatchReplyMsg::getPreProcessReplyMsgs() {
                                                       singleMsgHeader.reqRetryId,
                                                       (const uint8_t*)&singleMsgHeader.resultsHash,
                                                       sigPosition,
+                                                      sigLen,
                                                       cid,
                                                       singleMsgHeader.status,
                                                       singleMsgHeader.preProcessResult,
@@ -60,6 +60,7 @@ class PreProcessBatchReplyMsg : public MessageBase {
   void setParams(
       NodeIdType senderId, uint16_t clientId, uint32_t numOfMessagesInBatch, uint32_t repliesSize, ViewNum viewNum);
   Header* msgBody() const { return ((Header*)msgBody_); }
+  bool checkElements() const;
 
  private:
   std::string cid_;
@@ -10,7 +10,9 @@
 // file.
 
 #include "PreProcessReplyMsg.hpp"
+#include "PreProcessResultMsg.hpp"
 #include "ReplicaConfig.hpp"
+#include "CryptoManager.hpp"
 #include "util/assertUtils.hpp"
 #include "SigManager.hpp"
 
@@ -24,6 +26,12 @@ using namespace bftEngine::impl;
 // maxReplyMsgSize_ = sizeof(Header) + sizeof(signature) + reqCid.size(), i.e 58 + 256 + up to 710 bytes of reqCid
 uint16_t PreProcessReplyMsg::maxReplyMsgSize_ = 1024;
 
+uint32_t PreProcessReplyMsg::maxReplyMsgSize() {
+  if (!ReplicaConfig::instance().preExecutionResultThresholdSignEnabled) return maxReplyMsgSize_;
+  // Leave room for the threshold signature share
+  return maxReplyMsgSize_ + CryptoManager::instance().thresholdSignerForPreExecution()->requiredLengthForSignedData();
+}
+
 PreProcessReplyMsg::PreProcessReplyMsg(NodeIdType senderId,
                                        uint16_t clientId,
                                        uint16_t reqOffsetInBatch,
@@ -35,7 +43,7 @@ PreProcessReplyMsg::PreProcessReplyMsg(NodeIdType senderId,
                                        ReplyStatus status,
                                        OperationResult preProcessResult,
                                        ViewNum viewNum)
-    : MessageBase(senderId, MsgCode::PreProcessReply, 0, maxReplyMsgSize_) {
+    : MessageBase(senderId, MsgCode::PreProcessReply, 0, maxReplyMsgSize()) {
   setParams(senderId, clientId, reqOffsetInBatch, reqSeqNum, reqRetryId, status, preProcessResult, viewNum);
   setupMsgBody(preProcessResultBuf, preProcessResultBufLen, reqCid);
 }
@@ -48,13 +56,14 @@ PreProcessReplyMsg::PreProcessReplyMsg(NodeIdType senderId,
                                        uint64_t reqRetryId,
                                        const uint8_t* resultsHash,
                                        const char* signature,
+                                       uint32_t signatureLen,
                                        const std::string& reqCid,
                                        ReplyStatus status,
                                        OperationResult preProcessResult,
                                        ViewNum viewNum)
-    : MessageBase(senderId, MsgCode::PreProcessReply, 0, maxReplyMsgSize_) {
+    : MessageBase(senderId, MsgCode::PreProcessReply, 0, maxReplyMsgSize()) {
   setParams(senderId, clientId, reqOffsetInBatch, reqSeqNum, reqRetryId, status, preProcessResult, viewNum);
-  setupMsgBody(resultsHash, signature, reqCid);
+  setupMsgBody(resultsHash, signature, signatureLen, reqCid);
 }
 
 void PreProcessReplyMsg::validate(const ReplicasInfo& repInfo) const {
@@ -100,6 +109,15 @@ std::vector<uint8_t> PreProcessReplyMsg::getResultHashSignature() const {
   return std::vector<uint8_t>((uint8_t*)msgBody() + headerSize, (uint8_t*)msgBody() + headerSize + sigLen);
 }
 
+std::vector<uint8_t> PreProcessReplyMsg::getResultHashThresholdSigShare() const {
+  const uint64_t headerSize = sizeof(Header);
+  const auto& msgHeader = *msgBody();
+  const uint32_t sigLen = SigManager::instance()->getSigLength(msgHeader.senderId);
+  if (msgHeader.replyLength <= sigLen) return {};
+  const auto* sharePos = (uint8_t*)msgBody() + headerSize + sigLen;
+  return std::vector<uint8_t>(sharePos, sharePos + (msgHeader.replyLength - sigLen));
+}
+
 void PreProcessReplyMsg::setParams(NodeIdType senderId,
                                    uint16_t clientId,
                                    uint16_t reqOffsetInBatch,
@@ -120,7 +138,7 @@ void PreProcessReplyMsg::setParams(NodeIdType senderId,
             KVLOG(senderId, clientId, reqSeqNum, reqRetryId, status, static_cast<uint32_t>(preProcessResult)));
 }
 
-void PreProcessReplyMsg::setLeftMsgParams(const string& reqCid, uint16_t sigSize) {
+void PreProcessReplyMsg::setLeftMsgParams(const string& reqCid, uint32_t sigSize) {
   const uint16_t headerSize = sizeof(Header);
   msgBody()->cidLength = reqCid.size();
   memcpy(body() + headerSize + sigSize, reqCid.c_str(), reqCid.size());
@@ -142,7 +160,7 @@ void PreProcessReplyMsg::setLeftMsgParams(const string& reqCid, uint16_t sigSize
 void PreProcessReplyMsg::setupMsgBody(const char* preProcessResultBuf,
                                       uint32_t preProcessResultBufLen,
                                       const string& reqCid) {
-  uint16_t sigSize = 0;
+  uint32_t sigSize = 0;
   auto sigManager = SigManager::instance();
   sigSize = sigManager->getMySigLength();
   // Calculate pre-process result hash
@@ -158,15 +176,22 @@ void PreProcessReplyMsg::setupMsgBody(const char* preProcessResultBuf,
                      concord::crypto::SHA3_256::SIZE_IN_BYTES,
                      reinterpret_cast<concord::Byte*>(body() + sizeof(Header)));
   }
+  if (ReplicaConfig::instance().preExecutionResultThresholdSignEnabled) {
+    const auto share = PreProcessResultCertificate::signShare(hash);
+    memcpy(body() + sizeof(Header) + sigSize, share.data(), share.size());
+    sigSize += share.size();
+  }
   setLeftMsgParams(reqCid, sigSize);
 }
 
 // Used by PreProcessBatchReplyMsg while retrieving PreProcessReplyMsgs from the batch
-void PreProcessReplyMsg::setupMsgBody(const uint8_t* resultsHash, const char* signature, const string& reqCid) {
+void PreProcessReplyMsg::setupMsgBody(const uint8_t* resultsHash,
+                                      const char* signature,
+                                      uint32_t signatureLen,
+                                      const string& reqCid) {
   memcpy(msgBody()->resultsHash, resultsHash, concord::crypto::SHA3_256::SIZE_IN_BYTES);
-  const uint16_t sigLen = SigManager::instance()->getMySigLength();
-  memcpy(body() + sizeof(Header), signature, sigLen);
-  setLeftMsgParams(reqCid, sigLen);
+  memcpy(body() + sizeof(Header), signature, signatureLen);
+  setLeftMsgParams(reqCid, signatureLen);
 }
 
 std::string PreProcessReplyMsg::getCid() const {
@@ -41,6 +41,7 @@ class PreProcessReplyMsg : public MessageBase {
                      uint64_t reqRetryId,
                      const uint8_t* resultsHash,
                      const char* signature,
+                     uint32_t signatureLen,
                      const std::string& reqCid,
                      ReplyStatus status,
                      bftEngine::OperationResult preProcessResult,
@@ -59,6 +60,7 @@ class PreProcessReplyMsg : public MessageBase {
   const bftEngine::OperationResult preProcessResult() const { return msgBody()->preProcessResult; }
   const ViewNum viewNum() const { return msgBody()->viewNum; }
   std::vector<uint8_t> getResultHashSignature() const;
+  std::vector<uint8_t> getResultHashThresholdSigShare() const;
   std::string getCid() const;
 
   static void setPreProcessorHistograms(preprocessor::PreProcessorRecorder* histograms) {
@@ -81,7 +83,8 @@ class PreProcessReplyMsg : public MessageBase {
     uint64_t reqRetryId = 0;
     ViewNum viewNum;
   };
-// The pre-executed results' hash signature resides in the message body
+// The pre-executed results' hash signature resides in the message body. It is followed by a threshold signature share
+// of the hash if ReplicaConfig::preExecutionResultThresholdSignEnabled is set. replyLength is the length of both.
 #pragma pack(pop)
 
  protected:
@@ -102,8 +105,12 @@ class PreProcessReplyMsg : public MessageBase {
                  bftEngine::OperationResult preProcessResult,
                  ViewNum viewNum);
   void setupMsgBody(const char* preProcessResultBuf, uint32_t preProcessResultBufLen, const std::string& reqCid);
-  void setupMsgBody(const uint8_t* resultsHash, const char* signature, const std::string& reqCid);
-  void setLeftMsgParams(const std::string& cid, uint16_t sigSize);
+  void setupMsgBody(const uint8_t* resultsHash,
+                    const char* signature,
+                    uint32_t signatureLen,
+                    const std::string& reqCid);
+  void setLeftMsgParams(const std::string& cid, uint32_t sigSize);
+  static uint32_t maxReplyMsgSize();
 
   Header* msgBody() const { return ((Header*)msgBody_); }
 
@@ -12,6 +12,7 @@
 #include "PreProcessResultMsg.hpp"
 #include "Replica.hpp"  // for HAS_PRE_PROCESSED_FLAG
 #include "SigManager.hpp"
+#include "CryptoManager.hpp"
 #include "PreProcessResultHashCreator.hpp"
 #include "util/endianness.hpp"
 
@@ -99,6 +100,37 @@ std::optional<std::string> PreProcessResultMsg::validatePreProcessResultSignatur
   return {};
 }
 
+std::optional<std::string> PreProcessResultMsg::validatePreProcessResultCertificate(SeqNum seqNum) {
+  const auto [buf, buf_len] = getResultSignaturesBuf();
+  std::stringstream err;
+  PreProcessResultCertificate certificate;
+  try {
+    certificate = PreProcessResultCertificate::deserialize(buf, buf_len);
+  } catch (const std::runtime_error& e) {
+    err << "PreProcessResult certificate validation failure - " << e.what()
+        << KVLOG(clientProxyId(), getCid(), requestSeqNum());
+    return err.str();
+  }
+
+  const auto hash = PreProcessResultHashCreator::create(
+      requestBuf(), requestLength(), certificate.pre_process_result, clientProxyId(), requestSeqNum());
+  const auto verify = [&](const IThresholdVerifier& verifier) {
+    return verifier.verify(reinterpret_cast<const char*>(hash.data()),
+                           hash.size(),
+                           reinterpret_cast<const char*>(certificate.threshold_signature.data()),
+                           certificate.threshold_signature.size());
+  };
+  const auto& cryptoManager = CryptoManager::instance();
+  const auto latestVerifier = cryptoManager.thresholdVerifierForPreExecution();
+  const auto verifier = cryptoManager.thresholdVerifierForPreExecution(seqNum);
+  if (!verify(*latestVerifier) && (verifier == latestVerifier || !verify(*verifier))) {
+    err << "PreProcessResult certificate validation failure - invalid threshold signature"
+        << KVLOG(clientProxyId(), getCid(), requestSeqNum(), seqNum);
+    return err.str();
+  }
+  return {};
+}
+
 std::string PreProcessResultSignature::serializeResultSignatures(const std::set<PreProcessResultSignature>& signatures,
                                                                  const uint16_t numOfRequiredSignatures) {
   size_t buf_len = 0;
@@ -158,4 +190,72 @@ std::set<PreProcessResultSignature> PreProcessResultSignature::deserializeResult
   return ret;
 }
 
-}  // namespace preprocessor
\ No newline at end of file
+std::vector<concord::Byte> PreProcessResultCertificate::signShare(const concord::crypto::SHA3_256::Digest& hash) {
+  auto signer = CryptoManager::instance().thresholdSignerForPreExecution();
+  std::vector<concord::Byte> share(signer->requiredLengthForSignedData());
+  signer->signData(
+      reinterpret_cast<const char*>(hash.data()), hash.size(), reinterpret_cast<char*>(share.data()), share.size());
+  return share;
+}
+
+std::optional<PreProcessResultCertificate> PreProcessResultCertificate::combine(
+    const std::set<PreProcessResultSignature>& shares,
+    const concord::crypto::SHA3_256::Digest& hash,
+    uint16_t numOfRequiredShares) {
+  if (shares.size() < numOfRequiredShares) return std::nullopt;
+  const auto& cryptoManager = CryptoManager::instance();
+  const auto verifier = cryptoManager.thresholdVerifierForPreExecution();
+  // All the replicas use the same scheme, a share of a different length is malformed
+  const auto shareLen = cryptoManager.thresholdSignerForPreExecution()->requiredLengthForSignedData();
+  const auto result = shares.begin()->pre_process_result;
+  const auto* digest = reinterpret_cast<const unsigned char*>(hash.data());
+  std::vector<char> buf(verifier->requiredLengthForSignedData());
+
+  const auto accumulate = [&](const auto& isValid) -> std::optional<PreProcessResultCertificate> {
+    std::unique_ptr<IThresholdAccumulator> acc{verifier->newAccumulator(false)};
+    acc->setExpectedDigest(digest, hash.size());
+    int numOfShares = 0;
+    for (const auto& s : shares) {
+      if (static_cast<int>(s.signature.size()) != shareLen || s.pre_process_result != result || !isValid(s)) continue;
+      numOfShares = acc->add(reinterpret_cast<const char*>(s.signature.data()), s.signature.size());
+      if (numOfShares == numOfRequiredShares) break;
+    }
+    if (numOfShares < numOfRequiredShares) return std::nullopt;
+    const auto len = acc->getFullSignedData(buf.data(), buf.size());
+    if (!verifier->verify(reinterpret_cast<const char*>(hash.data()), hash.size(), buf.data(), len)) {
+      return std::nullopt;
+    }
+    return PreProcessResultCertificate{result, std::vector<concord::Byte>(buf.begin(), buf.begin() + len)};
+  };
+
+  // Optimistically, don't use share verification
+  if (auto certificate = accumulate([](const PreProcessResultSignature&) { return true; })) return certificate;
+
+  // Some shares are invalid, combine the valid ones only
+  return accumulate([&](const PreProcessResultSignature& s) {
+    std::unique_ptr<IThresholdAccumulator> acc{verifier->newAccumulator(true)};
+    acc->setExpectedDigest(digest, hash.size());
+    acc->add(reinterpret_cast<const char*>(s.signature.data()), s.signature.size());
+    return acc->getNumValidShares() == 1;
+  });
+}
+
+std::string PreProcessResultCertificate::serialize() const {
+  std::string output;
+  output.reserve(sizeof(uint32_t) + threshold_signature.size());
+  output.append(concordUtils::toBigEndianStringBuffer(static_cast<uint32_t>(pre_process_result)));
+  output.append(threshold_signature.begin(), threshold_signature.end());
+  return output;
+}
+
+PreProcessResultCertificate PreProcessResultCertificate::deserialize(const char* buf, size_t len) {
+  if (len <= sizeof(uint32_t)) {
+    throw std::runtime_error("Deserialization error - buffer length is less than the certificate size");
+  }
+  PreProcessResultCertificate certificate;
+  certificate.pre_process_result = static_cast<OperationResult>(concordUtils::fromBigEndianBuffer<uint32_t>(buf));
+  certificate.threshold_signature.assign(buf + sizeof(uint32_t), buf + len);
+  return certificate;
+}
+
+}  // namespace preprocessor
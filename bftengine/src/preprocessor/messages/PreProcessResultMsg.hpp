@@ -14,7 +14,9 @@
 #include "util/types.hpp"
 #include "messages/ClientRequestMsg.hpp"
 #include "SharedTypes.hpp"
+#include "crypto/digest.hpp"
 #include <list>
+#include <optional>
 
 namespace preprocessor {
 
@@ -58,6 +60,9 @@ class PreProcessResultMsg : public ClientRequestMsg {
 
   std::pair<char*, uint32_t> getResultSignaturesBuf();
   ErrorMessage validatePreProcessResultSignatures(ReplicaId myReplicaId, int16_t fVal);
+  // Used instead of validatePreProcessResultSignatures() if ReplicaConfig::preExecutionResultThresholdSignEnabled is
+  // set. seqNum is the sequence number of the PrePrepare carrying this message.
+  ErrorMessage validatePreProcessResultCertificate(SeqNum seqNum);
 };
 
 struct PreProcessResultSignature {
@@ -84,4 +89,26 @@ struct PreProcessResultSignature {
   static std::set<PreProcessResultSignature> deserializeResultSignatures(const char* buf, size_t len);
 };
 
+// A single threshold signature on the pre-execution result hash, combined by the primary from the signature shares of
+// fVal+1 replicas that agreed on the result. It replaces the set of PreProcessResultSignature, so a PreProcessResultMsg
+// carries one certificate that is verified at once, rather than fVal+1 signatures that are verified one by one.
+//
+// In this mode PreProcessResultSignature::signature holds the replica's threshold signature share.
+struct PreProcessResultCertificate {
+  bftEngine::OperationResult pre_process_result;
+  std::vector<concord::Byte> threshold_signature;
+
+  // Sign the hash with the pre-execution threshold signer of this replica
+  static std::vector<concord::Byte> signShare(const concord::crypto::SHA3_256::Digest& hash);
+
+  // Combine the first numOfRequiredShares valid shares. Invalid shares are only looked for if the optimistic
+  // combination fails. Returns std::nullopt if there are not enough valid shares.
+  static std::optional<PreProcessResultCertificate> combine(const std::set<PreProcessResultSignature>& shares,
+                                                            const concord::crypto::SHA3_256::Digest& hash,
+                                                            uint16_t numOfRequiredShares);
+
+  std::string serialize() const;
+  static PreProcessResultCertificate deserialize(const char* buf, size_t len);
+};
+
 }  // namespace preprocessor
@@ -115,4 +115,41 @@ TEST_F(PreProcessReplyMsgTestFixture, getResultHashSignature) {
   clearDiagnosticsHandlers();
 }
 
+TEST_F(PreProcessReplyMsgTestFixture, getResultHashThresholdSigShare) {
+  ASSERT_TRUE(sigManager);
+  config.preExecutionResultThresholdSignEnabled = true;
+  const NodeIdType senderId = 1;
+  const uint16_t clientId = 1;
+  const uint64_t reqSeqNum = 100;
+  const char preProcessResultBuf[] = "request body";
+  const uint32_t preProcessResultBufLen = sizeof(preProcessResultBuf);
+  const std::string& cid = "abcdef1";
+  const OperationResult opResult = OperationResult::SUCCESS;
+  ViewNum viewNum = 1;
+  auto preProcessReplyMsg = PreProcessReplyMsg(senderId,
+                                               clientId,
+                                               0,
+                                               reqSeqNum,
+                                               0,
+                                               preProcessResultBuf,
+                                               preProcessResultBufLen,
+                                               cid,
+                                               STATUS_GOOD,
+                                               opResult,
+                                               viewNum);
+  config.preExecutionResultThresholdSignEnabled = false;
+  const auto hash =
+      PreProcessResultHashCreator::create(preProcessResultBuf, preProcessResultBufLen, opResult, clientId, reqSeqNum);
+  auto expected_signature = std::vector<concord::Byte>(sigManager->getMySigLength());
+  sigManager->sign(hash.data(), sizeof(hash), expected_signature.data());
+  EXPECT_THAT(expected_signature, testing::ContainerEq(preProcessReplyMsg.getResultHashSignature()));
+  // The share of the dummy threshold signer follows the signature
+  const auto share = preProcessReplyMsg.getResultHashThresholdSigShare();
+  auto signer = CryptoManager::instance().thresholdSignerForPreExecution();
+  EXPECT_EQ(share.size(), static_cast<size_t>(signer->requiredLengthForSignedData()));
+  EXPECT_EQ(share, std::vector<concord::Byte>(share.size(), 'S'));
+  EXPECT_EQ(cid, preProcessReplyMsg.getCid());
+  clearDiagnosticsHandlers();
+}
+
 }  // namespace
@@ -0,0 +1,166 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the sub-component's license, as noted in the LICENSE
+// file.
+
+#include <gtest/gtest.h>
+#include "messages/PreProcessResultMsg.hpp"
+#include "messages/PreProcessResultHashCreator.hpp"
+#include "CryptoManager.hpp"
+#include "ReplicaConfig.hpp"
+
+// Tests of PreProcessResultCertificate with real EdDSA multisig shares. The CryptoManager is a singleton, and the
+// other message tests initialize it with a dummy cryptosystem, hence the separate executable.
+
+namespace {
+using namespace bftEngine;
+using namespace preprocessor;
+
+constexpr uint16_t kFVal = 1;
+constexpr uint16_t kNumReplicas = 3 * kFVal + 1;
+constexpr uint16_t kNumRequiredShares = kFVal + 1;
+
+class PreProcessResultCertificateTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    auto& config = ReplicaConfig::instance();
+    config.numReplicas = kNumReplicas;
+    config.fVal = kFVal;
+    config.cVal = 0;
+    config.replicaId = 0;
+
+    Cryptosystem cryptosystem{MULTISIG_EDDSA_SCHEME, "", kNumReplicas, kNumReplicas};
+    cryptosystem.generateNewPseudorandomKeys();
+    const auto privateKeys = cryptosystem.getSystemPrivateKeys();
+    // Signer ids are 1-indexed, i.e. replica i signs with private key i + 1
+    for (uint16_t i = 0; i < kNumReplicas; ++i) {
+      Cryptosystem replicaCryptosystem{cryptosystem};
+      replicaCryptosystem.loadPrivateKey(i + 1, privateKeys[i + 1]);
+      signers_.emplace_back(replicaCryptosystem.createThresholdSigner());
+    }
+    cryptosystem.loadPrivateKey(config.replicaId + 1, privateKeys[config.replicaId + 1]);
+    CryptoManager::instance(std::make_unique<Cryptosystem>(cryptosystem));
+  }
+
+  static void TearDownTestSuite() { signers_.clear(); }
+
+  static std::vector<concord::Byte> share(uint16_t replica, const concord::crypto::SHA3_256::Digest& hash) {
+    std::vector<concord::Byte> signature(signers_[replica]->requiredLengthForSignedData());
+    signers_[replica]->signData(reinterpret_cast<const char*>(hash.data()),
+                                hash.size(),
+                                reinterpret_cast<char*>(signature.data()),
+                                signature.size());
+    return signature;
+  }
+
+  std::set<PreProcessResultSignature> shares(const concord::crypto::SHA3_256::Digest& hash) const {
+    std::set<PreProcessResultSignature> all;
+    for (uint16_t i = 0; i < kNumReplicas; ++i) {
+      all.emplace(share(i, hash), i, OperationResult::SUCCESS);
+    }
+    return all;
+  }
+
+  // Flips a byte of the signature, after the signer id
+  static PreProcessResultSignature corrupt(PreProcessResultSignature share) {
+    share.signature.back() ^= 0xff;
+    return share;
+  }
+
+  std::unique_ptr<PreProcessResultMsg> createMsg(const PreProcessResultCertificate& certificate) const {
+    return std::make_unique<PreProcessResultMsg>(senderId,
+                                                 0,
+                                                 reqSeqNum,
+                                                 sizeof(result),
+                                                 result,
+                                                 0,
+                                                 "correlationId",
+                                                 concordUtils::SpanContext{},
+                                                 nullptr,
+                                                 0,
+                                                 certificate.serialize());
+  }
+
+  const NodeIdType senderId = 5u;
+  const uint64_t reqSeqNum = 100u;
+  const char result[12] = {"result body"};
+  const concord::crypto::SHA3_256::Digest hash =
+      PreProcessResultHashCreator::create(result, sizeof(result), OperationResult::SUCCESS, senderId, reqSeqNum);
+
+  static std::vector<std::unique_ptr<IThresholdSigner>> signers_;
+};
+
+std::vector<std::unique_ptr<IThresholdSigner>> PreProcessResultCertificateTest::signers_;
+
+TEST_F(PreProcessResultCertificateTest, CombineValidShares) {
+  // The share of this replica, created through the CryptoManager, is the same as the one of its signer
+  EXPECT_EQ(PreProcessResultCertificate::signShare(hash), share(ReplicaConfig::instance().replicaId, hash));
+
+  const auto certificate = PreProcessResultCertificate::combine(shares(hash), hash, kNumRequiredShares);
+  ASSERT_TRUE(certificate);
+  EXPECT_EQ(certificate->pre_process_result, OperationResult::SUCCESS);
+  EXPECT_EQ(certificate->threshold_signature.size(), kNumRequiredShares * share(0, hash).size());
+  EXPECT_FALSE(createMsg(*certificate)->validatePreProcessResultCertificate(1));
+
+  // Too few shares
+  auto tooFew = shares(hash);
+  tooFew.erase(tooFew.begin(), std::next(tooFew.begin(), kNumReplicas - kNumRequiredShares + 1));
+  EXPECT_FALSE(PreProcessResultCertificate::combine(tooFew, hash, kNumRequiredShares));
+}
+
+TEST_F(PreProcessResultCertificateTest, InvalidCertificateIsRejected) {
+  const auto certificate = PreProcessResultCertificate::combine(shares(hash), hash, kNumRequiredShares);
+  ASSERT_TRUE(certificate);
+
+  // A certificate on a different result, or with a corrupted signature, doesn't verify
+  auto otherResult = *certificate;
+  otherResult.pre_process_result = OperationResult::INTERNAL_ERROR;
+  auto res = createMsg(otherResult)->validatePreProcessResultCertificate(1);
+  EXPECT_TRUE(res && res->find("invalid threshold signature") != std::string::npos);
+
+  auto tampered = *certificate;
+  tampered.threshold_signature.back() ^= 0xff;
+  res = createMsg(tampered)->validatePreProcessResultCertificate(1);
+  EXPECT_TRUE(res && res->find("invalid threshold signature") != std::string::npos);
+
+  // Less than fVal + 1 signatures
+  auto truncated = *certificate;
+  truncated.threshold_signature.resize(truncated.threshold_signature.size() / kNumRequiredShares);
+  EXPECT_TRUE(createMsg(truncated)->validatePreProcessResultCertificate(1));
+}
+
+TEST_F(PreProcessResultCertificateTest, FallbackOnInvalidShare) {
+  // The shares are combined in the order of the replicas, so an invalid first share fails the optimistic combine, and
+  // the certificate is combined from the valid shares only
+  auto withInvalid = shares(hash);
+  const auto first = *withInvalid.begin();
+  withInvalid.erase(withInvalid.begin());
+  withInvalid.insert(corrupt(first));
+
+  const auto certificate = PreProcessResultCertificate::combine(withInvalid, hash, kNumRequiredShares);
+  ASSERT_TRUE(certificate);
+  EXPECT_FALSE(createMsg(*certificate)->validatePreProcessResultCertificate(1));
+
+  // A share on a different hash is invalid as well
+  const auto otherHash =
+      PreProcessResultHashCreator::create(result, sizeof(result), OperationResult::SUCCESS, senderId, reqSeqNum + 1);
+  auto withOtherHash = shares(hash);
+  withOtherHash.erase(withOtherHash.begin());
+  withOtherHash.emplace(share(0, otherHash), 0, OperationResult::SUCCESS);
+  EXPECT_TRUE(PreProcessResultCertificate::combine(withOtherHash, hash, kNumRequiredShares));
+
+  // Not enough valid shares
+  std::set<PreProcessResultSignature> mostlyInvalid;
+  for (const auto& s : shares(hash)) {
+    mostlyInvalid.insert(s.sender_replica < kNumReplicas - kFVal ? corrupt(s) : s);
+  }
+  EXPECT_FALSE(PreProcessResultCertificate::combine(mostlyInvalid, hash, kNumRequiredShares));
+}
+
+}  // namespace
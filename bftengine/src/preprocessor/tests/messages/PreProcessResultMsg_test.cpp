@@ -315,6 +315,38 @@ TEST_F(PreProcessResultMsgTestFixture, MsgWithTooMuchSigs) {
   EXPECT_TRUE(res && res->find(ss.str()) != std::string::npos);
 }
 
+TEST_F(PreProcessResultMsgTestFixture, ThresholdCertificate) {
+  MsgParams params;
+  PreProcessResultCertificate certificate{OperationResult::SUCCESS, std::vector<concord::Byte>(64, 'S')};
+  const auto certificateBuf = certificate.serialize();
+  const auto deserialized = PreProcessResultCertificate::deserialize(certificateBuf.data(), certificateBuf.size());
+  EXPECT_EQ(deserialized.pre_process_result, certificate.pre_process_result);
+  EXPECT_EQ(deserialized.threshold_signature, certificate.threshold_signature);
+  EXPECT_THROW(PreProcessResultCertificate::deserialize(certificateBuf.data(), sizeof(uint32_t)), std::runtime_error);
+
+  auto createMsg = [&](const std::string& resultSignatures) {
+    return std::make_unique<PreProcessResultMsg>(params.senderId,
+                                                 0,
+                                                 params.reqSeqNum,
+                                                 sizeof(params.result),
+                                                 params.result,
+                                                 params.requestTimeoutMilli,
+                                                 params.correlationId,
+                                                 concordUtils::SpanContext{params.spanContext},
+                                                 nullptr,
+                                                 0,
+                                                 resultSignatures);
+  };
+  // The message carries a single certificate instead of a signature per replica
+  auto msg = createMsg(certificateBuf);
+  EXPECT_EQ(msg->getResultSignaturesBuf().second, certificateBuf.size());
+  EXPECT_FALSE(msg->validatePreProcessResultCertificate(1));
+
+  auto malformed = createMsg(certificateBuf.substr(0, 2));
+  auto res = malformed->validatePreProcessResultCertificate(1);
+  EXPECT_TRUE(res && res->find("certificate validation failure") != std::string::npos);
+}
+
 TEST_F(PreProcessResultMsgTxSigningOffTestFixture, ClientRequestMsgSanityChecks) {
   MsgParams params;
   auto msg = createMessage(params, replicaInfo.getNumberOfReplicas());
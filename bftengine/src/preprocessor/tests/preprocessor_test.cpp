@@ -747,6 +747,48 @@ TEST(requestPreprocessingState_test, validatePreProcessBatchReplyMsg) {
   }
 }
 
+TEST(requestPreprocessingState_test, rejectPreProcessBatchReplyMsgWithOversizedReply) {
+  bftEngine::impl::ReplicasInfo repInfo(replicaConfig, false, false);
+
+  PreProcessReplyMsgsList batch;
+  uint overallRepliesSize = 0;
+  const auto numOfMsgs = 3;
+  const auto senderId = 2;
+  SigManager::instance(sigManager[senderId].get());
+  for (uint i = 0; i < numOfMsgs; i++) {
+    auto preProcessReplyMsg = make_shared<PreProcessReplyMsg>(senderId,
+                                                              clientId,
+                                                              i,
+                                                              reqSeqNum + i,
+                                                              i,
+                                                              buf,
+                                                              bufLen,
+                                                              cid + to_string(i + 1),
+                                                              STATUS_GOOD,
+                                                              OperationResult::SUCCESS,
+                                                              viewNum);
+    batch.push_back(preProcessReplyMsg);
+    overallRepliesSize += preProcessReplyMsg->size();
+  }
+  auto preProcessBatchReplyMsg =
+      make_shared<PreProcessBatchReplyMsg>(clientId, senderId, batch, cid, overallRepliesSize, viewNum);
+  SigManager::instance(sigManager[repInfo.myId()].get());
+  preProcessBatchReplyMsg->validate(repInfo);
+
+  // Make the second reply claim a signature far larger than the single reply buffer
+  const auto secondReplyOffset =
+      bftEngine::impl::sizeOfHeader<PreProcessBatchReplyMsg>() + cid.size() + batch[0]->size();
+  auto* secondReply = (PreProcessReplyMsg::Header*)(preProcessBatchReplyMsg->body() + secondReplyOffset);
+  const auto origReplyLength = secondReply->replyLength;
+  secondReply->replyLength = 64 * 1024;
+  EXPECT_THROW(preProcessBatchReplyMsg->validate(repInfo), std::runtime_error);
+  EXPECT_TRUE(preProcessBatchReplyMsg->getPreProcessReplyMsgs().empty());
+
+  // A length that fits in the batch but does not match the sender's signature is rejected as well
+  secondReply->replyLength = origReplyLength - 1;
+  EXPECT_THROW(preProcessBatchReplyMsg->validate(repInfo), std::runtime_error);
+}
+
 // Verify that requests and the batch have been successfully released in case no pre-processing consensus reached
 TEST(requestPreprocessingState_test, batchCancelledNoConsensusReached) {
   const uint numOfReplicas = 4;
@@ -1152,7 +1194,7 @@ TEST(requestPreprocessingState_test, rejectMsgWithInvalidView) {
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   logging::initLogger("logging.properties");
-  logging::Logger::getInstance("preprocessor_test").setLogLevel(log4cplus::ERROR_LOG_LEVEL);
+  logging::getLogger("preprocessor_test").setLogLevel(logging::ERROR_LOG_LEVEL);
   if (replicaConfig.replicaMsgSigningAlgo == SignatureAlgorithm::EdDSA) {
     replicaPrivKeys = replicaEdDSAPrivKeys;
     replicaPubKeys = replicaEdDSAPubKeys;
@@ -339,7 +339,12 @@ SimpleStateTran::SimpleStateTran(
       true,                                 // enableReservedPages
       true,                                 // enableSourceBlocksPreFetch
       true,                                 // enableSourceSelectorPrimaryAwareness
-      true                                  // enableStoreRvbDataDuringCheckpointing
+      true,                                 // enableStoreRvbDataDuringCheckpointing
+      false,                                // enableStripedFetching
+      3,                                    // maxNumOfFetchStripes
+      0,                                    // blockCompressionType
+      1,                                    // resPagesDigestVersion
+      0                                     // sourceBlocksCacheSizeMb
   };
 
   auto comparator = concord::storage::memorydb::KeyComparator();
@@ -17,6 +17,8 @@
 #include <vector>
 #include <string>
 #include <cmath>
+#include <chrono>
+#include <map>
 
 #include "gtest/gtest.h"
 
@@ -118,6 +120,9 @@ class BcStTestDelegator {
 
   void addRightNode(const RVBId start_id, const RVBId end_id);
   void removeLeftNode(const RVBId start_id, const RVBId end_id);
+  // Same as addRightNode/removeLeftNode, but the tree is not validated after each node
+  void addRightNodesNoValidation(const RVBId start_id, const RVBId end_id);
+  void removeLeftNodesNoValidation(const RVBId start_id, const RVBId end_id);
 
  protected:
   std::unique_ptr<RangeValidationTree> rvt_;
@@ -141,6 +146,20 @@ void BcStTestDelegator::removeLeftNode(const RVBId start_id, const RVBId end_id)
   }
 }
 
+void BcStTestDelegator::addRightNodesNoValidation(const RVBId start_id, const RVBId end_id) {
+  for (auto i = start_id; i <= end_id; i = i + config_.fetch_range_size_) {
+    const auto str = std::to_string(i);
+    rvt_->addRightNode(i, str.data(), str.size());
+  }
+}
+
+void BcStTestDelegator::removeLeftNodesNoValidation(const RVBId start_id, const RVBId end_id) {
+  for (auto i = start_id; i <= end_id; i = i + config_.fetch_range_size_) {
+    const auto str = std::to_string(i);
+    rvt_->removeLeftNode(i, str.data(), str.size());
+  }
+}
+
 class RVTTest : public ::testing::Test {
  public:
   void init(const RVTConfig& config) {
@@ -243,6 +262,84 @@ TEST_F(RVTTest, NodeValModOps) {
   ASSERT_EQ(c * div_res + mod_res, a + b);
 }
 
+// Golden values, generated by the arbitrary precision (OpenSSL BIGNUM based) NodeVal implementation. NodeVal values
+// are persisted and compared across replicas, so their arithmetic and encoding must not change.
+TEST_F(RVTTest, NodeValGoldenValues) {
+  struct Golden {
+    size_t value_size;
+    std::vector<std::pair<std::string, std::string>> hex_values;  // name -> hex string
+    std::string a_dec;
+    std::string a_minus_b_dec;
+    std::string root;
+    std::string pruned_root;
+  };
+  const std::vector<Golden> goldens = {
+      {32,
+       {{"a", "666972737420626C6F636B20646967657374"},
+        {"b", "6368206973206C6F6E676572207468616E207468652076616C75652073697A65"},
+        {"a+b", "6368206973206C6F6E6765722074CECAE093E888C78CE5C4D795C989DACEEDD9"},
+        {"a-b", "-6368206973206C6F6E676572207401F7FBAD004802B406FE015500B70C0406F1"},
+        {"a*b", "3E49F8F56C67DB63E037CC86D37CA0B932132601856138A9E38F06D59A9FD4C4"},
+        {"b/a", "F87CEC2064072DCE6ABDF0ED5090"},
+        {"b%a", "5EA5C40B459329FEEA1FA14BDFB9F3E04925"},
+        {"a-=b", "9C97DF968CDF939091989A8DDF8BFE080452FFB7FD4BF901FEAAFF48F3FBF90F"},
+        {"-a", "-666972737420626C6F636B20646967657374"},
+        {"-a%b", "-666972737420626C6F636B20646967657374"}},
+       "8921334945027227184378998262770170518139764",
+       "-44962947803282073595210945415950188443805782572165528018569211569529573082865",
+       "D540213F50D35B5E571CF80CC2060C60C6655B97F0B122DC50E6158EEAB2A91C",
+       "C76B3BF17972AE3749001BB0D432CC4D794D481690FBBC4CAE699E7A9CA19003"},
+      {5,
+       {{"a", "6967657374"},
+        {"b", "2073697A65"},
+        {"a+b", "89DACEEDD9"},
+        {"a-b", "48F3FBF90F"},
+        {"a*b", "D59A9FD4C4"},
+        {"b/a", "0"},
+        {"b%a", "2073697A65"},
+        {"a-=b", "48F3FBF90F"},
+        {"-a", "-6967657374"},
+        {"-a%b", "-080D290445"}},
+       "452706268020",
+       "313331022095",
+       "8EEAB2A91C",
+       "7A9CA19003"},
+  };
+
+  for (const auto& golden : goldens) {
+    init(RVTConfig(4, 4, golden.value_size));
+    const NodeVal a{std::string("first block digest")};
+    const NodeVal b{std::string("second block digest, which is longer than the value size")};
+    NodeVal a_minus_eq_b{a};
+    a_minus_eq_b -= b;
+    NodeVal minus_a{a};
+    minus_a.setNegative();
+    const std::map<std::string, NodeVal> values = {{"a", a},
+                                                   {"b", b},
+                                                   {"a+b", a + b},
+                                                   {"a-b", a - b},
+                                                   {"a*b", a * b},
+                                                   {"b/a", b / a},
+                                                   {"b%a", b % a},
+                                                   {"a-=b", a_minus_eq_b},
+                                                   {"-a", minus_a},
+                                                   {"-a%b", minus_a % b}};
+    for (const auto& [name, hex] : golden.hex_values) {
+      ASSERT_EQ(values.at(name).toHexString(), hex) << KVLOG(golden.value_size, name);
+      ASSERT_EQ(NodeVal::fromHexString(hex), values.at(name)) << KVLOG(golden.value_size, name);
+    }
+    ASSERT_EQ(a.toDecString(), golden.a_dec);
+    ASSERT_EQ((a - b).toDecString(), golden.a_minus_b_dec);
+    ASSERT_EQ(NodeVal().toHexString(), "0");
+    ASSERT_EQ(NodeVal().toDecString(), "0");
+
+    ASSERT_NFF(rvt_delegator_->addRightNode(4, 400));
+    ASSERT_EQ(rvt_delegator_->getRootCurrentValueStr(), golden.root);
+    ASSERT_NFF(rvt_delegator_->removeLeftNode(4, 200));
+    ASSERT_EQ(rvt_delegator_->getRootCurrentValueStr(), golden.pruned_root);
+  }
+}
+
 TEST_F(RVTTest, StartIntheMiddleInsertionsOnly) {
   const uint32_t RVT_K = 12;
   const uint32_t fetch_range_size = 5;
@@ -313,6 +410,46 @@ TEST_F(RVTTest, constructAndRemoveSingleNode) {
   ASSERT_EQ(rvt_delegator_->empty(), true);
 }
 
+// Large scale tree, as built on replica startup. This is a timing benchmark, so it is disabled by default. To run it:
+// RVT_test --gtest_filter=RVTTest.DISABLED_largeScaleTreeTiming --gtest_also_run_disabled_tests
+TEST_F(RVTTest, DISABLED_largeScaleTreeTiming) {
+  const uint32_t RVT_K = 1024;
+  const uint32_t fetch_range_size = 4;
+  const size_t num_rvbs = 500 * 1000;
+  const auto max_rvb_id = num_rvbs * fetch_range_size;
+  init(RVTConfig(RVT_K, fetch_range_size, 32));
+  auto elapsed_ms = [](const auto& start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  rvt_delegator_->addRightNodesNoValidation(fetch_range_size, max_rvb_id);
+  const auto build_ms = elapsed_ms(start);
+  ASSERT_NFF(rvt_delegator_->validate());
+  ASSERT_EQ(rvt_delegator_->getMaxRvbId(), max_rvb_id);
+
+  start = std::chrono::steady_clock::now();
+  std::ostringstream oss;
+  ASSERT_NFF(oss = rvt_delegator_->getSerializedRvbData());
+  const auto serialize_ms = elapsed_ms(start);
+  auto root_hash = rvt_delegator_->getRootCurrentValueStr();
+  auto total_nodes = rvt_delegator_->totalNodes();
+
+  start = std::chrono::steady_clock::now();
+  std::istringstream iss(oss.str());
+  ASSERT_TRUE(rvt_delegator_->setSerializedRvbData(iss));
+  const auto deserialize_ms = elapsed_ms(start);
+  ASSERT_EQ(root_hash, rvt_delegator_->getRootCurrentValueStr());
+  ASSERT_EQ(total_nodes, rvt_delegator_->totalNodes());
+
+  start = std::chrono::steady_clock::now();
+  rvt_delegator_->removeLeftNodesNoValidation(fetch_range_size, max_rvb_id / 2);
+  const auto prune_ms = elapsed_ms(start);
+  ASSERT_NFF(rvt_delegator_->validate());
+
+  std::cout << KVLOG(num_rvbs, total_nodes, build_ms, serialize_ms, deserialize_ms, prune_ms) << std::endl;
+}
+
 class RVTTestserializeDeserializeTreeFixture : public RVTTest,
                                                public testing::WithParamInterface<std::pair<uint32_t, uint32_t>> {};
 TEST_P(RVTTestserializeDeserializeTreeFixture, serializeDeserializeTree) {
@@ -40,6 +40,7 @@
 #include "Messages.hpp"
 #include "messages/PrePrepareMsg.hpp"
 #include "util/hex_tools.hpp"
+#include "util/serializable.hpp"
 #include "RVBManager.hpp"
 #include "RangeValidationTree.hpp"
 #include "messages/StateTransferMsg.hpp"
@@ -146,7 +147,12 @@ Config targetConfig() {
       true,               // enableReservedPages
       true,               // enableSourceBlocksPreFetch
       true,               // enableSourceSelectorPrimaryAwareness
-      true                // enableStoreRvbDataDuringCheckpointing
+      true,               // enableStoreRvbDataDuringCheckpointing
+      false,              // enableStripedFetching
+      3,                  // maxNumOfFetchStripes
+      0,                  // blockCompressionType
+      1,                  // resPagesDigestVersion
+      0                   // sourceBlocksCacheSizeMb
   };
 }
 
@@ -399,6 +405,12 @@ class BcStTestDelegator {
   SimpleMemoryPool<BCStateTran::BlockIOContext>& getIoPool() const { return stateTransfer_->ioPool_; }
   std::deque<BCStateTran::BlockIOContextPtr>& getIoContexts() const { return stateTransfer_->ioContexts_; }
   void clearIoContexts() { stateTransfer_->clearIoContexts(); }
+  const SourceBlocksCache& getSourceBlocksCache() const { return *stateTransfer_->sourceBlocksCache_; }
+  void waitForSourceReadAhead() {
+    if (stateTransfer_->readAheadFuture_.valid()) {
+      stateTransfer_->readAheadFuture_.wait();
+    }
+  }
   RVBId nextRvbBlockId(BlockId blockId) const { return stateTransfer_->rvbm_->nextRvbBlockId(blockId); }
   RVBId prevRvbBlockId(BlockId blockId) const { return stateTransfer_->rvbm_->prevRvbBlockId(blockId); }
   RangeValidationTree* getRvt() { return stateTransfer_->rvbm_->in_mem_rvt_.get(); }
@@ -442,6 +454,9 @@ class BcStTestDelegator {
   const std::set<uint16_t>& getPreferredReplicas() { return stateTransfer_->sourceSelector_.preferredReplicas_; }
   void validateEqualRVTs(const RangeValidationTree& rvtA, const RangeValidationTree& rvtB) const;
   FetchingState getFetchingState() { return stateTransfer_->getFetchingState(); }
+
+  // Striped fetching
+  StripeManager& getStripeManager() { return stateTransfer_->stripeManager_; }
   bool isSrcSessionOpen() const { return stateTransfer_->sourceSession_.isOpen(); }
   uint16_t srcSessionOwnerDestReplicaId() const { return stateTransfer_->sourceSession_.ownerDestReplicaId(); }
 
@@ -528,9 +543,12 @@ class FakeDestination : public FakeReplicaBase {
                             uint64_t requiredCheckpointNum,
                             uint16_t senderReplicaId = UINT_LEAST16_MAX);
   uint64_t getLastMsgSeqNum() { return lastMsgSeqNum_; }
+  // Send FetchBlocksMsg as older replicas do, without the trailing compressionType
+  void sendLegacyFetchBlocksMsgs() { fetchBlocksMsgSize_ = FetchBlocksMsg::sizeWithoutCompressionType(); }
 
  protected:
   uint64_t lastMsgSeqNum_;
+  size_t fetchBlocksMsgSize_ = sizeof(FetchBlocksMsg);
 };
 
 /////////////////////////////////////////////////////////
@@ -552,13 +570,34 @@ class FakeSources : public FakeReplicaBase {
   // Source (fake) Replies
   void replyAskForCheckpointSummariesMsg(bool generateBlocksAndDescriptors = true);
   void replyFetchBlocksMsg();
+  // Reply to a FetchBlocksMsg sent to any of the sources, e.g. a stripe request sent to a helper source
+  void replyFetchBlocksMsg(const Msg& msg);
   void replyResPagesMsg(bool& outDoneSending);
   void rejectFetchingMsg(uint16_t rejCode, uint64_t reqMsgSeqNum, uint16_t destReplicaId);
   void syncBlocks(TestAppState& srcAppState, uint64_t fromBlockId, uint64_t toBlockId);
+  // The first block in the next FetchBlocks reply is sent in numOfChunks chunks. If surplusChunkTotal is not 0, a
+  // surplus chunk numOfChunks+1, claiming the block has surplusChunkTotal chunks, is sent just before the last chunk.
+  void chunkFirstBlockOfNextReply(uint16_t numOfChunks, uint16_t surplusChunkTotal = 0) {
+    numOfChunksInFirstBlock_ = numOfChunks;
+    surplusChunkTotal_ = surplusChunkTotal;
+  }
+  // The first block in the next FetchBlocks reply is corrupted, hence it fails validation by the destination
+  void corruptFirstBlockOfNextReply() { corruptFirstBlock_ = true; }
 
  protected:
+  void sendBlockInChunks(const FetchBlocksMsg* fetchBlocksMsg,
+                         uint16_t destReplicaId,
+                         uint64_t blockId,
+                         const char* data,
+                         uint32_t rvbDigestsSize,
+                         uint32_t dataSize,
+                         bool lastInBatch);
+
   std::unique_ptr<char[]> rawVBlock_;
   std::optional<FetchResPagesMsg> lastReceivedFetchResPagesMsg_;
+  uint16_t numOfChunksInFirstBlock_ = 1;
+  uint16_t surplusChunkTotal_ = 0;
+  bool corruptFirstBlock_ = false;
 };
 
 /////////////////////////////////////////////////////////
@@ -614,6 +653,12 @@ class BcStTest : public ::testing::Test {
   void dstAssertFetchResPagesMsgSent();
   void dstReportMultiplePrePrepareMessagesReceived(size_t numberOfPreprepareMessages, uint16_t senderId);
 
+  // Target/Product ST - destination striped fetching
+  void dstStartStripedFetching();
+  void dstTakeFetchBlocksMsgs(vector<Msg>& outCurrentSourceMsgs, vector<Msg>& outStripeMsgs);
+  void dstReplyFetchBlocksMsg(const Msg& msg);
+  void dstFetchAllBlocks(size_t& outNumOfStripeRequests);
+
   // Target/Product ST - source API & assertions// This should be the same as TestConfig
   void srcAssertCheckpointSummariesSent(uint64_t minRepliedCheckpointNum, uint64_t maxRepliedCheckpointNum);
   void srcAssertItemDataMsgBatchSentWithBlocks(uint64_t minExpectedBlockId, uint64_t maxExpectedBlockId);
@@ -716,6 +761,8 @@ void DataGenerator::generateCheckpointDescriptors(const TestAppState& appState,
   computeBlockDigest(
       lastBlockId, reinterpret_cast<const char*>(lastBlk.get()), lastBlk->totalBlockSize, &lastBlockDigest);
 
+  const auto resPagesDigestVersion =
+      static_cast<DataStore::ResPagesDigestVersion>(targetConfig_.resPagesDigestVersion);
   for (uint64_t i = minRepliedCheckpointNum; i <= maxRepliedCheckpointNum; ++i) {
     // for now, we do not support (expect) setting into an already set descriptor
     ASSERT_FALSE(datastore->hasCheckpointDesc(i));
@@ -734,10 +781,11 @@ void DataGenerator::generateCheckpointDescriptors(const TestAppState& appState,
     ASSERT_NFF(generateReservedPages(datastore, i));
     DataStore::ResPagesDescriptor* resPagesDesc = datastore->getResPagesDescriptor(i);
     Digest digestOfResPagesDescriptor;
-    BCStateTran::computeDigestOfPagesDescriptor(resPagesDesc, digestOfResPagesDescriptor);
+    BCStateTran::computeDigestOfPagesDescriptor(resPagesDesc, digestOfResPagesDescriptor, resPagesDigestVersion);
     datastore->free(resPagesDesc);
 
     desc.digestOfResPagesDescriptor = digestOfResPagesDescriptor;
+    desc.resPagesDigestVersion = resPagesDigestVersion;
     rvbm->updateRvbDataDuringCheckpoint(desc);
     datastore->setCheckpointDesc(i, desc);
   }
@@ -809,8 +857,18 @@ void BcStTestDelegator::assertBCStateTranMetricKeyVal(const std::string& key, ui
     ASSERT_EQ(stMetrics_.src_num_io_contexts_invoked_.Get().Get(), val);
   } else if (key == "src_num_io_contexts_consumed") {
     ASSERT_EQ(stMetrics_.src_num_io_contexts_consumed_.Get().Get(), val);
+  } else if (key == "src_blocks_cache_hits") {
+    ASSERT_EQ(stMetrics_.src_blocks_cache_hits_.Get().Get(), val);
+  } else if (key == "src_blocks_cache_misses") {
+    ASSERT_EQ(stMetrics_.src_blocks_cache_misses_.Get().Get(), val);
+  } else if (key == "src_num_blocks_read_ahead") {
+    ASSERT_EQ(stMetrics_.src_num_blocks_read_ahead_.Get().Get(), val);
   } else if (key == "received_reject_fetching_msg") {
     ASSERT_EQ(stMetrics_.received_reject_fetching_msg_.Get().Get(), val);
+  } else if (key == "invalid_item_data_msg") {
+    ASSERT_EQ(stMetrics_.invalid_item_data_msg_.Get().Get(), val);
+  } else if (key == "irrelevant_item_data_msg") {
+    ASSERT_EQ(stMetrics_.irrelevant_item_data_msg_.Get().Get(), val);
   } else {
     FAIL() << "Unexpected key!";
   }
@@ -987,8 +1045,8 @@ void FakeDestination::sendFetchBlocksMsg(uint64_t minBlockId,
                         : senderReplicaId;
   char* fetchBlocksMsgBuff{nullptr};
   ASSERT_NFF(TestUtils::allocCopyStateTransferMsg(
-      reinterpret_cast<char*>(&fetchBlocksMsg), sizeof(FetchBlocksMsg), &fetchBlocksMsgBuff));
-  stDelegator_->handleStateTransferMessage(fetchBlocksMsgBuff, sizeof(FetchBlocksMsg), senderReplicaId);
+      reinterpret_cast<char*>(&fetchBlocksMsg), fetchBlocksMsgSize_, &fetchBlocksMsgBuff));
+  stDelegator_->handleStateTransferMessage(fetchBlocksMsgBuff, fetchBlocksMsgSize_, senderReplicaId);
   do {
     const auto [isTriggered, duration] = testedReplicaIf_.popOneShotTimerDurationMilli();
     if (!isTriggered) {
@@ -1098,7 +1156,7 @@ void FakeSources::replyAskForCheckpointSummariesMsg(bool generateBlocksAndDescri
   for (uint64_t i = testState_.maxRepliedCheckpointNum; i >= testState_.minRepliedCheckpointNum; i--) {
     ASSERT_TRUE(datastore_->hasCheckpointDesc(i));
     DataStore::CheckpointDesc desc = datastore_->getCheckpointDesc(i);
-    auto reply(CheckpointSummaryMsg::alloc(desc.rvbData.size()));
+    auto reply(CheckpointSummaryMsg::alloc(desc.rvbData.size(), static_cast<uint8_t>(desc.resPagesDigestVersion)));
     reply->checkpointNum = desc.checkpointNum;
     reply->maxBlockId = desc.maxBlockId;
     reply->digestOfMaxBlockId = desc.digestOfMaxBlockId;
@@ -1123,7 +1181,11 @@ void FakeSources::replyAskForCheckpointSummariesMsg(bool generateBlocksAndDescri
 
 void FakeSources::replyFetchBlocksMsg() {
   ASSERT_EQ(testedReplicaIf_.sent_messages_.size(), 1);
-  const auto& msg = testedReplicaIf_.sent_messages_.front();
+  ASSERT_NFF(replyFetchBlocksMsg(testedReplicaIf_.sent_messages_.front()));
+  testedReplicaIf_.sent_messages_.pop_front();
+}
+
+void FakeSources::replyFetchBlocksMsg(const Msg& msg) {
   ASSERT_NFF(assertMsgType(msg, MsgType::FetchBlocks));
   auto fetchBlocksMsg = reinterpret_cast<FetchBlocksMsg*>(msg.data_.get());
   uint64_t nextBlockId = fetchBlocksMsg->maxBlockId;
@@ -1132,7 +1194,6 @@ void FakeSources::replyFetchBlocksMsg() {
   // very basic validity check, no simulate corruption
   if ((fetchBlocksMsg->minBlockId == 0) || (fetchBlocksMsg->maxBlockId == 0)) {
     rejectFetchingMsg(RejectFetchingMsg::Reason::BLOCK_NOT_FOUND_IN_STORAGE, fetchBlocksMsg->msgSeqNum, msg.to_);
-    testedReplicaIf_.sent_messages_.pop_front();
     return;
   }
 
@@ -1164,16 +1225,70 @@ void FakeSources::replyFetchBlocksMsg() {
     }
     itemDataMsg->rvbDigestsSize = rvbGroupDigestsActualSize;
     memcpy(itemDataMsg->data + rvbGroupDigestsActualSize, blk.get(), blk->totalBlockSize);
-    char* msgBytes{nullptr};
-    ASSERT_NFF(TestUtils::allocCopyStateTransferMsg(itemDataMsg.getSerializedMsg(), itemDataMsg->size(), &msgBytes));
-    stDelegator_->handleStateTransferMessage(reinterpret_cast<char*>(msgBytes), itemDataMsg->size(), msg.to_);
+    if ((nextBlockId == fetchBlocksMsg->maxBlockId) && corruptFirstBlock_) {
+      itemDataMsg->data[rvbGroupDigestsActualSize + blk->totalBlockSize - 1] ^= 0xFF;
+      corruptFirstBlock_ = false;
+    }
+    if ((nextBlockId == fetchBlocksMsg->maxBlockId) && (numOfChunksInFirstBlock_ > 1)) {
+      ASSERT_NFF(sendBlockInChunks(fetchBlocksMsg,
+                                   msg.to_,
+                                   nextBlockId,
+                                   itemDataMsg->data,
+                                   rvbGroupDigestsActualSize,
+                                   rvbGroupDigestsActualSize + blk->totalBlockSize,
+                                   lastInBatch));
+      numOfChunksInFirstBlock_ = 1;
+      surplusChunkTotal_ = 0;
+    } else {
+      char* msgBytes{nullptr};
+      ASSERT_NFF(TestUtils::allocCopyStateTransferMsg(itemDataMsg.getSerializedMsg(), itemDataMsg->size(), &msgBytes));
+      stDelegator_->handleStateTransferMessage(reinterpret_cast<char*>(msgBytes), itemDataMsg->size(), msg.to_);
+    }
     if (lastInBatch) {
       break;
     }
     --nextBlockId;
     ++numOfSentChunks;
   }
-  testedReplicaIf_.sent_messages_.pop_front();
+}
+
+// RVB group digests (if any) are sent with the first chunk
+void FakeSources::sendBlockInChunks(const FetchBlocksMsg* fetchBlocksMsg,
+                                    uint16_t destReplicaId,
+                                    uint64_t blockId,
+                                    const char* data,
+                                    uint32_t rvbDigestsSize,
+                                    uint32_t dataSize,
+                                    bool lastInBatch) {
+  const uint16_t numOfChunks = numOfChunksInFirstBlock_;
+  const uint32_t blockSize = dataSize - rvbDigestsSize;
+  ASSERT_GE(blockSize, numOfChunks);
+  const uint32_t chunkSize = blockSize / numOfChunks;
+  auto sendChunk = [&](uint16_t chunkNumber, uint16_t totalNumberOfChunks, const char* pos, uint32_t size) {
+    const uint32_t chunkRvbDigestsSize = (chunkNumber == 1) ? rvbDigestsSize : 0;
+    auto itemDataMsg = ItemDataMsg::alloc(chunkRvbDigestsSize + size);
+    itemDataMsg->requestMsgSeqNum = fetchBlocksMsg->msgSeqNum;
+    itemDataMsg->blockNumber = blockId;
+    itemDataMsg->totalNumberOfChunksInBlock = totalNumberOfChunks;
+    itemDataMsg->chunkNumber = chunkNumber;
+    itemDataMsg->lastInBatch = lastInBatch && (chunkNumber == numOfChunks);
+    itemDataMsg->rvbDigestsSize = chunkRvbDigestsSize;
+    memcpy(itemDataMsg->data, data, chunkRvbDigestsSize);
+    memcpy(itemDataMsg->data + chunkRvbDigestsSize, pos, size);
+    char* msgBytes{nullptr};
+    ASSERT_NFF(TestUtils::allocCopyStateTransferMsg(itemDataMsg.getSerializedMsg(), itemDataMsg->size(), &msgBytes));
+    stDelegator_->handleStateTransferMessage(reinterpret_cast<char*>(msgBytes), itemDataMsg->size(), destReplicaId);
+  };
+
+  const char* blockData = data + rvbDigestsSize;
+  for (uint16_t chunkNumber = 1; chunkNumber <= numOfChunks; ++chunkNumber) {
+    const uint32_t offset = (chunkNumber - 1) * chunkSize;
+    const uint32_t size = (chunkNumber < numOfChunks) ? chunkSize : (blockSize - offset);
+    if ((chunkNumber == numOfChunks) && (surplusChunkTotal_ > 0)) {
+      ASSERT_NFF(sendChunk(numOfChunks + 1, surplusChunkTotal_, blockData, chunkSize));
+    }
+    ASSERT_NFF(sendChunk(chunkNumber, numOfChunks, blockData + offset, size));
+  }
 }
 
 // To ASSERT_ / EXPECT_  inside this function, we must pass output as a parameter
@@ -1319,8 +1434,8 @@ void BcStTest::initialize() {
   printConfiguration();
   if (testConfig_.productDbDeleteOnStart) deleteBcStateTransferDbFolder(testConfig_.bcstDbPath);
   ASSERT_LE(testConfig_.minNumberOfUpdatedReservedPages, testConfig_.maxNumberOfUpdatedReservedPages);
-  // For now we assume no chunking is supported
-  ASSERT_EQ(targetConfig_.maxChunkSize, targetConfig_.maxBlockSize);
+  // Fake sources send a block in a single chunk, unless told otherwise (see FakeSources::chunkFirstBlockOfNextReply)
+  ASSERT_LE(targetConfig_.maxChunkSize, targetConfig_.maxBlockSize);
 
   datastore_ = createDataStore(testConfig_.bcstDbPath, targetConfig_);
   dataGen_ = make_unique<DataGenerator>(targetConfig_, testConfig_);
@@ -1432,6 +1547,64 @@ void BcStTest::dstReportMultiplePrePrepareMessagesReceived(size_t numberOfPrepre
   }
 }
 
+static FetchBlocksMsg* asFetchBlocksMsg(const Msg& msg) { return reinterpret_cast<FetchBlocksMsg*>(msg.data_.get()); }
+
+// Start a cycle with striped fetching enabled, and reply to the current source until stripes are dispatched. Stripes
+// are fetched without RVB group digests, hence they can be dispatched only after the first batch stored them.
+void BcStTest::dstStartStripedFetching() {
+  targetConfig_.enableStripedFetching = true;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  while (testedReplicaIf_.sent_messages_.size() == 1) {
+    ASSERT_NFF(dstAssertFetchBlocksMsgSent());
+    ASSERT_EQ(stDelegator_->getStripeManager().getStripes().size(), 0);
+    ASSERT_NFF(fakeSrcReplica_->replyFetchBlocksMsg());
+    this_thread::sleep_for(chrono::milliseconds(20));
+    stateTransfer_->onTimer();
+  }
+  ASSERT_EQ(FetchingState::GettingMissingBlocks, stDelegator_->getFetchingState());
+}
+
+// Take all sent FetchBlocksMsgs: the ones sent to the current source, and the stripes requests (sorted by block ID)
+void BcStTest::dstTakeFetchBlocksMsgs(vector<Msg>& outCurrentSourceMsgs, vector<Msg>& outStripeMsgs) {
+  auto currentSourceId = stDelegator_->getSourceSelector().currentReplica();
+  auto& sentMessages = testedReplicaIf_.sent_messages_;
+  for (auto& msg : sentMessages) {
+    ASSERT_NFF(assertMsgType(msg, MsgType::FetchBlocks));
+    auto& out = (msg.to_ == currentSourceId) ? outCurrentSourceMsgs : outStripeMsgs;
+    out.push_back(std::move(msg));
+  }
+  sentMessages.clear();
+  std::sort(outStripeMsgs.begin(), outStripeMsgs.end(), [](const Msg& a, const Msg& b) {
+    return asFetchBlocksMsg(a)->minBlockId < asFetchBlocksMsg(b)->minBlockId;
+  });
+}
+
+void BcStTest::dstReplyFetchBlocksMsg(const Msg& msg) {
+  ASSERT_NFF(fakeSrcReplica_->replyFetchBlocksMsg(msg));
+  // There might be pending jobs for putBlock, we need to wait some time and then finalize them by calling onTimer
+  this_thread::sleep_for(chrono::milliseconds(20));
+  stateTransfer_->onTimer();
+}
+
+// Reply to all FetchBlocksMsgs (of the current source and of the stripes) in the order they were sent, until all
+// blocks are collected
+void BcStTest::dstFetchAllBlocks(size_t& outNumOfStripeRequests) {
+  outNumOfStripeRequests = 0;
+  while (datastore_->getFirstRequiredBlock() != 0) {
+    ASSERT_FALSE(testedReplicaIf_.sent_messages_.empty());
+    Msg msg = std::move(testedReplicaIf_.sent_messages_.front());
+    testedReplicaIf_.sent_messages_.pop_front();
+    if (msg.to_ != stDelegator_->getSourceSelector().currentReplica()) {
+      ++outNumOfStripeRequests;
+    }
+    ASSERT_NFF(dstReplyFetchBlocksMsg(msg));
+  }
+  // Stripes are cleared once all blocks are collected, drop their requests which are left unanswered
+  fakeSrcReplica_->clearSentMessagesByMessageType(MsgType::FetchBlocks);
+}
+
 void BcStTest::srcAssertCheckpointSummariesSent(uint64_t minRepliedCheckpointNum, uint64_t maxRepliedCheckpointNum) {
   LOG_TRACE(GL, "");
   ASSERT_SRC_UNDER_TEST;
@@ -1439,8 +1612,13 @@ void BcStTest::srcAssertCheckpointSummariesSent(uint64_t minRepliedCheckpointNum
   ASSERT_EQ(testedReplicaIf_.sent_messages_.size(), maxRepliedCheckpointNum - minRepliedCheckpointNum + 1);
   uint64_t expectedCheckpointNum = maxRepliedCheckpointNum;
   for (const auto& msg : testedReplicaIf_.sent_messages_) {
-    ASSERT_NFF(assertMsgType(msg, MsgType::CheckpointsSummary));
+    // A non default reserved pages digest version is sent in a message which older replicas do not accept
+    ASSERT_NFF(assertMsgType(msg,
+                             (targetConfig_.resPagesDigestVersion == CheckpointSummaryMsg::kDefaultResPagesDigestVersion)
+                                 ? MsgType::CheckpointsSummary
+                                 : MsgType::VersionedCheckpointsSummary));
     const auto* checkpointSummaryMsg = reinterpret_cast<CheckpointSummaryMsg*>(msg.data_.get());
+    ASSERT_EQ(msg.len_, checkpointSummaryMsg->size());
     ASSERT_EQ(checkpointSummaryMsg->checkpointNum, expectedCheckpointNum);
     ASSERT_EQ(checkpointSummaryMsg->requestMsgSeqNum, fakeDstReplica_->getLastMsgSeqNum());
     ASSERT_EQ(checkpointSummaryMsg->maxBlockId, (expectedCheckpointNum + 1) * testConfig_.checkpointWindowSize);
@@ -1449,6 +1627,7 @@ void BcStTest::srcAssertCheckpointSummariesSent(uint64_t minRepliedCheckpointNum
     DataStore::CheckpointDesc desc = datastore_->getCheckpointDesc(checkpointSummaryMsg->checkpointNum);
     ASSERT_EQ(checkpointSummaryMsg->digestOfMaxBlockId, desc.digestOfMaxBlockId);
     ASSERT_EQ(checkpointSummaryMsg->digestOfResPagesDescriptor, desc.digestOfResPagesDescriptor);
+    ASSERT_EQ(checkpointSummaryMsg->resPagesDigestVersion(), static_cast<uint8_t>(desc.resPagesDigestVersion));
     ASSERT_EQ(checkpointSummaryMsg->sizeofRvbData(), desc.rvbData.size());
     ASSERT_EQ(memcmp(checkpointSummaryMsg->data, desc.rvbData.data(), checkpointSummaryMsg->sizeofRvbData()), 0);
     --expectedCheckpointNum;
@@ -1464,6 +1643,7 @@ void BcStTest::srcAssertItemDataMsgBatchSentWithBlocks(uint64_t minExpectedBlock
   uint64_t currentBlockId = maxExpectedBlockId;  // we expect to get blocks in reverse order, chunking not supported
 
   for (const auto& msg : testedReplicaIf_.sent_messages_) {
+    ASSERT_NFF(assertMsgType(msg, MsgType::ItemData));
     const auto* itemDataMsg = reinterpret_cast<ItemDataMsg*>(msg.data_.get());
     ASSERT_EQ(1, itemDataMsg->totalNumberOfChunksInBlock);
     ASSERT_EQ(1, itemDataMsg->chunkNumber);
@@ -1926,6 +2106,229 @@ TEST_F(BcStTest, dstPreprepareFromMultipleSourcesDuringStateTransfer) {
                                    testState_.maxRequiredBlockId));
 }
 
+// The first block of the first batch is sent in 2 chunks, followed by a surplus chunk 3 which claims the block has only
+// 2 chunks. The surplus chunk is dropped on arrival, and the block is accepted.
+TEST_F(BcStTest, dstDropSurplusChunkOfBlock) {
+  targetConfig_.maxChunkSize = targetConfig_.maxBlockSize / 4;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  fakeSrcReplica_->chunkFirstBlockOfNextReply(2, 2);
+  ASSERT_NFF(getMissingblocksStage<void>());
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("invalid_item_data_msg", 1));
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("replacement_due_to_bad_data", 0));
+  ASSERT_NFF(getReservedPagesStage());
+  // validate completion
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+}
+
+// Same as above, but the surplus chunk claims the block has 3 chunks. Chunks 1..2 do not make a full block anymore (for
+// both the digest jobs and getNextFullBlock): the source is replaced due to bad data, and the block is fetched again.
+TEST_F(BcStTest, dstSurplusChunkOfBlockIsBadData) {
+  targetConfig_.maxChunkSize = targetConfig_.maxBlockSize / 4;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  fakeSrcReplica_->chunkFirstBlockOfNextReply(2, 3);
+  ASSERT_NFF(getMissingblocksStage<void>());
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("invalid_item_data_msg", 0));
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("replacement_due_to_bad_data", 1));
+  ASSERT_NFF(getReservedPagesStage());
+  // validate completion
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+}
+
+// Validate a full state transfer, while upcoming batches are fetched as stripes from helper sources
+TEST_F(BcStTest, dstStripedFetchingFullStateTransfer) {
+  ASSERT_NFF(dstStartStripedFetching());
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  stDelegator_->getStripeManager().setAggregator(aggregator);
+  size_t numOfStripeRequests{0};
+  ASSERT_NFF(dstFetchAllBlocks(numOfStripeRequests));
+  ASSERT_GT(numOfStripeRequests, 0);
+  stDelegator_->getStripeManager().UpdateAggregator();
+  ASSERT_GT(aggregator->GetCounter("state_transfer_striped_fetch", "stripes_consumed").Get(), 0);
+  ASSERT_EQ(aggregator->GetCounter("state_transfer_striped_fetch", "stripes_cancelled_bad_data").Get(), 0);
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("replacement_due_to_bad_data", 0));
+  ASSERT_NFF(getReservedPagesStage());
+  // validate completion
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+}
+
+// Stripes are dispatched to distinct helper sources for the batches which follow the current batch. Once the current
+// batch is committed, the destination waits for the stripe of the next batch instead of requesting it from the current
+// source. When this stripe arrives, it is consumed and the freed slot is used to dispatch the next stripe.
+TEST_F(BcStTest, dstWaitForStripeOfCurrentBatch) {
+  ASSERT_NFF(dstStartStripedFetching());
+  auto currentSourceId = stDelegator_->getSourceSelector().currentReplica();
+  vector<Msg> currentSourceMsgs, stripeMsgs;
+  ASSERT_NFF(dstTakeFetchBlocksMsgs(currentSourceMsgs, stripeMsgs));
+  ASSERT_EQ(currentSourceMsgs.size(), 1);
+  ASSERT_EQ(stripeMsgs.size(), targetConfig_.maxNumOfFetchStripes);
+  set<uint16_t> helperSources;
+  uint64_t expectedMinBlockId = asFetchBlocksMsg(currentSourceMsgs.front())->maxBlockId + 1;
+  for (const auto& msg : stripeMsgs) {
+    ASSERT_TRUE(helperSources.insert(msg.to_).second);  // helper sources must be unique
+    ASSERT_EQ(asFetchBlocksMsg(msg)->minBlockId, expectedMinBlockId);
+    ASSERT_EQ(asFetchBlocksMsg(msg)->rvbGroupId, 0);
+    expectedMinBlockId = asFetchBlocksMsg(msg)->maxBlockId + 1;
+  }
+
+  // The current batch is done, the next one is fetched by the 1st stripe
+  ASSERT_NFF(dstReplyFetchBlocksMsg(currentSourceMsgs.front()));
+  ASSERT_TRUE(testedReplicaIf_.sent_messages_.empty());
+  ASSERT_EQ(stDelegator_->getNextRequiredBlock(), asFetchBlocksMsg(stripeMsgs[0])->maxBlockId);
+
+  // The 1st stripe is consumed, the destination waits for the 2nd stripe and dispatches a new one
+  ASSERT_NFF(dstReplyFetchBlocksMsg(stripeMsgs[0]));
+  ASSERT_EQ(stDelegator_->getNextRequiredBlock(), asFetchBlocksMsg(stripeMsgs[1])->maxBlockId);
+  ASSERT_EQ(stDelegator_->getSourceSelector().currentReplica(), currentSourceId);
+  vector<Msg> newCurrentSourceMsgs, newStripeMsgs;
+  ASSERT_NFF(dstTakeFetchBlocksMsgs(newCurrentSourceMsgs, newStripeMsgs));
+  ASSERT_TRUE(newCurrentSourceMsgs.empty());
+  ASSERT_EQ(newStripeMsgs.size(), 1);
+  ASSERT_EQ(asFetchBlocksMsg(newStripeMsgs.front())->minBlockId, expectedMinBlockId);
+
+  // Complete the cycle
+  testedReplicaIf_.sent_messages_.push_back(std::move(stripeMsgs[1]));
+  testedReplicaIf_.sent_messages_.push_back(std::move(stripeMsgs[2]));
+  testedReplicaIf_.sent_messages_.push_back(std::move(newStripeMsgs.front()));
+  size_t numOfStripeRequests{0};
+  ASSERT_NFF(dstFetchAllBlocks(numOfStripeRequests));
+  ASSERT_NFF(getReservedPagesStage());
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+}
+
+// A stripe with a corrupted block is consumed: the block fails validation, the helper source which fetched the stripe
+// is excluded, and the batch is requested again from the current source, which is not replaced
+TEST_F(BcStTest, dstStripeBadDataIsAttributedToHelperSource) {
+  ASSERT_NFF(dstStartStripedFetching());
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  stDelegator_->getStripeManager().setAggregator(aggregator);
+  auto currentSourceId = stDelegator_->getSourceSelector().currentReplica();
+  vector<Msg> currentSourceMsgs, stripeMsgs;
+  ASSERT_NFF(dstTakeFetchBlocksMsgs(currentSourceMsgs, stripeMsgs));
+  ASSERT_EQ(currentSourceMsgs.size(), 1);
+  ASSERT_EQ(stripeMsgs.size(), targetConfig_.maxNumOfFetchStripes);
+  const auto helperSourceId = stripeMsgs[0].to_;
+  const auto stripeMinBlockId = asFetchBlocksMsg(stripeMsgs[0])->minBlockId;
+  const auto stripeMaxBlockId = asFetchBlocksMsg(stripeMsgs[0])->maxBlockId;
+  ASSERT_NFF(dstReplyFetchBlocksMsg(currentSourceMsgs.front()));
+  fakeSrcReplica_->corruptFirstBlockOfNextReply();
+  ASSERT_NFF(dstReplyFetchBlocksMsg(stripeMsgs[0]));
+
+  ASSERT_TRUE(stDelegator_->getStripeManager().isExcluded(helperSourceId));
+  ASSERT_EQ(stDelegator_->getSourceSelector().currentReplica(), currentSourceId);
+  ASSERT_NFF(stDelegator_->assertSourceSelectorMetricKeyVal("replacement_due_to_bad_data", 0));
+  stDelegator_->getStripeManager().UpdateAggregator();
+  ASSERT_EQ(aggregator->GetCounter("state_transfer_striped_fetch", "stripes_cancelled_bad_data").Get(), 1);
+  vector<Msg> newCurrentSourceMsgs, newStripeMsgs;
+  ASSERT_NFF(dstTakeFetchBlocksMsgs(newCurrentSourceMsgs, newStripeMsgs));
+  ASSERT_EQ(newCurrentSourceMsgs.size(), 1);
+  ASSERT_EQ(asFetchBlocksMsg(newCurrentSourceMsgs.front())->minBlockId, stripeMinBlockId);
+  ASSERT_EQ(asFetchBlocksMsg(newCurrentSourceMsgs.front())->maxBlockId, stripeMaxBlockId);
+  for (const auto& msg : newStripeMsgs) {
+    ASSERT_NE(msg.to_, helperSourceId);
+  }
+
+  // Complete the cycle
+  testedReplicaIf_.sent_messages_.push_back(std::move(newCurrentSourceMsgs.front()));
+  testedReplicaIf_.sent_messages_.push_back(std::move(stripeMsgs[1]));
+  testedReplicaIf_.sent_messages_.push_back(std::move(stripeMsgs[2]));
+  for (auto& msg : newStripeMsgs) {
+    testedReplicaIf_.sent_messages_.push_back(std::move(msg));
+  }
+  size_t numOfStripeRequests{0};
+  ASSERT_NFF(dstFetchAllBlocks(numOfStripeRequests));
+  ASSERT_NFF(getReservedPagesStage());
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+}
+
+// A helper source replies to an older request: its ItemDataMsgs are dropped as irrelevant, and the stripe keeps waiting
+// for the reply to its latest request
+TEST_F(BcStTest, dstIgnoreStripeItemDataMsgsOfOtherRequest) {
+  ASSERT_NFF(dstStartStripedFetching());
+  vector<Msg> currentSourceMsgs, stripeMsgs;
+  ASSERT_NFF(dstTakeFetchBlocksMsgs(currentSourceMsgs, stripeMsgs));
+  ASSERT_EQ(currentSourceMsgs.size(), 1);
+  ASSERT_EQ(stripeMsgs.size(), targetConfig_.maxNumOfFetchStripes);
+  ASSERT_NFF(dstReplyFetchBlocksMsg(currentSourceMsgs.front()));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("irrelevant_item_data_msg", 0));
+
+  auto stripeRequest = asFetchBlocksMsg(stripeMsgs[0]);
+  const auto stripeMsgSeqNum = stripeRequest->msgSeqNum;
+  stripeRequest->msgSeqNum = stripeMsgSeqNum - 1;
+  ASSERT_NFF(dstReplyFetchBlocksMsg(stripeMsgs[0]));
+  auto stripe = stDelegator_->getStripeManager().getStripeBySource(stripeMsgs[0].to_);
+  ASSERT_NE(stripe, nullptr);
+  ASSERT_FALSE(stripe->completed);
+  ASSERT_EQ(stripe->bytesReceived, 0);
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("irrelevant_item_data_msg", stripe->numOfBlocks()));
+  ASSERT_EQ(stDelegator_->getNextRequiredBlock(), stripeRequest->maxBlockId);
+  ASSERT_TRUE(testedReplicaIf_.sent_messages_.empty());
+
+  // The reply to the latest request is accepted
+  stripeRequest->msgSeqNum = stripeMsgSeqNum;
+  ASSERT_NFF(dstReplyFetchBlocksMsg(stripeMsgs[0]));
+  ASSERT_EQ(stDelegator_->getNextRequiredBlock(), asFetchBlocksMsg(stripeMsgs[1])->maxBlockId);
+
+  // Complete the cycle
+  testedReplicaIf_.sent_messages_.push_front(std::move(stripeMsgs[2]));
+  testedReplicaIf_.sent_messages_.push_front(std::move(stripeMsgs[1]));
+  size_t numOfStripeRequests{0};
+  ASSERT_NFF(dstFetchAllBlocks(numOfStripeRequests));
+  ASSERT_NFF(getReservedPagesStage());
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+}
+
+// A helper source rejects its stripe request: the stripe is cancelled, the helper source is suspended, and the freed
+// slot is used to dispatch a stripe to another helper source
+TEST_F(BcStTest, dstRejectedStripeIsDispatchedToAnotherHelper) {
+  ASSERT_NFF(dstStartStripedFetching());
+  vector<Msg> currentSourceMsgs, stripeMsgs;
+  ASSERT_NFF(dstTakeFetchBlocksMsgs(currentSourceMsgs, stripeMsgs));
+  ASSERT_EQ(currentSourceMsgs.size(), 1);
+  ASSERT_EQ(stripeMsgs.size(), targetConfig_.maxNumOfFetchStripes);
+  const auto rejectingSourceId = stripeMsgs[0].to_;
+  ASSERT_NFF(fakeSrcReplica_->rejectFetchingMsg(RejectFetchingMsg::Reason::BLOCK_NOT_FOUND_IN_STORAGE,
+                                                asFetchBlocksMsg(stripeMsgs[0])->msgSeqNum,
+                                                rejectingSourceId));
+  ASSERT_EQ(stDelegator_->getStripeManager().getStripeBySource(rejectingSourceId), nullptr);
+  ASSERT_TRUE(stDelegator_->getStripeManager().isSuspended(rejectingSourceId, getMonotonicTimeMilli()));
+  vector<Msg> newCurrentSourceMsgs, newStripeMsgs;
+  ASSERT_NFF(dstTakeFetchBlocksMsgs(newCurrentSourceMsgs, newStripeMsgs));
+  ASSERT_TRUE(newCurrentSourceMsgs.empty());
+  ASSERT_EQ(newStripeMsgs.size(), 1);
+  ASSERT_NE(newStripeMsgs.front().to_, rejectingSourceId);
+  ASSERT_NE(newStripeMsgs.front().to_, stripeMsgs[1].to_);
+  ASSERT_NE(newStripeMsgs.front().to_, stripeMsgs[2].to_);
+  ASSERT_EQ(asFetchBlocksMsg(newStripeMsgs.front())->minBlockId, asFetchBlocksMsg(stripeMsgs[2])->maxBlockId + 1);
+
+  // Complete the cycle - the rejected batch is fetched from the current source
+  testedReplicaIf_.sent_messages_.push_back(std::move(currentSourceMsgs.front()));
+  testedReplicaIf_.sent_messages_.push_back(std::move(stripeMsgs[1]));
+  testedReplicaIf_.sent_messages_.push_back(std::move(stripeMsgs[2]));
+  testedReplicaIf_.sent_messages_.push_back(std::move(newStripeMsgs.front()));
+  size_t numOfStripeRequests{0};
+  ASSERT_NFF(dstFetchAllBlocks(numOfStripeRequests));
+  ASSERT_NFF(getReservedPagesStage());
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+}
+
 // Run a full state transfer with 3 cycles
 TEST_F(BcStTest, dstFullStateTransferMultipleCycles) {
   vector<float> nextcycleSizeMultiplier{0.5, 0.25};  // How larger/smaller is the next cycle from the previous one
@@ -1968,6 +2371,39 @@ TEST_F(BcStTest, dstFullStateTransferWithRestarts) {
                                    testState_.maxRequiredBlockId));
 }
 
+// Reserved pages digest of the checkpoints is a Merkle root (ResPagesDigestVersion::MERKLE) on all replicas
+TEST_F(BcStTest, dstFullStateTransferWithMerkleResPagesDigest) {
+  targetConfig_.resPagesDigestVersion = static_cast<uint16_t>(DataStore::ResPagesDigestVersion::MERKLE);
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  ASSERT_NFF(getMissingblocksStage<void>());
+  ASSERT_NFF(getReservedPagesStage());
+  // now validate completion
+  ASSERT_NFF(dstValidateCycleEnd());
+  ASSERT_NFF(compareAppStateblocks(testState_.maxRequiredBlockId - testState_.numBlocksToCollect + 1,
+                                   testState_.maxRequiredBlockId));
+  ASSERT_EQ(datastore_->getCheckpointDesc(testState_.maxRepliedCheckpointNum).resPagesDigestVersion,
+            DataStore::ResPagesDigestVersion::MERKLE);
+}
+
+// Checkpoint summaries with a reserved pages digest version other than the configured one cannot be validated, and are
+// ignored: the destination keeps collecting summaries.
+TEST_F(BcStTest, dstIgnoreCheckpointSummariesOfOtherResPagesDigestVersion) {
+  targetConfig_.resPagesDigestVersion = static_cast<uint16_t>(DataStore::ResPagesDigestVersion::MERKLE);
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(dstStartRunningAndCollecting());
+  // The sources generate their checkpoints with the default version
+  targetConfig_.resPagesDigestVersion = CheckpointSummaryMsg::kDefaultResPagesDigestVersion;
+  ASSERT_NFF(fakeSrcReplica_->replyAskForCheckpointSummariesMsg());
+  ASSERT_EQ(stDelegator_->getFetchingState(), FetchingState::GettingCheckpointSummaries);
+  for (const auto& msg : testedReplicaIf_.sent_messages_) {
+    const auto type = reinterpret_cast<const BCStateTranBaseMsg*>(msg.data_.get())->type;
+    ASSERT_NE(type, MsgType::FetchBlocks);
+    ASSERT_NE(type, MsgType::FetchResPages);
+  }
+}
+
 // Since state is getting missing blocks, replica re-set preffered group and continues without the rejecting source
 TEST_F(BcStTest, dstSetNewPrefferedReplicasOnFetchBlocksMsgRejection) {
   list<uint16_t> rejectReasons{RejectFetchingMsg::Reason::IN_STATE_TRANSFER,
@@ -2128,6 +2564,22 @@ TEST_F(BcStTest, srcHandleAskForCheckpointSummariesMsg) {
   ASSERT_NFF(srcAssertCheckpointSummariesSent(testState_.minRepliedCheckpointNum, testState_.maxRepliedCheckpointNum));
 }
 
+TEST_F(BcStTest, srcHandleAskForCheckpointSummariesMsgWithMerkleResPagesDigest) {
+  testConfig_.testTarget = TestConfig::TestTarget::SOURCE;
+  targetConfig_.resPagesDigestVersion = static_cast<uint16_t>(DataStore::ResPagesDigestVersion::MERKLE);
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(cmnStartRunning());
+  ASSERT_NFF(dataGen_->generateBlocks(appState_, appState_.getGenesisBlockNum() + 1, testState_.maxRequiredBlockId));
+  ASSERT_NFF(dataGen_->generateCheckpointDescriptors(appState_,
+                                                     datastore_,
+                                                     testState_.minRepliedCheckpointNum,
+                                                     testState_.maxRepliedCheckpointNum,
+                                                     stDelegator_->getRvbManager()));
+  fakeDstReplica_->sendAskForCheckpointSummariesMsg(testState_.lastCheckpointKnownToRequester);
+  // Summaries are sent as VersionedCheckpointsSummary, carrying the version
+  ASSERT_NFF(srcAssertCheckpointSummariesSent(testState_.minRepliedCheckpointNum, testState_.maxRepliedCheckpointNum));
+}
+
 TEST_F(BcStTest, srcHandleFetchBlocksMsg) {
   testConfig_.testTarget = TestConfig::TestTarget::SOURCE;
   ASSERT_NFF(initialize());
@@ -2173,6 +2625,140 @@ TEST_F(BcStTest, srcHandleFetchBlocksMsg) {
   ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_overall_on_spot_batches_sent", 1));
 }
 
+// Wire layouts of FetchBlocksMsg and ItemDataMsg as sent by replicas which do not support blocks compression
+#pragma pack(push, 1)
+struct LegacyFetchBlocksMsg {
+  uint16_t type;
+  uint8_t isIncomingMsg_;
+  uint64_t msgSeqNum;
+  uint64_t minBlockId;
+  uint64_t maxBlockId;
+  uint64_t maxBlockIdInCycle;
+  uint64_t rvbGroupId;
+  uint16_t lastKnownChunkInLastRequiredBlock;
+};
+
+struct LegacyItemDataMsg {
+  uint16_t type;
+  uint8_t isIncomingMsg_;
+  uint64_t requestMsgSeqNum;
+  uint64_t blockNumber;
+  uint16_t totalNumberOfChunksInBlock;
+  uint16_t chunkNumber;
+  uint8_t lastInBatch;
+  uint32_t rvbDigestsSize;
+  uint32_t dataSize;
+  char data[1];
+};
+#pragma pack(pop)
+
+TEST(BcStMessagesTest, fetchBlocksMsgCompatibleWithLegacyLayout) {
+  ASSERT_EQ(sizeof(LegacyFetchBlocksMsg), FetchBlocksMsg::sizeWithoutCompressionType());
+
+  // A request of an older destination: no compression requested, no byte is read beyond the legacy message
+  LegacyFetchBlocksMsg legacyMsg{MsgType::FetchBlocks, 0, 7, 10, 20, 30, 2, 3};
+  auto buff = std::make_unique<char[]>(sizeof(FetchBlocksMsg));
+  memset(buff.get(), static_cast<int>(CompressionType::LZ4), sizeof(FetchBlocksMsg));
+  memcpy(buff.get(), &legacyMsg, sizeof(legacyMsg));
+  const auto* msg = reinterpret_cast<const FetchBlocksMsg*>(buff.get());
+  ASSERT_EQ(msg->type, MsgType::FetchBlocks);
+  ASSERT_EQ(msg->msgSeqNum, 7u);
+  ASSERT_EQ(msg->minBlockId, 10u);
+  ASSERT_EQ(msg->maxBlockId, 20u);
+  ASSERT_EQ(msg->maxBlockIdInCycle, 30u);
+  ASSERT_EQ(msg->rvbGroupId, 2u);
+  ASSERT_EQ(msg->lastKnownChunkInLastRequiredBlock, 3);
+  ASSERT_EQ(msg->requestedCompressionType(sizeof(LegacyFetchBlocksMsg)), 0);
+
+  // A request of a newer destination is a legacy message followed by the requested compression
+  FetchBlocksMsg newMsg;
+  newMsg.msgSeqNum = 7;
+  newMsg.maxBlockId = 20;
+  newMsg.compressionType = static_cast<uint8_t>(CompressionType::ZSTD);
+  const auto* asLegacy = reinterpret_cast<const LegacyFetchBlocksMsg*>(&newMsg);
+  ASSERT_EQ(asLegacy->msgSeqNum, 7u);
+  ASSERT_EQ(asLegacy->maxBlockId, 20u);
+  ASSERT_EQ(newMsg.requestedCompressionType(sizeof(FetchBlocksMsg)), static_cast<uint8_t>(CompressionType::ZSTD));
+}
+
+TEST(BcStMessagesTest, itemDataMsgCompatibleWithLegacyLayout) {
+  constexpr size_t dataSize = 100;
+  for (bool compressed : {false, true}) {
+    auto msg = ItemDataMsg::alloc(dataSize, compressed);
+    msg->requestMsgSeqNum = 7;
+    msg->blockNumber = 20;
+    msg->totalNumberOfChunksInBlock = 2;
+    msg->chunkNumber = 1;
+    msg->lastInBatch = 1;
+    msg->rvbDigestsSize = 0;
+    memset(msg->data, 'x', dataSize);
+    if (compressed) {
+      msg->setCompressionInfo(static_cast<uint8_t>(CompressionType::LZ4), 1000);
+    }
+
+    // An uncompressed chunk is byte identical to the legacy message, a compressed one has a trailer and another type
+    const auto legacySize = sizeof(LegacyItemDataMsg) - 1 + dataSize;
+    const auto* asLegacy = reinterpret_cast<const LegacyItemDataMsg*>(msg.getSerializedMsg());
+    ASSERT_EQ(msg->size(), legacySize + (compressed ? sizeof(ItemDataMsg::CompressionInfo) : 0));
+    ASSERT_EQ(asLegacy->type, compressed ? MsgType::CompressedItemData : MsgType::ItemData);
+    ASSERT_EQ(asLegacy->requestMsgSeqNum, 7u);
+    ASSERT_EQ(asLegacy->blockNumber, 20u);
+    ASSERT_EQ(asLegacy->totalNumberOfChunksInBlock, 2);
+    ASSERT_EQ(asLegacy->chunkNumber, 1);
+    ASSERT_EQ(asLegacy->lastInBatch, 1);
+    ASSERT_EQ(asLegacy->dataSize, dataSize);
+    ASSERT_EQ(asLegacy->data[dataSize - 1], 'x');
+    ASSERT_EQ(msg->compressionType(), compressed ? static_cast<uint8_t>(CompressionType::LZ4) : 0);
+    ASSERT_EQ(msg->uncompressedBlockSize(), compressed ? 1000u : 0u);
+  }
+}
+
+TEST(BcStMessagesTest, checkpointSummaryMsgCompatibleWithLegacyLayout) {
+  const std::vector<char> rvbData{'a', 'b', 'c'};
+  // The legacy message has no resPagesDigestVersion: its size (and the requirement of older replicas) is unchanged
+  static_assert(sizeof(CheckpointSummaryMsg) == sizeof(BCStateTranBaseMsg) + 3 * sizeof(uint64_t) +
+                                                    2 * sizeof(Digest) + sizeof(uint32_t) + 1);
+  auto flat = CheckpointSummaryMsg::alloc(rvbData.size());
+  std::copy(rvbData.begin(), rvbData.end(), flat->data);
+  ASSERT_EQ(flat->type, MsgType::CheckpointsSummary);
+  ASSERT_EQ(flat->size(), sizeof(CheckpointSummaryMsg) - 1 + rvbData.size());
+  ASSERT_EQ(flat->resPagesDigestVersion(), CheckpointSummaryMsg::kDefaultResPagesDigestVersion);
+
+  // A non default version follows the RVB data, in a message of another type
+  const auto merkle = static_cast<uint8_t>(DataStore::ResPagesDigestVersion::MERKLE);
+  auto versioned = CheckpointSummaryMsg::alloc(rvbData.size(), merkle);
+  std::copy(rvbData.begin(), rvbData.end(), versioned->data);
+  ASSERT_EQ(versioned->type, MsgType::VersionedCheckpointsSummary);
+  ASSERT_EQ(versioned->size(), flat->size() + sizeof(uint8_t));
+  ASSERT_EQ(versioned->sizeofRvbData(), rvbData.size());
+  ASSERT_EQ(versioned->resPagesDigestVersion(), merkle);
+  ASSERT_EQ(memcmp(versioned->data, rvbData.data(), rvbData.size()), 0);
+  ASSERT_FALSE(CheckpointSummaryMsg::equivalent(flat.operator->(), versioned.operator->()));
+}
+
+// A source with blocks compression enabled serves an older destination: the request without the trailing
+// compressionType is accepted, and blocks are sent raw in plain ItemData messages.
+TEST_F(BcStTest, srcHandleLegacyFetchBlocksMsg) {
+  testConfig_.testTarget = TestConfig::TestTarget::SOURCE;
+  targetConfig_.blockCompressionType = static_cast<uint16_t>(CompressionType::LZ4);
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(cmnStartRunning());
+  ASSERT_NFF(dataGen_->generateBlocks(appState_, appState_.getGenesisBlockNum() + 1, testState_.maxRequiredBlockId));
+  ASSERT_NFF(dataGen_->generateCheckpointDescriptors(appState_,
+                                                     datastore_,
+                                                     testState_.minRepliedCheckpointNum,
+                                                     testState_.maxRepliedCheckpointNum,
+                                                     stDelegator_->getRvbManager()));
+
+  fakeDstReplica_->sendLegacyFetchBlocksMsgs();
+  ASSERT_NFF(fakeDstReplica_->sendFetchBlocksMsg<void>(testState_.minRequiredBlockId, testState_.maxRequiredBlockId));
+  uint64_t maxExpectedBlockId = (testState_.numBlocksToCollect > targetConfig_.maxNumberOfChunksInBatch)
+                                    ? (testState_.minRequiredBlockId + targetConfig_.maxNumberOfChunksInBatch - 1)
+                                    : testState_.maxRequiredBlockId;
+  ASSERT_NFF(srcAssertItemDataMsgBatchSentWithBlocks(testState_.minRequiredBlockId, maxExpectedBlockId));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_overall_batches_sent", 1));
+}
+
 TEST_F(BcStTest, srcRejectFetchBlocksMsgOnRvbGroupDigests) {
   testConfig_.testTarget = TestConfig::TestTarget::SOURCE;
   ASSERT_NFF(initialize());
@@ -2615,6 +3201,57 @@ TEST_F(BcStTest, srcTestSourcePrepareIoContexts) {
                                             src_num_io_contexts_consumed += targetConfig_.maxNumberOfChunksInBatch));
 }
 
+TEST_F(BcStTest, srcReadAheadIntoSourceBlocksCache) {
+  testConfig_.testTarget = TestConfig::TestTarget::SOURCE;
+  targetConfig_.maxNumberOfChunksInBatch = 10;
+  targetConfig_.fetchRangeSize = 10;
+  targetConfig_.sourceBlocksCacheSizeMb = 1;
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(cmnStartRunning());
+  ASSERT_NFF(dataGen_->generateBlocks(appState_, appState_.getGenesisBlockNum() + 1, testState_.maxRequiredBlockId));
+  ASSERT_NFF(dataGen_->generateCheckpointDescriptors(appState_,
+                                                     datastore_,
+                                                     testState_.minRepliedCheckpointNum,
+                                                     testState_.maxRepliedCheckpointNum,
+                                                     stDelegator_->getRvbManager()));
+  const auto batchSize = targetConfig_.maxNumberOfChunksInBatch;
+  const auto& cache = stDelegator_->getSourceBlocksCache();
+  auto assertCached = [&](uint64_t minBlockId, uint64_t maxBlockId) {
+    for (auto blockId = minBlockId; blockId <= maxBlockId; ++blockId) {
+      ASSERT_TRUE(cache.contains(blockId)) << KVLOG(blockId);
+    }
+  };
+
+  // 1) The batch is read on spot and the next one is pre-fetched, both miss the empty cache. The batch after them is
+  // read ahead into the cache, and the blocks sent are kept in it.
+  const auto minBlockId = testState_.minRequiredBlockId;
+  ASSERT_NFF(fakeDstReplica_->sendFetchBlocksMsg<void>(minBlockId, testState_.maxRequiredBlockId));
+  ASSERT_NFF(srcAssertItemDataMsgBatchSentWithBlocks(minBlockId, minBlockId + batchSize - 1));
+  testedReplicaIf_.sent_messages_.clear();
+  stDelegator_->waitForSourceReadAhead();
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_num_blocks_read_ahead", batchSize));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_blocks_cache_misses", 2 * batchSize));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_blocks_cache_hits", 0));
+  ASSERT_NFF(assertCached(minBlockId, minBlockId + batchSize - 1));
+  ASSERT_NFF(assertCached(minBlockId + 2 * batchSize, minBlockId + 3 * batchSize - 1));
+
+  // 2) The pre-fetched batch is sent, and the next one is pre-fetched from the cache
+  ASSERT_NFF(fakeDstReplica_->sendFetchBlocksMsg<void>(minBlockId + batchSize, testState_.maxRequiredBlockId));
+  ASSERT_NFF(srcAssertItemDataMsgBatchSentWithBlocks(minBlockId + batchSize, minBlockId + 2 * batchSize - 1));
+  testedReplicaIf_.sent_messages_.clear();
+  stDelegator_->waitForSourceReadAhead();
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_num_blocks_read_ahead", 2 * batchSize));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_blocks_cache_misses", 2 * batchSize));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_blocks_cache_hits", batchSize));
+  ASSERT_NFF(assertCached(minBlockId + 3 * batchSize, minBlockId + 4 * batchSize - 1));
+
+  // 3) The batch read from the cache is sent with the stored blocks
+  ASSERT_NFF(fakeDstReplica_->sendFetchBlocksMsg<void>(minBlockId + 2 * batchSize, testState_.maxRequiredBlockId));
+  ASSERT_NFF(srcAssertItemDataMsgBatchSentWithBlocks(minBlockId + 2 * batchSize, minBlockId + 3 * batchSize - 1));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_overall_prefetched_batches_sent", 2));
+  ASSERT_NFF(stDelegator_->assertBCStateTranMetricKeyVal("src_blocks_cache_hits", 2 * batchSize));
+}
+
 /////////////////////////////////////////////////////////////////
 //
 //  BcStTest Backup Replica (Initialization, Checkpointing) Tests
@@ -3062,6 +3699,79 @@ TEST_F(BcStTest, bkpTestRvbDataConflictDetection) {
   }
 }
 
+
+// With a Merkle reserved pages digest, the digest kept up to date incrementally across checkpoints is the one computed
+// from scratch over the whole reserved pages descriptor.
+TEST_F(BcStTest, bkpCheckpointingWithMerkleResPagesDigest) {
+  targetConfig_.resPagesDigestVersion = static_cast<uint16_t>(DataStore::ResPagesDigestVersion::MERKLE);
+  ASSERT_NFF(initialize());
+  ASSERT_NFF(cmnStartRunning());
+  ASSERT_NFF(dataGen_->generateBlocks(appState_, appState_.getGenesisBlockNum() + 1, testState_.maxRequiredBlockId));
+  std::unique_ptr<char[]> page(new char[targetConfig_.sizeOfReservedPage]);
+  for (uint64_t i = testState_.minRepliedCheckpointNum; i <= testState_.maxRepliedCheckpointNum; ++i) {
+    // update a few pages between checkpoints
+    for (uint32_t pageId = i % 3; pageId < testConfig_.maxNumberOfUpdatedReservedPages; pageId += 7) {
+      fillRandomBytes(page.get(), targetConfig_.sizeOfReservedPage);
+      stateTransfer_->saveReservedPage(pageId, targetConfig_.sizeOfReservedPage, page.get());
+    }
+    stDelegator_->createCheckpointOfCurrentState(i);
+    ASSERT_TRUE(datastore_->hasCheckpointDesc(i));
+    DataStore::CheckpointDesc desc = datastore_->getCheckpointDesc(i);
+    ASSERT_EQ(desc.resPagesDigestVersion, DataStore::ResPagesDigestVersion::MERKLE);
+    DataStore::ResPagesDescriptor* resPagesDesc = datastore_->getResPagesDescriptor(i);
+    Digest expectedDigest;
+    BCStateTran::computeDigestOfPagesDescriptor(resPagesDesc, expectedDigest, DataStore::ResPagesDigestVersion::MERKLE);
+    datastore_->free(resPagesDesc);
+    ASSERT_EQ(desc.digestOfResPagesDescriptor, expectedDigest);
+  }
+}
+
+// Checkpoint descriptors are persisted with the reserved pages digest version appended. Descriptors persisted before
+// the version was added have none, and are read as ResPagesDigestVersion::FLAT.
+TEST(BcStDataStoreTest, checkpointDescPersistedWithoutResPagesDigestVersion) {
+  concord::storage::IDBClient::ptr dbc(new concord::storage::memorydb::Client());
+  dbc->init();
+  auto keyManip = make_shared<concord::storage::v1DirectKeyValue::STKeyManipulator>();
+  constexpr uint64_t legacyCheckpoint = 5;
+  constexpr uint64_t merkleCheckpoint = 6;
+  DataStore::CheckpointDesc legacyDesc;
+  legacyDesc.checkpointNum = legacyCheckpoint;
+  legacyDesc.maxBlockId = 150;
+  fillRandomBytes(legacyDesc.digestOfMaxBlockId.getForUpdate(), sizeof(Digest));
+  fillRandomBytes(legacyDesc.digestOfResPagesDescriptor.getForUpdate(), sizeof(Digest));
+  legacyDesc.rvbData = {'r', 'v', 'b'};
+
+  // Serialized exactly as by the previous version of DBDataStore
+  std::ostringstream oss;
+  concord::serialize::Serializable::serialize(oss, legacyDesc.checkpointNum);
+  concord::serialize::Serializable::serialize(oss, legacyDesc.maxBlockId);
+  concord::serialize::Serializable::serialize(oss, legacyDesc.digestOfMaxBlockId.get(), DIGEST_SIZE);
+  concord::serialize::Serializable::serialize(oss, legacyDesc.digestOfResPagesDescriptor.get(), DIGEST_SIZE);
+  concord::serialize::Serializable::serialize(oss, legacyDesc.rvbData);
+  ASSERT_TRUE(dbc->put(keyManip->generateSTCheckpointDescriptorKey(legacyCheckpoint), Sliver(oss.str())).isOK());
+  {
+    DBDataStore datastore(dbc, 4096, keyManip, false);
+    DataStore::CheckpointDesc merkleDesc = legacyDesc;
+    merkleDesc.checkpointNum = merkleCheckpoint;
+    merkleDesc.resPagesDigestVersion = DataStore::ResPagesDigestVersion::MERKLE;
+    datastore.setCheckpointDesc(merkleCheckpoint, merkleDesc);
+  }
+
+  DBDataStore datastore(dbc, 4096, keyManip, false);
+  ASSERT_TRUE(datastore.hasCheckpointDesc(legacyCheckpoint));
+  auto desc = datastore.getCheckpointDesc(legacyCheckpoint);
+  ASSERT_EQ(desc.checkpointNum, legacyDesc.checkpointNum);
+  ASSERT_EQ(desc.maxBlockId, legacyDesc.maxBlockId);
+  ASSERT_EQ(desc.digestOfMaxBlockId, legacyDesc.digestOfMaxBlockId);
+  ASSERT_EQ(desc.digestOfResPagesDescriptor, legacyDesc.digestOfResPagesDescriptor);
+  ASSERT_EQ(desc.rvbData, legacyDesc.rvbData);
+  ASSERT_EQ(desc.resPagesDigestVersion, DataStore::ResPagesDigestVersion::FLAT);
+
+  ASSERT_TRUE(datastore.hasCheckpointDesc(merkleCheckpoint));
+  ASSERT_EQ(datastore.getCheckpointDesc(merkleCheckpoint).resPagesDigestVersion,
+            DataStore::ResPagesDigestVersion::MERKLE);
+}
+
 }  // namespace bftEngine::bcst::impl::test
 
 int main(int argc, char** argv) {
@@ -0,0 +1,126 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "BlockCompressor.hpp"
+
+namespace {
+
+using bftEngine::bcst::impl::BlockCompressor;
+using bftEngine::bcst::impl::CompressionType;
+
+const auto compressionTypes = std::vector<CompressionType>{CompressionType::LZ4, CompressionType::ZSTD};
+
+// Looks like a typical application block: repetitive key-value records
+std::vector<char> compressibleBlock(size_t size) {
+  std::vector<char> block;
+  block.reserve(size);
+  for (size_t i = 0; block.size() < size; ++i) {
+    auto record = "{\"key\":\"account_" + std::to_string(i % 1000) + "\",\"value\":" + std::to_string(i * 7) + "},";
+    block.insert(block.end(), record.begin(), record.end());
+  }
+  block.resize(size);
+  return block;
+}
+
+std::vector<char> randomBlock(size_t size) {
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> dist{0, 255};
+  std::vector<char> block(size);
+  for (auto& c : block) {
+    c = static_cast<char>(dist(gen));
+  }
+  return block;
+}
+
+TEST(block_compressor_test, unsupported_type_leaves_block_raw) {
+  auto block = compressibleBlock(BlockCompressor::kSampleSize);
+  const auto original = block;
+  ASSERT_FALSE(BlockCompressor::isSupported(CompressionType::NONE));
+  ASSERT_EQ(BlockCompressor::compress(CompressionType::NONE, block.data(), block.size()), 0U);
+  ASSERT_EQ(block, original);
+}
+
+TEST(block_compressor_test, compress_and_decompress) {
+  for (auto type : compressionTypes) {
+    if (!BlockCompressor::isSupported(type)) continue;
+    // smaller than a sample, and larger than a sample
+    for (size_t size : {4096UL, 4UL * BlockCompressor::kSampleSize + 17}) {
+      auto block = compressibleBlock(size);
+      const auto original = block;
+      auto compressedSize = BlockCompressor::compress(type, block.data(), block.size());
+      ASSERT_GT(compressedSize, 0U);
+      ASSERT_LT(compressedSize, size / 2);
+
+      std::vector<char> decompressed(size);
+      ASSERT_TRUE(BlockCompressor::decompress(type, block.data(), compressedSize, decompressed.data(), size));
+      ASSERT_EQ(decompressed, original);
+    }
+  }
+}
+
+TEST(block_compressor_test, incompressible_block_is_left_raw) {
+  for (auto type : compressionTypes) {
+    if (!BlockCompressor::isSupported(type)) continue;
+    auto block = randomBlock(4 * BlockCompressor::kSampleSize);
+    const auto original = block;
+    ASSERT_EQ(BlockCompressor::compress(type, block.data(), block.size()), 0U);
+    ASSERT_EQ(block, original);
+  }
+}
+
+TEST(block_compressor_test, small_block_is_left_raw) {
+  for (auto type : compressionTypes) {
+    if (!BlockCompressor::isSupported(type)) continue;
+    auto block = compressibleBlock(BlockCompressor::kMinBlockSize - 1);
+    ASSERT_EQ(BlockCompressor::compress(type, block.data(), block.size()), 0U);
+  }
+}
+
+TEST(block_compressor_test, compression_is_deterministic) {
+  for (auto type : compressionTypes) {
+    if (!BlockCompressor::isSupported(type)) continue;
+    auto block1 = compressibleBlock(2 * BlockCompressor::kSampleSize);
+    auto block2 = block1;
+    auto size1 = BlockCompressor::compress(type, block1.data(), block1.size());
+    auto size2 = BlockCompressor::compress(type, block2.data(), block2.size());
+    ASSERT_EQ(size1, size2);
+    ASSERT_EQ(block1, block2);
+  }
+}
+
+TEST(block_compressor_test, bad_data_fails_decompression) {
+  for (auto type : compressionTypes) {
+    if (!BlockCompressor::isSupported(type)) continue;
+    const size_t size = 2 * BlockCompressor::kSampleSize;
+    auto block = compressibleBlock(size);
+    auto compressedSize = BlockCompressor::compress(type, block.data(), block.size());
+    ASSERT_GT(compressedSize, 0U);
+    std::vector<char> decompressed(size);
+
+    // wrong declared size
+    ASSERT_FALSE(BlockCompressor::decompress(type, block.data(), compressedSize, decompressed.data(), size - 1));
+    // truncated data
+    ASSERT_FALSE(BlockCompressor::decompress(type, block.data(), compressedSize / 2, decompressed.data(), size));
+    // garbage
+    auto garbage = randomBlock(compressedSize);
+    ASSERT_FALSE(BlockCompressor::decompress(type, garbage.data(), garbage.size(), decompressed.data(), size));
+  }
+}
+
+}  // namespace
@@ -0,0 +1,92 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#include <cstring>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "ResPagesDigestTree.hpp"
+
+namespace {
+
+using bftEngine::bcst::impl::DataStore;
+using concord::crypto::Digest;
+using bftEngine::bcst::impl::ResPagesDigestTree;
+
+class DescriptorHolder {
+ public:
+  explicit DescriptorHolder(uint32_t numOfPages)
+      : buffer_{new char[DataStore::ResPagesDescriptor::size(numOfPages)]} {
+    memset(buffer_.get(), 0, DataStore::ResPagesDescriptor::size(numOfPages));
+    get()->numOfPages = numOfPages;
+    for (uint32_t i = 0; i < numOfPages; ++i) {
+      get()->d[i].pageId = i;
+    }
+  }
+  DataStore::ResPagesDescriptor* get() { return reinterpret_cast<DataStore::ResPagesDescriptor*>(buffer_.get()); }
+
+ private:
+  std::unique_ptr<char[]> buffer_;
+};
+
+DataStore::SingleResPageDesc pageDesc(uint32_t pageId, uint64_t checkpoint) {
+  DataStore::SingleResPageDesc desc{pageId, checkpoint, Digest{}};
+  auto str = std::to_string(pageId) + ":" + std::to_string(checkpoint);
+  desc.pageDigest = Digest(str.data(), str.size());
+  return desc;
+}
+
+TEST(res_pages_digest_tree_test, incremental_update_equals_rebuild) {
+  for (uint32_t numOfPages : {1U, 2U, 7U, 64U, 1000U}) {
+    DescriptorHolder holder{numOfPages};
+    ResPagesDigestTree tree{numOfPages};
+    tree.build(holder.get());
+    ASSERT_EQ(tree.digest(), ResPagesDigestTree::computeDigest(holder.get()));
+
+    for (uint64_t checkpoint = 1; checkpoint <= 5; ++checkpoint) {
+      for (uint32_t pageId = checkpoint % numOfPages; pageId < numOfPages; pageId += 3) {
+        auto desc = pageDesc(pageId, checkpoint);
+        holder.get()->d[pageId] = desc;
+        tree.update(desc);
+      }
+      ASSERT_EQ(tree.digest(), ResPagesDigestTree::computeDigest(holder.get()));
+    }
+  }
+}
+
+TEST(res_pages_digest_tree_test, digest_depends_on_every_field) {
+  const uint32_t numOfPages = 10;
+  DescriptorHolder holder{numOfPages};
+  for (uint32_t i = 0; i < numOfPages; ++i) {
+    holder.get()->d[i] = pageDesc(i, 1);
+  }
+  const auto digest = ResPagesDigestTree::computeDigest(holder.get());
+
+  holder.get()->d[5].relevantCheckpoint = 2;
+  ASSERT_NE(digest, ResPagesDigestTree::computeDigest(holder.get()));
+  holder.get()->d[5] = pageDesc(5, 1);
+  ASSERT_EQ(digest, ResPagesDigestTree::computeDigest(holder.get()));
+
+  holder.get()->d[9].pageDigest = pageDesc(8, 1).pageDigest;
+  ASSERT_NE(digest, ResPagesDigestTree::computeDigest(holder.get()));
+}
+
+TEST(res_pages_digest_tree_test, digest_depends_on_number_of_pages) {
+  // both descriptors are padded to 4 leaves
+  DescriptorHolder holder1{3};
+  DescriptorHolder holder2{4};
+  ASSERT_NE(ResPagesDigestTree::computeDigest(holder1.get()), ResPagesDigestTree::computeDigest(holder2.get()));
+}
+
+}  // namespace
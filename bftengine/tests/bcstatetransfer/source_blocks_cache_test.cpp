@@ -0,0 +1,119 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "SourceBlocksCache.hpp"
+
+namespace {
+
+using bftEngine::bcst::impl::SourceBlocksCache;
+
+std::string block(uint64_t blockId, size_t size) {
+  auto str = std::to_string(blockId);
+  std::string res;
+  while (res.size() < size) res += str;
+  res.resize(size);
+  return res;
+}
+
+std::string get(SourceBlocksCache& cache, uint64_t blockId) {
+  std::vector<char> buffer(1024);
+  uint32_t actualSize{0};
+  if (!cache.get(blockId, buffer.data(), buffer.size(), &actualSize)) {
+    return "";
+  }
+  return std::string(buffer.data(), actualSize);
+}
+
+TEST(source_blocks_cache_test, put_and_get) {
+  SourceBlocksCache cache{1024};
+  ASSERT_FALSE(cache.contains(1));
+  ASSERT_EQ(get(cache, 1), "");
+
+  cache.put(1, block(1, 100).data(), 100);
+  cache.put(2, block(2, 200).data(), 200);
+  ASSERT_TRUE(cache.contains(1));
+  ASSERT_EQ(get(cache, 1), block(1, 100));
+  ASSERT_EQ(get(cache, 2), block(2, 200));
+  ASSERT_EQ(cache.numOfBlocks(), 2U);
+  ASSERT_EQ(cache.sizeBytes(), 300U);
+
+  // blocks are immutable, a second put does not change the block
+  cache.put(1, block(3, 50).data(), 50);
+  ASSERT_EQ(get(cache, 1), block(1, 100));
+  ASSERT_EQ(cache.sizeBytes(), 300U);
+
+  cache.clear();
+  ASSERT_EQ(cache.numOfBlocks(), 0U);
+  ASSERT_EQ(cache.sizeBytes(), 0U);
+  ASSERT_FALSE(cache.contains(1));
+}
+
+TEST(source_blocks_cache_test, least_recently_used_blocks_are_evicted) {
+  SourceBlocksCache cache{1000};
+  for (uint64_t id = 1; id <= 4; ++id) {
+    cache.put(id, block(id, 250).data(), 250);
+  }
+  ASSERT_EQ(cache.sizeBytes(), 1000U);
+
+  // block 1 is now the most recently used, so 2 and 3 are evicted to make room
+  ASSERT_EQ(get(cache, 1), block(1, 250));
+  cache.put(5, block(5, 400).data(), 400);
+  ASSERT_TRUE(cache.contains(1));
+  ASSERT_FALSE(cache.contains(2));
+  ASSERT_FALSE(cache.contains(3));
+  ASSERT_TRUE(cache.contains(4));
+  ASSERT_TRUE(cache.contains(5));
+  ASSERT_LE(cache.sizeBytes(), cache.maxSizeBytes());
+}
+
+TEST(source_blocks_cache_test, block_larger_than_cache_is_ignored) {
+  SourceBlocksCache cache{100};
+  cache.put(1, block(1, 50).data(), 50);
+  cache.put(2, block(2, 101).data(), 101);
+  ASSERT_FALSE(cache.contains(2));
+  ASSERT_TRUE(cache.contains(1));
+}
+
+TEST(source_blocks_cache_test, small_output_buffer_throws) {
+  SourceBlocksCache cache{1000};
+  cache.put(1, block(1, 100).data(), 100);
+  std::vector<char> buffer(99);
+  uint32_t actualSize{0};
+  ASSERT_THROW(cache.get(1, buffer.data(), buffer.size(), &actualSize), std::runtime_error);
+}
+
+TEST(source_blocks_cache_test, concurrent_put_and_get) {
+  SourceBlocksCache cache{10 * 1024};
+  const uint64_t numOfBlocks = 1000;
+  std::thread writer([&]() {
+    for (uint64_t id = 1; id <= numOfBlocks; ++id) {
+      cache.put(id, block(id, 100).data(), 100);
+    }
+  });
+  for (uint64_t id = 1; id <= numOfBlocks; ++id) {
+    auto res = get(cache, id);
+    ASSERT_TRUE(res.empty() || (res == block(id, 100)));
+  }
+  writer.join();
+  ASSERT_LE(cache.sizeBytes(), cache.maxSizeBytes());
+  ASSERT_TRUE(cache.contains(numOfBlocks));
+}
+
+}  // namespace
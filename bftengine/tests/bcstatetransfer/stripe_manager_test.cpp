@@ -0,0 +1,241 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#include <map>
+
+#include "gtest/gtest.h"
+
+#include "log/logger.hpp"
+#include "StripeManager.hpp"
+
+namespace {
+
+using bftEngine::bcst::impl::StripeManager;
+using bftEngine::bcst::impl::StripeCancelReason;
+using bftEngine::bcst::impl::Stripe;
+using bftEngine::bcst::impl::NO_REPLICA;
+
+constexpr uint16_t kMaxNumOfStripes = 3;
+constexpr uint32_t kInactivityTimeoutMs = 2000;
+constexpr uint32_t kSuspensionTimeMs = 4000;
+constexpr uint64_t kSampleCurrentTimeMs = 1000;
+constexpr uint64_t kBlocksInBatch = 16;
+constexpr uint32_t kBatchSizeBytes = 1024 * 1024;
+
+const auto replicas = std::set<uint16_t>{1, 2, 3};
+
+class StripeManagerTestFixture : public ::testing::Test {
+ public:
+  StripeManagerTestFixture() : stripe_manager(kMaxNumOfStripes, kInactivityTimeoutMs, kSuspensionTimeMs, GL){};
+
+ protected:
+  // Assign the batch to a source and fetch it completely within durationMs
+  void fetchStripe(uint16_t sourceId, uint64_t batchNum, uint64_t startTimeMs, uint64_t durationMs) {
+    auto minBlockId = batchNum * kBlocksInBatch + 1;
+    stripe_manager.addStripe(minBlockId, minBlockId + kBlocksInBatch - 1, sourceId, batchNum + 1, startTimeMs);
+    stripe_manager.onDataReceived(sourceId, kBatchSizeBytes, startTimeMs + durationMs);
+    stripe_manager.onStripeCompleted(sourceId, startTimeMs + durationMs);
+  }
+
+  StripeManager stripe_manager;
+};
+
+TEST_F(StripeManagerTestFixture, no_stripes_on_construction) {
+  ASSERT_TRUE(stripe_manager.empty());
+  ASSERT_TRUE(stripe_manager.hasCapacity());
+  ASSERT_EQ(stripe_manager.maxStripedBlockId(), 0);
+}
+
+TEST_F(StripeManagerTestFixture, capacity_is_limited_by_max_num_of_stripes) {
+  for (uint16_t i = 0; i < kMaxNumOfStripes; ++i) {
+    ASSERT_TRUE(stripe_manager.hasCapacity());
+    auto sourceId = stripe_manager.selectSource(replicas, kSampleCurrentTimeMs);
+    ASSERT_NE(sourceId, NO_REPLICA);
+    stripe_manager.addStripe(i * kBlocksInBatch + 1, (i + 1) * kBlocksInBatch, sourceId, i + 1, kSampleCurrentTimeMs);
+  }
+  ASSERT_FALSE(stripe_manager.hasCapacity());
+  ASSERT_EQ(stripe_manager.numOfStripes(), kMaxNumOfStripes);
+  ASSERT_EQ(stripe_manager.maxStripedBlockId(), kMaxNumOfStripes * kBlocksInBatch);
+}
+
+TEST_F(StripeManagerTestFixture, busy_source_is_not_selected) {
+  stripe_manager.addStripe(1, kBlocksInBatch, 1, 1, kSampleCurrentTimeMs);
+  ASSERT_EQ(stripe_manager.selectSource({1}, kSampleCurrentTimeMs), NO_REPLICA);
+  ASSERT_EQ(stripe_manager.selectSource({1, 2}, kSampleCurrentTimeMs), 2);
+  ASSERT_NE(stripe_manager.getStripeBySource(1), nullptr);
+  ASSERT_NE(stripe_manager.getStripeByRange(1, kBlocksInBatch), nullptr);
+  ASSERT_EQ(stripe_manager.getStripeByRange(1, kBlocksInBatch + 1), nullptr);
+}
+
+TEST_F(StripeManagerTestFixture, unexplored_source_is_selected_first) {
+  fetchStripe(1, 0, kSampleCurrentTimeMs, 100);
+  stripe_manager.onStripeConsumed(1);
+  ASSERT_EQ(stripe_manager.selectSource({1, 2}, kSampleCurrentTimeMs + 100), 2);
+}
+
+TEST_F(StripeManagerTestFixture, fastest_source_is_preferred) {
+  fetchStripe(1, 0, kSampleCurrentTimeMs, 200);
+  fetchStripe(2, 1, kSampleCurrentTimeMs, 100);
+  fetchStripe(3, 2, kSampleCurrentTimeMs, 150);
+  for (auto id : replicas) stripe_manager.onStripeConsumed(id);
+  ASSERT_GT(stripe_manager.getSourceThroughput(2), stripe_manager.getSourceThroughput(3));
+  ASSERT_GT(stripe_manager.getSourceThroughput(3), stripe_manager.getSourceThroughput(1));
+  ASSERT_EQ(stripe_manager.selectSource(replicas, kSampleCurrentTimeMs + 200), 2);
+  ASSERT_EQ(stripe_manager.selectSource({1, 3}, kSampleCurrentTimeMs + 200), 3);
+}
+
+TEST_F(StripeManagerTestFixture, slow_source_is_suspended_for_a_while) {
+  fetchStripe(1, 0, kSampleCurrentTimeMs, 100);
+  fetchStripe(2, 1, kSampleCurrentTimeMs, 1000);
+  stripe_manager.onStripeConsumed(1);
+  stripe_manager.onStripeConsumed(2);
+  auto now = kSampleCurrentTimeMs + 1000;
+  ASSERT_TRUE(stripe_manager.isSuspended(2, now));
+  ASSERT_EQ(stripe_manager.selectSource({2}, now), NO_REPLICA);
+  // suspension is over - source is explored again
+  now += kSuspensionTimeMs;
+  ASSERT_FALSE(stripe_manager.isSuspended(2, now));
+  ASSERT_EQ(stripe_manager.selectSource({2}, now), 2);
+}
+
+TEST_F(StripeManagerTestFixture, source_which_sent_bad_data_is_excluded_until_reset) {
+  stripe_manager.addStripe(1, kBlocksInBatch, 1, 1, kSampleCurrentTimeMs);
+  stripe_manager.cancelStripe(1, StripeCancelReason::BAD_DATA, kSampleCurrentTimeMs);
+  ASSERT_TRUE(stripe_manager.empty());
+  ASSERT_TRUE(stripe_manager.isExcluded(1));
+  ASSERT_EQ(stripe_manager.selectSource({1}, kSampleCurrentTimeMs + 10 * kSuspensionTimeMs), NO_REPLICA);
+  stripe_manager.reset();
+  ASSERT_EQ(stripe_manager.selectSource({1}, kSampleCurrentTimeMs), 1);
+}
+
+TEST_F(StripeManagerTestFixture, source_which_rejected_is_suspended) {
+  stripe_manager.addStripe(1, kBlocksInBatch, 1, 1, kSampleCurrentTimeMs);
+  stripe_manager.cancelStripe(1, StripeCancelReason::REJECTED, kSampleCurrentTimeMs);
+  ASSERT_FALSE(stripe_manager.isExcluded(1));
+  ASSERT_TRUE(stripe_manager.isSuspended(1, kSampleCurrentTimeMs));
+  ASSERT_EQ(stripe_manager.selectSource({1}, kSampleCurrentTimeMs + kSuspensionTimeMs), 1);
+}
+
+TEST_F(StripeManagerTestFixture, stale_stripe_cancellation_has_no_penalty) {
+  stripe_manager.addStripe(1, kBlocksInBatch, 1, 1, kSampleCurrentTimeMs);
+  stripe_manager.cancelStripe(1, StripeCancelReason::STALE, kSampleCurrentTimeMs);
+  ASSERT_TRUE(stripe_manager.empty());
+  ASSERT_EQ(stripe_manager.selectSource({1}, kSampleCurrentTimeMs), 1);
+}
+
+TEST_F(StripeManagerTestFixture, inactive_stripes_are_detected) {
+  stripe_manager.addStripe(1, kBlocksInBatch, 1, 1, kSampleCurrentTimeMs);
+  stripe_manager.addStripe(kBlocksInBatch + 1, 2 * kBlocksInBatch, 2, 2, kSampleCurrentTimeMs);
+  stripe_manager.onDataReceived(2, 1024, kSampleCurrentTimeMs + kInactivityTimeoutMs);
+  auto inactive = stripe_manager.getInactiveStripesSources(kSampleCurrentTimeMs + kInactivityTimeoutMs + 1);
+  ASSERT_EQ(inactive, std::vector<uint16_t>{1});
+}
+
+TEST_F(StripeManagerTestFixture, slow_stripe_is_late_when_waited_for) {
+  fetchStripe(1, 0, kSampleCurrentTimeMs, 100);
+  stripe_manager.onStripeConsumed(1);
+  // source 2 is active, but ~100 times slower than source 1
+  auto &stripe = stripe_manager.addStripe(kBlocksInBatch + 1, 2 * kBlocksInBatch, 2, 2, kSampleCurrentTimeMs);
+  auto waitingSince = kSampleCurrentTimeMs + 100;
+  auto now = waitingSince + kInactivityTimeoutMs / 2;
+  stripe_manager.onDataReceived(2, kBatchSizeBytes / 200, now);
+  ASSERT_FALSE(stripe_manager.isStripeLate(stripe, waitingSince, now));
+  now = waitingSince + kInactivityTimeoutMs + 1;
+  stripe_manager.onDataReceived(2, kBatchSizeBytes / 200, now);
+  ASSERT_TRUE(stripe_manager.isStripeLate(stripe, waitingSince, now));
+}
+
+// Simulate fetching a range of batches, from a current source and from helper sources with heterogeneous speeds.
+// Batches are consumed in order: the current batch is fetched by the current source unless it is already fetched by a
+// stripe, while a window of kMaxNumOfStripes batches ahead of it is fetched from the helper sources in parallel.
+// Compare to fetching all batches one after the other from the current source only.
+TEST_F(StripeManagerTestFixture, striped_fetching_throughput_with_heterogeneous_sources) {
+  constexpr uint64_t kNumOfBatches = 60;
+  constexpr uint64_t kTickMs = 10;
+  constexpr uint16_t kCurrentSource = 0;
+  // Bytes per millisecond
+  const std::map<uint16_t, uint64_t> sourcesSpeed{{kCurrentSource, 500}, {1, 1000}, {2, 500}, {3, 20}};
+  const auto helpers = replicas;
+
+  std::map<uint16_t, uint64_t> batchesServed;
+  std::map<uint64_t, uint16_t> batchToHelper;
+  uint64_t nextBatchToConsume = 0;
+  uint64_t currentSourceBytes = 0;
+  uint64_t waitingSince = 0;
+  uint64_t now = kSampleCurrentTimeMs;
+
+  while (nextBatchToConsume < kNumOfBatches) {
+    // Fill the stripes window, beyond the current batch
+    const auto windowEnd = std::min(nextBatchToConsume + kMaxNumOfStripes + 1, kNumOfBatches);
+    for (uint64_t batch = nextBatchToConsume + 1; (batch < windowEnd) && stripe_manager.hasCapacity(); ++batch) {
+      if (batchToHelper.count(batch)) continue;
+      auto sourceId = stripe_manager.selectSource(helpers, now);
+      if (sourceId == NO_REPLICA) break;
+      stripe_manager.addStripe(batch * kBlocksInBatch + 1, (batch + 1) * kBlocksInBatch, sourceId, batch + 1, now);
+      batchToHelper[batch] = sourceId;
+    }
+
+    // Sources send data
+    now += kTickMs;
+    std::vector<uint16_t> completed;
+    for (const auto &[id, stripe] : stripe_manager.getStripes()) {
+      if (stripe.completed) continue;
+      auto bytes = std::min<uint64_t>(sourcesSpeed.at(id) * kTickMs, kBatchSizeBytes - stripe.bytesReceived);
+      stripe_manager.onDataReceived(id, bytes, now);
+      if (stripe.bytesReceived == kBatchSizeBytes) completed.push_back(id);
+    }
+    for (auto id : completed) stripe_manager.onStripeCompleted(id, now);
+
+    // Consume in order
+    while (nextBatchToConsume < kNumOfBatches) {
+      auto it = batchToHelper.find(nextBatchToConsume);
+      if (it != batchToHelper.end()) {
+        auto stripe = stripe_manager.getStripeBySource(it->second);
+        ASSERT_NE(stripe, nullptr);
+        if (!stripe->completed) {
+          if (waitingSince == 0) waitingSince = now;
+          if (!stripe_manager.isStripeLate(*stripe, waitingSince, now)) break;
+          // Fetch it from the current source instead
+          stripe_manager.cancelStripe(it->second, StripeCancelReason::TIMEOUT, now);
+          batchToHelper.erase(it);
+          continue;
+        }
+        ++batchesServed[it->second];
+        stripe_manager.onStripeConsumed(it->second);
+        batchToHelper.erase(it);
+      } else {
+        currentSourceBytes += sourcesSpeed.at(kCurrentSource) * kTickMs;
+        if (currentSourceBytes < kBatchSizeBytes) break;
+        currentSourceBytes = 0;
+        ++batchesServed[kCurrentSource];
+      }
+      ++nextBatchToConsume;
+      waitingSince = 0;
+    }
+  }
+
+  const uint64_t stripedDurationMs = now - kSampleCurrentTimeMs;
+  const uint64_t singleSourceDurationMs = kNumOfBatches * kBatchSizeBytes / sourcesSpeed.at(kCurrentSource);
+  LOG_INFO(GL,
+           KVLOG(stripedDurationMs,
+                 singleSourceDurationMs,
+                 batchesServed[kCurrentSource],
+                 batchesServed[1],
+                 batchesServed[2],
+                 batchesServed[3]));
+  ASSERT_LT(stripedDurationMs * 2, singleSourceDurationMs);
+  ASSERT_GE(batchesServed[1], batchesServed[2]);
+  ASSERT_GT(batchesServed[2], batchesServed[3]);
+}
+
+}  // namespace
@@ -1116,6 +1116,41 @@ TEST(ClientsManager, infoOfEarliestPendingRequest) {
                                  "string for a ClientsManager that should have had only committed request records.";
 }
 
+TEST(ClientsManager, infoOfEarliestPendingRequestAfterRemovals) {
+  resetMockReservedPages();
+
+  unique_ptr<ClientsManager> cm(new ClientsManager({7}, {6, 8, 12}, {}, {9}, metrics));
+  cm->addPendingRequest(12, 2, "removed correlation ID");
+  cm->addPendingRequest(8, 3, "cleared correlation ID");
+  cm->addPendingRequest(6, 4, "latest correlation ID");
+
+  string observed_cid;
+  cm->removePendingForExecutionRequest(12, 2);
+  cm->infoOfEarliestPendingRequest(observed_cid);
+  EXPECT_EQ(observed_cid, "cleared correlation ID")
+      << "ClientsManager::infoOfEarliestPendingRequest returned the CID of a request which was removed for execution.";
+
+  // Removing a request which doesn't exist or marking it as committed twice has no effect
+  cm->removePendingForExecutionRequest(12, 2);
+  cm->markRequestAsCommitted(8, 3);
+  cm->markRequestAsCommitted(8, 3);
+  cm->removePendingForExecutionRequest(8, 3);
+  cm->infoOfEarliestPendingRequest(observed_cid);
+  EXPECT_EQ(observed_cid, "latest correlation ID")
+      << "ClientsManager::infoOfEarliestPendingRequest did not return the CID of the only pending request.";
+
+  cm->clearAllPendingRequests();
+  EXPECT_EQ(cm->infoOfEarliestPendingRequest(observed_cid), MaxTime)
+      << "ClientsManager::infoOfEarliestPendingRequest returned a time other than MaxTime after all pending requests "
+         "were cleared.";
+  EXPECT_EQ(observed_cid, "");
+
+  // Requests can be added again after they were cleared
+  cm->addPendingRequest(8, 3, "re-added correlation ID");
+  cm->infoOfEarliestPendingRequest(observed_cid);
+  EXPECT_EQ(observed_cid, "re-added correlation ID");
+}
+
 TEST(ClientsManager, logAllPendingRequestsExceedingThreshold) {
   resetMockReservedPages();
 
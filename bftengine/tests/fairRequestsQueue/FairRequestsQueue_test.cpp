@@ -0,0 +1,157 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the sub-component's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+#include "FairRequestsQueue.hpp"
+
+#include <map>
+#include <vector>
+
+using namespace bftEngine::impl;
+
+namespace {
+
+struct Request {
+  Request(uint16_t clientId, uint32_t reqSize, int seqNum) : clientId_{clientId}, size_{reqSize}, seqNum_{seqNum} {}
+  uint16_t clientProxyId() const { return clientId_; }
+  uint32_t size() const { return size_; }
+
+  uint16_t clientId_;
+  uint32_t size_;
+  int seqNum_;
+};
+
+using Queue = FairRequestsQueue<Request>;
+
+const uint32_t kQuantum = 100;
+
+void push(Queue& queue, uint16_t clientId, uint32_t reqSize, int seqNum) {
+  ASSERT_TRUE(queue.push(std::make_unique<Request>(clientId, reqSize, seqNum)));
+}
+
+// Pops all requests and returns their client IDs in the order they were served
+std::vector<uint16_t> popAll(Queue& queue) {
+  std::vector<uint16_t> clients;
+  while (!queue.empty()) {
+    clients.push_back(queue.front()->clientProxyId());
+    queue.pop();
+  }
+  return clients;
+}
+
+TEST(FairRequestsQueue, empty_queue) {
+  Queue queue{kQuantum, 0};
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(queue.front(), nullptr);
+  queue.pop();
+  ASSERT_EQ(queue.size(), 0u);
+}
+
+TEST(FairRequestsQueue, single_client_is_fifo) {
+  Queue queue{kQuantum, 0};
+  for (int i = 0; i < 10; ++i) {
+    push(queue, 1, 10 * (i + 1), i);
+  }
+  ASSERT_EQ(queue.size(), 10u);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(queue.front()->seqNum_, i);
+    queue.pop();
+  }
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(FairRequestsQueue, chatty_client_does_not_starve_others) {
+  Queue queue{kQuantum, 0};
+  for (int i = 0; i < 100; ++i) {
+    push(queue, 1, kQuantum, i);
+  }
+  push(queue, 2, kQuantum, 0);
+  push(queue, 3, kQuantum, 0);
+  ASSERT_EQ(queue.numOfActiveClients(), 3u);
+
+  const auto clients = popAll(queue);
+  ASSERT_EQ(clients.size(), 102u);
+  // The quiet clients are served in the first round rather than after the chatty one
+  ASSERT_EQ(clients[0], 1);
+  ASSERT_EQ(clients[1], 2);
+  ASSERT_EQ(clients[2], 3);
+  ASSERT_EQ(queue.numOfActiveClients(), 0u);
+}
+
+TEST(FairRequestsQueue, share_is_by_bytes) {
+  Queue queue{kQuantum, 0};
+  // Client 1 sends small requests - 4 of them fit in a quantum
+  for (int i = 0; i < 8; ++i) {
+    push(queue, 1, kQuantum / 4, i);
+  }
+  for (int i = 0; i < 2; ++i) {
+    push(queue, 2, kQuantum, i);
+  }
+  const auto clients = popAll(queue);
+  ASSERT_EQ(clients, (std::vector<uint16_t>{1, 1, 1, 1, 2, 1, 1, 1, 1, 2}));
+}
+
+TEST(FairRequestsQueue, large_requests_accumulate_deficit) {
+  Queue queue{kQuantum, 0};
+  // Client 1's request needs 3 turns
+  push(queue, 1, 3 * kQuantum, 0);
+  for (int i = 0; i < 5; ++i) {
+    push(queue, 2, kQuantum, i);
+  }
+  const auto clients = popAll(queue);
+  ASSERT_EQ(clients, (std::vector<uint16_t>{2, 2, 1, 2, 2, 2}));
+}
+
+TEST(FairRequestsQueue, weights) {
+  Queue queue{kQuantum, 0, {{1, 3}}};
+  for (int i = 0; i < 6; ++i) {
+    push(queue, 1, kQuantum, i);
+    push(queue, 2, kQuantum, i);
+  }
+  const auto clients = popAll(queue);
+  ASSERT_EQ(clients, (std::vector<uint16_t>{1, 1, 1, 2, 1, 1, 1, 2, 2, 2, 2, 2}));
+}
+
+TEST(FairRequestsQueue, bounded_client_queue) {
+  Queue queue{kQuantum, 2};
+  push(queue, 1, 10, 0);
+  push(queue, 1, 10, 1);
+  ASSERT_TRUE(queue.isClientQueueFull(1));
+  auto req = std::make_unique<Request>(1, 10, 2);
+  ASSERT_FALSE(queue.push(std::move(req)));
+  // The rejected request stays with the caller
+  ASSERT_NE(req, nullptr);
+
+  // Other clients are not affected
+  ASSERT_FALSE(queue.isClientQueueFull(2));
+  push(queue, 2, 10, 0);
+  ASSERT_EQ(queue.size(1), 2u);
+  ASSERT_EQ(queue.size(2), 1u);
+  ASSERT_EQ(queue.size(), 3u);
+
+  queue.pop();
+  ASSERT_FALSE(queue.isClientQueueFull(1));
+  ASSERT_TRUE(queue.push(std::move(req)));
+}
+
+TEST(FairRequestsQueue, clear) {
+  Queue queue{kQuantum, 0};
+  push(queue, 1, 10, 0);
+  push(queue, 2, 10, 0);
+  queue.clear();
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(queue.front(), nullptr);
+  ASSERT_EQ(queue.size(1), 0u);
+  push(queue, 2, 10, 1);
+  ASSERT_EQ(queue.front()->seqNum_, 1);
+}
+
+}  // namespace
@@ -0,0 +1,467 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+
+#include "IncomingMsgsStorageImp.hpp"
+#include "MsgHandlersRegistrator.hpp"
+#include "MsgsCommunicator.hpp"
+#include "PersistentStorageImp.hpp"
+#include "ReplicaBase.hpp"
+#include "ReplicasInfo.hpp"
+#include "communication/ICommunication.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tests of the group commit of the consensus metadata (ReplicaConfig::groupCommitMetadata): the deferred commits of
+// PersistentStorageImp, the "batch done" handler called by the dispatcher, and the outgoing messages held by
+// ReplicaBase until the covering commit. The handlers registered here do what ReplicaImp does, while the deferred
+// commits are tested against the real PersistentStorageImp, including its use by other threads.
+
+namespace {
+
+using namespace bftEngine;
+using namespace bftEngine::impl;
+using namespace bft::communication;
+using namespace std::chrono_literals;
+
+constexpr uint16_t kNumReplicas = 4;
+constexpr uint16_t kMsgType = 1;
+
+// In-memory metadata storage, which records the commits of write-only batches and the atomic writes
+class TestMetadataStorage : public MetadataStorage {
+ public:
+  bool initMaxSizeOfObjects(const std::map<uint32_t, ObjectDesc>&, uint32_t) override { return true; }
+  bool isNewStorage() override { return committed_.empty(); }
+
+  void read(uint32_t objectId, uint32_t bufferSize, char* outBufferForObject, uint32_t& outActualObjectSize) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    outActualObjectSize = 0;
+    auto* objects = (batch_ && batch_->count(objectId)) ? &*batch_ : &committed_;
+    auto it = objects->find(objectId);
+    if (it == objects->end()) return;
+    outActualObjectSize = std::min<uint32_t>(it->second.size(), bufferSize);
+    memcpy(outBufferForObject, it->second.data(), outActualObjectSize);
+  }
+
+  void atomicWrite(uint32_t objectId, const char* data, uint32_t dataLength) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    committed_[objectId].assign(data, dataLength);
+    ops_.push_back("atomicWrite");
+  }
+
+  void beginAtomicWriteOnlyBatch() override {
+    std::lock_guard<std::mutex> lock(lock_);
+    ASSERT_FALSE(batch_);
+    batch_.emplace();
+  }
+
+  void writeInBatch(uint32_t objectId, const char* data, uint32_t dataLength) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    ASSERT_TRUE(batch_);
+    (*batch_)[objectId].assign(data, dataLength);
+  }
+
+  void commitAtomicWriteOnlyBatch(bool sync) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    ASSERT_TRUE(batch_);
+    for (auto& [id, data] : *batch_) committed_[id] = std::move(data);
+    batch_.reset();
+    ops_.push_back(sync ? "commit(sync)" : "commit");
+  }
+
+  void eraseData() override {
+    std::lock_guard<std::mutex> lock(lock_);
+    committed_.clear();
+  }
+
+  void atomicWriteArbitraryObject(const std::string&, const char*, uint32_t) override {}
+
+  std::vector<std::string> ops() const {
+    std::lock_guard<std::mutex> lock(lock_);
+    return ops_;
+  }
+
+  void clearOps() {
+    std::lock_guard<std::mutex> lock(lock_);
+    ops_.clear();
+  }
+
+  bool isCommitted(uint32_t objectId) const {
+    std::lock_guard<std::mutex> lock(lock_);
+    return committed_.count(objectId) > 0;
+  }
+
+  // The committed last executed sequence number
+  SeqNum lastExecutedSeqNum() const {
+    std::lock_guard<std::mutex> lock(lock_);
+    SeqNum seqNum = 0;
+    auto it = committed_.find(LAST_EXEC_SEQ_NUM);
+    if (it != committed_.end()) memcpy(&seqNum, it->second.data(), sizeof(seqNum));
+    return seqNum;
+  }
+
+ private:
+  mutable std::mutex lock_;
+  std::map<uint32_t, std::string> committed_;
+  std::optional<std::map<uint32_t, std::string>> batch_;
+  std::vector<std::string> ops_;
+};
+
+// Records the messages that are sent
+class TestComm : public ICommunication {
+ public:
+  int getMaxMessageSize() override { return 64 * 1024; }
+  int start() override { return 0; }
+  int stop() override { return 0; }
+  bool isRunning() const override { return true; }
+  ConnectionStatus getCurrentConnectionStatus(NodeNum) override { return ConnectionStatus::Connected; }
+  int send(NodeNum destNode, std::vector<uint8_t>&& msg, NodeNum) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    sent_.push_back({{destNode}, std::move(msg)});
+    return 0;
+  }
+  std::set<NodeNum> send(std::set<NodeNum> dests, std::vector<uint8_t>&& msg, NodeNum) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    sent_.push_back({std::move(dests), std::move(msg)});
+    return {};
+  }
+  void setReceiver(NodeNum, IReceiver*) override {}
+  void restartCommunication(NodeNum) override {}
+
+  struct Sent {
+    std::set<NodeNum> dests;
+    std::vector<uint8_t> data;
+  };
+  std::vector<Sent> sent() const {
+    std::lock_guard<std::mutex> lock(lock_);
+    return sent_;
+  }
+
+ private:
+  mutable std::mutex lock_;
+  std::vector<Sent> sent_;
+};
+
+class TestReplicaConfig : public ReplicaConfig {
+ public:
+  TestReplicaConfig() {
+    numReplicas = kNumReplicas;
+    fVal = 1;
+    cVal = 0;
+    replicaId = 0;
+  }
+};
+
+class TestReplica : public ReplicaBase {
+ public:
+  TestReplica(const ReplicaConfig& config,
+              std::shared_ptr<MsgsCommunicator> comm,
+              std::shared_ptr<MsgHandlersRegistrator> handlers,
+              concordUtil::Timers& timers)
+      : ReplicaBase(config, nullptr, comm, handlers, timers), replicasInfo_(config, false, false) {
+    repsInfo = &replicasInfo_;
+  }
+
+  bool isReadOnly() const override { return false; }
+
+  using ReplicaBase::releaseOutgoingMsgs;
+  using ReplicaBase::send;
+  using ReplicaBase::sendToAllOtherReplicas;
+
+  // As in ReplicaImp, messages are held while there are deferred metadata writes, unless `ps` is not set
+  bool holdOutgoingMsgs() const override { return ps ? ps->hasDeferredWrites() : hold.load(); }
+  std::atomic_bool hold{false};
+  PersistentStorage* ps = nullptr;
+
+ protected:
+  void onReportAboutInvalidMessage(MessageBase*, const char*) override {}
+
+ private:
+  ReplicasInfo replicasInfo_;
+};
+
+std::vector<uint8_t> bytesOf(const MessageBase& m) { return std::vector<uint8_t>(m.body(), m.body() + m.size()); }
+
+class group_commit_test : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto metadata = std::make_unique<TestMetadataStorage>();
+    metadata_ = metadata.get();
+    ps_.init(std::move(metadata));
+    metadata_->clearOps();
+    replica_.ps = &ps_;
+  }
+
+  std::unique_ptr<MessageBase> newMsg(uint16_t type = kMsgType) const {
+    return std::make_unique<MessageBase>(config_.replicaId, type, sizeof(MessageBase::Header));
+  }
+
+  // Executes the next sequence number in a write transaction, and sends a message that depends on it
+  void execute() {
+    ps_.beginWriteTran();
+    ps_.setLastExecutedSeqNum(++executed_);
+    ps_.endWriteTran(true);
+    auto m = newMsg(static_cast<uint16_t>(kMsgType + executed_));
+    replica_.send(m.get(), 1);
+  }
+
+  // The batch done handler of ReplicaImp
+  void onMsgsBatchDone() {
+    if (ps_.hasDeferredWrites()) ps_.commitDeferredWrites();
+    replica_.releaseOutgoingMsgs();
+  }
+
+  template <typename Pred>
+  static bool waitFor(Pred pred) {
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (!pred() && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(1ms);
+    }
+    return pred();
+  }
+
+  TestReplicaConfig config_;
+  TestComm comm_;
+  concordUtil::Timers timers_;
+  std::shared_ptr<MsgHandlersRegistrator> handlers_ = std::make_shared<MsgHandlersRegistrator>();
+  TestReplica replica_{config_, std::make_shared<MsgsCommunicator>(&comm_, nullptr, nullptr), handlers_, timers_};
+  PersistentStorageImp ps_{kNumReplicas, 1, 0, kNumReplicas + 1, 1};
+  TestMetadataStorage* metadata_ = nullptr;
+  SeqNum executed_ = 0;
+};
+
+TEST_F(group_commit_test, messages_are_sent_right_away_when_not_held) {
+  replica_.ps = nullptr;
+  auto m1 = newMsg();
+  replica_.send(m1.get(), 2);
+  replica_.sendToAllOtherReplicas(m1.get());
+  const auto sent = comm_.sent();
+  ASSERT_EQ(sent.size(), 2u);
+  EXPECT_EQ(sent[0].dests, (std::set<NodeNum>{2}));
+  EXPECT_EQ(sent[1].dests, (std::set<NodeNum>{1, 2, 3}));
+  EXPECT_EQ(sent[0].data, bytesOf(*m1));
+}
+
+TEST_F(group_commit_test, held_messages_are_sent_in_order_on_release) {
+  replica_.ps = nullptr;
+  replica_.hold = true;
+  auto m1 = newMsg(kMsgType);
+  auto m2 = newMsg(kMsgType + 1);
+  const auto bytes1 = bytesOf(*m1);
+  const auto bytes2 = bytesOf(*m2);
+  replica_.send(m1.get(), 3);
+  replica_.sendToAllOtherReplicas(m2.get());
+  // Held messages are copied, so the messages may be freed right after they are sent
+  m1.reset();
+  m2.reset();
+  EXPECT_TRUE(comm_.sent().empty());
+
+  replica_.hold = false;
+  replica_.releaseOutgoingMsgs();
+  auto sent = comm_.sent();
+  ASSERT_EQ(sent.size(), 2u);
+  EXPECT_EQ(sent[0].dests, (std::set<NodeNum>{3}));
+  EXPECT_EQ(sent[0].data, bytes1);
+  EXPECT_EQ(sent[1].dests, (std::set<NodeNum>{1, 2, 3}));
+  EXPECT_EQ(sent[1].data, bytes2);
+
+  // Released messages are sent once
+  replica_.releaseOutgoingMsgs();
+  EXPECT_EQ(comm_.sent().size(), 2u);
+}
+
+TEST_F(group_commit_test, messages_are_held_until_the_deferred_writes_are_committed) {
+  ps_.setDeferredCommits(true);
+  execute();
+  EXPECT_TRUE(ps_.hasDeferredWrites());
+  EXPECT_EQ(metadata_->lastExecutedSeqNum(), 0);
+  EXPECT_TRUE(comm_.sent().empty());
+
+  onMsgsBatchDone();
+  EXPECT_FALSE(ps_.hasDeferredWrites());
+  EXPECT_EQ(metadata_->lastExecutedSeqNum(), 1);
+  EXPECT_EQ(metadata_->ops(), (std::vector<std::string>{"commit(sync)"}));
+  EXPECT_EQ(comm_.sent().size(), 1u);
+}
+
+TEST_F(group_commit_test, one_commit_per_dispatched_batch) {
+  constexpr SeqNum kNumMsgs = 10;
+  ps_.setDeferredCommits(true);
+  std::vector<SeqNum> executedAtCommit;
+  handlers_->registerMsgHandler(kMsgType, [this](std::unique_ptr<MessageBase>) { execute(); });
+  handlers_->registerMsgsBatchDoneHandler([&]() {
+    if (ps_.hasDeferredWrites()) executedAtCommit.push_back(executed_);
+    onMsgsBatchDone();
+  });
+
+  // The messages are pushed before the dispatcher starts, so that it takes all of them at once
+  IncomingMsgsStorageImp storage{handlers_, 10ms, config_.replicaId};
+  for (SeqNum i = 0; i < kNumMsgs; ++i) {
+    ASSERT_TRUE(storage.pushExternalMsg(newMsg()));
+  }
+  storage.start();
+  ASSERT_TRUE(waitFor([&]() { return comm_.sent().size() == kNumMsgs; }));
+  storage.stop();
+
+  EXPECT_EQ(executedAtCommit, std::vector<SeqNum>{kNumMsgs});
+  EXPECT_EQ(metadata_->ops(), (std::vector<std::string>{"commit(sync)"}));
+  EXPECT_EQ(metadata_->lastExecutedSeqNum(), kNumMsgs);
+  // The messages were sent after the commit, in order
+  const auto sent = comm_.sent();
+  for (SeqNum i = 0; i < kNumMsgs; ++i) {
+    EXPECT_EQ(sent[i].data, bytesOf(*newMsg(static_cast<uint16_t>(kMsgType + i + 1)))) << i;
+  }
+}
+
+// A view change flushes right away (see ReplicaImp::MoveToHigherView), rather than at the end of the batch
+TEST_F(group_commit_test, view_change_flushes_within_the_batch) {
+  constexpr uint16_t kViewChangeType = 100;
+  ps_.setDeferredCommits(true);
+  std::vector<size_t> sentAtMsg;
+  handlers_->registerMsgHandler(kMsgType, [this, &sentAtMsg](std::unique_ptr<MessageBase>) {
+    execute();
+    sentAtMsg.push_back(comm_.sent().size());
+  });
+  handlers_->registerMsgHandler(kViewChangeType, [this, &sentAtMsg](std::unique_ptr<MessageBase>) {
+    execute();
+    onMsgsBatchDone();
+    sentAtMsg.push_back(comm_.sent().size());
+  });
+  handlers_->registerMsgsBatchDoneHandler([this]() { onMsgsBatchDone(); });
+
+  IncomingMsgsStorageImp storage{handlers_, 10ms, config_.replicaId};
+  ASSERT_TRUE(storage.pushExternalMsg(newMsg()));
+  ASSERT_TRUE(storage.pushExternalMsg(newMsg(kViewChangeType)));
+  ASSERT_TRUE(storage.pushExternalMsg(newMsg()));
+  storage.start();
+  ASSERT_TRUE(waitFor([&]() { return comm_.sent().size() == 3; }));
+  storage.stop();
+
+  // The messages of the first two executions were sent while handling the view change, before the batch ended
+  EXPECT_EQ(sentAtMsg, (std::vector<size_t>{0, 2, 2}));
+  EXPECT_EQ(metadata_->ops(), (std::vector<std::string>{"commit(sync)", "commit(sync)"}));
+}
+
+// On shutdown (see ReplicaImp::stop) and when the mode is turned off, the deferred writes are committed
+TEST_F(group_commit_test, deferred_writes_are_committed_on_shutdown) {
+  ps_.setDeferredCommits(true);
+  execute();
+  execute();
+  // Not inside a write transaction
+  ps_.beginWriteTran();
+  ps_.commitDeferredWrites();
+  EXPECT_TRUE(metadata_->ops().empty());
+  ps_.endWriteTran();
+
+  ps_.commitDeferredWrites();
+  EXPECT_EQ(metadata_->ops(), (std::vector<std::string>{"commit(sync)"}));
+  EXPECT_EQ(metadata_->lastExecutedSeqNum(), 2);
+
+  execute();
+  ps_.setDeferredCommits(false);
+  EXPECT_FALSE(ps_.hasDeferredWrites());
+  EXPECT_EQ(metadata_->lastExecutedSeqNum(), 3);
+
+  // Without deferred commits, every transaction is committed
+  execute();
+  EXPECT_EQ(metadata_->ops(), (std::vector<std::string>{"commit(sync)", "commit(sync)", "commit(sync)"}));
+}
+
+// The descriptor of the last execution is the write-ahead record of the execution (see ReplicaLoader), so it has to be
+// durable before the application executes the requests
+TEST_F(group_commit_test, execution_descriptor_is_committed_before_execution) {
+  ps_.setDeferredCommits(true);
+  execute();
+  execute();
+  EXPECT_TRUE(metadata_->ops().empty());
+
+  Bitmap requests(1);
+  requests.set(0);
+  ps_.beginWriteTran();
+  ps_.setDescriptorOfLastExecution(DescriptorOfLastExecution{executed_ + 1, requests, 0});
+  ps_.endWriteTran(false);
+  // Committed along with the deferred writes, which asked to sync
+  EXPECT_FALSE(ps_.hasDeferredWrites());
+  EXPECT_EQ(metadata_->ops(), (std::vector<std::string>{"commit(sync)"}));
+  EXPECT_TRUE(metadata_->isCommitted(LAST_EXEC_DESC));
+  EXPECT_EQ(metadata_->lastExecutedSeqNum(), 2);
+
+  // The transactions that follow are deferred again
+  execute();
+  EXPECT_TRUE(ps_.hasDeferredWrites());
+  EXPECT_EQ(metadata_->ops().size(), 1u);
+}
+
+// Messages sent after a commit that didn't release the held messages yet are held as well, to keep their order
+TEST_F(group_commit_test, messages_are_held_while_earlier_messages_are_held) {
+  ps_.setDeferredCommits(true);
+  execute();
+  ps_.commitDeferredWrites();
+  EXPECT_FALSE(ps_.hasDeferredWrites());
+  auto m = newMsg(kMsgType);
+  replica_.send(m.get(), 2);
+  EXPECT_TRUE(comm_.sent().empty());
+
+  replica_.releaseOutgoingMsgs();
+  const auto sent = comm_.sent();
+  ASSERT_EQ(sent.size(), 2u);
+  EXPECT_EQ(sent[0].data, bytesOf(*newMsg(static_cast<uint16_t>(kMsgType + 1))));
+  EXPECT_EQ(sent[1].data, bytesOf(*m));
+}
+
+// DbCheckpointManager writes its metadata atomically from its own threads, which commits the deferred writes of the
+// dispatcher thread. The batch must not be committed while the dispatcher writes into it.
+TEST_F(group_commit_test, deferred_writes_are_committed_by_other_threads) {
+  constexpr SeqNum kNumExecutions = 2000;
+  ps_.setDeferredCommits(true);
+  std::atomic_bool done{false};
+  std::thread dbCheckpointThread([&]() {
+    const std::vector<uint8_t> dbCheckpointMetadata{1, 2, 3};
+    while (!done) {
+      ps_.setDbCheckpointMetadata(dbCheckpointMetadata);
+    }
+  });
+  for (SeqNum i = 1; i <= kNumExecutions; ++i) {
+    ps_.beginWriteTran();
+    ps_.setLastExecutedSeqNum(i);
+    ps_.endWriteTran(true);
+    if (i % 10 == 0) ps_.commitDeferredWrites();
+  }
+  done = true;
+  dbCheckpointThread.join();
+  ps_.commitDeferredWrites();
+
+  EXPECT_FALSE(ps_.hasDeferredWrites());
+  EXPECT_EQ(metadata_->lastExecutedSeqNum(), kNumExecutions);
+}
+
+TEST_F(group_commit_test, atomic_writes_do_not_overtake_deferred_writes) {
+  ps_.setDeferredCommits(true);
+  execute();
+  ps_.setNewEpochFlag(true);
+  EXPECT_EQ(metadata_->ops(), (std::vector<std::string>{"commit(sync)", "atomicWrite"}));
+  EXPECT_EQ(metadata_->lastExecutedSeqNum(), 1);
+}
+
+}  // namespace
@@ -112,6 +112,31 @@ TEST(metadataStorage_test, multi_write) {
   }
 }
 
+TEST(metadataStorage_test, read_in_open_batch) {
+  auto *committed = writeRandomData(initialObjectId, initialObjDataSize);
+  metadataStorage->beginAtomicWriteOnlyBatch();
+  auto *inBatch = writeInTransaction(initialObjectId, initialObjDataSize + 1);
+  auto *outBuf = new uint8_t[maxObjDataSize];
+  uint32_t realSize = 0;
+  // Writes of the open batch are read before they are committed
+  metadataStorage->read(initialObjectId, maxObjDataSize, (char *)outBuf, realSize);
+  ASSERT_TRUE(initialObjDataSize + 1 == realSize);
+  ASSERT_TRUE(is_match(inBatch, outBuf, realSize));
+  // Objects that are not in the batch are read from the DB
+  auto *other = writeRandomData(initialObjectId + 1, initialObjDataSize);
+  metadataStorage->read(initialObjectId + 1, maxObjDataSize, (char *)outBuf, realSize);
+  ASSERT_TRUE(initialObjDataSize == realSize);
+  ASSERT_TRUE(is_match(other, outBuf, realSize));
+  metadataStorage->commitAtomicWriteOnlyBatch();
+  metadataStorage->read(initialObjectId, maxObjDataSize, (char *)outBuf, realSize);
+  ASSERT_TRUE(initialObjDataSize + 1 == realSize);
+  ASSERT_TRUE(is_match(inBatch, outBuf, realSize));
+  delete[] committed;
+  delete[] inBatch;
+  delete[] other;
+  delete[] outBuf;
+}
+
 uint8_t *createUpdateAndCloseDB(Client *client, bool clear_db = false) {
   auto db = initiateMetadataStorage(client, "./metadataStorage_test_db_recover", true);
   auto *inBuf = writeRandomData(initialObjectId, initialObjDataSize, db);
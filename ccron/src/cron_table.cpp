@@ -58,9 +58,12 @@ bool CronTable::empty() const { return (numberOfEntries() == 0); }
 std::uint32_t CronTable::componentId() const { return component_id_; }
 
 void CronTable::evaluate(const Tick& tick) const {
+  if (tick.component_id != component_id_) {
+    return;
+  }
   for (const auto& [_, entry] : entries_) {
     (void)_;
-    if (tick.component_id == component_id_ && entry.rule(tick)) {
+    if (entry.rule(tick)) {
       if (entry.schedule_next) {
         (*entry.schedule_next)(tick);
       }
@@ -11,13 +11,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <chrono>
+#include <future>
+#include <thread>
 
 #include "log/logger.hpp"
 #include "communication/ICommunication.hpp"
 #include "util/DynamicUpperLimitWithSimpleFilter.hpp"
+#include "util/Timers.hpp"
 
 #include "bftclient/config.h"
 #include "matcher.h"
@@ -43,7 +47,9 @@ class Client {
     metrics_.setAggregator(aggregator);
   }
 
-  void stop() { communication_->stop(); }
+  ~Client() { stopAsync(); }
+
+  void stop();
 
   // Send a message where the reply gets allocated by the callee and returned in a vector.
   // The message to be sent is moved into the caller to prevent unnecessary copies.
@@ -53,6 +59,17 @@ class Client {
   Reply send(const ReadConfig& config, Msg&& request);
   SeqNumToReplyMap sendBatch(std::deque<WriteRequest>& write_requests, const std::string& cid);
 
+  // Send a message without waiting for the reply. Any number of requests, each with a unique sequence number, may be
+  // in flight at the same time. Replies are matched on a dedicated thread that also retransmits requests on retry
+  // timeouts.
+  //
+  // The returned future holds the Reply on quorum, or a TimeoutException if the request timed out.
+  // Throws a BftClientException if the sequence number is already in flight or the client was stopped.
+  //
+  // This function is thread safe. Once it is called, the synchronous send APIs must not be used on this client.
+  std::future<Reply> sendAsync(const WriteConfig& config, Msg&& request);
+  std::future<Reply> sendAsync(const ReadConfig& config, Msg&& request);
+
   // Return true if the client has at least num_replicas_required active replica connections.
   bool isServing(int num_replicas, int num_replicas_required) const;
 
@@ -68,6 +85,22 @@ class Client {
   // Generic function for sending a read or write message.
   Reply send(const MatchConfig& match_config, const RequestConfig& request_config, Msg&& request, bool read_only);
 
+  std::future<Reply> sendAsync(const MatchConfig& match_config,
+                               const RequestConfig& request_config,
+                               Msg&& request,
+                               bool read_only);
+
+  // Send to the primary if it's known and this is a write, otherwise to all destinations of the quorum.
+  void sendToReplicas(Msg&& msg, const MatchConfig& match_config, bool read_only);
+
+  // The loop of the async thread: match received replies and handle expired retry and request timers.
+  void runAsync();
+  void onAsyncReply(UnmatchedReply&& reply);
+  void onAsyncTimers();
+
+  // Stop the async thread and fail all requests that are still in flight.
+  void stopAsync();
+
   // Wait for messages until we get a quorum or a retry timeout.
   //
   // Inserts the Replies to the input queue.
@@ -148,6 +181,37 @@ class Client {
     std::string component_name_;
   };
 
+  // An outstanding request sent with sendAsync
+  struct AsyncRequest {
+    AsyncRequest(const MatchConfig& config) : match_config(config), matcher(config) {}
+    MatchConfig match_config;
+    Matcher matcher;
+    Msg msg;
+    bool read_only = false;
+    std::string cid;
+    std::chrono::milliseconds timeout;
+    std::chrono::steady_clock::time_point start;
+    concordUtil::Timers::Handle retry_timer;
+    concordUtil::Timers::Handle timeout_timer;
+    std::promise<Reply> promise;
+  };
+
+  // How long the async thread waits for replies before checking the timers
+  static constexpr std::chrono::milliseconds ASYNC_TIMERS_RESOLUTION = std::chrono::milliseconds(10);
+
+  // All members below are protected by async_lock_, except for the atomics.
+  std::mutex async_lock_;
+  std::unordered_map<uint64_t, AsyncRequest> async_requests_;
+  // Timer callbacks only record the sequence numbers of the expired requests. They are handled after evaluating the
+  // timers, as timers must not be added or canceled from within a callback.
+  concordUtil::Timers async_timers_;
+  std::vector<uint64_t> expired_retry_timers_;
+  std::vector<uint64_t> expired_timeout_timers_;
+  uint32_t async_max_reply_size_ = 0;
+  std::thread async_thread_;
+  std::atomic_bool async_mode_ = false;
+  std::atomic_bool async_stopped_ = false;
+
   static constexpr uint32_t count_between_snapshots = 200;
   uint32_t snapshot_index_ = 0;
   std::unique_ptr<Recorders> histograms_;
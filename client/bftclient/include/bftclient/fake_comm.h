@@ -157,13 +157,34 @@ inline std::vector<uint8_t> createReply(const MsgFromClient& msg, std::vector<ui
   return reply;
 }
 
+// Create a reply for a single request, or one reply for every request of a batch
+inline std::vector<std::vector<uint8_t>> createReplies(const MsgFromClient& msg) {
+  const auto* batch_header = reinterpret_cast<const bftEngine::ClientBatchRequestMsgHeader*>(msg.data.data());
+  if (batch_header->msgType != BATCH_REQUEST_MSG_TYPE) {
+    return {createReply(msg)};
+  }
+  std::vector<std::vector<uint8_t>> replies;
+  const auto* position = msg.data.data() + sizeof(bftEngine::ClientBatchRequestMsgHeader) + batch_header->cidSize;
+  for (uint32_t i = 0; i < batch_header->numOfMessagesInBatch; i++) {
+    const auto* req_header = reinterpret_cast<const bftEngine::ClientRequestMsgHeader*>(position);
+    const auto req_size = sizeof(bftEngine::ClientRequestMsgHeader) + req_header->spanContextSize +
+                          req_header->requestLength + req_header->cidLength + req_header->reqSignatureLength;
+    replies.push_back(createReply(MsgFromClient{msg.destination, Msg(position, position + req_size)}));
+    position += req_size;
+  }
+  return replies;
+}
+
 inline void immediateBehaviour(const MsgFromClient& msg, IReceiver* client_receiver) {
-  std::vector<uint8_t> reply = createReply(msg);
-  client_receiver->onNewMessage(msg.destination.val, reinterpret_cast<const char*>(reply.data()), reply.size());
+  for (const auto& reply : createReplies(msg)) {
+    client_receiver->onNewMessage(msg.destination.val, reinterpret_cast<const char*>(reply.data()), reply.size());
+  }
 }
 
 inline void delayedBehaviour(const MsgFromClient& msg, IReceiver* client_receiver) {
-  std::vector<uint8_t> reply = createReply(msg);
+  auto replies = createReplies(msg);
   std::this_thread::sleep_for(5ms);
-  client_receiver->onNewMessage(msg.destination.val, reinterpret_cast<const char*>(reply.data()), reply.size());
+  for (const auto& reply : replies) {
+    client_receiver->onNewMessage(msg.destination.val, reinterpret_cast<const char*>(reply.data()), reply.size());
+  }
 }
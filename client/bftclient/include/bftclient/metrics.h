@@ -22,7 +22,8 @@ struct Metrics {
         retransmissions{component_.RegisterCounter("retransmissions")},
         transactionSigning{component_.RegisterCounter("transactionSigning")},
         retransmissionTimer{component_.RegisterGauge("retransmissionTimer", 0)},
-        repliesCleared{component_.RegisterCounter("repliesCleared", 0)} {
+        repliesCleared{component_.RegisterCounter("repliesCleared", 0)},
+        asyncRequestsInFlight{component_.RegisterGauge("asyncRequestsInFlight", 0)} {
     component_.Register();
   }
 
@@ -40,6 +41,7 @@ struct Metrics {
   concordMetrics::CounterHandle transactionSigning;
   concordMetrics::GaugeHandle retransmissionTimer;
   concordMetrics::CounterHandle repliesCleared;
+  concordMetrics::GaugeHandle asyncRequestsInFlight;
 };
 
 }  // namespace bft::client
@@ -204,6 +204,7 @@ Msg Client::initBatch(std::deque<WriteRequest>& write_requests,
 }
 
 Reply Client::send(const WriteConfig& config, Msg&& request) {
+  ConcordAssert(!async_mode_);
   ConcordAssertEQ(reply_certificates_.size(), 0);
   auto match_config = writeConfigToMatchConfig(config);
   bool read_only = false;
@@ -211,6 +212,7 @@ Reply Client::send(const WriteConfig& config, Msg&& request) {
 }
 
 Reply Client::send(const ReadConfig& config, Msg&& request) {
+  ConcordAssert(!async_mode_);
   ConcordAssertEQ(reply_certificates_.size(), 0);
   auto match_config = readConfigToMatchConfig(config);
   bool read_only = true;
@@ -229,16 +231,7 @@ Reply Client::send(const MatchConfig& match_config,
   auto start = std::chrono::steady_clock::now();
   auto end = start + request_config.timeout;
   while (std::chrono::steady_clock::now() < end) {
-    bft::client::Msg msg(orig_msg);  // create copy here due to the loop
-    if (primary_ && !read_only) {
-      communication_->send(primary_.value().val, std::move(msg), config_.id.val);
-    } else {
-      std::set<bft::communication::NodeNum> dests;
-      for (const auto& d : match_config.quorum.destinations) {
-        dests.emplace(d.val);
-      }
-      communication_->send(dests, std::move(msg), config_.id.val);
-    }
+    sendToReplicas(Msg(orig_msg), match_config, read_only);  // create copy here due to the loop
 
     if (auto reply = wait()) {
       expected_commit_time_ms_.add(
@@ -254,7 +247,167 @@ Reply Client::send(const MatchConfig& match_config,
   throw TimeoutException(request_config.sequence_number, request_config.correlation_id);
 }
 
+void Client::sendToReplicas(Msg&& msg, const MatchConfig& match_config, bool read_only) {
+  if (primary_ && !read_only) {
+    communication_->send(primary_.value().val, std::move(msg), config_.id.val);
+  } else {
+    std::set<bft::communication::NodeNum> dests;
+    for (const auto& d : match_config.quorum.destinations) {
+      dests.emplace(d.val);
+    }
+    communication_->send(dests, std::move(msg), config_.id.val);
+  }
+}
+
+std::future<Reply> Client::sendAsync(const WriteConfig& config, Msg&& request) {
+  auto match_config = writeConfigToMatchConfig(config);
+  bool read_only = false;
+  return sendAsync(match_config, config.request, std::move(request), read_only);
+}
+
+std::future<Reply> Client::sendAsync(const ReadConfig& config, Msg&& request) {
+  auto match_config = readConfigToMatchConfig(config);
+  bool read_only = true;
+  return sendAsync(match_config, config.request, std::move(request), read_only);
+}
+
+std::future<Reply> Client::sendAsync(const MatchConfig& match_config,
+                                     const RequestConfig& request_config,
+                                     Msg&& request,
+                                     bool read_only) {
+  std::lock_guard<std::mutex> lg(async_lock_);
+  if (async_stopped_) {
+    throw BftClientException("Client is stopped, cannot send request sequence number: " +
+                             std::to_string(request_config.sequence_number));
+  }
+  if (async_requests_.count(request_config.sequence_number)) {
+    throw BftClientException("Request sequence number: " + std::to_string(request_config.sequence_number) +
+                             " is already in flight");
+  }
+  ConcordAssertEQ(reply_certificates_.size(), 0);
+  async_mode_ = true;
+
+  // The receiver drops replies larger than its max reply size, so it must fit all requests in flight.
+  if (request_config.max_reply_size > async_max_reply_size_) {
+    async_max_reply_size_ = request_config.max_reply_size;
+    receiver_.activate(async_max_reply_size_);
+  }
+  const auto retry_timeout = std::chrono::milliseconds(expected_commit_time_ms_.upperLimit());
+  metrics_.retransmissionTimer.Get().Set(retry_timeout.count());
+
+  const auto seq_num = request_config.sequence_number;
+  auto [it, inserted] = async_requests_.emplace(seq_num, AsyncRequest{match_config});
+  ConcordAssert(inserted);
+  auto& req = it->second;
+  req.msg = createClientMsg(request_config, std::move(request), read_only, config_.id.val);
+  req.read_only = read_only;
+  req.cid = request_config.correlation_id;
+  req.timeout = request_config.timeout;
+  req.start = std::chrono::steady_clock::now();
+  req.retry_timer = async_timers_.add(
+      retry_timeout,
+      concordUtil::Timers::Timer::RECURRING,
+      [this, seq_num](concordUtil::Timers::Handle) { expired_retry_timers_.push_back(seq_num); },
+      req.start);
+  req.timeout_timer = async_timers_.add(
+      req.timeout,
+      concordUtil::Timers::Timer::ONESHOT,
+      [this, seq_num](concordUtil::Timers::Handle) { expired_timeout_timers_.push_back(seq_num); },
+      req.start);
+  sendToReplicas(Msg(req.msg), match_config, read_only);
+  metrics_.asyncRequestsInFlight.Get().Set(async_requests_.size());
+  metrics_.updateAggregator();
+
+  if (!async_thread_.joinable()) {
+    async_thread_ = std::thread([this] { runAsync(); });
+  }
+  return req.promise.get_future();
+}
+
+void Client::runAsync() {
+  while (!async_stopped_) {
+    auto replies = receiver_.wait(ASYNC_TIMERS_RESOLUTION);
+    std::lock_guard<std::mutex> lg(async_lock_);
+    for (auto&& reply : replies) {
+      onAsyncReply(std::move(reply));
+    }
+    onAsyncTimers();
+    metrics_.asyncRequestsInFlight.Get().Set(async_requests_.size());
+  }
+}
+
+void Client::onAsyncReply(UnmatchedReply&& reply) {
+  auto it = async_requests_.find(reply.metadata.seq_num);
+  if (it == async_requests_.end()) return;
+  auto& req = it->second;
+  if (auto match = req.matcher.onReply(std::move(reply))) {
+    primary_ = req.matcher.getPrimary();
+    expected_commit_time_ms_.add(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - req.start).count());
+    async_timers_.cancel(req.retry_timer);
+    async_timers_.cancel(req.timeout_timer);
+    req.promise.set_value(std::move(match->reply));
+    async_requests_.erase(it);
+  }
+}
+
+void Client::onAsyncTimers() {
+  async_timers_.evaluate();
+
+  for (auto seq_num : expired_timeout_timers_) {
+    auto it = async_requests_.find(seq_num);
+    if (it == async_requests_.end()) continue;
+    auto& req = it->second;
+    async_timers_.cancel(req.retry_timer);
+    expected_commit_time_ms_.add(req.timeout.count());
+    req.promise.set_exception(std::make_exception_ptr(TimeoutException(seq_num, req.cid)));
+    async_requests_.erase(it);
+  }
+  expired_timeout_timers_.clear();
+
+  static const size_t CLEAR_MATCHER_REPLIES_THRESHOLD = 2 * config_.f_val + config_.c_val + 1;
+  for (auto seq_num : expired_retry_timers_) {
+    auto it = async_requests_.find(seq_num);
+    if (it == async_requests_.end()) continue;
+    auto& req = it->second;
+    if (req.matcher.numDifferentReplies() > CLEAR_MATCHER_REPLIES_THRESHOLD) {
+      req.matcher.clearReplies();
+      metrics_.repliesCleared++;
+    }
+    // As with synchronous requests, a retry means that the primary may have changed.
+    primary_ = std::nullopt;
+    sendToReplicas(Msg(req.msg), req.match_config, req.read_only);
+    metrics_.retransmissions++;
+  }
+  expired_retry_timers_.clear();
+}
+
+void Client::stop() {
+  stopAsync();
+  communication_->stop();
+}
+
+void Client::stopAsync() {
+  {
+    // Once set under the lock, sendAsync can no longer start the async thread
+    std::lock_guard<std::mutex> lg(async_lock_);
+    async_stopped_ = true;
+  }
+  if (async_thread_.joinable()) {
+    async_thread_.join();
+  }
+  std::lock_guard<std::mutex> lg(async_lock_);
+  for (auto& [seq_num, req] : async_requests_) {
+    async_timers_.cancel(req.retry_timer);
+    async_timers_.cancel(req.timeout_timer);
+    req.promise.set_exception(std::make_exception_ptr(
+        BftClientException("Client stopped with request sequence number: " + std::to_string(seq_num) + " in flight")));
+  }
+  async_requests_.clear();
+}
+
 SeqNumToReplyMap Client::sendBatch(std::deque<WriteRequest>& write_requests, const std::string& cid) {
+  ConcordAssert(!async_mode_);
   SeqNumToReplyMap replies;
   std::chrono::milliseconds max_time_to_wait = 0s;
   MatchConfig match_config = writeConfigToMatchConfig(write_requests.front().config);
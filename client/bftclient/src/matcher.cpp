@@ -14,29 +14,36 @@
 namespace bft::client {
 
 std::optional<Match> Matcher::onReply(UnmatchedReply&& reply) {
+  if (completed_) return std::nullopt;
   if (!valid(reply)) return std::nullopt;
   if (!config_.include_primary_) reply.metadata.primary = std::nullopt;
-  auto key = MatchKey{reply.metadata, std::move(reply.data)};
-  if (matches_[key].count(reply.rsi.from)) {
-    if (matches_[key][reply.rsi.from] != reply.rsi.data) {
-      LOG_ERROR(logger_,
-                "Received two different pieces of replica specific information from: " << reply.rsi.from.val
-                                                                                       << ". Keeping the new one.");
-    }
+  auto digest = concord::crypto::openssl::SHA2_256{}.digest(reply.data.data(), reply.data.size());
+  auto key = MatchKey{reply.metadata, digest};
+  auto [it, inserted] = matches_.try_emplace(std::move(key));
+  if (inserted) {
+    it->second.data = std::move(reply.data);
   }
-  matches_[key].insert_or_assign(reply.rsi.from, std::move(reply.rsi.data));
+  auto& rsi = it->second.rsi;
+  auto replica_rsi = rsi.find(reply.rsi.from);
+  if (replica_rsi != rsi.end() && replica_rsi->second != reply.rsi.data) {
+    LOG_ERROR(logger_,
+              "Received two different pieces of replica specific information from: " << reply.rsi.from.val
+                                                                                     << ". Keeping the new one.");
+  }
+  rsi.insert_or_assign(reply.rsi.from, std::move(reply.rsi.data));
 
-  return match();
+  return match(it);
 }
 
-std::optional<Match> Matcher::match() {
-  auto result = std::find_if(matches_.begin(), matches_.end(), [this](const auto& match) {
-    return match.second.size() == config_.quorum.wait_for;
-  });
-  if (result == matches_.end()) return std::nullopt;
-  primary_ = result->first.metadata.primary;
-  return Match{Reply{result->first.metadata.result, result->first.data, std::move(result->second)},
-               result->first.metadata.primary};
+std::optional<Match> Matcher::match(std::map<MatchKey, MatchedReplies>::iterator it) {
+  // Only the replies of the updated key can have reached the quorum
+  if (it->second.rsi.size() != config_.quorum.wait_for) return std::nullopt;
+  completed_ = true;
+  primary_ = it->first.metadata.primary;
+  auto match =
+      Match{Reply{it->first.metadata.result, std::move(it->second.data), std::move(it->second.rsi)}, primary_};
+  matches_.clear();
+  return match;
 }
 
 bool Matcher::valid(const UnmatchedReply& reply) const {
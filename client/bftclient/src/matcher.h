@@ -16,6 +16,7 @@
 #include <optional>
 #include <set>
 
+#include "crypto/openssl/hash.hpp"
 #include "log/logger.hpp"
 #include "bftclient/config.h"
 #include "msg_receiver.h"
@@ -30,23 +31,35 @@ struct MatchConfig {
 };
 
 // The parts of data that must match in a reply for quorum to be reached
+//
+// Replies are matched by a SHA256 digest of their data rather than by the data itself, such that large replies are
+// hashed once and then compared by 32 bytes. The hash must be collision resistant, since a malicious replica could
+// otherwise craft a different reply that matches the honest ones.
 struct MatchKey {
+  using Digest = concord::crypto::openssl::SHA2_256::Digest;
+
   ReplyMetadata metadata;
-  Msg data;
+  Digest digest;
 
-  bool operator==(const MatchKey& other) const { return metadata == other.metadata && data == other.data; }
+  bool operator==(const MatchKey& other) const { return metadata == other.metadata && digest == other.digest; }
   bool operator!=(const MatchKey& other) const { return !(*this == other); }
   bool operator<(const MatchKey& other) const {
     if (metadata < other.metadata) {
       return true;
     }
-    if (metadata == other.metadata && data < other.data) {
+    if (metadata == other.metadata && digest < other.digest) {
       return true;
     }
     return false;
   }
 };
 
+// All replies with the same MatchKey. The data is kept only once, for the first reply, since the rest are identical.
+struct MatchedReplies {
+  Msg data;
+  std::map<ReplicaId, Msg> rsi;
+};
+
 // A successful match
 struct Match {
   Reply reply;
@@ -58,6 +71,7 @@ class Matcher {
  public:
   Matcher(const MatchConfig& config) : config_(config) {}
 
+  // Return a match as soon as the quorum is reached. Any reply received after that is ignored.
   std::optional<Match> onReply(UnmatchedReply&& reply);
 
   // Return the number of replies from replicas that don't match, excluding RSI. When this number
@@ -79,15 +93,15 @@ class Matcher {
   // Is the reply from a source listed in the quorum's destination?
   bool validSource(const ReplicaId& source) const;
 
-  // Check for a quorum based on config_ and matches_
-  std::optional<Match> match();
+  // Check for a quorum among the replies that match the given key
+  std::optional<Match> match(std::map<MatchKey, MatchedReplies>::iterator it);
 
   MatchConfig config_;
   std::optional<ReplicaId> primary_;
 
   logging::Logger logger_ = logging::getLogger("bftclient.matcher");
 
-  // A map from a MatchKey to ReplicaSpecificInfo
+  // A map from a MatchKey to the matching data and ReplicaSpecificInfo
   //
   // We store it as a nested map so that in case a replica returns different ReplicaSpecificInfo.data, we don't count it
   // as 2 replies.
@@ -95,7 +109,10 @@ class Matcher {
   // In case this occurs, the replica is buggy or malicious, and we should log it and reject any replies from that
   // replica. In the future we can keep track of this across future requests, but for now, we just log it and worry
   // about it for the current match.
-  std::map<MatchKey, std::map<ReplicaId, Msg>> matches_;
+  std::map<MatchKey, MatchedReplies> matches_;
+
+  // Set once a quorum is reached. The matched data has been moved out into the Match at that point.
+  bool completed_ = false;
 };
 
 }  // namespace bft::client
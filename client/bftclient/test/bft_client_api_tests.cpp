@@ -17,6 +17,10 @@
 #include <vector>
 #include <iostream>
 #include <ctime>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
 
 #include "gtest/gtest.h"
 
@@ -523,6 +527,73 @@ TEST_F(ClientApiTestFixture, write_f_plus_one_get_differnt_rsi) {
   client.stop();
 }
 
+TEST_F(ClientApiTestFixture, async_requests_throughput) {
+  unique_ptr<FakeCommunication> comm(new FakeCommunication(immediateBehaviour));
+  Client client(move(comm), test_config_);
+  constexpr uint64_t num_requests = 2000;
+  constexpr uint64_t max_in_flight = 200;
+  Msg expected{'r', 'e', 'p', 'l', 'y'};
+  deque<future<Reply>> in_flight;
+  auto start = chrono::steady_clock::now();
+  for (uint64_t seq_num = 1; seq_num <= num_requests; seq_num++) {
+    WriteConfig config{RequestConfig{false, seq_num}, ByzantineSafeQuorum{}};
+    config.request.timeout = 5s;
+    in_flight.push_back(client.sendAsync(config, Msg({'h', 'e', 'l', 'l', 'o'})));
+    if (in_flight.size() == max_in_flight) {
+      ASSERT_EQ(expected, in_flight.front().get().matched_data);
+      in_flight.pop_front();
+    }
+  }
+  for (auto& reply : in_flight) {
+    ASSERT_EQ(expected, reply.get().matched_data);
+  }
+  auto duration = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+  cout << num_requests << " async requests completed in " << duration.count() << "ms" << endl;
+  ASSERT_EQ(client.primary(), ReplicaId_t{0});
+  client.stop();
+}
+
+TEST_F(ClientApiTestFixture, async_requests_retry_and_timeout) {
+  // Replicas only reply to the retransmission of even sequence numbers
+  mutex lock;
+  map<uint64_t, set<ReplicaId_t>> heard_from;
+  auto RetryEvenBehavior = [&](const MsgFromClient& msg, IReceiver* client_receiver) {
+    const auto* req_header = reinterpret_cast<const ClientRequestMsgHeader*>(msg.data.data());
+    if (req_header->reqSeqNum % 2) return;
+    {
+      lock_guard<mutex> guard(lock);
+      if (heard_from[req_header->reqSeqNum].insert(msg.destination).second) return;
+    }
+    auto reply = replyFromRequest(msg);
+    client_receiver->onNewMessage((NodeNum)msg.destination.val, (const char*)reply.data(), reply.size());
+  };
+
+  unique_ptr<FakeCommunication> comm(new FakeCommunication(RetryEvenBehavior));
+  Client client(move(comm), test_config_);
+  vector<future<Reply>> replies;
+  for (uint64_t seq_num = 1; seq_num <= 10; seq_num++) {
+    ReadConfig config{RequestConfig{false, seq_num}, All{}};
+    config.request.timeout = 1s;
+    replies.push_back(client.sendAsync(config, Msg({'h', 'e', 'l', 'l', 'o'})));
+  }
+  ReadConfig duplicate{RequestConfig{false, 1}, All{}};
+  ASSERT_THROW(client.sendAsync(duplicate, Msg({'h', 'e', 'l', 'l', 'o'})), BftClientException);
+
+  Msg expected{'w', 'o', 'r', 'l', 'd'};
+  for (uint64_t seq_num = 1; seq_num <= 10; seq_num++) {
+    auto& reply = replies[seq_num - 1];
+    if (seq_num % 2) {
+      ASSERT_THROW(reply.get(), TimeoutException);
+    } else {
+      auto r = reply.get();
+      ASSERT_EQ(expected, r.matched_data);
+      ASSERT_EQ(r.rsi.size(), 4);
+    }
+  }
+  client.stop();
+  ASSERT_THROW(client.sendAsync(duplicate, Msg({'h', 'e', 'l', 'l', 'o'})), BftClientException);
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
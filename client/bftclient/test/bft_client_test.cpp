@@ -271,6 +271,31 @@ TEST(matcher_tests, wait_for_replies_with_ignoring_primary) {
   ASSERT_FALSE(match.value().primary.has_value());
 }
 
+TEST(matcher_tests, late_replies_ignored_after_quorum) {
+  uint64_t seq_num = 5;
+  MatchConfig config{MofN{2, destinations(4)}, seq_num};
+  Matcher matcher(config);
+  ReplicaId primary{1};
+  Msg msg(64 * 1024, 'r');
+  auto unmatched = unmatched_replies(4, ReplyMetadata{primary, seq_num}, msg, create_rsi(4));
+
+  auto non_matching_data = unmatched[3];
+  non_matching_data.data.back() = 'x';
+  ASSERT_EQ(std::nullopt, matcher.onReply(std::move(non_matching_data)));
+  ASSERT_EQ(std::nullopt, matcher.onReply(std::move(unmatched[0])));
+  ASSERT_EQ(2u, matcher.numDifferentReplies());
+
+  auto match = matcher.onReply(std::move(unmatched[1]));
+  ASSERT_TRUE(match.has_value());
+  ASSERT_EQ(match.value().reply.matched_data, msg);
+  ASSERT_EQ(2u, match.value().reply.rsi.size());
+
+  // The quorum is reached - the replies are released and any late reply is dropped
+  ASSERT_EQ(0u, matcher.numDifferentReplies());
+  ASSERT_EQ(std::nullopt, matcher.onReply(std::move(unmatched[2])));
+  ASSERT_EQ(0u, matcher.numDifferentReplies());
+}
+
 TEST(quorum_tests, valid_quorums_without_destinations) {
   auto all_replicas = destinations(4);
   // Even that we have ro replicas, empty destinations should include only committers. To issue a request to ro replica
@@ -0,0 +1,70 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include "matcher.h"
+
+// Matching of large replies from all replicas of a cluster. Every iteration feeds the replies of a single request to
+// a new matcher until a quorum of 2F + 1 out of N is reached, after which the replies of the remaining replicas are
+// late and dropped.
+
+namespace {
+
+using namespace bft::client;
+
+constexpr uint64_t kSeqNum = 5;
+
+std::vector<UnmatchedReply> makeReplies(uint16_t num_replicas, size_t reply_size) {
+  const Msg data(reply_size, 'r');
+  std::vector<UnmatchedReply> replies;
+  for (uint16_t i = 0; i < num_replicas; ++i) {
+    replies.push_back(UnmatchedReply{ReplyMetadata{ReplicaId{0}, kSeqNum}, data, {ReplicaId{i}, {'r', 's', 'i'}}});
+  }
+  return replies;
+}
+
+void matchLargeReplies(benchmark::State& state) {
+  const auto reply_size = static_cast<size_t>(state.range(0));
+  const auto f = static_cast<uint16_t>(state.range(1));
+  const uint16_t num_replicas = 3 * f + 1;
+  std::set<ReplicaId> destinations;
+  for (uint16_t i = 0; i < num_replicas; ++i) {
+    destinations.insert(ReplicaId{i});
+  }
+  const auto config = MatchConfig{MofN{2 * f + 1u, destinations}, kSeqNum};
+  const auto replies = makeReplies(num_replicas, reply_size);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto batch = replies;
+    state.ResumeTiming();
+    Matcher matcher(config);
+    for (auto& reply : batch) {
+      auto match = matcher.onReply(std::move(reply));
+      benchmark::DoNotOptimize(match);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * num_replicas * reply_size);
+}
+
+}  // namespace
+
+// Reply sizes of 4KB, 64KB and 1MB with F = 1 and F = 10
+BENCHMARK(matchLargeReplies)->ArgsProduct({{4 << 10, 64 << 10, 1 << 20}, {1, 10}})->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+
+namespace concord_client_pool {
+
+/*
+ * Sizes client-side batches from the observed request arrival rate and reply latency instead of using a fixed batch
+ * size and flush timeout.
+ *
+ * Every client in the pool can have one batch in flight per reply latency. In order to keep up with the arrival rate,
+ * a batch has to hold about `arrival_rate * reply_latency / num_clients` requests. Under low load this yields batches
+ * of a single request that are sent right away, while bursts grow the batches up to the configured maximum. The flush
+ * timeout is the expected time to fill a batch of that size, bounded by the configured flush timeout.
+ *
+ * Both the arrival rate and the reply latency are exponentially weighted moving averages. Until there are samples of
+ * both, the configured maximums are used (i.e. the controller behaves like static batching).
+ *
+ * Not thread safe.
+ */
+class AdaptiveBatchController {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  AdaptiveBatchController(size_t max_batch_size, std::chrono::milliseconds max_flush_timeout, size_t num_clients)
+      : max_batch_size_{std::max<size_t>(max_batch_size, 1)},
+        max_flush_timeout_{max_flush_timeout},
+        num_clients_{std::max<size_t>(num_clients, 1)} {}
+
+  // Record the arrival of a request that is good for batching
+  void onRequestArrival(Clock::time_point now) {
+    if (last_arrival_) {
+      const auto interval_us = std::chrono::duration<double, std::micro>(now - *last_arrival_).count();
+      inter_arrival_us_ = ewma(inter_arrival_us_, std::max(interval_us, 1.0));
+    }
+    last_arrival_ = now;
+  }
+
+  // Record the time it took to get the replies for a batch or a single request
+  void onReply(std::chrono::milliseconds latency) {
+    reply_latency_ms_ = ewma(reply_latency_ms_, static_cast<double>(std::max<int64_t>(latency.count(), 1)));
+  }
+
+  size_t batchSize() const {
+    if (inter_arrival_us_ == 0 || reply_latency_ms_ == 0) {
+      return max_batch_size_;
+    }
+    const auto in_flight = arrivalRate() * reply_latency_ms_ / 1000 / num_clients_;
+    return std::clamp<size_t>(static_cast<size_t>(std::ceil(in_flight)), 1, max_batch_size_);
+  }
+
+  std::chrono::milliseconds flushTimeout() const {
+    if (inter_arrival_us_ == 0 || reply_latency_ms_ == 0) {
+      return max_flush_timeout_;
+    }
+    const auto fill_time_ms = static_cast<int64_t>(std::ceil(batchSize() * inter_arrival_us_ / 1000));
+    return std::clamp(std::chrono::milliseconds{fill_time_ms}, std::chrono::milliseconds{1}, max_flush_timeout_);
+  }
+
+  // Requests per second
+  double arrivalRate() const { return inter_arrival_us_ > 0 ? 1000 * 1000 / inter_arrival_us_ : 0; }
+
+  std::chrono::milliseconds replyLatency() const {
+    return std::chrono::milliseconds{static_cast<int64_t>(reply_latency_ms_)};
+  }
+
+ private:
+  static double ewma(double avg, double sample) { return avg == 0 ? sample : avg + kAlpha * (sample - avg); }
+
+  static constexpr double kAlpha = 0.1;
+
+  const size_t max_batch_size_;
+  const std::chrono::milliseconds max_flush_timeout_;
+  const size_t num_clients_;
+  std::optional<Clock::time_point> last_arrival_;
+  double inter_arrival_us_{0};
+  double reply_latency_ms_{0};
+};
+
+}  // namespace concord_client_pool
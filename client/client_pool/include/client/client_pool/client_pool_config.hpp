@@ -59,6 +59,8 @@ typedef struct ConcordClientPoolConfig {
   bool use_unified_certificates = false;
   size_t client_batching_max_messages_nbr = 20;
   std::uint64_t client_batching_flush_timeout_ms = 100;
+  // Size batches from the observed arrival rate and reply latency, bounded by the two values above
+  bool client_batching_adaptive = false;
   bool encrypted_config_enabled = false;
   bool transaction_signing_enabled = false;
   bool with_cre = false;
@@ -111,6 +113,7 @@ class ClientPoolConfig {
   const std::string MULTIPLEX_CHANNEL_ENABLED = "enable_multiplex_channel";
   const std::string CLIENT_BATCHING_MAX_MSG_NUM = "client_batching_max_messages_nbr";
   const std::string CLIENT_BATCHING_TIMEOUT_MILLI = "client_batching_flush_timeout_ms";
+  const std::string CLIENT_BATCHING_ADAPTIVE = "client_batching_adaptive";
   const std::string TRACE_SAMPLING_RATE = "trace_sampling_rate";
   ClientPoolConfig();
 
@@ -80,7 +80,14 @@ class Timer {
    * from a previous call to start that has not either completed its callback or been successfully cancelled via
    * cancel() or stopTimerThread().
    */
-  void start(const ClientT& client) {
+  void start(const ClientT& client) { start(client, timeout_); }
+
+  /*
+   * Same as start(client), but the callback is made after the given timeout instead of the one given at this Timer's
+   * construction. A Timer constructed with a timeout of 0 milliseconds still never makes any callback. Behavior is
+   * undefined if timeout is not a positive number of milliseconds.
+   */
+  void start(const ClientT& client, std::chrono::milliseconds timeout) {
     if (timeout_.count() == 0 || not timer_thread_future_.valid() || io_context_.stopped()) {
       LOG_WARN(logger_, "Timer cannot start for client " << client_);
       return;
@@ -93,7 +100,7 @@ class Timer {
     };
 
     start_timer_ = std::chrono::steady_clock::now();
-    timer_.expires_at(start_timer_ + timeout_);
+    timer_.expires_at(start_timer_ + timeout);
     timer_.async_wait(handler);
     LOG_DEBUG(logger_, "Timer set for client " << client_);
   }
@@ -15,15 +15,22 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/lockfree/queue.hpp>
 
 #include "util/SimpleThreadPool.hpp"
 #include "bftclient/base_types.h"
 #include "bftclient/config.h"
 #include "bftclient/quorums.h"
+#include "adaptive_batch_controller.hpp"
 #include "client_pool_timer.hpp"
 #include "external_client.hpp"
 
@@ -133,6 +140,14 @@ class ConcordClientPool {
                            bft::client::Msg&& request,
                            const bftEngine::RequestCallBack& callback = {});
 
+  // This method is responsible to send many write requests at once, callbacks[i] being invoked once requests[i] is
+  // done. If client batching is enabled, the pre-execution requests are sent right away as batches of up to
+  // client_batching_max_messages_nbr requests, each batch by a single client, instead of being aggregated one by one
+  // until the batching timer fires. All the other requests are sent as if SendRequest was called for each one.
+  // Returns Overloaded if any of the requests was rejected.
+  SubmitResult SendRequests(std::deque<bft::client::WriteRequest>&& requests,
+                            const std::vector<bftEngine::RequestCallBack>& callbacks);
+
   void processReplies(std::shared_ptr<concord::external_client::ConcordClient>& client,
                       std::pair<int8_t, external_client::ConcordClient::PendingReplies>&& replies);
 
@@ -164,20 +179,48 @@ class ConcordClientPool {
 
   void AddSenderAndSignature(std::vector<uint8_t>& request, const ClientPtr& chosenClient);
 
+  // Take a serving client from the free clients queue. Returns nullptr if there is none, in which case
+  // found_not_serving tells whether there were free clients that are not serving.
+  ClientPtr takeFreeClient(bool& found_not_serving);
+  void returnFreeClient(const ClientPtr& client);
+
+  void recordArrival(const std::string& correlation_id, std::chrono::steady_clock::time_point arrival_time);
+
+  // Sends the requests aggregated by batching_client_ and resets it. Called with batching_lock_ held.
+  void sendBatch();
+
+  SubmitResult rejectRequest(const std::string& correlation_id,
+                             bool found_not_serving,
+                             const bftEngine::RequestCallBack& callback);
+
   void OnBatchingTimeout(ClientPtr client);
   bool clusterHasKeys(ClientPtr& cl);
   std::atomic_bool hasKeys_{false};
   std::atomic_bool stop_{false};
   size_t batch_size_ = 0UL;
+  std::chrono::milliseconds batch_flush_timeout_{0};
   bool client_batching_enabled_{false};
 
-  // Clients that are available for use (i.e. not already in use).
-  std::deque<ClientPtr> clients_;
+  // All clients of the pool. Doesn't change after the pool is created.
+  std::vector<ClientPtr> clients_;
+  std::unordered_map<const external_client::ConcordClient*, uint16_t> client_indexes_;
+
+  // Indexes into clients_ of the clients that are available for use (i.e. not already in use). Requests take clients
+  // and jobs return them without locking.
+  std::unique_ptr<boost::lockfree::queue<uint16_t, boost::lockfree::fixed_sized<true>>> free_clients_;
+  std::atomic_size_t num_free_clients_{0};
+
+  // The client that aggregates the current batch, if any. Taken out of the free clients queue while it aggregates.
+  ClientPtr batching_client_;
+  // Protects batching_client_ and batch_controller_
+  std::mutex batching_lock_;
+  // Set if batches are sized adaptively (client_batching_adaptive)
+  std::optional<::concord_client_pool::AdaptiveBatchController> batch_controller_;
 
   // Thread pool, on each thread on client will run
   concord::util::SimpleThreadPool jobs_thread_pool_;
-  // Clients queue mutex
-  std::mutex clients_queue_lock_;
+  // Protects cid_arrival_map_
+  std::mutex cid_arrival_lock_;
   // Metric
   concordMetrics::Component metricsComponent_;
   struct ClientPoolMetrics {
@@ -195,6 +238,9 @@ class ConcordClientPool {
     concordMetrics::GaugeHandle average_batch_agg_dur_gauge;
     concordMetrics::GaugeHandle average_cid_rcv_dur_gauge;
     concordMetrics::GaugeHandle average_cid_finish_dur_gauge;
+    concordMetrics::GaugeHandle adaptive_batch_size_gauge;
+    concordMetrics::GaugeHandle adaptive_flush_timeout_gauge;
+    concordMetrics::GaugeHandle arrival_rate_gauge;
   } ClientPoolMetrics_;
 
   // Logger
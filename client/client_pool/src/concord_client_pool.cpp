@@ -14,6 +14,7 @@
 #include "client/client_pool/concord_client_pool.hpp"
 
 #include <sparse_merkle/base_types.h>
+#include <algorithm>
 #include <mutex>
 #include <thread>
 #include <utility>
@@ -49,111 +50,157 @@ SubmitResult ConcordClientPool::SendRequest(std::vector<uint8_t> &&request,
     callback(bftEngine::SendResult{static_cast<uint32_t>(OperationResult::INVALID_REQUEST)});
     return SubmitResult::Overloaded;
   }
-  std::unique_lock<std::mutex> lock(clients_queue_lock_);
   metricsComponent_.UpdateAggregator();
-  auto serving_candidates = clients_.size();
-  int client_id = 0;
-
-  while (!clients_.empty() && serving_candidates != 0) {
-    auto client = clients_.front();
-    client_id = client->getClientId();
-    if (is_overloaded_) {
-      is_overloaded_ = false;
-    }
-    if (!client->isServing()) {
-      clients_.pop_front();
-      clients_.push_back(client);
-      --serving_candidates;
-      continue;
+  const auto arrival_time = std::chrono::steady_clock::now();
+  bool found_not_serving = false;
+
+  if (IsGoodForBatching(flags, client_batching_enabled_)) {
+    std::unique_lock<std::mutex> lock(batching_lock_);
+    if (!batching_client_ && !(batching_client_ = takeFreeClient(found_not_serving))) {
+      lock.unlock();
+      return rejectRequest(correlation_id, found_not_serving, callback);
     }
+    auto client = batching_client_;
+    auto client_id = client->getClientId();
     if (0 == seq_num) {
       seq_num = client->generateClientSeqNum();
       if (flags & ClientMsgFlag::RECONFIG_FLAG_REQ) {
         correlation_id += ("-" + std::to_string(seq_num));
       }
     }
-    if (cid_arrival_map_.size() > 7000)  // 7000 == 5 seconds of 700 trades per second
-      cid_arrival_map_.clear();
-    cid_arrival_map_[correlation_id] = std::chrono::steady_clock::now();
-    if (IsGoodForBatching(flags, client_batching_enabled_)) {
-      if (0 == client->PendingRequestsCount()) {
-        LOG_TRACE(logger_, "Set batching timer" << KVLOG(client_id));
-        batch_timer_->start(client);
-      }
-
-      if (flags & ClientMsgFlag::RECONFIG_FLAG_REQ) {
-        AddSenderAndSignature(request, client);
-      }
-      client->AddPendingRequest(std::move(request),
-                                flags,
-                                reply_buffer,
-                                timeout_ms,
-                                max_reply_size,
-                                seq_num,
-                                correlation_id,
-                                span_context,
-                                callback);
+    recordArrival(correlation_id, arrival_time);
+    auto batch_size = batch_size_;
+    auto flush_timeout = batch_flush_timeout_;
+    if (batch_controller_) {
+      batch_controller_->onRequestArrival(arrival_time);
+      batch_size = batch_controller_->batchSize();
+      flush_timeout = batch_controller_->flushTimeout();
+      ClientPoolMetrics_.adaptive_batch_size_gauge.Get().Set(batch_size);
+      ClientPoolMetrics_.adaptive_flush_timeout_gauge.Get().Set(flush_timeout.count());
+      ClientPoolMetrics_.arrival_rate_gauge.Get().Set((uint64_t)batch_controller_->arrivalRate());
+    }
+    if (0 == client->PendingRequestsCount()) {
+      LOG_TRACE(logger_, "Set batching timer" << KVLOG(client_id, flush_timeout.count()));
+      batch_timer_->start(client, flush_timeout);
+    }
 
-      if (correlation_id.find('-') != std::string::npos) {
-        ClientPoolMetrics_.first_leg_counter++;
-      } else {
-        ClientPoolMetrics_.second_leg_counter++;
-      }
-      LOG_DEBUG(
-          logger_,
-          "Added request" << KVLOG(seq_num, correlation_id, client->PendingRequestsCount(), batch_size_, client_id));
-
-      if (client->PendingRequestsCount() >= batch_size_) {
-        clients_.pop_front();
-        LOG_TRACE(logger_, "Cancel batching timer" << KVLOG(client_id));
-        auto batch_wait_time = batch_timer_->cancel();
-        batch_agg_dur_.add(batch_wait_time.count());
-        ClientPoolMetrics_.average_batch_agg_dur_gauge.Get().Set((uint64_t)batch_agg_dur_.avg());
-        if (batch_agg_dur_.numOfElements() == 1000) batch_agg_dur_.reset();
-        ClientPoolMetrics_.full_batch_counter++;
-        assignJobToClient(client);
-      }
-      LOG_DEBUG(logger_, "Request Acknowledged (batch)" << KVLOG(client_id, correlation_id, seq_num, flags));
-      return SubmitResult::Acknowledged;
+    if (flags & ClientMsgFlag::RECONFIG_FLAG_REQ) {
+      AddSenderAndSignature(request, client);
+    }
+    client->AddPendingRequest(std::move(request),
+                              flags,
+                              reply_buffer,
+                              timeout_ms,
+                              max_reply_size,
+                              seq_num,
+                              correlation_id,
+                              span_context,
+                              callback);
+
+    if (correlation_id.find('-') != std::string::npos) {
+      ClientPoolMetrics_.first_leg_counter++;
     } else {
-      clients_.pop_front();
-      if (0 != client->PendingRequestsCount()) {
-        LOG_TRACE(logger_, "Cancel batching timer" << KVLOG(client_id));
-        auto batch_wait_time = batch_timer_->cancel();
-        batch_agg_dur_.add(batch_wait_time.count());
-        ClientPoolMetrics_.average_batch_agg_dur_gauge.Get().Set((uint64_t)batch_agg_dur_.avg());
-        if (batch_agg_dur_.numOfElements() == 1000) {
-          batch_agg_dur_.reset();
-        }
-        ClientPoolMetrics_.full_batch_counter++;
-        assignJobToClient(client);
-      } else {
-        if (flags & ClientMsgFlag::RECONFIG_FLAG_REQ) {
-          AddSenderAndSignature(request, client);
-        }
-        assignJobToClient(client,
-                          std::move(request),
-                          flags,
-                          timeout_ms,
-                          reply_buffer,
-                          max_reply_size,
-                          seq_num,
-                          correlation_id,
-                          span_context,
-                          callback);
-        LOG_DEBUG(logger_, "Request Acknowledged (single)" << KVLOG(client_id, correlation_id, seq_num, flags));
-        return SubmitResult::Acknowledged;
-      }
+      ClientPoolMetrics_.second_leg_counter++;
     }
+    LOG_DEBUG(logger_,
+              "Added request" << KVLOG(seq_num, correlation_id, client->PendingRequestsCount(), batch_size, client_id));
+
+    if (client->PendingRequestsCount() >= batch_size) {
+      sendBatch();
+    }
+    LOG_DEBUG(logger_, "Request Acknowledged (batch)" << KVLOG(client_id, correlation_id, seq_num, flags));
+    return SubmitResult::Acknowledged;
   }
 
+  {
+    // As requests that can't be batched are sent right away, the pending batch is sent first
+    std::unique_lock<std::mutex> lock(batching_lock_);
+    if (batching_client_ && 0 != batching_client_->PendingRequestsCount()) {
+      sendBatch();
+    }
+  }
+  auto client = takeFreeClient(found_not_serving);
+  if (!client) {
+    return rejectRequest(correlation_id, found_not_serving, callback);
+  }
+  auto client_id = client->getClientId();
+  if (0 == seq_num) {
+    seq_num = client->generateClientSeqNum();
+    if (flags & ClientMsgFlag::RECONFIG_FLAG_REQ) {
+      correlation_id += ("-" + std::to_string(seq_num));
+    }
+  }
+  recordArrival(correlation_id, arrival_time);
+  if (flags & ClientMsgFlag::RECONFIG_FLAG_REQ) {
+    AddSenderAndSignature(request, client);
+  }
+  assignJobToClient(client,
+                    std::move(request),
+                    flags,
+                    timeout_ms,
+                    reply_buffer,
+                    max_reply_size,
+                    seq_num,
+                    correlation_id,
+                    span_context,
+                    callback);
+  LOG_DEBUG(logger_, "Request Acknowledged (single)" << KVLOG(client_id, correlation_id, seq_num, flags));
+  return SubmitResult::Acknowledged;
+}
+
+void ConcordClientPool::sendBatch() {
+  auto client = std::move(batching_client_);
+  const auto client_id = client->getClientId();
+  LOG_TRACE(logger_, "Cancel batching timer" << KVLOG(client_id));
+  auto batch_wait_time = batch_timer_->cancel();
+  batch_agg_dur_.add(batch_wait_time.count());
+  ClientPoolMetrics_.average_batch_agg_dur_gauge.Get().Set((uint64_t)batch_agg_dur_.avg());
+  if (batch_agg_dur_.numOfElements() == 1000) batch_agg_dur_.reset();
+  ClientPoolMetrics_.full_batch_counter++;
+  assignJobToClient(client);
+}
+
+ConcordClientPool::ClientPtr ConcordClientPool::takeFreeClient(bool &found_not_serving) {
+  // Clients that are not serving are put back at the end of the queue, so every free client is tried at most once
+  auto candidates = num_free_clients_.load();
+  uint16_t index = 0;
+  while (candidates-- > 0 && free_clients_->pop(index)) {
+    const auto &client = clients_[index];
+    if (!client->isServing()) {
+      found_not_serving = true;
+      free_clients_->push(index);
+      continue;
+    }
+    num_free_clients_--;
+    is_overloaded_ = false;
+    return client;
+  }
+  return nullptr;
+}
+
+void ConcordClientPool::recordArrival(const std::string &correlation_id,
+                                      std::chrono::steady_clock::time_point arrival_time) {
+  std::unique_lock<std::mutex> lock(cid_arrival_lock_);
+  if (cid_arrival_map_.size() > 7000)  // 7000 == 5 seconds of 700 trades per second
+    cid_arrival_map_.clear();
+  cid_arrival_map_[correlation_id] = arrival_time;
+}
+
+void ConcordClientPool::returnFreeClient(const ClientPtr &client) {
+  num_free_clients_++;
+  free_clients_->push(client_indexes_.at(client.get()));
+}
+
+SubmitResult ConcordClientPool::rejectRequest(const std::string &correlation_id,
+                                              bool found_not_serving,
+                                              const bftEngine::RequestCallBack &callback) {
   // None of the available clients are either ready or all of the clients are busy,
   // so client pool will have to reject the request
   ClientPoolMetrics_.rejected_counter++;
   is_overloaded_ = true;
   LOG_WARN(logger_, "Cannot allocate client for" << KVLOG(correlation_id));
   if (callback) {
-    if (serving_candidates == 0 && !clients_.empty()) {
+    if (found_not_serving) {
       callback(bftEngine::SendResult{static_cast<uint32_t>(OperationResult::NOT_READY)});
     } else {
       callback(bftEngine::SendResult{static_cast<uint32_t>(OperationResult::OVERLOADED)});
@@ -169,7 +216,7 @@ void ConcordClientPool::assignJobToClient(const ClientPtr &client) {
   auto *job = new BatchRequestProcessingJob(*this, client);
   ClientPoolMetrics_.requests_counter += client->PendingRequestsCount();
   ClientPoolMetrics_.size_of_batch_gauge.Get().Set(client->PendingRequestsCount());
-  ClientPoolMetrics_.clients_gauge.Get().Set(clients_.size());
+  ClientPoolMetrics_.clients_gauge.Get().Set(num_free_clients_);
   jobs_thread_pool_.add(job);
 }
 
@@ -201,7 +248,7 @@ void ConcordClientPool::assignJobToClient(const ClientPtr &client,
                                              span_context,
                                              callback);
   ClientPoolMetrics_.requests_counter++;
-  ClientPoolMetrics_.clients_gauge.Get().Set(clients_.size());
+  ClientPoolMetrics_.clients_gauge.Get().Set(num_free_clients_);
   jobs_thread_pool_.add(job);
 }
 
@@ -248,6 +295,64 @@ SubmitResult ConcordClientPool::SendRequest(const bft::client::ReadConfig &confi
                      callback);
 }
 
+SubmitResult ConcordClientPool::SendRequests(std::deque<bft::client::WriteRequest> &&requests,
+                                             const std::vector<bftEngine::RequestCallBack> &callbacks) {
+  ConcordAssertEQ(requests.size(), callbacks.size());
+  LOG_DEBUG(logger_, "Received write requests" << KVLOG(requests.size()));
+  auto result = SubmitResult::Acknowledged;
+  // Indexes of the requests that are sent in batches
+  std::vector<size_t> batched;
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const auto &config = requests[i].config.request;
+    if (client_batching_enabled_ && config.pre_execute && !config.reconfiguration && config.timeout.count() > 0) {
+      batched.push_back(i);
+    } else if (SendRequest(requests[i].config, std::move(requests[i].request), callbacks[i]) !=
+               SubmitResult::Acknowledged) {
+      result = SubmitResult::Overloaded;
+    }
+  }
+  if (batched.empty()) return result;
+
+  metricsComponent_.UpdateAggregator();
+  const auto arrival_time = std::chrono::steady_clock::now();
+  const auto batch_size = std::max<size_t>(batch_size_, 1);
+  for (size_t begin = 0; begin < batched.size(); begin += batch_size) {
+    const auto end = std::min(begin + batch_size, batched.size());
+    bool found_not_serving = false;
+    auto client = takeFreeClient(found_not_serving);
+    if (!client) {
+      for (auto j = begin; j < end; ++j) {
+        rejectRequest(requests[batched[j]].config.request.correlation_id, found_not_serving, callbacks[batched[j]]);
+      }
+      result = SubmitResult::Overloaded;
+      continue;
+    }
+    for (auto j = begin; j < end; ++j) {
+      auto &config = requests[batched[j]].config.request;
+      auto seq_num = config.sequence_number ? config.sequence_number : client->generateClientSeqNum();
+      recordArrival(config.correlation_id, arrival_time);
+      client->AddPendingRequest(std::move(requests[batched[j]].request),
+                                ClientMsgFlag::PRE_PROCESS_REQ,
+                                nullptr,
+                                config.timeout,
+                                config.max_reply_size,
+                                seq_num,
+                                config.correlation_id,
+                                config.span_context,
+                                callbacks[batched[j]]);
+      if (config.correlation_id.find('-') != std::string::npos) {
+        ClientPoolMetrics_.first_leg_counter++;
+      } else {
+        ClientPoolMetrics_.second_leg_counter++;
+      }
+    }
+    LOG_DEBUG(logger_, "Requests Acknowledged (batch)" << KVLOG(client->getClientId(), client->PendingRequestsCount()));
+    ClientPoolMetrics_.full_batch_counter++;
+    assignJobToClient(client);
+  }
+  return result;
+}
+
 std::unique_ptr<ConcordClientPool> ConcordClientPool::create(config_pool::ConcordClientPoolConfig &config,
                                                              std::shared_ptr<concordMetrics::Aggregator> aggregator) {
   return std::make_unique<ConcordClientPool>(config, aggregator);
@@ -271,7 +376,10 @@ ConcordClientPool::ConcordClientPool(config_pool::ConcordClientPoolConfig &confi
                          metricsComponent_.RegisterGauge("average_req_dur_gauge", 0),
                          metricsComponent_.RegisterGauge("average_batch_agg_dur_gauge", 0),
                          metricsComponent_.RegisterGauge("average_cid_rcv_dur_gauge", 0),
-                         metricsComponent_.RegisterGauge("average_cid_finish_dur_gauge", 0)},
+                         metricsComponent_.RegisterGauge("average_cid_finish_dur_gauge", 0),
+                         metricsComponent_.RegisterGauge("adaptive_batch_size_gauge", 0),
+                         metricsComponent_.RegisterGauge("adaptive_flush_timeout_gauge", 0),
+                         metricsComponent_.RegisterGauge("arrival_rate_gauge", 0)},
       logger_(logging::getLogger("com.vmware.external_client_pool")) {
   concord::external_client::ConcordClient::setDelayFlagForTest(delay_behavior);
   try {
@@ -302,7 +410,10 @@ ConcordClientPool::ConcordClientPool(config_pool::ConcordClientPoolConfig &confi
                          metricsComponent_.RegisterGauge("average_req_dur_gauge", 0),
                          metricsComponent_.RegisterGauge("average_batch_agg_dur_gauge", 0),
                          metricsComponent_.RegisterGauge("average_cid_rcv_dur_gauge", 0),
-                         metricsComponent_.RegisterGauge("average_cid_finish_dur_gauge", 0)},
+                         metricsComponent_.RegisterGauge("average_cid_finish_dur_gauge", 0),
+                         metricsComponent_.RegisterGauge("adaptive_batch_size_gauge", 0),
+                         metricsComponent_.RegisterGauge("adaptive_flush_timeout_gauge", 0),
+                         metricsComponent_.RegisterGauge("arrival_rate_gauge", 0)},
       logger_(logging::getLogger("com.vmware.external_client_pool")) {
   try {
     metricsComponent_.SetAggregator(aggregator);
@@ -371,7 +482,11 @@ void ConcordClientPool::CreatePool(concord::config_pool::ConcordClientPoolConfig
   if (config.client_batching_enabled) {
     batch_size_ = config.client_batching_max_messages_nbr;
     timeout = std::chrono::milliseconds(config.client_batching_flush_timeout_ms);
+    batch_flush_timeout_ = timeout;
     client_batching_enabled_ = true;
+    if (config.client_batching_adaptive) {
+      batch_controller_.emplace(batch_size_, timeout, num_clients);
+    }
   }
   batch_timer_ =
       std::make_unique<Timer_t>(timeout, [this](ClientPtr client) -> void { OnBatchingTimeout(std::move(client)); });
@@ -413,8 +528,13 @@ void ConcordClientPool::CreatePool(concord::config_pool::ConcordClientPoolConfig
   external_client::ConcordClient::setStatics(
       required_num_of_replicas, num_replicas, max_buf_size, batch_size_, config, clientParams, tlsMultiplexConfig);
 #endif
+  free_clients_ = std::make_unique<boost::lockfree::queue<uint16_t, boost::lockfree::fixed_sized<true>>>(
+      std::max(num_clients, 1));
   for (int i = 0; i < num_clients; i++) {
     clients_.push_back(std::make_shared<external_client::ConcordClient>(i, aggregator));
+    client_indexes_[clients_.back().get()] = i;
+    free_clients_->push(i);
+    num_free_clients_++;
     ClientPoolMetrics_.clients_gauge++;
   }
   jobs_thread_pool_.start(num_clients);
@@ -434,15 +554,15 @@ void ConcordClientPool::AddSenderAndSignature(std::vector<uint8_t> &request, con
 
 void ConcordClientPool::OnBatchingTimeout(std::shared_ptr<concord::external_client::ConcordClient> client) {
   {
-    std::unique_lock<std::mutex> lock(clients_queue_lock_);
+    std::unique_lock<std::mutex> lock(batching_lock_);
     const auto client_id = client->getClientId();
     LOG_INFO(logger_,
              "Client reached batching timeout" << KVLOG(client_id, batch_size_, client->PendingRequestsCount()));
-    if (client != clients_.front()) {
+    if (client != batching_client_) {
       LOG_DEBUG(logger_, "Client is already processing other requests" << KVLOG(client_id));
       return;
     }
-    clients_.pop_front();
+    batching_client_.reset();
   }
   ClientPoolMetrics_.partial_batch_counter++;
   assignJobToClient(client);
@@ -451,7 +571,6 @@ void ConcordClientPool::OnBatchingTimeout(std::shared_ptr<concord::external_clie
 ConcordClientPool::~ConcordClientPool() {
   batch_timer_->stopTimerThread();
   jobs_thread_pool_.stop(true);
-  std::unique_lock<std::mutex> clients_lock(clients_queue_lock_);
   for (auto &client : clients_) {
     client->stopClientComm();
   }
@@ -516,9 +635,13 @@ void ConcordClientPool::processReplies(ClientPtr &client,
   ClientPoolMetrics_.average_req_dur_gauge.Get().Set((uint64_t)average_req_dur_.avg());
   if (average_req_dur_.numOfElements() == 1000) average_req_dur_.reset();  // reset the average every 1000 samples
   ClientPoolMetrics_.executed_requests_counter++;
+  if (batch_controller_) {
+    std::unique_lock<std::mutex> lock(batching_lock_);
+    batch_controller_->onReply(std::chrono::milliseconds{duration});
+  }
   metricsComponent_.UpdateAggregator();
   {
-    std::unique_lock<std::mutex> lock(clients_queue_lock_);
+    std::unique_lock<std::mutex> lock(cid_arrival_lock_);
     auto finish = std::chrono::steady_clock::now();
     for (const auto &reply : replies.second) {
       auto before_send = client->getAndDeleteCidBeforeSendTime(reply.cid);
@@ -536,30 +659,29 @@ void ConcordClientPool::processReplies(ClientPtr &client,
   if (average_cid_close_dur_.numOfElements() >= 1000) average_cid_close_dur_.reset();
   ClientPoolMetrics_.average_cid_rcv_dur_gauge.Get().Set((uint64_t)average_cid_receive_dur_.avg());
   if (average_cid_receive_dur_.numOfElements() >= 1000) average_cid_receive_dur_.reset();
-  {
-    std::unique_lock<std::mutex> lock(clients_queue_lock_);
-    clients_.push_back(client);
-  }
   OperationResult operation_result = client->getRequestExecutionResult();
+  returnFreeClient(client);
   if (replies.second.front().cb && operation_result != OperationResult::SUCCESS) {
     for (const auto &reply : replies.second) reply.cb(SendResult{static_cast<uint32_t>(operation_result)});
   }
 }
 
 PoolStatus ConcordClientPool::HealthStatus() {
-  std::unique_lock<std::mutex> lock(clients_queue_lock_);
-  for (auto &client : clients_) {
-    if (client->isServing()) {
-      if (!hasKeys_ && !(hasKeys_ = clusterHasKeys(client))) {
-        LOG_DEBUG(logger_, "The key exchange is not completed - the pool is not ready");
-        return PoolStatus::NotServing;
-      }
-      LOG_INFO(logger_, "client_id=" << client->getClientId() << " is serving - the pool is ready");
-      return PoolStatus::Serving;
-    }
+  bool found_not_serving = false;
+  auto client = takeFreeClient(found_not_serving);
+  if (!client) {
+    LOG_DEBUG(logger_, "None of clients is serving - the pool is not ready");
+    return PoolStatus::NotServing;
+  }
+  auto status = PoolStatus::Serving;
+  if (!hasKeys_ && !(hasKeys_ = clusterHasKeys(client))) {
+    LOG_DEBUG(logger_, "The key exchange is not completed - the pool is not ready");
+    status = PoolStatus::NotServing;
+  } else {
+    LOG_INFO(logger_, "client_id=" << client->getClientId() << " is serving - the pool is ready");
   }
-  LOG_DEBUG(logger_, "None of clients is serving - the pool is not ready");
-  return PoolStatus::NotServing;
+  returnFreeClient(client);
+  return status;
 }
 
 bool ConcordClientPool::clusterHasKeys(ClientPtr &cl) {
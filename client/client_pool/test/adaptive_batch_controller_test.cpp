@@ -0,0 +1,77 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <chrono>
+
+#include "client/client_pool/adaptive_batch_controller.hpp"
+#include "gtest/gtest.h"
+
+using concord_client_pool::AdaptiveBatchController;
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+using namespace std::chrono_literals;
+
+const size_t kMaxBatchSize = 20;
+const milliseconds kMaxFlushTimeout = 50ms;
+
+// Feed requests arriving every interval, each taking latency to be replied
+void feed(AdaptiveBatchController& controller, microseconds interval, milliseconds latency) {
+  auto now = AdaptiveBatchController::Clock::now();
+  for (int i = 0; i < 100; ++i) {
+    controller.onRequestArrival(now);
+    controller.onReply(latency);
+    now += interval;
+  }
+}
+
+TEST(adaptive_batch_controller, staticBatchingWithoutSamples) {
+  auto controller = AdaptiveBatchController(kMaxBatchSize, kMaxFlushTimeout, 4);
+  EXPECT_EQ(controller.batchSize(), kMaxBatchSize);
+  EXPECT_EQ(controller.flushTimeout(), kMaxFlushTimeout);
+
+  controller.onReply(10ms);
+  EXPECT_EQ(controller.batchSize(), kMaxBatchSize);
+  EXPECT_EQ(controller.flushTimeout(), kMaxFlushTimeout);
+}
+
+TEST(adaptive_batch_controller, lowLoadSendsRequestsRightAway) {
+  auto controller = AdaptiveBatchController(kMaxBatchSize, kMaxFlushTimeout, 4);
+  feed(controller, 100ms, 10ms);
+  EXPECT_EQ(controller.batchSize(), 1u);
+  EXPECT_DOUBLE_EQ(controller.arrivalRate(), 10.0);
+  EXPECT_EQ(controller.replyLatency(), 10ms);
+}
+
+TEST(adaptive_batch_controller, batchesGrowWithLoad) {
+  auto controller = AdaptiveBatchController(kMaxBatchSize, kMaxFlushTimeout, 2);
+  // 1000 requests per second, 20ms latency and 2 clients - each client has to send 10 requests per batch
+  feed(controller, 1ms, 20ms);
+  EXPECT_EQ(controller.batchSize(), 10u);
+  EXPECT_EQ(controller.flushTimeout(), 10ms);
+
+  // 10000 requests per second - capped by the max batch size, which fills within 2ms
+  auto busy_controller = AdaptiveBatchController(kMaxBatchSize, kMaxFlushTimeout, 2);
+  feed(busy_controller, 100us, 20ms);
+  EXPECT_EQ(busy_controller.batchSize(), kMaxBatchSize);
+  EXPECT_EQ(busy_controller.flushTimeout(), 2ms);
+}
+
+TEST(adaptive_batch_controller, flushTimeoutIsBounded) {
+  auto controller = AdaptiveBatchController(kMaxBatchSize, kMaxFlushTimeout, 1);
+  // 20 requests per second and 1s latency - a batch of 20 takes 1s to fill
+  feed(controller, 50ms, 1000ms);
+  EXPECT_EQ(controller.batchSize(), kMaxBatchSize);
+  EXPECT_EQ(controller.flushTimeout(), kMaxFlushTimeout);
+}
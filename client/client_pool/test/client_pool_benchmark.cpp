@@ -0,0 +1,132 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "client/client_pool/concord_client_pool.hpp"
+
+// Throughput and latency of batched (pre-processed) requests submitted to the client pool by several threads. The
+// replicas are faked in-process by the pool's mock communication (see bftclient/fake_comm.h), which replies to every
+// request of a batch right away, i.e. the measured time is spent in the pool and the clients.
+//
+// The replica cluster test harness (tests/apollo) runs the replicas as separate processes, driven from Python, so
+// it isn't used here. Its timing would be dominated by consensus and execution rather than by the pool.
+
+namespace {
+
+using namespace std::chrono_literals;
+
+using concord::concord_client_pool::ConcordClientPool;
+using concord::concord_client_pool::SubmitResult;
+using concord::config_pool::ConcordClientPoolConfig;
+
+constexpr uint16_t kNumClients = 8;
+constexpr size_t kRequestsPerSubmitter = 2000;
+
+ConcordClientPoolConfig makeConfig(bool adaptive) {
+  ConcordClientPoolConfig config;
+  config.enable_mock_comm = true;
+  config.clients_per_participant_node = kNumClients;
+  config.client_batching_enabled = true;
+  config.client_batching_adaptive = adaptive;
+  config.client_batching_max_messages_nbr = 20;
+  config.client_batching_flush_timeout_ms = 10;
+  config.client_initial_retry_timeout_milli = 1000;
+  config.client_min_retry_timeout_milli = 1000;
+  config.client_max_retry_timeout_milli = 1000;
+  for (uint16_t i = 0; i < config.num_replicas; ++i) {
+    config.replicas[i] = bft::communication::NodeInfo{"127.0.0.1", static_cast<uint16_t>(3710 + 2 * i), true};
+  }
+  concord::config_pool::ParticipantNode node;
+  node.participant_node_host = "127.0.0.1";
+  node.principal_id = config.num_replicas + config.client_proxies_per_replica * config.num_replicas;
+  for (uint16_t i = 0; i < kNumClients; ++i) {
+    node.externalClients[i] = concord::config_pool::ExternalClient{static_cast<uint16_t>(4000 + i),
+                                                                   static_cast<uint16_t>(node.principal_id + 1 + i)};
+  }
+  config.participant_nodes.push_back(node);
+  return config;
+}
+
+void submitBatched(benchmark::State& state, bool adaptive) {
+  const auto num_submitters = static_cast<size_t>(state.range(0));
+  auto config = makeConfig(adaptive);
+  ConcordClientPool pool{config, std::make_shared<concordMetrics::Aggregator>()};
+
+  std::vector<double> latencies_ms;
+  std::mutex latencies_lock;
+  for (auto _ : state) {
+    std::atomic_size_t num_replies{0};
+    std::vector<std::thread> submitters;
+    for (size_t s = 0; s < num_submitters; ++s) {
+      submitters.emplace_back([&, s] {
+        for (size_t i = 0; i < kRequestsPerSubmitter; ++i) {
+          const auto cid = std::to_string(s) + "-" + std::to_string(i);
+          const auto start = std::chrono::steady_clock::now();
+          auto callback = [&, start](bftEngine::SendResult&&) {
+            const auto latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+            {
+              std::lock_guard<std::mutex> guard(latencies_lock);
+              latencies_ms.push_back(latency.count());
+            }
+            num_replies++;
+          };
+          // Retry until a client is free
+          while (pool.SendRequest(std::vector<uint8_t>(64, 'r'),
+                                  bftEngine::ClientMsgFlag::PRE_PROCESS_REQ,
+                                  5s,
+                                  nullptr,
+                                  0,
+                                  0,
+                                  cid,
+                                  {},
+                                  callback) != SubmitResult::Acknowledged) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (auto& submitter : submitters) {
+      submitter.join();
+    }
+    while (num_replies < num_submitters * kRequestsPerSubmitter) {
+      std::this_thread::sleep_for(1ms);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_submitters * kRequestsPerSubmitter);
+
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  if (!latencies_ms.empty()) {
+    state.counters["p50_latency_ms"] = latencies_ms[latencies_ms.size() / 2];
+    state.counters["p99_latency_ms"] = latencies_ms[latencies_ms.size() * 99 / 100];
+  }
+}
+
+void staticBatching(benchmark::State& state) { submitBatched(state, false); }
+void adaptiveBatching(benchmark::State& state) { submitBatched(state, true); }
+
+}  // namespace
+
+BENCHMARK(staticBatching)->Arg(1)->Arg(4)->Arg(16)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(adaptiveBatching)->Arg(1)->Arg(4)->Arg(16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,266 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "client/client_pool/concord_client_pool.hpp"
+#include "gtest/gtest.h"
+
+// Tests of ConcordClientPool::SendRequests. The replicas are faked by the pool's mock communication (see
+// bftclient/fake_comm.h), which echoes every request of a batch as a separate reply with the data "reply".
+
+using bftEngine::OperationResult;
+using concord::concord_client_pool::ConcordClientPool;
+using concord::concord_client_pool::SubmitResult;
+using concord::config_pool::ConcordClientPoolConfig;
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint16_t kBatchSize = 4;
+
+ConcordClientPoolConfig makeConfig(uint16_t num_clients) {
+  ConcordClientPoolConfig config;
+  config.enable_mock_comm = true;
+  config.clients_per_participant_node = num_clients;
+  config.client_batching_enabled = true;
+  config.client_batching_max_messages_nbr = kBatchSize;
+  config.client_batching_flush_timeout_ms = 10;
+  config.client_initial_retry_timeout_milli = 1000;
+  config.client_min_retry_timeout_milli = 1000;
+  config.client_max_retry_timeout_milli = 1000;
+  for (uint16_t i = 0; i < config.num_replicas; ++i) {
+    config.replicas[i] = bft::communication::NodeInfo{"127.0.0.1", static_cast<uint16_t>(3710 + 2 * i), true};
+  }
+  concord::config_pool::ParticipantNode node;
+  node.participant_node_host = "127.0.0.1";
+  node.principal_id = config.num_replicas + config.client_proxies_per_replica * config.num_replicas;
+  for (uint16_t i = 0; i < num_clients; ++i) {
+    node.externalClients[i] = concord::config_pool::ExternalClient{static_cast<uint16_t>(4000 + i),
+                                                                   static_cast<uint16_t>(node.principal_id + 1 + i)};
+  }
+  config.participant_nodes.push_back(node);
+  return config;
+}
+
+// Collects the result of every request of a SendRequests call
+class Results {
+ public:
+  explicit Results(size_t num_requests) : results_(num_requests) {}
+
+  bftEngine::RequestCallBack callback(size_t index) {
+    return [this, index](bftEngine::SendResult&& result) {
+      std::lock_guard<std::mutex> lock(lock_);
+      results_[index] = std::move(result);
+      ++num_called_[index];
+      ++num_done_;
+    };
+  }
+
+  bool waitForAll(std::chrono::milliseconds timeout = 10s) const {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (num_done_ < results_.size() && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(5ms);
+    }
+    return num_done_ == results_.size();
+  }
+
+  bool isReply(size_t index) const {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (!std::holds_alternative<bft::client::Reply>(results_[index])) return false;
+    const auto& data = std::get<bft::client::Reply>(results_[index]).matched_data;
+    return std::string(data.begin(), data.end()) == "reply";
+  }
+
+  bool isError(size_t index, OperationResult error) const {
+    std::lock_guard<std::mutex> lock(lock_);
+    return std::holds_alternative<uint32_t>(results_[index]) &&
+           std::get<uint32_t>(results_[index]) == static_cast<uint32_t>(error);
+  }
+
+  size_t numCalled(size_t index) const {
+    std::lock_guard<std::mutex> lock(lock_);
+    return num_called_.count(index) ? num_called_.at(index) : 0;
+  }
+
+ private:
+  mutable std::mutex lock_;
+  std::vector<bftEngine::SendResult> results_;
+  std::map<size_t, size_t> num_called_;
+  std::atomic_size_t num_done_{0};
+};
+
+bft::client::WriteRequest makeRequest(const std::string& cid, bool pre_execute) {
+  bft::client::WriteConfig config;
+  config.request.pre_execute = pre_execute;
+  config.request.correlation_id = cid;
+  config.request.timeout = 5s;
+  return bft::client::WriteRequest{config, bft::client::Msg{'r', 'e', 'q'}};
+}
+
+// The pool only pushes its metrics to the aggregator when it handles requests and replies, so wait for the last update
+bool waitForCounter(concordMetrics::Aggregator& aggregator, const std::string& name, uint64_t expected) {
+  const auto deadline = std::chrono::steady_clock::now() + 10s;
+  while (aggregator.GetCounter("ClientPool", name).Get() != expected && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(5ms);
+  }
+  return aggregator.GetCounter("ClientPool", name).Get() == expected;
+}
+
+TEST(client_pool_send_requests, splits_into_batches) {
+  auto config = makeConfig(4);
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  ConcordClientPool pool{config, aggregator, false};
+
+  // Two full batches and a partial one, all sent right away
+  const size_t num_requests = 2 * kBatchSize + 1;
+  std::deque<bft::client::WriteRequest> requests;
+  Results results{num_requests};
+  std::vector<bftEngine::RequestCallBack> callbacks;
+  for (size_t i = 0; i < num_requests; ++i) {
+    // Requests of the first leg have a '-' in their correlation id
+    requests.push_back(makeRequest(i % 2 ? "batch-" + std::to_string(i) : std::to_string(i), true));
+    callbacks.push_back(results.callback(i));
+  }
+  ASSERT_EQ(pool.SendRequests(std::move(requests), callbacks), SubmitResult::Acknowledged);
+
+  ASSERT_TRUE(results.waitForAll());
+  for (size_t i = 0; i < num_requests; ++i) {
+    EXPECT_TRUE(results.isReply(i)) << "request " << i;
+    EXPECT_EQ(results.numCalled(i), 1u) << "request " << i;
+  }
+  EXPECT_TRUE(waitForCounter(*aggregator, "full_batch_counter", 3));
+  EXPECT_TRUE(waitForCounter(*aggregator, "first_leg_counter", num_requests / 2));
+  EXPECT_TRUE(waitForCounter(*aggregator, "second_leg_counter", num_requests - num_requests / 2));
+}
+
+TEST(client_pool_send_requests, batches_only_pre_executed_requests) {
+  auto config = makeConfig(4);
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  ConcordClientPool pool{config, aggregator, false};
+
+  // Interleave pre-executed requests, which fill exactly one batch, with requests that are sent one by one
+  const size_t num_requests = 2 * kBatchSize;
+  std::deque<bft::client::WriteRequest> requests;
+  Results results{num_requests};
+  std::vector<bftEngine::RequestCallBack> callbacks;
+  for (size_t i = 0; i < num_requests; ++i) {
+    requests.push_back(makeRequest("mixed-" + std::to_string(i), i % 2 == 0));
+    callbacks.push_back(results.callback(i));
+  }
+  ASSERT_EQ(pool.SendRequests(std::move(requests), callbacks), SubmitResult::Acknowledged);
+
+  ASSERT_TRUE(results.waitForAll());
+  for (size_t i = 0; i < num_requests; ++i) {
+    EXPECT_TRUE(results.isReply(i)) << "request " << i;
+    EXPECT_EQ(results.numCalled(i), 1u) << "request " << i;
+  }
+  EXPECT_TRUE(waitForCounter(*aggregator, "full_batch_counter", 1));
+  EXPECT_TRUE(waitForCounter(*aggregator, "first_leg_counter", kBatchSize));
+}
+
+TEST(client_pool_send_request, non_batchable_request_sends_pending_batch) {
+  auto config = makeConfig(4);
+  // Long enough for the batch not to be sent on timeout
+  config.client_batching_flush_timeout_ms = 10000;
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  ConcordClientPool pool{config, aggregator, false};
+
+  // A partial batch, followed by a request that isn't pre-executed
+  Results results{3};
+  for (size_t i = 0; i < 3; ++i) {
+    auto request = makeRequest("flush-" + std::to_string(i), i < 2);
+    ASSERT_EQ(pool.SendRequest(request.config, std::move(request.request), results.callback(i)),
+              SubmitResult::Acknowledged);
+  }
+
+  ASSERT_TRUE(results.waitForAll(5s));
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_TRUE(results.isReply(i)) << "request " << i;
+  }
+  EXPECT_TRUE(waitForCounter(*aggregator, "full_batch_counter", 1));
+  EXPECT_EQ(aggregator->GetCounter("ClientPool", "partial_batch_counter").Get(), 0u);
+}
+
+TEST(client_pool_send_requests, per_request_result) {
+  auto config = makeConfig(4);
+  ConcordClientPool pool{config, std::make_shared<concordMetrics::Aggregator>(), false};
+
+  // A pre-executed request without a timeout is invalid and fails on its own, the rest of the batch succeeds
+  std::deque<bft::client::WriteRequest> requests;
+  Results results{3};
+  std::vector<bftEngine::RequestCallBack> callbacks;
+  for (size_t i = 0; i < 3; ++i) {
+    requests.push_back(makeRequest("result-" + std::to_string(i), true));
+    callbacks.push_back(results.callback(i));
+  }
+  requests[1].config.request.timeout = 0ms;
+  EXPECT_EQ(pool.SendRequests(std::move(requests), callbacks), SubmitResult::Overloaded);
+
+  ASSERT_TRUE(results.waitForAll());
+  EXPECT_TRUE(results.isReply(0));
+  EXPECT_TRUE(results.isError(1, OperationResult::INVALID_REQUEST));
+  EXPECT_TRUE(results.isReply(2));
+}
+
+TEST(client_pool_send_requests, empty) {
+  auto config = makeConfig(1);
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  ConcordClientPool pool{config, aggregator, false};
+
+  EXPECT_EQ(pool.SendRequests({}, {}), SubmitResult::Acknowledged);
+  EXPECT_EQ(aggregator->GetCounter("ClientPool", "full_batch_counter").Get(), 0u);
+}
+
+TEST(client_pool_send_requests, pool_exhausted) {
+  // A single client, which is kept busy by the replies being delayed
+  auto config = makeConfig(1);
+  auto aggregator = std::make_shared<concordMetrics::Aggregator>();
+  ConcordClientPool pool{config, aggregator, true};
+
+  const size_t num_requests = 3 * kBatchSize;
+  std::deque<bft::client::WriteRequest> requests;
+  Results results{num_requests};
+  std::vector<bftEngine::RequestCallBack> callbacks;
+  for (size_t i = 0; i < num_requests; ++i) {
+    requests.push_back(makeRequest("exhausted-" + std::to_string(i), true));
+    callbacks.push_back(results.callback(i));
+  }
+  EXPECT_EQ(pool.SendRequests(std::move(requests), callbacks), SubmitResult::Overloaded);
+
+  // The first batch is sent, the others are rejected, and every request gets exactly one result
+  ASSERT_TRUE(results.waitForAll());
+  for (size_t i = 0; i < num_requests; ++i) {
+    if (i < kBatchSize) {
+      EXPECT_TRUE(results.isReply(i)) << "request " << i;
+    } else {
+      EXPECT_TRUE(results.isError(i, OperationResult::OVERLOADED)) << "request " << i;
+    }
+    EXPECT_EQ(results.numCalled(i), 1u) << "request " << i;
+  }
+  EXPECT_TRUE(waitForCounter(*aggregator, "full_batch_counter", 1));
+  EXPECT_TRUE(waitForCounter(*aggregator, "rejected_counter", num_requests - kBatchSize));
+}
+
+}  // namespace
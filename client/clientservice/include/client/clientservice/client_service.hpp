@@ -37,6 +37,7 @@ class ClientService {
     requestservice::RequestServiceCallData::setMetricDumpInterval(metrics_dump_interval);
   };
 
+  // Every async thread polls its own completion queue. If num_async_threads is 0, one thread per core is started.
   void start(const std::string& addr, unsigned num_async_threads, uint64_t max_receive_msg_size);
 
   // Blocks waiting for all work to complete
@@ -0,0 +1,74 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "crypto/digest.hpp"
+
+// Client side computation of the public state hashes that the replicas persist for DB snapshots (see
+// concord::kvbc::IKVBCStateSnapshot). Clientservice doesn't depend on kvbc, so the hashes are computed here as well -
+// test/public_state_hash_test.cpp checks both implementations agree.
+
+namespace concord::client::clientservice {
+
+// Must be equal to concord::kvbc::kPublicStateHashPartitionSize
+constexpr uint64_t kPublicStateHashPartitionSize = 4096;
+
+inline concord::crypto::SHA3_256::Digest singleHash(const std::string& key) {
+  return concord::crypto::SHA3_256{}.digest(key.data(), key.size());
+}
+
+// h = hash(h || hash(key) || value)
+inline void nextHash(const std::string& key, const std::string& value, concord::crypto::SHA3_256::Digest& prev_hash) {
+  auto hasher = concord::crypto::SHA3_256{};
+  hasher.init();
+  hasher.update(prev_hash.data(), prev_hash.size());
+  const auto key_hash = singleHash(key);
+  hasher.update(key_hash.data(), key_hash.size());
+  hasher.update(value.data(), value.size());
+  prev_hash = hasher.finish();
+}
+
+// Computes the partitioned public state hash, i.e. the hash of the chained hashes of consecutive partitions of
+// kPublicStateHashPartitionSize keys. Keys are expected in their sorted order.
+class PartitionedHash {
+ public:
+  PartitionedHash() { hasher_.init(); }
+
+  void next(const std::string& key, const std::string& value) {
+    nextHash(key, value, partition_hash_);
+    if (++partition_keys_ == kPublicStateHashPartitionSize) {
+      finishPartition();
+    }
+  }
+
+  concord::crypto::SHA3_256::Digest finish() {
+    if (partition_keys_ > 0) {
+      finishPartition();
+    }
+    return hasher_.finish();
+  }
+
+ private:
+  void finishPartition() {
+    hasher_.update(partition_hash_.data(), partition_hash_.size());
+    partition_hash_ = singleHash(std::string{});
+    partition_keys_ = 0;
+  }
+
+  concord::crypto::SHA3_256 hasher_;
+  concord::crypto::SHA3_256::Digest partition_hash_ = singleHash(std::string{});
+  uint64_t partition_keys_ = 0;
+};
+
+}  // namespace concord::client::clientservice
@@ -12,7 +12,11 @@
 #include <grpcpp/alarm.h>
 #include <grpcpp/grpcpp.h>
 #include <request.grpc.pb.h>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "log/logger.hpp"
 #include "client/concordclient/concord_client.hpp"
@@ -21,13 +25,33 @@ namespace concord::client::clientservice {
 
 namespace requestservice {
 
+// Map a failed concord client request to a gRPC status
+grpc::Status toGrpcStatus(uint32_t result, const std::string& cid);
+
+// Check that a `SendBatch` request can be forwarded to concord client, i.e. that it has requests
+grpc::Status checkBatchRequest(const vmware::concord::client::request::v1::BatchRequest& request);
+
+// Fill the result of one request of a `SendBatch` call and return its status. The response is only set on success.
+grpc::Status toBatchResult(concord::client::concordclient::SendResult&& send_result,
+                           const std::string& cid,
+                           bool is_any_request_type,
+                           vmware::concord::client::request::v1::BatchResult& result);
+
+// The tag of the asynchronous RequestService calls on the completion queues
+class CallData {
+ public:
+  virtual ~CallData() = default;
+  // Walk through the state machine
+  virtual void proceed() = 0;
+};
+
 // Every `Send` request is represented by this class.
 // It follows a simple state machine `RpcState`:
 // CREATE - Register to handle incoming `Send` requests
 // SEND_TO_CONCORDCLIENT - forward request to concord client
 // PROCESS_CALLBACK_RESULT - respond to caller
 // FINISH - clean-up
-class RequestServiceCallData {
+class RequestServiceCallData : public CallData {
  public:
   RequestServiceCallData(vmware::concord::client::request::v1::RequestService::AsyncService* service,
                          grpc::ServerCompletionQueue* cq,
@@ -42,7 +66,7 @@ class RequestServiceCallData {
   }
 
   // Walk through the state machine
-  void proceed();
+  void proceed() override;
   // Callback invoked by concord client after request processing is done
   void populateResult(grpc::Status);
   // Forward request to concord client
@@ -80,9 +104,66 @@ class RequestServiceCallData {
     concordMetrics::AtomicCounterHandle num_completed_requests;
     concordMetrics::AtomicCounterHandle num_incoming_requests;
     concordMetrics::AtomicCounterHandle num_failed_requests;
+    concordMetrics::AtomicCounterHandle num_incoming_batches;
   };
   static Metrics metrics_;
   static uint64_t metrics_dump_interval_ms_;
+
+  friend class BatchRequestServiceCallData;
+};
+
+// Every `SendBatch` request is represented by this class.
+// It follows the same state machine as `RequestServiceCallData`, except that the response is sent once concord client
+// is done with all the requests of the batch.
+// The pre-executed write requests are forwarded to concord client together, so that they reach the replicas in
+// batches instead of one by one.
+class BatchRequestServiceCallData : public CallData {
+ public:
+  BatchRequestServiceCallData(vmware::concord::client::request::v1::RequestService::AsyncService* service,
+                              grpc::ServerCompletionQueue* cq,
+                              std::shared_ptr<concord::client::concordclient::ConcordClient> client)
+      : logger_(logging::getLogger("concord.client.clientservice.requestservice")),
+        service_(service),
+        cq_(cq),
+        responder_(&ctx_),
+        state_(CREATE),
+        client_(client) {
+    proceed();
+  }
+
+  // Walk through the state machine
+  void proceed() override;
+  // Invoked once concord client is done with all the requests, or if the batch is rejected as a whole
+  void populateResult(grpc::Status);
+  // Forward the requests to concord client
+  void sendToConcordClient();
+
+ private:
+  // Callback invoked by concord client after processing of the request at `index` is done
+  void onResult(int index, concord::client::concordclient::SendResult&& send_result);
+
+  logging::Logger logger_;
+
+  vmware::concord::client::request::v1::RequestService::AsyncService* service_;
+  grpc::ServerCompletionQueue* cq_;
+  grpc::ServerContext ctx_;
+  grpc::ServerAsyncResponseWriter<vmware::concord::client::request::v1::BatchResponse> responder_;
+
+  grpc::Alarm callback_alarm_;
+  grpc::Status return_status_;
+
+  vmware::concord::client::request::v1::BatchRequest request_;
+  vmware::concord::client::request::v1::BatchResponse response_;
+  // Whether each request has a typed (Any) request, and thus expects a typed response. Not a vector<bool>, since the
+  // elements are written while callbacks of the requests already sent read theirs.
+  std::vector<uint8_t> is_any_request_type_;
+  // The number of requests that concord client is not done with yet
+  std::atomic_int num_pending_{0};
+
+  enum RpcState { CREATE, SEND_TO_CONCORDCLIENT, PROCESS_CALLBACK_RESULT, FINISH };
+  RpcState state_;
+
+  std::shared_ptr<concord::client::concordclient::ConcordClient> client_;
 };
 
 }  // namespace requestservice
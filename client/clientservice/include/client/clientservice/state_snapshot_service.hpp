@@ -41,8 +41,10 @@ class StateSnapshotServiceImpl final
                         vmware::concord::client::statesnapshot::v1::ReadAsOfResponse* response) override;
 
  private:
+  // The replicas may have computed either version of the public state hash, the reported one has to match one of them
   void isHashValid(uint64_t snapshot_id,
-                   const concord::crypto::SHA3_256::Digest& final_hash,
+                   const concord::crypto::SHA3_256::Digest& chained_hash,
+                   const concord::crypto::SHA3_256::Digest& partitioned_hash,
                    const std::chrono::milliseconds& timeout,
                    grpc::Status& return_status);
 
@@ -11,7 +11,9 @@
 
 #include "client/clientservice/client_service.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <thread>
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/health_check_service_interface.h>
 #include <grpcpp/ext/proto_server_reflection_plugin.h>
@@ -22,6 +24,10 @@ using namespace std::literals::chrono_literals;
 namespace concord::client::clientservice {
 
 void ClientService::start(const std::string& addr, unsigned num_async_threads, uint64_t max_receive_msg_size) {
+  if (num_async_threads == 0) {
+    num_async_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  LOG_INFO(logger_, KVLOG(addr, num_async_threads));
   grpc::EnableDefaultHealthCheckService(false);
   grpc::reflection::InitProtoReflectionServerBuilderPlugin();
 
@@ -95,13 +101,14 @@ void ClientService::shutdown() {
 void ClientService::handleRpcs(unsigned thread_idx) {
   // Note: Memory is freed in `proceed`
   new requestservice::RequestServiceCallData(&request_service_, cqs_[thread_idx].get(), client_);
+  new requestservice::BatchRequestServiceCallData(&request_service_, cqs_[thread_idx].get(), client_);
 
   void* tag;  // uniquely identifies a request.
   bool ok = false;
   while (true) {
     // Block waiting to read the next event from the completion queue. The
     // event is uniquely identified by its tag, which in this case is the
-    // memory address of a RequestServiceCallData instance (see `proceed`).
+    // memory address of a RequestServiceCallData or BatchRequestServiceCallData instance (see `proceed`).
     // The return value of Next should always be checked. This return value
     // tells us whether there is any kind of event or cqs_ is shutting down.
     if (not cqs_[thread_idx]->Next(&tag, &ok)) {
@@ -117,7 +124,7 @@ void ClientService::handleRpcs(unsigned thread_idx) {
     if (not ok) {
       continue;
     }
-    static_cast<requestservice::RequestServiceCallData*>(tag)->proceed();
+    static_cast<requestservice::CallData*>(tag)->proceed();
   }
 }
 
@@ -10,6 +10,8 @@
 // file.
 
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <opentracing/tracer.h>
 
 #include "client/clientservice/request_service.hpp"
@@ -20,6 +22,8 @@
 
 using namespace client::thin_replica_client;
 using namespace vmware::concord::client::concord_client_request::v1;
+using vmware::concord::client::request::v1::Request;
+using vmware::concord::client::request::v1::Response;
 using concord::util::DurationTracker;
 
 namespace concord::client::clientservice {
@@ -73,117 +77,157 @@ void RequestServiceCallData::populateResult(grpc::Status status) {
   callback_alarm_.Set(cq_, gpr_now(gpr_clock_type::GPR_CLOCK_REALTIME), this);
 }
 
-void RequestServiceCallData::sendToConcordClient() {
-  bool is_any_request_type = false;
-  bft::client::Msg msg;
-  if (request_.has_typed_request()) {
+// Convert a gRPC request into the message that concord client sends to the replicas
+static bft::client::Msg toConcordClientMsg(const Request& request,
+                                           const concord::client::concordclient::ConcordClient& client,
+                                           bool& is_any_request_type) {
+  is_any_request_type = false;
+  if (request.has_typed_request()) {
     ConcordClientRequest concord_request;
-    concord_request.set_client_service_id(client_->getSubscriptionId());
-    concord_request.mutable_application_request()->CopyFrom(request_.typed_request());
+    concord_request.set_client_service_id(client.getSubscriptionId());
+    concord_request.mutable_application_request()->CopyFrom(request.typed_request());
     size_t request_size = concord_request.ByteSizeLong();
-    std::string request(request_size, '\0');
-    concord_request.SerializeToArray(request.data(), request_size);
-    msg = bft::client::Msg(request.begin(), request.end());
+    std::string serialized(request_size, '\0');
+    concord_request.SerializeToArray(serialized.data(), request_size);
     is_any_request_type = true;
-  } else {
-    msg = bft::client::Msg(request_.raw_request().begin(), request_.raw_request().end());
+    return bft::client::Msg(serialized.begin(), serialized.end());
   }
+  return bft::client::Msg(request.raw_request().begin(), request.raw_request().end());
+}
 
-  auto seconds = std::chrono::seconds{request_.timeout().seconds()};
-  auto nanos = std::chrono::nanoseconds{request_.timeout().nanos()};
+static bft::client::RequestConfig toRequestConfig(const Request& request,
+                                                  const concord::client::concordclient::ConcordClient& client) {
+  auto seconds = std::chrono::seconds{request.timeout().seconds()};
+  auto nanos = std::chrono::nanoseconds{request.timeout().nanos()};
   auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(seconds + nanos);
 
   bft::client::RequestConfig req_config;
-  req_config.pre_execute = request_.pre_execute();
-  req_config.max_reply_size = client_->getMaxReplyBufferSize();
+  req_config.pre_execute = request.pre_execute();
+  req_config.max_reply_size = client.getMaxReplyBufferSize();
   req_config.timeout = timeout;
-  req_config.correlation_id = request_.correlation_id();
+  req_config.correlation_id = request.correlation_id();
+  return req_config;
+}
 
-  auto callback = [this, req_config, is_any_request_type](concord::client::concordclient::SendResult&& send_result) {
-    grpc::Status status;
-    auto logger = logging::getLogger("concord.client.clientservice.request.callback");
-    if (not std::holds_alternative<bft::client::Reply>(send_result)) {
-      switch (std::get<uint32_t>(send_result)) {
-        case (static_cast<uint32_t>(bftEngine::OperationResult::INVALID_REQUEST)):
-          LOG_INFO(logger, "Request failed with INVALID_ARGUMENT error for cid=" << req_config.correlation_id);
-          status = grpc::Status(
-              grpc::StatusCode::INVALID_ARGUMENT,
-              ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_INVALID_REQUEST));
-          break;
-        case (static_cast<uint32_t>(bftEngine::OperationResult::NOT_READY)):
-          LOG_INFO(logger, "Request failed with NOT_READY error for cid=" << req_config.correlation_id);
-          status =
-              grpc::Status(grpc::StatusCode::UNAVAILABLE,
-                           ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_NOT_READY));
-          break;
-        case (static_cast<uint32_t>(bftEngine::OperationResult::TIMEOUT)):
-          LOG_INFO(logger, "Request failed with TIMEOUT error for cid=" << req_config.correlation_id);
-          status = grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED,
-                                ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_TIMEOUT));
-          break;
-        case (static_cast<uint32_t>(bftEngine::OperationResult::EXEC_DATA_TOO_LARGE)):
-          LOG_INFO(logger, "Request failed with EXEC_DATA_TOO_LARGE error for cid=" << req_config.correlation_id);
-          status = grpc::Status(
-              grpc::StatusCode::INTERNAL,
-              ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_EXEC_DATA_TOO_LARGE));
-          break;
-        case (static_cast<uint32_t>(bftEngine::OperationResult::EXEC_DATA_EMPTY)):
-          LOG_INFO(logger, "Request failed with EXEC_DATA_EMPTY error for cid=" << req_config.correlation_id);
-          status = grpc::Status(
-              grpc::StatusCode::INTERNAL,
-              ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_EXEC_DATA_EMPTY));
-          break;
-        case (static_cast<uint32_t>(bftEngine::OperationResult::CONFLICT_DETECTED)):
-          LOG_INFO(logger, "Request failed with CONFLICT_DETECTED error for cid=" << req_config.correlation_id);
-          status = grpc::Status(
-              grpc::StatusCode::ABORTED,
-              ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_CONFLICT_DETECTED));
-          break;
-        case (static_cast<uint32_t>(bftEngine::OperationResult::OVERLOADED)):
-          LOG_INFO(logger, "Request failed with OVERLOADED error for cid=" << req_config.correlation_id);
-          status =
-              grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
-                           ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_OVERLOADED));
-          break;
-        case (static_cast<uint32_t>(bftEngine::OperationResult::EXEC_ENGINE_REJECT_ERROR)):
-          LOG_INFO(logger, "Request failed with EXEC_ENGINE_REJECT_ERROR error for cid=" << req_config.correlation_id);
-          status = grpc::Status(
-              grpc::StatusCode::ABORTED,
-              ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_EXECUTION_ENGINE_REJECTED));
-          break;
-        default:
-          LOG_INFO(logger, "Request failed with INTERNAL error for cid=" << req_config.correlation_id);
-          status = grpc::Status(grpc::StatusCode::INTERNAL,
-                                ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_INTERNAL));
-          break;
-      }
-      metrics_.num_failed_requests++;
-      updateAggregator();
-      this->populateResult(status);
-      return;
+grpc::Status toGrpcStatus(uint32_t result, const std::string& cid) {
+  grpc::Status status;
+  auto logger = logging::getLogger("concord.client.clientservice.request.callback");
+  switch (result) {
+    case (static_cast<uint32_t>(bftEngine::OperationResult::INVALID_REQUEST)):
+      LOG_INFO(logger, "Request failed with INVALID_ARGUMENT error for cid=" << cid);
+      status = grpc::Status(
+          grpc::StatusCode::INVALID_ARGUMENT,
+          ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_INVALID_REQUEST));
+      break;
+    case (static_cast<uint32_t>(bftEngine::OperationResult::NOT_READY)):
+      LOG_INFO(logger, "Request failed with NOT_READY error for cid=" << cid);
+      status = grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                            ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_NOT_READY));
+      break;
+    case (static_cast<uint32_t>(bftEngine::OperationResult::TIMEOUT)):
+      LOG_INFO(logger, "Request failed with TIMEOUT error for cid=" << cid);
+      status = grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED,
+                            ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_TIMEOUT));
+      break;
+    case (static_cast<uint32_t>(bftEngine::OperationResult::EXEC_DATA_TOO_LARGE)):
+      LOG_INFO(logger, "Request failed with EXEC_DATA_TOO_LARGE error for cid=" << cid);
+      status = grpc::Status(
+          grpc::StatusCode::INTERNAL,
+          ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_EXEC_DATA_TOO_LARGE));
+      break;
+    case (static_cast<uint32_t>(bftEngine::OperationResult::EXEC_DATA_EMPTY)):
+      LOG_INFO(logger, "Request failed with EXEC_DATA_EMPTY error for cid=" << cid);
+      status = grpc::Status(
+          grpc::StatusCode::INTERNAL,
+          ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_EXEC_DATA_EMPTY));
+      break;
+    case (static_cast<uint32_t>(bftEngine::OperationResult::CONFLICT_DETECTED)):
+      LOG_INFO(logger, "Request failed with CONFLICT_DETECTED error for cid=" << cid);
+      status = grpc::Status(
+          grpc::StatusCode::ABORTED,
+          ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_CONFLICT_DETECTED));
+      break;
+    case (static_cast<uint32_t>(bftEngine::OperationResult::OVERLOADED)):
+      LOG_INFO(logger, "Request failed with OVERLOADED error for cid=" << cid);
+      status = grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                            ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_OVERLOADED));
+      break;
+    case (static_cast<uint32_t>(bftEngine::OperationResult::EXEC_ENGINE_REJECT_ERROR)):
+      LOG_INFO(logger, "Request failed with EXEC_ENGINE_REJECT_ERROR error for cid=" << cid);
+      status = grpc::Status(
+          grpc::StatusCode::ABORTED,
+          ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_EXECUTION_ENGINE_REJECTED));
+      break;
+    default:
+      LOG_INFO(logger, "Request failed with INTERNAL error for cid=" << cid);
+      status = grpc::Status(grpc::StatusCode::INTERNAL,
+                            ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_INTERNAL));
+      break;
+  }
+  return status;
+}
+
+// Convert the result of a concord client request into the gRPC status and response
+static grpc::Status toGrpcResult(concord::client::concordclient::SendResult&& send_result,
+                                 const std::string& cid,
+                                 bool is_any_request_type,
+                                 Response& response) {
+  if (not std::holds_alternative<bft::client::Reply>(send_result)) {
+    return toGrpcStatus(std::get<uint32_t>(send_result), cid);
+  }
+  auto reply = std::get<bft::client::Reply>(send_result);
+  // We need to copy because there is no implicit conversion between vector<uint8> and std::string
+  std::string data(reply.matched_data.begin(), reply.matched_data.end());
+
+  // Check if the application response is of Any Type then set it to Any response.
+  if (is_any_request_type) {
+    ConcordClientResponse concord_response;
+    if (!concord_response.ParseFromArray(data.c_str(), data.size())) {
+      return grpc::Status(grpc::StatusCode::INTERNAL, "Internal error in parsing typed response");
     }
-    auto reply = std::get<bft::client::Reply>(send_result);
-    // We need to copy because there is no implicit conversion between vector<uint8> and std::string
-    std::string data(reply.matched_data.begin(), reply.matched_data.end());
-
-    // Check if the application response is of Any Type then set it to Any response.
-    if (is_any_request_type) {
-      ConcordClientResponse concord_response;
-      if (!concord_response.ParseFromArray(data.c_str(), data.size())) {
-        status = grpc::Status(grpc::StatusCode::INTERNAL, "Internal error in parsing typed response");
-        metrics_.num_failed_requests++;
-        updateAggregator();
-        this->populateResult(status);
-        return;
-      }
-      this->response_.mutable_typed_response()->CopyFrom(concord_response.application_response());
+    response.mutable_typed_response()->CopyFrom(concord_response.application_response());
+  } else {
+    response.set_raw_response(std::move(data));
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status checkBatchRequest(const vmware::concord::client::request::v1::BatchRequest& request) {
+  if (request.requests_size() == 0) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        ConcordErrorMessage_Name(vmware::concord::client::request::v1::CONCORD_ERROR_INVALID_REQUEST));
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status toBatchResult(concord::client::concordclient::SendResult&& send_result,
+                           const std::string& cid,
+                           bool is_any_request_type,
+                           vmware::concord::client::request::v1::BatchResult& result) {
+  auto status = toGrpcResult(std::move(send_result), cid, is_any_request_type, *result.mutable_response());
+  if (!status.ok()) {
+    result.clear_response();
+  }
+  result.set_status_code(status.error_code());
+  result.set_status_message(status.error_message());
+  return status;
+}
+
+void RequestServiceCallData::sendToConcordClient() {
+  bool is_any_request_type = false;
+  auto msg = toConcordClientMsg(request_, *client_, is_any_request_type);
+  auto req_config = toRequestConfig(request_, *client_);
+
+  auto callback = [this, req_config, is_any_request_type](concord::client::concordclient::SendResult&& send_result) {
+    auto status =
+        toGrpcResult(std::move(send_result), req_config.correlation_id, is_any_request_type, this->response_);
+    if (status.ok()) {
+      metrics_.num_completed_requests++;
     } else {
-      this->response_.set_raw_response(std::move(data));
+      metrics_.num_failed_requests++;
     }
-
-    metrics_.num_completed_requests++;
     updateAggregator();
-    this->populateResult(grpc::Status::OK);
+    this->populateResult(status);
   };
 
   auto tracer = opentracing::Tracer::Global();
@@ -222,7 +266,8 @@ concordMetrics::Component RequestServiceCallData::metrics_component_{
 RequestServiceCallData::Metrics RequestServiceCallData::metrics_{
     metrics_component_.RegisterAtomicCounter("num_completed_requests", 0),
     metrics_component_.RegisterAtomicCounter("num_incoming_requests", 0),
-    metrics_component_.RegisterAtomicCounter("num_failed_requests", 0)};
+    metrics_component_.RegisterAtomicCounter("num_failed_requests", 0),
+    metrics_component_.RegisterAtomicCounter("num_incoming_batches", 0)};
 
 uint64_t RequestServiceCallData::metrics_dump_interval_ms_{0};
 
@@ -234,6 +279,124 @@ void RequestServiceCallData::updateAggregator() {
   }
 }
 
+void BatchRequestServiceCallData::proceed() {
+  if (state_ == FINISH) {
+    delete this;
+    return;
+  }
+
+  try {
+    if (state_ == CREATE) {
+      state_ = SEND_TO_CONCORDCLIENT;
+      // Request to handle an incoming `SendBatch` RPC -> will put an event on the cq if ready
+      service_->RequestSendBatch(&ctx_, &request_, &responder_, cq_, cq_, this);
+    } else if (state_ == SEND_TO_CONCORDCLIENT) {
+      // We are handling an incoming `SendBatch` right now, let's make sure we handle the next one too
+      new requestservice::BatchRequestServiceCallData(service_, cq_, client_);
+      // Forward the requests to concord client (non-blocking)
+      sendToConcordClient();
+      // Note: The next state transition happens in `populateResult`
+    } else if (state_ == PROCESS_CALLBACK_RESULT) {
+      state_ = FINISH;
+      // Once the response is sent, an event will be put on the cq for cleanup
+      if (return_status_.ok()) {
+        responder_.Finish(response_, return_status_, this);
+      } else {
+        responder_.FinishWithError(return_status_, this);
+      }
+    } else {
+      // Unreachable - all states are handled above
+      ConcordAssert(false);
+    }
+  } catch (std::exception& e) {
+    LOG_ERROR(logger_, "Unexpected exception (batch of " << request_.requests_size() << " requests): " << e.what());
+    state_ = FINISH;
+    auto status = grpc::Status(grpc::StatusCode::INTERNAL, "Unexpected exception occured");
+    responder_.FinishWithError(status, this);
+  }
+}
+
+void BatchRequestServiceCallData::populateResult(grpc::Status status) {
+  // Push an event onto the completion queue so that PROCESS_CALLBACK_RESULT is handled
+  state_ = PROCESS_CALLBACK_RESULT;
+  return_status_ = std::move(status);
+  ConcordAssertNE(cq_, nullptr);
+  callback_alarm_.Set(cq_, gpr_now(gpr_clock_type::GPR_CLOCK_REALTIME), this);
+}
+
+void BatchRequestServiceCallData::onResult(int index, concord::client::concordclient::SendResult&& send_result) {
+  // Every request has its own result, so callbacks of different requests don't race
+  auto status = toBatchResult(std::move(send_result),
+                              request_.requests(index).correlation_id(),
+                              is_any_request_type_[index],
+                              *response_.mutable_results(index));
+  if (status.ok()) {
+    RequestServiceCallData::metrics_.num_completed_requests++;
+  } else {
+    RequestServiceCallData::metrics_.num_failed_requests++;
+  }
+  RequestServiceCallData::updateAggregator();
+  if (--num_pending_ == 0) {
+    populateResult(grpc::Status::OK);
+  }
+}
+
+void BatchRequestServiceCallData::sendToConcordClient() {
+  auto status = checkBatchRequest(request_);
+  if (!status.ok()) {
+    populateResult(status);
+    return;
+  }
+  const auto num_requests = request_.requests_size();
+  // All the results are added upfront, the callbacks only fill them
+  is_any_request_type_.resize(num_requests);
+  for (auto i = 0; i < num_requests; ++i) {
+    response_.add_results();
+  }
+  num_pending_ = num_requests;
+
+  auto tracer = opentracing::Tracer::Global();
+  auto parent_span = TraceContexts::ExtractSpanFromMetadata(*tracer, ctx_);
+  auto span = tracer->StartSpan("send_batch", {opentracing::ChildOf(parent_span.get())});
+  if (span) {
+    span->SetTag(kClientInstanceId, client_->getSubscriptionId());
+  }
+  std::ostringstream carrier;
+  tracer->Inject(span->context(), carrier);
+
+  std::deque<bft::client::WriteRequest> write_requests;
+  std::vector<std::function<void(concord::client::concordclient::SendResult&&)>> write_callbacks;
+  for (auto i = 0; i < num_requests; ++i) {
+    const auto& request = request_.requests(i);
+    bool is_any_request_type = false;
+    auto msg = toConcordClientMsg(request, *client_, is_any_request_type);
+    is_any_request_type_[i] = is_any_request_type;
+    auto req_config = toRequestConfig(request, *client_);
+    req_config.span_context = carrier.str();
+    auto callback = [this, i](concord::client::concordclient::SendResult&& send_result) {
+      onResult(i, std::move(send_result));
+    };
+
+    // Read-only requests don't go through consensus, hence they are not batched
+    if (request.read_only()) {
+      bft::client::ReadConfig config;
+      config.request = req_config;
+      client_->send(config, std::move(msg), callback);
+    } else {
+      bft::client::WriteConfig config;
+      config.request = req_config;
+      write_requests.push_back(bft::client::WriteRequest{config, std::move(msg)});
+      write_callbacks.push_back(callback);
+    }
+    RequestServiceCallData::metrics_.num_incoming_requests++;
+  }
+  if (!write_requests.empty()) {
+    client_->send(std::move(write_requests), write_callbacks);
+  }
+  RequestServiceCallData::metrics_.num_incoming_batches++;
+  RequestServiceCallData::updateAggregator();
+}
+
 }  // namespace requestservice
 
 }  // namespace concord::client::clientservice
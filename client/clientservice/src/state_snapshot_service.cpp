@@ -17,6 +17,7 @@
 
 #include "util/assertUtils.hpp"
 #include "client/clientservice/state_snapshot_service.hpp"
+#include "client/clientservice/public_state_hash.hpp"
 #include "client/concordclient/snapshot_update.hpp"
 
 using grpc::Status;
@@ -59,20 +60,6 @@ using namespace std;
 
 namespace concord::client::clientservice {
 
-static concord::crypto::SHA3_256::Digest singleHash(const std::string& key) {
-  return concord::crypto::SHA3_256{}.digest(key.data(), key.size());
-}
-
-static void nextHash(const std::string& key, const std::string& value, concord::crypto::SHA3_256::Digest& prev_hash) {
-  auto hasher = concord::crypto::SHA3_256{};
-  hasher.init();
-  hasher.update(prev_hash.data(), prev_hash.size());
-  const auto key_hash = singleHash(key);
-  hasher.update(key_hash.data(), key_hash.size());
-  hasher.update(value.data(), value.size());
-  prev_hash = hasher.finish();
-}
-
 template <typename ResponseT>
 struct ResponseType {
   std::variant<ResponseT, std::vector<std::unique_ptr<ResponseT>>> response;
@@ -312,6 +299,7 @@ Status StateSnapshotServiceImpl::StreamSnapshot(ServerContext* context,
   Status status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "Service not available");
   bool is_end_of_stream = false;
   auto accumulated_hash = singleHash(std::string{});
+  auto partitioned_hash = PartitionedHash{};
   // Wait for the update from other thread for 500 ms before checking the context
   auto pop_timeout = 500ms;
   while (!context->IsCancelled()) {
@@ -351,18 +339,20 @@ Status StateSnapshotServiceImpl::StreamSnapshot(ServerContext* context,
     kvpair->set_value(update->val);
     stream->Write(response);
     nextHash(update->key, update->val, accumulated_hash);
+    partitioned_hash.next(update->key, update->val);
   }
 
   if (is_end_of_stream && status.ok()) {
     chrono::milliseconds timeout = setTimeoutFromDeadline(context);
-    isHashValid(proto_request->snapshot_id(), accumulated_hash, timeout, status);
+    isHashValid(proto_request->snapshot_id(), accumulated_hash, partitioned_hash.finish(), timeout, status);
   }
 
   return status;
 }
 
 void StateSnapshotServiceImpl::isHashValid(uint64_t snapshot_id,
-                                           const concord::crypto::SHA3_256::Digest& final_hash,
+                                           const concord::crypto::SHA3_256::Digest& chained_hash,
+                                           const concord::crypto::SHA3_256::Digest& partitioned_hash,
                                            const chrono::milliseconds& timeout,
                                            Status& return_status) {
   auto read_config = std::shared_ptr<ReadConfig>(
@@ -432,7 +422,7 @@ void StateSnapshotServiceImpl::isHashValid(uint64_t snapshot_id,
           if ((res->data).snapshot_id != snapshot_id) {
             return_status = grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "snapshot id mismatch from replicas");
           }
-          if ((res->data).hash != final_hash) {
+          if ((res->data).hash != chained_hash && (res->data).hash != partitioned_hash) {
             return_status = grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "Hash mismatch from replicas");
           }
           break;
@@ -0,0 +1,83 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License"). You may not use this product except in
+// compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright notices and license terms. Your use of
+// these subcomponents is subject to the terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "client/clientservice/public_state_hash.hpp"
+#include "state_snapshot_interface.hpp"
+
+// The expected hashes are the ones the replicas compute for the same public state, see
+// kvbc/test/kvbc_adapter/common/state_snapshot_adapter_test.cpp
+
+using concord::client::clientservice::kPublicStateHashPartitionSize;
+using concord::client::clientservice::nextHash;
+using concord::client::clientservice::PartitionedHash;
+using concord::client::clientservice::singleHash;
+using concord::crypto::SHA3_256;
+
+namespace {
+
+static_assert(kPublicStateHashPartitionSize == concord::kvbc::kPublicStateHashPartitionSize,
+              "The partitioned public state hash of clientservice must match the one of the replicas");
+
+// The public state of addPublicState() in state_snapshot_adapter_test.cpp
+const std::vector<std::pair<std::string, std::string>> kPublicState{{"a", "va"}, {"b", "vb"}, {"c", "vc"}, {"d", "vd"}};
+
+TEST(public_state_hash, empty) {
+  const SHA3_256::Digest expected{0xa7, 0xff, 0xc6, 0xf8, 0xbf, 0x1e, 0xd7, 0x66, 0x51, 0xc1, 0x47,
+                                  0x56, 0xa0, 0x61, 0xd6, 0x62, 0xf5, 0x80, 0xff, 0x4d, 0xe4, 0x3b,
+                                  0x49, 0xfa, 0x82, 0xd8, 0x0a, 0x4b, 0x80, 0xf8, 0x43, 0x4a};
+  EXPECT_EQ(singleHash(std::string{}), expected);
+  EXPECT_EQ(PartitionedHash{}.finish(), expected);
+}
+
+TEST(public_state_hash, chained) {
+  auto hash = singleHash(std::string{});
+  for (const auto& [key, value] : kPublicState) {
+    nextHash(key, value, hash);
+  }
+  // h4 of assertPublicStateHash()
+  EXPECT_EQ(hash,
+            (SHA3_256::Digest{0xfd, 0x4c, 0x5e, 0xa0, 0x3d, 0xa1, 0x8d, 0xea, 0xf1, 0x03, 0x65,
+                              0xfd, 0xf0, 0x01, 0xc2, 0x16, 0x05, 0x5a, 0xaa, 0xa7, 0x96, 0xb0,
+                              0xa9, 0x8e, 0x4d, 0xb7, 0xc7, 0x56, 0xa4, 0x26, 0xae, 0x81}));
+}
+
+TEST(public_state_hash, partitioned_single_partition) {
+  auto hash = PartitionedHash{};
+  for (const auto& [key, value] : kPublicState) {
+    hash.next(key, value);
+  }
+  // As in compute_and_persist_partitioned_hash_single_partition
+  EXPECT_EQ(hash.finish(),
+            (SHA3_256::Digest{0xf8, 0x00, 0xc6, 0x67, 0x4e, 0x70, 0xec, 0xb2, 0x60, 0xf6, 0xf2,
+                              0x18, 0xf4, 0x40, 0x45, 0x4b, 0x6c, 0xbf, 0x95, 0xca, 0xe6, 0xc4,
+                              0x25, 0x06, 0x50, 0x66, 0xd2, 0xc1, 0x73, 0x28, 0x92, 0x45}));
+}
+
+TEST(public_state_hash, partitioned_multiple_partitions) {
+  // Two full partitions and a partial one
+  auto hash = PartitionedHash{};
+  for (auto i = 0ull; i < 2 * kPublicStateHashPartitionSize + 1; ++i) {
+    const auto key = std::to_string(100000 + i);
+    hash.next(key, "v" + key);
+  }
+  // As in compute_and_persist_partitioned_hash_multiple_partitions
+  EXPECT_EQ(hash.finish(),
+            (SHA3_256::Digest{0x93, 0x64, 0x50, 0x11, 0x2b, 0x74, 0x8d, 0xc5, 0xf2, 0x44, 0xc2,
+                              0x99, 0x89, 0x28, 0x4c, 0xd8, 0x7f, 0x83, 0x55, 0xc2, 0x0b, 0x42,
+                              0x29, 0xa1, 0x6e, 0xb3, 0x8f, 0x34, 0xeb, 0x84, 0x59, 0x8e}));
+}
+
+}  // namespace
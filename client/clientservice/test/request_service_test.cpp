@@ -0,0 +1,94 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "client/clientservice/request_service.hpp"
+#include "concord_client_request.pb.h"
+#include "gtest/gtest.h"
+
+using concord::client::clientservice::requestservice::checkBatchRequest;
+using concord::client::clientservice::requestservice::toBatchResult;
+using concord::client::clientservice::requestservice::toGrpcStatus;
+using concord::client::concordclient::SendResult;
+using vmware::concord::client::concord_client_request::v1::ConcordClientResponse;
+using vmware::concord::client::request::v1::BatchRequest;
+using vmware::concord::client::request::v1::BatchResult;
+
+namespace {
+
+bft::client::Reply makeReply(const std::string& data) {
+  bft::client::Reply reply;
+  reply.matched_data.assign(data.begin(), data.end());
+  return reply;
+}
+
+TEST(request_service, error_codes) {
+  const std::vector<std::pair<bftEngine::OperationResult, grpc::StatusCode>> expected = {
+      {bftEngine::OperationResult::INVALID_REQUEST, grpc::StatusCode::INVALID_ARGUMENT},
+      {bftEngine::OperationResult::NOT_READY, grpc::StatusCode::UNAVAILABLE},
+      {bftEngine::OperationResult::TIMEOUT, grpc::StatusCode::DEADLINE_EXCEEDED},
+      {bftEngine::OperationResult::EXEC_DATA_TOO_LARGE, grpc::StatusCode::INTERNAL},
+      {bftEngine::OperationResult::EXEC_DATA_EMPTY, grpc::StatusCode::INTERNAL},
+      {bftEngine::OperationResult::CONFLICT_DETECTED, grpc::StatusCode::ABORTED},
+      {bftEngine::OperationResult::OVERLOADED, grpc::StatusCode::RESOURCE_EXHAUSTED},
+      {bftEngine::OperationResult::EXEC_ENGINE_REJECT_ERROR, grpc::StatusCode::ABORTED},
+      {bftEngine::OperationResult::INTERNAL_ERROR, grpc::StatusCode::INTERNAL},
+  };
+  for (const auto& [result, code] : expected) {
+    EXPECT_EQ(toGrpcStatus(static_cast<uint32_t>(result), "cid").error_code(), code)
+        << "OperationResult " << static_cast<uint32_t>(result);
+  }
+}
+
+TEST(request_service, empty_batch_is_invalid) {
+  BatchRequest request;
+  EXPECT_EQ(checkBatchRequest(request).error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+
+  request.add_requests()->set_raw_request("request");
+  EXPECT_TRUE(checkBatchRequest(request).ok());
+}
+
+TEST(request_service, batch_result_per_request) {
+  // A batch whose requests end differently: raw reply, typed reply, failure and unparsable typed reply
+  BatchResult raw;
+  EXPECT_TRUE(toBatchResult(SendResult{makeReply("raw")}, "cid-0", false, raw).ok());
+  EXPECT_EQ(raw.status_code(), grpc::StatusCode::OK);
+  EXPECT_EQ(raw.response().raw_response(), "raw");
+
+  ConcordClientResponse concord_response;
+  concord_response.mutable_application_response()->set_type_url("type.googleapis.com/test");
+  concord_response.mutable_application_response()->set_value("typed");
+  BatchResult typed;
+  EXPECT_TRUE(toBatchResult(SendResult{makeReply(concord_response.SerializeAsString())}, "cid-1", true, typed).ok());
+  EXPECT_EQ(typed.status_code(), grpc::StatusCode::OK);
+  EXPECT_EQ(typed.response().typed_response().value(), "typed");
+
+  BatchResult overloaded;
+  auto status = toBatchResult(
+      SendResult{static_cast<uint32_t>(bftEngine::OperationResult::OVERLOADED)}, "cid-2", false, overloaded);
+  EXPECT_EQ(status.error_code(), grpc::StatusCode::RESOURCE_EXHAUSTED);
+  EXPECT_EQ(overloaded.status_code(), grpc::StatusCode::RESOURCE_EXHAUSTED);
+  EXPECT_EQ(overloaded.status_message(), status.error_message());
+  EXPECT_FALSE(overloaded.has_response());
+
+  BatchResult unparsable;
+  EXPECT_EQ(toBatchResult(SendResult{makeReply(std::string("\xff\xff", 2))}, "cid-3", true, unparsable).error_code(),
+            grpc::StatusCode::INTERNAL);
+  EXPECT_EQ(unparsable.status_code(), grpc::StatusCode::INTERNAL);
+  EXPECT_FALSE(unparsable.has_response());
+}
+
+}  // namespace
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <chrono>
+#include <deque>
 #include <functional>
 #include <opentracing/span.h>
 #include <memory>
@@ -67,6 +68,7 @@ struct BftTopology {
   bool client_batching_enabled;
   size_t client_batching_max_messages_nbr;
   std::uint64_t client_batching_flush_timeout_ms;
+  bool client_batching_adaptive = false;
   std::string path_to_replicas_master_key = std::string();
 };
 
@@ -109,6 +111,8 @@ struct SubscribeConfig {
   std::string pem_cert_chain;
   // Buffer with the client's PEM encoded private key
   std::string pem_private_key;
+  // Verify updates by range hashes over this many updates (0 verifies every update on its own)
+  uint32_t range_hash_interval = 0;
 };
 
 struct StateSnapshotConfig {
@@ -167,6 +171,10 @@ class ConcordClient {
   void send(const bft::client::ReadConfig& config,
             bft::client::Msg&& msg,
             const std::function<void(SendResult&&)>& callback);
+  // Send many write requests at once, pre-execution requests are sent to the replicas in batches.
+  // callbacks[i] gets invoked once the handling BFT client returns for requests[i].
+  void send(std::deque<bft::client::WriteRequest>&& requests,
+            const std::vector<std::function<void(SendResult&&)>>& callbacks);
 
   // Subscribe to events which are pushed into the given update queue.
   void subscribe(const SubscribeRequest& request,
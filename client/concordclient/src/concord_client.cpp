@@ -110,6 +110,7 @@ ConcordClientPoolConfig ConcordClient::createClientPoolStruct(const ConcordClien
   client_pool_config.client_batching_enabled = config.topology.client_batching_enabled;
   client_pool_config.client_batching_max_messages_nbr = config.topology.client_batching_max_messages_nbr;
   client_pool_config.client_batching_flush_timeout_ms = config.topology.client_batching_flush_timeout_ms;
+  client_pool_config.client_batching_adaptive = config.topology.client_batching_adaptive;
 
   client_pool_config.comm_to_use = config.transport.comm_type == TransportConfig::Invalid
                                        ? "Invalid"
@@ -141,6 +142,11 @@ void ConcordClient::send(const bft::client::WriteConfig& config,
   client_pool_->SendRequest(config, std::forward<bft::client::Msg>(msg), callback);
 }
 
+void ConcordClient::send(std::deque<bft::client::WriteRequest>&& requests,
+                         const std::vector<std::function<void(SendResult&&)>>& callbacks) {
+  client_pool_->SendRequests(std::move(requests), callbacks);
+}
+
 void ConcordClient::createGrpcConnections() {
   for (const auto& replica : config_.topology.replicas) {
     auto addr = replica.host + ":" + std::to_string(replica.event_port);
@@ -192,6 +198,7 @@ void ConcordClient::subscribe(const SubscribeRequest& sub_req,
 
   auto trc_config = std::make_unique<ThinReplicaClientConfig>(
       config_.subscribe_config.id, queue, config_.topology.f_val, grpc_connections_);
+  trc_config->range_hash_interval = config_.subscribe_config.range_hash_interval;
   trc_ = std::make_unique<ThinReplicaClient>(std::move(trc_config), aggregator_);
 
   if (std::holds_alternative<EventGroupRequest>(sub_req.request)) {
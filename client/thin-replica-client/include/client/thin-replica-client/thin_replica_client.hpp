@@ -46,6 +46,7 @@
 
 #include <opentracing/span.h>
 #include <condition_variable>
+#include <deque>
 #include <thread>
 
 #include "log/logger.hpp"
@@ -106,17 +107,27 @@ struct ThinReplicaClientConfig {
   // the time duration the TRC waits before printing warning logs when
   // responsive agreeing servers are less than config_->max_faulty + 1
   std::chrono::seconds no_agreement_warn_duration;
+  // range_hash_interval if non-zero enables range hash verification: instead
+  // of collecting (max_faulty + 1) hashes for every single update, the TRC
+  // buffers updates from the data stream and verifies them against range hashes
+  // which max_faulty servers send for every range_hash_interval updates.
+  // Verified updates are pushed to the update_queue in batches. If range hash
+  // verification fails, the TRC falls back to per-update verification for the
+  // next range_hash_interval updates.
+  uint32_t range_hash_interval;
 
   ThinReplicaClientConfig(std::string client_id_,
                           std::shared_ptr<concord::client::concordclient::EventUpdateQueue> update_queue_,
                           std::size_t max_faulty_,
                           std::vector<std::shared_ptr<client::concordclient::GrpcConnection>>& trs_conns_,
-                          std::chrono::seconds no_agreement_warn_duration_ = kNoAgreementWarnDuration)
+                          std::chrono::seconds no_agreement_warn_duration_ = kNoAgreementWarnDuration,
+                          uint32_t range_hash_interval_ = 0)
       : client_id(std::move(client_id_)),
         update_queue(update_queue_),
         max_faulty(max_faulty_),
         trs_conns(trs_conns_),
-        no_agreement_warn_duration(no_agreement_warn_duration_) {}
+        no_agreement_warn_duration(no_agreement_warn_duration_),
+        range_hash_interval(range_hash_interval_) {}
 
  private:
   static constexpr std::chrono::seconds kNoAgreementWarnDuration = 60s;
@@ -134,7 +145,9 @@ struct ThinReplicaClientMetrics {
         last_verified_event_group_id{metrics_component_.RegisterGauge("last_verified_event_group_id", 0)},
         update_duration_microsec{metrics_component_.RegisterGauge("update_duration_microsec", 0)},
         num_updates_processed{metrics_component_.RegisterCounter("num_updates_processed", 0)},
-        num_events_processed{metrics_component_.RegisterGauge("num_events_processed", 0)} {
+        num_events_processed{metrics_component_.RegisterGauge("num_events_processed", 0)},
+        verification_lag{metrics_component_.RegisterGauge("verification_lag", 0)},
+        num_range_hash_fallbacks{metrics_component_.RegisterCounter("num_range_hash_fallbacks", 0)} {
     metrics_component_.Register();
   }
 
@@ -171,6 +184,12 @@ struct ThinReplicaClientMetrics {
   concordMetrics::CounterHandle num_updates_processed;
   // number of events pushed by TRC to the update queue
   concordMetrics::GaugeHandle num_events_processed;
+  // verification_lag - the number of updates received from the data stream
+  // which wait for range hash verification
+  concordMetrics::GaugeHandle verification_lag;
+  // number of times range hash verification fell back to per-update
+  // verification
+  concordMetrics::CounterHandle num_range_hash_fallbacks;
 };
 
 struct SubscribeRequest {
@@ -200,6 +219,9 @@ class ThinReplicaClient final {
   uint64_t latest_verified_event_group_id_;
   // a subscription is said to be successful when TRC receives the first verified update.
   bool is_subscription_successful_;
+  // number of updates to verify one by one before trying range hash
+  // verification (again)
+  uint64_t per_update_verifications_left_;
 
   std::unique_ptr<std::thread> subscription_thread_;
   std::atomic_bool stop_subscription_thread_;
@@ -223,6 +245,12 @@ class ThinReplicaClient final {
   // Reset metrics before next update
   void resetMetricsBeforeNextUpdate();
 
+  // Convert a verified update, advance the latest verified ID and push the
+  // update to the update queue
+  void pushVerifiedUpdate(const com::vmware::concord::thin_replica::Data& update_in,
+                          std::unique_ptr<opentracing::Span>& span,
+                          const std::chrono::steady_clock::time_point& start);
+
   struct HashRecord {
     enum Type { EventGroup, LegacyEvent };
     Type type;
@@ -299,6 +327,37 @@ class ThinReplicaClient final {
                                 size_t& servers_out_of_range,
                                 size_t& servers_pruned);
 
+  // Range hash verification (see ThinReplicaClientConfig::range_hash_interval)
+  // Updates read from the data stream are buffered until max_faulty servers
+  // sent range hashes covering them. Each server's range hashes need to be
+  // contiguous and need to match the hashes of the buffered updates. Updates
+  // verified by all of them are pushed to the update queue.
+  // Returns false if the updates couldn't be verified by range hashes; in that
+  // case, the caller drops the buffered updates and verifies the following
+  // updates one by one. Returns true if the subscription was stopped.
+  bool receiveRangeVerifiedUpdates();
+  struct RangeHashVerifier {
+    size_t server_index;
+    // The last update ID covered by the range hashes of this server
+    uint64_t verified_up_to;
+  };
+  struct BufferedUpdate {
+    com::vmware::concord::thin_replica::Data data;
+    std::string hash;
+    std::chrono::steady_clock::time_point received;
+  };
+  // Read the next range hash from the given verifier and check it against the
+  // buffered updates. The data stream is read as far as the range requires.
+  // Returns false if the range hash is invalid or doesn't match, or if the
+  // verifier times out while buffered updates wait for its range hash.
+  bool verifyNextRangeHash(RangeHashVerifier& verifier, std::deque<BufferedUpdate>& buffered_updates);
+  // Append the next update from the data stream to the buffer. Returns false if
+  // the read fails or if the update isn't the next one in order.
+  bool readIntoBuffer(std::deque<BufferedUpdate>& buffered_updates);
+  uint64_t latestVerifiedId() const {
+    return is_event_group_request_ ? latest_verified_event_group_id_ : latest_verified_block_id_;
+  }
+
  public:
   // Constructor for ThinReplicaClient. Note that, as the ThinReplicaClient
   // protocol allows only one active subscription at a time for a given client,
@@ -318,6 +377,7 @@ class ThinReplicaClient final {
         latest_verified_block_id_(0),
         latest_verified_event_group_id_(0),
         is_subscription_successful_(false),
+        per_update_verifications_left_(0),
         subscription_thread_(),
         stop_subscription_thread_(false) {
     metrics_.setAggregator(aggregator);
@@ -11,6 +11,8 @@
 // terms and conditions of the subcomponent's license, as noted in the LICENSE
 // file.
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <numeric>
 #include <sstream>
@@ -42,6 +44,7 @@ using concord::client::concordclient::OutOfRangeSubscriptionRequest;
 using concord::client::concordclient::InternalError;
 using concord::client::concordclient::EventUpdateQueue;
 using std::atomic_bool;
+using std::deque;
 using std::list;
 using std::logic_error;
 using std::make_pair;
@@ -506,6 +509,7 @@ void ThinReplicaClient::receiveUpdates() {
 
   // Set initial data stream
   logDataStreamResetResult(resetDataStreamTo(0), 0);
+  per_update_verifications_left_ = 0;
 
   // last timestamp when responsive agreeing servers were less than config_->max_faulty + 1
   std::optional<std::chrono::steady_clock::time_point> last_non_agreement_time;
@@ -514,6 +518,22 @@ void ThinReplicaClient::receiveUpdates() {
   // corresponds to receiving, validating, and returning one update.
   // We break out of this loop only if the application sets the flag.
   while (!stop_subscription_thread_) {
+    if (config_->range_hash_interval > 0 && config_->max_faulty > 0 && per_update_verifications_left_ == 0) {
+      if (!receiveRangeVerifiedUpdates() && !stop_subscription_thread_) {
+        // Per-update verification finds the agreeing servers, or the reason why there aren't any
+        LOG_WARN(logger_,
+                 "Range hash verification failed, verifying the next " << config_->range_hash_interval
+                                                                       << " updates one by one");
+        metrics_.num_range_hash_fallbacks++;
+        metrics_.verification_lag.Get().Set(0);
+        per_update_verifications_left_ = config_->range_hash_interval;
+        // Drop the unverified updates and continue after the latest verified update
+        closeAllHashStreams();
+        logDataStreamResetResult(resetDataStreamTo(data_conn_index_), data_conn_index_);
+      }
+      continue;
+    }
+
     // For each loop of the outer iteration, we need to find at least
     // (max_faulty_ + 1) responsive agreeing servers (we count the server that
     // gave us the actual data for this update as one of the agreeing, so we
@@ -658,33 +678,6 @@ void ThinReplicaClient::receiveUpdates() {
     is_subscription_successful_ = true;
     LOG_DEBUG(logger_, "Read and verified data for update " << update_id);
 
-    ConcordAssertNE(config_->update_queue, nullptr);
-
-    auto update = std::make_unique<EventVariant>();
-    if (update_in.has_event_group()) {
-      EventGroup event_group;
-      event_group.id = update_in.event_group().id();
-      for (auto& event : update_in.event_group().events()) {
-        event_group.events.push_back(event);
-      }
-      event_group.record_time = update_in.event_group().record_time();
-      latest_verified_event_group_id_ = event_group.id;
-      update->emplace<EventGroup>(std::move(event_group));
-      // If we started with a legacy request then the transition has happened now
-      is_event_group_request_ = true;
-    } else {
-      ConcordAssert(update_in.has_events());
-      Update legacy_event;
-      legacy_event.block_id = update_in.events().block_id();
-      legacy_event.correlation_id_ = update_in.events().correlation_id();
-      for (const auto& kvp_in : update_in.events().data()) {
-        legacy_event.kv_pairs.push_back(make_pair(kvp_in.key(), kvp_in.value()));
-      }
-      latest_verified_block_id_ = legacy_event.block_id;
-      update->emplace<Update>(std::move(legacy_event));
-    }
-    TraceContexts::InjectSpan(span, *update);
-
     if (metrics_.read_timeouts_per_update.Get().Get() > 0 || metrics_.read_failures_per_update.Get().Get() > 0 ||
         metrics_.read_ignored_per_update.Get().Get() > 0) {
       LOG_WARN(logger_,
@@ -694,9 +687,12 @@ void ThinReplicaClient::receiveUpdates() {
     }
 
     // Push update to update queue for consumption before receiving next update
-    pushUpdateToUpdateQueue(std::move(update), start, update_in.has_event_group());
+    pushVerifiedUpdate(update_in, span, start);
     // Reset read timeout, failure and ignored metrics before the next update
     resetMetricsBeforeNextUpdate();
+    if (per_update_verifications_left_ > 0) {
+      per_update_verifications_left_--;
+    }
 
     // Cleanup before the next update
 
@@ -715,6 +711,229 @@ void ThinReplicaClient::receiveUpdates() {
   stop_subscription_thread_ = true;
 }
 
+bool ThinReplicaClient::readIntoBuffer(deque<BufferedUpdate>& buffered_updates) {
+  if (!config_->trs_conns[data_conn_index_]->hasDataStream()) {
+    return false;
+  }
+
+  Data update_in;
+  GrpcConnection::Result read_result = config_->trs_conns[data_conn_index_]->readData(&update_in);
+  if (read_result == GrpcConnection::Result::kTimeout) {
+    LOG_DEBUG(logger_, "Data stream " << data_conn_index_ << " timed out");
+    metrics_.read_timeouts_per_update++;
+    return false;
+  }
+  if (read_result != GrpcConnection::Result::kSuccess) {
+    LOG_DEBUG(logger_, "Data stream " << data_conn_index_ << " read failed");
+    metrics_.read_failures_per_update++;
+    return false;
+  }
+
+  // The transition from legacy events to event groups is verified update by update
+  if (update_in.has_event_group() != is_event_group_request_) {
+    LOG_INFO(logger_, "Data stream " << data_conn_index_ << " switched the update type");
+    return false;
+  }
+  uint64_t id = update_in.has_event_group() ? update_in.event_group().id() : update_in.events().block_id();
+  uint64_t expected_id = latestVerifiedId() + buffered_updates.size() + 1;
+  if (id != expected_id) {
+    LOG_WARN(logger_,
+             "Data stream " << data_conn_index_ << " gave update " << id << " but update " << expected_id
+                            << " was expected");
+    metrics_.read_ignored_per_update++;
+    return false;
+  }
+
+  string update_hash = hashUpdate(update_in);
+  buffered_updates.push_back({std::move(update_in), std::move(update_hash), steady_clock::now()});
+  metrics_.verification_lag.Get().Set(buffered_updates.size());
+  return true;
+}
+
+bool ThinReplicaClient::verifyNextRangeHash(RangeHashVerifier& verifier, deque<BufferedUpdate>& buffered_updates) {
+  Hash hash;
+  GrpcConnection::Result read_result = config_->trs_conns[verifier.server_index]->readHash(&hash);
+  if (read_result == GrpcConnection::Result::kTimeout) {
+    LOG_DEBUG(logger_, "Hash stream " << verifier.server_index << " timed out.");
+    metrics_.read_timeouts_per_update++;
+    // An idle server is fine unless buffered updates wait for its range hash
+    return verifier.verified_up_to >= latestVerifiedId() + buffered_updates.size();
+  }
+  if (read_result != GrpcConnection::Result::kSuccess) {
+    LOG_DEBUG(logger_, "Hash stream " << verifier.server_index << " read failed.");
+    metrics_.read_failures_per_update++;
+    return false;
+  }
+
+  uint64_t range_start;
+  uint64_t range_end;
+  string range_hash;
+  if (hash.has_event_group()) {
+    range_start = hash.event_group().range_start();
+    range_end = hash.event_group().event_group_id();
+    range_hash = hash.event_group().hash();
+  } else {
+    ConcordAssert(hash.has_events());
+    range_start = hash.events().range_start();
+    range_end = hash.events().block_id();
+    range_hash = hash.events().hash();
+  }
+  // Note that servers which don't support range hashes send per-update hashes without range_start. A range may be
+  // shorter than the requested interval, but never longer - we would have to buffer an unbounded number of updates.
+  if (hash.has_event_group() != is_event_group_request_ || range_start != verifier.verified_up_to + 1 ||
+      range_end < range_start || range_end - range_start + 1 > config_->range_hash_interval ||
+      range_hash.length() > kThinReplicaHashLength) {
+    LOG_WARN(logger_,
+             "Hash stream " << verifier.server_index << " gave an unexpected range hash for [" << range_start << ", "
+                            << range_end << "], verified up to " << verifier.verified_up_to);
+    metrics_.read_ignored_per_update++;
+    return false;
+  }
+
+  while (latestVerifiedId() + buffered_updates.size() < range_end) {
+    if (stop_subscription_thread_ || !readIntoBuffer(buffered_updates)) {
+      return false;
+    }
+  }
+
+  ConcordAssertGT(range_start, latestVerifiedId());
+  list<string> update_hashes;
+  auto first = buffered_updates.cbegin() + (range_start - latestVerifiedId() - 1);
+  auto last = first + (range_end - range_start + 1);
+  std::transform(first, last, std::back_inserter(update_hashes), [](const auto& update) { return update.hash; });
+  range_hash.resize(kThinReplicaHashLength, '\0');
+  if (hashState(update_hashes) != range_hash) {
+    LOG_WARN(logger_,
+             "Hash stream " << verifier.server_index << " gave a range hash for [" << range_start << ", " << range_end
+                            << "] in disagreement with data stream " << data_conn_index_);
+    metrics_.read_ignored_per_update++;
+    return false;
+  }
+
+  LOG_DEBUG(logger_,
+            "Hash stream " << verifier.server_index << " verified [" << range_start << ", " << range_end << "]");
+  verifier.verified_up_to = range_end;
+  return true;
+}
+
+bool ThinReplicaClient::receiveRangeVerifiedUpdates() {
+  if (!config_->trs_conns[data_conn_index_]->hasDataStream()) {
+    return false;
+  }
+
+  // Prefer servers with an open hash stream; they agreed with the latest verified update
+  std::vector<size_t> candidates;
+  for (size_t server_index = 0; server_index < config_->trs_conns.size(); ++server_index) {
+    if (server_index != data_conn_index_) {
+      candidates.push_back(server_index);
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(), [this](auto a, auto b) {
+    return config_->trs_conns[a]->hasHashStream() > config_->trs_conns[b]->hasHashStream();
+  });
+  closeAllHashStreams();
+
+  SubscriptionRequest request;
+  if (is_event_group_request_) {
+    request.mutable_event_groups()->set_event_group_id(latest_verified_event_group_id_ + 1);
+  } else {
+    request.mutable_events()->set_block_id(latest_verified_block_id_ + 1);
+  }
+  request.set_range_hash_interval(config_->range_hash_interval);
+
+  // Together with the data stream, max_faulty verifiers make the (max_faulty + 1) agreeing servers
+  std::vector<RangeHashVerifier> verifiers;
+  for (auto server_index : candidates) {
+    if (verifiers.size() == config_->max_faulty || stop_subscription_thread_) {
+      break;
+    }
+    GrpcConnection::Result stream_open_status = config_->trs_conns[server_index]->openHashStream(request);
+    if (stream_open_status == GrpcConnection::Result::kSuccess) {
+      verifiers.push_back({server_index, latestVerifiedId()});
+    } else if (stream_open_status == GrpcConnection::Result::kTimeout) {
+      LOG_DEBUG(logger_, "Opening a range hash stream to server " << server_index << " timed out.");
+      metrics_.read_timeouts_per_update++;
+    } else {
+      LOG_DEBUG(logger_, "Opening a range hash stream to server " << server_index << " failed.");
+      metrics_.read_failures_per_update++;
+    }
+  }
+  if (verifiers.size() < config_->max_faulty) {
+    return false;
+  }
+
+  deque<BufferedUpdate> buffered_updates;
+  while (!stop_subscription_thread_) {
+    for (auto& verifier : verifiers) {
+      if (stop_subscription_thread_ || !verifyNextRangeHash(verifier, buffered_updates)) {
+        return false;
+      }
+    }
+
+    // Release the updates which all verifiers agreed on
+    auto verified_up_to =
+        std::min_element(verifiers.begin(), verifiers.end(), [](const auto& a, const auto& b) {
+          return a.verified_up_to < b.verified_up_to;
+        })->verified_up_to;
+    if (latestVerifiedId() == verified_up_to) {
+      continue;
+    }
+    LOG_DEBUG(logger_, "Read and verified data up to update " << verified_up_to);
+    is_subscription_successful_ = true;
+    while (latestVerifiedId() < verified_up_to) {
+      const auto& update_in = buffered_updates.front().data;
+      SpanPtr span;
+      if (update_in.has_event_group()) {
+        span =
+            TraceContexts::CreateChildSpanFromBinary(update_in.event_group().trace_context(), "trc_read_event_group");
+      } else {
+        span = TraceContexts::CreateChildSpanFromBinary(
+            update_in.events().span_context(), "trc_read_block", update_in.events().correlation_id());
+      }
+      LogCid cid(update_in.has_event_group() ? string{} : update_in.events().correlation_id());
+      pushVerifiedUpdate(update_in, span, buffered_updates.front().received);
+      buffered_updates.pop_front();
+    }
+    metrics_.verification_lag.Get().Set(buffered_updates.size());
+    // Reset read timeout, failure and ignored metrics before the next batch
+    resetMetricsBeforeNextUpdate();
+  }
+  return true;
+}
+
+void ThinReplicaClient::pushVerifiedUpdate(const Data& update_in,
+                                           SpanPtr& span,
+                                           const std::chrono::steady_clock::time_point& start) {
+  ConcordAssertNE(config_->update_queue, nullptr);
+
+  auto update = std::make_unique<EventVariant>();
+  if (update_in.has_event_group()) {
+    EventGroup event_group;
+    event_group.id = update_in.event_group().id();
+    for (auto& event : update_in.event_group().events()) {
+      event_group.events.push_back(event);
+    }
+    event_group.record_time = update_in.event_group().record_time();
+    latest_verified_event_group_id_ = event_group.id;
+    update->emplace<EventGroup>(std::move(event_group));
+    // If we started with a legacy request then the transition has happened now
+    is_event_group_request_ = true;
+  } else {
+    ConcordAssert(update_in.has_events());
+    Update legacy_event;
+    legacy_event.block_id = update_in.events().block_id();
+    legacy_event.correlation_id_ = update_in.events().correlation_id();
+    for (const auto& kvp_in : update_in.events().data()) {
+      legacy_event.kv_pairs.push_back(make_pair(kvp_in.key(), kvp_in.value()));
+    }
+    latest_verified_block_id_ = legacy_event.block_id;
+    update->emplace<Update>(std::move(legacy_event));
+  }
+  TraceContexts::InjectSpan(span, *update);
+
+  pushUpdateToUpdateQueue(std::move(update), start, update_in.has_event_group());
+}
+
 void ThinReplicaClient::pushUpdateToUpdateQueue(std::unique_ptr<EventVariant> update,
                                                 const std::chrono::steady_clock::time_point& start,
                                                 bool is_event_group) {
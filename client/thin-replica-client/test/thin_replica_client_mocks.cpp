@@ -299,7 +299,9 @@ ClientReaderInterface<Data>* DelayedMockDataStreamPreparer::SubscribeToUpdatesRa
   return data_stream;
 }
 
-MockOrderedDataStreamHasher::StreamHasher::StreamHasher(ClientReaderInterface<Data>* data) : data_stream_(data) {}
+MockOrderedDataStreamHasher::StreamHasher::StreamHasher(ClientReaderInterface<Data>* data,
+                                                        uint32_t range_hash_interval)
+    : data_stream_(data), range_hash_interval_(range_hash_interval) {}
 
 MockOrderedDataStreamHasher::StreamHasher::~StreamHasher() {}
 
@@ -310,7 +312,18 @@ bool MockOrderedDataStreamHasher::StreamHasher::Read(Hash* msg) {
 
   Data data;
   bool read_status = data_stream_->Read(&data);
-  if (read_status) {
+  if (read_status && range_hash_interval_ > 0) {
+    // Cover up to range_hash_interval_ updates, a finite data stream may end the range early
+    uint64_t range_start = data.events().block_id();
+    list<string> update_hashes{hashUpdate(data)};
+    msg->mutable_events()->set_block_id(range_start);
+    while (update_hashes.size() < range_hash_interval_ && data_stream_->Read(&data)) {
+      update_hashes.push_back(hashUpdate(data));
+      msg->mutable_events()->set_block_id(data.events().block_id());
+    }
+    msg->mutable_events()->set_range_start(range_start);
+    msg->mutable_events()->set_hash(hashState(update_hashes));
+  } else if (read_status) {
     msg->mutable_events()->set_block_id(data.events().block_id());
     msg->mutable_events()->set_hash(hashUpdate(data));
   }
@@ -367,7 +380,8 @@ Status MockOrderedDataStreamHasher::ReadStateHash(ClientContext* context,
 ClientReaderInterface<Hash>* MockOrderedDataStreamHasher::SubscribeToUpdateHashesRaw(
     ClientContext* context, const SubscriptionRequest& request) const {
   auto hash_stream = new MockThinReplicaStream<Hash>();
-  auto hash_stream_state = new StreamHasher(data_preparer_->SubscribeToUpdatesRaw(context, request));
+  auto hash_stream_state =
+      new StreamHasher(data_preparer_->SubscribeToUpdatesRaw(context, request), request.range_hash_interval());
   hash_stream->state.reset(hash_stream_state);
 
   ON_CALL(*hash_stream, Finish).WillByDefault(Invoke(hash_stream_state, &StreamHasher::Finish));
@@ -777,6 +791,29 @@ ClientReaderInterface<Hash>* UpdateHashFabricator::SubscribeToUpdateHashesRaw(
   return correct_hashes;
 }
 
+RangeHashIntervalInflater::RangeHashIntervalInflater(shared_ptr<MockDataStreamPreparer> data_preparer,
+                                                     uint32_t inflation_factor,
+                                                     size_t num_faulty_servers)
+    : hasher_(new MockOrderedDataStreamHasher(data_preparer)),
+      inflation_factor_(inflation_factor),
+      num_faulty_servers_(num_faulty_servers) {}
+
+RangeHashIntervalInflater::~RangeHashIntervalInflater() {}
+
+ClientReaderInterface<Hash>* RangeHashIntervalInflater::SubscribeToUpdateHashesRaw(
+    size_t server_index,
+    ClientContext* context,
+    const SubscriptionRequest& request,
+    ClientReaderInterface<Hash>* correct_hashes) {
+  if (request.range_hash_interval() > 0 && MakeByzantineFaulty(server_index, num_faulty_servers_)) {
+    delete correct_hashes;
+    SubscriptionRequest inflated_request = request;
+    inflated_request.set_range_hash_interval(request.range_hash_interval() * inflation_factor_);
+    return hasher_->SubscribeToUpdateHashesRaw(context, inflated_request);
+  }
+  return correct_hashes;
+}
+
 StateStreamDelayer::DelayedStreamState::DelayedStreamState(ClientReaderInterface<Data>* data, size_t delay_after)
     : undelayed_data_(data), updates_until_delay_(delay_after) {}
 
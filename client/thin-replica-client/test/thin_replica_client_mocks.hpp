@@ -201,9 +201,12 @@ class MockOrderedDataStreamHasher {
   class StreamHasher : public MockThinReplicaStream<com::vmware::concord::thin_replica::Hash>::State {
    private:
     std::unique_ptr<grpc::ClientReaderInterface<com::vmware::concord::thin_replica::Data>> data_stream_;
+    // If non-zero, the stream sends range hashes (see SubscriptionRequest)
+    uint32_t range_hash_interval_;
 
    public:
-    StreamHasher(grpc::ClientReaderInterface<com::vmware::concord::thin_replica::Data>* data);
+    StreamHasher(grpc::ClientReaderInterface<com::vmware::concord::thin_replica::Data>* data,
+                 uint32_t range_hash_interval = 0);
     ~StreamHasher() override;
     grpc::Status Finish();
     bool Read(com::vmware::concord::thin_replica::Hash* msg);
@@ -655,6 +658,28 @@ class UpdateHashFabricator : public ByzantineMockThinReplicaServerPreparer::Byza
       grpc::ClientReaderInterface<com::vmware::concord::thin_replica::Hash>* correct_data) override;
 };
 
+// Simulates Byzantine server behavior in which faulty servers cover more
+// updates with each range hash than the client asked for (see
+// SubscriptionRequest::range_hash_interval). The range hashes are otherwise
+// correct.
+class RangeHashIntervalInflater : public ByzantineMockThinReplicaServerPreparer::ByzantineServerBehavior {
+ private:
+  std::shared_ptr<MockOrderedDataStreamHasher> hasher_;
+  uint32_t inflation_factor_;
+  size_t num_faulty_servers_;
+
+ public:
+  RangeHashIntervalInflater(std::shared_ptr<MockDataStreamPreparer> data_preparer,
+                            uint32_t inflation_factor = 2,
+                            size_t num_faulty_servers = 1);
+  ~RangeHashIntervalInflater() override;
+  grpc::ClientReaderInterface<com::vmware::concord::thin_replica::Hash>* SubscribeToUpdateHashesRaw(
+      size_t server_index,
+      grpc::ClientContext* context,
+      const com::vmware::concord::thin_replica::SubscriptionRequest& request,
+      grpc::ClientReaderInterface<com::vmware::concord::thin_replica::Hash>* correct_data) override;
+};
+
 // Simulates a slow server that slows down at some point when streaming data in
 // response to ReadState.
 class StateStreamDelayer : public ByzantineMockThinReplicaServerPreparer::ByzantineServerBehavior {
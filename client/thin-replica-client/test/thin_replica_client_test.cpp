@@ -430,6 +430,96 @@ TEST(thin_replica_client_test, test_correct_data_returned_) {
   delay_condition->notify_all();
 }
 
+TEST(thin_replica_client_test, test_range_hash_verification_returns_correct_data) {
+  vector<Data> update_data;
+  for (size_t i = 0; i <= 60; ++i) {
+    Data update;
+    update.mutable_events()->set_block_id(i);
+    KVPair* kvp = update.mutable_events()->add_data();
+    kvp->set_key("key" + to_string(i % 7));
+    kvp->set_value("value" + to_string(i));
+    update_data.push_back(update);
+  }
+
+  shared_ptr<MockDataStreamPreparer> stream_preparer(new VectorMockDataStreamPreparer(update_data, 1));
+  MockOrderedDataStreamHasher hasher(stream_preparer);
+
+  uint16_t max_faulty = 1;
+  size_t num_replicas = 3 * max_faulty + 1;
+  uint32_t range_hash_interval = 8;
+
+  shared_ptr<EventUpdateQueue> update_queue = make_shared<BasicEventUpdateQueue>();
+
+  auto mock_servers = CreateTrsConnections(num_replicas, stream_preparer, hasher);
+  auto trc_config = make_unique<ThinReplicaClientConfig>(
+      kTestingClientID, update_queue, max_faulty, mock_servers, std::chrono::seconds(60), range_hash_interval);
+  std::shared_ptr<concordMetrics::Aggregator> aggregator;
+  auto trc = make_unique<ThinReplicaClient>(std::move(trc_config), aggregator);
+
+  // The last range is cut short by the end of the data
+  trc->Subscribe(1);
+  for (size_t i = 1; i < update_data.size(); ++i) {
+    unique_ptr<EventVariant> received_update = update_queue->pop();
+    ASSERT_TRUE((bool)received_update);
+    ASSERT_TRUE(std::holds_alternative<Update>(*received_update));
+    auto& legacy_event = std::get<Update>(*received_update);
+    EXPECT_EQ(legacy_event.block_id, update_data[i].events().block_id());
+    ASSERT_EQ(legacy_event.kv_pairs.size(), 1u);
+    EXPECT_EQ(legacy_event.kv_pairs[0].first, update_data[i].events().data(0).key());
+    EXPECT_EQ(legacy_event.kv_pairs[0].second, update_data[i].events().data(0).value());
+  }
+  trc->Unsubscribe();
+  EXPECT_EQ(trc->metrics_.num_range_hash_fallbacks.Get().Get(), 0u);
+  EXPECT_EQ(trc->metrics_.verification_lag.Get().Get(), 0u);
+}
+
+TEST(thin_replica_client_test, test_range_hash_longer_than_interval_is_rejected) {
+  vector<Data> update_data;
+  for (size_t i = 0; i <= 60; ++i) {
+    Data update;
+    update.mutable_events()->set_block_id(i);
+    KVPair* kvp = update.mutable_events()->add_data();
+    kvp->set_key("key" + to_string(i % 7));
+    kvp->set_value("value" + to_string(i));
+    update_data.push_back(update);
+  }
+
+  shared_ptr<MockDataStreamPreparer> stream_preparer(new VectorMockDataStreamPreparer(update_data, 1));
+  auto hasher = make_shared<MockOrderedDataStreamHasher>(stream_preparer);
+  // The first server asked for range hashes covers twice the requested interval with each (otherwise correct) hash
+  auto byzantine_behavior = make_shared<RangeHashIntervalInflater>(stream_preparer);
+  ByzantineMockThinReplicaServerPreparer server_preparer(stream_preparer, hasher, byzantine_behavior);
+
+  uint16_t max_faulty = 1;
+  size_t num_replicas = 3 * max_faulty + 1;
+  uint32_t range_hash_interval = 8;
+
+  shared_ptr<EventUpdateQueue> update_queue = make_shared<BasicEventUpdateQueue>();
+
+  auto mock_servers = CreateByzantineMockServers(num_replicas, server_preparer);
+  auto trc_config = make_unique<ThinReplicaClientConfig>(kTestingClientID,
+                                                         update_queue,
+                                                         max_faulty,
+                                                         CreateTrsConnections(mock_servers),
+                                                         std::chrono::seconds(60),
+                                                         range_hash_interval);
+  std::shared_ptr<concordMetrics::Aggregator> aggregator;
+  auto trc = make_unique<ThinReplicaClient>(std::move(trc_config), aggregator);
+
+  trc->Subscribe(1);
+  for (size_t i = 1; i < update_data.size(); ++i) {
+    unique_ptr<EventVariant> received_update = update_queue->pop();
+    ASSERT_TRUE((bool)received_update);
+    ASSERT_TRUE(std::holds_alternative<Update>(*received_update));
+    auto& legacy_event = std::get<Update>(*received_update);
+    EXPECT_EQ(legacy_event.block_id, update_data[i].events().block_id());
+    ASSERT_EQ(legacy_event.kv_pairs.size(), 1u);
+    EXPECT_EQ(legacy_event.kv_pairs[0].second, update_data[i].events().data(0).value());
+  }
+  trc->Unsubscribe();
+  EXPECT_GE(trc->metrics_.num_range_hash_fallbacks.Get().Get(), 1u);
+}
+
 }  // anonymous namespace
 
 int main(int argc, char** argv) {
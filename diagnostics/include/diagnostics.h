@@ -17,6 +17,7 @@
 #include <mutex>
 #include <stdexcept>
 
+#include "flight_recorder.h"
 #include "performance_handler.h"
 #include "status_handlers.h"
 
@@ -26,6 +27,7 @@ class Registrar {
  public:
   PerformanceHandler perf;
   StatusHandlers status;
+  FlightRecorder events;
 };
 
 // Singleton wrapper class for a Registrar.
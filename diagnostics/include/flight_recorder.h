@@ -0,0 +1,142 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace concord::diagnostics {
+
+struct FlightEvent {
+  std::chrono::system_clock::time_point time;
+  std::string thread;
+  const char* name;
+  // Usually the sequence number the event belongs to
+  uint64_t id;
+  uint64_t arg;
+};
+
+// The flight recorder keeps the last events of every thread that records events, such that the timeline of individual
+// sequence numbers (e.g. PrePrepare received -> prepare collected -> commit collected -> executed) can be dumped on
+// demand. While histograms show the distribution of latencies, the recorded events explain the outliers.
+//
+// Every thread records into its own fixed-size ring, overwriting its oldest events. Recording is lock-free and costs a
+// clock read and a few relaxed stores, so the recorder is always on. A dump reads the rings concurrently and skips
+// events that are overwritten while being read. The rings of threads that exited are kept until they are reused by new
+// threads.
+class FlightRecorder {
+ public:
+  static constexpr size_t kEventsPerThread = 4096;
+
+  FlightRecorder();
+  ~FlightRecorder();
+  FlightRecorder(const FlightRecorder&) = delete;
+  FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+  // `name` must be a string literal, since only the pointer is kept
+  void record(const char* name, uint64_t id, uint64_t arg = 0) {
+    if (!enabled_.load(std::memory_order_relaxed)) return;
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    threadRing().push(name, id, arg, std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+  }
+
+  void enable(bool enabled) { enabled_ = enabled; }
+  bool enabled() const { return enabled_; }
+
+  // The recorded events of all threads in time order. If `id` is given, only its events are returned.
+  std::vector<FlightEvent> events(std::optional<uint64_t> id = std::nullopt) const;
+
+  // One line per event, as returned by events(), with the time elapsed since the first one
+  std::string dump(std::optional<uint64_t> id = std::nullopt) const;
+
+  // DO NOT USE THIS IN PRODUCTION. THIS IS ONLY FOR TESTING.
+  void clear();
+
+ private:
+  class Ring {
+   public:
+    explicit Ring(std::string thread) : thread(std::move(thread)) {}
+
+    // Called by the owning thread only
+    void push(const char* name, uint64_t id, uint64_t arg, int64_t time_ns) {
+      const auto pos = next_.load(std::memory_order_relaxed);
+      auto& slot = slots_[pos % kEventsPerThread];
+      // Seqlock - the version is odd while the slot is written and encodes the position of the event
+      slot.version.store(2 * pos + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      slot.time_ns.store(time_ns, std::memory_order_relaxed);
+      slot.name.store(name, std::memory_order_relaxed);
+      slot.id.store(id, std::memory_order_relaxed);
+      slot.arg.store(arg, std::memory_order_relaxed);
+      slot.version.store(2 * pos + 2, std::memory_order_release);
+      next_.store(pos + 1, std::memory_order_release);
+    }
+
+    void collect(std::optional<uint64_t> id, std::vector<FlightEvent>& events) const;
+    void clear();
+
+    // Guarded by the recorder's mutex
+    std::string thread;
+    // Whether the thread that owns the ring is still alive
+    std::atomic_bool in_use{true};
+
+   private:
+    struct Slot {
+      std::atomic_uint64_t version{0};
+      std::atomic_int64_t time_ns{0};
+      std::atomic<const char*> name{nullptr};
+      std::atomic_uint64_t id{0};
+      std::atomic_uint64_t arg{0};
+    };
+
+    std::atomic_uint64_t next_{0};
+    std::array<Slot, kEventsPerThread> slots_;
+  };
+
+  struct CachedRing {
+    ~CachedRing() { release(); }
+    void release() {
+      if (ring) ring->in_use = false;
+    }
+    uint64_t recorder_id{0};
+    std::shared_ptr<Ring> ring;
+  };
+
+  Ring& threadRing() {
+    thread_local CachedRing cached;
+    if (cached.recorder_id != id_) {
+      cached.release();
+      cached.ring = addRing();
+      cached.recorder_id = id_;
+    }
+    return *cached.ring;
+  }
+
+  std::shared_ptr<Ring> addRing();
+
+  // Unique per recorder, such that a thread doesn't use the ring it had in a destroyed recorder
+  const uint64_t id_;
+  std::atomic_bool enabled_{true};
+  std::vector<std::shared_ptr<Ring>> rings_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace concord::diagnostics
@@ -41,7 +41,12 @@ inline std::string usage() {
   usage += "    perf list [COMPONENT]\n";
   usage += "        List all components or all histograms for a given [COMPONENT]\n\n";
   usage += "    perf snapshot <COMPONENT1> [COMPONENT2]...[COMPONENT_N]\n";
-  usage += "        Snapshot all histograms for the given components.";
+  usage += "        Snapshot all histograms for the given components.\n\n";
+  usage += "  events <COMMAND> [ARGS]\n\n";
+  usage += "    events dump [ID]\n";
+  usage += "        Dump the recorded events, or only the events of [ID] (usually a sequence number).\n\n";
+  usage += "    events enable|disable\n";
+  usage += "        Start or stop recording events.";
   return usage;
 }
 
@@ -122,6 +127,27 @@ inline std::string run(const std::vector<std::string>& tokens, Registrar& regist
     }
   }
 
+  if (subject == "events") {
+    if (command == "dump") {
+      if (tokens.size() == 2) {
+        return registrar.events.dump();
+      }
+      if (tokens.size() == 3) {
+        try {
+          return registrar.events.dump(std::stoull(tokens[2]));
+        } catch (const std::exception& e) {
+          return usage();
+        }
+      }
+      return usage();
+    }
+    if (command == "enable" || command == "disable") {
+      if (tokens.size() != 2) return usage();
+      registrar.events.enable(command == "enable");
+      return "";
+    }
+  }
+
   return usage();
 }
 
@@ -0,0 +1,124 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <pthread.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "flight_recorder.h"
+
+namespace concord::diagnostics {
+
+static std::atomic_uint64_t next_recorder_id{1};
+
+static std::string threadName() {
+  char name[16] = {0};
+  std::ostringstream oss;
+  if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0 && name[0] != 0) {
+    oss << name << "-";
+  }
+  oss << std::this_thread::get_id();
+  return oss.str();
+}
+
+FlightRecorder::FlightRecorder() : id_{next_recorder_id++} {}
+
+FlightRecorder::~FlightRecorder() = default;
+
+std::shared_ptr<FlightRecorder::Ring> FlightRecorder::addRing() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& ring : rings_) {
+    if (!ring->in_use) {
+      ring->clear();
+      ring->thread = threadName();
+      ring->in_use = true;
+      return ring;
+    }
+  }
+  return rings_.emplace_back(std::make_shared<Ring>(threadName()));
+}
+
+void FlightRecorder::Ring::collect(std::optional<uint64_t> id, std::vector<FlightEvent>& events) const {
+  const auto next = next_.load(std::memory_order_acquire);
+  const auto first = next > kEventsPerThread ? next - kEventsPerThread : 0;
+  for (auto pos = first; pos < next; ++pos) {
+    const auto& slot = slots_[pos % kEventsPerThread];
+    const auto version = slot.version.load(std::memory_order_acquire);
+    const auto time_ns = slot.time_ns.load(std::memory_order_relaxed);
+    const auto* name = slot.name.load(std::memory_order_relaxed);
+    const auto event_id = slot.id.load(std::memory_order_relaxed);
+    const auto arg = slot.arg.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Skip events that were overwritten meanwhile
+    if (version != 2 * pos + 2 || slot.version.load(std::memory_order_relaxed) != version) {
+      continue;
+    }
+    if (id && *id != event_id) {
+      continue;
+    }
+    events.push_back(FlightEvent{std::chrono::system_clock::time_point{std::chrono::duration_cast<
+                                     std::chrono::system_clock::duration>(std::chrono::nanoseconds{time_ns})},
+                                 thread,
+                                 name,
+                                 event_id,
+                                 arg});
+  }
+}
+
+void FlightRecorder::Ring::clear() {
+  // Events at positions before next_ are no longer valid for readers
+  for (auto& slot : slots_) {
+    slot.version.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::vector<FlightEvent> FlightRecorder::events(std::optional<uint64_t> id) const {
+  std::vector<FlightEvent> events;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (const auto& ring : rings_) {
+      ring->collect(id, events);
+    }
+  }
+  std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b) { return a.time < b.time; });
+  return events;
+}
+
+std::string FlightRecorder::dump(std::optional<uint64_t> id) const {
+  const auto recorded = events(id);
+  std::ostringstream oss;
+  for (const auto& event : recorded) {
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(event.time - recorded.front().time).count();
+    const auto time = std::chrono::system_clock::to_time_t(event.time);
+    const auto micros =
+        std::chrono::duration_cast<std::chrono::microseconds>(event.time.time_since_epoch()).count() % 1000000;
+    std::tm tm;
+    gmtime_r(&time, &tm);
+    oss << std::put_time(&tm, "%FT%T.") << std::setw(6) << std::setfill('0') << micros << std::setfill(' ') << "Z "
+        << "+" << elapsed << "us " << event.thread << " " << event.name << " id=" << event.id << " arg=" << event.arg
+        << "\n";
+  }
+  return oss.str();
+}
+
+void FlightRecorder::clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& ring : rings_) {
+    ring->clear();
+  }
+}
+
+}  // namespace concord::diagnostics
@@ -112,6 +112,12 @@ TEST(diagnostics_tests, protocol) {
   // Getting status for multiple handlers works
   expected = async_handler_status + "\n" + async_handler_status + "\n";
   ASSERT_EQ(expected, run({"status", "get", async_handler_name, async_handler_name2}, registrar));
+
+  // Dumping recorded events works
+  registrar.events.record("TestEvent", 5, 1);
+  ASSERT_NE(std::string::npos, run({"events", "dump", "5"}, registrar).find("TestEvent id=5 arg=1\n"));
+  ASSERT_EQ("", run({"events", "dump", "6"}, registrar));
+  ASSERT_EQ(0, std::memcmp("Usage:", run({"events", "dump", "not_a_number"}, registrar).c_str(), 6));
 }
 
 TEST(diagnostics_server_tests, shutdown_cleanly_from_destructor) {
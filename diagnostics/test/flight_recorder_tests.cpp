@@ -0,0 +1,104 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "flight_recorder.h"
+
+using namespace concord::diagnostics;
+
+TEST(flight_recorder_tests, events_in_time_order) {
+  FlightRecorder recorder;
+  recorder.record("PrePrepareReceived", 1, 0);
+  std::thread([&recorder]() { recorder.record("PrepareCollected", 1, 0); }).join();
+  recorder.record("PrePrepareReceived", 2, 0);
+  recorder.record("CommitCollected", 1, 7);
+
+  auto events = recorder.events();
+  ASSERT_EQ(4, events.size());
+  for (size_t i = 1; i < events.size(); i++) {
+    ASSERT_LE(events[i - 1].time, events[i].time);
+  }
+
+  events = recorder.events(1);
+  ASSERT_EQ(3, events.size());
+  ASSERT_STREQ("PrePrepareReceived", events[0].name);
+  ASSERT_STREQ("PrepareCollected", events[1].name);
+  ASSERT_NE(events[0].thread, events[1].thread);
+  ASSERT_STREQ("CommitCollected", events[2].name);
+  ASSERT_EQ(7, events[2].arg);
+
+  auto dump = recorder.dump(2);
+  ASSERT_NE(std::string::npos, dump.find("PrePrepareReceived id=2 arg=0\n"));
+}
+
+TEST(flight_recorder_tests, keeps_last_events_per_thread) {
+  FlightRecorder recorder;
+  const auto num_events = FlightRecorder::kEventsPerThread + 10;
+  for (uint64_t i = 0; i < num_events; i++) {
+    recorder.record("Event", i);
+  }
+  auto events = recorder.events();
+  ASSERT_EQ(FlightRecorder::kEventsPerThread, events.size());
+  ASSERT_EQ(10, events.front().id);
+  ASSERT_EQ(num_events - 1, events.back().id);
+}
+
+TEST(flight_recorder_tests, disable) {
+  FlightRecorder recorder;
+  recorder.enable(false);
+  recorder.record("Event", 1);
+  ASSERT_TRUE(recorder.events().empty());
+  recorder.enable(true);
+  recorder.record("Event", 1);
+  ASSERT_EQ(1, recorder.events().size());
+}
+
+TEST(flight_recorder_tests, rings_of_exited_threads_are_reused) {
+  FlightRecorder recorder;
+  for (int i = 0; i < 3; i++) {
+    std::thread([&recorder, i]() { recorder.record("Event", i); }).join();
+  }
+  auto events = recorder.events();
+  // Each thread got the ring of the previous one
+  ASSERT_EQ(1, events.size());
+  ASSERT_EQ(2, events[0].id);
+}
+
+// Dumps run concurrently with recording threads. Every event dumped must be one that was recorded.
+TEST(flight_recorder_tests, concurrent_dumps) {
+  FlightRecorder recorder;
+  std::atomic_bool stop{false};
+  std::vector<std::thread> threads;
+  for (uint64_t t = 0; t < 4; t++) {
+    threads.emplace_back([&recorder, &stop, t]() {
+      for (uint64_t i = 0; !stop; i++) {
+        recorder.record("Event", t, i * 10 + t);
+      }
+    });
+  }
+  for (int i = 0; i < 100; i++) {
+    for (const auto& event : recorder.events()) {
+      ASSERT_STREQ("Event", event.name);
+      ASSERT_EQ(event.id, event.arg % 10);
+    }
+  }
+  stop = true;
+  for (auto& t : threads) {
+    t.join();
+  }
+}
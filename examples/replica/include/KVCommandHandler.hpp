@@ -28,6 +28,7 @@
 #include "SharedTypes.hpp"
 #include "categorization/db_categories.h"
 #include "kvbc_adapter/replica_adapter.hpp"
+#include "recent_writes_index.hpp"
 
 static const std::string VERSIONED_KV_CAT_ID{concord::kvbc::categorization::kExecutionPrivateCategory};
 static const std::string BLOCK_MERKLE_CAT_ID{concord::kvbc::categorization::kExecutionProvableCategory};
@@ -110,7 +111,8 @@ class KVCommandHandler : public concord::kvbc::ICommandsHandler {
   std::optional<std::string> get(const std::string &key, concord::kvbc::BlockId blockId) const;
   std::string getAtMost(const std::string &key, concord::kvbc::BlockId blockId) const;
   std::string getLatest(const std::string &key) const;
-  std::optional<concord::kvbc::BlockId> getLatestVersion(const std::string &key) const;
+  // Whether any of the keys was written after readVersion. Moves out the keys it has to look up in the storage.
+  bool hasReadSetConflict(std::vector<std::string> &keys, concord::kvbc::BlockId readVersion);
   std::optional<std::map<std::string, std::string>> getBlockUpdates(concord::kvbc::BlockId blockId) const;
   void writeAccumulatedBlock(ExecutionRequestsQueue &blockedRequests,
                              concord::kvbc::categorization::VersionedUpdates &verUpdates,
@@ -143,4 +145,7 @@ class KVCommandHandler : public concord::kvbc::ICommandsHandler {
   std::shared_ptr<concord::performance::PerformanceManager> perfManager_;
   bool addAllKeysAsPublic_{false};  // Add all key-values in the block merkle category as public ones.
   concord::kvbc::adapter::ReplicaBlockchain *kvbc_{nullptr};
+  // Keys written in the last blocks, such that most conflict checks don't have to read the storage
+  static constexpr size_t kRecentWritesIndexBlocks = 1024;
+  concord::kvbc::RecentWritesIndex recentWrites_{kRecentWritesIndexBlocks};
 };
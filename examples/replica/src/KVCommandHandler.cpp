@@ -222,14 +222,33 @@ std::string KVCommandHandler::getLatest(const std::string &key) const {
   return std::visit([](const auto &v) { return v.data; }, *v);
 }
 
-std::optional<BlockId> KVCommandHandler::getLatestVersion(const std::string &key) const {
-  const auto v = storageReader_->getLatestVersion(keyToCategory(key), key);
-  if (!v) {
-    return std::nullopt;
+bool KVCommandHandler::hasReadSetConflict(std::vector<std::string> &keys, BlockId readVersion) {
+  recentWrites_.sync(storageReader_->getLastBlockId());
+  const auto check = recentWrites_.writtenAfter(keys, readVersion);
+  if (check.conflict || check.unresolved.empty()) {
+    return check.conflict;
+  }
+
+  // Keys that weren't written recently are looked up with a single multi-get per category
+  auto categoryKeys = std::map<std::string, std::vector<std::string>>{};
+  for (const auto i : check.unresolved) {
+    categoryKeys[keyToCategory(keys[i])].push_back(std::move(keys[i]));
+  }
+  auto versions = std::vector<std::optional<TaggedVersion>>{};
+  for (const auto &[category, catKeys] : categoryKeys) {
+    storageReader_->multiGetLatestVersion(category, catKeys, versions);
+    for (const auto &v : versions) {
+      if (!v) {
+        continue;
+      }
+      // We never delete keys in TesterReplica at that stage.
+      ConcordAssert(!v->deleted);
+      if (v->version > readVersion) {
+        return true;
+      }
+    }
   }
-  // We never delete keys in TesterReplica at that stage.
-  ConcordAssert(!v->deleted);
-  return v->version;
+  return false;
 }
 
 std::optional<std::map<std::string, std::string>> KVCommandHandler::getBlockUpdates(
@@ -368,11 +387,23 @@ void KVCommandHandler::addBlock(VersionedUpdates &verUpdates, BlockMerkleUpdates
                               std::string{publicStateSer.cbegin(), publicStateSer.cend()});
   }
   addMetadataKeyValue(internalUpdates, sn);
+  auto writtenKeys = std::vector<std::string>{};
+  writtenKeys.reserve(verUpdates.size() + merkleUpdates.size());
+  for (const auto &[k, _] : verUpdates.getData().kv) {
+    (void)_;
+    writtenKeys.push_back(k);
+  }
+  for (const auto &[k, _] : merkleUpdates.getData().kv) {
+    (void)_;
+    writtenKeys.push_back(k);
+  }
   updates.add(kConcordInternalCategoryId, std::move(internalUpdates));
   updates.add(VERSIONED_KV_CAT_ID, std::move(verUpdates));
   updates.add(BLOCK_MERKLE_CAT_ID, std::move(merkleUpdates));
   const auto newBlockId = blockAdder_->add(std::move(updates));
   ConcordAssert(newBlockId == currBlock + 1);
+  recentWrites_.sync(currBlock);
+  recentWrites_.addBlock(newBlockId, writtenKeys);
 }
 
 bool KVCommandHandler::hasConflictInBlockAccumulatedRequests(const std::string &key,
@@ -424,23 +455,25 @@ OperationResult KVCommandHandler::executeWriteCommand(uint32_t requestSize,
                << " BLOCK_ACCUMULATION_ENABLED=" << isBlockAccumulationEnabled);
   BlockId currBlock = storageReader_->getLastBlockId();
 
-  // Look for conflicts
+  // Look for conflicts - first in the not yet written block accumulated requests, then in the blockchain
   bool hasConflict = false;
+  auto readKeys = std::vector<string>{};
+  readKeys.reserve(writeReq.readset.size());
   for (size_t i = 0; !hasConflict && i < writeReq.readset.size(); i++) {
     static_assert(
         sizeof(*(writeReq.readset[i].data())) == sizeof(string::value_type),
         "Byte pointer type used by concord::kvbc::IReader, concord::kvbc::categorization::VersionedUpdates, and/or "
         "concord::kvbc::categorization::BlockMerkleUpdates is incompatible with byte pointer type used by CMF.");
-    const string key =
-        string(reinterpret_cast<const string::value_type *>(writeReq.readset[i].data()), writeReq.readset[i].size());
-    const auto latestVer = getLatestVersion(key);
-    hasConflict = (latestVer && latestVer > writeReq.read_version);
-    if (isBlockAccumulationEnabled && !hasConflict) {
-      if (hasConflictInBlockAccumulatedRequests(key, blockAccumulatedVerUpdates, blockAccumulatedMerkleUpdates)) {
-        hasConflict = true;
-      }
+    const auto &key = readKeys.emplace_back(reinterpret_cast<const string::value_type *>(writeReq.readset[i].data()),
+                                            writeReq.readset[i].size());
+    if (isBlockAccumulationEnabled) {
+      hasConflict =
+          hasConflictInBlockAccumulatedRequests(key, blockAccumulatedVerUpdates, blockAccumulatedMerkleUpdates);
     }
   }
+  if (!hasConflict) {
+    hasConflict = hasReadSetConflict(readKeys, writeReq.read_version);
+  }
 
   if (!hasConflict) {
     if (isBlockAccumulationEnabled) {
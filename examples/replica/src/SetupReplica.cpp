@@ -54,12 +54,16 @@ void SetupReplica::ParseReplicaConfFile(bftEngine::ReplicaConfig& replicaConfig,
   readYamlField(rconfig_yaml, "statusReportTimerMillisec", replicaConfig.statusReportTimerMillisec);
   readYamlField(rconfig_yaml, "preExecutionFeatureEnabled", replicaConfig.preExecutionFeatureEnabled);
   readYamlField(rconfig_yaml, "clientBatchingEnabled", replicaConfig.clientBatchingEnabled);
+  readYamlField(rconfig_yaml, "maxPrimaryQueueRequestsPerClient", replicaConfig.maxPrimaryQueueRequestsPerClient);
   readYamlField(rconfig_yaml, "pruningEnabled_", replicaConfig.pruningEnabled_);
   readYamlField(rconfig_yaml, "numBlocksToKeep_", replicaConfig.numBlocksToKeep_);
   readYamlField(rconfig_yaml, "batchedPreProcessEnabled", replicaConfig.batchedPreProcessEnabled);
   readYamlField(rconfig_yaml, "timeServiceEnabled", replicaConfig.timeServiceEnabled);
   readYamlField(rconfig_yaml, "enablePostExecutionSeparation", replicaConfig.enablePostExecutionSeparation);
   readYamlField(rconfig_yaml, "preExecutionResultAuthEnabled", replicaConfig.preExecutionResultAuthEnabled);
+  readYamlField(rconfig_yaml,
+                "preExecutionResultThresholdSignEnabled",
+                replicaConfig.preExecutionResultThresholdSignEnabled);
   readYamlField(rconfig_yaml, "numOfClientServices", replicaConfig.numOfClientServices);
   readYamlField(rconfig_yaml, "viewChangeProtocolEnabled", replicaConfig.viewChangeProtocolEnabled);
   readYamlField(rconfig_yaml, "autoPrimaryRotationTimerMillisec", replicaConfig.autoPrimaryRotationTimerMillisec);
@@ -112,6 +112,9 @@ class Replica : public IReplica,
                                   char *outBlock,
                                   uint32_t outBlockMaxSize,
                                   uint32_t *outBlockActualSize) override final;
+  void getBlocks(const std::vector<uint64_t> &blockIds,
+                 uint32_t outBlockMaxSize,
+                 std::vector<std::optional<std::string>> &outBlocks) const override final;
   bool getPrevDigestFromBlock(uint64_t blockId, bftEngine::bcst::StateTransferDigest *) const override final;
   void getPrevDigestFromBlock(const char *blockData,
                               const uint32_t blockSize,
@@ -45,6 +45,7 @@ namespace bcutil {
 class BlockChainUtils {
  public:
   static std::string publicStateHashKey();
+  static std::string partitionedPublicStateHashKey();
 };
 }  // namespace bcutil
 }  // end namespace concord::kvbc
@@ -45,6 +45,11 @@ class KVBCStateSnapshot : public concord::kvbc::IKVBCStateSnapshot {
       BlockId checkpoint_block_id,
       const Converter& value_converter = [](std::string&& s) -> std::string { return std::move(s); }) override final;
 
+  // Computes and persists the partitioned public state hash, see IKVBCStateSnapshot.
+  void computeAndPersistPartitionedPublicStateHash(
+      BlockId checkpoint_block_id,
+      const Converter& value_converter = [](std::string&& s) -> std::string { return std::move(s); }) override final;
+
   // Returns the public state keys as of the current point in the blockchain's history.
   // Returns std::nullopt if no public keys have been persisted.
   std::optional<concord::kvbc::categorization::PublicStateKeys> getPublicStateKeys() const override final;
@@ -72,6 +77,12 @@ class KVBCStateSnapshot : public concord::kvbc::IKVBCStateSnapshot {
   bool iteratePublicStateKeyValuesImpl(const std::function<void(std::string&&, std::string&&)>& f,
                                        const std::optional<std::string>& after_key) const;
 
+  // Returns the chained hash of keys[begin, end), starting from hash("")
+  concord::kvbc::categorization::Hash hashPublicStateKeys(const std::vector<std::string>& keys,
+                                                          std::size_t begin,
+                                                          std::size_t end,
+                                                          const Converter& value_converter) const;
+
  private:
   const concord::kvbc::IReader* reader_{nullptr};
   std::shared_ptr<concord::storage::rocksdb::NativeClient> native_client_;
@@ -140,6 +140,11 @@ class ReplicaBlockchain : public IBlocksDeleter,
                 uint32_t *outBlockActualSize) const override final {
     return app_state_->getBlock(blockId, outBlock, outBlockMaxSize, outBlockActualSize);
   }
+  void getBlocks(const std::vector<uint64_t> &blockIds,
+                 uint32_t outBlockMaxSize,
+                 std::vector<std::optional<std::string>> &outBlocks) const override final {
+    app_state_->getBlocks(blockIds, outBlockMaxSize, outBlocks);
+  }
 
   std::future<bool> getBlockAsync(uint64_t blockId,
                                   char *outBlock,
@@ -197,6 +202,12 @@ class ReplicaBlockchain : public IBlocksDeleter,
     state_snapshot_->computeAndPersistPublicStateHash(checkpoint_block_id, value_converter);
   }
 
+  void computeAndPersistPartitionedPublicStateHash(
+      BlockId checkpoint_block_id,
+      const Converter &value_converter = [](std::string &&s) -> std::string { return std::move(s); }) override final {
+    state_snapshot_->computeAndPersistPartitionedPublicStateHash(checkpoint_block_id, value_converter);
+  }
+
   std::optional<categorization::PublicStateKeys> getPublicStateKeys() const override final {
     return state_snapshot_->getPublicStateKeys();
   }
@@ -41,6 +41,12 @@ class AppStateAdapter : public bftEngine::bcst::IAppState {
     ConcordAssert(false);
     return std::async([]() { return false; });
   }
+
+  // Reads the blocks with a single multiGet
+  virtual void getBlocks(const std::vector<uint64_t> &blockIds,
+                         uint32_t outBlockMaxSize,
+                         std::vector<std::optional<std::string>> &outBlocks) const override;
+
   virtual bool getPrevDigestFromBlock(uint64_t blockId,
                                       bftEngine::bcst::StateTransferDigest *outPrevBlockDigest) const override;
 
@@ -0,0 +1,134 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "kv_types.hpp"
+
+namespace concord::kvbc {
+
+// In-memory index of the keys written in the last `num_blocks` blocks, mapping every key to the latest block it was
+// written in. Used by the execution engines for MVCC conflict detection (was a key written after the block a request
+// has read it at?) such that most read-set checks are answered without going to the storage.
+//
+// The index only knows about the blocks it was told about via addBlock(). Blocks that were added by others (e.g. state
+// transfer) are detected by sync() and reset the index. Writes in [firstBlockId(), lastBlockId()] are always indexed.
+//
+// Not thread safe.
+class RecentWritesIndex {
+ public:
+  struct ReadSetCheck {
+    bool conflict{false};
+    // Positions of the keys the index can't decide on, i.e. the caller has to look up their latest versions
+    std::vector<std::size_t> unresolved;
+  };
+
+  explicit RecentWritesIndex(std::size_t num_blocks) : num_blocks_{std::max<std::size_t>(num_blocks, 1)} {}
+
+  // Make sure the index is in line with the blockchain. Should be called with the last block ID before the index is
+  // used.
+  void sync(BlockId last_block_id) {
+    if (last_block_id != last_block_id_) {
+      reset(last_block_id + 1);
+      last_block_id_ = last_block_id;
+    }
+  }
+
+  // Index the keys written in `block_id`. `keys` is any range of strings.
+  template <typename KeysRange>
+  void addBlock(BlockId block_id, const KeysRange& keys) {
+    if (block_id != last_block_id_ + 1) {
+      reset(block_id);
+    }
+    auto& block_keys = blocks_.emplace_back();
+    for (const auto& key : keys) {
+      latest_[key] = block_id;
+      block_keys.push_back(key);
+    }
+    last_block_id_ = block_id;
+    while (blocks_.size() > num_blocks_) {
+      for (const auto& key : blocks_.front()) {
+        auto it = latest_.find(key);
+        if (it != latest_.end() && it->second == first_block_id_) {
+          latest_.erase(it);
+        }
+      }
+      blocks_.pop_front();
+      ++first_block_id_;
+    }
+  }
+
+  // The latest block `key` was written in, if it was written in an indexed block
+  std::optional<BlockId> latestVersion(const std::string& key) const {
+    auto it = latest_.find(key);
+    if (it == latest_.cend()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  // Check whether any of `keys` was written after `block_id`. `block_id` is usually the read version of a request or
+  // the block ID its pre-execution ran at (see ReplicaImp::setConflictDetectionBlockId).
+  // If all blocks after `block_id` are indexed, the check is complete. Otherwise, the keys that weren't written in the
+  // indexed blocks are reported as unresolved.
+  template <typename KeysRange>
+  ReadSetCheck writtenAfter(const KeysRange& keys, BlockId block_id) const {
+    auto result = ReadSetCheck{};
+    const auto complete = covers(block_id + 1);
+    std::size_t i = 0;
+    for (const auto& key : keys) {
+      const auto version = latestVersion(key);
+      if (version) {
+        if (*version > block_id) {
+          result.conflict = true;
+          result.unresolved.clear();
+          return result;
+        }
+      } else if (!complete) {
+        result.unresolved.push_back(i);
+      }
+      ++i;
+    }
+    return result;
+  }
+
+  // Whether all writes in blocks [block_id, lastBlockId()] are indexed
+  bool covers(BlockId block_id) const { return block_id >= first_block_id_; }
+
+  BlockId firstBlockId() const { return first_block_id_; }
+  BlockId lastBlockId() const { return last_block_id_; }
+  std::size_t size() const { return latest_.size(); }
+
+ private:
+  void reset(BlockId first_block_id) {
+    latest_.clear();
+    blocks_.clear();
+    first_block_id_ = first_block_id;
+  }
+
+  const std::size_t num_blocks_;
+  std::unordered_map<std::string, BlockId> latest_;
+  std::deque<std::vector<std::string>> blocks_;
+  BlockId first_block_id_{1};
+  BlockId last_block_id_{0};
+};
+
+}  // namespace concord::kvbc
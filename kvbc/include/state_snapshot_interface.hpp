@@ -12,6 +12,7 @@
 // file.
 
 #pragma once
+#include <cstdint>
 #include <optional>
 #include <functional>
 #include <string>
@@ -37,6 +38,19 @@ class IDBCheckpoint {
   virtual ~IDBCheckpoint() = default;
 };
 
+// Versions of the public state hash. Each version is persisted under its own key, so that snapshots with either of them
+// can coexist.
+enum class PublicStateHashVersion : std::uint8_t {
+  // See IKVBCStateSnapshot::computeAndPersistPublicStateHash()
+  kChained = 1,
+  // See IKVBCStateSnapshot::computeAndPersistPartitionedPublicStateHash()
+  kPartitioned = 2,
+};
+
+// Number of (sorted) public keys in a partition of the partitioned public state hash. Changing it changes the hash and
+// therefore requires a new PublicStateHashVersion.
+constexpr std::uint64_t kPublicStateHashPartitionSize = 4096;
+
 // State snapshot support.
 class IKVBCStateSnapshot {
  public:
@@ -51,6 +65,19 @@ class IKVBCStateSnapshot {
   // Precondition: The current KeyValueBlockchain instance points to a DB snapshot.
   virtual void computeAndPersistPublicStateHash(BlockId checkpoint_block_id, const Converter& value_converter) = 0;
 
+  // Computes and persists the partitioned public state hash. The sorted public keys are split into partitions of
+  // kPublicStateHashPartitionSize keys, such that partition `j` holds keys k(j*P+1) to k((j+1)*P). Then:
+  //  pj = the chained hash above, computed over the keys of partition `j` only
+  //  h = hash(p0 || p1 || ... || pM)
+  //
+  // Partitions are hashed in parallel, hence `value_converter` is called concurrently. A change of a value only changes
+  // the hash of its partition.
+  //
+  // This method is supposed to be called on DB snapshots only and not on the actual blockchain.
+  // Precondition: The current KeyValueBlockchain instance points to a DB snapshot.
+  virtual void computeAndPersistPartitionedPublicStateHash(BlockId checkpoint_block_id,
+                                                           const Converter& value_converter) = 0;
+
   // Returns the public state keys as of the current point in the blockchain's history.
   // Returns std::nullopt if no public keys have been persisted.
   virtual std::optional<concord::kvbc::categorization::PublicStateKeys> getPublicStateKeys() const = 0;
@@ -51,6 +51,9 @@ class KeyValueBlockchain {
   // if the block exists, returns the content of the block i.e. raw block
   // the block origin can be the blockchain or the state-transfer chain
   std::optional<std::string> getBlockData(const BlockId &) const;
+  // Batched version of getBlockData. block_ids must be unique, values are returned in the same order.
+  // Blocks of the blockchain are read with a single multiGet.
+  void multiGetBlockData(const std::vector<BlockId> &block_ids, std::vector<std::optional<std::string>> &values) const;
   // Insert the block buffer to the ST chain, if last block is true, it links the ST chain
   // To the blockchain.
   void addBlockToSTChain(const BlockId &, const char *block, const uint32_t blockSize, bool lastBlock);
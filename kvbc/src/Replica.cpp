@@ -363,7 +363,12 @@ void Replica::createReplicaAndSyncState() {
         const auto link_st_chain = false;
         auto kvbc = adapter::ReplicaBlockchain{db, link_st_chain};
         kvbc.trimBlocksFromCheckpoint(block_id_at_checkpoint);
-        kvbc.computeAndPersistPublicStateHash(block_id_at_checkpoint, value_converter);
+        if (bftEngine::ReplicaConfig::instance().publicStateHashVersion ==
+            static_cast<std::uint32_t>(PublicStateHashVersion::kPartitioned)) {
+          kvbc.computeAndPersistPartitionedPublicStateHash(block_id_at_checkpoint, value_converter);
+        } else {
+          kvbc.computeAndPersistPublicStateHash(block_id_at_checkpoint, value_converter);
+        }
       },
       [this](bool flag, kvbc::BlockId id) { checkpointInProcess(flag, id); });
 }
@@ -524,7 +529,12 @@ Replica::Replica(ICommunication *comm,
     replicaConfig_.get("concord.bft.st.enableReservedPages", true),
     replicaConfig_.get("concord.bft.st.enableSourceBlocksPreFetch", true),
     replicaConfig_.get("concord.bft.st.enableSourceSelectorPrimaryAwareness", true),
-    replicaConfig_.get("concord.bft.st.enableStoreRvbDataDuringCheckpointing", true)
+    replicaConfig_.get("concord.bft.st.enableStoreRvbDataDuringCheckpointing", true),
+    replicaConfig_.get("concord.bft.st.enableStripedFetching", false),
+    replicaConfig_.get<uint16_t>("concord.bft.st.maxNumOfFetchStripes", 3),
+    replicaConfig_.get<uint16_t>("concord.bft.st.blockCompressionType", 0),
+    replicaConfig_.get<uint16_t>("concord.bft.st.resPagesDigestVersion", 1),
+    replicaConfig_.get<uint32_t>("concord.bft.st.sourceBlocksCacheSizeMb", 0)
   };
   stConfig.runInSeparateThread = replicaConfig_.isReadOnly ? false : true;
 
@@ -757,6 +767,17 @@ std::future<bool> Replica::getBlockAsync(uint64_t blockId,
   return future;
 }
 
+void Replica::getBlocks(const std::vector<uint64_t> &blockIds,
+                        uint32_t outBlockMaxSize,
+                        std::vector<std::optional<std::string>> &outBlocks) const {
+  if (replicaConfig_.isReadOnly) {
+    // the object store is read block by block
+    IAppState::getBlocks(blockIds, outBlockMaxSize, outBlocks);
+    return;
+  }
+  m_kvBlockchain->getBlocks(blockIds, outBlockMaxSize, outBlocks);
+}
+
 bool Replica::getBlockFromObjectStore(uint64_t blockId,
                                       char *outBlock,
                                       uint32_t outblockMaxSize,
@@ -53,7 +53,10 @@ block_version BlockVersion::getBlockVersion(const char* raw_block_ser, size_t le
 namespace bcutil {
 static const auto kPublicStateHashKey = concord::storage::v2MerkleTree::detail::serialize(
     concord::storage::v2MerkleTree::detail::EBFTSubtype::PublicStateHashAtDbCheckpoint);
+static const auto kPartitionedPublicStateHashKey = concord::storage::v2MerkleTree::detail::serialize(
+    concord::storage::v2MerkleTree::detail::EBFTSubtype::PartitionedPublicStateHashAtDbCheckpoint);
 
 std::string BlockChainUtils::publicStateHashKey() { return kPublicStateHashKey; }
+std::string BlockChainUtils::partitionedPublicStateHashKey() { return kPartitionedPublicStateHashKey; }
 }  // end of namespace bcutil
 }  // end of namespace concord::kvbc
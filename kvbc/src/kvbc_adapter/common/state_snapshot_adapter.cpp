@@ -11,32 +11,74 @@
 // terms and conditions of the subcomponent's license, as noted in the LICENSE
 // file.
 
+#include <algorithm>
+#include <future>
 #include <variant>
 #include "categorization/details.h"
 #include "categorization/db_categories.h"
 #include "kvbc_key_types.hpp"
 #include "kvbc_adapter/common/state_snapshot_adapter.hpp"
+#include "util/thread_pool.hpp"
 
 namespace concord::kvbc::adapter::common::statesnapshot {
+
+// h = hash(h || hash(key) || value)
+static void nextHash(const std::string& key, const std::string& value, concord::kvbc::categorization::Hash& hash) {
+  auto hasher = concord::kvbc::categorization::Hasher{};
+  hasher.init();
+  hasher.update(hash.data(), hash.size());
+  const auto key_hash = concord::kvbc::categorization::detail::hash(key);
+  hasher.update(key_hash.data(), key_hash.size());
+  hasher.update(value.data(), value.size());
+  hash = hasher.finish();
+}
+
 ////////////////////////////IKVBCStateSnapshot////////////////////////////////////////////////////////////////////////
 void KVBCStateSnapshot::computeAndPersistPublicStateHash(BlockId checkpoint_block_id,
                                                          const Converter& value_converter) {
   auto hash = concord::kvbc::categorization::detail::hash(std::string{});
-  iteratePublicStateKeyValues([&](std::string&& key, std::string&& value) {
-    value = value_converter(std::move(value));
-    auto hasher = concord::kvbc::categorization::Hasher{};
-    hasher.init();
-    hasher.update(hash.data(), hash.size());
-    const auto key_hash = concord::kvbc::categorization::detail::hash(key);
-    hasher.update(key_hash.data(), key_hash.size());
-    hasher.update(value.data(), value.size());
-    hash = hasher.finish();
-  });
+  iteratePublicStateKeyValues(
+      [&](std::string&& key, std::string&& value) { nextHash(key, value_converter(std::move(value)), hash); });
   native_client_->put(concord::kvbc::bcutil::BlockChainUtils::publicStateHashKey(),
                       concord::kvbc::categorization::detail::serialize(
                           concord::kvbc::categorization::StateHash{checkpoint_block_id, hash}));
 }
 
+void KVBCStateSnapshot::computeAndPersistPartitionedPublicStateHash(BlockId checkpoint_block_id,
+                                                                    const Converter& value_converter) {
+  auto keys = std::vector<std::string>{};
+  if (auto public_state = getPublicStateKeys()) {
+    keys = std::move(public_state->keys);
+  }
+  const auto partitions = (keys.size() + kPublicStateHashPartitionSize - 1) / kPublicStateHashPartitionSize;
+  auto partition_hashes = std::vector<concord::kvbc::categorization::Hash>(partitions);
+  {
+    concord::util::ThreadPool pool{"KVBCStateSnapshot::computeAndPersistPartitionedPublicStateHash::pool"};
+    auto tasks = std::vector<std::future<void>>{};
+    tasks.reserve(partitions);
+    for (auto i = 0ull; i < partitions; ++i) {
+      tasks.push_back(pool.async([&keys, &partition_hashes, &value_converter, i, this]() {
+        const auto begin = i * kPublicStateHashPartitionSize;
+        const auto end = std::min<std::size_t>(begin + kPublicStateHashPartitionSize, keys.size());
+        partition_hashes[i] = hashPublicStateKeys(keys, begin, end, value_converter);
+      }));
+    }
+    // Rethrows the exception of a failed partition, if any
+    for (auto& task : tasks) {
+      task.get();
+    }
+  }
+  // With no partitions, this is hash("") - the same as for the chained hash
+  auto hasher = concord::kvbc::categorization::Hasher{};
+  hasher.init();
+  for (const auto& partition_hash : partition_hashes) {
+    hasher.update(partition_hash.data(), partition_hash.size());
+  }
+  native_client_->put(concord::kvbc::bcutil::BlockChainUtils::partitionedPublicStateHashKey(),
+                      concord::kvbc::categorization::detail::serialize(
+                          concord::kvbc::categorization::StateHash{checkpoint_block_id, hasher.finish()}));
+}
+
 std::optional<concord::kvbc::categorization::PublicStateKeys> KVBCStateSnapshot::getPublicStateKeys() const {
   const auto opt_val = reader_->getLatest(concord::kvbc::categorization::kConcordInternalCategoryId,
                                           concord::kvbc::keyTypes::state_public_key_set);
@@ -108,4 +150,34 @@ bool KVBCStateSnapshot::iteratePublicStateKeyValuesImpl(const std::function<void
   return true;
 }
 
+concord::kvbc::categorization::Hash KVBCStateSnapshot::hashPublicStateKeys(const std::vector<std::string>& keys,
+                                                                           std::size_t begin,
+                                                                           std::size_t end,
+                                                                           const Converter& value_converter) const {
+  auto hash = concord::kvbc::categorization::detail::hash(std::string{});
+  const auto batch_size =
+      std::max<std::size_t>(bftEngine::ReplicaConfig::instance().stateIterationMultiGetBatchSize, 1);
+  auto keys_batch = std::vector<std::string>{};
+  keys_batch.reserve(batch_size);
+  auto opt_values = std::vector<std::optional<concord::kvbc::categorization::Value>>{};
+  opt_values.reserve(batch_size);
+  for (auto idx = begin; idx < end;) {
+    keys_batch.clear();
+    opt_values.clear();
+    for (; keys_batch.size() < batch_size && idx < end; ++idx) {
+      keys_batch.push_back(keys[idx]);
+    }
+    reader_->multiGetLatest(concord::kvbc::categorization::kExecutionProvableCategory, keys_batch, opt_values);
+    ConcordAssertEQ(keys_batch.size(), opt_values.size());
+    for (auto i = 0ull; i < keys_batch.size(); ++i) {
+      auto& opt_value = opt_values[i];
+      ConcordAssert(opt_value.has_value());
+      auto value = std::get_if<concord::kvbc::categorization::MerkleValue>(&opt_value.value());
+      ConcordAssertNE(value, nullptr);
+      nextHash(keys_batch[i], value_converter(std::move(value->data)), hash);
+    }
+  }
+  return hash;
+}
+
 }  // namespace concord::kvbc::adapter::common::statesnapshot
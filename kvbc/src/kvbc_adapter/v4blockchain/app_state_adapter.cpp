@@ -38,6 +38,18 @@ bool AppStateAdapter::getBlock(uint64_t blockId,
   return true;
 }
 
+void AppStateAdapter::getBlocks(const std::vector<uint64_t> &blockIds,
+                                uint32_t outBlockMaxSize,
+                                std::vector<std::optional<std::string>> &outBlocks) const {
+  kvbc_->multiGetBlockData(blockIds, outBlocks);
+  for (const auto &blockData : outBlocks) {
+    if (blockData && (blockData->size() > outBlockMaxSize)) {
+      LOG_ERROR(V4_BLOCK_LOG, KVLOG(blockData->size(), outBlockMaxSize));
+      throw std::runtime_error("not enough space to copy block!");
+    }
+  }
+}
+
 bool AppStateAdapter::getPrevDigestFromBlock(uint64_t blockId,
                                              bftEngine::bcst::StateTransferDigest *outPrevBlockDigest) const {
   ConcordAssert(blockId > 0);
@@ -209,6 +209,8 @@ EBFTSubtype DBKeyManipulator::getBftSubtype(const Sliver &s) {
       return EBFTSubtype::STTempBlock;
     case toChar(EBFTSubtype::PublicStateHashAtDbCheckpoint):
       return EBFTSubtype::PublicStateHashAtDbCheckpoint;
+    case toChar(EBFTSubtype::PartitionedPublicStateHashAtDbCheckpoint):
+      return EBFTSubtype::PartitionedPublicStateHashAtDbCheckpoint;
   }
   ConcordAssert(false);
 
@@ -309,7 +309,12 @@ bool StateSnapshotReconfigurationHandler::handle(const concord::messages::Signed
       const auto read_only = true;
       try {
         auto db = NativeClient::newClient(snapshot_path, read_only, NativeClient::DefaultOptions{});
-        const auto ser_hash = db->get(concord::kvbc::bcutil::BlockChainUtils::publicStateHashKey());
+        // A snapshot has either a partitioned or a chained public state hash. The response doesn't carry the version,
+        // which keeps its wire format - clients compare the hash with both versions.
+        auto ser_hash = db->get(concord::kvbc::bcutil::BlockChainUtils::partitionedPublicStateHashKey());
+        if (!ser_hash) {
+          ser_hash = db->get(concord::kvbc::bcutil::BlockChainUtils::publicStateHashKey());
+        }
         if (!ser_hash) {
           LOG_ERROR(getLogger(),
                     "SignedPublicStateHashRequest: missing public state hash for snapshot ID = "
@@ -347,6 +347,31 @@ std::optional<std::string> KeyValueBlockchain::getBlockData(const BlockId &block
   return block_chain_.getBlockData(block_id);
 }
 
+void KeyValueBlockchain::multiGetBlockData(const std::vector<BlockId> &block_ids,
+                                           std::vector<std::optional<std::string>> &values) const {
+  values.clear();
+  values.reserve(block_ids.size());
+  const auto last_reachable_block = getLastReachableBlockId();
+  std::vector<BlockId> reachable_block_ids;
+  reachable_block_ids.reserve(block_ids.size());
+  for (const auto id : block_ids) {
+    if (id <= last_reachable_block) {
+      reachable_block_ids.push_back(id);
+    }
+  }
+  std::unordered_map<BlockId, std::optional<std::string>> reachable_blocks;
+  if (!reachable_block_ids.empty()) {
+    block_chain_.multiGetBlockData(reachable_block_ids, reachable_blocks);
+  }
+  for (const auto id : block_ids) {
+    if (id > last_reachable_block) {
+      values.push_back(state_transfer_chain_.getBlockData(id));
+    } else {
+      values.push_back(std::move(reachable_blocks.at(id)));
+    }
+  }
+}
+
 std::optional<BlockId> KeyValueBlockchain::getLastStatetransferBlockId() const {
   if (state_transfer_chain_.getLastBlockId() == 0) return std::nullopt;
   return state_transfer_chain_.getLastBlockId();
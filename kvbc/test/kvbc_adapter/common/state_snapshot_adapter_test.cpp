@@ -412,6 +412,177 @@ TEST_F(common_kvbc, compute_and_persist_hash_batch_size_less_than_key_count_even
   }
 }
 
+// A single partition: hash(h4), where h4 is the chained hash from assertPublicStateHash().
+TEST_F(common_kvbc, compute_and_persist_partitioned_hash_single_partition) {
+  bool version_is_set = false;
+  std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE> cat_map;
+  for (int32_t ver = 0; ver <= static_cast<int32_t>(concord::kvbc::BLOCKCHAIN_VERSION::INVALID_BLOCKCHAIN_VERSION);
+       ++ver) {
+    auto blockchain_version = getBlockchainVersion(ver);
+    if (!blockchain_version) {
+      continue;
+    }
+    switch (*blockchain_version) {
+      case concord::kvbc::BLOCKCHAIN_VERSION::CATEGORIZED_BLOCKCHAIN:
+        if (!version_is_set) {
+          bftEngine::ReplicaConfig::instance().kvBlockchainVersion = static_cast<uint32_t>(ver);
+          version_is_set = true;
+          cat_map.emplace(concord::kvbc::categorization::kExecutionProvableCategory,
+                          concord::kvbc::categorization::CATEGORY_TYPE::block_merkle);
+          cat_map.emplace(concord::kvbc::categorization::kConcordInternalCategoryId,
+                          concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+        }
+      case concord::kvbc::BLOCKCHAIN_VERSION::V4_BLOCKCHAIN:
+        if (!version_is_set) {
+          bftEngine::ReplicaConfig::instance().kvBlockchainVersion = static_cast<uint32_t>(ver);
+          version_is_set = true;
+          cat_map.emplace("merkle", concord::kvbc::categorization::CATEGORY_TYPE::block_merkle);
+          cat_map.emplace("versioned", concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+          cat_map.emplace(concord::kvbc::categorization::kConcordInternalCategoryId,
+                          concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+        }
+        {
+          const auto link_st_chain = true;
+          auto kvbc = concord::kvbc::adapter::ReplicaBlockchain{
+              db,
+              link_st_chain,
+              std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE>{
+                  {concord::kvbc::categorization::kExecutionProvableCategory,
+                   concord::kvbc::categorization::CATEGORY_TYPE::block_merkle},
+                  {concord::kvbc::categorization::kConcordInternalCategoryId,
+                   concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv}}};
+          addPublicState(kvbc);
+          bftEngine::ReplicaConfig::instance().stateIterationMultiGetBatchSize = 3;
+          kvbc.computeAndPersistPartitionedPublicStateHash(1);
+          // Each version is persisted under its own key
+          ASSERT_FALSE(db->get(concord::kvbc::bcutil::BlockChainUtils::publicStateHashKey()).has_value());
+          const auto state_hash_val = db->get(concord::kvbc::bcutil::BlockChainUtils::partitionedPublicStateHashKey());
+          ASSERT_TRUE(state_hash_val.has_value());
+          auto state_hash = concord::kvbc::categorization::StateHash{};
+          concord::kvbc::categorization::detail::deserialize(*state_hash_val, state_hash);
+          ASSERT_EQ(state_hash.block_id, 1);
+          ASSERT_THAT(
+              state_hash.hash,
+              ContainerEq(concord::kvbc::categorization::Hash{
+                  0xf8, 0x00, 0xc6, 0x67, 0x4e, 0x70, 0xec, 0xb2, 0x60, 0xf6, 0xf2, 0x18, 0xf4, 0x40, 0x45, 0x4b,
+                  0x6c, 0xbf, 0x95, 0xca, 0xe6, 0xc4, 0x25, 0x06, 0x50, 0x66, 0xd2, 0xc1, 0x73, 0x28, 0x92, 0x45}));
+        }
+        version_is_set = false;
+        break;
+      case concord::kvbc::BLOCKCHAIN_VERSION::INVALID_BLOCKCHAIN_VERSION:
+        version_is_set = false;
+        break;
+    }
+  }
+}
+
+TEST_F(common_kvbc, compute_and_persist_partitioned_hash_multiple_partitions) {
+  bool version_is_set = false;
+  std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE> cat_map;
+  for (int32_t ver = 0; ver <= static_cast<int32_t>(concord::kvbc::BLOCKCHAIN_VERSION::INVALID_BLOCKCHAIN_VERSION);
+       ++ver) {
+    auto blockchain_version = getBlockchainVersion(ver);
+    if (!blockchain_version) {
+      continue;
+    }
+    switch (*blockchain_version) {
+      case concord::kvbc::BLOCKCHAIN_VERSION::CATEGORIZED_BLOCKCHAIN:
+        if (!version_is_set) {
+          bftEngine::ReplicaConfig::instance().kvBlockchainVersion = static_cast<uint32_t>(ver);
+          version_is_set = true;
+          cat_map.emplace(concord::kvbc::categorization::kExecutionProvableCategory,
+                          concord::kvbc::categorization::CATEGORY_TYPE::block_merkle);
+          cat_map.emplace(concord::kvbc::categorization::kConcordInternalCategoryId,
+                          concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+        }
+      case concord::kvbc::BLOCKCHAIN_VERSION::V4_BLOCKCHAIN:
+        if (!version_is_set) {
+          bftEngine::ReplicaConfig::instance().kvBlockchainVersion = static_cast<uint32_t>(ver);
+          version_is_set = true;
+          cat_map.emplace("merkle", concord::kvbc::categorization::CATEGORY_TYPE::block_merkle);
+          cat_map.emplace("versioned", concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+          cat_map.emplace(concord::kvbc::categorization::kConcordInternalCategoryId,
+                          concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv);
+        }
+        {
+          const auto link_st_chain = true;
+          auto kvbc = concord::kvbc::adapter::ReplicaBlockchain{
+              db,
+              link_st_chain,
+              std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE>{
+                  {concord::kvbc::categorization::kExecutionProvableCategory,
+                   concord::kvbc::categorization::CATEGORY_TYPE::block_merkle},
+                  {concord::kvbc::categorization::kConcordInternalCategoryId,
+                   concord::kvbc::categorization::CATEGORY_TYPE::versioned_kv}}};
+          // Two full partitions and a partial one
+          const auto key_count = 2 * concord::kvbc::kPublicStateHashPartitionSize + 1;
+          auto updates = concord::kvbc::categorization::Updates{};
+          auto merkle = concord::kvbc::categorization::BlockMerkleUpdates{};
+          auto public_state = concord::kvbc::categorization::PublicStateKeys{};
+          for (auto i = 0ull; i < key_count; ++i) {
+            auto key = std::to_string(100000 + i);
+            merkle.addUpdate(std::string{key}, "v" + key);
+            public_state.keys.push_back(std::move(key));
+          }
+          auto versioned = concord::kvbc::categorization::VersionedUpdates{};
+          const auto ser_public_state = concord::kvbc::categorization::detail::serialize(public_state);
+          versioned.addUpdate(std::string{concord::kvbc::keyTypes::state_public_key_set},
+                              std::string{ser_public_state.cbegin(), ser_public_state.cend()});
+          updates.add(concord::kvbc::categorization::kExecutionProvableCategory, std::move(merkle));
+          updates.add(concord::kvbc::categorization::kConcordInternalCategoryId, std::move(versioned));
+          ASSERT_EQ(kvbc.add(std::move(updates)), 1);
+
+          // Compute the expected hash sequentially
+          auto partition_hashes = std::vector<concord::kvbc::categorization::Hash>{};
+          auto partition_hash = concord::kvbc::categorization::detail::hash(std::string{});
+          auto partition_keys = 0ull;
+          kvbc.iteratePublicStateKeyValues([&](std::string&& key, std::string&& value) {
+            auto hasher = concord::kvbc::categorization::Hasher{};
+            hasher.init();
+            hasher.update(partition_hash.data(), partition_hash.size());
+            const auto key_hash = concord::kvbc::categorization::detail::hash(key);
+            hasher.update(key_hash.data(), key_hash.size());
+            hasher.update(value.data(), value.size());
+            partition_hash = hasher.finish();
+            if (++partition_keys == concord::kvbc::kPublicStateHashPartitionSize) {
+              partition_hashes.push_back(partition_hash);
+              partition_hash = concord::kvbc::categorization::detail::hash(std::string{});
+              partition_keys = 0;
+            }
+          });
+          ASSERT_EQ(partition_keys, 1);
+          partition_hashes.push_back(partition_hash);
+          auto hasher = concord::kvbc::categorization::Hasher{};
+          hasher.init();
+          for (const auto& h : partition_hashes) {
+            hasher.update(h.data(), h.size());
+          }
+          const auto expected = hasher.finish();
+
+          bftEngine::ReplicaConfig::instance().stateIterationMultiGetBatchSize = 30;
+          kvbc.computeAndPersistPartitionedPublicStateHash(2);
+          const auto state_hash_val = db->get(concord::kvbc::bcutil::BlockChainUtils::partitionedPublicStateHashKey());
+          ASSERT_TRUE(state_hash_val.has_value());
+          auto state_hash = concord::kvbc::categorization::StateHash{};
+          concord::kvbc::categorization::detail::deserialize(*state_hash_val, state_hash);
+          ASSERT_EQ(state_hash.block_id, 2);
+          ASSERT_THAT(state_hash.hash, ContainerEq(expected));
+          // Clientservice computes the same hash, see client/clientservice/test/public_state_hash_test.cpp
+          ASSERT_THAT(
+              state_hash.hash,
+              ContainerEq(concord::kvbc::categorization::Hash{
+                  0x93, 0x64, 0x50, 0x11, 0x2b, 0x74, 0x8d, 0xc5, 0xf2, 0x44, 0xc2, 0x99, 0x89, 0x28, 0x4c, 0xd8,
+                  0x7f, 0x83, 0x55, 0xc2, 0x0b, 0x42, 0x29, 0xa1, 0x6e, 0xb3, 0x8f, 0x34, 0xeb, 0x84, 0x59, 0x8e}));
+        }
+        version_is_set = false;
+        break;
+      case concord::kvbc::BLOCKCHAIN_VERSION::INVALID_BLOCKCHAIN_VERSION:
+        version_is_set = false;
+        break;
+    }
+  }
+}
+
 TEST_F(common_kvbc, iterate_partial_public_state) {
   bool version_is_set = false;
   std::map<std::string, concord::kvbc::categorization::CATEGORY_TYPE> cat_map;
@@ -0,0 +1,108 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+#include "recent_writes_index.hpp"
+
+namespace {
+
+using namespace concord::kvbc;
+
+using Keys = std::vector<std::string>;
+
+TEST(recent_writes_index, latest_version) {
+  auto index = RecentWritesIndex{10};
+  index.sync(5);
+  index.addBlock(6, Keys{"a", "b"});
+  index.addBlock(7, Keys{"b"});
+  ASSERT_EQ(index.latestVersion("a"), 6u);
+  ASSERT_EQ(index.latestVersion("b"), 7u);
+  ASSERT_FALSE(index.latestVersion("c"));
+  ASSERT_EQ(index.firstBlockId(), 6u);
+  ASSERT_EQ(index.lastBlockId(), 7u);
+}
+
+TEST(recent_writes_index, complete_check) {
+  auto index = RecentWritesIndex{10};
+  index.sync(5);
+  index.addBlock(6, Keys{"a"});
+  index.addBlock(7, Keys{"b"});
+
+  // All blocks after 5 are indexed
+  auto check = index.writtenAfter(Keys{"c", "d"}, 5);
+  ASSERT_FALSE(check.conflict);
+  ASSERT_TRUE(check.unresolved.empty());
+
+  check = index.writtenAfter(Keys{"c", "b"}, 6);
+  ASSERT_TRUE(check.conflict);
+
+  check = index.writtenAfter(Keys{"a", "b"}, 7);
+  ASSERT_FALSE(check.conflict);
+  ASSERT_TRUE(check.unresolved.empty());
+}
+
+TEST(recent_writes_index, keys_before_the_window_are_unresolved) {
+  auto index = RecentWritesIndex{10};
+  index.sync(5);
+  index.addBlock(6, Keys{"a"});
+
+  const auto check = index.writtenAfter(Keys{"a", "b", "c"}, 3);
+  ASSERT_TRUE(check.conflict);
+
+  const auto no_conflict = index.writtenAfter(Keys{"b", "c"}, 3);
+  ASSERT_FALSE(no_conflict.conflict);
+  ASSERT_EQ(no_conflict.unresolved, (std::vector<std::size_t>{0, 1}));
+}
+
+TEST(recent_writes_index, old_blocks_are_evicted) {
+  auto index = RecentWritesIndex{2};
+  index.addBlock(1, Keys{"a", "b"});
+  index.addBlock(2, Keys{"b"});
+  index.addBlock(3, Keys{"c"});
+  ASSERT_EQ(index.firstBlockId(), 2u);
+  ASSERT_FALSE(index.latestVersion("a"));
+  // Written again in a block that is still indexed
+  ASSERT_EQ(index.latestVersion("b"), 2u);
+  ASSERT_EQ(index.size(), 2u);
+  ASSERT_FALSE(index.covers(1));
+  ASSERT_TRUE(index.covers(2));
+
+  const auto check = index.writtenAfter(Keys{"a"}, 0);
+  ASSERT_FALSE(check.conflict);
+  ASSERT_EQ(check.unresolved.size(), 1u);
+}
+
+TEST(recent_writes_index, blocks_added_by_others_reset_the_index) {
+  auto index = RecentWritesIndex{10};
+  index.addBlock(1, Keys{"a"});
+  index.addBlock(2, Keys{"b"});
+
+  // E.g. state transfer added blocks 3 to 5
+  index.sync(5);
+  ASSERT_EQ(index.size(), 0u);
+  ASSERT_EQ(index.firstBlockId(), 6u);
+  ASSERT_FALSE(index.covers(5));
+  ASSERT_EQ(index.writtenAfter(Keys{"a"}, 1).unresolved.size(), 1u);
+
+  // A gap in the added blocks
+  index.addBlock(6, Keys{"a"});
+  index.addBlock(8, Keys{"b"});
+  ASSERT_FALSE(index.latestVersion("a"));
+  ASSERT_EQ(index.firstBlockId(), 8u);
+}
+
+}  // namespace
@@ -10,6 +10,7 @@
 // terms and conditions of the subcomponent's license, as noted in the
 // LICENSE file.
 #include <cstdint>
+#include <set>
 #include "crypto/threshsign/IThresholdVerifier.h"
 #include "crypto/threshsign/eddsa/EdDSAMultisigVerifier.h"
 
@@ -92,7 +93,11 @@ bool EdDSAMultisigVerifier::verify(const char *msg, int msgLen, const char *sig,
   LOG_DEBUG(EDDSA_MULTISIG_LOG, KVLOG(this, signersCount_, threshold_, sigLen));
   auto msgLenUnsigned = static_cast<size_t>(msgLen);
   auto sigLenUnsigned = static_cast<unsigned long>(sigLen);
-  ConcordAssert(sigLenUnsigned % sizeof(SingleEdDSASignature) == 0);
+  // The signature may be received from another replica, e.g. in a PreProcessResultMsg, so don't assert on its length
+  if (sigLen < 0 || sigLenUnsigned % sizeof(SingleEdDSASignature) != 0) {
+    LOG_ERROR(EDDSA_MULTISIG_LOG, "Invalid signature length" << KVLOG(sigLen, sizeof(SingleEdDSASignature)));
+    return false;
+  }
   const auto signatureCountInBuffer = sigLenUnsigned / sizeof(SingleEdDSASignature);
 
   if (signatureCountInBuffer < threshold_) {
@@ -101,6 +106,7 @@ bool EdDSAMultisigVerifier::verify(const char *msg, int msgLen, const char *sig,
 
   const SingleEdDSASignature *allSignatures = reinterpret_cast<const SingleEdDSASignature *>(sig);
   size_t validSignatureCount = 0;
+  std::set<uint32_t> validSigners;
 
   for (int i = 0; i < static_cast<int>(signatureCountInBuffer); i++) {
     auto &currentSignature = allSignatures[i];
@@ -111,7 +117,10 @@ bool EdDSAMultisigVerifier::verify(const char *msg, int msgLen, const char *sig,
     auto result = verifySingleSignature(reinterpret_cast<const uint8_t *>(msg), msgLenUnsigned, currentSignature);
     LOG_DEBUG(EDDSA_MULTISIG_LOG, "Verified id: " << KVLOG(currentSignature.id, result));
 
-    validSignatureCount += result == true;
+    // Count every signer once, a duplicated signature must not help in reaching the threshold
+    if (result && validSigners.insert(currentSignature.id).second) {
+      validSignatureCount++;
+    }
   }
 
   bool result = validSignatureCount >= threshold_;
@@ -169,6 +169,25 @@ TEST_F(EdDSAMultisigTest, TestInvalidMultiSignature) {
   ASSERT_FALSE(verifier->verify(digest.data(), static_cast<int>(digest.size()), multisigBuffer.get(), multisigBytes));
 }
 
+TEST_F(EdDSAMultisigTest, TestDuplicateSignaturesAndBadLength) {
+  constexpr const uint64_t n_signers = 4;
+  auto [signers, verifier] = factory_.newRandomSigners(2, n_signers);
+  const auto digest = testMsgDigest();
+
+  SingleEdDSASignature signature;
+  signers[1]->signData(
+      digest.data(), static_cast<int>(digest.size()), reinterpret_cast<char*>(&signature), sizeof(signature));
+  // The same signer twice doesn't reach a threshold of 2
+  std::vector<SingleEdDSASignature> duplicates{signature, signature};
+  const auto duplicatesLen = static_cast<int>(duplicates.size() * sizeof(SingleEdDSASignature));
+  ASSERT_FALSE(verifier->verify(
+      digest.data(), static_cast<int>(digest.size()), reinterpret_cast<char*>(duplicates.data()), duplicatesLen));
+
+  // A truncated signature is rejected
+  ASSERT_FALSE(verifier->verify(
+      digest.data(), static_cast<int>(digest.size()), reinterpret_cast<char*>(duplicates.data()), duplicatesLen - 1));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -112,6 +112,7 @@ class Logger {
   Logger(LoggerImpl& logger) : logger_{&logger} {}
   std::ostream& print(logging::LogLevel l, const char* func) const { return logger_->print(l, func); }
   LogLevel getLogLevel() const { return logger_->level_; }
+  const std::string& getName() const { return logger_->name_; }
   void setLogLevel(LogLevel l) { logger_->level_ = l; }
   static ThreadContext& getThreadContext() { return LoggerImpl::getThreadContext(); }
   static bool config(const std::string& configFileName);
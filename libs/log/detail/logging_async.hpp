@@ -0,0 +1,237 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the
+// LICENSE file.
+
+#pragma once
+
+#include <sys/time.h>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Loggers, levels, MDC and configuration are the ones of the default backend. Only the way messages are written
+// differs.
+#include "logging.hpp"
+
+namespace logging::async {
+
+/**
+ * Asynchronous logging backend
+ *
+ * A log call doesn't format its message. Instead, it encodes the streamed values into a fixed-size binary record:
+ * - arithmetic values and pointers are copied as is and formatted later
+ * - strings are copied
+ * - stream manipulators (e.g. std::hex) are kept as function pointers and applied later
+ * - values of any other type are formatted on the calling thread, since they may not outlive the call
+ * - manipulators with an argument (e.g. std::setw) apply to the values that follow, hence these are formatted on the
+ *   calling thread as well
+ * The record is pushed into a ring buffer of the calling thread. A background thread drains the rings of all threads,
+ * formats the records in timestamp order and writes them to the standard output in batches.
+ *
+ * A message that doesn't fit the record is formatted on the calling thread from the point it overflows.
+ * If the ring of a thread is full, TRACE and DEBUG messages are dropped (and the number of dropped messages is
+ * reported), while INFO and above wait for the writer. FATAL messages are written before the log call returns.
+ */
+struct Record {
+  static constexpr size_t kPayloadSize = 960;
+
+  Record() = default;
+  Record(const Record&) = delete;
+  Record& operator=(const Record&) = delete;
+  Record& operator=(Record&& other) {
+    time = other.time;
+    level = other.level;
+    seq = other.seq;
+    logger = other.logger;
+    file = other.file;
+    line = other.line;
+    size = other.size;
+    overflow = std::move(other.overflow);
+    std::memcpy(payload, other.payload, size);
+    return *this;
+  }
+
+  timeval time;
+  LogLevel level;
+  uint64_t seq;
+  // Loggers live as long as the process
+  const std::string* logger;
+  const char* file;
+  int line;
+  uint16_t size = 0;
+  // The part of the message that didn't fit the payload
+  std::unique_ptr<std::string> overflow;
+  char payload[kPayloadSize];
+};
+
+// The types of the values in the payload of a record. Every value is prefixed by its type.
+enum class Arg : uint8_t {
+  Bool,
+  Char,
+  SignedChar,
+  UnsignedChar,
+  Short,
+  UnsignedShort,
+  Int,
+  UnsignedInt,
+  Long,
+  UnsignedLong,
+  LongLong,
+  UnsignedLongLong,
+  Float,
+  Double,
+  LongDouble,
+  Pointer,
+  // uint16_t length followed by the characters
+  String,
+  OstreamManipulator,
+  IosManipulator,
+};
+
+template <typename T>
+constexpr Arg argOf() {
+  if constexpr (std::is_same_v<T, bool>) return Arg::Bool;
+  if constexpr (std::is_same_v<T, char>) return Arg::Char;
+  if constexpr (std::is_same_v<T, signed char>) return Arg::SignedChar;
+  if constexpr (std::is_same_v<T, unsigned char>) return Arg::UnsignedChar;
+  if constexpr (std::is_same_v<T, short>) return Arg::Short;
+  if constexpr (std::is_same_v<T, unsigned short>) return Arg::UnsignedShort;
+  if constexpr (std::is_same_v<T, int>) return Arg::Int;
+  if constexpr (std::is_same_v<T, unsigned int>) return Arg::UnsignedInt;
+  if constexpr (std::is_same_v<T, long>) return Arg::Long;
+  if constexpr (std::is_same_v<T, unsigned long>) return Arg::UnsignedLong;
+  if constexpr (std::is_same_v<T, long long>) return Arg::LongLong;
+  if constexpr (std::is_same_v<T, unsigned long long>) return Arg::UnsignedLongLong;
+  if constexpr (std::is_same_v<T, float>) return Arg::Float;
+  if constexpr (std::is_same_v<T, double>) return Arg::Double;
+  if constexpr (std::is_same_v<T, long double>) return Arg::LongDouble;
+  return Arg::Pointer;
+}
+
+template <typename T>
+constexpr bool isEncodable() {
+  return std::is_same_v<T, bool> || std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+         std::is_same_v<T, unsigned char> || std::is_same_v<T, short> || std::is_same_v<T, unsigned short> ||
+         std::is_same_v<T, int> || std::is_same_v<T, unsigned int> || std::is_same_v<T, long> ||
+         std::is_same_v<T, unsigned long> || std::is_same_v<T, long long> || std::is_same_v<T, unsigned long long> ||
+         std::is_floating_point_v<T>;
+}
+
+template <typename T>
+constexpr bool isCharPointer() {
+  return std::is_same_v<T, const signed char*> || std::is_same_v<T, signed char*> ||
+         std::is_same_v<T, const unsigned char*> || std::is_same_v<T, unsigned char*>;
+}
+
+template <typename T>
+constexpr bool isIomanip() {
+  return std::is_same_v<T, decltype(std::setw(0))> || std::is_same_v<T, decltype(std::setprecision(0))> ||
+         std::is_same_v<T, decltype(std::setbase(0))> || std::is_same_v<T, decltype(std::setfill('0'))> ||
+         std::is_same_v<T, decltype(std::setiosflags(std::ios_base::fmtflags{}))> ||
+         std::is_same_v<T, decltype(std::resetiosflags(std::ios_base::fmtflags{}))>;
+}
+
+// Hand a record over to the writer
+void push(Record&& record);
+
+// Write all the records pushed so far
+void flush();
+
+/**
+ * Encodes a single log message into a record, which is pushed when the stream is destroyed
+ */
+class RecordStream {
+ public:
+  RecordStream(const Logger& logger, LogLevel level, const char* file, int line);
+  ~RecordStream();
+  RecordStream(const RecordStream&) = delete;
+  RecordStream& operator=(const RecordStream&) = delete;
+
+  template <typename T>
+  RecordStream& operator<<(const T& value) {
+    if constexpr (isEncodable<T>()) {
+      if (!tail_ && fits(sizeof(T))) {
+        append(argOf<T>(), &value, sizeof(T));
+        return *this;
+      }
+      tail() << value;
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+      appendString(std::string_view(value));
+    } else if constexpr (isCharPointer<T>()) {
+      // A null-terminated string, as std::ostream prints it
+      appendString(reinterpret_cast<const char*>(value));
+    } else if constexpr (isIomanip<T>()) {
+      tail() << value;
+    } else if constexpr (std::is_pointer_v<T>) {
+      const void* ptr = value;
+      if (!tail_ && fits(sizeof(ptr))) {
+        append(Arg::Pointer, &ptr, sizeof(ptr));
+        return *this;
+      }
+      tail() << ptr;
+    } else if (tail_) {
+      *tail_ << value;
+    } else {
+      std::ostringstream oss;
+      oss << value;
+      appendString(oss.str());
+    }
+    return *this;
+  }
+
+  RecordStream& operator<<(std::ostream& (*manip)(std::ostream&)) {
+    if (!tail_ && fits(sizeof(manip))) {
+      append(Arg::OstreamManipulator, &manip, sizeof(manip));
+    } else {
+      tail() << manip;
+    }
+    return *this;
+  }
+
+  RecordStream& operator<<(std::ios_base& (*manip)(std::ios_base&)) {
+    if (!tail_ && fits(sizeof(manip))) {
+      append(Arg::IosManipulator, &manip, sizeof(manip));
+    } else {
+      tail() << manip;
+    }
+    return *this;
+  }
+
+ private:
+  bool fits(size_t size) const { return record_.size + 1 + size <= Record::kPayloadSize; }
+  void append(Arg arg, const void* data, size_t size) {
+    record_.payload[record_.size] = static_cast<char>(arg);
+    std::memcpy(record_.payload + record_.size + 1, data, size);
+    record_.size += 1 + size;
+  }
+  void appendString(std::string_view str);
+  // The stream that formats the rest of the message on the calling thread. The manipulators encoded so far are applied
+  // to it when it's created.
+  std::ostringstream& tail();
+
+  Record record_;
+  std::unique_ptr<std::ostringstream> tail_;
+};
+
+}  // namespace logging::async
+
+#undef LOG_COMMON
+#define LOG_COMMON(logger, level, s)                                           \
+  do {                                                                         \
+    if ((logger).getLogLevel() <= level) {                                     \
+      (logging::async::RecordStream((logger), level, __FILE__, __LINE__)) << s; \
+    }                                                                          \
+  } while (0)
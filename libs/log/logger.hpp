@@ -23,7 +23,9 @@
 
 uint64_t getSeq();
 
-#ifdef USE_LOG4CPP
+#if defined(USE_ASYNC_LOG)
+#include "detail/logging_async.hpp"
+#elif defined(USE_LOG4CPP)
 #include "detail/logging4cplus.hpp"
 #else
 #include "detail/logging.hpp"
@@ -0,0 +1,404 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to
+// the terms and conditions of the subcomponent's license,
+// as noted in the LICENSE file.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "logger.hpp"
+
+namespace logging::async {
+
+// MDC values are copied into the payload, and longer ones are truncated
+static constexpr size_t kMaxMdcValueSize = 64;
+static constexpr size_t kRingCapacity = 256;
+static constexpr auto kIdleSleep = std::chrono::milliseconds{1};
+
+template <typename T>
+static T read(const char*& p) {
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return value;
+}
+
+static std::string_view readString(const char*& p) {
+  const auto size = read<uint16_t>(p);
+  std::string_view str(p, size);
+  p += size;
+  return str;
+}
+
+template <typename T>
+static void streamValue(const char*& p, std::ostream& os, bool withValues) {
+  const auto value = read<T>(p);
+  if (withValues) {
+    os << value;
+  }
+}
+
+// Write the values in [p, end) of a payload into a stream. Manipulators are always applied, while the other values are
+// skipped if withValues is false.
+static void streamPayload(const char* p, const char* end, std::ostream& os, bool withValues) {
+  while (p < end) {
+    const auto arg = static_cast<Arg>(*p++);
+    switch (arg) {
+      case Arg::Bool:
+        streamValue<bool>(p, os, withValues);
+        break;
+      case Arg::Char:
+        streamValue<char>(p, os, withValues);
+        break;
+      case Arg::SignedChar:
+        streamValue<signed char>(p, os, withValues);
+        break;
+      case Arg::UnsignedChar:
+        streamValue<unsigned char>(p, os, withValues);
+        break;
+      case Arg::Short:
+        streamValue<short>(p, os, withValues);
+        break;
+      case Arg::UnsignedShort:
+        streamValue<unsigned short>(p, os, withValues);
+        break;
+      case Arg::Int:
+        streamValue<int>(p, os, withValues);
+        break;
+      case Arg::UnsignedInt:
+        streamValue<unsigned int>(p, os, withValues);
+        break;
+      case Arg::Long:
+        streamValue<long>(p, os, withValues);
+        break;
+      case Arg::UnsignedLong:
+        streamValue<unsigned long>(p, os, withValues);
+        break;
+      case Arg::LongLong:
+        streamValue<long long>(p, os, withValues);
+        break;
+      case Arg::UnsignedLongLong:
+        streamValue<unsigned long long>(p, os, withValues);
+        break;
+      case Arg::Float:
+        streamValue<float>(p, os, withValues);
+        break;
+      case Arg::Double:
+        streamValue<double>(p, os, withValues);
+        break;
+      case Arg::LongDouble:
+        streamValue<long double>(p, os, withValues);
+        break;
+      case Arg::Pointer:
+        streamValue<const void*>(p, os, withValues);
+        break;
+      case Arg::String: {
+        const auto str = readString(p);
+        if (withValues) {
+          os << str;
+        }
+        break;
+      }
+      case Arg::OstreamManipulator:
+        os << read<std::ostream& (*)(std::ostream&)>(p);
+        break;
+      case Arg::IosManipulator:
+        os << read<std::ios_base& (*)(std::ios_base&)>(p);
+        break;
+    }
+  }
+}
+
+/**
+ * Single producer (the owning thread), single consumer (the writer) ring of records
+ */
+class RecordRing {
+ public:
+  bool tryPush(Record&& record) {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == kRingCapacity) {
+      return false;
+    }
+    records_[head % kRingCapacity] = std::move(record);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // The records in [tail, head) can be read by the consumer
+  size_t head() const { return head_.load(std::memory_order_acquire); }
+  size_t tail() const { return tail_.load(std::memory_order_relaxed); }
+  Record& at(size_t pos) { return records_[pos % kRingCapacity]; }
+  void release(size_t tail) {
+    for (auto pos = tail_.load(std::memory_order_relaxed); pos < tail; ++pos) {
+      at(pos).overflow.reset();
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  std::atomic_uint64_t dropped{0};
+
+ private:
+  std::array<Record, kRingCapacity> records_;
+  std::atomic_size_t head_{0};
+  std::atomic_size_t tail_{0};
+};
+
+class Writer {
+ public:
+  // Never destroyed, such that logging from static destructors is safe
+  static Writer& instance() {
+    static Writer* writer = new Writer();
+    return *writer;
+  }
+
+  void push(Record&& record) {
+    if (stopped_) {
+      std::lock_guard<std::mutex> lock(drain_mutex_);
+      std::string out;
+      format(record, out);
+      std::cout << out << std::flush;
+      return;
+    }
+    auto& ring = threadRing();
+    const auto level = record.level;
+    while (!ring.tryPush(std::move(record))) {
+      if (level < INFO_LOG_LEVEL) {
+        ring.dropped++;
+        return;
+      }
+      if (stopped_) {
+        push(std::move(record));
+        return;
+      }
+      std::this_thread::yield();
+    }
+    if (level >= FATAL_LOG_LEVEL) {
+      flush();
+    }
+  }
+
+  void flush() {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    drain();
+  }
+
+ private:
+  Writer() {
+    thread_ = std::thread([this]() { run(); });
+    std::atexit([]() { instance().stop(); });
+  }
+
+  RecordRing& threadRing() {
+    thread_local std::shared_ptr<RecordRing> ring = [this]() {
+      auto r = std::make_shared<RecordRing>();
+      std::lock_guard<std::mutex> lock(rings_mutex_);
+      rings_.push_back(r);
+      return r;
+    }();
+    return *ring;
+  }
+
+  void run() {
+    while (!stopped_) {
+      size_t written = 0;
+      {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        written = drain();
+      }
+      if (written == 0) {
+        std::this_thread::sleep_for(kIdleSleep);
+      }
+    }
+  }
+
+  void stop() {
+    stopped_ = true;
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    flush();
+  }
+
+  // Write the records of all threads in timestamp order. Should be called with drain_mutex_ held.
+  size_t drain() {
+    std::vector<std::shared_ptr<RecordRing>> rings;
+    {
+      std::lock_guard<std::mutex> lock(rings_mutex_);
+      // The rings of threads that exited are removed once they are empty
+      rings_.erase(std::remove_if(rings_.begin(),
+                                  rings_.end(),
+                                  [](const auto& r) { return r.use_count() == 1 && r->head() == r->tail(); }),
+                   rings_.end());
+      rings = rings_;
+    }
+
+    std::vector<std::pair<RecordRing*, size_t>> heads;
+    batch_.clear();
+    for (auto& ring : rings) {
+      const auto head = ring->head();
+      for (auto pos = ring->tail(); pos < head; ++pos) {
+        batch_.push_back(&ring->at(pos));
+      }
+      heads.emplace_back(ring.get(), head);
+    }
+    std::stable_sort(batch_.begin(), batch_.end(), [](const Record* a, const Record* b) {
+      return std::tie(a->time.tv_sec, a->time.tv_usec) < std::tie(b->time.tv_sec, b->time.tv_usec);
+    });
+
+    out_.clear();
+    for (const auto* record : batch_) {
+      format(*record, out_);
+    }
+    for (auto& [ring, head] : heads) {
+      ring->release(head);
+      if (const auto dropped = ring->dropped.exchange(0); dropped > 0) {
+        reportDropped(dropped, out_);
+      }
+    }
+    if (!out_.empty()) {
+      std::cout << out_ << std::flush;
+    }
+    return batch_.size();
+  }
+
+  // The layout of the log4cplus backend:
+  // %D{%Y-%m-%dT%H:%M:%S,%q,%z}|%-5p|%X{rid}|%c|%X{thread}|%X{cid}|%X{sn}|%b:%L|%m | [SQ:<seq>]
+  void format(const Record& record, std::string& out) {
+    const char* p = record.payload;
+    const char* end = record.payload + record.size;
+    // The payload starts with the MDC values (see RecordStream's constructor)
+    auto readMdc = [&p]() {
+      ++p;
+      return readString(p);
+    };
+    const auto rid = readMdc();
+    const auto thread = readMdc();
+    const auto cid = readMdc();
+    const auto sn = readMdc();
+
+    const char* file = std::strrchr(record.file, '/');
+    file = file ? file + 1 : record.file;
+
+    appendTime(record.time, out);
+    out.append("|").append(LoggerImpl::LEVELS_STRINGS[record.level / LOG4CPLUS_LEVEL_COEFF]);
+    out.append("|").append(rid);
+    out.append("|").append(*record.logger);
+    out.append("|").append(thread);
+    out.append("|").append(cid);
+    out.append("|").append(sn);
+    out.append("|").append(file).append(":").append(std::to_string(record.line)).append("|");
+
+    // Values are formatted with a fresh stream, such that manipulators apply to a single message only
+    msg_.str("");
+    msg_.copyfmt(defaultFormat_);
+    streamPayload(p, end, msg_, true);
+    if (record.overflow) {
+      msg_ << *record.overflow;
+    }
+    out.append(msg_.str());
+    out.append(" | [SQ:").append(std::to_string(record.seq)).append("]\n");
+  }
+
+  void reportDropped(uint64_t dropped, std::string& out) {
+    timeval now;
+    gettimeofday(&now, nullptr);
+    appendTime(now, out);
+    out.append("|").append(LoggerImpl::LEVELS_STRINGS[WARN_LOG_LEVEL / LOG4CPLUS_LEVEL_COEFF]);
+    out.append("||concord.log|||||dropped ").append(std::to_string(dropped)).append(" log messages\n");
+  }
+
+  // Formatting the date is relatively expensive, hence it is done once per second
+  void appendTime(const timeval& time, std::string& out) {
+    if (time.tv_sec != lastSecond_) {
+      std::tm tm;
+      localtime_r(&time.tv_sec, &tm);
+      char buf[64];
+      std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+      secondPrefix_ = buf;
+      std::strftime(buf, sizeof(buf), "%z", &tm);
+      zoneSuffix_ = buf;
+      lastSecond_ = time.tv_sec;
+    }
+    char millis[8];
+    std::snprintf(millis, sizeof(millis), ",%03d,", static_cast<int>(time.tv_usec / 1000));
+    out.append(secondPrefix_).append(millis).append(zoneSuffix_);
+  }
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<RecordRing>> rings_;
+  // The rings have a single consumer, i.e. either the writer thread or a thread that flushes
+  std::mutex drain_mutex_;
+  std::atomic_bool stopped_{false};
+  std::thread thread_;
+
+  // Used by the consumer only
+  std::vector<Record*> batch_;
+  std::string out_;
+  std::ostringstream msg_;
+  const std::ostringstream defaultFormat_;
+  time_t lastSecond_ = -1;
+  std::string secondPrefix_;
+  std::string zoneSuffix_;
+};
+
+void push(Record&& record) { Writer::instance().push(std::move(record)); }
+
+void flush() { Writer::instance().flush(); }
+
+RecordStream::RecordStream(const Logger& logger, LogLevel level, const char* file, int line) {
+  gettimeofday(&record_.time, nullptr);
+  record_.level = level;
+  record_.seq = getSeq();
+  record_.logger = &logger.getName();
+  record_.file = file;
+  record_.line = line;
+  auto& mdc = Logger::getThreadContext().getMDC();
+  for (const auto* key : {MDC_REPLICA_ID_KEY, MDC_THREAD_KEY, MDC_CID_KEY, MDC_SEQ_NUM_KEY}) {
+    appendString(std::string_view(mdc.get(key)).substr(0, kMaxMdcValueSize));
+  }
+}
+
+RecordStream::~RecordStream() {
+  if (tail_) {
+    record_.overflow = std::make_unique<std::string>(tail_->str());
+  }
+  push(std::move(record_));
+}
+
+void RecordStream::appendString(std::string_view str) {
+  if (!tail_ && fits(sizeof(uint16_t) + str.size())) {
+    const auto size = static_cast<uint16_t>(str.size());
+    record_.payload[record_.size] = static_cast<char>(Arg::String);
+    std::memcpy(record_.payload + record_.size + 1, &size, sizeof(size));
+    std::memcpy(record_.payload + record_.size + 1 + sizeof(size), str.data(), size);
+    record_.size += 1 + sizeof(size) + size;
+    return;
+  }
+  tail() << str;
+}
+
+std::ostringstream& RecordStream::tail() {
+  if (!tail_) {
+    tail_ = std::make_unique<std::ostringstream>();
+    streamPayload(record_.payload, record_.payload + record_.size, *tail_, false);
+  }
+  return *tail_;
+}
+
+}  // namespace logging::async
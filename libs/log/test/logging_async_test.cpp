@@ -0,0 +1,206 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "log/logger.hpp"
+
+// Tests of the asynchronous logging backend (built with -DUSE_ASYNC_LOG=ON). The writer thread writes to std::cout,
+// which is redirected to a string for the duration of each test.
+
+namespace {
+
+class AsyncLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    logger_.setLogLevel(logging::TRACE_LOG_LEVEL);
+    logging::async::flush();
+    coutBuf_ = std::cout.rdbuf(out_.rdbuf());
+  }
+
+  void TearDown() override {
+    logging::async::flush();
+    std::cout.rdbuf(coutBuf_);
+  }
+
+  // All the lines written so far
+  std::vector<std::string> lines() {
+    logging::async::flush();
+    return unflushedLines();
+  }
+
+  // The lines written so far, without waiting for the writer
+  std::vector<std::string> unflushedLines() const {
+    std::vector<std::string> result;
+    std::istringstream in(out_.str());
+    for (std::string line; std::getline(in, line);) {
+      result.push_back(line);
+    }
+    return result;
+  }
+
+  // The messages of the lines logged by this file
+  std::vector<std::string> messages() {
+    static const std::regex kMessage{R"(\|logging_async_test\.cpp:\d+\|(.*) \| \[SQ:\d+\]$)"};
+    std::vector<std::string> result;
+    for (const auto& line : lines()) {
+      std::smatch match;
+      if (std::regex_search(line, match, kMessage)) {
+        result.push_back(match[1]);
+      }
+    }
+    return result;
+  }
+
+  logging::Logger logger_ = logging::getLogger("concord.log.test");
+
+ private:
+  std::ostringstream out_;
+  std::streambuf* coutBuf_ = nullptr;
+};
+
+TEST_F(AsyncLogTest, layout) {
+  LOG_INFO(logger_, "values: " << 42 << ' ' << -7L << ' ' << 1.5 << ' ' << true << ' ' << std::string("str"));
+  const auto all = lines();
+  ASSERT_EQ(all.size(), 1u);
+  // %D{%Y-%m-%dT%H:%M:%S,%q,%z}|%-5p|%X{rid}|%c|%X{thread}|%X{cid}|%X{sn}|%b:%L|%m | [SQ:<seq>]
+  const std::regex layout{
+      R"(^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2},\d{3},[+-]\d{4}\|INFO \|\|concord\.log\.test\|\|\|\|)"
+      R"(logging_async_test\.cpp:\d+\|values: 42 -7 1\.5 1 str \| \[SQ:\d+\]$)"};
+  EXPECT_TRUE(std::regex_match(all[0], layout)) << all[0];
+}
+
+TEST_F(AsyncLogTest, levels) {
+  logger_.setLogLevel(logging::WARN_LOG_LEVEL);
+  LOG_DEBUG(logger_, "debug");
+  LOG_INFO(logger_, "info");
+  LOG_WARN(logger_, "warn");
+  LOG_ERROR(logger_, "error");
+  const auto all = lines();
+  ASSERT_EQ(all.size(), 2u);
+  EXPECT_NE(all[0].find("|WARN |"), std::string::npos) << all[0];
+  EXPECT_NE(all[1].find("|ERROR|"), std::string::npos) << all[1];
+}
+
+TEST_F(AsyncLogTest, mdc) {
+  {
+    SCOPED_MDC(MDC_REPLICA_ID_KEY, "3");
+    SCOPED_MDC_CID("cid-7");
+    SCOPED_MDC_SEQ_NUM("12");
+    MDC_PUT(MDC_THREAD_KEY, "worker");
+    LOG_INFO(logger_, "with mdc");
+    // MDC values are captured when the message is logged
+    MDC_PUT(MDC_THREAD_KEY, "other");
+  }
+  MDC_REMOVE(MDC_THREAD_KEY);
+  LOG_INFO(logger_, "without mdc");
+  // Long MDC values are truncated
+  {
+    SCOPED_MDC_CID(std::string(100, 'c'));
+    LOG_INFO(logger_, "long mdc");
+  }
+
+  const auto all = lines();
+  ASSERT_EQ(all.size(), 3u);
+  EXPECT_NE(all[0].find("|INFO |3|concord.log.test|worker|cid-7|12|"), std::string::npos) << all[0];
+  EXPECT_NE(all[1].find("|INFO ||concord.log.test||||"), std::string::npos) << all[1];
+  EXPECT_NE(all[2].find("|concord.log.test||" + std::string(64, 'c') + "||"), std::string::npos) << all[2];
+}
+
+TEST_F(AsyncLogTest, manipulators) {
+  LOG_INFO(logger_, std::hex << 255 << ' ' << std::dec << 255 << ' ' << std::boolalpha << true);
+  // Manipulators apply to a single message
+  LOG_INFO(logger_, 255 << ' ' << true);
+  LOG_INFO(logger_, std::setw(4) << std::setfill('0') << 7 << ' ' << std::fixed << std::setprecision(2) << 1.0);
+  LOG_INFO(logger_, std::showbase << std::hex << 255 << ' ' << std::setw(6) << 255);
+  EXPECT_EQ(messages(), (std::vector<std::string>{"ff 255 true", "255 1", "0007 1.00", "0xff   0xff"}));
+}
+
+TEST_F(AsyncLogTest, strings_and_pointers) {
+  const char* cstr = "cstr";
+  char array[] = "array";
+  const auto* bytes = reinterpret_cast<const unsigned char*>("unsigned");
+  const auto* signedBytes = reinterpret_cast<const signed char*>("signed");
+  const std::string_view view{"view of a string", 4};
+  LOG_INFO(logger_, cstr << ' ' << array << ' ' << bytes << ' ' << signedBytes << ' ' << view);
+  LOG_INFO(logger_, static_cast<const void*>(bytes));
+  const auto all = messages();
+  ASSERT_EQ(all.size(), 2u);
+  EXPECT_EQ(all[0], "cstr array unsigned signed view");
+  std::ostringstream address;
+  address << static_cast<const void*>(bytes);
+  EXPECT_EQ(all[1], address.str());
+}
+
+// A message that doesn't fit a record is formatted on the calling thread from the point it overflows, with the
+// manipulators that were applied before that point
+TEST_F(AsyncLogTest, overflow) {
+  const std::string longString(2000, 'x');
+  LOG_INFO(logger_, "begin " << 1 << ' ' << longString << ' ' << 2 << " end");
+  LOG_INFO(logger_, std::hex << 255 << ' ' << longString << ' ' << 255);
+  // Overflows in the middle of the numbers
+  const std::string almostFull(930, 'y');
+  LOG_INFO(logger_, almostFull << 1 << 2 << 3 << 4 << 5 << 6);
+  EXPECT_EQ(messages(),
+            (std::vector<std::string>{
+                "begin 1 " + longString + " 2 end", "ff " + longString + " ff", almostFull + "123456"}));
+}
+
+// TRACE and DEBUG messages are dropped when the ring of a thread is full, and the number of dropped messages is logged.
+// INFO messages are never dropped.
+TEST_F(AsyncLogTest, drop_when_full) {
+  constexpr int kNumMessages = 10000;
+  for (int i = 0; i < kNumMessages; ++i) {
+    LOG_DEBUG(logger_, "debug " << i);
+  }
+  for (int i = 0; i < kNumMessages; ++i) {
+    LOG_INFO(logger_, "info " << i);
+  }
+
+  static const std::regex kDropped{R"(\|WARN \|.*dropped (\d+) log messages$)"};
+  int numDebug = 0;
+  int numInfo = 0;
+  int numDropped = 0;
+  for (const auto& line : lines()) {
+    std::smatch match;
+    if (std::regex_search(line, match, kDropped)) {
+      numDropped += std::stoi(match[1]);
+    } else if (line.find("|debug ") != std::string::npos) {
+      ++numDebug;
+    } else if (line.find("|info " + std::to_string(numInfo) + " |") != std::string::npos) {
+      // INFO messages are written in order
+      ++numInfo;
+    }
+  }
+  EXPECT_EQ(numDebug + numDropped, kNumMessages);
+  EXPECT_EQ(numInfo, kNumMessages);
+}
+
+// FATAL messages are written before the log call returns
+TEST_F(AsyncLogTest, fatal_is_flushed) {
+  LOG_INFO(logger_, "before");
+  LOG_FATAL(logger_, "fatal");
+  const auto all = unflushedLines();
+  ASSERT_EQ(all.size(), 2u);
+  EXPECT_NE(all[0].find("|before |"), std::string::npos) << all[0];
+  EXPECT_NE(all[1].find("|FATAL|"), std::string::npos) << all[1];
+  EXPECT_NE(all[1].find("|fatal |"), std::string::npos) << all[1];
+}
+
+}  // namespace
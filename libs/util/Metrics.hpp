@@ -18,6 +18,7 @@
 #include <map>
 #include <vector>
 #include <mutex>
+#include <shared_mutex>
 #include <memory>
 #include <list>
 #include <variant>
@@ -53,6 +54,12 @@ typedef struct metric_ Metric;
 // all their metric values. Therefore, the state of all metrics is eventually
 // consistent.
 //
+// Every component is a shard that is only written by its own thread. An update
+// publishes an immutable snapshot of the component's values with an atomic
+// pointer swap, and the snapshots are merged only when the aggregator is read.
+// Hence, updates never take the aggregator's lock, and readers (e.g. the
+// Prometheus collector and the metrics server) never block the components.
+//
 // The Aggregator is the type responsible for reporting metrics for the entire
 // system. A process should have a single aggregator, and any service
 // responsible for reporting system metrics should read it from the aggregator.
@@ -71,12 +78,15 @@ class Aggregator {
   std::string ToJson();
 
  private:
+  struct ComponentSnapshot;
+
   const bool metricsEnabled_ = true;
-  void RegisterComponent(Component& component);
-  void UpdateValues(const std::string& name, Values&& values);
+  // Returns the snapshot the component should publish its values to
+  std::shared_ptr<ComponentSnapshot> RegisterComponent(const Component& component);
 
-  std::map<std::string, Component> components_;
-  std::mutex lock_;
+  std::map<std::string, std::shared_ptr<ComponentSnapshot>> components_;
+  // Guards components_ only. Registration takes it exclusively and readers take it shared.
+  std::shared_mutex lock_;
 
   friend class Component;
 };
@@ -101,6 +111,7 @@ class BasicGauge {
   BasicGauge operator--(int) { return BasicGauge(val_--); }
   void Set(const uint64_t val) { val_ = val; }
   T& Get() { return val_; }
+  const T& Get() const { return val_; }
 
  private:
   T val_;
@@ -126,6 +137,7 @@ class BasicCounter {
   }
 
   T& Get() { return val_; }
+  const T& Get() const { return val_; }
 
  private:
   T val_;
@@ -144,6 +156,7 @@ class BasicStatus {
 
   void Set(const T& val) { val_ = val; }
   T& Get() { return val_; }
+  const T& Get() const { return val_; }
 
  private:
   T val_;
@@ -209,6 +222,26 @@ class Tags {
   friend class Aggregator;
 };
 
+/******************************** Struct ComponentSnapshot ********************************/
+
+// The state of a component as seen by the aggregator. The names and tags are
+// fixed on registration, while the values are replaced as a whole every time
+// the component updates the aggregator.
+struct Aggregator::ComponentSnapshot {
+  ComponentSnapshot(const std::string& name, const Names& names, const Tags& tags, const Values& values)
+      : name(name), names(names), tags(tags), values_(std::make_shared<const Values>(values)) {}
+
+  std::shared_ptr<const Values> Load() const { return std::atomic_load(&values_); }
+  void Store(std::shared_ptr<const Values> values) { std::atomic_store(&values_, std::move(values)); }
+
+  const std::string name;
+  const Names names;
+  const Tags tags;
+
+ private:
+  std::shared_ptr<const Values> values_;
+};
+
 /******************************** Class Component ********************************/
 
 // A Component stores Values of different types and is updated on the local
@@ -277,11 +310,12 @@ class Component {
   // updated at runtime for performance reasons.
   void Register() {
     if (auto aggregator = aggregator_.lock()) {
-      aggregator->RegisterComponent(*this);
+      snapshot_ = aggregator->RegisterComponent(*this);
     }
   }
 
-  // Update the values in the aggregator
+  // Publish a snapshot of the values to the aggregator. Doesn't block on
+  // concurrent readers of the aggregator.
   void UpdateAggregator();
 
   // Change the aggregator used by the component
@@ -298,7 +332,18 @@ class Component {
  private:
   friend class Aggregator;
 
-  void SetValues(Values&& values) { values_ = values; }
+  // Shared by the component and the aggregator, which call them with the
+  // component's values and with the last published snapshot respectively
+  static std::list<Metric> CollectGauges(const std::string& name,
+                                         const Names& names,
+                                         const Tags& tags,
+                                         const Values& values);
+  static std::list<Metric> CollectCounters(const std::string& name,
+                                           const Names& names,
+                                           const Tags& tags,
+                                           const Values& values);
+  static std::list<Metric> CollectStatuses(const std::string& name, const Names& names, const Values& values);
+  static std::string ToJson(const std::string& name, const Names& names, const Values& values);
 
   std::weak_ptr<Aggregator> aggregator_;
   std::string name_;
@@ -307,6 +352,7 @@ class Component {
   Names names_;
   Tags tags_;
   Values values_;
+  std::shared_ptr<Aggregator::ComponentSnapshot> snapshot_;
 };
 
 typedef concordMetrics::Component::Handle<concordMetrics::Gauge> GaugeHandle;
@@ -15,14 +15,21 @@
 #include <functional>
 #include <cstdint>
 #include <chrono>
-#include <vector>
+#include <array>
+#include <list>
 #include <algorithm>
 #include <mutex>
+#include <unordered_map>
 
 #include "log/logger.hpp"
 namespace concordUtil {
 
-// A collection of timers backed by a vector.
+// A collection of timers backed by a hierarchical timing wheel.
+//
+// The wheel has kLevels levels of kSlots slots each. A slot of level 0 spans a single tick (a millisecond) and a slot
+// of level N spans kSlots^N ticks. A timer is kept in the slot of the lowest level that covers its expiry time, and is
+// moved down a level whenever the wheel turns into its slot (cascading). Hence, adding, cancelling and resetting a
+// timer is O(1), and evaluate() only visits the timers that expire, regardless of the number of armed timers.
 class Timers {
  public:
   class Handle {
@@ -84,11 +91,16 @@ class Timers {
     uint64_t id_ = 0;
     std::function<void(Handle)> callback_;
 
+    // The slot the timer is linked in, if any, and its position there
+    std::list<Timer*>* slot_ = nullptr;
+    std::list<Timer*>::iterator pos_;
+    size_t level_ = 0;
+
     friend class Timers;
   };
 
  public:
-  Timers() : id_counter_(0) {}
+  Timers() : id_counter_(0), current_(floorTick(std::chrono::steady_clock::now())) {}
   Timers(const Timers& timers) = delete;
   Timers& operator=(const Timers& timers) = delete;
   Timers(Timers&& timers) = delete;
@@ -103,10 +115,11 @@ class Timers {
              const std::function<void(Handle)>& cb,
              std::chrono::steady_clock::time_point now) {
     std::unique_lock<std::recursive_mutex> mlock(lock_);
-    timers_.emplace_back(Timer(d, t, cb, now));
     id_counter_ += 1;
     Handle h{id_counter_};
-    timers_.back().id_ = h.id_;
+    auto& timer = timers_.emplace(h.id_, Timer(d, t, cb, now)).first->second;
+    timer.id_ = h.id_;
+    link(timer);
     return h;
   }
 
@@ -114,16 +127,23 @@ class Timers {
 
   void reset(const Handle& handle, std::chrono::milliseconds d, std::chrono::steady_clock::time_point now) {
     std::unique_lock<std::recursive_mutex> mlock(lock_);
-    auto it = find(handle);
+    auto it = timers_.find(handle.id_);
     if (it != timers_.end()) {
-      it->reset(now, d);
+      unlink(it->second);
+      it->second.reset(now, d);
+      link(it->second);
     }
   }
 
   void cancel(const Handle& handle) {
     std::unique_lock<std::recursive_mutex> mlock(lock_);
-    auto it = find(handle);
-    if (it != timers_.end()) {
+    auto it = timers_.find(handle.id_);
+    if (it == timers_.end()) return;
+    unlink(it->second);
+    // The running timer is removed once its callback returns
+    if (handle.id_ == running_id_) {
+      running_cancelled_ = true;
+    } else {
       timers_.erase(it);
     }
   }
@@ -133,35 +153,138 @@ class Timers {
 
   void evaluate(std::chrono::steady_clock::time_point now) {
     std::unique_lock<std::recursive_mutex> mlock(lock_);
-    if (timers_.empty()) return;
-
-    // Expired ids must be stored separately since erasing causes iterator invalidation.
-    std::vector<Handle> to_cancel;
-    for (auto& timer : timers_) {
-      if (timer.expired(now)) {
-        timer.run_callback(Handle(timer.id_));
-        if (timer.recurring()) {
-          timer.reset(now);
-        } else {
-          to_cancel.push_back(Handle(timer.id_));
-        }
+    advance(floorTick(now));
+    if (expired_.empty()) return;
+
+    // Timers that expire while the callbacks run (e.g. recurring timers with a zero duration) are run on the next call
+    std::list<Timer*> due;
+    due.splice(due.end(), expired_);
+    for (auto* timer : due) {
+      timer->slot_ = &due;
+    }
+    while (!due.empty()) {
+      auto& timer = *due.front();
+      due.pop_front();
+      timer.slot_ = nullptr;
+      if (!timer.expired(now)) {
+        // Expires later within the current tick
+        link(timer);
+        continue;
+      }
+      running_id_ = timer.id_;
+      running_cancelled_ = false;
+      timer.run_callback(Handle(timer.id_));
+      running_id_ = 0;
+      if (running_cancelled_) {
+        timers_.erase(timer.id_);
+      } else if (timer.recurring()) {
+        unlink(timer);
+        timer.reset(now);
+        link(timer);
+      } else {
+        unlink(timer);
+        timers_.erase(timer.id_);
       }
     }
+  }
+
+ private:
+  static constexpr size_t kLevels = 4;
+  static constexpr uint64_t kSlotBits = 8;
+  static constexpr uint64_t kSlots = 1 << kSlotBits;
+  static constexpr uint64_t kSlotMask = kSlots - 1;
+  // Timers that expire later than that are cascaded again from the last level
+  static constexpr uint64_t kMaxTicks = (uint64_t{1} << (kSlotBits * kLevels)) - 1;
+
+  static uint64_t floorTick(std::chrono::steady_clock::time_point t) {
+    return std::chrono::floor<std::chrono::milliseconds>(t.time_since_epoch()).count();
+  }
 
-    for (auto& handle : to_cancel) {
-      cancel(handle);
+  void link(Timer& timer) {
+    const auto expires = floorTick(timer.expires_at_);
+    if (expires <= current_) {
+      linkTo(timer, expired_, kLevels);
+      return;
+    }
+    const auto ticks = std::min(expires - current_, kMaxTicks);
+    size_t level = 0;
+    while ((ticks >> (kSlotBits * (level + 1))) != 0) {
+      ++level;
     }
+    const auto slot = ((current_ + ticks) >> (kSlotBits * level)) & kSlotMask;
+    linkTo(timer, wheel_[level][slot], level);
+    ++level_size_[level];
   }
 
- private:
-  std::vector<Timer>::iterator find(const Handle& handle) {
-    std::unique_lock<std::recursive_mutex> mlock(lock_);
-    return std::find_if(timers_.begin(), timers_.end(), [&handle](const Timer& t) { return t.id_ == handle.id_; });
+  void linkTo(Timer& timer, std::list<Timer*>& slot, size_t level) {
+    timer.slot_ = &slot;
+    timer.pos_ = slot.insert(slot.end(), &timer);
+    timer.level_ = level;
+  }
+
+  void unlink(Timer& timer) {
+    if (!timer.slot_) return;
+    timer.slot_->erase(timer.pos_);
+    timer.slot_ = nullptr;
+    if (timer.level_ < kLevels) {
+      --level_size_[timer.level_];
+    }
+  }
+
+  // Turn the wheel up to `tick` and move the timers that expired to expired_
+  void advance(uint64_t tick) {
+    while (current_ < tick) {
+      if (level_size_[0] == 0) {
+        // Nothing expires before the next cascade of the lowest level with timers, if any
+        const auto level = std::find_if(level_size_.begin(), level_size_.end(), [](size_t n) { return n > 0; });
+        const auto bits = kSlotBits * (level - level_size_.begin());
+        if (level == level_size_.end() || ((current_ >> bits) + 1) << bits > tick) {
+          current_ = tick;
+          return;
+        }
+        current_ = ((current_ >> bits) + 1) << bits;
+      } else {
+        ++current_;
+      }
+      if ((current_ & kSlotMask) == 0) {
+        cascade();
+      }
+      auto& slot = wheel_[0][current_ & kSlotMask];
+      for (auto* timer : slot) {
+        timer->slot_ = &expired_;
+        timer->level_ = kLevels;
+      }
+      level_size_[0] -= slot.size();
+      expired_.splice(expired_.end(), slot);
+    }
+  }
+
+  // Move the timers of the higher level slots the wheel turned into down to the lower levels
+  void cascade() {
+    for (size_t level = 1; level < kLevels; ++level) {
+      const auto index = (current_ >> (kSlotBits * level)) & kSlotMask;
+      std::list<Timer*> slot;
+      slot.splice(slot.end(), wheel_[level][index]);
+      level_size_[level] -= slot.size();
+      for (auto* timer : slot) {
+        timer->slot_ = nullptr;
+        link(*timer);
+      }
+      if (index != 0) break;
+    }
   }
 
   std::recursive_mutex lock_;
-  std::vector<Timer> timers_;
+  std::unordered_map<uint64_t, Timer> timers_;
+  std::array<std::array<std::list<Timer*>, kSlots>, kLevels> wheel_;
+  std::array<size_t, kLevels> level_size_{};
+  // Timers that expired and whose callbacks weren't run yet
+  std::list<Timer*> expired_;
   uint64_t id_counter_;
+  // All timers that expire up to (and including) this tick are in expired_, even if they expire later within the tick
+  uint64_t current_;
+  uint64_t running_id_ = 0;
+  bool running_cancelled_ = false;
 };
 
 }  // namespace concordUtil
@@ -74,67 +74,88 @@ Component::Handle<AtomicGauge> Component::RegisterAtomicGauge(const std::string&
 
 std::list<Metric> Component::CollectGauges() {
   if (!metricsEnabled_) return list<Metric>();
+  return CollectGauges(name_, names_, tags_, values_);
+}
+
+std::list<Metric> Component::CollectCounters() {
+  if (!metricsEnabled_) return list<Metric>();
+  return CollectCounters(name_, names_, tags_, values_);
+}
+
+std::list<Metric> Component::CollectStatuses() {
+  if (!metricsEnabled_) return list<Metric>();
+  return CollectStatuses(name_, names_, values_);
+}
+
+std::list<Metric> Component::CollectGauges(const string& name,
+                                           const Names& names,
+                                           const Tags& tags,
+                                           const Values& values) {
   std::list<Metric> ret;
-  for (size_t i = 0; i < names_.gauge_names_.size(); i++) {
-    if (tags_.gauge_tags_[i].size()) {
-      ret.emplace_back(Metric{name_, names_.gauge_names_[i], values_.gauges_[i], tags_.gauge_tags_[i]});
+  for (size_t i = 0; i < names.gauge_names_.size(); i++) {
+    if (tags.gauge_tags_[i].size()) {
+      ret.emplace_back(Metric{name, names.gauge_names_[i], values.gauges_[i], tags.gauge_tags_[i]});
     } else {
-      ret.emplace_back(Metric{name_, names_.gauge_names_[i], values_.gauges_[i]});
+      ret.emplace_back(Metric{name, names.gauge_names_[i], values.gauges_[i]});
     }
   }
-  for (std::size_t i = 0; i < names_.atomic_gauge_names_.size(); i++) {
-    ret.emplace_back(Metric{name_, names_.atomic_gauge_names_[i], Gauge(values_.atomic_gauges_[i].Get())});
+  for (std::size_t i = 0; i < names.atomic_gauge_names_.size(); i++) {
+    ret.emplace_back(Metric{name, names.atomic_gauge_names_[i], Gauge(values.atomic_gauges_[i].Get())});
   }
   return ret;
 }
 
-std::list<Metric> Component::CollectCounters() {
-  if (!metricsEnabled_) return list<Metric>();
+std::list<Metric> Component::CollectCounters(const string& name,
+                                             const Names& names,
+                                             const Tags& tags,
+                                             const Values& values) {
   std::list<Metric> ret;
-  for (size_t i = 0; i < names_.counter_names_.size(); i++) {
-    if (tags_.counter_tags_[i].size()) {
-      ret.emplace_back(Metric{name_, names_.counter_names_[i], values_.counters_[i], tags_.counter_tags_[i]});
+  for (size_t i = 0; i < names.counter_names_.size(); i++) {
+    if (tags.counter_tags_[i].size()) {
+      ret.emplace_back(Metric{name, names.counter_names_[i], values.counters_[i], tags.counter_tags_[i]});
     } else {
-      ret.emplace_back(Metric{name_, names_.counter_names_[i], values_.counters_[i]});
+      ret.emplace_back(Metric{name, names.counter_names_[i], values.counters_[i]});
     }
   }
-  for (std::size_t i = 0; i < names_.atomic_counter_names_.size(); i++) {
-    ret.emplace_back(Metric{name_, names_.atomic_counter_names_[i], Counter(values_.atomic_counters_[i].Get())});
+  for (std::size_t i = 0; i < names.atomic_counter_names_.size(); i++) {
+    ret.emplace_back(Metric{name, names.atomic_counter_names_[i], Counter(values.atomic_counters_[i].Get())});
   }
   return ret;
 }
 
-std::list<Metric> Component::CollectStatuses() {
-  if (!metricsEnabled_) return list<Metric>();
+std::list<Metric> Component::CollectStatuses(const string& name, const Names& names, const Values& values) {
   std::list<Metric> ret;
-  for (size_t i = 0; i < names_.status_names_.size(); i++) {
-    ret.emplace_back(Metric{name_, names_.status_names_[i], values_.statuses_[i]});
+  for (size_t i = 0; i < names.status_names_.size(); i++) {
+    ret.emplace_back(Metric{name, names.status_names_[i], values.statuses_[i]});
   }
   return ret;
 }
 
 void Component::UpdateAggregator() {
-  if (!metricsEnabled_) return;
-  Values copy = values_;
-  if (auto aggregator = aggregator_.lock()) aggregator->UpdateValues(name_, std::move(copy));
+  if (!metricsEnabled_ || !snapshot_) return;
+  snapshot_->Store(std::make_shared<const Values>(values_));
 }
 
-// Generate a JSON string of the component. To save space we don't add any newline characters.
 std::string Component::ToJson() {
   if (!metricsEnabled_) return "";
+  return ToJson(name_, names_, values_);
+}
+
+// Generate a JSON string of the component. To save space we don't add any newline characters.
+std::string Component::ToJson(const string& name, const Names& names, const Values& values) {
   ostringstream oss;
 
   // Add the object opening and component name
-  oss << "{\"Name\":\"" << name_ << "\",";
+  oss << "{\"Name\":\"" << name << "\",";
 
   // Add any gauges
   oss << "\"Gauges\":{";
 
-  for (size_t i = 0; i < names_.gauge_names_.size(); i++) {
+  for (size_t i = 0; i < names.gauge_names_.size(); i++) {
     if (i != 0) {
       oss << ",";
     }
-    oss << "\"" << names_.gauge_names_[i] << "\":" << values_.gauges_[i].Get() << "";
+    oss << "\"" << names.gauge_names_[i] << "\":" << values.gauges_[i].Get() << "";
   }
 
   // End gauges
@@ -143,12 +164,12 @@ std::string Component::ToJson() {
   // Add any status
   oss << "\"Statuses\":{";
 
-  for (size_t i = 0; i < names_.status_names_.size(); i++) {
+  for (size_t i = 0; i < names.status_names_.size(); i++) {
     if (i != 0) {
       oss << ",";
     }
-    oss << "\"" << names_.status_names_[i] << "\":"
-        << "\"" << values_.statuses_[i].Get() << "\"";
+    oss << "\"" << names.status_names_[i] << "\":"
+        << "\"" << values.statuses_[i].Get() << "\"";
   }
 
   // End status
@@ -157,18 +178,18 @@ std::string Component::ToJson() {
   // Add any counters
   oss << "\"Counters\":{";
 
-  for (size_t i = 0; i < names_.counter_names_.size(); i++) {
+  for (size_t i = 0; i < names.counter_names_.size(); i++) {
     if (i != 0) {
       oss << ",";
     }
-    oss << "\"" << names_.counter_names_[i] << "\":" << values_.counters_[i].Get() << "";
+    oss << "\"" << names.counter_names_[i] << "\":" << values.counters_[i].Get() << "";
   }
 
-  for (size_t i = 0; i < names_.atomic_counter_names_.size(); i++) {
-    if (i != 0 || names_.counter_names_.size() > 0) {
+  for (size_t i = 0; i < names.atomic_counter_names_.size(); i++) {
+    if (i != 0 || names.counter_names_.size() > 0) {
       oss << ",";
     }
-    oss << "\"" << names_.atomic_counter_names_[i] << "\":" << values_.atomic_counters_[i].Get() << "";
+    oss << "\"" << names.atomic_counter_names_[i] << "\":" << values.atomic_counters_[i].Get() << "";
   }
 
   // End counters
@@ -182,33 +203,27 @@ std::string Component::ToJson() {
 
 /******************************** Class Aggregator ********************************/
 
-void Aggregator::RegisterComponent(Component& component) {
-  std::lock_guard<std::mutex> lock(lock_);
-  components_.insert(make_pair(component.Name(), component));
-}
-
-// Throws if the component doesn't exist.
-// This is only called from the component itself, so it will never actually throw.
-void Aggregator::UpdateValues(const string& name, Values&& values) {
-  if (!metricsEnabled_) return;
-  std::lock_guard<std::mutex> lock(lock_);
-  try {
-    components_.at(name).SetValues(std::move(values));
-  } catch (const std::out_of_range& e) {
-    throw std::out_of_range("components_.at() failed for name = " + name);
+// A component that is registered twice (e.g. a copy of it) shares the snapshot of the first registration
+std::shared_ptr<Aggregator::ComponentSnapshot> Aggregator::RegisterComponent(const Component& component) {
+  std::unique_lock<std::shared_mutex> lock(lock_);
+  auto& snapshot = components_[component.name_];
+  if (!snapshot) {
+    snapshot =
+        std::make_shared<ComponentSnapshot>(component.name_, component.names_, component.tags_, component.values_);
   }
+  return snapshot;
 }
 
 Gauge Aggregator::GetGauge(const string& component_name, const string& val_name) {
-  std::lock_guard<std::mutex> lock(lock_);
+  std::shared_lock<std::shared_mutex> lock(lock_);
   try {
-    auto& component = components_.at(component_name);
-    auto& gauges = component.names_.gauge_names_;
+    auto& component = *components_.at(component_name);
+    const auto values = component.Load();
+    auto& gauges = component.names.gauge_names_;
     if (std::find(gauges.begin(), gauges.end(), val_name) != gauges.end()) {
-      return FindValue(kGaugeName, val_name, component.names_.gauge_names_, component.values_.gauges_);
+      return FindValue(kGaugeName, val_name, component.names.gauge_names_, values->gauges_);
     }
-    auto atomic_gauge =
-        FindValue(kCounterName, val_name, component.names_.atomic_gauge_names_, component.values_.atomic_gauges_);
+    auto atomic_gauge = FindValue(kCounterName, val_name, component.names.atomic_gauge_names_, values->atomic_gauges_);
     return Gauge(atomic_gauge.Get());
   } catch (const std::out_of_range& e) {
     throw std::out_of_range("components_.at() failed for component_name = " + component_name);
@@ -216,25 +231,26 @@ Gauge Aggregator::GetGauge(const string& component_name, const string& val_name)
 }
 
 Status Aggregator::GetStatus(const string& component_name, const string& val_name) {
-  std::lock_guard<std::mutex> lock(lock_);
+  std::shared_lock<std::shared_mutex> lock(lock_);
   try {
-    auto& component = components_.at(component_name);
-    return FindValue(kStatusName, val_name, component.names_.status_names_, component.values_.statuses_);
+    auto& component = *components_.at(component_name);
+    return FindValue(kStatusName, val_name, component.names.status_names_, component.Load()->statuses_);
   } catch (const std::out_of_range& e) {
     throw std::out_of_range("components_.at() failed for component_name = " + component_name);
   }
 }
 
 Counter Aggregator::GetCounter(const string& component_name, const string& val_name) {
-  std::lock_guard<std::mutex> lock(lock_);
+  std::shared_lock<std::shared_mutex> lock(lock_);
   try {
-    auto& component = components_.at(component_name);
-    auto& counters = component.names_.counter_names_;
+    auto& component = *components_.at(component_name);
+    const auto values = component.Load();
+    auto& counters = component.names.counter_names_;
     if (std::find(counters.begin(), counters.end(), val_name) != counters.end()) {
-      return FindValue(kCounterName, val_name, component.names_.counter_names_, component.values_.counters_);
+      return FindValue(kCounterName, val_name, component.names.counter_names_, values->counters_);
     }
     auto atomic_counter =
-        FindValue(kCounterName, val_name, component.names_.atomic_counter_names_, component.values_.atomic_counters_);
+        FindValue(kCounterName, val_name, component.names.atomic_counter_names_, values->atomic_counters_);
     return Counter(atomic_counter.Get());
   } catch (const std::out_of_range& e) {
     throw std::out_of_range("components_.at() failed for component_name = " + component_name);
@@ -246,7 +262,7 @@ Counter Aggregator::GetCounter(const string& component_name, const string& val_n
 std::string Aggregator::ToJson() {
   if (!metricsEnabled_) return "";
   ostringstream oss;
-  std::lock_guard<std::mutex> lock(lock_);
+  std::shared_lock<std::shared_mutex> lock(lock_);
 
   // Add the object opening
   oss << "{\"Components\":[";
@@ -257,7 +273,8 @@ std::string Aggregator::ToJson() {
     if (it != components_.begin()) {
       oss << ",";
     }
-    oss << it->second.ToJson();
+    const auto& component = *it->second;
+    oss << Component::ToJson(component.name, component.names, *component.Load());
   }
 
   // Add the object end
@@ -267,32 +284,35 @@ std::string Aggregator::ToJson() {
 }
 std::list<Metric> Aggregator::CollectGauges() {
   if (!metricsEnabled_) return std::list<Metric>();
-  std::lock_guard<std::mutex> lock(lock_);
+  std::shared_lock<std::shared_mutex> lock(lock_);
   std::list<Metric> ret;
   for (auto& comp : components_) {
-    const auto& gauges = comp.second.CollectGauges();
-    ret.insert(ret.end(), gauges.begin(), gauges.end());
+    const auto& component = *comp.second;
+    auto gauges = Component::CollectGauges(component.name, component.names, component.tags, *component.Load());
+    ret.splice(ret.end(), gauges);
   }
   return ret;
 }
 std::list<Metric> Aggregator::CollectCounters() {
   if (!metricsEnabled_) return std::list<Metric>();
-  std::lock_guard<std::mutex> lock(lock_);
+  std::shared_lock<std::shared_mutex> lock(lock_);
   std::list<Metric> ret;
   for (auto& comp : components_) {
-    const auto& counters = comp.second.CollectCounters();
-    ret.insert(ret.end(), counters.begin(), counters.end());
+    const auto& component = *comp.second;
+    auto counters = Component::CollectCounters(component.name, component.names, component.tags, *component.Load());
+    ret.splice(ret.end(), counters);
   }
   return ret;
 }
 
 std::list<Metric> Aggregator::CollectStatuses() {
   if (!metricsEnabled_) return std::list<Metric>();
-  std::lock_guard<std::mutex> lock(lock_);
+  std::shared_lock<std::shared_mutex> lock(lock_);
   std::list<Metric> ret;
   for (auto& comp : components_) {
-    const auto& statuses = comp.second.CollectStatuses();
-    ret.insert(ret.end(), statuses.begin(), statuses.end());
+    const auto& component = *comp.second;
+    auto statuses = Component::CollectStatuses(component.name, component.names, *component.Load());
+    ret.splice(ret.end(), statuses);
   }
   return ret;
 }
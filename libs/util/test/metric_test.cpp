@@ -16,6 +16,10 @@
 #include "gtest/gtest.h"
 #include "util/Metrics.hpp"
 #include <cmath>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
@@ -203,4 +207,45 @@ TEST(MetricTest, CollectStatuses) {
   ASSERT_EQ(numOfGaugesInStateTransfer, 1);
 }
 
+// Components are updated on their own threads while the aggregator is read. Readers should only see published
+// snapshots, i.e. the two gauges of a component, which are always set together, are equal.
+TEST(MetricTest, ConcurrentUpdatesAndReads) {
+  const int kNumComponents = 4;
+  const uint64_t kNumUpdates = 10000;
+  auto aggregator = std::make_shared<Aggregator>();
+  std::vector<std::unique_ptr<Component>> components;
+  std::vector<std::thread> updaters;
+  for (int i = 0; i < kNumComponents; i++) {
+    auto& c = components.emplace_back(std::make_unique<Component>("component_" + std::to_string(i), aggregator));
+    auto h_first = c->RegisterGauge("first", 0);
+    auto h_second = c->RegisterGauge("second", 0);
+    c->Register();
+    updaters.emplace_back([c = c.get(), h_first, h_second]() mutable {
+      for (uint64_t i = 1; i <= kNumUpdates; i++) {
+        h_first.Get().Set(i);
+        h_second.Get().Set(i);
+        c->UpdateAggregator();
+      }
+    });
+  }
+
+  auto done = false;
+  while (!done) {
+    map<string, vector<uint64_t>> gauges;
+    for (auto& g : aggregator->CollectGauges()) {
+      gauges[g.component].push_back(std::get<Gauge>(g.value).Get());
+    }
+    ASSERT_EQ(gauges.size(), kNumComponents);
+    done = true;
+    for (auto& [component, values] : gauges) {
+      ASSERT_EQ(values.size(), 2) << component;
+      ASSERT_EQ(values[0], values[1]) << component;
+      done = done && values[0] == kNumUpdates;
+    }
+  }
+  for (auto& t : updaters) {
+    t.join();
+  }
+}
+
 }  // namespace concordMetrics
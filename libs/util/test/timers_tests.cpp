@@ -13,6 +13,8 @@
 //
 
 #include <cstdlib>
+#include <optional>
+#include <vector>
 #include "gtest/gtest.h"
 #include "util/Timers.hpp"
 
@@ -106,4 +108,105 @@ TEST(TimersTest, Basic) {
   ASSERT_TRUE(third_timer_fired);
 }
 
+// Timers with expiry times at all levels of the wheel fire exactly when the clock passes their expiry time.
+TEST(TimersTest, FireAtExpiryAcrossWheelLevels) {
+  auto timers = Timers();
+  steady_clock::time_point start = steady_clock::now();
+  const vector<milliseconds> durations{milliseconds(1),
+                                       milliseconds(255),
+                                       milliseconds(256),
+                                       milliseconds(1000),
+                                       milliseconds(65536),
+                                       milliseconds(3600 * 1000),
+                                       milliseconds(1ull << 32),
+                                       milliseconds((1ull << 33) + 17)};
+  vector<optional<steady_clock::time_point>> fired(durations.size());
+  steady_clock::time_point now = start;
+  for (size_t i = 0; i < durations.size(); ++i) {
+    timers.add(
+        durations[i], Timers::Timer::ONESHOT, [&fired, &now, i](Handle) { fired[i] = now; }, start);
+  }
+
+  // Advance the clock in irregular steps, jumping over long idle periods
+  std::srand(17);
+  while (now < start + durations.back() + milliseconds(1)) {
+    now += microseconds(std::rand() % 5000000) + (std::rand() % 8 == 0 ? milliseconds(1ull << 30) : milliseconds(0));
+    timers.evaluate(now);
+    for (size_t i = 0; i < durations.size(); ++i) {
+      if (start + durations[i] <= now) {
+        ASSERT_TRUE(fired[i].has_value()) << i;
+      } else {
+        ASSERT_FALSE(fired[i].has_value()) << i;
+      }
+    }
+  }
+}
+
+TEST(TimersTest, ManyTimers) {
+  auto timers = Timers();
+  steady_clock::time_point now = steady_clock::now();
+  const size_t count = 10000;
+  vector<int> fired(count, 0);
+  vector<Handle> handles;
+  for (size_t i = 0; i < count; ++i) {
+    handles.push_back(timers.add(
+        milliseconds(i % 1000 + 1), Timers::Timer::RECURRING, [&fired, i](Handle) { ++fired[i]; }, now));
+  }
+  // Cancel every other timer and postpone every third one
+  for (size_t i = 0; i < count; i += 2) {
+    timers.cancel(handles[i]);
+  }
+  for (size_t i = 1; i < count; i += 3) {
+    timers.reset(handles[i], milliseconds(5000), now);
+  }
+  for (int ms = 1; ms <= 4000; ++ms) {
+    timers.evaluate(now + milliseconds(ms));
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (i % 2 == 0) {
+      ASSERT_EQ(0, fired[i]) << i;
+    } else if (i % 3 == 1) {
+      ASSERT_EQ(0, fired[i]) << i;
+    } else {
+      ASSERT_EQ(static_cast<int>(4000 / (i % 1000 + 1)), fired[i]) << i;
+    }
+  }
+}
+
+TEST(TimersTest, ModifyTimersFromCallbacks) {
+  auto timers = Timers();
+  steady_clock::time_point now = steady_clock::now();
+  int self_cancelling_counter = 0;
+  int cancelled_counter = 0;
+  int added_counter = 0;
+  Handle cancelled;
+  timers.add(
+      milliseconds(10),
+      Timers::Timer::RECURRING,
+      [&](Handle h) {
+        ++self_cancelling_counter;
+        timers.cancel(h);
+        timers.cancel(cancelled);
+        timers.add(
+            milliseconds(10), Timers::Timer::ONESHOT, [&added_counter](Handle) { ++added_counter; }, now);
+      },
+      now);
+  cancelled = timers.add(
+      milliseconds(10), Timers::Timer::RECURRING, [&cancelled_counter](Handle) { ++cancelled_counter; }, now);
+
+  now += milliseconds(10);
+  timers.evaluate(now);
+  ASSERT_EQ(1, self_cancelling_counter);
+  ASSERT_EQ(0, cancelled_counter);
+  ASSERT_EQ(0, added_counter);
+
+  now += milliseconds(10);
+  timers.evaluate(now);
+  now += milliseconds(10);
+  timers.evaluate(now);
+  ASSERT_EQ(1, self_cancelling_counter);
+  ASSERT_EQ(0, cancelled_counter);
+  ASSERT_EQ(1, added_counter);
+}
+
 }  // namespace concordUtil
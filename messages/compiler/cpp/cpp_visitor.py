@@ -15,8 +15,11 @@ from visitor import Visitor
 
 def struct_start(name, id):
     return f"""
+class {name}View;
+
 struct {name} {{
   static constexpr uint32_t id = {id};
+  using View = {name}View;
 
 """
 
@@ -29,7 +32,7 @@ def serialize_byte_buffer_declaration(name):
 
 
 def serialize_byte_buffer_start(name):
-    return serialize_byte_buffer_fn.format(name=name) + " {\n"
+    return serialize_byte_buffer_fn.format(name=name) + " {\n  cmf::reserve(output, serialized_size(t));\n"
 
 
 serialize_string_fn = "void serialize(std::string& output, const {name}& t)"
@@ -40,7 +43,7 @@ def serialize_string_declaration(name):
 
 
 def serialize_string_start(name):
-    return serialize_string_fn.format(name=name) + " {\n"
+    return serialize_string_fn.format(name=name) + " {\n  cmf::reserve(output, serialized_size(t));\n"
 
 
 deserialize_fn = "void deserialize(const uint8_t*& input, const uint8_t* end, {name}& t)"
@@ -84,6 +87,93 @@ def deserialize_string(name):
 """
 
 
+serialized_size_fn = "size_t serialized_size(const {name}& t)"
+
+
+def serialized_size_declaration(name):
+    return serialized_size_fn.format(name=name) + ";\n"
+
+
+def serialized_size(name, fields):
+    """ Create a function returning the exact size of the serialized message """
+    # Oneofs are handled generically in the cmf namespace, unlike their serialization functions
+    sizes = " + ".join([f"{'' if type == 'msg' else 'cmf::'}serialized_size(t.{field})" for (field, type, _) in fields])
+    return serialized_size_fn.format(name=name) + f""" {{
+  return {sizes or "0"};
+}}"""
+
+
+def view_declaration(name, fields):
+    """ Create the <Msg>View class that reads the fields of a serialized message out of a buffer """
+    accessors = "".join([f"  cmf::View<{cpp_type}> {field}() const;\n" for (field, _, cpp_type) in fields])
+    return f"""
+// A view of a serialized {name}. It is only valid while the buffer it was created from is.
+class {name}View {{
+ public:
+  // Throw cmf::DeserializeError if the buffer doesn't hold a valid {name}
+  {name}View(const uint8_t*& input, const uint8_t* end);
+  explicit {name}View(const std::vector<uint8_t>& input);
+  explicit {name}View(const std::string& input);
+  {name}View(std::vector<uint8_t>&& input) = delete;
+  {name}View(std::string&& input) = delete;
+
+{accessors}
+ private:
+  void parse(const uint8_t*& input, const uint8_t* end);
+
+  std::array<const uint8_t*, {len(fields)}> fields_{{}};
+  const uint8_t* end_{{nullptr}};
+}};
+"""
+
+
+def view(name, fields):
+    s = f"""{name}View::{name}View(const uint8_t*& input, const uint8_t* end) {{ parse(input, end); }}
+
+{name}View::{name}View(const std::vector<uint8_t>& input) {{
+  auto begin = input.data();
+  parse(begin, begin + input.size());
+}}
+
+{name}View::{name}View(const std::string& input) {{
+  auto begin = reinterpret_cast<const unsigned char*>(input.data());
+  parse(begin, begin + input.size());
+}}
+
+void {name}View::parse(const uint8_t*& input, const uint8_t* end) {{
+"""
+    for i, (_, _, cpp_type) in enumerate(fields):
+        s += f"  fields_[{i}] = input;\n"
+        s += f"  cmf::ViewTraits<{cpp_type}>::read(input, end);\n"
+    s += "  end_ = input;\n}\n"
+    for i, (field, _, cpp_type) in enumerate(fields):
+        s += f"""
+cmf::View<{cpp_type}> {name}View::{field}() const {{
+  auto input = fields_[{i}];
+  return cmf::ViewTraits<{cpp_type}>::read(input, end_);
+}}
+"""
+    return s
+
+
+view_equalop_fn = "bool operator==(const {msg_name}& l, const {msg_name}View& r)"
+
+
+def view_equalop_declaration(msg_name):
+    return view_equalop_fn.format(msg_name=msg_name) + ";\n"
+
+
+def view_equalop(msg_name, fields):
+    """ Create an 'operator==' function comparing a message with a view of a serialized message """
+    comparison = "true"
+    if fields:
+        comparison = " && ".join(
+            [f"cmf::ViewTraits<{cpp_type}>::equal(l.{f}, r.{f}())" for (f, _, cpp_type) in fields])
+    return view_equalop_fn.format(msg_name=msg_name) + f""" {{
+  return {comparison};
+}}"""
+
+
 def serialize_field(name, type):
     # All messages except oneofs and messages exist in the cmf namespace, and are provided in
     # serialize.h
@@ -194,6 +284,12 @@ class CppVisitor(Visitor):
         # All fields currently seen for the given message
         self.fields_seen = []
 
+        # The name, CMF type and C++ type of all fields currently seen for the given message
+        self.field_types = []
+
+        # Where the C++ type of the current field starts in the struct being created
+        self.field_type_start = 0
+
         # The struct being created for the current message. This includes the fields of the struct.
         self.struct = ""
 
@@ -262,9 +358,12 @@ class CppVisitor(Visitor):
                 self.oneof_serialize_string,
                 self.oneof_deserialize,
                 equalop_str(self.msg_name, self.fields_seen),
+                serialized_size(self.msg_name, self.field_types),
                 self.serialize_byte_buffer,
                 self.serialize_string,
                 self.deserialize,
+                view(self.msg_name, self.field_types),
+                view_equalop(self.msg_name, self.field_types),
             ] if s != ''
         ]) + "\n"
         self.output_declaration += "".join([
@@ -280,6 +379,9 @@ class CppVisitor(Visitor):
                 self.oneof_serialize_string_declaration,
                 self.oneof_deserialize_declaration,
                 equalop_str_declaration(self.msg_name),
+                serialized_size_declaration(self.msg_name),
+                view_declaration(self.msg_name, self.field_types),
+                view_equalop_declaration(self.msg_name),
             ] if s != ''
         ]) + "\n"
         self._reset()
@@ -287,6 +389,8 @@ class CppVisitor(Visitor):
     def field_start(self, name, type):
         self.struct += "  "  # Indent fields
         self.field['name'] = name
+        self.field['type'] = type
+        self.field_type_start = len(self.struct)
         self.fields_seen.append(name)
         self.serialize_byte_buffer += serialize_field(name, type)
         self.serialize_string += serialize_field(name, type)
@@ -295,6 +399,7 @@ class CppVisitor(Visitor):
     def field_end(self):
         # The field is preceeded by the type in the struct definition. Close it with the name and
         # necessary syntax.
+        self.field_types.append((self.field['name'], self.field['type'], self.struct[self.field_type_start:]))
         self.struct += f" {self.field['name']}{{}};\n"
 
 
@@ -19,27 +19,13 @@ inline void cmfAssert(bool expr) {
   }
 }
 
-class DeserializeError : public std::runtime_error {
- public:
-  DeserializeError(const std::string& error) : std::runtime_error(("DeserializeError: " + error).c_str()) {}
-};
-
-class NoDataLeftError : public DeserializeError {
- public:
-  NoDataLeftError() : DeserializeError("Data left in buffer is less than what is needed for deserialization") {}
-};
-
-class BadDataError : public DeserializeError {
- public:
-  BadDataError(const std::string& expected, const std::string& got) : DeserializeError(str(expected, got)) {}
-
- private:
-  static std::string str(const std::string& expected, const std::string& actual) {
-    std::ostringstream oss;
-    oss << "Expected " << expected << ", got" << actual;
-    return oss.str();
+// Reserve space for `size` more bytes, while keeping the geometric growth of an output that is appended to
+template <typename Output>
+void reserve(Output& output, std::size_t size) {
+  if (output.size() + size > output.capacity()) {
+    output.reserve(std::max(output.size() + size, 2 * output.capacity()));
   }
-};
+}
 
 /******************************************************************************
  * Integers
@@ -70,28 +56,12 @@ void serialize(std::string& output, const T& t) {
 
 template <typename T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
 void deserialize(const uint8_t*& start, const uint8_t* end, T& t) {
-  if constexpr (std::is_same_v<T, bool>) {
-    if (start + 1 > end) {
-      throw NoDataLeftError();
-    }
-    if (*start == 0) {
-      t = false;
-    } else if (*start == 1) {
-      t = true;
-    } else {
-      throw BadDataError("0 or 1", std::to_string(*start));
-    }
-    start += 1;
-  } else {
-    if (start + sizeof(T) > end) {
-      throw NoDataLeftError();
-    }
-    t = 0;
-    for (auto i = 0u; i < sizeof(T); i++) {
-      t |= (static_cast<std::make_unsigned_t<T>>(*(start + sizeof(T) - 1 - i)) << (i * 8));
-    }
-    start += sizeof(T);
-  }
+  t = readInteger<T>(start, end);
+}
+
+template <typename T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+std::size_t serialized_size(const T&) {
+  return sizeof(T);
 }
 
 /******************************************************************************
@@ -119,6 +89,11 @@ void deserialize(const uint8_t*& start, const uint8_t* end, T& t) {
   }
 }
 
+template <typename T, typename std::enable_if<std::is_enum<T>::value>::type* = nullptr>
+std::size_t serialized_size(const T&) {
+  return sizeof(uint8_t);
+}
+
 /******************************************************************************
  * Strings
  *
@@ -148,6 +123,8 @@ void deserialize(const uint8_t*& start, const uint8_t* end, T& t) {
   start += length;
 }
 
+[[maybe_unused]] static inline std::size_t serialized_size(const std::string& s) { return sizeof(uint32_t) + s.size(); }
+
 /******************************************************************************
  Forward declarations needed by recursive types
  ******************************************************************************/
@@ -158,6 +135,8 @@ template <typename T>
 void serialize(std::string& output, const std::vector<T>& v);
 template <typename T>
 void deserialize(const uint8_t*& start, const uint8_t* end, std::vector<T>& v);
+template <typename T>
+std::size_t serialized_size(const std::vector<T>& v);
 
 // Fixed Lists
 template <typename T, std::size_t N>
@@ -166,6 +145,8 @@ template <typename T, std::size_t N>
 void serialize(std::string& output, const std::array<T, N>& v);
 template <typename T, std::size_t N>
 void deserialize(const uint8_t*& start, const uint8_t* end, std::array<T, N>& v);
+template <typename T, std::size_t N>
+std::size_t serialized_size(const std::array<T, N>& v);
 
 // KVPairs
 template <typename K, typename V>
@@ -174,6 +155,8 @@ template <typename K, typename V>
 void serialize(std::string& output, const std::pair<K, V>& kvpair);
 template <typename K, typename V>
 void deserialize(const uint8_t*& start, const uint8_t* end, std::pair<K, V>& kvpair);
+template <typename K, typename V>
+std::size_t serialized_size(const std::pair<K, V>& kvpair);
 
 // Maps
 template <typename K, typename V>
@@ -182,6 +165,8 @@ template <typename K, typename V>
 void serialize(std::string& output, const std::map<K, V>& m);
 template <typename K, typename V>
 void deserialize(const uint8_t*& start, const uint8_t* end, std::map<K, V>& m);
+template <typename K, typename V>
+std::size_t serialized_size(const std::map<K, V>& m);
 
 // Optionals
 template <typename T>
@@ -190,6 +175,12 @@ template <typename T>
 void serialize(std::string& output, const std::optional<T>& t);
 template <typename T>
 void deserialize(const uint8_t*& start, const uint8_t* end, std::optional<T>& t);
+template <typename T>
+std::size_t serialized_size(const std::optional<T>& t);
+
+// Oneofs
+template <typename... Ts>
+std::size_t serialized_size(const std::variant<Ts...>& v);
 
 /******************************************************************************
  * Lists are modeled as std::vectors
@@ -236,6 +227,19 @@ void deserialize(const uint8_t*& start, const uint8_t* end, std::vector<T>& v) {
   }
 }
 
+template <typename T>
+std::size_t serialized_size(const std::vector<T>& v) {
+  std::size_t size = sizeof(uint32_t);
+  if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+    size += v.size();
+  } else {
+    for (auto& it : v) {
+      size += serialized_size(it);
+    }
+  }
+  return size;
+}
+
 template <typename T, std::size_t N>
 void serialize(std::vector<uint8_t>& output, const std::array<T, N>& a) {
   for (auto& it : a) {
@@ -266,6 +270,19 @@ void deserialize(const uint8_t*& start, const uint8_t* end, std::array<T, N>& a)
   }
 }
 
+template <typename T, std::size_t N>
+std::size_t serialized_size(const std::array<T, N>& a) {
+  if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+    return N;
+  } else {
+    std::size_t size = 0;
+    for (auto& it : a) {
+      size += serialized_size(it);
+    }
+    return size;
+  }
+}
+
 /******************************************************************************
  * KVPairs are modeled as std::pairs.
  ******************************************************************************/
@@ -287,6 +304,11 @@ void deserialize(const uint8_t*& start, const uint8_t* end, std::pair<K, V>& kvp
   deserialize(start, end, kvpair.second);
 }
 
+template <typename K, typename V>
+std::size_t serialized_size(const std::pair<K, V>& kvpair) {
+  return serialized_size(kvpair.first) + serialized_size(kvpair.second);
+}
+
 /******************************************************************************
  * Maps
  *
@@ -323,6 +345,15 @@ void deserialize(const uint8_t*& start, const uint8_t* end, std::map<K, V>& m) {
   }
 }
 
+template <typename K, typename V>
+std::size_t serialized_size(const std::map<K, V>& m) {
+  std::size_t size = sizeof(uint32_t);
+  for (auto& it : m) {
+    size += serialized_size(it.first) + serialized_size(it.second);
+  }
+  return size;
+}
+
 /******************************************************************************
  * Optionals are modeled as std::optional
  *
@@ -357,4 +388,20 @@ void deserialize(const uint8_t*& start, const uint8_t* end, std::optional<T>& t)
   }
 }
 
+template <typename T>
+std::size_t serialized_size(const std::optional<T>& t) {
+  return sizeof(uint8_t) + (t.has_value() ? serialized_size(t.value()) : 0);
+}
+
+/******************************************************************************
+ * Oneofs are modeled as std::variant
+ *
+ * Oneofs are preceded by the uint32_t id of the message they hold. Their serialization functions are generated per
+ * variant.
+ ******************************************************************************/
+template <typename... Ts>
+std::size_t serialized_size(const std::variant<Ts...>& v) {
+  return sizeof(uint32_t) + std::visit([](auto&& arg) { return serialized_size(arg); }, v);
+}
+
 }  // namespace cmf
@@ -1,5 +1,324 @@
+#ifndef __CMF__SERIALIZE_HPP__
+#define __CMF__SERIALIZE_HPP__
+
 namespace cmf {
-class DeserializeError;
-class NoDataLeftError;
-class BadDataError;
+
+class DeserializeError : public std::runtime_error {
+ public:
+  DeserializeError(const std::string& error) : std::runtime_error(("DeserializeError: " + error).c_str()) {}
+};
+
+class NoDataLeftError : public DeserializeError {
+ public:
+  NoDataLeftError() : DeserializeError("Data left in buffer is less than what is needed for deserialization") {}
+};
+
+class BadDataError : public DeserializeError {
+ public:
+  BadDataError(const std::string& expected, const std::string& got) : DeserializeError(str(expected, got)) {}
+
+ private:
+  static std::string str(const std::string& expected, const std::string& actual) {
+    std::ostringstream oss;
+    oss << "Expected " << expected << ", got" << actual;
+    return oss.str();
+  }
+};
+
+/******************************************************************************
+ * Integers
+ *
+ * All integers are encoded in big-endian
+ ******************************************************************************/
+template <typename T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+T readInteger(const uint8_t*& start, const uint8_t* end) {
+  if constexpr (std::is_same_v<T, bool>) {
+    if (start + 1 > end) {
+      throw NoDataLeftError();
+    }
+    if (*start > 1) {
+      throw BadDataError("0 or 1", std::to_string(*start));
+    }
+    return *start++ == 1;
+  } else {
+    if (start + sizeof(T) > end) {
+      throw NoDataLeftError();
+    }
+    T t = 0;
+    for (auto i = 0u; i < sizeof(T); i++) {
+      t |= (static_cast<std::make_unsigned_t<T>>(*(start + sizeof(T) - 1 - i)) << (i * 8));
+    }
+    start += sizeof(T);
+    return t;
+  }
+}
+
+/******************************************************************************
+ * Views
+ *
+ * A view reads a serialized value directly out of the buffer it is created from, without copying or allocating. Views
+ * are validated when they are created, and are only valid as long as the buffer is.
+ *
+ * View<T> is the view type of the C++ type T that a CMF type maps to:
+ *  - Integers, bools and enums are views of themselves
+ *  - Strings are viewed as std::string_view
+ *  - Bytes, and lists and fixedlists of uint8, are viewed as BytesView
+ *  - Lists, fixedlists and maps are viewed as ListView
+ *  - KVPairs, optionals and oneofs are viewed as std::pair, std::optional and std::variant of views
+ *  - Messages are viewed as their generated <Msg>View classes
+ ******************************************************************************/
+template <typename T, typename = void>
+struct ViewTraits;
+
+template <typename T>
+using View = typename ViewTraits<T>::type;
+
+template <typename T>
+inline constexpr bool isByte = std::is_integral_v<T> && sizeof(T) == 1 && !std::is_same_v<T, bool>;
+
+class BytesView {
+ public:
+  BytesView() = default;
+  BytesView(const uint8_t* data, std::size_t size) : data_{data}, size_{size} {}
+
+  const uint8_t* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const uint8_t* begin() const { return data_; }
+  const uint8_t* end() const { return data_ + size_; }
+  uint8_t operator[](std::size_t i) const { return data_[i]; }
+
+ private:
+  const uint8_t* data_{nullptr};
+  std::size_t size_{0};
+};
+
+// The elements are decoded while iterating
+template <typename T>
+class ListView {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = View<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    Iterator(const uint8_t* pos, const uint8_t* end, uint32_t index) : pos_{pos}, end_{end}, index_{index} {}
+
+    value_type operator*() const {
+      auto pos = pos_;
+      return ViewTraits<T>::read(pos, end_);
+    }
+    Iterator& operator++() {
+      ViewTraits<T>::read(pos_, end_);
+      ++index_;
+      return *this;
+    }
+    bool operator==(const Iterator& other) const { return index_ == other.index_; }
+    bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+   private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+    uint32_t index_;
+  };
+
+  ListView() = default;
+  // [begin, end) holds exactly `size` valid elements
+  ListView(const uint8_t* begin, const uint8_t* end, uint32_t size) : begin_{begin}, end_{end}, size_{size} {}
+
+  Iterator begin() const { return Iterator{begin_, end_, 0}; }
+  Iterator end() const { return Iterator{end_, end_, size_}; }
+  uint32_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Validate `size` elements starting at `start` and return their view
+  static ListView read(const uint8_t*& start, const uint8_t* end, uint32_t size) {
+    auto begin = start;
+    for (auto i = 0u; i < size; i++) {
+      ViewTraits<T>::read(start, end);
+    }
+    return ListView{begin, start, size};
+  }
+
+  template <typename Range>
+  bool equal(const Range& owned) const {
+    if (owned.size() != size_) {
+      return false;
+    }
+    auto it = begin();
+    for (const auto& value : owned) {
+      if (!ViewTraits<T>::equal(value, *it)) {
+        return false;
+      }
+      ++it;
+    }
+    return true;
+  }
+
+ private:
+  const uint8_t* begin_{nullptr};
+  const uint8_t* end_{nullptr};
+  uint32_t size_{0};
+};
+
+// Messages have a nested `View` type, i.e. their generated <Msg>View class
+template <typename T, typename>
+struct ViewTraits {
+  using type = typename T::View;
+  static type read(const uint8_t*& start, const uint8_t* end) { return type{start, end}; }
+  static bool equal(const T& owned, const type& view) { return owned == view; }
+};
+
+template <typename T>
+struct ViewTraits<T, std::enable_if_t<std::is_integral_v<T>>> {
+  using type = T;
+  static type read(const uint8_t*& start, const uint8_t* end) { return readInteger<T>(start, end); }
+  static bool equal(const T& owned, const type& view) { return owned == view; }
+};
+
+template <typename T>
+struct ViewTraits<T, std::enable_if_t<std::is_enum_v<T>>> {
+  using type = T;
+  static type read(const uint8_t*& start, const uint8_t* end) {
+    auto val = readInteger<uint8_t>(start, end);
+    if (val >= enumSize(T{})) {
+      throw BadDataError(std::string("Value < ") + std::to_string(enumSize(T{})), std::to_string(val));
+    }
+    return static_cast<T>(val);
+  }
+  static bool equal(const T& owned, const type& view) { return owned == view; }
+};
+
+template <>
+struct ViewTraits<std::string> {
+  using type = std::string_view;
+  static type read(const uint8_t*& start, const uint8_t* end) {
+    auto length = readInteger<uint32_t>(start, end);
+    if (start + length > end) {
+      throw NoDataLeftError();
+    }
+    auto view = std::string_view{reinterpret_cast<const char*>(start), length};
+    start += length;
+    return view;
+  }
+  static bool equal(const std::string& owned, const type& view) { return owned == view; }
+};
+
+template <typename T>
+struct ViewTraits<std::vector<T>> {
+  using type = std::conditional_t<isByte<T>, BytesView, ListView<T>>;
+  static type read(const uint8_t*& start, const uint8_t* end) {
+    auto length = readInteger<uint32_t>(start, end);
+    if constexpr (isByte<T>) {
+      if (start + length > end) {
+        throw NoDataLeftError();
+      }
+      auto view = BytesView{start, length};
+      start += length;
+      return view;
+    } else {
+      return ListView<T>::read(start, end, length);
+    }
+  }
+  static bool equal(const std::vector<T>& owned, const type& view) {
+    if constexpr (isByte<T>) {
+      return owned.size() == view.size() && std::equal(owned.begin(), owned.end(), view.begin());
+    } else {
+      return view.equal(owned);
+    }
+  }
+};
+
+template <typename T, std::size_t N>
+struct ViewTraits<std::array<T, N>> {
+  using type = std::conditional_t<isByte<T>, BytesView, ListView<T>>;
+  static type read(const uint8_t*& start, const uint8_t* end) {
+    if constexpr (isByte<T>) {
+      if (start + N > end) {
+        throw NoDataLeftError();
+      }
+      auto view = BytesView{start, N};
+      start += N;
+      return view;
+    } else {
+      return ListView<T>::read(start, end, N);
+    }
+  }
+  static bool equal(const std::array<T, N>& owned, const type& view) {
+    if constexpr (isByte<T>) {
+      return std::equal(owned.begin(), owned.end(), view.begin());
+    } else {
+      return view.equal(owned);
+    }
+  }
+};
+
+template <typename K, typename V>
+struct ViewTraits<std::pair<K, V>> {
+  using type = std::pair<View<K>, View<V>>;
+  static type read(const uint8_t*& start, const uint8_t* end) {
+    auto key = ViewTraits<K>::read(start, end);
+    return type{key, ViewTraits<V>::read(start, end)};
+  }
+  static bool equal(const std::pair<K, V>& owned, const type& view) {
+    return ViewTraits<K>::equal(owned.first, view.first) && ViewTraits<V>::equal(owned.second, view.second);
+  }
+};
+
+// Maps are serialized as lists of sorted kvpairs
+template <typename K, typename V>
+struct ViewTraits<std::map<K, V>> {
+  using type = ListView<std::pair<K, V>>;
+  static type read(const uint8_t*& start, const uint8_t* end) {
+    return type::read(start, end, readInteger<uint32_t>(start, end));
+  }
+  static bool equal(const std::map<K, V>& owned, const type& view) { return view.equal(owned); }
+};
+
+template <typename T>
+struct ViewTraits<std::optional<T>> {
+  using type = std::optional<View<T>>;
+  static type read(const uint8_t*& start, const uint8_t* end) {
+    if (readInteger<bool>(start, end)) {
+      return ViewTraits<T>::read(start, end);
+    }
+    return std::nullopt;
+  }
+  static bool equal(const std::optional<T>& owned, const type& view) {
+    if (owned.has_value() != view.has_value()) {
+      return false;
+    }
+    return !owned.has_value() || ViewTraits<T>::equal(*owned, *view);
+  }
+};
+
+// Oneofs are serialized as the message id followed by the message
+template <typename... Ts>
+struct ViewTraits<std::variant<Ts...>> {
+  using type = std::variant<View<Ts>...>;
+  static type read(const uint8_t*& start, const uint8_t* end) {
+    auto id = readInteger<uint32_t>(start, end);
+    std::optional<type> view;
+    ((id == Ts::id ? (void)view.emplace(ViewTraits<Ts>::read(start, end)) : (void)0), ...);
+    if (!view) {
+      throw DeserializeError(std::string("Invalid Message id in variant: ") + std::to_string(id));
+    }
+    return *view;
+  }
+  static bool equal(const std::variant<Ts...>& owned, const type& view) {
+    return std::visit(
+        [&view](const auto& value) {
+          using T = std::decay_t<decltype(value)>;
+          const auto* alternative = std::get_if<View<T>>(&view);
+          return alternative != nullptr && ViewTraits<T>::equal(value, *alternative);
+        },
+        owned);
+  }
+};
+
 }  // namespace cmf
+
+#endif  // __CMF__SERIALIZE_HPP__
@@ -212,7 +212,8 @@ class InstanceVisitor(Visitor):
 
 def testSerializationStr(msg_name):
     """
-    Create a function that roundtrip serializes and deserializes all instances of a given message type.
+    Create a function that roundtrip serializes and deserializes all instances of a given message type, and checks
+    their serialized sizes and views.
     """
     s = "void {}() {{\n".format(test_name(msg_name))
     for i in range(0, MAX_SIZE):
@@ -222,13 +223,17 @@ def testSerializationStr(msg_name):
     {msg_name} {instance}_computed;
     std::vector<uint8_t> output;
     serialize(output, {instance});
+    assert(serialized_size({instance}) == output.size());
     deserialize(output, {instance}_computed);
     assert({instance} == {instance}_computed);
+    {msg_name}View {instance}_view(output);
+    assert({instance} == {instance}_view);
     {msg_name} {instance}_str_computed;
     std::string output_str;
     serialize(output_str, {instance});
     deserialize(output_str, {instance}_str_computed);
     assert({instance} == {instance}_str_computed);
+    assert({instance} == {msg_name}View(output_str));
   }}
 """
     s += "}\n"
@@ -25,6 +25,7 @@
 #include "util/assertUtils.hpp"
 #include "storage/db_interface.h"
 #include "s3_metrics.hpp"
+#include "put_queue.hpp"
 #include "util/thread_pool.hpp"
 
 #pragma once
@@ -41,6 +42,8 @@ struct StoreConfig {
   std::string secretKey;           // password
   std::string pathPrefix;          // optional path prefix used in the bucket
   std::uint32_t operationTimeout;  // max timeout for an operation in milliseconds
+  std::uint32_t putConcurrency = 16;   // number of puts in flight, see PutQueue
+  std::uint32_t maxPendingPuts = 1024;  // putAsync() blocks while this many puts are pending
 
   std::string toURL() const {
     std::ostringstream oss;
@@ -215,6 +218,8 @@ class Client : public concord::storage::IDBClient {
   Client(const StoreConfig& config) : config_{config} { LOG_INFO(logger_, "S3 client created"); }
 
   ~Client() {
+    // Pending puts are failed before libs3 goes away
+    put_queue_.reset();
     /* Destroy LibS3 */
     S3_deinitialize();
     init_ = false;
@@ -245,6 +250,16 @@ class Client : public concord::storage::IDBClient {
     return do_with_retry("put_internal", std::bind(&Client::put_internal, this, _1, _2), key, value);
   }
 
+  /**
+   * Queue a put, which is performed and retried by one of the put queue's workers.
+   * Blocks while StoreConfig::maxPendingPuts puts are pending.
+   */
+  std::future<concordUtils::Status> putAsync(const concordUtils::Sliver& key, const concordUtils::Sliver& value) {
+    LOG_DEBUG(logger_, key.toString());
+    ConcordAssert(put_queue_ != nullptr);
+    return put_queue_->push(key, value);
+  }
+
   concordUtils::Status create_bucket() {
     LOG_DEBUG(logger_, config_.bucketName);
     return do_with_retry("create_bucket_internal", std::bind(&Client::create_bucket_internal, this));
@@ -327,7 +342,10 @@ class Client : public concord::storage::IDBClient {
       }
       rd = std::forward<F>(f)(std::forward<Args>(args)...);
     }
+    return to_status(msg, rd);
+  }
 
+  Status to_status(const std::string_view msg, const ResponseData& rd) const {
     if (rd.status == S3Status::S3StatusOK) {
       LOG_DEBUG(logger_, msg << " status: " << rd.status);
       return Status::OK();
@@ -340,6 +358,11 @@ class Client : public concord::storage::IDBClient {
     return Status::GeneralError("Status: " + rd.errorMessage);
   }
 
+  // A single attempt, retries are done by the put queue
+  Status put_once(const concordUtils::Sliver& key, const concordUtils::Sliver& value) {
+    return to_status("put_internal", put_internal(key, value));
+  }
+
   bool S3_status_is_not_found(S3Status s) const {
     return s == S3Status::S3StatusHttpErrorNotFound || s == S3Status::S3StatusErrorNoSuchBucket ||
            s == S3Status::S3StatusErrorNoSuchKey;
@@ -394,6 +417,7 @@ class Client : public concord::storage::IDBClient {
   uint16_t initialDelay_ = 100;
   Metrics metrics_;
   util::ThreadPool thread_pool_{"GetObjectResponseData::thread_pool", std::thread::hardware_concurrency()};
+  std::unique_ptr<PutQueue> put_queue_;
 };
 
 }  // namespace concord::storage::s3
@@ -0,0 +1,102 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log/logger.hpp"
+#include "s3_metrics.hpp"
+#include "util/sliver.hpp"
+#include "util/status.hpp"
+
+namespace concord::storage::s3 {
+
+/**
+ * A bounded queue of asynchronous puts, served by a fixed number of workers.
+ *
+ * - push() blocks while `capacity` puts are pending (queued, waiting for a retry or in flight), such that a fast
+ *   producer is slowed down to the rate of the object store instead of buffering without limit.
+ * - A put that fails with anything but NotFound is retried with the same schedule as Client::do_with_retry(), i.e. the
+ *   delay grows by `initialDelay` * attempt until it reaches `operationTimeout`. A put that waits for a retry doesn't
+ *   occupy a worker.
+ * - The result of every put is delivered through the future returned by push().
+ *
+ * The put function is called concurrently by the workers. It is expected to make a single attempt.
+ */
+class PutQueue {
+ public:
+  using PutFunction = std::function<concordUtils::Status(const concordUtils::Sliver&, const concordUtils::Sliver&)>;
+  using Clock = std::chrono::steady_clock;
+
+  struct Config {
+    std::uint32_t workers = 16;
+    std::uint32_t capacity = 1024;
+    std::uint16_t initialDelay = 100;       // milliseconds
+    std::uint32_t operationTimeout = 60000;  // milliseconds
+  };
+
+  PutQueue(const Config& config, PutFunction put, Metrics& metrics);
+  ~PutQueue();
+  PutQueue(const PutQueue&) = delete;
+  PutQueue& operator=(const PutQueue&) = delete;
+
+  std::future<concordUtils::Status> push(const concordUtils::Sliver& key, const concordUtils::Sliver& value);
+
+  std::size_t pending() const;
+
+ private:
+  struct Item {
+    concordUtils::Sliver key;
+    concordUtils::Sliver value;
+    std::promise<concordUtils::Status> promise;
+    std::uint16_t attempts = 0;
+    std::uint32_t delay = 0;
+  };
+
+  void run();
+  // Should be called with mutex_ held
+  void done(Item& item, const concordUtils::Status& status);
+  void updateThroughput(std::size_t bytes, Clock::time_point now);
+
+  const Config config_;
+  const PutFunction put_;
+  Metrics& metrics_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable space_cv_;
+  std::deque<Item> ready_;
+  // Puts that wait for a retry, by the time of the retry
+  std::multimap<Clock::time_point, Item> delayed_;
+  std::size_t pending_ = 0;
+  bool stopped_ = false;
+
+  Clock::time_point window_start_;
+  std::uint64_t window_bytes_ = 0;
+
+  std::vector<std::thread> workers_;
+  logging::Logger logger_ = logging::getLogger("concord.storage.s3.put_queue");
+};
+
+}  // namespace concord::storage::s3
@@ -13,6 +13,10 @@ class Metrics {
         bytes_transferred{
             metrics_component.RegisterCounter("bytes_transferred"),
         },
+        put_retries{metrics_component.RegisterCounter("put_retries")},
+        put_failures{metrics_component.RegisterCounter("put_failures")},
+        pending_puts{metrics_component.RegisterGauge("pending_puts", 0)},
+        put_throughput{metrics_component.RegisterGauge("put_throughput_bytes_per_sec", 0)},
         last_saved_block_id_{
             metrics_component.RegisterGauge("last_saved_block_id", 0),
         }
@@ -61,6 +65,13 @@ class Metrics {
 
   concordMetrics::CounterHandle num_keys_transferred;
   concordMetrics::CounterHandle bytes_transferred;
+  // Puts that were retried, and puts that failed after all their retries
+  concordMetrics::CounterHandle put_retries;
+  concordMetrics::CounterHandle put_failures;
+  // Puts that were queued and are not done yet
+  concordMetrics::GaugeHandle pending_puts;
+  // Bytes put per second, averaged over the last second
+  concordMetrics::GaugeHandle put_throughput;
 
  private:
   // This function "guesses" if metadata or block is being updated.
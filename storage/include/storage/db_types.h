@@ -62,6 +62,7 @@ enum class EBFTSubtype : std::uint8_t {
   STCheckpointDescriptor,
   STTempBlock,
   PublicStateHashAtDbCheckpoint,
+  PartitionedPublicStateHashAtDbCheckpoint,
 };
 
 enum class EMigrationSubType : std::uint8_t {
@@ -84,6 +84,13 @@ void Client::init(bool readOnly) {
   }
   LOG_INFO(logger_, "libs3 initialized");
   init_ = true;
+  PutQueue::Config putQueueConfig;
+  putQueueConfig.workers = config_.putConcurrency;
+  putQueueConfig.capacity = config_.maxPendingPuts;
+  putQueueConfig.initialDelay = initialDelay_;
+  putQueueConfig.operationTimeout = config_.operationTimeout;
+  put_queue_ = std::make_unique<PutQueue>(
+      putQueueConfig, [this](const Sliver& key, const Sliver& value) { return put_once(key, value); }, metrics_);
   auto res = test_bucket();
   if (res.isOK()) return;
   if (!res.isNotFound()) throw std::runtime_error("s3::Client failed to test bucket: " + res.toString());
@@ -203,7 +210,7 @@ Client::ResponseData Client::create_bucket_internal() {
 }
 
 std::ostream& operator<<(std::ostream& os, const concord::storage::s3::StoreConfig& c) {
-  os << KVLOG(c.url, c.bucketName, c.pathPrefix, c.protocol, c.operationTimeout);
+  os << KVLOG(c.url, c.bucketName, c.pathPrefix, c.protocol, c.operationTimeout, c.putConcurrency, c.maxPendingPuts);
   return os;
 }
 
@@ -259,8 +266,8 @@ void Client::Transaction::commit() {
   try {
     auto client = std::dynamic_pointer_cast<Client>(client_);
     std::vector<std::future<concordUtils::Status>> futures;
-    for (auto& pair : multiput_)
-      futures.emplace_back(client->thread_pool_.async([pair, client] { return client->put(pair.first, pair.second); }));
+    // Puts are retried by the put queue, which also bounds the number of puts in flight
+    for (auto& pair : multiput_) futures.emplace_back(client->putAsync(pair.first, pair.second));
     for (auto& key : keys_to_delete_)
       futures.emplace_back(client->thread_pool_.async([key, client] { return client->del(key); }));
     for (auto& f : futures) {
@@ -32,6 +32,8 @@ concord::storage::s3::StoreConfig ConfigFileParser::parse() {
   config.secretKey = parser_.get_value<string>("s3-secret-key");
   config.pathPrefix = parser_.get_optional_value<string>("s3-path-prefix", "");
   config.operationTimeout = parser_.get_optional_value<std::uint32_t>("s3-operation-timeout", 60000);
+  config.putConcurrency = parser_.get_optional_value<std::uint32_t>("s3-put-concurrency", 16);
+  config.maxPendingPuts = parser_.get_optional_value<std::uint32_t>("s3-max-pending-puts", 1024);
   LOG_INFO(logger_, config);
   return config;
 }
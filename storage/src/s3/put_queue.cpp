@@ -0,0 +1,148 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "s3/put_queue.hpp"
+
+#include <algorithm>
+
+#include "util/kvstream.h"
+
+namespace concord::storage::s3 {
+
+using concordUtils::Sliver;
+using concordUtils::Status;
+
+PutQueue::PutQueue(const Config& config, PutFunction put, Metrics& metrics)
+    : config_{config}, put_{std::move(put)}, metrics_{metrics}, window_start_{Clock::now()} {
+  const auto workers = std::max<std::uint32_t>(config_.workers, 1);
+  workers_.reserve(workers);
+  for (auto i = 0u; i < workers; ++i) {
+    workers_.emplace_back([this]() { run(); });
+  }
+  LOG_INFO(logger_, KVLOG(workers, config_.capacity, config_.initialDelay, config_.operationTimeout));
+}
+
+PutQueue::~PutQueue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  work_cv_.notify_all();
+  space_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& item : ready_) {
+    done(item, Status::GeneralError("put queue stopped"));
+  }
+  for (auto& [time, item] : delayed_) {
+    (void)time;
+    done(item, Status::GeneralError("put queue stopped"));
+  }
+  ready_.clear();
+  delayed_.clear();
+  metrics_.metrics_component.UpdateAggregator();
+}
+
+std::future<Status> PutQueue::push(const Sliver& key, const Sliver& value) {
+  Item item;
+  item.key = key;
+  item.value = value;
+  item.delay = config_.initialDelay;
+  auto future = item.promise.get_future();
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_cv_.wait(lock, [this]() { return stopped_ || pending_ < std::max<std::uint32_t>(config_.capacity, 1); });
+    if (stopped_) {
+      item.promise.set_value(Status::GeneralError("put queue stopped"));
+      return future;
+    }
+    ready_.push_back(std::move(item));
+    ++pending_;
+    metrics_.pending_puts.Get().Set(pending_);
+  }
+  work_cv_.notify_one();
+  return future;
+}
+
+std::size_t PutQueue::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_;
+}
+
+void PutQueue::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopped_) {
+    // Puts whose retry is due go after the ones that are already ready
+    const auto now = Clock::now();
+    while (!delayed_.empty() && delayed_.begin()->first <= now) {
+      ready_.push_back(std::move(delayed_.begin()->second));
+      delayed_.erase(delayed_.begin());
+    }
+    if (ready_.empty()) {
+      if (delayed_.empty()) {
+        work_cv_.wait(lock);
+      } else {
+        work_cv_.wait_until(lock, delayed_.begin()->first);
+      }
+      continue;
+    }
+
+    auto item = std::move(ready_.front());
+    ready_.pop_front();
+    ++item.attempts;
+    lock.unlock();
+    const auto status = put_(item.key, item.value);
+    lock.lock();
+
+    if (status.isOK() || status.isNotFound() || item.delay >= config_.operationTimeout) {
+      if (status.isOK()) {
+        updateThroughput(item.key.length() + item.value.length(), Clock::now());
+      } else if (!status.isNotFound()) {
+        LOG_ERROR(logger_, "put failed, giving up" << KVLOG(item.key.toString(), item.attempts, status.toString()));
+        metrics_.put_failures++;
+      }
+      done(item, status);
+      metrics_.metrics_component.UpdateAggregator();
+      continue;
+    }
+    item.delay += item.attempts * config_.initialDelay;
+    LOG_WARN(logger_,
+             "put failed, retrying" << KVLOG(item.key.toString(), item.attempts, item.delay, status.toString()));
+    metrics_.put_retries++;
+    metrics_.metrics_component.UpdateAggregator();
+    const auto retry_at = Clock::now() + std::chrono::milliseconds{item.delay};
+    delayed_.emplace(retry_at, std::move(item));
+    // Workers that wait for the next retry should wake up earlier if needed
+    work_cv_.notify_all();
+  }
+}
+
+void PutQueue::done(Item& item, const Status& status) {
+  --pending_;
+  metrics_.pending_puts.Get().Set(pending_);
+  space_cv_.notify_one();
+  item.promise.set_value(status);
+}
+
+void PutQueue::updateThroughput(std::size_t bytes, Clock::time_point now) {
+  window_bytes_ += bytes;
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - window_start_).count();
+  if (elapsed < 1000) return;
+  metrics_.put_throughput.Get().Set(window_bytes_ * 1000 / elapsed);
+  window_bytes_ = 0;
+  window_start_ = now;
+}
+
+}  // namespace concord::storage::s3
@@ -0,0 +1,203 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the
+// "License").  You may not use this product except in compliance with the
+// Apache 2.0 License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include "gtest/gtest.h"
+#include "s3/put_queue.hpp"
+
+#include <atomic>
+#include <map>
+
+namespace concord::storage::s3::test {
+
+using concordUtils::Sliver;
+using concordUtils::Status;
+using namespace std::chrono_literals;
+
+// An in-memory object store that can be made slow or failing
+class FakeObjectStore {
+ public:
+  Status put(const Sliver& key, const Sliver& value) {
+    const auto in_flight = ++in_flight_;
+    for (auto max = max_in_flight_.load(); in_flight > max && !max_in_flight_.compare_exchange_weak(max, in_flight);) {
+    }
+    std::this_thread::sleep_for(latency);
+    --in_flight_;
+    ++puts_;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return !blocked; });
+    }
+    if (failures > 0 && failures-- > 0) return Status::GeneralError("injected failure");
+    if (not_found) return Status::NotFound("no such bucket");
+    std::lock_guard<std::mutex> lock(mutex_);
+    objects_[key.toString()] = value.toString();
+    return Status::OK();
+  }
+
+  void unblock() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      blocked = false;
+    }
+    cv_.notify_all();
+  }
+
+  std::string get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return objects_[key];
+  }
+
+  std::chrono::milliseconds latency{0};
+  std::atomic_int failures{0};
+  std::atomic_bool not_found{false};
+  bool blocked = false;
+
+  std::atomic_uint32_t puts_{0};
+  std::atomic_uint32_t in_flight_{0};
+  std::atomic_uint32_t max_in_flight_{0};
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<std::string, std::string> objects_;
+};
+
+class PutQueueTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<PutQueue> makeQueue(std::uint32_t workers, std::uint32_t capacity, std::uint32_t timeout = 1000) {
+    PutQueue::Config config;
+    config.workers = workers;
+    config.capacity = capacity;
+    config.initialDelay = 10;
+    config.operationTimeout = timeout;
+    return std::make_unique<PutQueue>(
+        config, [this](const Sliver& key, const Sliver& value) { return store.put(key, value); }, metrics);
+  }
+
+  FakeObjectStore store;
+  Metrics metrics;
+};
+
+TEST_F(PutQueueTest, PutsAreDoneConcurrently) {
+  store.latency = 20ms;
+  auto queue = makeQueue(8, 64);
+  std::vector<std::future<Status>> futures;
+  for (auto i = 0; i < 64; ++i) {
+    futures.push_back(queue->push(Sliver(std::to_string(i)), Sliver(std::string(i, 'v'))));
+  }
+  for (auto& f : futures) {
+    ASSERT_TRUE(f.get().isOK());
+  }
+  ASSERT_EQ(64u, store.puts_);
+  ASSERT_LE(store.max_in_flight_, 8u);
+  ASSERT_GT(store.max_in_flight_, 1u);
+  ASSERT_EQ(0u, queue->pending());
+  for (auto i = 0; i < 64; ++i) {
+    ASSERT_EQ(std::string(i, 'v'), store.get(std::to_string(i)));
+  }
+}
+
+TEST_F(PutQueueTest, PushBlocksWhenFull) {
+  store.blocked = true;
+  auto queue = makeQueue(2, 4);
+  std::vector<std::future<Status>> futures;
+  for (auto i = 0; i < 4; ++i) {
+    futures.push_back(queue->push(Sliver(std::to_string(i)), Sliver("v")));
+  }
+  ASSERT_EQ(4u, queue->pending());
+  ASSERT_EQ(4u, metrics.pending_puts.Get().Get());
+
+  std::atomic_bool pushed{false};
+  auto producer = std::thread([&]() {
+    futures.push_back(queue->push(Sliver("4"), Sliver("v")));
+    pushed = true;
+  });
+  std::this_thread::sleep_for(100ms);
+  ASSERT_FALSE(pushed);
+
+  store.unblock();
+  producer.join();
+  ASSERT_TRUE(pushed);
+  for (auto& f : futures) {
+    ASSERT_TRUE(f.get().isOK());
+  }
+  ASSERT_EQ(0u, metrics.pending_puts.Get().Get());
+}
+
+TEST_F(PutQueueTest, TransientFailuresAreRetried) {
+  store.failures = 3;
+  auto queue = makeQueue(1, 4);
+  auto f = queue->push(Sliver("key"), Sliver("value"));
+  ASSERT_TRUE(f.get().isOK());
+  ASSERT_EQ(4u, store.puts_);
+  ASSERT_EQ(3u, metrics.put_retries.Get().Get());
+  ASSERT_EQ(0u, metrics.put_failures.Get().Get());
+  ASSERT_EQ("value", store.get("key"));
+}
+
+TEST_F(PutQueueTest, RetriesDontBlockOtherPuts) {
+  store.failures = 1;
+  auto queue = makeQueue(1, 4, 10000);
+  auto failing = queue->push(Sliver("failing"), Sliver("value"));
+  // The first put fails and waits 20ms for its retry, meanwhile the second one is done by the only worker
+  auto other = queue->push(Sliver("other"), Sliver("value"));
+  ASSERT_EQ(std::future_status::ready, other.wait_for(15ms));
+  ASSERT_TRUE(other.get().isOK());
+  ASSERT_TRUE(failing.get().isOK());
+}
+
+TEST_F(PutQueueTest, PermanentFailureAfterTimeout) {
+  store.failures = 1000;
+  auto queue = makeQueue(1, 4, 100);
+  auto f = queue->push(Sliver("key"), Sliver("value"));
+  auto s = f.get();
+  ASSERT_TRUE(s.isGeneralError());
+  // The delay grows 10 -> 20 -> 40 -> 70 -> 110 ms
+  ASSERT_EQ(5u, store.puts_);
+  ASSERT_EQ(1u, metrics.put_failures.Get().Get());
+  ASSERT_EQ(0u, queue->pending());
+}
+
+TEST_F(PutQueueTest, NotFoundIsNotRetried) {
+  store.not_found = true;
+  auto queue = makeQueue(1, 4);
+  auto f = queue->push(Sliver("key"), Sliver("value"));
+  ASSERT_TRUE(f.get().isNotFound());
+  ASSERT_EQ(1u, store.puts_);
+  ASSERT_EQ(0u, metrics.put_retries.Get().Get());
+}
+
+TEST_F(PutQueueTest, PendingPutsFailOnDestruction) {
+  store.failures = 1000;
+  auto queue = makeQueue(1, 4, 60000);
+  auto f = queue->push(Sliver("key"), Sliver("value"));
+  std::this_thread::sleep_for(50ms);
+  queue.reset();
+  ASSERT_TRUE(f.get().isGeneralError());
+}
+
+TEST_F(PutQueueTest, Throughput) {
+  store.latency = 5ms;
+  auto queue = makeQueue(4, 16);
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::future<Status>> futures;
+  while (std::chrono::steady_clock::now() - start < 1200ms) {
+    futures.push_back(queue->push(Sliver("key"), Sliver(std::string(1024, 'v'))));
+  }
+  for (auto& f : futures) {
+    ASSERT_TRUE(f.get().isOK());
+  }
+  ASSERT_GT(metrics.put_throughput.Get().Get(), 0u);
+}
+
+}  // namespace concord::storage::s3::test
@@ -167,4 +167,24 @@ TEST_F(S3Test, Iterator) {
     res = it->next();
   }
 }
+
+/** @brief put many objects of different sizes concurrently through the put queue */
+TEST_F(S3Test, PutAsync) {
+  std::vector<std::pair<Sliver, Sliver>> objects;
+  std::vector<std::future<Status>> futures;
+  for (int i = 0; i < 100; ++i) {
+    std::string key("putAsyncKey" + std::to_string(i));
+    std::string val(1 << (i % 20), static_cast<char>('a' + i % 26));
+    objects.emplace_back(Sliver::copy(key.data(), key.length()), Sliver::copy(val.data(), val.length()));
+    futures.push_back(state.client->putAsync(objects.back().first, objects.back().second));
+  }
+  for (auto& f : futures) ASSERT_EQ(f.get(), Status::OK());
+
+  for (auto& [key, value] : objects) {
+    Sliver rvalue;
+    ASSERT_EQ(state.client->get(key, rvalue), Status::OK());
+    ASSERT_EQ(value, rvalue);
+    ASSERT_EQ(state.client->del(key), Status::OK());
+  }
+}
 }  // namespace concord::storage::s3::test
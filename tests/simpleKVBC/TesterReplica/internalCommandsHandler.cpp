@@ -224,14 +224,33 @@ std::string InternalCommandsHandler::getLatest(const std::string &key) const {
   return std::visit([](const auto &v) { return v.data; }, *v);
 }
 
-std::optional<BlockId> InternalCommandsHandler::getLatestVersion(const std::string &key) const {
-  const auto v = m_storage->getLatestVersion(keyToCategory(key), key);
-  if (!v) {
-    return std::nullopt;
+bool InternalCommandsHandler::hasReadSetConflict(std::vector<std::string> &keys, BlockId readVersion) {
+  m_recentWrites.sync(m_storage->getLastBlockId());
+  const auto check = m_recentWrites.writtenAfter(keys, readVersion);
+  if (check.conflict || check.unresolved.empty()) {
+    return check.conflict;
+  }
+
+  // Keys that weren't written recently are looked up with a single multi-get per category
+  auto category_keys = std::map<std::string, std::vector<std::string>>{};
+  for (const auto i : check.unresolved) {
+    category_keys[keyToCategory(keys[i])].push_back(std::move(keys[i]));
+  }
+  auto versions = std::vector<std::optional<TaggedVersion>>{};
+  for (const auto &[category, cat_keys] : category_keys) {
+    m_storage->multiGetLatestVersion(category, cat_keys, versions);
+    for (const auto &v : versions) {
+      if (!v) {
+        continue;
+      }
+      // We never delete keys in TesterReplica at that stage.
+      ConcordAssert(!v->deleted);
+      if (v->version > readVersion) {
+        return true;
+      }
+    }
   }
-  // We never delete keys in TesterReplica at that stage.
-  ConcordAssert(!v->deleted);
-  return v->version;
+  return false;
 }
 
 std::optional<std::map<std::string, std::string>> InternalCommandsHandler::getBlockUpdates(
@@ -372,11 +391,23 @@ void InternalCommandsHandler::addBlock(VersionedUpdates &verUpdates, BlockMerkle
                                std::string{public_state_ser.cbegin(), public_state_ser.cend()});
   }
   addMetadataKeyValue(internal_updates, sn);
+  auto written_keys = std::vector<std::string>{};
+  written_keys.reserve(verUpdates.size() + merkleUpdates.size());
+  for (const auto &[k, _] : verUpdates.getData().kv) {
+    (void)_;
+    written_keys.push_back(k);
+  }
+  for (const auto &[k, _] : merkleUpdates.getData().kv) {
+    (void)_;
+    written_keys.push_back(k);
+  }
   updates.add(kConcordInternalCategoryId, std::move(internal_updates));
   updates.add(VERSIONED_KV_CAT_ID, std::move(verUpdates));
   updates.add(BLOCK_MERKLE_CAT_ID, std::move(merkleUpdates));
   const auto newBlockId = m_blockAdder->add(std::move(updates));
   ConcordAssert(newBlockId == currBlock + 1);
+  m_recentWrites.sync(currBlock);
+  m_recentWrites.addBlock(newBlockId, written_keys);
 }
 
 bool InternalCommandsHandler::hasConflictInBlockAccumulatedRequests(
@@ -429,23 +460,25 @@ OperationResult InternalCommandsHandler::executeWriteCommand(uint32_t requestSiz
                << " BLOCK_ACCUMULATION_ENABLED=" << isBlockAccumulationEnabled);
   BlockId currBlock = m_storage->getLastBlockId();
 
-  // Look for conflicts
+  // Look for conflicts - first in the not yet written block accumulated requests, then in the blockchain
   bool hasConflict = false;
+  auto read_keys = std::vector<string>{};
+  read_keys.reserve(write_req.readset.size());
   for (size_t i = 0; !hasConflict && i < write_req.readset.size(); i++) {
     static_assert(
         sizeof(*(write_req.readset[i].data())) == sizeof(string::value_type),
         "Byte pointer type used by concord::kvbc::IReader, concord::kvbc::categorization::VersionedUpdates, and/or "
         "concord::kvbc::categorization::BlockMerkleUpdates is incompatible with byte pointer type used by CMF.");
-    const string key =
-        string(reinterpret_cast<const string::value_type *>(write_req.readset[i].data()), write_req.readset[i].size());
-    const auto latest_ver = getLatestVersion(key);
-    hasConflict = (latest_ver && latest_ver > write_req.read_version);
-    if (isBlockAccumulationEnabled && !hasConflict) {
-      if (hasConflictInBlockAccumulatedRequests(key, blockAccumulatedVerUpdates, blockAccumulatedMerkleUpdates)) {
-        hasConflict = true;
-      }
+    const auto &key = read_keys.emplace_back(reinterpret_cast<const string::value_type *>(write_req.readset[i].data()),
+                                             write_req.readset[i].size());
+    if (isBlockAccumulationEnabled) {
+      hasConflict =
+          hasConflictInBlockAccumulatedRequests(key, blockAccumulatedVerUpdates, blockAccumulatedMerkleUpdates);
     }
   }
+  if (!hasConflict) {
+    hasConflict = hasReadSetConflict(read_keys, write_req.read_version);
+  }
 
   if (!hasConflict) {
     if (isBlockAccumulationEnabled) {
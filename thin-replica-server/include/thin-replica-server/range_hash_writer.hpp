@@ -0,0 +1,111 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#ifndef THIN_REPLICA_RANGE_HASH_WRITER_HPP_
+#define THIN_REPLICA_RANGE_HASH_WRITER_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "crypto/openssl/crypto.hpp"
+#include "thin_replica.grpc.pb.h"
+
+namespace concord {
+namespace thin_replica {
+
+// Hash stream writer for range hash subscriptions (see
+// SubscriptionRequest::range_hash_interval). Instead of writing one hash per
+// update, the per-update hashes are collected and one range hash is written for
+// every `interval` updates. The range hash is the SHA256 hash over the
+// concatenated per-update hashes, i.e. the client can verify a range of
+// buffered updates with a single message.
+//
+// A pending range is written early if the stream switches from legacy events to
+// event groups and whenever the owner calls flush() (e.g. because there are no
+// live updates) such that the client doesn't wait for a range to fill up.
+//
+// The interval is requested by the client and is clamped to kMaxInterval, which
+// bounds the per-update hashes the server keeps per subscription. Clients accept
+// ranges that are shorter than requested.
+template <typename ServerWriterT>
+class RangeHashWriter {
+ public:
+  static constexpr uint32_t kMaxInterval = 1024;
+
+  RangeHashWriter(ServerWriterT* stream, uint32_t interval)
+      : stream_(stream), interval_(std::clamp(interval, uint32_t{1}, kMaxInterval)) {}
+
+  // Same contract as grpc::ServerWriter::Write - returns false if the stream is closed
+  bool Write(const com::vmware::concord::thin_replica::Hash& hash) {
+    const bool is_event_group = hash.has_event_group();
+    if (num_pending_ > 0 && is_event_group != is_event_group_) {
+      if (!flush()) return false;
+    }
+    const auto id = is_event_group ? hash.event_group().event_group_id() : hash.events().block_id();
+    if (num_pending_ == 0) {
+      is_event_group_ = is_event_group;
+      range_start_ = id;
+    }
+    range_end_ = id;
+    concatenated_hashes_.append(is_event_group ? hash.event_group().hash() : hash.events().hash());
+    if (++num_pending_ < interval_) {
+      return true;
+    }
+    return flush();
+  }
+
+  // Write the range hash of the pending updates, if any
+  bool flush() {
+    if (num_pending_ == 0) {
+      return true;
+    }
+    com::vmware::concord::thin_replica::Hash range_hash;
+    if (is_event_group_) {
+      range_hash.mutable_event_group()->set_event_group_id(range_end_);
+      range_hash.mutable_event_group()->set_range_start(range_start_);
+      range_hash.mutable_event_group()->set_hash(
+          concord::crypto::openssl::computeSHA256Hash(concatenated_hashes_));
+    } else {
+      range_hash.mutable_events()->set_block_id(range_end_);
+      range_hash.mutable_events()->set_range_start(range_start_);
+      range_hash.mutable_events()->set_hash(concord::crypto::openssl::computeSHA256Hash(concatenated_hashes_));
+    }
+    concatenated_hashes_.clear();
+    num_pending_ = 0;
+    return stream_->Write(range_hash);
+  }
+
+  uint32_t numPending() const { return num_pending_; }
+  uint32_t interval() const { return interval_; }
+
+ private:
+  ServerWriterT* stream_;
+  const uint32_t interval_;
+  uint32_t num_pending_{0};
+  bool is_event_group_{false};
+  uint64_t range_start_{0};
+  uint64_t range_end_{0};
+  std::string concatenated_hashes_;
+};
+
+template <typename T>
+struct IsRangeHashWriter : std::false_type {};
+template <typename ServerWriterT>
+struct IsRangeHashWriter<RangeHashWriter<ServerWriterT>> : std::true_type {};
+
+}  // namespace thin_replica
+}  // namespace concord
+
+#endif  // THIN_REPLICA_RANGE_HASH_WRITER_HPP_
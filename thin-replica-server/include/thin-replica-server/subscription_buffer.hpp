@@ -15,15 +15,22 @@
 #define CONCORD_THIN_REPLICA_SUBSCRIPTION_BUFFER_HPP_
 
 #include <categorization/updates.h>
-#include <boost/lockfree/spsc_queue.hpp>
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <tuple>
+#include <typeindex>
 #include <unordered_set>
+#include <vector>
 
 #include "log/logger.hpp"
 #include "util/assertUtils.hpp"
+#include "util/kvstream.h"
 #include "block_update/block_update.hpp"
 #include "block_update/event_group_update.hpp"
 #include "kv_types.hpp"
@@ -39,275 +46,406 @@ class ConsumerTooSlow : public std::runtime_error {
 typedef kvbc::BlockUpdate SubUpdate;
 typedef kvbc::EventGroupUpdate SubEventGroupUpdate;
 
-// Each subscriber creates its own spsc queue and puts it into the shared list
-// of subscriber buffers. This is a thread-safe implementation around boost's
-// spsc queue in order to use an additional wake-up mechanism. We expect a
-// single producer (the commands handler) and a single consumer (the subscriber
-// thread in the thin replica gRPC service).
-class SubUpdateBuffer {
+// An update which is published once and read by all subscribers. Subscribers
+// with the same filter (client id) derive the same data from an update, hence,
+// they can share the result via memoize() instead of computing it again.
+template <typename T>
+class SharedUpdate {
  public:
-  explicit SubUpdateBuffer(size_t size)
-      : logger_(logging::getLogger("concord.thin_replica.sub_buffer")),
-        queue_(size),
-        eg_queue_(size),
-        too_slow_(false),
-        eg_too_slow_(false),
-        newest_block_id_(0),
-        newest_event_group_id_(0) {}
+  explicit SharedUpdate(const T& update) : update_(update) {}
 
-  // Let's help ourselves and make sure we don't copy this buffer
-  SubUpdateBuffer(const SubUpdateBuffer&) = delete;
-  SubUpdateBuffer& operator=(const SubUpdateBuffer&) = delete;
+  SharedUpdate(const SharedUpdate&) = delete;
+  SharedUpdate& operator=(const SharedUpdate&) = delete;
 
-  // Add an update to the queue and notify waiting subscribers
-  void Push(const SubUpdate& update) {
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
-      if (!too_slow_ && !queue_.push(update)) {
-        // If we fail to push a new update (because the queue is full) we
-        // indicate that this queue is unusable and the reader should clean-up.
-        // Not stopping the subscription will lead to a failure on the consumer
-        // end (TRC) eventually. Therefore, let's stop it right here.
-        too_slow_ = true;
-        LOG_WARN(logger_, "Failed to add update. Consumer too slow.");
-      } else {
-        newest_block_id_ = update.block_id;
-      }
-    }
-    cv_.notify_one();
-  }
+  const T& get() const { return update_; }
 
-  // Add an update to the queue and notify waiting subscribers
-  void PushEventGroup(const SubEventGroupUpdate& update) {
+  // Return the result of `compute` for the given key. The first caller computes
+  // the value, concurrent callers with the same key and type wait for it.
+  template <typename V, typename ComputeT>
+  std::shared_ptr<const V> memoize(const std::string& key, ComputeT&& compute) const {
+    std::shared_ptr<MemoSlot> slot;
     {
-      std::unique_lock<std::mutex> lock(eg_mutex_);
-      if (!eg_too_slow_ && !eg_queue_.push(update)) {
-        // If we fail to push a new update (because the queue is full) we
-        // indicate that this queue is unusable and the reader should clean-up.
-        // Not stopping the subscription will lead to a failure on the consumer
-        // end (TRC) eventually. Therefore, let's stop it right here.
-        eg_too_slow_ = true;
-        LOG_WARN(logger_, "Failed to add update. Consumer too slow.");
-      } else {
-        newest_event_group_id_ = update.event_group_id;
+      std::lock_guard<std::mutex> lock(memo_mutex_);
+      auto& elem = memo_[std::make_pair(std::type_index(typeid(V)), key)];
+      if (!elem) {
+        elem = std::make_shared<MemoSlot>();
       }
+      slot = elem;
     }
-    eg_cv_.notify_one();
+    std::call_once(slot->once, [&] { slot->value = std::make_shared<const V>(compute()); });
+    return std::static_pointer_cast<const V>(slot->value);
   }
 
-  // Return the oldest update (block if queue is empty)
-  void Pop(SubUpdate& out) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    // Boost's spsc queue is wait-free but we want to block here
-    cv_.wait(lock, [this] { return too_slow_ || queue_.read_available(); });
+ private:
+  struct MemoSlot {
+    std::once_flag once;
+    std::shared_ptr<const void> value;
+  };
+
+  const T update_;
+  mutable std::mutex memo_mutex_;
+  mutable std::map<std::pair<std::type_index, std::string>, std::shared_ptr<MemoSlot>> memo_;
+};
 
-    if (too_slow_) {
-      // We throw an exception because we cannot handle the clean-up ourselves
-      // and it doesn't make sense to continue pushing/popping updates.
-      throw ConsumerTooSlow();
-    }
+typedef SharedUpdate<SubUpdate> SharedSubUpdate;
+typedef SharedUpdate<SubEventGroupUpdate> SharedSubEventGroupUpdate;
+typedef std::shared_ptr<const SharedSubUpdate> SharedSubUpdatePtr;
+typedef std::shared_ptr<const SharedSubEventGroupUpdate> SharedSubEventGroupUpdatePtr;
+
+// Fixed-size ring of shared updates with a single producer and any number of
+// readers. Every reader owns a cursor (the sequence number of the next update to
+// read) which is passed in by the caller and only modified under the ring's
+// lock. A slot is released as soon as all readers which were attached at the
+// time of publishing have read or skipped it. A reader which falls more than
+// `capacity` updates behind lost updates and is considered too slow.
+template <typename T>
+class SubUpdateRing {
+ public:
+  typedef std::shared_ptr<const SharedUpdate<T>> Entry;
 
-    ConcordAssert(queue_.pop(out));
+  explicit SubUpdateRing(size_t capacity)
+      : logger_(logging::getLogger("concord.thin_replica.sub_buffer")), slots_(capacity) {
+    ConcordAssertGT(capacity, 0);
   }
 
-  template <typename RepT, typename PeriodT>
-  bool TryPop(SubUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    // Boost's spsc queue is wait-free but we want to block here
-    cv_.wait_for(lock, timeout, [this] { return too_slow_ || queue_.read_available(); });
+  SubUpdateRing(const SubUpdateRing&) = delete;
+  SubUpdateRing& operator=(const SubUpdateRing&) = delete;
 
-    if (too_slow_) {
-      // We throw an exception because we cannot handle the clean-up ourselves
-      // and it doesn't make sense to continue pushing/popping updates.
-      throw ConsumerTooSlow();
-    }
+  size_t capacity() const { return slots_.size(); }
 
-    if (queue_.read_available()) {
-      ConcordAssert(queue_.pop(out));
-      return true;
-    }
-    return false;
+  // Register a new reader which will read updates published from now on
+  uint64_t attach() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_readers_;
+    return head_;
   }
 
-  // Return the oldest update (event group if queue is empty)
-  void PopEventGroup(SubEventGroupUpdate& out) {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // Boost's spsc queue is wait-free but we want to block here
-    eg_cv_.wait(lock, [this] { return eg_too_slow_ || eg_queue_.read_available(); });
+  // Unregister a reader and release the updates it didn't read
+  void detach(const uint64_t& cursor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ConcordAssertGT(num_readers_, 0);
+    release(cursor, head_);
+    --num_readers_;
+  }
 
-    if (eg_too_slow_) {
-      // We throw an exception because we cannot handle the clean-up ourselves
-      // and it doesn't make sense to continue pushing/popping updates.
-      throw ConsumerTooSlow();
+  size_t numReaders() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_readers_;
+  }
+
+  // Make the update available to all attached readers
+  void publish(Entry entry) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (num_readers_ == 0) {
+        return;
+      }
+      auto& slot = slots_[head_ % slots_.size()];
+      slot.entry = std::move(entry);
+      slot.pending_readers = num_readers_;
+      ++head_;
     }
+    cv_.notify_all();
+  }
 
-    ConcordAssert(eg_queue_.pop(out));
+  // Return the oldest unread update (block if there is none)
+  Entry pop(uint64_t& cursor) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return head_ > cursor; });
+    return next(cursor);
   }
 
   template <typename RepT, typename PeriodT>
-  bool TryPopEventGroup(SubEventGroupUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // Boost's spsc queue is wait-free but we want to block here
-    eg_cv_.wait_for(lock, timeout, [this] { return eg_too_slow_ || eg_queue_.read_available(); });
-
-    if (eg_too_slow_) {
-      // We throw an exception because we cannot handle the clean-up ourselves
-      // and it doesn't make sense to continue pushing/popping updates.
-      throw ConsumerTooSlow();
-    }
-
-    if (eg_queue_.read_available()) {
-      ConcordAssert(eg_queue_.pop(out));
-      return true;
+  bool tryPop(uint64_t& cursor, Entry& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cv_.wait_for(lock, timeout, [&] { return head_ > cursor; })) {
+      return false;
     }
-    return false;
+    out = next(cursor);
+    return true;
   }
 
-  void waitUntilNonEmpty() {
+  void waitUntilNonEmpty(const uint64_t& cursor) {
     std::unique_lock<std::mutex> lock(mutex_);
-    cv_.wait(lock, [this] { return queue_.read_available(); });
+    cv_.wait(lock, [&] { return head_ > cursor; });
   }
 
   template <typename RepT, typename PeriodT>
-  [[nodiscard]] bool waitUntilNonEmpty(const std::chrono::duration<RepT, PeriodT>& duration) {
+  bool waitUntilNonEmpty(const uint64_t& cursor, const std::chrono::duration<RepT, PeriodT>& duration) {
     std::unique_lock<std::mutex> lock(mutex_);
-    return cv_.wait_for(lock, duration, [this] { return queue_.read_available(); });
+    return cv_.wait_for(lock, duration, [&] { return head_ > cursor; });
   }
 
-  void waitForEventGroupUntilNonEmpty() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    eg_cv_.wait(lock, [this] { return eg_queue_.read_available(); });
+  // Skip all unread updates
+  void skipAll(uint64_t& cursor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    release(cursor, head_);
+    cursor = head_;
   }
 
-  template <typename RepT, typename PeriodT>
-  [[nodiscard]] bool waitForEventGroupUntilNonEmpty(const std::chrono::duration<RepT, PeriodT>& duration) {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    return eg_cv_.wait_for(lock, duration, [this] { return eg_queue_.read_available(); });
+  // The caller needs to make sure that there are unread updates
+  Entry oldest(const uint64_t& cursor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ConcordAssertGT(head_, cursor);
+    throwIfLagging(cursor);
+    return slots_[cursor % slots_.size()].entry;
   }
 
-  // This is not thread-safe and the caller has to make sure that there is no
-  // writer or reader active. This is a trade-off in order to stay lock-free.
-  void removeAllUpdates() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    queue_.reset();
+  // The caller needs to make sure that there are unread updates
+  Entry newest(const uint64_t& cursor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ConcordAssertGT(head_, cursor);
+    return slots_[(head_ - 1) % slots_.size()].entry;
   }
 
-  // This is not thread-safe and the caller has to make sure that there is no
-  // writer or reader active. This is a trade-off in order to stay lock-free.
-  void removeAllEventGroupUpdates() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    eg_queue_.reset();
+  // Number of unread updates which are still available
+  size_t size(const uint64_t& cursor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::min<uint64_t>(head_ - cursor, slots_.size());
   }
 
-  // The caller needs to make sure that the queue is not empty when calling
-  kvbc::BlockId newestBlockId() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    // We cannot reach the newest element without consuming the others. Hence,
-    // the counter is a workaround but it requires that there is at least one
-    // element in the queue.
-    ConcordAssertGT(queue_.read_available(), 0);
-    return newest_block_id_;
+  bool full(const uint64_t& cursor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return head_ - cursor >= slots_.size();
+  }
+
+ private:
+  struct Slot {
+    Entry entry;
+    // Number of readers which still need to read this update
+    size_t pending_readers{0};
+  };
+
+  // Requires the lock
+  void throwIfLagging(const uint64_t& cursor) {
+    if (head_ - cursor > slots_.size()) {
+      // The update at the cursor was overwritten already. We throw an exception
+      // because we cannot handle the clean-up ourselves and it doesn't make
+      // sense to continue. Not stopping the subscription will lead to a failure
+      // on the consumer end (TRC) eventually.
+      LOG_WARN(logger_, "Reader lost updates. Consumer too slow." << KVLOG(head_, cursor));
+      throw ConsumerTooSlow();
+    }
   }
 
-  // The caller needs to make sure that the queue is not empty when calling
-  kvbc::EventGroupId newestEventGroupId() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // We cannot reach the newest element without consuming the others. Hence,
-    // the counter is a workaround but it requires that there is at least one
-    // element in the queue.
-    ConcordAssertGT(eg_queue_.read_available(), 0);
-    return newest_event_group_id_;
+  // Requires the lock and an unread update
+  Entry next(uint64_t& cursor) {
+    throwIfLagging(cursor);
+    auto& slot = slots_[cursor % slots_.size()];
+    auto entry = slot.entry;
+    if (--slot.pending_readers == 0) {
+      slot.entry.reset();
+    }
+    ++cursor;
+    return entry;
   }
 
-  // The caller needs to make sure that the queue is not empty when calling
-  kvbc::BlockId oldestBlockId() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    // Undefined behavior if the queue is empty
-    ConcordAssertGT(queue_.read_available(), 0);
-    return queue_.front().block_id;
+  // Requires the lock
+  void release(uint64_t from, uint64_t to) {
+    // Overwritten slots belong to newer updates
+    if (head_ - from > slots_.size()) {
+      from = head_ - slots_.size();
+    }
+    for (auto i = from; i < to; ++i) {
+      auto& slot = slots_[i % slots_.size()];
+      if (--slot.pending_readers == 0) {
+        slot.entry.reset();
+      }
+    }
   }
 
-  // The caller needs to make sure that the queue is not empty when calling
-  kvbc::EventGroupId oldestEventGroupId() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // Undefined behavior if the queue is empty
-    ConcordAssertGT(eg_queue_.read_available(), 0);
-    return eg_queue_.front().event_group_id;
+  logging::Logger logger_;
+  std::vector<Slot> slots_;
+  // Sequence number of the next update to be published
+  uint64_t head_{0};
+  size_t num_readers_{0};
+  // lock used for the slots as well as the variables above and all cursors
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+typedef SubUpdateRing<SubUpdate> SubUpdateRingT;
+typedef SubUpdateRing<SubEventGroupUpdate> SubEventGroupUpdateRingT;
+
+// Each subscriber reads updates through its own buffer. A buffer is a pair of
+// cursors into rings of shared updates (one for blocks and one for event
+// groups). Buffers created by the subscriber list read from the list's rings,
+// so that an update is published once for all subscribers. A buffer created
+// with a size owns its rings and only sees updates pushed to it directly. We
+// expect a single producer (the commands handler) and a single consumer (the
+// subscriber thread in the thin replica gRPC service) per buffer.
+class SubUpdateBuffer {
+ public:
+  explicit SubUpdateBuffer(size_t size)
+      : SubUpdateBuffer(std::make_shared<SubUpdateRingT>(size), std::make_shared<SubEventGroupUpdateRingT>(size)) {}
+
+  SubUpdateBuffer(std::shared_ptr<SubUpdateRingT> ring, std::shared_ptr<SubEventGroupUpdateRingT> eg_ring)
+      : ring_(std::move(ring)),
+        eg_ring_(std::move(eg_ring)),
+        cursor_(ring_->attach()),
+        eg_cursor_(eg_ring_->attach()) {}
+
+  ~SubUpdateBuffer() {
+    ring_->detach(cursor_);
+    eg_ring_->detach(eg_cursor_);
   }
 
-  // The caller needs to make sure that the queue is not empty when calling
-  SubEventGroupUpdate oldestEventGroup() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    // Undefined behavior if the queue is empty
-    ConcordAssertGT(eg_queue_.read_available(), 0);
-    return eg_queue_.front();
+  // Let's help ourselves and make sure we don't copy this buffer
+  SubUpdateBuffer(const SubUpdateBuffer&) = delete;
+  SubUpdateBuffer& operator=(const SubUpdateBuffer&) = delete;
+
+  // Add an update and notify waiting subscribers
+  // Note: If the buffer reads from shared rings then all of their readers will
+  // see the update.
+  void Push(const SubUpdate& update) { PushShared(std::make_shared<const SharedSubUpdate>(update)); }
+  void PushShared(SharedSubUpdatePtr update) { ring_->publish(std::move(update)); }
+
+  // Add an update and notify waiting subscribers
+  void PushEventGroup(const SubEventGroupUpdate& update) {
+    PushSharedEventGroup(std::make_shared<const SharedSubEventGroupUpdate>(update));
   }
+  void PushSharedEventGroup(SharedSubEventGroupUpdatePtr update) { eg_ring_->publish(std::move(update)); }
 
-  bool Empty() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return !queue_.read_available();
+  // Return the oldest update (block if buffer is empty)
+  void Pop(SubUpdate& out) { out = ring_->pop(cursor_)->get(); }
+  void PopShared(SharedSubUpdatePtr& out) { out = ring_->pop(cursor_); }
+
+  template <typename RepT, typename PeriodT>
+  bool TryPop(SubUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
+    SharedSubUpdatePtr update;
+    if (!TryPopShared(update, timeout)) {
+      return false;
+    }
+    out = update->get();
+    return true;
   }
 
-  bool EmptyEventGroupQueue() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    return !eg_queue_.read_available();
+  // Return the oldest update without copying it
+  template <typename RepT, typename PeriodT>
+  bool TryPopShared(SharedSubUpdatePtr& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
+    return ring_->tryPop(cursor_, out, timeout);
   }
 
-  bool Full() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return !queue_.write_available();
+  // Return the oldest update (event group if buffer is empty)
+  void PopEventGroup(SubEventGroupUpdate& out) { out = eg_ring_->pop(eg_cursor_)->get(); }
+  void PopSharedEventGroup(SharedSubEventGroupUpdatePtr& out) { out = eg_ring_->pop(eg_cursor_); }
+
+  template <typename RepT, typename PeriodT>
+  bool TryPopEventGroup(SubEventGroupUpdate& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
+    SharedSubEventGroupUpdatePtr update;
+    if (!TryPopSharedEventGroup(update, timeout)) {
+      return false;
+    }
+    out = update->get();
+    return true;
   }
 
-  bool FullEventGroupQueue() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    return !eg_queue_.write_available();
+  // Return the oldest event group without copying it
+  template <typename RepT, typename PeriodT>
+  bool TryPopSharedEventGroup(SharedSubEventGroupUpdatePtr& out, const std::chrono::duration<RepT, PeriodT>& timeout) {
+    return eg_ring_->tryPop(eg_cursor_, out, timeout);
   }
 
-  // Return the number of elements in the queue
-  size_t Size() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return queue_.read_available();
+  void waitUntilNonEmpty() { ring_->waitUntilNonEmpty(cursor_); }
+
+  template <typename RepT, typename PeriodT>
+  [[nodiscard]] bool waitUntilNonEmpty(const std::chrono::duration<RepT, PeriodT>& duration) {
+    return ring_->waitUntilNonEmpty(cursor_, duration);
   }
 
-  // Return the number of elements in the queue
-  size_t SizeEventGroupQueue() {
-    std::unique_lock<std::mutex> lock(eg_mutex_);
-    return eg_queue_.read_available();
+  void waitForEventGroupUntilNonEmpty() { eg_ring_->waitUntilNonEmpty(eg_cursor_); }
+
+  template <typename RepT, typename PeriodT>
+  [[nodiscard]] bool waitForEventGroupUntilNonEmpty(const std::chrono::duration<RepT, PeriodT>& duration) {
+    return eg_ring_->waitUntilNonEmpty(eg_cursor_, duration);
+  }
+
+  // Skip all unread updates. The caller has to make sure that there is no
+  // reader active.
+  void removeAllUpdates() { ring_->skipAll(cursor_); }
+
+  // Skip all unread event groups. The caller has to make sure that there is no
+  // reader active.
+  void removeAllEventGroupUpdates() { eg_ring_->skipAll(eg_cursor_); }
+
+  // The caller needs to make sure that the buffer is not empty when calling
+  kvbc::BlockId newestBlockId() { return ring_->newest(cursor_)->get().block_id; }
+
+  // The caller needs to make sure that the buffer is not empty when calling
+  kvbc::EventGroupId newestEventGroupId() { return eg_ring_->newest(eg_cursor_)->get().event_group_id; }
+
+  // The caller needs to make sure that the buffer is not empty when calling
+  kvbc::BlockId oldestBlockId() { return ring_->oldest(cursor_)->get().block_id; }
+
+  // The caller needs to make sure that the buffer is not empty when calling
+  kvbc::EventGroupId oldestEventGroupId() { return eg_ring_->oldest(eg_cursor_)->get().event_group_id; }
+
+  // The caller needs to make sure that the buffer is not empty when calling
+  SubEventGroupUpdate oldestEventGroup() { return eg_ring_->oldest(eg_cursor_)->get(); }
+
+  // The caller needs to make sure that the buffer is not empty when calling
+  SharedSubEventGroupUpdatePtr oldestSharedEventGroup() { return eg_ring_->oldest(eg_cursor_); }
+
+  bool Empty() { return ring_->size(cursor_) == 0; }
+
+  bool EmptyEventGroupQueue() { return eg_ring_->size(eg_cursor_) == 0; }
+
+  bool Full() { return ring_->full(cursor_); }
+
+  bool FullEventGroupQueue() { return eg_ring_->full(eg_cursor_); }
+
+  // Return the number of unread updates
+  size_t Size() { return ring_->size(cursor_); }
+
+  // Return the number of unread event groups
+  size_t SizeEventGroupQueue() { return eg_ring_->size(eg_cursor_); }
+
+  // Whether this buffer reads from the given rings
+  bool readsFrom(const std::shared_ptr<SubUpdateRingT>& ring,
+                 const std::shared_ptr<SubEventGroupUpdateRingT>& eg_ring) const {
+    return ring_ == ring && eg_ring_ == eg_ring;
   }
 
  private:
-  logging::Logger logger_;
-  boost::lockfree::spsc_queue<SubUpdate> queue_;
-  boost::lockfree::spsc_queue<SubEventGroupUpdate> eg_queue_;
-  // lock used for updating the queue as well as the variables below
-  std::mutex mutex_;
-  std::condition_variable cv_;
-  std::mutex eg_mutex_;
-  std::condition_variable eg_cv_;
-
-  // Indidcate whether the consumer doesn't read fast enough
-  bool too_slow_;
-  bool eg_too_slow_;
-  uint64_t newest_block_id_;
-  uint64_t newest_event_group_id_;
+  std::shared_ptr<SubUpdateRingT> ring_;
+  std::shared_ptr<SubEventGroupUpdateRingT> eg_ring_;
+  // Owned by the consumer but only accessed under the ring's lock
+  uint64_t cursor_;
+  uint64_t eg_cursor_;
 };
 
-// Thread-safe list implementation which manages subscriber queues. You can
+// Thread-safe list implementation which manages subscriber buffers. You can
 // think of this list as the list of subscribers whereby each subscriber is
-// represented by its spsc queue. The presence or absence of a buffer determines
+// represented by its buffer. The presence or absence of a buffer determines
 // whether a subscriber is subscribed or unsubscribed respectively.
+//
+// Updates are copied once into a shared, refcounted entry and published into
+// the list's rings which are read by all buffers created via createBuffer().
+// Hence, the cost of an update doesn't depend on the number of subscribers.
+// Buffers which own their rings are supported but need an extra push each.
 class SubBufferList {
  public:
-  SubBufferList() {}
+  static constexpr size_t kDefaultCapacity{1000u};
+
+  explicit SubBufferList(size_t capacity = kDefaultCapacity)
+      : ring_(std::make_shared<SubUpdateRingT>(capacity)),
+        eg_ring_(std::make_shared<SubEventGroupUpdateRingT>(capacity)) {}
 
   // Let's help ourselves and make sure we don't copy this list
   SubBufferList(const SubBufferList&) = delete;
   SubBufferList& operator=(const SubBufferList&) = delete;
 
+  // Create a buffer which reads from the list's rings starting with the next
+  // update. The buffer still needs to be added to the list.
+  std::shared_ptr<SubUpdateBuffer> createBuffer() { return std::make_shared<SubUpdateBuffer>(ring_, eg_ring_); }
+
   // Add a subscriber
   virtual bool addBuffer(std::shared_ptr<SubUpdateBuffer> elem) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto success = subscriber_.insert(elem).second;
+    if (success && !elem->readsFrom(ring_, eg_ring_)) {
+      private_subscriber_.insert(elem);
+    }
     return success;
   }
 
@@ -316,23 +454,25 @@ class SubBufferList {
     std::lock_guard<std::mutex> lock(mutex_);
     // If the assert fires then there is a logic error somewhere
     ConcordAssertEQ(subscriber_.erase(elem), 1);
+    private_subscriber_.erase(elem);
   }
 
   // Populate updates to all subscribers
-  // Note: This is potentially expensive depending on the update size and the
-  // number of subscribers. If TRC/TRS stays then we might want to think about
-  // an optimization.
   virtual void updateSubBuffers(SubUpdate& update) {
+    auto entry = std::make_shared<const SharedSubUpdate>(update);
     std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& it : subscriber_) {
-      it->Push(update);
+    ring_->publish(entry);
+    for (const auto& it : private_subscriber_) {
+      it->PushShared(entry);
     }
   }
 
   virtual void updateEventGroupSubBuffers(SubEventGroupUpdate& update) {
+    auto entry = std::make_shared<const SharedSubEventGroupUpdate>(update);
     std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& it : subscriber_) {
-      it->PushEventGroup(update);
+    eg_ring_->publish(entry);
+    for (const auto& it : private_subscriber_) {
+      it->PushSharedEventGroup(entry);
     }
   }
 
@@ -344,7 +484,11 @@ class SubBufferList {
   virtual ~SubBufferList() = default;
 
  protected:
+  std::shared_ptr<SubUpdateRingT> ring_;
+  std::shared_ptr<SubEventGroupUpdateRingT> eg_ring_;
   std::unordered_set<std::shared_ptr<SubUpdateBuffer>> subscriber_;
+  // Subscribers which don't read from the shared rings
+  std::unordered_set<std::shared_ptr<SubUpdateBuffer>> private_subscriber_;
   std::mutex mutex_;
 };
 
@@ -39,6 +39,7 @@
 #include "crypto/openssl/certificates.hpp"
 
 #include "thin_replica.grpc.pb.h"
+#include "range_hash_writer.hpp"
 #include "subscription_buffer.hpp"
 #include "trs_metrics.hpp"
 #include "util/filesystem.hpp"
@@ -60,9 +61,9 @@ struct ThinReplicaServerConfig {
   const std::string tls_trs_cert_path;
   // read-only storage is a concord key-value blockchain's read interface
   const concord::kvbc::IReader* rostorage;
-  // subscriber_list is a list of subscribers where each subscriber is an spsc
-  // queue. The updates are produced by the commands handler (single producer).
-  // and consumed by the subscribers (single consumer) in the subscriber_list.
+  // subscriber_list is a list of subscribers where each subscriber reads from
+  // a shared ring of updates. The updates are produced by the commands handler
+  // (single producer) and consumed by the subscribers in the subscriber_list.
   // TRS acts as an intermediary, it waits for updates, filters them and sends
   // them to the subscribers.
   SubBufferList& subscriber_list;
@@ -114,7 +115,6 @@ class ThinReplicaImpl {
   };
 
   using KvbAppFilterPtr = std::shared_ptr<kvbc::KvbAppFilter>;
-  static constexpr size_t kSubUpdateBufferSize{1000u};
   const std::chrono::milliseconds kWaitForUpdateTimeout{100};
   const std::string kCorrelationIdTag = "cid";
   // last timestamp when subscription status for live updates was not ok
@@ -255,6 +255,15 @@ class ThinReplicaImpl {
   grpc::Status SubscribeToUpdates(ServerContextT* context,
                                   const com::vmware::concord::thin_replica::SubscriptionRequest* request,
                                   ServerWriterT* stream) {
+    if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Hash>() &&
+                  !IsRangeHashWriter<ServerWriterT>::value) {
+      if (request->range_hash_interval() > 0) {
+        RangeHashWriter<ServerWriterT> range_stream(stream, request->range_hash_interval());
+        return SubscribeToUpdates<ServerContextT, RangeHashWriter<ServerWriterT>, DataT>(
+            context, request, &range_stream);
+      }
+    }
+
     std::string stream_type;
     if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Data>()) {
       stream_type = "data";
@@ -379,10 +388,10 @@ class ThinReplicaImpl {
           }
           is_update_available = live_updates->waitUntilNonEmpty(kWaitForUpdateTimeout);
           if (is_update_available && live_updates->oldestBlockId() < last_block_id + 1) {
-            SubUpdate update;
-            live_updates->Pop(update);
+            SharedSubUpdatePtr update;
+            live_updates->PopShared(update);
             LOG_DEBUG(logger_,
-                      "Dropping block ID: " << update.block_id << " from live_updates, requested block ID: "
+                      "Dropping block ID: " << update->get().block_id << " from live_updates, requested block ID: "
                                             << request->events().block_id());
             is_update_available = false;
           }
@@ -420,43 +429,48 @@ class ThinReplicaImpl {
         return grpc::Status(grpc::StatusCode::UNKNOWN, msg.str());
       }
       // Read, filter, and send live updates
-      SubUpdate update;
+      // Note: Live updates are shared with all subscribers. Filter results and responses only depend on the client id,
+      // hence, they are computed once per update and client.
+      SharedSubUpdatePtr update;
+      const auto client_id = getClientId(context);
       try {
         while (!context->IsCancelled() && !is_event_group_transition) {
           metrics.queue_size.Get().Set(live_updates->Size());
           bool is_update_available = false;
-          is_update_available = live_updates->TryPop(update, kWaitForUpdateTimeout);
+          is_update_available = live_updates->TryPopShared(update, kWaitForUpdateTimeout);
           if (not is_update_available) {
+            flushRangeHash(stream);
             continue;
           }
-          auto kvb_update =
-              kvbc::KvbUpdate{update.block_id, update.correlation_id, std::move(update.immutable_kv_pairs)};
-          const auto& filtered_update = kvb_filter->filterUpdate(kvb_update);
-          const auto num_events = filtered_update.kv_pairs.size();
-          const auto block_id = filtered_update.block_id;
-          const auto client_id = getClientId(context);
+          const auto filtered_update = filterSharedUpdate(update, kvb_filter, client_id);
+          const auto num_events = filtered_update->kv_pairs.size();
+          const auto block_id = filtered_update->block_id;
           if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Data>()) {
             LOG_DEBUG(logger_, "Sending updates (live, data)" << KVLOG(client_id, block_id, num_events));
-            auto correlation_id = filtered_update.correlation_id;
-            if (update.parent_span) {
-              sendData(stream, filtered_update, {*update.parent_span});
+            const auto& parent_span = update->get().parent_span;
+            if (parent_span) {
+              sendSharedData(stream, update, client_id, *filtered_update, *parent_span);
             } else {
-              std::string propagated_span_context;
 #ifdef USE_OPENTRACING
+              // Every subscriber starts its own span, hence, the response cannot be shared
+              auto correlation_id = filtered_update->correlation_id;
               auto span = opentracing::Tracer::Global()->StartSpan(
                   "trs_stream_update", {opentracing::SetTag{kCorrelationIdTag, correlation_id}});
               std::ostringstream context;
               const opentracing::Span& span_to_serialize = *span;
               span_to_serialize.tracer().Inject(span_to_serialize.context(), context);
-              propagated_span_context = context.str();
+              sendData(stream, *filtered_update, {context.str()});
+#else
+              sendSharedData(stream, update, client_id, *filtered_update, std::string{});
 #endif
-              sendData(stream, filtered_update, {propagated_span_context});
             }
           } else if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Hash>()) {
             LOG_DEBUG(logger_, "Sending updates (live, hash)" << KVLOG(client_id, block_id, num_events));
-            sendHash(stream, update.block_id, kvb_filter->hashUpdate(filtered_update));
+            auto update_hash = update->memoize<std::string>(
+                client_id, [&kvb_filter, &filtered_update] { return kvb_filter->hashUpdate(*filtered_update); });
+            sendHash(stream, block_id, *update_hash);
           }
-          metrics.last_sent_block_id.Get().Set(update.block_id);
+          metrics.last_sent_block_id.Get().Set(block_id);
           metrics.num_storage_reads += kvb_filter->num_storage_reads;
           if (++update_aggregator_counter == config_->update_metrics_aggregator_thresh) {
             metrics.updateAggregator();
@@ -519,46 +533,50 @@ class ThinReplicaImpl {
     }
 
     // Read, filter, and send live updates
-    SubEventGroupUpdate sub_eg_update;
+    SharedSubEventGroupUpdatePtr sub_eg_update;
+    const auto client_id = getClientId(context);
     try {
       while (not context->IsCancelled()) {
         metrics.queue_size.Get().Set(live_updates->SizeEventGroupQueue());
         bool is_update_available = false;
-        is_update_available = live_updates->TryPopEventGroup(sub_eg_update, kWaitForUpdateTimeout);
+        is_update_available = live_updates->TryPopSharedEventGroup(sub_eg_update, kWaitForUpdateTimeout);
         if (not is_update_available) {
+          flushRangeHash(stream);
           continue;
         }
         const auto& [last_ext_eg_id_read, last_global_eg_id_read] = kvb_filter->getLastEgIdsRead();
+        const auto global_eg_id = sub_eg_update->get().event_group_id;
         // Event group read from live update queue should always be greater than last global event group ID read and
         // sent
-        ConcordAssertGT(sub_eg_update.event_group_id, last_global_eg_id_read);
-
-        auto eg_update = kvbc::EgUpdate{sub_eg_update.event_group_id, std::move(sub_eg_update.event_group)};
+        ConcordAssertGT(global_eg_id, last_global_eg_id_read);
 
         auto next_ext_eg_id = last_ext_eg_id_read + 1;
-        // TODO (Shruti):
-        // We read and filter the first event group for the client from the live update queue twice.
-        // Once in syncAndSendEventGroups() and once here. Do this only once.
-        auto filtered_eg_update = kvb_filter->filterEventGroupUpdate(eg_update);
-        if (!filtered_eg_update) {
+        // The filter result is shared with syncAndSendEventGroups() and other subscribers of the same client
+        auto filtered_eg_update = filterSharedEventGroupUpdate(sub_eg_update, kvb_filter, client_id);
+        if (!*filtered_eg_update) {
           metrics.num_skipped_event_groups++;
           continue;
         }
-        // Overwrite event group ID in the filtered update to external event group ID
-        // We don't want to expose the global event group ID to the client
-        filtered_eg_update.value().event_group_id = next_ext_eg_id;
 
+        // The response carries the external event group ID
+        // We don't want to expose the global event group ID to the client
+        const auto response_key = client_id + '#' + std::to_string(next_ext_eg_id);
+        const auto& event_group = filtered_eg_update->value().event_group;
         if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Data>()) {
-          sendEventGroupData(stream, filtered_eg_update.value(), sub_eg_update.parent_span);
+          auto data = sub_eg_update->memoize<com::vmware::concord::thin_replica::Data>(response_key, [&] {
+            return makeEventGroupData(next_ext_eg_id, event_group, sub_eg_update->get().parent_span);
+          });
+          writeData(stream, *data);
         } else if constexpr (std::is_same<DataT, com::vmware::concord::thin_replica::Hash>()) {
-          sendEventGroupHash(stream,
-                             filtered_eg_update.value().event_group_id,
-                             kvb_filter->hashEventGroupUpdate(filtered_eg_update.value()));
+          auto eg_hash = sub_eg_update->memoize<std::string>(response_key, [&] {
+            return kvb_filter->hashEventGroupUpdate(kvbc::KvbFilteredEventGroupUpdate{next_ext_eg_id, event_group});
+          });
+          sendEventGroupHash(stream, next_ext_eg_id, *eg_hash);
         }
 
-        kvb_filter->setLastEgIdsRead(next_ext_eg_id, sub_eg_update.event_group_id);
+        kvb_filter->setLastEgIdsRead(next_ext_eg_id, global_eg_id);
 
-        metrics.last_sent_event_group_id.Get().Set(filtered_eg_update.value().event_group_id);
+        metrics.last_sent_event_group_id.Get().Set(next_ext_eg_id);
         metrics.num_storage_reads += kvb_filter->num_storage_reads;
         if (++update_aggregator_counter == config_->update_metrics_aggregator_thresh) {
           metrics.updateAggregator();
@@ -962,6 +980,7 @@ class ThinReplicaImpl {
       if (context->IsCancelled()) {
         throw StreamCancelled("StreamCancelled while waiting for the first live update");
       }
+      if (not is_update_available) flushRangeHash(stream);
       // If event groups are enabled then all live updates will be event groups but they won't show up in the legacy
       // event queue. Therefore, let's query storage directly.
       if (kvb_filter->getOldestEventGroupBlockId()) {
@@ -992,11 +1011,11 @@ class ThinReplicaImpl {
     // If we read updates from KVB that were added to the live updates already
     // then we just need to drop the overlap and return
     ConcordAssertLE(live_updates->oldestBlockId(), end);
-    SubUpdate update;
+    SharedSubUpdatePtr update;
     do {
-      live_updates->Pop(update);
-      LOG_DEBUG(logger_, "Sync dropping " << update.block_id);
-    } while (update.block_id < end);
+      live_updates->PopShared(update);
+      LOG_DEBUG(logger_, "Sync dropping " << update->get().block_id);
+    } while (update->get().block_id < end);
   }
 
   // Read from KVB until we are in sync with the live updates. This function
@@ -1041,14 +1060,17 @@ class ThinReplicaImpl {
       if (context->IsCancelled()) {
         throw StreamCancelled("StreamCancelled while waiting for the first live update");
       }
-      if (not is_update_available) continue;
+      if (not is_update_available) {
+        flushRangeHash(stream);
+        continue;
+      }
 
       // Drop all live updates with global_eg_id < next_global_eg_id_to_read, because TRS has already read and sent
       // these updates from storage
       if (live_updates->oldestEventGroupId() < next_global_eg_id_to_read) {
-        SubEventGroupUpdate sub_eg_update;
-        live_updates->PopEventGroup(sub_eg_update);
-        LOG_DEBUG(logger_, "Sync dropping " << sub_eg_update.event_group_id);
+        SharedSubEventGroupUpdatePtr sub_eg_update;
+        live_updates->PopSharedEventGroup(sub_eg_update);
+        LOG_DEBUG(logger_, "Sync dropping " << sub_eg_update->get().event_group_id);
         is_update_available = false;
         continue;
       }
@@ -1059,11 +1081,12 @@ class ThinReplicaImpl {
       // If the oldest live update is not for the requesting client, keep reading from the live update queue
       // until the first relevant live update is reached. Drop all non-relevant live updates read along the way.
       if (live_updates->oldestEventGroupId() == next_global_eg_id_to_read) {
-        auto filtered_eg_update = kvb_filter->filterEventGroupUpdate(live_updates->oldestEventGroup());
-        if (!filtered_eg_update) {
-          SubEventGroupUpdate sub_eg_update;
-          live_updates->PopEventGroup(sub_eg_update);
-          LOG_DEBUG(logger_, "Sync dropping upon filtering " << sub_eg_update.event_group_id);
+        auto filtered_eg_update =
+            filterSharedEventGroupUpdate(live_updates->oldestSharedEventGroup(), kvb_filter, getClientId(context));
+        if (!*filtered_eg_update) {
+          SharedSubEventGroupUpdatePtr sub_eg_update;
+          live_updates->PopSharedEventGroup(sub_eg_update);
+          LOG_DEBUG(logger_, "Sync dropping upon filtering " << sub_eg_update->get().event_group_id);
           is_update_available = false;
           next_global_eg_id_to_read += 1;
           metrics.num_skipped_event_groups++;
@@ -1113,11 +1136,51 @@ class ThinReplicaImpl {
     ConcordAssertEQ(next_global_eg_id_to_read, live_updates->oldestEventGroupId());
   }
 
+  // Filter a live update once per client and share the result with all of the client's subscribers
+  std::shared_ptr<const kvbc::KvbFilteredUpdate> filterSharedUpdate(const SharedSubUpdatePtr& update,
+                                                                    KvbAppFilterPtr& kvb_filter,
+                                                                    const std::string& client_id) {
+    return update->memoize<kvbc::KvbFilteredUpdate>(
+        client_id, [&kvb_filter, &update] { return kvb_filter->filterUpdate(update->get()); });
+  }
+
+  // Filter a live event group once per client and share the result with all of the client's subscribers
+  // Note: The filtered event group carries the global event group ID
+  std::shared_ptr<const std::optional<kvbc::KvbFilteredEventGroupUpdate>> filterSharedEventGroupUpdate(
+      const SharedSubEventGroupUpdatePtr& update, KvbAppFilterPtr& kvb_filter, const std::string& client_id) {
+    return update->memoize<std::optional<kvbc::KvbFilteredEventGroupUpdate>>(
+        client_id, [&kvb_filter, &update] { return kvb_filter->filterEventGroupUpdate(update->get()); });
+  }
+
+  // Build the response for a live update once per client and span
+  template <typename ServerWriterT>
+  void sendSharedData(ServerWriterT* stream,
+                      const SharedSubUpdatePtr& update,
+                      const std::string& client_id,
+                      const kvbc::KvbFilteredUpdate& filtered_update,
+                      const std::string& span) {
+    auto data = update->memoize<com::vmware::concord::thin_replica::Data>(
+        client_id + '#' + span, [this, &filtered_update, &span] { return makeData(filtered_update, span); });
+    writeData(stream, *data);
+  }
+
+  template <typename ServerWriterT>
+  void writeData(ServerWriterT* stream, const com::vmware::concord::thin_replica::Data& data) {
+    if (!stream->Write(data)) {
+      throw StreamClosed(data.has_event_group() ? "Data event group stream closed" : "Data stream closed");
+    }
+  }
+
   // Send* prepares the response object and puts it on the stream
   template <typename ServerWriterT>
   void sendData(ServerWriterT* stream,
                 const kvbc::KvbFilteredUpdate& update,
                 const std::optional<std::string>& span = std::nullopt) {
+    writeData(stream, makeData(update, span));
+  }
+
+  com::vmware::concord::thin_replica::Data makeData(const kvbc::KvbFilteredUpdate& update,
+                                                    const std::optional<std::string>& span) {
     com::vmware::concord::thin_replica::Data data;
     LOG_DEBUG(logger_, "sendData for block " << update.block_id);
     data.mutable_events()->set_block_id(update.block_id);
@@ -1132,9 +1195,7 @@ class ThinReplicaImpl {
     if (span) {
       data.mutable_events()->set_span_context(*span);
     }
-    if (!stream->Write(data)) {
-      throw StreamClosed("Data stream closed");
-    }
+    return data;
   }
 
   // Send* prepares the response object and puts it on the stream
@@ -1142,23 +1203,27 @@ class ThinReplicaImpl {
   void sendEventGroupData(ServerWriterT* stream,
                           const kvbc::KvbFilteredEventGroupUpdate& eg_update,
                           const std::optional<std::string>& span = std::nullopt) {
+    writeData(stream, makeEventGroupData(eg_update.event_group_id, eg_update.event_group, span));
+  }
+
+  com::vmware::concord::thin_replica::Data makeEventGroupData(kvbc::EventGroupId event_group_id,
+                                                              const kvbc::KvbFilteredEventGroupUpdate::EventGroup& eg,
+                                                              const std::optional<std::string>& span) {
     com::vmware::concord::thin_replica::Data data;
-    LOG_DEBUG(logger_, "sendEventGroupData for id " << eg_update.event_group_id);
-    data.mutable_event_group()->set_id(eg_update.event_group_id);
+    LOG_DEBUG(logger_, "sendEventGroupData for id " << event_group_id);
+    data.mutable_event_group()->set_id(event_group_id);
 
-    for (const auto& event : eg_update.event_group.events) {
+    for (const auto& event : eg.events) {
       // TODO: Move don't copy.
       data.mutable_event_group()->add_events(event.data);
     }
     google::protobuf::Timestamp* timestamp = new google::protobuf::Timestamp();
-    TimeUtil::FromString(eg_update.event_group.record_time, timestamp);
+    TimeUtil::FromString(eg.record_time, timestamp);
     data.mutable_event_group()->set_allocated_record_time(timestamp);
     if (span) {
       data.mutable_event_group()->set_trace_context(*span);
     }
-    if (!stream->Write(data)) {
-      throw StreamClosed("Data event group stream closed");
-    }
+    return data;
   }
 
   template <typename ServerWriterT>
@@ -1184,6 +1249,17 @@ class ThinReplicaImpl {
     }
   }
 
+  // Range hash streams send the pending range hash whenever the subscription is
+  // idle such that the client doesn't wait for the range to fill up
+  template <typename ServerWriterT>
+  void flushRangeHash(ServerWriterT* stream) {
+    if constexpr (IsRangeHashWriter<ServerWriterT>::value) {
+      if (!stream->flush()) {
+        throw StreamClosed("Hash stream closed");
+      }
+    }
+  }
+
   // Get client_id from metadata if using insecure TRS
   // Get client_id from the client certs if using secure TRS
   // and compare the client_id with the client_id in known root cert
@@ -1238,7 +1314,7 @@ class ThinReplicaImpl {
   template <typename RequestT>
   std::tuple<grpc::Status, std::shared_ptr<SubUpdateBuffer>> subscribeToLiveUpdates(
       RequestT* request, const std::string& client_id, std::shared_ptr<kvbc::KvbAppFilter>& kvb_filter) {
-    auto live_updates = std::make_shared<SubUpdateBuffer>(kSubUpdateBufferSize);
+    auto live_updates = config_->subscriber_list.createBuffer();
     bool success = config_->subscriber_list.addBuffer(live_updates);
     if (!success) {
       std::stringstream msg;
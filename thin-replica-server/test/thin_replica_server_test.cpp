@@ -14,6 +14,7 @@
 #include <grpcpp/impl/codegen/server_context.h>
 
 #include <iterator>
+#include <limits>
 #include <map>
 #include <sstream>
 #include <string>
@@ -22,6 +23,7 @@
 
 #include "kv_types.hpp"
 #include "kvbc_app_filter/kvbc_key_types.h"
+#include "thin-replica-server/range_hash_writer.hpp"
 #include "thin-replica-server/subscription_buffer.hpp"
 #include "thin-replica-server/thin_replica_impl.hpp"
 
@@ -651,7 +653,7 @@ class TestServerWriter {
 
  public:
   TestServerWriter(TestStateMachine<T>& state_machine) : state_machine_(state_machine) {}
-  bool Write(T& msg) { return state_machine_.on_server_write(msg); }
+  bool Write(const T& msg) { return state_machine_.on_server_write(msg); }
 };
 
 template <typename DataT>
@@ -3588,6 +3590,101 @@ TEST(thin_replica_server_test, SubscribeToUpdatesLegacyRequestEventGroups) {
   EXPECT_EQ(state_machine.numLegacyBlocksReceived(), 0);
   EXPECT_EQ(state_machine.numEventGroupsReceived(), total_event_groups);
 }
+
+class CollectingHashWriter {
+ public:
+  bool Write(const Hash& msg) {
+    hashes.push_back(msg);
+    return true;
+  }
+  std::vector<Hash> hashes;
+};
+
+std::string updateHash(uint64_t id) { return std::string(32, static_cast<char>('a' + id % 26)); }
+
+std::string rangeHash(uint64_t start, uint64_t end) {
+  std::string concatenated_hashes;
+  for (auto id = start; id <= end; ++id) {
+    concatenated_hashes += updateHash(id);
+  }
+  return concord::crypto::openssl::computeSHA256Hash(concatenated_hashes);
+}
+
+TEST(thin_replica_server_test, RangeHashWriterInterval) {
+  CollectingHashWriter stream;
+  concord::thin_replica::RangeHashWriter<CollectingHashWriter> range_stream(&stream, 3);
+  for (uint64_t block_id = 1; block_id <= 7; ++block_id) {
+    Hash hash;
+    hash.mutable_events()->set_block_id(block_id);
+    hash.mutable_events()->set_hash(updateHash(block_id));
+    EXPECT_TRUE(range_stream.Write(hash));
+  }
+  ASSERT_EQ(stream.hashes.size(), 2u);
+  EXPECT_EQ(range_stream.numPending(), 1u);
+  EXPECT_TRUE(range_stream.flush());
+  EXPECT_EQ(range_stream.numPending(), 0u);
+  // Nothing pending, nothing to write
+  EXPECT_TRUE(range_stream.flush());
+
+  ASSERT_EQ(stream.hashes.size(), 3u);
+  const std::vector<std::pair<uint64_t, uint64_t>> expected_ranges{{1, 3}, {4, 6}, {7, 7}};
+  for (size_t i = 0; i < expected_ranges.size(); ++i) {
+    const auto& [start, end] = expected_ranges[i];
+    ASSERT_TRUE(stream.hashes[i].has_events());
+    EXPECT_EQ(stream.hashes[i].events().range_start(), start);
+    EXPECT_EQ(stream.hashes[i].events().block_id(), end);
+    EXPECT_EQ(stream.hashes[i].events().hash(), rangeHash(start, end));
+  }
+}
+
+TEST(thin_replica_server_test, RangeHashWriterLegacyTransition) {
+  CollectingHashWriter stream;
+  concord::thin_replica::RangeHashWriter<CollectingHashWriter> range_stream(&stream, 10);
+  for (uint64_t block_id = 5; block_id <= 6; ++block_id) {
+    Hash hash;
+    hash.mutable_events()->set_block_id(block_id);
+    hash.mutable_events()->set_hash(updateHash(block_id));
+    EXPECT_TRUE(range_stream.Write(hash));
+  }
+  EXPECT_TRUE(stream.hashes.empty());
+
+  // The legacy range ends with the first event group
+  for (uint64_t eg_id = 1; eg_id <= 2; ++eg_id) {
+    Hash hash;
+    hash.mutable_event_group()->set_event_group_id(eg_id);
+    hash.mutable_event_group()->set_hash(updateHash(eg_id));
+    EXPECT_TRUE(range_stream.Write(hash));
+  }
+  ASSERT_EQ(stream.hashes.size(), 1u);
+  ASSERT_TRUE(stream.hashes[0].has_events());
+  EXPECT_EQ(stream.hashes[0].events().range_start(), 5u);
+  EXPECT_EQ(stream.hashes[0].events().block_id(), 6u);
+  EXPECT_EQ(stream.hashes[0].events().hash(), rangeHash(5, 6));
+
+  EXPECT_TRUE(range_stream.flush());
+  ASSERT_EQ(stream.hashes.size(), 2u);
+  ASSERT_TRUE(stream.hashes[1].has_event_group());
+  EXPECT_EQ(stream.hashes[1].event_group().range_start(), 1u);
+  EXPECT_EQ(stream.hashes[1].event_group().event_group_id(), 2u);
+  EXPECT_EQ(stream.hashes[1].event_group().hash(), rangeHash(1, 2));
+}
+
+TEST(thin_replica_server_test, RangeHashWriterClampsInterval) {
+  using Writer = concord::thin_replica::RangeHashWriter<CollectingHashWriter>;
+  CollectingHashWriter stream;
+  Writer range_stream(&stream, std::numeric_limits<uint32_t>::max());
+  EXPECT_EQ(range_stream.interval(), Writer::kMaxInterval);
+  for (uint64_t block_id = 1; block_id <= Writer::kMaxInterval + 1; ++block_id) {
+    Hash hash;
+    hash.mutable_events()->set_block_id(block_id);
+    hash.mutable_events()->set_hash(updateHash(block_id));
+    EXPECT_TRUE(range_stream.Write(hash));
+  }
+  ASSERT_EQ(stream.hashes.size(), 1u);
+  EXPECT_EQ(stream.hashes[0].events().range_start(), 1u);
+  EXPECT_EQ(stream.hashes[0].events().block_id(), Writer::kMaxInterval);
+  EXPECT_EQ(range_stream.numPending(), 1u);
+}
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -0,0 +1,123 @@
+// Concord
+//
+// Copyright (c) 2022 VMware, Inc. All Rights Reserved.
+//
+// This product is licensed to you under the Apache 2.0 license (the "License").
+// You may not use this product except in compliance with the Apache 2.0
+// License.
+//
+// This product may include a number of subcomponents with separate copyright
+// notices and license terms. Your use of these subcomponents is subject to the
+// terms and conditions of the subcomponent's license, as noted in the LICENSE
+// file.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thin-replica-server/subscription_buffer.hpp"
+
+// Fan-out of live updates from the commands handler to thin replica
+// subscribers. Every subscriber reads all updates on its own thread. Measures
+// the time until all subscribers received all updates.
+
+namespace {
+
+using namespace std::chrono_literals;
+
+using concord::kvbc::categorization::ImmutableInput;
+using concord::kvbc::categorization::ImmutableValueUpdate;
+using concord::thin_replica::SharedSubUpdatePtr;
+using concord::thin_replica::SubBufferList;
+using concord::thin_replica::SubUpdate;
+using concord::thin_replica::SubUpdateBuffer;
+
+constexpr size_t kNumUpdates = 1000;
+constexpr size_t kNumKeysPerUpdate = 32;
+constexpr size_t kValueSize = 256;
+// Large enough to never detect a slow consumer
+constexpr size_t kBufferSize = kNumUpdates;
+
+SubUpdate makeUpdate() {
+  ImmutableInput input;
+  for (size_t i = 0; i < kNumKeysPerUpdate; ++i) {
+    ImmutableValueUpdate val;
+    val.data = std::string(kValueSize, 'v');
+    val.tags = {"client1", "client2"};
+    input.kv.emplace("key" + std::to_string(i), std::move(val));
+  }
+  return SubUpdate{0, "cid", std::move(input)};
+}
+
+template <typename ProduceT>
+void runFanOut(benchmark::State& state, std::vector<std::shared_ptr<SubUpdateBuffer>>& buffers, ProduceT&& produce) {
+  std::vector<std::thread> readers;
+  for (auto& buffer : buffers) {
+    readers.emplace_back([&buffer] {
+      SharedSubUpdatePtr out;
+      for (size_t i = 0; i < kNumUpdates; ++i) {
+        buffer->PopShared(out);
+        benchmark::DoNotOptimize(out);
+      }
+    });
+  }
+  auto update = makeUpdate();
+  for (size_t i = 0; i < kNumUpdates; ++i) {
+    update.block_id = i;
+    produce(update);
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
+
+// Updates are published once into the shared ring of the subscriber list
+void sharedRing(benchmark::State& state) {
+  const auto num_subscribers = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    SubBufferList sub_list{kBufferSize};
+    std::vector<std::shared_ptr<SubUpdateBuffer>> buffers;
+    for (size_t i = 0; i < num_subscribers; ++i) {
+      buffers.push_back(sub_list.createBuffer());
+      sub_list.addBuffer(buffers.back());
+    }
+    runFanOut(state, buffers, [&sub_list](SubUpdate& update) { sub_list.updateSubBuffers(update); });
+  }
+  state.SetItemsProcessed(state.iterations() * kNumUpdates);
+}
+
+// Every subscriber receives its own copy of each update (the former approach)
+void copyPerSubscriber(benchmark::State& state) {
+  const auto num_subscribers = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    std::vector<std::shared_ptr<SubUpdateBuffer>> buffers;
+    for (size_t i = 0; i < num_subscribers; ++i) {
+      buffers.push_back(std::make_shared<SubUpdateBuffer>(kBufferSize));
+    }
+    runFanOut(state, buffers, [&buffers](SubUpdate& update) {
+      for (auto& buffer : buffers) {
+        buffer->Push(update);
+      }
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * kNumUpdates);
+}
+
+}  // namespace
+
+BENCHMARK(sharedRing)->Arg(1)->Arg(10)->Arg(50)->Arg(100)->Arg(200)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(copyPerSubscriber)
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(50)
+    ->Arg(100)
+    ->Arg(200)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
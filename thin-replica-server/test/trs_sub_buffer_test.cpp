@@ -30,10 +30,13 @@ using concord::kvbc::categorization::ImmutableValueUpdate;
 using concord::kvbc::categorization::EventGroup;
 using concord::kvbc::categorization::Event;
 using concord::thin_replica::ConsumerTooSlow;
+using concord::thin_replica::SharedSubUpdate;
+using concord::thin_replica::SharedSubUpdatePtr;
 using concord::thin_replica::SubBufferList;
 using concord::thin_replica::SubUpdate;
 using concord::thin_replica::SubEventGroupUpdate;
 using concord::thin_replica::SubUpdateBuffer;
+using concord::thin_replica::SubUpdateRingT;
 
 // A producer should be able to "add" updates whether there are consumers or
 // not. Meaning, the producer does not get interrupted/disturbed if no
@@ -285,6 +288,116 @@ TEST(trs_sub_buffer_test, waiting_for_updates) {
   sub_list.updateEventGroupSubBuffers(update_eg);
 }
 
+TEST(trs_sub_buffer_test, shared_buffers_read_the_same_update) {
+  SubBufferList sub_list;
+  auto updates1 = sub_list.createBuffer();
+  auto updates2 = sub_list.createBuffer();
+  sub_list.addBuffer(updates1);
+  sub_list.addBuffer(updates2);
+
+  SubUpdate update{1337, "CID", {}};
+  sub_list.updateSubBuffers(update);
+
+  // Both subscribers hold the one and only copy of the update
+  SharedSubUpdatePtr out1, out2;
+  ASSERT_TRUE(updates1->TryPopShared(out1, 10ms));
+  ASSERT_TRUE(updates2->TryPopShared(out2, 10ms));
+  ASSERT_EQ(out1.get(), out2.get());
+  ASSERT_EQ(out1->get().block_id, 1337u);
+  ASSERT_TRUE(updates1->Empty());
+  ASSERT_TRUE(updates2->Empty());
+}
+
+TEST(trs_sub_buffer_test, shared_buffer_starts_at_the_next_update) {
+  SubBufferList sub_list;
+  SubUpdate update{1, "CID", {}};
+  auto updates1 = sub_list.createBuffer();
+  sub_list.addBuffer(updates1);
+  sub_list.updateSubBuffers(update);
+
+  auto updates2 = sub_list.createBuffer();
+  sub_list.addBuffer(updates2);
+  update.block_id = 2;
+  sub_list.updateSubBuffers(update);
+
+  ASSERT_EQ(updates1->Size(), 2u);
+  ASSERT_EQ(updates1->oldestBlockId(), 1u);
+  ASSERT_EQ(updates1->newestBlockId(), 2u);
+  ASSERT_EQ(updates2->Size(), 1u);
+  ASSERT_EQ(updates2->oldestBlockId(), 2u);
+}
+
+TEST(trs_sub_buffer_test, lagging_shared_reader_does_not_affect_others) {
+  SubBufferList sub_list{10};
+  auto slow = sub_list.createBuffer();
+  auto fast = sub_list.createBuffer();
+  sub_list.addBuffer(slow);
+  sub_list.addBuffer(fast);
+
+  SubUpdate update{0, "CID", {}};
+  SubUpdate out;
+  for (unsigned i = 0; i < 11; ++i) {
+    update.block_id = i;
+    sub_list.updateSubBuffers(update);
+    fast->Pop(out);
+    ASSERT_EQ(out.block_id, i);
+  }
+
+  ASSERT_TRUE(slow->Full());
+  EXPECT_THROW(slow->Pop(out), ConsumerTooSlow);
+  ASSERT_TRUE(fast->Empty());
+}
+
+TEST(trs_sub_buffer_test, shared_update_is_released_once_read) {
+  auto ring = std::make_shared<SubUpdateRingT>(10);
+  auto entry = std::make_shared<const SharedSubUpdate>(SubUpdate{1, "CID", {}});
+  std::weak_ptr<const SharedSubUpdate> weak_entry = entry;
+  uint64_t cursor1 = ring->attach();
+  uint64_t cursor2 = ring->attach();
+  ring->publish(std::move(entry));
+
+  ring->pop(cursor1);
+  ASSERT_FALSE(weak_entry.expired());
+  // A reader leaving releases its unread updates
+  ring->detach(cursor2);
+  ASSERT_TRUE(weak_entry.expired());
+  ring->detach(cursor1);
+  ASSERT_EQ(ring->numReaders(), 0u);
+}
+
+TEST(trs_sub_buffer_test, updates_are_not_kept_without_readers) {
+  auto ring = std::make_shared<SubUpdateRingT>(10);
+  auto entry = std::make_shared<const SharedSubUpdate>(SubUpdate{1, "CID", {}});
+  std::weak_ptr<const SharedSubUpdate> weak_entry = entry;
+  ring->publish(std::move(entry));
+  ASSERT_TRUE(weak_entry.expired());
+}
+
+TEST(trs_sub_buffer_test, memoize_computes_once_per_key) {
+  SharedSubUpdate update{SubUpdate{1, "CID", {}}};
+  std::atomic_int num_computed{0};
+  auto compute = [&] {
+    ++num_computed;
+    return std::string("result");
+  };
+
+  std::vector<std::future<std::shared_ptr<const std::string>>> results;
+  for (int i = 0; i < 8; ++i) {
+    results.emplace_back(
+        std::async(std::launch::async, [&] { return update.memoize<std::string>("client", compute); }));
+  }
+  auto first = results.front().get();
+  for (size_t i = 1; i < results.size(); ++i) {
+    ASSERT_EQ(results[i].get().get(), first.get());
+  }
+  ASSERT_EQ(num_computed, 1);
+
+  // Different keys or types are computed separately
+  ASSERT_EQ(*update.memoize<std::string>("other_client", compute), "result");
+  ASSERT_EQ(*update.memoize<size_t>("client", [] { return size_t{5}; }), 5u);
+  ASSERT_EQ(num_computed, 2);
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -76,6 +76,17 @@ class CoinsSigner {
   template <typename T>
   bool validate(const UTTParams& p, const T&) const;
 
+  /**
+   * @brief Validating a batch of UTT transactions. The transactions are validated in parallel, and the signatures of
+   * all of them are verified at once, which is cheaper than calling validate() on each one
+   *
+   * @tparam T One of <operations::Transaction>
+   * @param p The shared global UTT parameters
+   * @return std::vector<bool> Whether each transaction is valid, in the order of the given transactions
+   */
+  template <typename T>
+  std::vector<bool> validateBatch(const UTTParams& p, const std::vector<T>&) const;
+
   /**
    * @brief Validating partial signatures of UTT operations
    *
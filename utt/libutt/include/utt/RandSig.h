@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 
 #include <utt/Comm.h>
 #include <utt/PolyCrypto.h>
@@ -9,6 +10,7 @@ namespace libutt {
 class Comm;
 class CommKey;
 class RandSig;
+class RandSigBatchVerifier;
 class RandSigPK;
 class RandSigShare;
 class RandSigShareSK;
@@ -146,6 +148,44 @@ class RandSig {
   bool operator!=(const RandSig& o) const { return !operator==(o); }
 };
 
+/**
+ * Randomized batch verification of PS16 signatures.
+ *
+ * For each signature, RandSig::verify() checks two pairing equations: cc.hasCorrectG2() and the signature itself.
+ * Here, the equations of all added signatures are raised to independent random exponents and multiplied, such that
+ * they are checked by a single multi-pairing with a single final exponentiation. Pairings on the same G1 or G2 element
+ * (i.e., on g, g_tilde of the same PK) are merged into one via multi-exponentiations.
+ *
+ * If verify() returns true, all added signatures are valid, except with negligible probability.
+ */
+class RandSigBatchVerifier {
+ public:
+  /**
+   * Adds the check of 'sig' on 'cc' under 'pk', i.e., the equivalent of sig.verify(cc, pk)
+   *
+   * WARNING: 'pk' is not copied, so it must outlive this object.
+   */
+  void add(const RandSig& sig, const Comm& cc, const RandSigPK& pk);
+
+  /**
+   * Adds all the checks of 'other'
+   */
+  void add(const RandSigBatchVerifier& other);
+
+  bool verify() const;
+
+  size_t size() const { return checks.size(); }
+
+ protected:
+  struct Check {
+    RandSig sig;
+    Comm cc;
+    const RandSigPK* pk;
+  };
+
+  std::vector<Check> checks;
+};
+
 /**
  * A PS16 signature *share* on a Comm
  */
@@ -18,6 +18,7 @@
 namespace libutt {
 class Coin;
 class Params;
+class RandSigBatchVerifier;
 class RegAuthPK;
 class Tx;
 }  // namespace libutt
@@ -92,9 +93,33 @@ class Tx {
    */
   G1 deriveRandSigBase(size_t txoIdx) const;
 
-  bool quickPayValidate(const Params& p, const RandSigPK& bpk, const RegAuthPK& rpk) const;
+  /**
+   * If 'sigs' is given, the regsig and coinsig checks are not done here, but added to 'sigs', so that they can be
+   * batch-verified later. In that case, this TXN is valid only if both this function and sigs->verify() succeed.
+   *
+   * WARNING: 'bpk' and 'rpk' must then outlive 'sigs'.
+   */
+  bool quickPayValidate(const Params& p,
+                        const RandSigPK& bpk,
+                        const RegAuthPK& rpk,
+                        RandSigBatchVerifier* sigs = nullptr) const;
+
+  bool validate(const Params& p,
+                const RandSigPK& bpk,
+                const RegAuthPK& rpk,
+                RandSigBatchVerifier* sigs = nullptr) const;
 
-  bool validate(const Params& p, const RandSigPK& bpk, const RegAuthPK& rpk) const;
+  /**
+   * Validates many TXNs, returning whether each one is valid.
+   *
+   * The TXNs are validated in parallel (when compiled with USE_MULTITHREADING), and all of their regsigs and
+   * coinsigs are checked by a single randomized batch verification. Only if that fails, the signatures of each TXN
+   * are re-checked separately, to find the invalid ones.
+   */
+  static std::vector<bool> validateBatch(const Params& p,
+                                         const std::vector<const Tx*>& txs,
+                                         const RandSigPK& bpk,
+                                         const RegAuthPK& rpk);
 
   /**
    * Returns the nullifiers of all coins spent by this TXN, including the budget coin's.
@@ -166,6 +166,62 @@ bool RandSig::verify(const Comm& cc, const RandSigPK& pk) const {
   // return ReducedPairing(s2, pk.g_tilde) == ReducedPairing(s1, pk.X_tilde + cc.asG2());
 }
 
+void RandSigBatchVerifier::add(const RandSig& sig, const Comm& cc, const RandSigPK& pk) {
+  testAssertTrue(cc.hasG2());
+  checks.push_back(Check{sig, cc, &pk});
+}
+
+void RandSigBatchVerifier::add(const RandSigBatchVerifier& other) {
+  checks.insert(checks.end(), other.checks.begin(), other.checks.end());
+}
+
+bool RandSigBatchVerifier::verify() const {
+  if (checks.empty()) return true;
+
+  // For each check, with random r and t:
+  //   e(ped1, g_tilde)^r * e(-g, ped2)^r = 1            (i.e., cc.hasCorrectG2())
+  //   e(s2, -g_tilde)^t * e(s1, X_tilde + ped2)^t = 1   (i.e., the PS16 signature)
+  // Terms on the same g_tilde or g of a PK are merged into a single pairing.
+  std::vector<const RandSigPK*> pks;
+  std::vector<std::vector<G1>> g1s;  // per PK, the G1 elements paired with its g_tilde
+  std::vector<std::vector<G2>> g2s;  // per PK, the G2 elements paired with its -g
+  std::vector<std::vector<Fr>> g1Exps, g2Exps;
+
+  std::vector<G1> pairingG1;
+  std::vector<G2> pairingG2;
+  for (auto& c : checks) {
+    size_t k = 0;
+    while (k < pks.size() && pks[k] != c.pk) k++;
+    if (k == pks.size()) {
+      pks.push_back(c.pk);
+      g1s.emplace_back();
+      g2s.emplace_back();
+      g1Exps.emplace_back();
+      g2Exps.emplace_back();
+    }
+
+    Fr r = Fr::random_element(), t = Fr::random_element();
+    g1s[k].push_back(c.cc.ped1);
+    g1Exps[k].push_back(r);
+    g1s[k].push_back(c.sig.s2);
+    g1Exps[k].push_back(-t);
+    g2s[k].push_back(c.cc.asG2());
+    g2Exps[k].push_back(r);
+
+    pairingG1.push_back(t * c.sig.s1);
+    pairingG2.push_back(c.pk->X_tilde + c.cc.asG2());
+  }
+
+  for (size_t k = 0; k < pks.size(); k++) {
+    pairingG1.push_back(multiExp<G1>(g1s[k], g1Exps[k]));
+    pairingG2.push_back(pks[k]->g_tilde);
+    pairingG1.push_back(-pks[k]->g);
+    pairingG2.push_back(multiExp<G2>(g2s[k], g2Exps[k]));
+  }
+
+  return MultiPairing(pairingG1, pairingG2) == GT::one();
+}
+
 bool RandSigShare::verify(const std::vector<Comm>& c, const RandSigSharePK& pk) const {
   assertEqual(c.size(), pk.Y_tilde.size());
 
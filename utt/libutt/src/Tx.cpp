@@ -1,5 +1,6 @@
 #include <utt/Configuration.h>
 
+#include <exception>
 #include <optional>
 #include <tuple>
 
@@ -8,6 +9,7 @@
 #include <utt/Coin.h>
 #include <utt/Comm.h>
 #include <utt/Params.h>
+#include <utt/RandSig.h>
 #include <utt/RegAuth.h>
 #include <utt/SplitProof.h>
 #include <utt/Tx.h>
@@ -324,7 +326,10 @@ Tx::Tx(const Params& p,
   assertEqual(outs.size(), recip.size() + (b.has_value() ? 1 : 0));
 }
 
-bool Tx::quickPayValidate(const Params& p, const RandSigPK& bpk, const RegAuthPK& rpk) const {
+bool Tx::quickPayValidate(const Params& p,
+                          const RandSigPK& bpk,
+                          const RegAuthPK& rpk,
+                          RandSigBatchVerifier* sigs) const {
   /**
    * TODO(Perf): Do we even need to check coinsig?
    * TODO(Perf): Do we even need to check regsig?
@@ -362,7 +367,9 @@ bool Tx::quickPayValidate(const Params& p, const RandSigPK& bpk, const RegAuthPK
   /**
    * Step 2: Check registration authority's sig on registration commitment
    */
-  if (!regsig.verify(rcm, rpk.vk)) {
+  if (sigs != nullptr) {
+    sigs->add(regsig, rcm, rpk.vk);
+  } else if (!regsig.verify(rcm, rpk.vk)) {
     logerror << "TX did not have a valid regsig" << endl;
     return false;
   }
@@ -385,7 +392,9 @@ bool Tx::quickPayValidate(const Params& p, const RandSigPK& bpk, const RegAuthPK
 
     // Here, we need the *full* coin commitment which contains the type and expiration date
     auto ccm_full = Coin::augmentComm(p.getCoinCK(), ins[i].ccm, ins[i].coin_type, ins[i].exp_date);
-    if (!ins[i].coinsig.verify(ccm_full, bpk)) {
+    if (sigs != nullptr) {
+      sigs->add(ins[i].coinsig, ccm_full, bpk);
+    } else if (!ins[i].coinsig.verify(ccm_full, bpk)) {
       logerror << "ins[" << i << "] did not have a valid coinsig" << endl;
       return false;
     }
@@ -401,8 +410,8 @@ bool Tx::quickPayValidate(const Params& p, const RandSigPK& bpk, const RegAuthPK
   return true;
 }
 
-bool Tx::validate(const Params& p, const RandSigPK& bpk, const RegAuthPK& rpk) const {
-  if (!quickPayValidate(p, bpk, rpk)) return false;
+bool Tx::validate(const Params& p, const RandSigPK& bpk, const RegAuthPK& rpk, RandSigBatchVerifier* sigs) const {
+  if (!quickPayValidate(p, bpk, rpk, sigs)) return false;
 
   bool isBudgeted = !isSplitOwnCoins;
 
@@ -529,6 +538,53 @@ bool Tx::validate(const Params& p, const RandSigPK& bpk, const RegAuthPK& rpk) c
   return true;
 }
 
+std::vector<bool> Tx::validateBatch(const Params& p,
+                                    const std::vector<const Tx*>& txs,
+                                    const RandSigPK& bpk,
+                                    const RegAuthPK& rpk) {
+  // NOTE: std::vector<bool> cannot be written concurrently, since its elements share bytes
+  std::vector<char> valid(txs.size(), false);
+  std::vector<RandSigBatchVerifier> sigs(txs.size());
+  std::vector<std::exception_ptr> errors(txs.size());
+
+#ifdef USE_MULTITHREADING
+#pragma omp parallel for
+#endif
+  for (size_t i = 0; i < txs.size(); i++) {
+    // exceptions cannot escape an OpenMP parallel region, so we rethrow them below
+    try {
+      valid[i] = txs[i]->validate(p, bpk, rpk, &sigs[i]);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  }
+
+  for (auto& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+
+  RandSigBatchVerifier all;
+  for (size_t i = 0; i < txs.size(); i++) {
+    if (valid[i]) all.add(sigs[i]);
+  }
+
+  // if the batch fails, find out which TXNs have bad signatures
+  if (!all.verify()) {
+    logerror << "Batch verification of " << all.size() << " signatures failed; verifying each TXN separately" << endl;
+#ifdef USE_MULTITHREADING
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < txs.size(); i++) {
+      if (valid[i] && !sigs[i].verify()) {
+        logerror << "TX #" << i << " did not have valid signatures" << endl;
+        valid[i] = false;
+      }
+    }
+  }
+
+  return std::vector<bool>(valid.begin(), valid.end());
+}
+
 G1 Tx::deriveRandSigBase(size_t txoIdx) const {
   auto vec = getNullifiers();
   std::string nulls = vec.at(0);
@@ -107,6 +107,16 @@ template <>
 bool CoinsSigner::validate<operations::Transaction>(const UTTParams& p, const operations::Transaction& tx) const {
   return tx.pImpl_->tx_.validate(p.pImpl_->p, pImpl_->bvk_, pImpl_->rvk_);
 }
+template <>
+std::vector<bool> CoinsSigner::validateBatch<operations::Transaction>(
+    const UTTParams& p, const std::vector<operations::Transaction>& txs) const {
+  std::vector<const libutt::Tx*> utt_txs;
+  utt_txs.reserve(txs.size());
+  for (const auto& tx : txs) {
+    utt_txs.push_back(&tx.pImpl_->tx_);
+  }
+  return libutt::Tx::validateBatch(p.pImpl_->p, utt_txs, pImpl_->bvk_, pImpl_->rvk_);
+}
 
 template <>
 bool CoinsSigner::validatePartialSignature<operations::Mint>(uint16_t id,
@@ -69,6 +69,66 @@ void testCentralized() {
   testAssertTrue(sig.verify(cm, pk));  // signature should verify again
 }
 
+void testBatchVerification() {
+  CommKey ck = CommKey::random(ell);
+  RandSigSK sk = RandSigSK::random(ck), otherSk = RandSigSK::random(ck);
+  RandSigPK pk = sk.toPK(), otherPk = otherSk.toPK();
+
+  // signatures alternate between the two PKs, so that the merging of pairings on the same PK is exercised
+  size_t numSigs = 8;
+  std::vector<Comm> cms;
+  std::vector<RandSig> sigs;
+  std::vector<const RandSigPK*> pks;
+  for (size_t i = 0; i < numSigs; i++) {
+    cms.push_back(Comm::create(ck, random_field_elems(ell + 1), true));
+    const auto& signer = i % 2 ? otherSk : sk;
+    sigs.push_back(signer.sign(cms.back(), Fr::random_element()));
+    pks.push_back(i % 2 ? &otherPk : &pk);
+  }
+
+  testAssertTrue(RandSigBatchVerifier().verify());
+
+  RandSigBatchVerifier good;
+  for (size_t i = 0; i < numSigs; i++) {
+    good.add(sigs[i], cms[i], *pks[i]);
+  }
+  testAssertEqual(good.size(), numSigs);
+  testAssertTrue(good.verify());
+
+  // a single bad signature among valid ones fails the whole batch: tampered s1, tampered s2 or the wrong PK
+  for (size_t bad = 0; bad < numSigs; bad++) {
+    for (int tamper = 0; tamper < 3; tamper++) {
+      RandSigBatchVerifier batch;
+      for (size_t i = 0; i < numSigs; i++) {
+        auto sig = sigs[i];
+        auto pki = pks[i];
+        if (i == bad) {
+          if (tamper == 0) sig.s1 = sig.s1 + G1::one();
+          if (tamper == 1) sig.s2 = sig.s2 + G1::one();
+          if (tamper == 2) pki = i % 2 ? &pk : &otherPk;
+        }
+        batch.add(sig, cms[i], *pki);
+      }
+      testAssertEqual(batch.size(), numSigs);
+      testAssertFalse(batch.verify());
+    }
+  }
+
+  // merging a batch with a bad signature into a good one
+  RandSigBatchVerifier bad;
+  auto badSig = sigs[0];
+  badSig.s2 = badSig.s2 + G1::one();
+  bad.add(badSig, cms[0], pk);
+  testAssertFalse(bad.verify());
+
+  RandSigBatchVerifier merged;
+  merged.add(good);
+  testAssertTrue(merged.verify());
+  merged.add(bad);
+  testAssertEqual(merged.size(), numSigs + 1);
+  testAssertFalse(merged.verify());
+}
+
 int main(int argc, char *argv[]) {
   libutt::initialize(nullptr, 0);
   // srand(static_cast<unsigned int>(time(NULL)));
@@ -76,6 +136,7 @@ int main(int argc, char *argv[]) {
   (void)argv;
 
   testCentralized();
+  testBatchVerification();
 
   loginfo << "All is well." << endl;
 
@@ -215,6 +215,45 @@ void testBudgeted2to2Txn(size_t thresh, size_t n, size_t numCycles, bool isBudge
   }      // end for all cycles
 }
 
+/**
+ * Checks Tx::validateBatch, when all TXNs are valid and when a single one has a bad coin or registration signature, in
+ * which case the batch check fails and the fallback must reject only that TXN.
+ */
+void testBatchValidation(size_t thresh, size_t n) {
+  Factory f(thresh, n);
+  const Params& p = f.getParams();
+  RegAuthPK rpk = f.getRegAuthPK();
+  RandSigPK bpk = f.getBankPK();
+
+  size_t numWallets = 3, numCoins = 2, maxDenom = 100;
+  std::vector<Wallet> w = f.randomWallets(numWallets, numCoins, maxDenom, maxDenom);
+
+  std::vector<Tx> txs;
+  for (size_t i = 0; i < w.size(); i++) {
+    txs.push_back(w[i].spendTwoRandomCoins(w[(i + 1) % w.size()].getUserPid(), true));
+  }
+  auto ptrs = [](const std::vector<Tx>& v) {
+    std::vector<const Tx*> res;
+    for (auto& tx : v) res.push_back(&tx);
+    return res;
+  };
+
+  testAssertTrue(Tx::validateBatch(p, {}, bpk, rpk).empty());
+  testAssertTrue(Tx::validateBatch(p, ptrs(txs), bpk, rpk) == std::vector<bool>(txs.size(), true));
+
+  // only the coin signature of an input of the 2nd TXN is bad
+  auto badCoinSig = txs;
+  badCoinSig[1].ins[0].coinsig.s2 = badCoinSig[1].ins[0].coinsig.s2 + G1::one();
+  testAssertFalse(badCoinSig[1].validate(p, bpk, rpk));
+  testAssertTrue(Tx::validateBatch(p, ptrs(badCoinSig), bpk, rpk) == (std::vector<bool>{true, false, true}));
+
+  // only the registration signature of the 3rd TXN is bad
+  auto badRegSig = txs;
+  badRegSig[2].regsig.s1 = badRegSig[2].regsig.s1 + G1::one();
+  testAssertFalse(badRegSig[2].validate(p, bpk, rpk));
+  testAssertTrue(Tx::validateBatch(p, ptrs(badRegSig), bpk, rpk) == (std::vector<bool>{true, true, false}));
+}
+
 int main(int argc, char* argv[]) {
   libutt::initialize(nullptr, 0);
   // srand(static_cast<unsigned int>(time(NULL)));
@@ -223,6 +262,7 @@ int main(int argc, char* argv[]) {
 
   testBudgeted2to2Txn(12, 21, 3, true, true);
   testBudgeted2to2Txn(12, 21, 3, true, false);
+  testBatchValidation(12, 21);
 
   loginfo << "All is well." << endl;
 
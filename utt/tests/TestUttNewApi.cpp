@@ -474,6 +474,45 @@ TEST_F(ibe_based_test_system_minted, test_transaction) {
   }
 }
 
+TEST_F(ibe_based_test_system_minted, test_batch_validation) {
+  auto other_utt_sys = ibe_based_test_system_minted_impl();
+  auto createTxs = [](test_system_minted& sys) {
+    libutt::IBE::MSK msk = libutt::deserialize<libutt::IBE::MSK>(sys.config->getIbeMsk());
+    auto mpk = msk.toMPK(sys.config->getPublicConfig().getParams().getImpl()->p.ibe);
+    libutt::IBEEncryptor encryptor(mpk);
+    std::vector<Transaction> txs;
+    for (size_t i = 0; i < sys.clients.size(); i++) {
+      auto& issuer = sys.clients[i];
+      auto& receiver = sys.clients[(i + 1) % sys.clients.size()];
+      txs.push_back(Transaction(sys.d,
+                                issuer,
+                                {sys.coins[issuer.getPid()].front()},
+                                {sys.bcoins[issuer.getPid()].front()},
+                                {{issuer.getPid(), 50}, {receiver.getPid(), 50}},
+                                encryptor));
+    }
+    return txs;
+  };
+  auto txs = createTxs(*this);
+  for (auto& b : banks) {
+    auto valid = b->validateBatch(d, txs);
+    ASSERT_EQ(valid.size(), txs.size());
+    for (size_t i = 0; i < txs.size(); i++) {
+      ASSERT_TRUE(valid[i]);
+      ASSERT_TRUE(b->validate(d, txs[i]));
+    }
+  }
+
+  // Transactions of another UTT system are not valid here, and should not fail the other transactions of the batch
+  auto other_txs = createTxs(other_utt_sys);
+  std::vector<Transaction> mixed_txs{txs.front(), other_txs.front(), txs.back()};
+  for (auto& b : banks) {
+    auto valid = b->validateBatch(d, mixed_txs);
+    ASSERT_EQ(valid, (std::vector<bool>{true, false, true}));
+  }
+  ASSERT_TRUE(banks.front()->validateBatch(d, std::vector<Transaction>{}).empty());
+}
+
 TEST_F(rsa_based_test_system_minted, test_transaction) {
   for (size_t i = 0; i < clients.size(); i++) {
     auto& issuer = clients[i];